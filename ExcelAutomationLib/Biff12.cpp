@@ -0,0 +1,235 @@
+﻿/*!
+* @file    Biff12.cpp
+* @brief   Implementation file for class Biff12 and Biff12Reader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstring>
+#include "Biff12.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    const size_t BufferSize = 65536;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class Biff12
+
+double Biff12::GetDouble(const unsigned char *p)
+{
+    unsigned long long bits = GetUInt32(p) | (static_cast<unsigned long long>(GetUInt32(p + 4)) << 32);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+double Biff12::DecodeRk(unsigned long rk)
+{
+    double value;
+    if (rk & 2)
+    {
+        value = static_cast<int>(rk & 0xFFFFFFFCUL) / 4;
+    }
+    else
+    {
+        unsigned long long bits = static_cast<unsigned long long>(rk & 0xFFFFFFFCUL) << 32;
+        memcpy(&value, &bits, sizeof(value));
+    }
+
+    return (rk & 1) ? value / 100 : value;
+}
+
+
+bool Biff12::GetWideString(const unsigned char *data, size_t size, size_t &offset, std::string &text)
+{
+    text.clear();
+    if (offset > size || size - offset < 4)
+        return false;
+
+    size_t units = GetUInt32(data + offset);
+    offset += 4;
+    if (units > (size - offset) / 2)
+        return false;
+
+    const unsigned char *p = data + offset;
+    offset += units * 2;
+
+    for (size_t i = 0; i < units; ++i)
+    {
+        unsigned long ch = GetUInt16(p + 2 * i);
+        if (ch >= 0xD800 && ch < 0xDC00 && i + 1 < units)
+        {
+            unsigned long low = GetUInt16(p + 2 * i + 2);
+            if (low >= 0xDC00 && low < 0xE000)
+            {
+                ch = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+                ++i;
+            }
+        }
+
+        Utf8::AppendCodePoint(text, ch);
+    }
+
+    return true;
+}
+
+
+void Biff12::AppendHeader(std::string &out, unsigned long type, size_t size)
+{
+    // the type takes at most 2 bytes, the size at most 4
+    do
+    {
+        unsigned char byte = static_cast<unsigned char>(type & 0x7F);
+        type >>= 7;
+        out.push_back(static_cast<char>(type != 0 ? byte | 0x80 : byte));
+    } while (type != 0);
+
+    do
+    {
+        unsigned char byte = static_cast<unsigned char>(size & 0x7F);
+        size >>= 7;
+        out.push_back(static_cast<char>(size != 0 ? byte | 0x80 : byte));
+    } while (size != 0);
+}
+
+
+void Biff12::AppendUInt16(std::string &out, unsigned long value)
+{
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+
+void Biff12::AppendUInt32(std::string &out, unsigned long value)
+{
+    AppendUInt16(out, value & 0xFFFF);
+    AppendUInt16(out, (value >> 16) & 0xFFFF);
+}
+
+
+void Biff12::AppendDouble(std::string &out, double value)
+{
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    AppendUInt32(out, static_cast<unsigned long>(bits & 0xFFFFFFFFUL));
+    AppendUInt32(out, static_cast<unsigned long>(bits >> 32));
+}
+
+
+void Biff12::AppendWideString(std::string &out, const std::string &text)
+{
+    // the count is known after the conversion
+    size_t countPos = out.size();
+    out.append(4, '\0');
+
+    const unsigned char *pos = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char *end = pos + text.length();
+    unsigned long units = 0;
+
+    while (pos != end)
+    {
+        unsigned long ch = Utf8::NextCodePoint(pos, end);
+        if (ch >= 0x10000)
+        {
+            AppendUInt16(out, 0xD800 + ((ch - 0x10000) >> 10));
+            AppendUInt16(out, 0xDC00 + (ch & 0x3FF));
+            units += 2;
+        }
+        else
+        {
+            AppendUInt16(out, ch);
+            ++units;
+        }
+    }
+
+    for (int i = 0; i < 4; ++i)
+        out[countPos + i] = static_cast<char>((units >> (8 * i)) & 0xFF);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class Biff12Reader
+
+Biff12Reader::Biff12Reader(ByteSource &input):
+    m_input(input), m_buffer(BufferSize), m_begin(0), m_end(0), m_type(0), m_size(0), m_failed(false)
+{
+}
+
+
+bool Biff12Reader::Next()
+{
+    m_begin += m_size;
+    m_size = 0;
+
+    if (m_failed || !Fill(1))
+        return false;       // the end of the part
+
+    unsigned long type, size;
+    if (!ReadNumber(2, type) || !ReadNumber(4, size) || !Fill(size))
+    {
+        m_failed = true;
+        return false;
+    }
+
+    m_type = type;
+    m_size = size;
+    return true;
+}
+
+
+bool Biff12Reader::Fill(size_t count)
+{
+    if (m_end - m_begin >= count)
+        return true;
+
+    // move the bytes which are not consumed to the front, and read more after them
+    memmove(&m_buffer[0], &m_buffer[m_begin], m_end - m_begin);
+    m_end -= m_begin;
+    m_begin = 0;
+
+    if (m_buffer.size() < count)
+        m_buffer.resize(count);
+
+    while (m_end < count)
+    {
+        size_t n = m_input.Read(&m_buffer[m_end], m_buffer.size() - m_end);
+        if (n == 0)
+            return false;
+        m_end += n;
+    }
+
+    return true;
+}
+
+
+bool Biff12Reader::ReadNumber(size_t maxBytes, unsigned long &value)
+{
+    value = 0;
+    for (size_t i = 0; i < maxBytes; ++i)
+    {
+        if (!Fill(1))
+            return false;
+
+        unsigned char byte = m_buffer[m_begin++];
+        value |= static_cast<unsigned long>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,202 @@
+﻿/*!
+* @file    Biff12.h
+* @brief   Header file for class Biff12 and Biff12Reader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef BIFF12_H_GUID_0B6E4D93_2F7A_4C15_A8D0_6C3E91F27B54
+#define BIFF12_H_GUID_0B6E4D93_2F7A_4C15_A8D0_6C3E91F27B54
+
+
+#include <string>
+#include <vector>
+#include "LibDef.h"
+#include "ByteSource.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Types of the BIFF12 records ([MS-XLSB]) which are read or written
+*/
+enum Biff12RecordType
+{
+    BRT_RowHdr              = 0,
+    BRT_CellBlank           = 1,
+    BRT_CellRk              = 2,
+    BRT_CellError           = 3,
+    BRT_CellBool            = 4,
+    BRT_CellReal            = 5,
+    BRT_CellSt              = 6,
+    BRT_CellIsst            = 7,
+    BRT_FmlaString          = 8,
+    BRT_FmlaNum             = 9,
+    BRT_FmlaBool            = 10,
+    BRT_FmlaError           = 11,
+    BRT_SstItem             = 19,
+    BRT_Font                = 43,
+    BRT_Fmt                 = 44,
+    BRT_Fill                = 45,
+    BRT_Border              = 46,
+    BRT_Xf                  = 47,
+    BRT_Style               = 48,
+    BRT_CellRString         = 62,
+    BRT_BeginSheet          = 129,
+    BRT_EndSheet            = 130,
+    BRT_BeginBook           = 131,
+    BRT_EndBook             = 132,
+    BRT_BeginBundleShs      = 143,
+    BRT_EndBundleShs        = 144,
+    BRT_BeginSheetData      = 145,
+    BRT_EndSheetData        = 146,
+    BRT_WbProp              = 153,
+    BRT_BundleSh            = 156,
+    BRT_BookView            = 158,
+    BRT_BeginSst            = 159,
+    BRT_EndSst              = 160,
+    BRT_BeginStyleSheet     = 278,
+    BRT_EndStyleSheet       = 279,
+    BRT_BeginFills          = 603,
+    BRT_EndFills            = 604,
+    BRT_BeginFonts          = 611,
+    BRT_EndFonts            = 612,
+    BRT_BeginBorders        = 613,
+    BRT_EndBorders          = 614,
+    BRT_BeginCellXfs        = 617,
+    BRT_EndCellXfs          = 618,
+    BRT_BeginStyles         = 619,
+    BRT_EndStyles           = 620,
+    BRT_BeginCellStyleXfs   = 626,
+    BRT_EndCellStyleXfs     = 627
+};
+
+
+/*!
+* @internal
+* @brief Class Biff12 reads and writes the fields of the BIFF12 records, the parts of an .xlsb package.
+*        All the members of Biff12 are static member.
+* @details A record is its type (1 or 2 bytes) and the size of its body (1 to 4 bytes), both with 7 bits
+*          in a byte and the high bit telling that another byte follows, then the body. The numbers in a
+*          body are little-endian, and the strings are UTF-16.
+* @note Biff12 is not intended and allowed to be instantiated.
+*/
+class Biff12
+{
+public:
+    // <begin> Read the fields of a record body; the caller checks the size of the body before
+    static unsigned long GetUInt16(const unsigned char *p)
+    {
+        return p[0] | (static_cast<unsigned long>(p[1]) << 8);
+    }
+
+    static unsigned long GetUInt32(const unsigned char *p)
+    {
+        return GetUInt16(p) | (GetUInt16(p + 2) << 16);
+    }
+
+    static double GetDouble(const unsigned char *p);
+
+    /*!
+    * @brief Decode an RK number: a 30-bit integer or the high 30 bits of a double, maybe multiplied by 100.
+    */
+    static double DecodeRk(unsigned long rk);
+    // <end> Read the fields of a record body
+
+    /*!
+    * @brief Read an XLWideString (a 32-bit count of UTF-16 code units, then the code units) in UTF-8.
+    * @param [in,out] offset Position of the string in the body, which is moved after it.
+    * @return false if the string does not fit in the body.
+    */
+    static bool GetWideString(const unsigned char *data, size_t size, size_t &offset, std::string &text);
+
+    // <begin> Append a record to a part being written
+    static void AppendHeader(std::string &out, unsigned long type, size_t size);
+
+    static void AppendRecord(std::string &out, unsigned long type, const std::string &body)
+    {
+        AppendHeader(out, type, body.size());
+        out.append(body);
+    }
+
+    static void AppendUInt16(std::string &out, unsigned long value);
+    static void AppendUInt32(std::string &out, unsigned long value);
+    static void AppendDouble(std::string &out, double value);
+
+    /*!
+    * @brief Append UTF-8 text as an XLWideString.
+    */
+    static void AppendWideString(std::string &out, const std::string &text);
+    // <end> Append a record to a part being written
+
+private:
+    // Forbid instantiation
+    Biff12();
+};
+
+
+/*!
+* @internal
+* @brief Class Biff12Reader reads the records of a BIFF12 part from a ByteSource.
+* @details The input is read in blocks, and a record body is given in place in the buffer, so it stays
+*          valid only until the next record is read.
+*/
+class Biff12Reader : public Noncopyable
+{
+public:
+    explicit Biff12Reader(ByteSource &input);
+
+    /*!
+    * @brief Read the next record.
+    * @return false at the end of the part, or if the part is broken (see Failed()).
+    */
+    bool Next();
+
+    unsigned long GetType() const
+    {
+        return m_type;
+    }
+
+    const unsigned char* GetData() const
+    {
+        return &m_buffer[m_begin];
+    }
+
+    size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    bool Failed() const
+    {
+        return m_failed || m_input.Failed();
+    }
+
+private:
+    // Make @e count bytes from m_begin available in the buffer
+    bool Fill(size_t count);
+
+    // Read a 7-bit encoded number of at most @e maxBytes bytes
+    bool ReadNumber(size_t maxBytes, unsigned long &value);
+
+private:
+    ByteSource                &m_input;
+    std::vector<unsigned char> m_buffer;
+    size_t                     m_begin;     // the bytes of the buffer which are not consumed: [m_begin, m_end)
+    size_t                     m_end;
+    unsigned long              m_type;
+    size_t                     m_size;      // of the body of the current record, which starts at m_begin
+    bool                       m_failed;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //BIFF12_H_GUID_0B6E4D93_2F7A_4C15_A8D0_6C3E91F27B54
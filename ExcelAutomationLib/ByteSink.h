@@ -0,0 +1,43 @@
+﻿/*!
+* @file    ByteSink.h
+* @brief   Header file for class ByteSink
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef BYTESINK_H_GUID_5A02373F_803A_43C7_9C2D_4024506D3678
+#define BYTESINK_H_GUID_5A02373F_803A_43C7_9C2D_4024506D3678
+
+
+#include <cstddef>
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class ByteSink is a sequential output of bytes, such as a file or an entry of a zip package.
+* @details It is the counterpart of ByteSource for the writers of the workbook files.
+*/
+class ByteSink
+{
+public:
+    virtual ~ByteSink() { }
+
+    /*!
+    * @brief Write all the bytes.
+    * @return true if successful, otherwise false
+    */
+    virtual bool Write(const unsigned char *data, size_t size) = 0;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //BYTESINK_H_GUID_5A02373F_803A_43C7_9C2D_4024506D3678
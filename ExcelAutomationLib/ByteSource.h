@@ -0,0 +1,52 @@
+﻿/*!
+* @file    ByteSource.h
+* @brief   Header file for class ByteSource
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef BYTESOURCE_H_GUID_739158C4_53D1_4908_8A34_2DE6EF224E42
+#define BYTESOURCE_H_GUID_739158C4_53D1_4908_8A34_2DE6EF224E42
+
+
+#include <cstddef>
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class ByteSource is a sequential stream of bytes, such as a file or an entry of a zip package.
+* @details The readers of the workbook files pull their input through ByteSource, so a part of a package
+*          is never held in memory as a whole.
+*/
+class ByteSource
+{
+public:
+    virtual ~ByteSource() { }
+
+    /*!
+    * @brief Read the next bytes.
+    * @param [out] buffer Which receives the bytes.
+    * @param [in] size Size of @e buffer.
+    * @return Number of bytes read. Less than @e size only at the end of the stream or on an error,
+    *         and 0 once the stream is exhausted.
+    */
+    virtual size_t Read(unsigned char *buffer, size_t size) = 0;
+
+    /*!
+    * @brief Whether the stream stopped because of an error, such as corrupted data.
+    */
+    virtual bool Failed() const = 0;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //BYTESOURCE_H_GUID_739158C4_53D1_4908_8A34_2DE6EF224E42
@@ -0,0 +1,95 @@
+﻿/*!
+* @file    CallTimer.h
+* @brief   Header file for class CallTimer
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef CALLTIMER_H_GUID_12036C2A_DD5B_416B_9117_CE3CC9C7E89B
+#define CALLTIMER_H_GUID_12036C2A_DD5B_416B_9117_CE3CC9C7E89B
+
+
+#include <windows.h>
+#include "LibDef.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class CallStatsTable holds the statistics reported by ExcelCallStats.
+*        All the members of CallStatsTable are static member.
+* @note CallStatsTable is not intended and allowed to be instantiated.
+*/
+class CallStatsTable
+{
+public:
+    static bool IsEnabled()
+    {
+        return s_enabled != 0;
+    }
+
+    /*!
+    * @brief Add a finished call to the statistics.
+    * @param [in] ticks Time of the call, in units of ::QueryPerformanceFrequency().
+    */
+    static void Record(LPCOLESTR typeName, LPCOLESTR name, WORD type, HRESULT hr, LONGLONG ticks);
+
+private:
+    friend class ExcelCallStats;
+
+    static volatile LONG s_enabled;
+
+    // Forbid instantiation
+    CallStatsTable();
+};
+
+
+/*!
+* @internal
+* @brief Class CallTimer times one call into Excel if ExcelCallStats is enabled.
+* @details Usage: @n
+*            CallTimer timer(typeName, name, type); @n
+*            HRESULT hr = ...; // the call @n
+*            timer.Stop(hr); @n
+*          Nothing but the test of the flag is done when ExcelCallStats is disabled.
+*/
+class CallTimer : public Noncopyable
+{
+public:
+    CallTimer(LPCOLESTR typeName, LPCOLESTR name, WORD type):
+        m_typeName(typeName), m_name(name), m_type(type), m_started(CallStatsTable::IsEnabled())
+    {
+        if (m_started)
+            ::QueryPerformanceCounter(&m_start);
+    }
+
+    void Stop(HRESULT hr)
+    {
+        if (!m_started)
+            return;
+
+        LARGE_INTEGER end;
+        ::QueryPerformanceCounter(&end);
+        CallStatsTable::Record(m_typeName, m_name, m_type, hr, end.QuadPart - m_start.QuadPart);
+        m_started = false;
+    }
+
+private:
+    LPCOLESTR     m_typeName;
+    LPCOLESTR     m_name;
+    WORD          m_type;
+    bool          m_started;
+    LARGE_INTEGER m_start;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //CALLTIMER_H_GUID_12036C2A_DD5B_416B_9117_CE3CC9C7E89B
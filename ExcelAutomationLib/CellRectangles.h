@@ -0,0 +1,148 @@
+﻿/*!
+* @file    CellRectangles.h
+* @brief   Header file for class CellRectangles
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef CELLRECTANGLES_H_GUID_8FE92BAE_1E01_4FEF_90F4_B682E7A97E24
+#define CELLRECTANGLES_H_GUID_8FE92BAE_1E01_4FEF_90F4_B682E7A97E24
+
+
+#include <cassert>
+#include <vector>
+#include "LibDef.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Position of a cell, ordered row by row.
+*/
+struct CellPos
+{
+    CellPos(int r, int c): row(r), column(c) { }
+
+    bool operator < (const CellPos &other) const
+    {
+        return row < other.row || (row == other.row && column < other.column);
+    }
+
+    int row;
+    int column;
+};
+
+
+/*!
+* @internal
+* @brief A rectangle of cells, all bounds are inclusive.
+*/
+struct CellRect
+{
+    CellRect(int r0, int r1, int c0, int c1): rowFrom(r0), rowTo(r1), columnFrom(c0), columnTo(c1) { }
+
+    int CountRows() const
+    {
+        return rowTo - rowFrom + 1;
+    }
+
+    int CountColumns() const
+    {
+        return columnTo - columnFrom + 1;
+    }
+
+    int rowFrom;
+    int rowTo;
+    int columnFrom;
+    int columnTo;
+};
+
+
+/*!
+* @internal
+* @brief Class CellRectangles covers a set of cells with dense rectangles, so that every rectangle can be
+*        written by one Range.Value put.
+* @details Cells of each row are grouped into runs of adjacent columns, then a run is merged into the
+*          rectangle right above it if both span exactly the same columns. A report written row by row
+*          (same columns in every row) becomes a single rectangle.
+* @note CellRectangles is not intended and allowed to be instantiated.
+*/
+class CellRectangles
+{
+public:
+    /*!
+    * @brief Cover the cells with rectangles.
+    * @param [in] cells The cells, sorted by CellPos::operator < and without duplicates.
+    * @param [out] rects Which returns the rectangles. Every cell is in exactly one rectangle,
+    *                    and every cell of a rectangle is in @e cells.
+    */
+    static void Build(const std::vector<CellPos> &cells, std::vector<CellRect> &rects)
+    {
+        rects.clear();
+
+        std::vector<CellRect> open;     // rectangles which may grow into the current row, sorted by column
+        std::vector<CellRect> next;
+
+        size_t i = 0;
+        while (i < cells.size())
+        {
+            int row = cells[i].row;
+            size_t candidate = 0;       // open rectangles are visited in column order, like the runs
+            next.clear();
+
+            while (i < cells.size() && cells[i].row == row)
+            {
+                // one run of adjacent columns
+                int columnFrom = cells[i].column;
+                int columnTo = columnFrom;
+                for (++i; i < cells.size() && cells[i].row == row && cells[i].column == columnTo + 1; ++i)
+                    ++columnTo;
+
+                while (candidate < open.size() && open[candidate].columnFrom < columnFrom)
+                    ++candidate;
+
+                if (candidate < open.size() && open[candidate].rowTo == row - 1 &&
+                    open[candidate].columnFrom == columnFrom && open[candidate].columnTo == columnTo)
+                {
+                    next.push_back(open[candidate]);
+                    next.back().rowTo = row;
+                    open[candidate].rowTo = -1;     // taken over by next
+                }
+                else
+                {
+                    next.push_back(CellRect(row, row, columnFrom, columnTo));
+                }
+            }
+
+            Close(open, rects);
+            open.swap(next);
+        }
+
+        Close(open, rects);
+    }
+
+private:
+    // Move the rectangles which stopped growing to the result
+    static void Close(const std::vector<CellRect> &open, std::vector<CellRect> &rects)
+    {
+        for (size_t k = 0; k < open.size(); ++k)
+        {
+            if (open[k].rowTo >= 0)
+                rects.push_back(open[k]);
+        }
+    }
+
+    // Forbid instantiation
+    CellRectangles();
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //CELLRECTANGLES_H_GUID_8FE92BAE_1E01_4FEF_90F4_B682E7A97E24
@@ -1,335 +1,1114 @@
-﻿/*!
-* @file    ComUtil.cpp
-* @brief   Implementation file for class ComUtil
-* @date    2009-12-09
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include <tchar.h>
-#include <cassert>
-#include <sstream>
-#include <iomanip>
-#include "ComUtil.h"
-
-
-// namespace start
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-/*
-* @brief ComUtil::Invoke is a wrapper of IDispatch::Invoke(), which is provided to simplify our work.
-* @param [in] pDisp Pointer to IDispatch. Must not be NULL.
-* @param [in] type Three values are allowed: DISPATCH_METHOD, DISPATCH_PROPERTYGET, DISPATCH_PROPERTYPUT
-* @param [in] name Name of the method or property involved.
-* @param [out] pResult Pointer to a variant which holds the results. Can be NULL.
-* @param [in] argc Number of the variant parameters. Must be equal or greater than 0.
-* @param [in] ... The variant parameters list. Their types must be VARIANT.
-* @return Any value which can be returned by IDispatch::GetIDsOfNames() or IDispatch::Invoke().
-*/
-HRESULT ComUtil::Invoke(IDispatch *pDisp, WORD type, LPOLESTR name, VARIANT *pResult, int argc, ...)
-{
-    assert(pDisp);
-    assert(argc >= 0);
-
-    // setup the parameters
-    va_list marker;
-    va_start(marker, argc);
-
-    VARIANT *pArgs = new VARIANT[argc + 1];
-    for (int i = argc - 1; i >= 0; --i)
-    {
-        pArgs[i] = va_arg(marker, VARIANT);
-    }
-
-    va_end(marker);
-
-    DISPPARAMS dp = { NULL, NULL, 0, 0 };
-    DISPID dispidNamed = DISPID_PROPERTYPUT;
-
-    dp.cArgs = argc;
-    dp.rgvarg = pArgs;
-
-    if (type & DISPATCH_PROPERTYPUT)
-	{
-        dp.cNamedArgs = 1;
-        dp.rgdispidNamedArgs = &dispidNamed;
-    }
-
-    // get ID of the name
-    DISPID dispID;
-    HRESULT hr = pDisp->GetIDsOfNames(IID_NULL, &name, 1, LOCALE_SYSTEM_DEFAULT, &dispID);
-
-    // do the invocation
-    if (SUCCEEDED(hr))
-    {
-        hr = pDisp->Invoke(dispID, IID_NULL, LOCALE_SYSTEM_DEFAULT,	type, &dp, pResult, NULL, NULL);
-    }
-
-    delete[] pArgs;
-
-    return hr;
-}
-
-
-/*
-* @brief Get an element of a two-dimensional SAFEARRAY. 
-*        ComUtil::GetSafeArrayElementDim2() is a wrapper of ::SafeArrayGetElements().
-* @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
-*                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
-* @param [in] dim1 Index of the first dimension of the array.
-* @param [in] dim2 Index of the second dimension of the array.
-* @param [out] pResult Pointer to a VARIANT object to save the result. Must not be NULL.
-* @return Any value which can be returned by ::SafeArrayGetElements().
-*/
-HRESULT ComUtil::GetSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, VARIANT *pResult)
-{
-    assert(psa && pResult);
-    assert(::SafeArrayGetDim(psa) == 2);
-
-	long indices[2];
-	indices[0] = dim1;
-	indices[1] = dim2;
-
-	VariantInit(pResult);
-	
-    HRESULT hr = ::SafeArrayGetElement(psa, indices, pResult);
-
-	return hr;
-}
-
-
-/*
-* @brief Set value of type string for the element in a two-dimensional SAFEARRAY. 
-*        ComUtil::PutSafeArrayElementDim2() is a wrapper of ::SafeArrayPutElement().
-* @param [in,out] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
-*                     Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
-* @param [in] dim1 Index of the first dimension of the array.
-* @param [in] dim2 Index of the second dimension of the array.
-* @param [in] value An OLE string which will be saved into the array.
-* @return Any value which can be returned by ::SafeArrayPutElement().
-*/
-HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
-{
-    assert(psa);
-    assert(::SafeArrayGetDim(psa) == 2);
-	
-	long indices[2];
-	indices[0] = dim1;
-	indices[1] = dim2;
-	
-	VARIANT param;
-	param.vt = VT_BSTR;
-	param.bstrVal = ::SysAllocString(value);
-	
-    HRESULT hr = ::SafeArrayPutElement(psa, indices, &param);
-
-	VariantClear(&param);
-
-	return hr;
-}
-
-
-/*
-* @brief Set value of type int for the element in a two-dimensional SAFEARRAY.
-* @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
-*/
-HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, int value)
-{
-    assert(psa);
-    assert(::SafeArrayGetDim(psa) == 2);
-	
-	long indices[2];
-	indices[0] = dim1;
-	indices[1] = dim2;
-	
-	VARIANT param;
-	param.vt = VT_INT;
-	param.intVal = value;
-	
-    HRESULT hr = ::SafeArrayPutElement(psa, indices, &param);
-
-	return hr;
-}
-
-
-/*
-* @brief Set value of type doulbe for the element in a two-dimensional SAFEARRAY.
-* @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
-*/
-HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, double value)
-{
-    assert(psa);
-    assert(::SafeArrayGetDim(psa) == 2);
-	
-	long indices[2];
-	indices[0] = dim1;
-	indices[1] = dim2;
-	
-	VARIANT param;
-	param.vt = VT_R8;
-	param.dblVal = value;
-	
-    HRESULT hr = ::SafeArrayPutElement(psa, indices, &param);
-
-	return hr;
-}
-
-
-/*
-* @brief Encode values in a two-dimensional SAFEARRAY object into string form.
-* @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
-*                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
-* @param [out] encodedStr The corresponding encoded string of the array.
-* @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
-*         ::VariantChangeType() or ComUtil::GetSafeArrayElementDim2().
-* @note Encoding format: @n
-*         EncodingString := <number of rows>#<number of columns>#{Values}            @n
-*         Values := {RowValues}{RowValues}...{RowValues}              --> All rows in the two-dimentional array    @n
-*         RowValues := {ColumnValue}{ColumnValue}...{ColumnValue}     --> All columns of in one row     @n
-*         ColumnValue := <number of characters>#<the character string of the value>          @n
-*       Example: @n
-*         For the two-dimensional array (2*5) @n
-*           { {abc, de, fghi, 3, 5235}, {23, 5353, 3253, 32} }, @n
-*         The correpsonding encoded string is 2#5#3#abc2#de4#fghi1#34#52352#234#53530#4#32532#32.    @n
-* @todo Add type info into the encoded string.
-*/
-HRESULT ComUtil::EncodeSafeArrayDim2(SAFEARRAY *psa, ELstring &encodedStr)
-{
-    assert(psa);
-    assert(::SafeArrayGetDim(psa) == 2);
-
-    LONG rowFrom = 0;
-    LONG rowTo = 0;
-    LONG columnFrom = 0;
-    LONG columnTo = 0;
-
-    HRESULT hr;
-    hr = ::SafeArrayGetLBound(psa, 1, &rowFrom);
-    if (FAILED(hr))
-        return hr;
-
-    hr = ::SafeArrayGetUBound(psa, 1, &rowTo);
-    if (FAILED(hr))
-        return hr;
-
-    hr = ::SafeArrayGetLBound(psa, 2, &columnFrom);
-    if (FAILED(hr))
-        return hr;
-
-    hr = ::SafeArrayGetUBound(psa, 2, &columnTo);
-    if (FAILED(hr))
-        return hr;
-
-
-    ELostringstream oss;
-
-    // Encoding format: <row>#<column>#
-    oss << (rowTo - rowFrom + 1) << ELtext('#') << (columnTo - columnFrom + 1) << ELtext('#');
-
-    for (LONG i = rowFrom; i <= rowTo; ++i)
-    {
-        for (LONG j = columnFrom; j <= columnTo; ++j)
-        {
-            VARIANT var;
-            hr = GetSafeArrayElementDim2(psa, i, j, &var);
-            if (FAILED(hr))
-                return hr;
-
-            // convert the VARIANT object into a string value
-            hr = ::VariantChangeType(&var, &var, VARIANT_NOUSEROVERRIDE, VT_BSTR);
-            if (FAILED(hr))
-                return hr;
-
-            ELstring str(var.bstrVal);
-
-            // Encoding format: <number of characters>#<characters>
-            oss << str.length() << ELtext('#') << str;
-        }
-    }
-
-    // return the encoded string
-    encodedStr = oss.str();
-
-    return S_OK;
-}
-
-
-/*
-* @brief Decode the data from the encoded string and create an SAFEARRAY to store the data.
-* @param [in] data The encoded string of a two dimensional array.
-* @return An SAFEARRAY with decoded data from encoded string. 
-*         If failed to decode the <em>data</em>, NULL will be returned.
-*/
-SAFEARRAY* ComUtil::DecodeSafeArrayDim2(const ELchar *data)
-{
-    assert(data);
-
-    EListringstream iss(data);
-    iss >> std::noskipws;
-
-    int row = 0;
-    int column = 0;
-    ELchar dumb;
-
-    // Encoding format: <row>#<column>#
-    iss >> row >> dumb;             // <row>#
-    assert(dumb == ELtext('#'));    // Whether the delimiter is '#', it's not important. 
-                                    // So we just place an assert statement here.
-    iss >> column >> dumb;          // <column>#
-    assert(dumb == ELtext('#'));
-
-    if (row <= 0 || column <= 0)
-        return NULL;   // no data or dirty data
-
-    SAFEARRAYBOUND sab[2];
-    sab[0].lLbound = 1;
-    sab[0].cElements = row;
-    sab[1].lLbound = 1;
-    sab[1].cElements = column;
-
-    SAFEARRAY *psa = ::SafeArrayCreate(VT_VARIANT, 2, sab);
-    if (!psa)
-        return NULL;   // failed to create an array
-
-    bool validState = true;  // flag indicating whether the data is well formed
-
-    for (int i = 1; validState && i <= row; ++i)
-    {
-        for (int j = 1; validState && j <= column; ++j)
-        {
-            // Encoding format: <number of characters>#<characters>
-            int count = 0;
-            iss >> count >> dumb;
-            assert(dumb == ELtext('#'));
-
-            validState = iss.good() && (count >= 0);
-            
-            ELstring value;
-            for (int k = 0; k < count; ++k)
-            {
-                ELchar ch;
-                iss >> ch;
-                value.push_back(ch);
-            }
-
-            validState = validState && iss.good();
-
-            if (validState)
-                PutSafeArrayElementDim2(psa, i, j, value.c_str());
-        }
-    }
-
-    if (!validState) {
-        ::SafeArrayDestroy(psa);
-        psa = NULL;
-    }
-
-    return psa;
-}
-
-
-
-// namespace end
-EXCEL_AUTOMATION_NAMESPACE_END
+﻿/*!
+* @file    ComUtil.cpp
+* @brief   Implementation file for class ComUtil
+* @date    2009-12-09
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include <tchar.h>
+#include <cassert>
+#include "ComUtil.h"
+#include "DispIdCache.h"
+#include "VtableBinding.h"
+#include "CallTimer.h"
+#include "RangeCodec.h"
+#include "ExcelUtil.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ComArg
+
+ComArg::ComArg(const ELchar *value): m_owned(true)
+{
+    m_var.vt = VT_BSTR;
+    m_var.bstrVal = ::SysAllocString(value);
+}
+
+
+ComArg::ComArg(const ELstring &value): m_owned(true)
+{
+    m_var.vt = VT_BSTR;
+    m_var.bstrVal = ::SysAllocStringLen(value.c_str(), static_cast<UINT>(value.length()));
+}
+
+
+ComArg::ComArg(const ComArg &other): m_var(other.m_var), m_owned(other.m_owned)
+{
+    if (m_owned)
+        m_var.bstrVal = ::SysAllocStringLen(other.m_var.bstrVal, ::SysStringLen(other.m_var.bstrVal));
+}
+
+
+ComArg::~ComArg()
+{
+    if (m_owned)
+        ::SysFreeString(m_var.bstrVal);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ComUtil
+
+HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+{
+    return InvokeArgs(pDisp, typeName, type, name, pResult, NULL, 0);
+}
+
+
+HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+    const ComArg &arg1)
+{
+    VARIANT args[1] = { arg1.Get() };
+    return InvokeArgs(pDisp, typeName, type, name, pResult, args, 1);
+}
+
+
+HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+    const ComArg &arg1, const ComArg &arg2)
+{
+    VARIANT args[2] = { arg2.Get(), arg1.Get() };
+    return InvokeArgs(pDisp, typeName, type, name, pResult, args, 2);
+}
+
+
+HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+    const ComArg &arg1, const ComArg &arg2, const ComArg &arg3)
+{
+    VARIANT args[3] = { arg3.Get(), arg2.Get(), arg1.Get() };
+    return InvokeArgs(pDisp, typeName, type, name, pResult, args, 3);
+}
+
+
+HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+    const ComArg &arg1, const ComArg &arg2, const ComArg &arg3, const ComArg &arg4)
+{
+    VARIANT args[4] = { arg4.Get(), arg3.Get(), arg2.Get(), arg1.Get() };
+    return InvokeArgs(pDisp, typeName, type, name, pResult, args, 4);
+}
+
+
+HRESULT ComUtil::InvokeEarlyBound(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+{
+    CallTimer timer(typeName, name, type);
+
+    HRESULT hr;
+    if (VtableBinding::Invoke(pDisp, typeName, type, name, pResult, NULL, 0, hr))
+    {
+        timer.Stop(hr);
+        return hr;
+    }
+
+    return InvokeArgs(pDisp, typeName, type, name, pResult, NULL, 0);
+}
+
+
+HRESULT ComUtil::InvokeEarlyBound(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+    const ComArg &arg1)
+{
+    VARIANT args[1] = { arg1.Get() };
+
+    CallTimer timer(typeName, name, type);
+
+    HRESULT hr;
+    if (VtableBinding::Invoke(pDisp, typeName, type, name, pResult, args, 1, hr))
+    {
+        timer.Stop(hr);
+        return hr;
+    }
+
+    return InvokeArgs(pDisp, typeName, type, name, pResult, args, 1);
+}
+
+
+HRESULT ComUtil::InvokeArgs(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+    VARIANT *pArgs, UINT argc)
+{
+    assert(pDisp);
+
+    CallTimer timer(typeName, name, type);
+
+    // setup the parameters (the VARIANTs are shallow copies owned by the ComArg objects of the caller)
+    DISPPARAMS dp = { NULL, NULL, 0, 0 };
+    DISPID dispidNamed = DISPID_PROPERTYPUT;
+
+    dp.cArgs = argc;
+    dp.rgvarg = pArgs;
+
+    if (type & DISPATCH_PROPERTYPUT)
+	{
+        dp.cNamedArgs = 1;
+        dp.rgdispidNamedArgs = &dispidNamed;
+    }
+
+    // get ID of the name
+    DISPID dispID;
+    HRESULT hr = DispIdCache::GetDispId(pDisp, typeName, name, dispID);
+
+    // do the invocation
+    if (SUCCEEDED(hr))
+    {
+        hr = pDisp->Invoke(dispID, IID_NULL, LOCALE_SYSTEM_DEFAULT,	type, &dp, pResult, NULL, NULL);
+
+        if (hr == DISP_E_MEMBERNOTFOUND && typeName)
+        {
+            // a stale cache entry, ask the object itself again
+            DispIdCache::Invalidate(typeName, name);
+            hr = DispIdCache::GetDispId(pDisp, typeName, name, dispID);
+            if (SUCCEEDED(hr))
+            {
+                hr = pDisp->Invoke(dispID, IID_NULL, LOCALE_SYSTEM_DEFAULT, type, &dp, pResult, NULL, NULL);
+            }
+        }
+    }
+
+    timer.Stop(hr);
+
+    return hr;
+}
+
+
+/*
+* @brief Get an element of a two-dimensional SAFEARRAY. 
+*        ComUtil::GetSafeArrayElementDim2() is a wrapper of ::SafeArrayGetElements().
+* @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+*                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+* @param [in] dim1 Index of the first dimension of the array.
+* @param [in] dim2 Index of the second dimension of the array.
+* @param [out] pResult Pointer to a VARIANT object to save the result. Must not be NULL.
+* @return Any value which can be returned by ::SafeArrayGetElements().
+*/
+HRESULT ComUtil::GetSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, VARIANT *pResult)
+{
+    assert(psa && pResult);
+    assert(::SafeArrayGetDim(psa) == 2);
+
+	long indices[2];
+	indices[0] = dim1;
+	indices[1] = dim2;
+
+	VariantInit(pResult);
+	
+    HRESULT hr = ::SafeArrayGetElement(psa, indices, pResult);
+
+	return hr;
+}
+
+
+/*
+* @brief Set value of type string for the element in a two-dimensional SAFEARRAY. 
+*        ComUtil::PutSafeArrayElementDim2() is a wrapper of ::SafeArrayPutElement().
+* @param [in,out] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+*                     Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+* @param [in] dim1 Index of the first dimension of the array.
+* @param [in] dim2 Index of the second dimension of the array.
+* @param [in] value An OLE string which will be saved into the array.
+* @return Any value which can be returned by ::SafeArrayPutElement().
+*/
+HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+	
+	long indices[2];
+	indices[0] = dim1;
+	indices[1] = dim2;
+	
+	VARIANT param;
+	param.vt = VT_BSTR;
+	param.bstrVal = ::SysAllocString(value);
+	
+    HRESULT hr = ::SafeArrayPutElement(psa, indices, &param);
+
+	VariantClear(&param);
+
+	return hr;
+}
+
+
+/*
+* @brief Set value of type int for the element in a two-dimensional SAFEARRAY.
+* @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
+*/
+HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, int value)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+	
+	long indices[2];
+	indices[0] = dim1;
+	indices[1] = dim2;
+	
+	VARIANT param;
+	param.vt = VT_INT;
+	param.intVal = value;
+	
+    HRESULT hr = ::SafeArrayPutElement(psa, indices, &param);
+
+	return hr;
+}
+
+
+/*
+* @brief Set value of type doulbe for the element in a two-dimensional SAFEARRAY.
+* @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
+*/
+HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, double value)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+	
+	long indices[2];
+	indices[0] = dim1;
+	indices[1] = dim2;
+	
+	VARIANT param;
+	param.vt = VT_R8;
+	param.dblVal = value;
+	
+    HRESULT hr = ::SafeArrayPutElement(psa, indices, &param);
+
+	return hr;
+}
+
+
+/*
+* @brief Encode values in a two-dimensional SAFEARRAY object into string form.
+* @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+*                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+* @param [out] encodedStr The corresponding encoded string of the array.
+* @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
+*         ::SafeArrayAccessData() or ::VariantChangeType().
+* @note Encoding format: @n
+*         EncodingString := <number of rows>#<number of columns>#{Values}            @n
+*         Values := {RowValues}{RowValues}...{RowValues}              --> All rows in the two-dimentional array    @n
+*         RowValues := {ColumnValue}{ColumnValue}...{ColumnValue}     --> All columns of in one row     @n
+*         ColumnValue := <number of characters>#<the character string of the value>          @n
+*       Example: @n
+*         For the two-dimensional array (2*5) @n
+*           { {abc, de, fghi, 3, 5235}, {23, 5353, 3253, 32} }, @n
+*         The correpsonding encoded string is 2#5#3#abc2#de4#fghi1#34#52352#234#53530#4#32532#32.    @n
+* @see ComUtil::EncodeSafeArrayDim2Typed() for an encoding which keeps the type of every value.
+*/
+HRESULT ComUtil::EncodeSafeArrayDim2(SAFEARRAY *psa, ELstring &encodedStr)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+
+    SafeArrayDim2Data data(psa);
+    if (FAILED(data.Status()))
+        return data.Status();
+
+    LONG rows = data.CountRows();
+    LONG columns = data.CountColumns();
+
+    ELstring encoded;
+
+    // Encoding format: <row>#<column>#
+    RangeCodec::AppendNumber(encoded, rows);
+    RangeCodec::AppendNumber(encoded, columns);
+
+    for (LONG i = 0; i < rows; ++i)
+    {
+        for (LONG j = 0; j < columns; ++j)
+        {
+            const VARIANT &var = data.At(i, j);
+
+            // Encoding format: <number of characters>#<characters>
+            if (var.vt == VT_BSTR)
+            {
+                RangeCodec::AppendValue(encoded, var.bstrVal, ::SysStringLen(var.bstrVal));
+                continue;
+            }
+
+            // convert the VARIANT object into a string value
+            VARIANT str;
+            ::VariantInit(&str);
+
+            HRESULT hr = ::VariantChangeType(&str, const_cast<VARIANT*>(&var), VARIANT_NOUSEROVERRIDE, VT_BSTR);
+            if (FAILED(hr))
+                return hr;
+
+            RangeCodec::AppendValue(encoded, str.bstrVal, ::SysStringLen(str.bstrVal));
+            ::VariantClear(&str);
+        }
+    }
+
+    // return the encoded string
+    encodedStr.swap(encoded);
+
+    return S_OK;
+}
+
+
+/*
+* @brief Class SafeArrayBuilder is the RangeCodec visitor which creates a two-dimensional SAFEARRAY
+*        and stores every decoded value into it as a BSTR.
+*/
+class SafeArrayBuilder : public Noncopyable
+{
+public:
+    SafeArrayBuilder(): m_psa(NULL), m_pData(NULL)
+    {
+    }
+
+    ~SafeArrayBuilder()
+    {
+        delete m_pData;
+
+        if (m_psa)
+            ::SafeArrayDestroy(m_psa);
+    }
+
+    bool Begin(int rows, int columns)
+    {
+        SAFEARRAYBOUND sab[2];
+        sab[0].lLbound = 1;
+        sab[0].cElements = rows;
+        sab[1].lLbound = 1;
+        sab[1].cElements = columns;
+
+        m_psa = ::SafeArrayCreate(VT_VARIANT, 2, sab);
+        if (!m_psa)
+            return false;   // failed to create an array
+
+        m_pData = new SafeArrayDim2Data(m_psa);
+        return SUCCEEDED(m_pData->Status());
+    }
+
+    bool Value(int row, int column, const ELchar *value, size_t length)
+    {
+        // the element is VT_EMPTY in a new array, so the BSTR is stored in place
+        VARIANT &var = m_pData->At(row, column);
+        var.bstrVal = ::SysAllocStringLen(value, static_cast<UINT>(length));
+        if (!var.bstrVal)
+            return false;
+
+        var.vt = VT_BSTR;
+        return true;
+    }
+
+    SAFEARRAY* Detach()
+    {
+        delete m_pData;
+        m_pData = NULL;
+
+        SAFEARRAY *psa = m_psa;
+        m_psa = NULL;
+        return psa;
+    }
+
+private:
+    SAFEARRAY         *m_psa;
+    SafeArrayDim2Data *m_pData;
+};
+
+
+/*
+* @brief Decode the data from the encoded string and create an SAFEARRAY to store the data.
+* @param [in] data The encoded string of a two dimensional array.
+* @return An SAFEARRAY with decoded data from encoded string. 
+*         If failed to decode the <em>data</em>, NULL will be returned.
+*/
+SAFEARRAY* ComUtil::DecodeSafeArrayDim2(const ELchar *data)
+{
+    assert(data);
+
+    SafeArrayBuilder builder;
+    if (!RangeCodec::Decode(data, std::char_traits<ELchar>::length(data), builder))
+        return NULL;   // no data or dirty data
+
+    return builder.Detach();
+}
+
+
+
+/*
+* @brief Append one VARIANT to a buffer in the typed binary encoding.
+* @param [in] pVar Pointer to the VARIANT. Must not be NULL.
+* @param [in,out] writer The writer of the typed binary encoding.
+* @return S_OK, or any value which can be returned by ::VariantChangeType() for a type which has
+*         no tag of its own (it is stored as a string then).
+*/
+HRESULT ComUtil::EncodeVariantTyped(const VARIANT *pVar, ExcelTypedWriter &writer)
+{
+    assert(pVar);
+
+    switch (pVar->vt)
+    {
+    case VT_EMPTY:
+    case VT_NULL:
+        writer.PutEmpty();
+        break;
+
+    case VT_R8:
+        writer.PutDouble(pVar->dblVal);
+        break;
+
+    case VT_R4:
+        writer.PutDouble(pVar->fltVal);
+        break;
+
+    case VT_CY:
+        writer.PutDouble(pVar->cyVal.int64 / 10000.0);
+        break;
+
+    case VT_DATE:
+        writer.PutDate(pVar->date);
+        break;
+
+    case VT_I1:
+        writer.PutInt64(pVar->cVal);
+        break;
+
+    case VT_UI1:
+        writer.PutInt64(pVar->bVal);
+        break;
+
+    case VT_I2:
+        writer.PutInt64(pVar->iVal);
+        break;
+
+    case VT_UI2:
+        writer.PutInt64(pVar->uiVal);
+        break;
+
+    case VT_I4:
+        writer.PutInt64(pVar->lVal);
+        break;
+
+    case VT_UI4:
+        writer.PutInt64(pVar->ulVal);
+        break;
+
+    case VT_INT:
+        writer.PutInt64(pVar->intVal);
+        break;
+
+    case VT_UINT:
+        writer.PutInt64(pVar->uintVal);
+        break;
+
+    case VT_I8:
+        writer.PutInt64(pVar->llVal);
+        break;
+
+    case VT_BOOL:
+        writer.PutBool(pVar->boolVal != VARIANT_FALSE);
+        break;
+
+    case VT_ERROR:
+        writer.PutError(pVar->scode);
+        break;
+
+    case VT_BSTR:
+        writer.PutString(pVar->bstrVal, ::SysStringLen(pVar->bstrVal));
+        break;
+
+    default:
+        {
+            // no tag for this type, store it as a string
+            VARIANT str;
+            ::VariantInit(&str);
+
+            HRESULT hr = ::VariantChangeType(&str, const_cast<VARIANT*>(pVar), VARIANT_NOUSEROVERRIDE, VT_BSTR);
+            if (FAILED(hr))
+                return hr;
+
+            writer.PutString(str.bstrVal, ::SysStringLen(str.bstrVal));
+            ::VariantClear(&str);
+        }
+        break;
+    }
+
+    return S_OK;
+}
+
+
+/*
+* @brief Encode values in a two-dimensional SAFEARRAY object into the typed binary encoding.
+* @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+*                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+* @param [out] encoded The corresponding encoded data of the array.
+* @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
+*         ::SafeArrayAccessData() or ComUtil::EncodeVariantTyped().
+*/
+HRESULT ComUtil::EncodeSafeArrayDim2Typed(SAFEARRAY *psa, std::vector<unsigned char> &encoded)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+
+    SafeArrayDim2Data data(psa);
+    if (FAILED(data.Status()))
+        return data.Status();
+
+    LONG rows = data.CountRows();
+    LONG columns = data.CountColumns();
+
+    encoded.clear();
+    ExcelTypedWriter writer(encoded);
+    writer.Begin(rows, columns);
+
+    for (LONG i = 0; i < rows; ++i)
+    {
+        for (LONG j = 0; j < columns; ++j)
+        {
+            HRESULT hr = EncodeVariantTyped(&data.At(i, j), writer);
+            if (FAILED(hr))
+                return hr;
+        }
+    }
+
+    return S_OK;
+}
+
+
+/*
+* @brief Store one decoded value of the typed binary encoding into a VARIANT.
+* @param [in] value The decoded value.
+* @param [out] pVar Pointer to a VARIANT which is not initialized yet. Must not be NULL.
+* @return S_OK, or E_OUTOFMEMORY if a string cannot be allocated
+*/
+HRESULT ComUtil::DecodeVariantTyped(const ExcelTypedValue &value, VARIANT *pVar)
+{
+    assert(pVar);
+
+    ::VariantInit(pVar);
+
+    switch (value.tag)
+    {
+    case ETT_Double:
+        pVar->vt = VT_R8;
+        pVar->dblVal = value.number;
+        break;
+
+    case ETT_Date:
+        pVar->vt = VT_DATE;
+        pVar->date = value.number;
+        break;
+
+    case ETT_Int64:
+        // Excel keeps every number as a double, and older versions reject VT_I8
+        if (value.integer >= -0x7FFFFFFFLL - 1 && value.integer <= 0x7FFFFFFFLL)
+        {
+            pVar->vt = VT_I4;
+            pVar->lVal = static_cast<LONG>(value.integer);
+        }
+        else
+        {
+            pVar->vt = VT_R8;
+            pVar->dblVal = static_cast<double>(value.integer);
+        }
+        break;
+
+    case ETT_Bool:
+        pVar->vt = VT_BOOL;
+        pVar->boolVal = (value.boolean ? VARIANT_TRUE : VARIANT_FALSE);
+        break;
+
+    case ETT_Error:
+        pVar->vt = VT_ERROR;
+        pVar->scode = value.error;
+        break;
+
+    case ETT_String16:
+    case ETT_String8:
+        {
+            std::wstring str = value.GetString();
+            pVar->vt = VT_BSTR;
+            pVar->bstrVal = ::SysAllocStringLen(str.c_str(), static_cast<UINT>(str.length()));
+            if (!pVar->bstrVal)
+            {
+                pVar->vt = VT_EMPTY;
+                return E_OUTOFMEMORY;
+            }
+        }
+        break;
+
+    default:
+        break;  // VT_EMPTY
+    }
+
+    return S_OK;
+}
+
+
+/*
+* @brief Decode data in the typed binary encoding and create an SAFEARRAY to store the data.
+* @param [in] data The encoded data of a two dimensional array.
+* @param [in] size Number of bytes in @e data.
+* @return An SAFEARRAY with decoded data from encoded data. 
+*         If failed to decode the <em>data</em>, NULL will be returned.
+*/
+SAFEARRAY* ComUtil::DecodeSafeArrayDim2Typed(const unsigned char *data, size_t size)
+{
+    assert(data || size == 0);
+
+    ExcelTypedReader reader(data, size);
+
+    int row = 0;
+    int column = 0;
+    if (!reader.ReadHeader(row, column) || row <= 0 || column <= 0)
+        return NULL;   // no data or dirty data
+
+    SAFEARRAYBOUND sab[2];
+    sab[0].lLbound = 1;
+    sab[0].cElements = row;
+    sab[1].lLbound = 1;
+    sab[1].cElements = column;
+
+    SAFEARRAY *psa = ::SafeArrayCreate(VT_VARIANT, 2, sab);
+    if (!psa)
+        return NULL;   // failed to create an array
+
+    bool validState = true;  // flag indicating whether the data is well formed
+
+    {
+        SafeArrayDim2Data elements(psa);
+        validState = SUCCEEDED(elements.Status());
+
+        for (int i = 0; validState && i < row; ++i)
+        {
+            for (int j = 0; validState && j < column; ++j)
+            {
+                ExcelTypedValue value;
+                validState = reader.Next(value) && SUCCEEDED(DecodeVariantTyped(value, &elements.At(i, j)));
+            }
+        }
+    }
+
+    if (!validState) {
+        ::SafeArrayDestroy(psa);
+        psa = NULL;
+    }
+
+    return psa;
+}
+
+
+/*
+* @brief Convert one VARIANT to an ExcelValue, without formatting a number as text.
+* @param [in] pVar Pointer to the VARIANT. Must not be NULL.
+* @param [out] value Which returns the value.
+* @return S_OK, or any value which can be returned by ::VariantChangeType() for a type which has
+*         no ExcelValueType of its own (it is stored as a string then).
+*/
+HRESULT ComUtil::VariantToValue(const VARIANT *pVar, ExcelValue &value)
+{
+    assert(pVar);
+
+    switch (pVar->vt)
+    {
+    case VT_EMPTY:
+    case VT_NULL:
+        value.Clear();
+        break;
+
+    case VT_R8:
+        value.SetDouble(pVar->dblVal);
+        break;
+
+    case VT_R4:
+        value.SetDouble(pVar->fltVal);
+        break;
+
+    case VT_CY:
+        value.SetDouble(pVar->cyVal.int64 / 10000.0);
+        break;
+
+    case VT_DATE:
+        value.SetDate(pVar->date);
+        break;
+
+    case VT_I1:
+        value.SetInt64(pVar->cVal);
+        break;
+
+    case VT_UI1:
+        value.SetInt64(pVar->bVal);
+        break;
+
+    case VT_I2:
+        value.SetInt64(pVar->iVal);
+        break;
+
+    case VT_UI2:
+        value.SetInt64(pVar->uiVal);
+        break;
+
+    case VT_I4:
+        value.SetInt64(pVar->lVal);
+        break;
+
+    case VT_UI4:
+        value.SetInt64(pVar->ulVal);
+        break;
+
+    case VT_INT:
+        value.SetInt64(pVar->intVal);
+        break;
+
+    case VT_UINT:
+        value.SetInt64(pVar->uintVal);
+        break;
+
+    case VT_I8:
+        value.SetInt64(pVar->llVal);
+        break;
+
+    case VT_BOOL:
+        value.SetBool(pVar->boolVal != VARIANT_FALSE);
+        break;
+
+    case VT_ERROR:
+        value.SetError(pVar->scode);
+        break;
+
+    case VT_BSTR:
+        value.SetString(pVar->bstrVal ? pVar->bstrVal : L"", ::SysStringLen(pVar->bstrVal));
+        break;
+
+    default:
+        {
+            // no ExcelValueType for this type, store it as a string
+            VARIANT str;
+            ::VariantInit(&str);
+
+            HRESULT hr = ::VariantChangeType(&str, const_cast<VARIANT*>(pVar), VARIANT_NOUSEROVERRIDE, VT_BSTR);
+            if (FAILED(hr))
+                return hr;
+
+            value.SetString(str.bstrVal ? str.bstrVal : L"", ::SysStringLen(str.bstrVal));
+            ::VariantClear(&str);
+        }
+        break;
+    }
+
+    return S_OK;
+}
+
+
+/*
+* @brief Store an ExcelValue into a VARIANT.
+* @param [in] value The value.
+* @param [out] pVar Pointer to a VARIANT which is not initialized yet. Must not be NULL.
+* @return S_OK, or E_OUTOFMEMORY if a string cannot be allocated
+*/
+HRESULT ComUtil::ValueToVariant(const ExcelValue &value, VARIANT *pVar)
+{
+    assert(pVar);
+
+    ::VariantInit(pVar);
+
+    switch (value.GetType())
+    {
+    case EVT_Double:
+        pVar->vt = VT_R8;
+        pVar->dblVal = value.GetDouble();
+        break;
+
+    case EVT_Date:
+        pVar->vt = VT_DATE;
+        pVar->date = value.GetDouble();
+        break;
+
+    case EVT_Int64:
+        // Excel keeps every number as a double, and older versions reject VT_I8
+        if (value.GetInt64() >= -0x7FFFFFFFLL - 1 && value.GetInt64() <= 0x7FFFFFFFLL)
+        {
+            pVar->vt = VT_I4;
+            pVar->lVal = static_cast<LONG>(value.GetInt64());
+        }
+        else
+        {
+            pVar->vt = VT_R8;
+            pVar->dblVal = static_cast<double>(value.GetInt64());
+        }
+        break;
+
+    case EVT_Bool:
+        pVar->vt = VT_BOOL;
+        pVar->boolVal = (value.GetBool() ? VARIANT_TRUE : VARIANT_FALSE);
+        break;
+
+    case EVT_Error:
+        pVar->vt = VT_ERROR;
+        pVar->scode = value.GetError();
+        break;
+
+    case EVT_String:
+        {
+            const ELstring &str = value.GetString();
+            pVar->vt = VT_BSTR;
+            pVar->bstrVal = ::SysAllocStringLen(str.c_str(), static_cast<UINT>(str.length()));
+            if (!pVar->bstrVal)
+            {
+                pVar->vt = VT_EMPTY;
+                return E_OUTOFMEMORY;
+            }
+        }
+        break;
+
+    default:
+        break;  // VT_EMPTY
+    }
+
+    return S_OK;
+}
+
+
+/*
+* @brief Convert values in a two-dimensional SAFEARRAY object to ExcelValue objects, row by row.
+* @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+*                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+* @param [out] values Which returns the values; values[i * columns + j] is for row i and column j.
+* @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
+*         ::SafeArrayAccessData() or ComUtil::VariantToValue().
+*/
+HRESULT ComUtil::SafeArrayDim2ToValues(SAFEARRAY *psa, std::vector<ExcelValue> &values)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+
+    values.clear();
+
+    SafeArrayDim2Data data(psa);
+    if (FAILED(data.Status()))
+        return data.Status();
+
+    LONG rows = data.CountRows();
+    LONG columns = data.CountColumns();
+
+    // every value is converted in place, so a reused vector keeps its strings
+    values.resize(static_cast<size_t>(rows) * columns);
+
+    for (LONG i = 0; i < rows; ++i)
+    {
+        for (LONG j = 0; j < columns; ++j)
+        {
+            HRESULT hr = VariantToValue(&data.At(i, j), values[static_cast<size_t>(i) * columns + j]);
+            if (FAILED(hr))
+                return hr;
+        }
+    }
+
+    return S_OK;
+}
+
+
+/*
+* @brief Create a two-dimensional SAFEARRAY to store ExcelValue objects.
+* @param [in] values The values, row by row; values[i * columns + j] is for row i and column j.
+* @param [in] rows Number of rows.
+* @param [in] columns Number of columns.
+* @return An SAFEARRAY with the values, or NULL if the size of @e values is not rows * columns
+*         or the array cannot be created.
+*/
+SAFEARRAY* ComUtil::ValuesToSafeArrayDim2(const std::vector<ExcelValue> &values, int rows, int columns)
+{
+    if (rows <= 0 || columns <= 0 || values.size() != static_cast<size_t>(rows) * columns)
+        return NULL;
+
+    SAFEARRAYBOUND sab[2];
+    sab[0].lLbound = 1;
+    sab[0].cElements = rows;
+    sab[1].lLbound = 1;
+    sab[1].cElements = columns;
+
+    SAFEARRAY *psa = ::SafeArrayCreate(VT_VARIANT, 2, sab);
+    if (!psa)
+        return NULL;   // failed to create an array
+
+    bool validState = true;
+
+    {
+        SafeArrayDim2Data elements(psa);
+        validState = SUCCEEDED(elements.Status());
+
+        for (int i = 0; validState && i < rows; ++i)
+        {
+            for (int j = 0; validState && j < columns; ++j)
+            {
+                const ExcelValue &value = values[static_cast<size_t>(i) * columns + j];
+                validState = SUCCEEDED(ValueToVariant(value, &elements.At(i, j)));
+            }
+        }
+    }
+
+    if (!validState) {
+        ::SafeArrayDestroy(psa);
+        psa = NULL;
+    }
+
+    return psa;
+}
+
+
+/*
+* @brief Store one VARIANT into entry @e row of a typed column buffer.
+* @param [in] pVar Pointer to the VARIANT. Must not be NULL.
+* @param [in,out] column The buffer, which has been reset for the rows of the range.
+* @param [in] row Index of the entry.
+*/
+void ComUtil::VariantToColumn(const VARIANT *pVar, ExcelColumn &column, size_t row)
+{
+    assert(pVar);
+    assert(row < column.Size());
+
+    switch (pVar->vt)
+    {
+    case VT_EMPTY:
+    case VT_NULL:
+    case VT_ERROR:
+        return;     // not valid
+
+    case VT_BSTR:
+        if (column.type == ECT_String)
+        {
+            column.strings[row].assign(pVar->bstrVal ? pVar->bstrVal : L"", ::SysStringLen(pVar->bstrVal));
+            column.valid[row] = true;
+        }
+        return;     // a string in a numeric column is not parsed
+
+    case VT_BOOL:
+        if (column.type != ECT_String)
+        {
+            // ::VariantChangeType() makes -1 of VARIANT_TRUE
+            ExcelUtil::SetColumnNumber(column, row, pVar->boolVal != VARIANT_FALSE ? 1 : 0);
+            return;
+        }
+        break;
+
+    case VT_R8:
+        ExcelUtil::SetColumnNumber(column, row, pVar->dblVal);
+        if (column.type != ECT_String)
+            return;
+        break;
+
+    default:
+        break;
+    }
+
+    VARIANT converted;
+    ::VariantInit(&converted);
+
+    VARTYPE type = (column.type == ECT_String ? VT_BSTR : VT_R8);
+    if (FAILED(::VariantChangeType(&converted, const_cast<VARIANT*>(pVar), VARIANT_NOUSEROVERRIDE, type)))
+        return;     // not valid
+
+    if (type == VT_BSTR)
+    {
+        // formatted as ComUtil::EncodeSafeArrayDim2() does
+        column.strings[row].assign(converted.bstrVal, ::SysStringLen(converted.bstrVal));
+        column.valid[row] = true;
+    }
+    else
+    {
+        ExcelUtil::SetColumnNumber(column, row, converted.dblVal);
+    }
+
+    ::VariantClear(&converted);
+}
+
+
+/*
+* @brief Store values in a two-dimensional SAFEARRAY object into typed column buffers.
+* @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+*                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+* @param [in,out] columns One buffer per column of the array, whose type is set by the caller.
+* @return E_INVALIDARG if the number of buffers is not the number of columns, or any value which can be
+*         returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound() or ::SafeArrayAccessData().
+*/
+HRESULT ComUtil::SafeArrayDim2ToColumns(SAFEARRAY *psa, std::vector<ExcelColumn> &columns)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+
+    SafeArrayDim2Data data(psa);
+    if (FAILED(data.Status()))
+        return data.Status();
+
+    LONG rows = data.CountRows();
+    LONG count = data.CountColumns();
+
+    if (!ExcelUtil::PrepareColumns(columns, count, rows))
+        return E_INVALIDARG;
+
+    // the array is column-major, so a column is read in the order of the elements
+    for (LONG j = 0; j < count; ++j)
+    {
+        for (LONG i = 0; i < rows; ++i)
+            VariantToColumn(&data.At(i, j), columns[j], i);
+    }
+
+    return S_OK;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class SafeArrayDim2Data
+
+SafeArrayDim2Data::SafeArrayDim2Data(SAFEARRAY *psa): m_psa(NULL), m_pData(NULL), m_rows(0), m_columns(0)
+{
+    assert(psa);
+    assert(::SafeArrayGetDim(psa) == 2);
+
+    LONG rowFrom = 0;
+    LONG rowTo = 0;
+    LONG columnFrom = 0;
+    LONG columnTo = 0;
+
+    m_status = ::SafeArrayGetLBound(psa, 1, &rowFrom);
+    if (FAILED(m_status))
+        return;
+
+    m_status = ::SafeArrayGetUBound(psa, 1, &rowTo);
+    if (FAILED(m_status))
+        return;
+
+    m_status = ::SafeArrayGetLBound(psa, 2, &columnFrom);
+    if (FAILED(m_status))
+        return;
+
+    m_status = ::SafeArrayGetUBound(psa, 2, &columnTo);
+    if (FAILED(m_status))
+        return;
+
+    void *pData = NULL;
+    m_status = ::SafeArrayAccessData(psa, &pData);
+    if (FAILED(m_status))
+        return;
+
+    m_psa = psa;
+    m_pData = static_cast<VARIANT*>(pData);
+    m_rows = rowTo - rowFrom + 1;
+    m_columns = columnTo - columnFrom + 1;
+}
+
+
+SafeArrayDim2Data::~SafeArrayDim2Data()
+{
+    Release();
+}
+
+
+void SafeArrayDim2Data::Release()
+{
+    if (m_psa)
+    {
+        ::SafeArrayUnaccessData(m_psa);
+        m_psa = NULL;
+        m_pData = NULL;
+    }
+}
+
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -1,119 +1,419 @@
-﻿/*!
-* @file    ComUtil.h
-* @brief   Header file for class ComUtil
-* @date    2009-12-09
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef COMUTIL_H_GUID_79FBF1F4_971A_489D_AD88_92DE25791DC9
-#define COMUTIL_H_GUID_79FBF1F4_971A_489D_AD88_92DE25791DC9
-
-
-#include <windows.h>
-#include "LibDef.h"
-#include "StringUtil.h"
-
-
-// namespace start
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-/*!
-* @brief Class ComUtil is an utility class which provides some wrapper functions for COM operation. 
-*        All the members of ComUtil are static member.
-* @note ComUtil is not intended and allowed to be instantiated.
-*/
-class ComUtil
-{
-public:
-    /*!
-    * @brief ComUtil::Invoke is a wrapper of IDispatch::Invoke(), which is provided to simplify our work.
-    * @param [in] pDisp Pointer to IDispatch. Must not be NULL.
-    * @param [in] type Three values are allowed: DISPATCH_METHOD, DISPATCH_PROPERTYGET, DISPATCH_PROPERTYPUT
-    * @param [in] name Name of the method or property involved.
-    * @param [out] pResult Pointer to a variant which holds the results. Can be NULL.
-    * @param [in] argc Number of the variant parameters. Must be equal or greater than 0.
-    * @param [in] ... The variant parameters list. Their types must be VARIANT.
-    * @return Any value which can be returned by IDispatch::GetIDsOfNames() or IDispatch::Invoke().
-    */
-    static HRESULT Invoke(IDispatch *pDisp, WORD type, LPOLESTR name, VARIANT *pResult, int argc, ...);
-
-    /*!
-    * @brief Get an element of a two-dimensional SAFEARRAY. 
-    *        ComUtil::GetSafeArrayElementDim2() is a wrapper of ::SafeArrayGetElements().
-    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
-    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
-    * @param [in] dim1 Index of the first dimension of the array.
-    * @param [in] dim2 Index of the second dimension of the array.
-    * @param [out] pResult Pointer to a VARIANT object to save the result. Must not be NULL.
-    * @return Any value which can be returned by ::SafeArrayGetElements().
-    */
-    static HRESULT GetSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, VARIANT *pResult);
-
-    /*!
-    * @brief Set value of type string for the element in a two-dimensional SAFEARRAY. 
-    *        ComUtil::PutSafeArrayElementDim2() is a wrapper of ::SafeArrayPutElement().
-    * @param [in,out] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
-    *                     Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
-    * @param [in] dim1 Index of the first dimension of the array.
-    * @param [in] dim2 Index of the second dimension of the array.
-    * @param [in] value An OLE string which will be saved into the array.
-    * @return Any value which can be returned by ::SafeArrayPutElement().
-    */
-    static HRESULT PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value);
-
-    /*!
-    * @brief Set value of type int for the element in a two-dimensional SAFEARRAY.
-    * @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
-    */
-    static HRESULT PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, int value);
-
-    /*!
-    * @brief Set value of type doulbe for the element in a two-dimensional SAFEARRAY.
-    * @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
-    */
-    static HRESULT PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, double value);
-
-
-    /*!
-    * @brief Encode values in a two-dimensional SAFEARRAY object into string form.
-    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
-    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
-    * @param [out] encodedStr The corresponding encoded string of the array.
-    * @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
-    *         ::VariantChangeType() or ComUtil::GetSafeArrayElementDim2().
-    * @note Encoding format: @n
-    *         EncodingString := <number of rows>#<number of columns>#{Values}            @n
-    *         Values := {RowValues}{RowValues}...{RowValues}              --> All rows in the two-dimentional array    @n
-    *         RowValues := {ColumnValue}{ColumnValue}...{ColumnValue}     --> All columns of in one row     @n
-    *         ColumnValue := <number of characters>#<the character string of the value>          @n
-    *       Example: @n
-    *         For the two-dimensional array (2*5) @n
-    *           { {abc, de, fghi, 3, 5235}, {23, 5353, 3253, 32} }, @n
-    *         The correpsonding encoded string is 2#5#3#abc2#de4#fghi1#34#52352#234#53530#4#32532#32.    @n
-    * @todo Add type info into the encoded string.
-    */
-    static HRESULT EncodeSafeArrayDim2(SAFEARRAY *psa, ELstring &encodedStr);
-
-    /*!
-    * @brief Decode the data from the encoded string and create an SAFEARRAY to store the data.
-    * @param [in] data The encoded string of a two dimensional array.
-    * @return An SAFEARRAY with decoded data from encoded string. 
-    *         If failed to decode the <em>data</em>, NULL will be returned.
-    * @note The encoding format of @e data must be the one specified in ComUtil::EncodeSafeArrayDim2().
-    */
-    static SAFEARRAY* DecodeSafeArrayDim2(const ELchar *data);
-
-private:
-    // Forbid instantiation
-    ComUtil();
-};
-
-
-// namespace end
-EXCEL_AUTOMATION_NAMESPACE_END
-
-
-#endif //COMUTIL_H_GUID_79FBF1F4_971A_489D_AD88_92DE25791DC9
+﻿/*!
+* @file    ComUtil.h
+* @brief   Header file for class ComUtil
+* @date    2009-12-09
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef COMUTIL_H_GUID_79FBF1F4_971A_489D_AD88_92DE25791DC9
+#define COMUTIL_H_GUID_79FBF1F4_971A_489D_AD88_92DE25791DC9
+
+
+#include <windows.h>
+#include <cassert>
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "ExcelTypedCodec.h"
+#include "ExcelValue.h"
+#include "ExcelColumns.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Class ComArg turns a native C++ value into a VARIANT parameter for ComUtil::Invoke().
+* @details ComArg is meant to be a temporary in the call of ComUtil::Invoke(), and its constructors are
+*          implicit for that reason: @n
+*            ComUtil::Invoke(pFont, OLESTR("Font"), DISPATCH_PROPERTYPUT, OLESTR("Size"), NULL, 12); @n
+*          Only a string needs a heap allocation (a BSTR), which is freed by the destructor.
+* @note An IDispatch pointer or a VARIANT is borrowed: it is neither AddRef()-ed nor copied.
+*/
+class ComArg
+{
+public:
+    ComArg(int value): m_owned(false)
+    {
+        m_var.vt = VT_INT;
+        m_var.intVal = value;
+    }
+
+    ComArg(long value): m_owned(false)
+    {
+        m_var.vt = VT_I4;
+        m_var.lVal = value;
+    }
+
+    ComArg(unsigned long value): m_owned(false)
+    {
+        m_var.vt = VT_UI4;
+        m_var.ulVal = value;
+    }
+
+    ComArg(double value): m_owned(false)
+    {
+        m_var.vt = VT_R8;
+        m_var.dblVal = value;
+    }
+
+    ComArg(bool value): m_owned(false)
+    {
+        m_var.vt = VT_BOOL;
+        m_var.boolVal = value ? VARIANT_TRUE : VARIANT_FALSE;
+    }
+
+    ComArg(const ELchar *value);
+    ComArg(const ELstring &value);
+
+    ComArg(IDispatch *value): m_owned(false)
+    {
+        m_var.vt = VT_DISPATCH;
+        m_var.pdispVal = value;
+    }
+
+    ComArg(const VARIANT &value): m_var(value), m_owned(false)
+    {
+    }
+
+    ComArg(const ComArg &other);
+
+    ~ComArg();
+
+    /*!
+    * @brief The marker of an omitted optional parameter.
+    */
+    static ComArg Missing()
+    {
+        VARIANT var;
+        var.vt = VT_ERROR;
+        var.scode = DISP_E_PARAMNOTFOUND;
+        return ComArg(var);
+    }
+
+    const VARIANT& Get() const
+    {
+        return m_var;
+    }
+
+private:
+    ComArg& operator = (const ComArg &);
+
+    // Any other pointer would be converted to bool. Not defined, so that passing one does not compile.
+    template <class T>
+    ComArg(const T *value);
+
+private:
+    VARIANT m_var;
+    bool    m_owned;    // whether m_var holds a BSTR allocated by this ComArg
+};
+
+
+/*!
+* @brief Class ComUtil is an utility class which provides some wrapper functions for COM operation. 
+*        All the members of ComUtil are static member.
+* @note ComUtil is not intended and allowed to be instantiated.
+*/
+class ComUtil
+{
+public:
+    /*!
+    * @brief ComUtil::Invoke is a wrapper of IDispatch::Invoke(), which is provided to simplify our work.
+    * @param [in] pDisp Pointer to IDispatch. Must not be NULL.
+    * @param [in] typeName Name of the Excel type which @e pDisp belongs to, such as "Range".
+    *                      It is used as the key of the DISPID cache. If it is NULL, the cache is bypassed.
+    * @param [in] type Three values are allowed: DISPATCH_METHOD, DISPATCH_PROPERTYGET, DISPATCH_PROPERTYPUT
+    * @param [in] name Name of the method or property involved.
+    * @param [out] pResult Pointer to a variant which holds the results. Can be NULL.
+    * @return Any value which can be returned by IDispatch::GetIDsOfNames() or IDispatch::Invoke().
+    * @note The overloads with parameters take them as ComArg, so native values can be passed directly.
+    *       The DISPPARAMS are built on the stack, nothing is allocated on the heap.
+    */
+    static HRESULT Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult);
+
+    /*!
+    * @brief ComUtil::Invoke with one parameter.
+    * @see HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+    */
+    static HRESULT Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+        const ComArg &arg1);
+
+    /*!
+    * @brief ComUtil::Invoke with two parameters.
+    * @see HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+    */
+    static HRESULT Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+        const ComArg &arg1, const ComArg &arg2);
+
+    /*!
+    * @brief ComUtil::Invoke with three parameters.
+    * @see HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+    */
+    static HRESULT Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+        const ComArg &arg1, const ComArg &arg2, const ComArg &arg3);
+
+    /*!
+    * @brief ComUtil::Invoke with four parameters.
+    * @see HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+    */
+    static HRESULT Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+        const ComArg &arg1, const ComArg &arg2, const ComArg &arg3, const ComArg &arg4);
+
+    /*!
+    * @brief ComUtil::InvokeEarlyBound calls the typed vtable method of the dual interface when it is available,
+    *        otherwise it falls back to ComUtil::Invoke().
+    * @details It is meant for the hot members (such as "Value" of a Range), and it saves the name lookup,
+    *          the DISPPARAMS packing and the argument coercion of IDispatch::Invoke().
+    * @see HRESULT ComUtil::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+    * @see VtableBinding
+    */
+    static HRESULT InvokeEarlyBound(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult);
+
+    /*!
+    * @brief ComUtil::InvokeEarlyBound with one parameter.
+    * @see HRESULT ComUtil::InvokeEarlyBound(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult)
+    */
+    static HRESULT InvokeEarlyBound(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+        const ComArg &arg1);
+
+    /*!
+    * @brief Get an element of a two-dimensional SAFEARRAY. 
+    *        ComUtil::GetSafeArrayElementDim2() is a wrapper of ::SafeArrayGetElements().
+    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+    * @param [in] dim1 Index of the first dimension of the array.
+    * @param [in] dim2 Index of the second dimension of the array.
+    * @param [out] pResult Pointer to a VARIANT object to save the result. Must not be NULL.
+    * @return Any value which can be returned by ::SafeArrayGetElements().
+    */
+    static HRESULT GetSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, VARIANT *pResult);
+
+    /*!
+    * @brief Set value of type string for the element in a two-dimensional SAFEARRAY. 
+    *        ComUtil::PutSafeArrayElementDim2() is a wrapper of ::SafeArrayPutElement().
+    * @param [in,out] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+    *                     Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+    * @param [in] dim1 Index of the first dimension of the array.
+    * @param [in] dim2 Index of the second dimension of the array.
+    * @param [in] value An OLE string which will be saved into the array.
+    * @return Any value which can be returned by ::SafeArrayPutElement().
+    */
+    static HRESULT PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value);
+
+    /*!
+    * @brief Set value of type int for the element in a two-dimensional SAFEARRAY.
+    * @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
+    */
+    static HRESULT PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, int value);
+
+    /*!
+    * @brief Set value of type doulbe for the element in a two-dimensional SAFEARRAY.
+    * @see HRESULT ComUtil::PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, const OLECHAR *value)
+    */
+    static HRESULT PutSafeArrayElementDim2(SAFEARRAY *psa, long dim1, long dim2, double value);
+
+
+    /*!
+    * @brief Encode values in a two-dimensional SAFEARRAY object into string form.
+    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+    * @param [out] encodedStr The corresponding encoded string of the array.
+    * @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
+    *         ::SafeArrayAccessData() or ::VariantChangeType().
+    * @note Encoding format: @n
+    *         EncodingString := <number of rows>#<number of columns>#{Values}            @n
+    *         Values := {RowValues}{RowValues}...{RowValues}              --> All rows in the two-dimentional array    @n
+    *         RowValues := {ColumnValue}{ColumnValue}...{ColumnValue}     --> All columns of in one row     @n
+    *         ColumnValue := <number of characters>#<the character string of the value>          @n
+    *       Example: @n
+    *         For the two-dimensional array (2*5) @n
+    *           { {abc, de, fghi, 3, 5235}, {23, 5353, 3253, 32} }, @n
+    *         The correpsonding encoded string is 2#5#3#abc2#de4#fghi1#34#52352#234#53530#4#32532#32.    @n
+    * @see ComUtil::EncodeSafeArrayDim2Typed() for an encoding which keeps the type of every value.
+    */
+    static HRESULT EncodeSafeArrayDim2(SAFEARRAY *psa, ELstring &encodedStr);
+
+    /*!
+    * @brief Decode the data from the encoded string and create an SAFEARRAY to store the data.
+    * @param [in] data The encoded string of a two dimensional array.
+    * @return An SAFEARRAY with decoded data from encoded string. 
+    *         If failed to decode the <em>data</em>, NULL will be returned.
+    * @note The encoding format of @e data must be the one specified in ComUtil::EncodeSafeArrayDim2().
+    */
+    static SAFEARRAY* DecodeSafeArrayDim2(const ELchar *data);
+
+    /*!
+    * @brief Append one VARIANT to a buffer in the typed binary encoding.
+    * @param [in] pVar Pointer to the VARIANT. Must not be NULL.
+    * @param [in,out] writer The writer of the typed binary encoding.
+    * @return S_OK, or any value which can be returned by ::VariantChangeType() for a type which has
+    *         no tag of its own (it is stored as a string then).
+    */
+    static HRESULT EncodeVariantTyped(const VARIANT *pVar, ExcelTypedWriter &writer);
+
+    /*!
+    * @brief Encode values in a two-dimensional SAFEARRAY object into the typed binary encoding.
+    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+    * @param [out] encoded The corresponding encoded data of the array.
+    * @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
+    *         ::SafeArrayAccessData() or ComUtil::EncodeVariantTyped().
+    * @note The encoding format is the one specified in ExcelTypedCodec.h.
+    *       Unlike ComUtil::EncodeSafeArrayDim2(), every value keeps its type.
+    */
+    static HRESULT EncodeSafeArrayDim2Typed(SAFEARRAY *psa, std::vector<unsigned char> &encoded);
+
+    /*!
+    * @brief Store one decoded value of the typed binary encoding into a VARIANT.
+    * @param [in] value The decoded value.
+    * @param [out] pVar Pointer to a VARIANT which is not initialized yet. Must not be NULL.
+    * @return S_OK, or E_OUTOFMEMORY if a string cannot be allocated
+    */
+    static HRESULT DecodeVariantTyped(const ExcelTypedValue &value, VARIANT *pVar);
+
+    /*!
+    * @brief Convert one VARIANT to an ExcelValue, without formatting a number as text.
+    * @param [in] pVar Pointer to the VARIANT. Must not be NULL.
+    * @param [out] value Which returns the value.
+    * @return S_OK, or any value which can be returned by ::VariantChangeType() for a type which has
+    *         no ExcelValueType of its own (it is stored as a string then).
+    */
+    static HRESULT VariantToValue(const VARIANT *pVar, ExcelValue &value);
+
+    /*!
+    * @brief Store an ExcelValue into a VARIANT.
+    * @param [in] value The value.
+    * @param [out] pVar Pointer to a VARIANT which is not initialized yet. Must not be NULL.
+    * @return S_OK, or E_OUTOFMEMORY if a string cannot be allocated
+    */
+    static HRESULT ValueToVariant(const ExcelValue &value, VARIANT *pVar);
+
+    /*!
+    * @brief Convert values in a two-dimensional SAFEARRAY object to ExcelValue objects, row by row.
+    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+    * @param [out] values Which returns the values; values[i * columns + j] is for row i and column j.
+    * @return Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound(), 
+    *         ::SafeArrayAccessData() or ComUtil::VariantToValue().
+    */
+    static HRESULT SafeArrayDim2ToValues(SAFEARRAY *psa, std::vector<ExcelValue> &values);
+
+    /*!
+    * @brief Create a two-dimensional SAFEARRAY to store ExcelValue objects.
+    * @param [in] values The values, row by row; values[i * columns + j] is for row i and column j.
+    * @param [in] rows Number of rows.
+    * @param [in] columns Number of columns.
+    * @return An SAFEARRAY with the values, or NULL if the size of @e values is not rows * columns
+    *         or the array cannot be created.
+    */
+    static SAFEARRAY* ValuesToSafeArrayDim2(const std::vector<ExcelValue> &values, int rows, int columns);
+
+    /*!
+    * @brief Store one VARIANT into entry @e row of a typed column buffer.
+    * @param [in] pVar Pointer to the VARIANT. Must not be NULL.
+    * @param [in,out] column The buffer, which has been reset for the rows of the range.
+    * @param [in] row Index of the entry.
+    * @note A value which cannot be converted to the type of the buffer leaves the entry not valid.
+    */
+    static void VariantToColumn(const VARIANT *pVar, ExcelColumn &column, size_t row);
+
+    /*!
+    * @brief Store values in a two-dimensional SAFEARRAY object into typed column buffers.
+    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+    * @param [in,out] columns One buffer per column of the array, whose type is set by the caller.
+    * @return E_INVALIDARG if the number of buffers is not the number of columns, or any value which can be
+    *         returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound() or ::SafeArrayAccessData().
+    */
+    static HRESULT SafeArrayDim2ToColumns(SAFEARRAY *psa, std::vector<ExcelColumn> &columns);
+
+    /*!
+    * @brief Decode data in the typed binary encoding and create an SAFEARRAY to store the data.
+    * @param [in] data The encoded data of a two dimensional array.
+    * @param [in] size Number of bytes in @e data.
+    * @return An SAFEARRAY with decoded data from encoded data. 
+    *         If failed to decode the <em>data</em>, NULL will be returned.
+    * @note The encoding format of @e data must be the one specified in ExcelTypedCodec.h.
+    */
+    static SAFEARRAY* DecodeSafeArrayDim2Typed(const unsigned char *data, size_t size);
+
+private:
+    // Do the invocation, the parameters in @e pArgs are in reversed order as DISPPARAMS requires
+    static HRESULT InvokeArgs(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult, 
+        VARIANT *pArgs, UINT argc);
+
+    // Forbid instantiation
+    ComUtil();
+};
+
+
+/*!
+* @brief Class SafeArrayDim2Data gives direct access to the elements of a two-dimensional SAFEARRAY of VARIANT.
+* @details The array is locked once with ::SafeArrayAccessData() in the constructor and unlocked in the
+*          destructor, so the elements can be read and written in place. This avoids the per-element
+*          locking and VARIANT copying of ::SafeArrayGetElement() and ::SafeArrayPutElement().
+* @note Elements are stored in column-major order: the first dimension (row) changes fastest.
+*/
+class SafeArrayDim2Data : public Noncopyable
+{
+public:
+    /*!
+    * @param [in] psa Pointer to an SAFEARRAY object which should be a two-dimensional array. 
+    *                 Must not be NULL. Element type of the SAFEARRAY object must be VARIANT.
+    */
+    explicit SafeArrayDim2Data(SAFEARRAY *psa);
+
+    ~SafeArrayDim2Data();
+
+    /*!
+    * @brief Any value which can be returned by ::SafeArrayGetLBound(), ::SafeArrayGetUBound() or
+    *        ::SafeArrayAccessData(). Other members can only be used if it is a success code.
+    */
+    HRESULT Status() const
+    {
+        return m_status;
+    }
+
+    LONG CountRows() const
+    {
+        return m_rows;
+    }
+
+    LONG CountColumns() const
+    {
+        return m_columns;
+    }
+
+    /*!
+    * @brief Return the element for row @e row and column @e column (both start from 0)
+    */
+    VARIANT& At(LONG row, LONG column) const
+    {
+        assert(SUCCEEDED(m_status));
+        assert(row >= 0 && row < m_rows && column >= 0 && column < m_columns);
+        return m_pData[row + column * m_rows];
+    }
+
+    /*!
+    * @brief Unlock the array before the destructor does.
+    */
+    void Release();
+
+private:
+    SAFEARRAY *m_psa;
+    VARIANT   *m_pData;
+    LONG       m_rows;
+    LONG       m_columns;
+    HRESULT    m_status;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //COMUTIL_H_GUID_79FBF1F4_971A_489D_AD88_92DE25791DC9
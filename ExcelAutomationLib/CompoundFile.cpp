@@ -0,0 +1,315 @@
+﻿/*!
+* @file    CompoundFile.cpp
+* @brief   Implementation file for class CompoundFile and CompoundStreamReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstring>
+#include "CompoundFile.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    const unsigned char Signature[8] = { 0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1 };
+
+    const size_t HeaderSize          = 512;
+    const size_t HeaderDifatCount    = 109;
+    const size_t DirectoryEntrySize  = 128;
+
+    // special values of the FAT
+    const unsigned long MaxRegularSector = 0xFFFFFFFAUL;
+    const unsigned long EndOfChain       = 0xFFFFFFFEUL;
+    const unsigned long NoStream         = 0xFFFFFFFFUL;
+
+    unsigned long GetUInt16(const unsigned char *p)
+    {
+        return p[0] | (static_cast<unsigned long>(p[1]) << 8);
+    }
+
+    unsigned long GetUInt32(const unsigned char *p)
+    {
+        return GetUInt16(p) | (GetUInt16(p + 2) << 16);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class CompoundFile
+
+bool CompoundFile::IsCompoundFile(const unsigned char *header, size_t size)
+{
+    return size >= sizeof(Signature) && memcmp(header, Signature, sizeof(Signature)) == 0;
+}
+
+
+bool CompoundFile::Open(const ELstring &filename)
+{
+    m_fat.clear();
+    m_miniFat.clear();
+    m_entries.clear();
+    m_miniStream.chunks.clear();
+
+    if (!m_package.Open(filename) || m_package.Size() < HeaderSize)
+        return false;
+
+    const unsigned char *header = m_package.Data();
+    if (!IsCompoundFile(header, HeaderSize) || GetUInt16(header + 0x1C) != 0xFFFE)
+        return false;
+
+    // version 3 has 512-byte sectors, version 4 has 4096-byte ones
+    unsigned long sectorShift = GetUInt16(header + 0x1E);
+    unsigned long miniSectorShift = GetUInt16(header + 0x20);
+    if ((sectorShift != 9 && sectorShift != 12) || miniSectorShift != 6)
+        return false;
+
+    m_sectorSize = static_cast<size_t>(1) << sectorShift;
+    m_miniSectorSize = static_cast<size_t>(1) << miniSectorShift;
+    m_miniStreamCutoff = GetUInt32(header + 0x38);
+
+    if (!ReadFat(header) || !ReadDirectory(GetUInt32(header + 0x30)))
+        return false;
+
+    // The MiniFAT, and the mini stream which is the stream of the root entry
+    std::vector<unsigned long> chain;
+    if (!GetChain(m_fat, GetUInt32(header + 0x3C), m_fat.size(), chain))
+        return false;
+
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        const unsigned char *sector = GetSector(chain[i]);
+        for (size_t k = 0; k < m_sectorSize; k += 4)
+            m_miniFat.push_back(GetUInt32(sector + k));
+    }
+
+    const DirectoryEntry &root = m_entries[0];
+    if (root.type != 5 || !GetChain(m_fat, root.start, m_fat.size(), chain))
+        return false;
+
+    m_miniStream.chunkSize = m_sectorSize;
+    m_miniStream.size = chain.size() * m_sectorSize;
+    for (size_t i = 0; i < chain.size(); ++i)
+        m_miniStream.chunks.push_back(GetSector(chain[i]));
+
+    return true;
+}
+
+
+bool CompoundFile::OpenStream(const char *name, CompoundStream &stream) const
+{
+    if (m_entries.empty())
+        return false;
+
+    std::string key(name);
+    for (size_t i = 0; i < key.length(); ++i)
+    {
+        if (key[i] >= 'a' && key[i] <= 'z')
+            key[i] = static_cast<char>(key[i] - 'a' + 'A');
+    }
+
+    // walk the tree of the children of the root storage
+    const DirectoryEntry *found = NULL;
+    std::vector<unsigned long> pending(1, m_entries[0].child);
+    size_t visited = 0;
+    while (!pending.empty() && found == NULL)
+    {
+        unsigned long id = pending.back();
+        pending.pop_back();
+        if (id == NoStream)
+            continue;
+        if (id >= m_entries.size() || ++visited > m_entries.size())
+            return false;   // a broken tree, or a loop
+
+        const DirectoryEntry &entry = m_entries[id];
+        if (entry.type == 2 && entry.name == key)
+            found = &entry;
+
+        pending.push_back(entry.left);
+        pending.push_back(entry.right);
+    }
+
+    if (found == NULL || found->size < 0 || static_cast<unsigned long long>(found->size) > m_package.Size())
+        return false;
+
+    stream.chunks.clear();
+    stream.size = static_cast<size_t>(found->size);
+
+    std::vector<unsigned long> chain;
+    if (found->size < static_cast<long long>(m_miniStreamCutoff))
+    {
+        // a small stream is in mini sectors
+        if (!GetChain(m_miniFat, found->start, m_miniFat.size(), chain))
+            return false;
+
+        stream.chunkSize = m_miniSectorSize;
+        for (size_t i = 0; i < chain.size(); ++i)
+        {
+            size_t offset = chain[i] * m_miniSectorSize;
+            if (offset + m_miniSectorSize > m_miniStream.size)
+                return false;
+            stream.chunks.push_back(m_miniStream.chunks[offset / m_sectorSize] + offset % m_sectorSize);
+        }
+    }
+    else
+    {
+        if (!GetChain(m_fat, found->start, m_fat.size(), chain))
+            return false;
+
+        stream.chunkSize = m_sectorSize;
+        for (size_t i = 0; i < chain.size(); ++i)
+            stream.chunks.push_back(GetSector(chain[i]));
+    }
+
+    return stream.chunks.size() * stream.chunkSize >= stream.size;
+}
+
+
+const unsigned char* CompoundFile::GetSector(unsigned long sector) const
+{
+    // the header takes the place of sector -1
+    return m_package.GetSpan((static_cast<long long>(sector) + 1) * m_sectorSize, m_sectorSize);
+}
+
+
+bool CompoundFile::GetChain(const std::vector<unsigned long> &table, unsigned long start, size_t limit,
+    std::vector<unsigned long> &chain) const
+{
+    chain.clear();
+
+    for (unsigned long sector = start; sector != EndOfChain; sector = table[sector])
+    {
+        if (sector >= table.size() || chain.size() >= limit)
+            return false;   // out of the table, or a loop
+
+        chain.push_back(sector);
+    }
+
+    // every sector of a regular chain must be in the file
+    if (&table == &m_fat)
+    {
+        for (size_t i = 0; i < chain.size(); ++i)
+        {
+            if (GetSector(chain[i]) == NULL)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool CompoundFile::ReadFat(const unsigned char *header)
+{
+    // The sectors of the FAT are listed by the DIFAT: 109 entries in the header, and a chain of sectors
+    // each of which ends with the next one
+    size_t fatCount = GetUInt32(header + 0x2C);
+    size_t sectorCount = m_package.Size() / m_sectorSize;
+    if (fatCount > sectorCount)
+        return false;
+
+    std::vector<unsigned long> fatSectors;
+    for (size_t i = 0; i < HeaderDifatCount && fatSectors.size() < fatCount; ++i)
+        fatSectors.push_back(GetUInt32(header + 0x4C + i * 4));
+
+    unsigned long difat = GetUInt32(header + 0x44);
+    size_t difatSectors = 0;
+    while (fatSectors.size() < fatCount)
+    {
+        const unsigned char *sector = (difat <= MaxRegularSector ? GetSector(difat) : NULL);
+        if (sector == NULL || ++difatSectors > sectorCount)
+            return false;
+
+        for (size_t k = 0; k + 4 < m_sectorSize && fatSectors.size() < fatCount; k += 4)
+            fatSectors.push_back(GetUInt32(sector + k));
+
+        difat = GetUInt32(sector + m_sectorSize - 4);
+    }
+
+    m_fat.reserve(fatCount * (m_sectorSize / 4));
+    for (size_t i = 0; i < fatSectors.size(); ++i)
+    {
+        const unsigned char *sector = (fatSectors[i] <= MaxRegularSector ? GetSector(fatSectors[i]) : NULL);
+        if (sector == NULL)
+            return false;
+
+        for (size_t k = 0; k < m_sectorSize; k += 4)
+            m_fat.push_back(GetUInt32(sector + k));
+    }
+
+    return true;
+}
+
+
+bool CompoundFile::ReadDirectory(unsigned long start)
+{
+    std::vector<unsigned long> chain;
+    if (!GetChain(m_fat, start, m_fat.size(), chain))
+        return false;
+
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        const unsigned char *sector = GetSector(chain[i]);
+        for (size_t offset = 0; offset < m_sectorSize; offset += DirectoryEntrySize)
+        {
+            const unsigned char *p = sector + offset;
+
+            DirectoryEntry entry;
+            size_t nameLength = GetUInt16(p + 0x40);    // in bytes, with the terminating null
+            for (size_t k = 0; k + 2 < nameLength && k < 62; k += 2)
+            {
+                unsigned long ch = GetUInt16(p + k);
+                if (ch >= 'a' && ch <= 'z')
+                    ch -= 'a' - 'A';
+                entry.name.push_back(ch < 0x80 ? static_cast<char>(ch) : '?');
+            }
+
+            entry.type = p[0x42];
+            entry.left = GetUInt32(p + 0x44);
+            entry.right = GetUInt32(p + 0x48);
+            entry.child = GetUInt32(p + 0x4C);
+            entry.start = GetUInt32(p + 0x74);
+
+            // the high part of the size is not reliable in version 3 files
+            entry.size = GetUInt32(p + 0x78);
+            if (m_sectorSize != 512)
+                entry.size += static_cast<long long>(GetUInt32(p + 0x7C)) << 32;
+
+            m_entries.push_back(entry);
+        }
+    }
+
+    return !m_entries.empty();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class CompoundStreamReader
+
+size_t CompoundStreamReader::Read(unsigned char *buffer, size_t size)
+{
+    size_t done = 0;
+    while (done < size && m_position < m_stream.size)
+    {
+        size_t offset = m_position % m_stream.chunkSize;
+        size_t n = m_stream.chunkSize - offset;
+        if (n > size - done)
+            n = size - done;
+        if (n > m_stream.size - m_position)
+            n = m_stream.size - m_position;
+
+        memcpy(buffer + done, m_stream.chunks[m_position / m_stream.chunkSize] + offset, n);
+        done += n;
+        m_position += n;
+    }
+
+    return done;
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
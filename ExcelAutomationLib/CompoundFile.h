@@ -0,0 +1,146 @@
+﻿/*!
+* @file    CompoundFile.h
+* @brief   Header file for class CompoundFile and CompoundStreamReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef COMPOUNDFILE_H_GUID_5E2B9D41_0C86_4A3F_B7E1_94D6A2C8F305
+#define COMPOUNDFILE_H_GUID_5E2B9D41_0C86_4A3F_B7E1_94D6A2C8F305
+
+
+#include <string>
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "ByteSource.h"
+#include "MappedPackage.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief A stream of a CompoundFile, as the places of its sectors in the mapped file.
+*/
+struct CompoundStream
+{
+    std::vector<const unsigned char*> chunks;   // the sectors (or mini sectors) of the stream, in order
+    size_t                            chunkSize;
+    size_t                            size;     // bytes of the stream, the last chunk may be used partly
+};
+
+
+/*!
+* @internal
+* @brief Class CompoundFile reads an OLE compound file (Compound File Binary format, [MS-CFB]), the
+*        container of an .xls workbook.
+* @details The file is mapped into memory, and a stream is read from its sectors in place. Only the
+*          streams at the root storage can be opened, which is where the Workbook stream is; the ones of
+*          the embedded objects are left out.
+*/
+class CompoundFile : public Noncopyable
+{
+public:
+    /*!
+    * @brief Whether a file starts with the signature of a compound file.
+    */
+    static bool IsCompoundFile(const unsigned char *header, size_t size);
+
+    bool Open(const ELstring &filename);
+
+    /*!
+    * @brief Find a stream in the root storage by name (case-insensitive, ASCII names only).
+    * @return false if there is no such stream or its sectors are broken.
+    */
+    bool OpenStream(const char *name, CompoundStream &stream) const;
+
+private:
+    struct DirectoryEntry
+    {
+        std::string   name;             // ASCII, upper case; other characters are '?'
+        int           type;             // 1: storage; 2: stream; 5: root storage
+        unsigned long left;             // siblings, in a red-black tree
+        unsigned long right;
+        unsigned long child;            // the root of the tree of the children of a storage
+        unsigned long start;            // first sector
+        long long     size;
+    };
+
+    const unsigned char* GetSector(unsigned long sector) const;
+
+    // Get the sectors of a chain of the FAT (or the MiniFAT), at most @e limit of them
+    bool GetChain(const std::vector<unsigned long> &table, unsigned long start, size_t limit,
+        std::vector<unsigned long> &chain) const;
+
+    bool ReadFat(const unsigned char *header);
+    bool ReadDirectory(unsigned long start);
+
+private:
+    MappedPackage               m_package;
+    size_t                      m_sectorSize;
+    size_t                      m_miniSectorSize;
+    unsigned long               m_miniStreamCutoff;
+    std::vector<unsigned long>  m_fat;
+    std::vector<unsigned long>  m_miniFat;
+    std::vector<DirectoryEntry> m_entries;
+    CompoundStream              m_miniStream;   // the stream of the root entry, which holds the mini sectors
+};
+
+
+/*!
+* @internal
+* @brief Class CompoundStreamReader reads a CompoundStream, from any position.
+*/
+class CompoundStreamReader : public ByteSource
+{
+public:
+    explicit CompoundStreamReader(const CompoundStream &stream): m_stream(stream), m_position(0) { }
+
+    size_t Size() const
+    {
+        return m_stream.size;
+    }
+
+    size_t Tell() const
+    {
+        return m_position;
+    }
+
+    /*!
+    * @return false if @e position is after the end.
+    */
+    bool Seek(size_t position)
+    {
+        if (position > m_stream.size)
+            return false;
+
+        m_position = position;
+        return true;
+    }
+
+    virtual size_t Read(unsigned char *buffer, size_t size);
+
+    virtual bool Failed() const
+    {
+        return false;
+    }
+
+private:
+    CompoundStreamReader& operator = (const CompoundStreamReader &);
+
+private:
+    const CompoundStream &m_stream;
+    size_t                m_position;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //COMPOUNDFILE_H_GUID_5E2B9D41_0C86_4A3F_B7E1_94D6A2C8F305
@@ -0,0 +1,75 @@
+﻿/*!
+* @file    Crc32.cpp
+* @brief   Implementation file for class Crc32
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include "Crc32.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief Class CrcTable holds the tables for the "slicing-by-4" algorithm, which handles 4 bytes per step.
+    * @details m_entries[0] is the checksum of every byte value; m_entries[k] is it followed by k zero bytes.
+    */
+    class CrcTable
+    {
+    public:
+        CrcTable()
+        {
+            for (unsigned long n = 0; n < 256; ++n)
+            {
+                unsigned long c = n;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? (0xEDB88320UL ^ (c >> 1)) : (c >> 1);
+                m_entries[0][n] = c;
+            }
+
+            for (unsigned long n = 0; n < 256; ++n)
+            {
+                for (int k = 1; k < 4; ++k)
+                    m_entries[k][n] = m_entries[0][m_entries[k - 1][n] & 0xFF] ^ (m_entries[k - 1][n] >> 8);
+            }
+        }
+
+        const unsigned long* operator [] (size_t slice) const
+        {
+            return m_entries[slice];
+        }
+
+    private:
+        unsigned long m_entries[4][256];
+    };
+
+    // Constructed while the module is being loaded, so it is ready before any thread uses it
+    const CrcTable s_table;
+}
+
+
+unsigned long Crc32::Update(unsigned long crc, const unsigned char *data, size_t size)
+{
+    crc = (crc ^ 0xFFFFFFFFUL) & 0xFFFFFFFFUL;
+
+    for (; size >= 4; size -= 4, data += 4)
+    {
+        crc ^= data[0] | (static_cast<unsigned long>(data[1]) << 8) | 
+            (static_cast<unsigned long>(data[2]) << 16) | (static_cast<unsigned long>(data[3]) << 24);
+        crc = s_table[3][crc & 0xFF] ^ s_table[2][(crc >> 8) & 0xFF] ^ s_table[1][(crc >> 16) & 0xFF] ^ s_table[0][crc >> 24];
+    }
+
+    for (; size > 0; --size, ++data)
+        crc = s_table[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+
+    return (crc ^ 0xFFFFFFFFUL) & 0xFFFFFFFFUL;
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
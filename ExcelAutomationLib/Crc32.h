@@ -0,0 +1,47 @@
+﻿/*!
+* @file    Crc32.h
+* @brief   Header file for class Crc32
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef CRC32_H_GUID_C29BC158_844F_4A88_BCC6_7728751123D5
+#define CRC32_H_GUID_C29BC158_844F_4A88_BCC6_7728751123D5
+
+
+#include <cstddef>
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class Crc32 computes the CRC-32 checksum used by the zip format.
+*        All the members of Crc32 are static member.
+* @note Crc32 is not intended and allowed to be instantiated.
+*/
+class Crc32
+{
+public:
+    /*!
+    * @brief Continue a checksum with more data.
+    * @param [in] crc The checksum of the data before, 0 for the first call.
+    * @return The checksum of all the data.
+    */
+    static unsigned long Update(unsigned long crc, const unsigned char *data, size_t size);
+
+private:
+    // Forbid instantiation
+    Crc32();
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //CRC32_H_GUID_C29BC158_844F_4A88_BCC6_7728751123D5
@@ -0,0 +1,64 @@
+﻿/*!
+* @file    DeflateFormat.h
+* @brief   Header file for class DeflateFormat
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef DEFLATEFORMAT_H_GUID_3F027D2C_C267_40D6_80C7_9044AA1000D8
+#define DEFLATEFORMAT_H_GUID_3F027D2C_C267_40D6_80C7_9044AA1000D8
+
+
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class DeflateFormat holds the constants of the DEFLATE format (RFC 1951), shared by Inflater and Deflater.
+*        All the members of DeflateFormat are static member.
+* @note DeflateFormat is not intended and allowed to be instantiated.
+*/
+class DeflateFormat
+{
+public:
+    enum
+    {
+        WindowSize        = 32768,
+        MaxBits           = 15,     // the longest code of the literal/length and the distance codes
+        MaxCodeLengthBits = 7,      // the longest code of the code length code
+        MinMatch          = 3,
+        MaxMatch          = 258,
+        EndOfBlock        = 256,
+        LiteralCodes      = 286,    // literal/length symbols which can be used
+        MaxLiteralCodes   = 288,    // literal/length symbols of the fixed code
+        DistanceCodes     = 30,
+        CodeLengthCodes   = 19
+    };
+
+    // Base lengths and extra bits of the length symbols 257..285
+    static const unsigned short LengthBase[29];
+    static const unsigned char  LengthExtra[29];
+
+    // Base distances and extra bits of the distance symbols 0..29
+    static const unsigned short DistanceBase[30];
+    static const unsigned char  DistanceExtra[30];
+
+    // Order of the code length code lengths in a dynamic block header
+    static const unsigned char  CodeLengthOrder[19];
+
+private:
+    // Forbid instantiation
+    DeflateFormat();
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //DEFLATEFORMAT_H_GUID_3F027D2C_C267_40D6_80C7_9044AA1000D8
@@ -0,0 +1,486 @@
+﻿/*!
+* @file    Deflater.cpp
+* @brief   Implementation file for class Deflater
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include "Deflater.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief Class SymbolTable maps the lengths and the distances of matches to their symbols.
+    */
+    class SymbolTable
+    {
+    public:
+        SymbolTable()
+        {
+            for (int code = 0; code < 29; ++code)
+            {
+                for (int length = DeflateFormat::LengthBase[code]; 
+                    length < DeflateFormat::LengthBase[code] + (1 << DeflateFormat::LengthExtra[code]) && length <= 258; ++length)
+                    m_lengthCode[length] = static_cast<unsigned char>(code);
+            }
+            m_lengthCode[258] = 28;     // 258 has its own symbol, not the last one of 227..258
+
+            for (int code = 0; code < 30; ++code)
+            {
+                int last = DeflateFormat::DistanceBase[code] + (1 << DeflateFormat::DistanceExtra[code]) - 1;
+                for (int distance = DeflateFormat::DistanceBase[code]; distance <= last; ++distance)
+                {
+                    if (distance <= 256)
+                        m_nearCode[distance - 1] = static_cast<unsigned char>(code);
+                    else
+                        m_farCode[(distance - 1) >> 7] = static_cast<unsigned char>(code);
+                }
+            }
+        }
+
+        int LengthCode(int length) const
+        {
+            return m_lengthCode[length];
+        }
+
+        int DistanceCode(int distance) const
+        {
+            return distance <= 256 ? m_nearCode[distance - 1] : m_farCode[(distance - 1) >> 7];
+        }
+
+    private:
+        unsigned char m_lengthCode[259];
+        unsigned char m_nearCode[256];      // distances 1..256
+        unsigned char m_farCode[256];       // distances 257..32768, by 128
+    };
+
+    // Constructed while the module is being loaded, so it is ready before any thread uses it
+    const SymbolTable s_symbols;
+}
+
+
+Deflater::Deflater(ByteSink &output): m_sink(output), m_buffer(BufferSize), m_pos(0), m_end(0), 
+    m_head(1 << HashBits, -1), m_prev(WindowSize, -1), m_bitBuffer(0), m_bitCount(0), m_failed(false)
+{
+    m_symbols.reserve(BlockSymbols);
+    m_output.reserve(OutputSize + 1024);
+}
+
+
+bool Deflater::Write(const unsigned char *data, size_t size)
+{
+    while (size > 0 && !m_failed)
+    {
+        if (m_end == m_buffer.size())
+        {
+            Compress(false);
+            Slide();
+            continue;
+        }
+
+        size_t n = std::min(size, m_buffer.size() - m_end);
+        memcpy(&m_buffer[m_end], data, n);
+        m_end += n;
+        data += n;
+        size -= n;
+    }
+
+    return !m_failed;
+}
+
+
+bool Deflater::Finish()
+{
+    Compress(true);
+    WriteBlock(true);
+
+    if (m_bitCount > 0)
+        PutBits(0, 8 - m_bitCount);     // to the byte boundary
+
+    return FlushOutput();
+}
+
+
+// Find the matches in the data; the last LookAhead bytes are left for the next call unless @e flush is true
+void Deflater::Compress(bool flush)
+{
+    size_t limit = flush ? m_end : (m_end > static_cast<size_t>(LookAhead) ? m_end - LookAhead : 0);
+
+    while (m_pos < limit)
+    {
+        size_t available = m_end - m_pos;
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+
+        if (available >= DeflateFormat::MinMatch)
+        {
+            size_t maxLength = std::min(available, static_cast<size_t>(DeflateFormat::MaxMatch));
+            const unsigned char *current = &m_buffer[m_pos];
+
+            const unsigned char *p = current;
+            int candidate = m_head[((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & ((1 << HashBits) - 1)];
+            for (int chain = MaxChain; candidate >= 0 && chain > 0; --chain)
+            {
+                size_t distance = m_pos - candidate;
+                if (distance > WindowSize)
+                    break;
+
+                const unsigned char *earlier = &m_buffer[candidate];
+                if (earlier[bestLength] == current[bestLength] && earlier[0] == current[0] && earlier[1] == current[1])
+                {
+                    size_t length = 2;
+                    while (length < maxLength && earlier[length] == current[length])
+                        ++length;
+
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        bestDistance = distance;
+                        if (length >= maxLength || length >= NiceMatch)
+                            break;
+                    }
+                }
+
+                int next = m_prev[candidate & (WindowSize - 1)];
+                if (next >= candidate)
+                    break;  // the slot was reused by a later position
+                candidate = next;
+            }
+
+            Insert(m_pos);
+        }
+
+        Symbol symbol;
+        if (bestLength >= DeflateFormat::MinMatch)
+        {
+            symbol.literalOrLength = static_cast<unsigned short>(bestLength);
+            symbol.distance = static_cast<unsigned short>(bestDistance);
+
+            for (size_t i = 1; i < bestLength; ++i)
+            {
+                if (m_end - (m_pos + i) >= DeflateFormat::MinMatch)
+                    Insert(m_pos + i);
+            }
+            m_pos += bestLength;
+        }
+        else
+        {
+            symbol.literalOrLength = m_buffer[m_pos];
+            symbol.distance = 0;
+            ++m_pos;
+        }
+
+        m_symbols.push_back(symbol);
+        if (m_symbols.size() == BlockSymbols)
+        {
+            WriteBlock(false);
+            if (m_output.size() >= OutputSize && !FlushOutput())
+                return;
+        }
+    }
+}
+
+
+// Drop the bytes which are too far before m_pos; the buffer is moved by whole windows to keep the slots of m_prev
+void Deflater::Slide()
+{
+    assert(m_pos >= WindowSize);
+
+    int shift = static_cast<int>((m_pos - WindowSize) & ~static_cast<size_t>(WindowSize - 1));
+    memmove(&m_buffer[0], &m_buffer[shift], m_end - shift);
+    m_pos -= shift;
+    m_end -= shift;
+
+    for (size_t i = 0; i < m_head.size(); ++i)
+        m_head[i] = (m_head[i] >= shift ? m_head[i] - shift : -1);
+    for (size_t i = 0; i < m_prev.size(); ++i)
+        m_prev[i] = (m_prev[i] >= shift ? m_prev[i] - shift : -1);
+}
+
+
+// Write the symbols of the current block as a block with dynamic Huffman codes
+void Deflater::WriteBlock(bool last)
+{
+    const int MaxCodes = DeflateFormat::LiteralCodes + DeflateFormat::DistanceCodes;
+
+    unsigned long literalFrequencies[DeflateFormat::LiteralCodes] = { 0 };
+    unsigned long distanceFrequencies[DeflateFormat::DistanceCodes] = { 0 };
+
+    for (size_t i = 0; i < m_symbols.size(); ++i)
+    {
+        const Symbol &symbol = m_symbols[i];
+        if (symbol.distance == 0)
+        {
+            ++literalFrequencies[symbol.literalOrLength];
+        }
+        else
+        {
+            ++literalFrequencies[257 + s_symbols.LengthCode(symbol.literalOrLength)];
+            ++distanceFrequencies[s_symbols.DistanceCode(symbol.distance)];
+        }
+    }
+    literalFrequencies[DeflateFormat::EndOfBlock] = 1;
+
+    unsigned char literalLengths[DeflateFormat::LiteralCodes];
+    unsigned char distanceLengths[DeflateFormat::DistanceCodes];
+    BuildLengths(literalFrequencies, DeflateFormat::LiteralCodes, DeflateFormat::MaxBits, literalLengths);
+    BuildLengths(distanceFrequencies, DeflateFormat::DistanceCodes, DeflateFormat::MaxBits, distanceLengths);
+
+    int literalCount = DeflateFormat::LiteralCodes;
+    while (literalCount > 257 && literalLengths[literalCount - 1] == 0)
+        --literalCount;
+    int distanceCount = DeflateFormat::DistanceCodes;
+    while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0)
+        --distanceCount;
+
+    // The code lengths of both codes are one sequence, compressed by run-lengths (symbols 16, 17 and 18)
+    unsigned char lengths[MaxCodes];
+    memcpy(lengths, literalLengths, literalCount);
+    memcpy(lengths + literalCount, distanceLengths, distanceCount);
+    int total = literalCount + distanceCount;
+
+    unsigned char runSymbols[MaxCodes];
+    unsigned char runExtras[MaxCodes];
+    int runCount = 0;
+    unsigned long codeLengthFrequencies[DeflateFormat::CodeLengthCodes] = { 0 };
+
+    for (int i = 0; i < total; )
+    {
+        unsigned char length = lengths[i];
+        int run = 1;
+        while (i + run < total && lengths[i + run] == length)
+            ++run;
+        i += run;
+
+        if (length == 0)
+        {
+            while (run >= 11)
+            {
+                int n = std::min(run, 138);
+                runSymbols[runCount] = 18;
+                runExtras[runCount++] = static_cast<unsigned char>(n - 11);
+                run -= n;
+            }
+            if (run >= 3)
+            {
+                runSymbols[runCount] = 17;
+                runExtras[runCount++] = static_cast<unsigned char>(run - 3);
+                run = 0;
+            }
+        }
+        else if (run >= 4)
+        {
+            runSymbols[runCount] = length;
+            runExtras[runCount++] = 0;
+            --run;
+            while (run >= 3)
+            {
+                int n = std::min(run, 6);
+                runSymbols[runCount] = 16;
+                runExtras[runCount++] = static_cast<unsigned char>(n - 3);
+                run -= n;
+            }
+        }
+
+        for (; run > 0; --run)
+        {
+            runSymbols[runCount] = length;
+            runExtras[runCount++] = 0;
+        }
+    }
+
+    for (int i = 0; i < runCount; ++i)
+        ++codeLengthFrequencies[runSymbols[i]];
+
+    unsigned char codeLengthLengths[DeflateFormat::CodeLengthCodes];
+    BuildLengths(codeLengthFrequencies, DeflateFormat::CodeLengthCodes, DeflateFormat::MaxCodeLengthBits, codeLengthLengths);
+
+    int codeLengthCount = DeflateFormat::CodeLengthCodes;
+    while (codeLengthCount > 4 && codeLengthLengths[DeflateFormat::CodeLengthOrder[codeLengthCount - 1]] == 0)
+        --codeLengthCount;
+
+    unsigned short literalCodes[DeflateFormat::LiteralCodes];
+    unsigned short distanceCodes[DeflateFormat::DistanceCodes];
+    unsigned short codeLengthCodes[DeflateFormat::CodeLengthCodes];
+    BuildCodes(literalLengths, DeflateFormat::LiteralCodes, literalCodes);
+    BuildCodes(distanceLengths, DeflateFormat::DistanceCodes, distanceCodes);
+    BuildCodes(codeLengthLengths, DeflateFormat::CodeLengthCodes, codeLengthCodes);
+
+    // Block header
+    PutBits(last ? 1 : 0, 1);
+    PutBits(2, 2);
+    PutBits(literalCount - 257, 5);
+    PutBits(distanceCount - 1, 5);
+    PutBits(codeLengthCount - 4, 4);
+
+    for (int i = 0; i < codeLengthCount; ++i)
+        PutBits(codeLengthLengths[DeflateFormat::CodeLengthOrder[i]], 3);
+
+    static const int runExtraBits[3] = { 2, 3, 7 };
+    for (int i = 0; i < runCount; ++i)
+    {
+        int symbol = runSymbols[i];
+        PutBits(codeLengthCodes[symbol], codeLengthLengths[symbol]);
+        if (symbol >= 16)
+            PutBits(runExtras[i], runExtraBits[symbol - 16]);
+    }
+
+    // Block data
+    for (size_t i = 0; i < m_symbols.size(); ++i)
+    {
+        const Symbol &symbol = m_symbols[i];
+        if (symbol.distance == 0)
+        {
+            PutBits(literalCodes[symbol.literalOrLength], literalLengths[symbol.literalOrLength]);
+            continue;
+        }
+
+        int code = s_symbols.LengthCode(symbol.literalOrLength);
+        PutBits(literalCodes[257 + code], literalLengths[257 + code]);
+        PutBits(symbol.literalOrLength - DeflateFormat::LengthBase[code], DeflateFormat::LengthExtra[code]);
+
+        code = s_symbols.DistanceCode(symbol.distance);
+        PutBits(distanceCodes[code], distanceLengths[code]);
+        PutBits(symbol.distance - DeflateFormat::DistanceBase[code], DeflateFormat::DistanceExtra[code]);
+    }
+
+    PutBits(literalCodes[DeflateFormat::EndOfBlock], literalLengths[DeflateFormat::EndOfBlock]);
+
+    m_symbols.clear();
+}
+
+
+bool Deflater::FlushOutput()
+{
+    if (!m_failed && !m_output.empty() && !m_sink.Write(&m_output[0], m_output.size()))
+        m_failed = true;
+
+    m_output.clear();
+    return !m_failed;
+}
+
+
+// Compute the lengths of a Huffman code, none longer than @e maxBits
+void Deflater::BuildLengths(const unsigned long *frequencies, int n, int maxBits, unsigned char *lengths)
+{
+    std::vector<unsigned long> weights(frequencies, frequencies + n);
+
+    // A code has two symbols at least, so that it is complete
+    int used = static_cast<int>(n - std::count(weights.begin(), weights.end(), 0UL));
+    for (int s = 0; used < 2 && s < n; ++s)
+    {
+        if (weights[s] == 0)
+        {
+            weights[s] = 1;
+            ++used;
+        }
+    }
+
+    std::vector<std::pair<unsigned long, int> > leaves;     // (weight, symbol)
+    std::vector<unsigned long> nodeWeights(2 * used);
+    std::vector<int> parents(2 * used);
+    std::vector<int> depths(2 * used);
+
+    for (;;)
+    {
+        leaves.clear();
+        for (int s = 0; s < n; ++s)
+        {
+            if (weights[s] != 0)
+                leaves.push_back(std::make_pair(weights[s], s));
+        }
+        std::sort(leaves.begin(), leaves.end());
+
+        // Two queues: the sorted leaves, and the internal nodes which are made in order of weight
+        int m = static_cast<int>(leaves.size());
+        for (int i = 0; i < m; ++i)
+            nodeWeights[i] = leaves[i].first;
+
+        int nextLeaf = 0;
+        int nextInternal = m;
+        for (int node = m; node < 2 * m - 1; ++node)
+        {
+            int children[2];
+            for (int k = 0; k < 2; ++k)
+            {
+                if (nextLeaf < m && (nextInternal >= node || nodeWeights[nextLeaf] <= nodeWeights[nextInternal]))
+                    children[k] = nextLeaf++;
+                else
+                    children[k] = nextInternal++;
+            }
+
+            nodeWeights[node] = nodeWeights[children[0]] + nodeWeights[children[1]];
+            parents[children[0]] = parents[children[1]] = node;
+        }
+
+        // A parent is made after its children, so the depths are computed from the root down
+        int maxDepth = 0;
+        depths[2 * m - 2] = 0;
+        for (int node = 2 * m - 3; node >= 0; --node)
+        {
+            depths[node] = depths[parents[node]] + 1;
+            if (node < m)
+                maxDepth = std::max(maxDepth, depths[node]);
+        }
+
+        if (maxDepth <= maxBits)
+        {
+            memset(lengths, 0, n);
+            for (int i = 0; i < m; ++i)
+                lengths[leaves[i].second] = static_cast<unsigned char>(depths[i]);
+            return;
+        }
+
+        // Too long: flatten the weights and try again
+        for (int s = 0; s < n; ++s)
+        {
+            if (weights[s] != 0)
+                weights[s] = (weights[s] + 1) / 2;
+        }
+    }
+}
+
+
+// Compute the canonical codes from the lengths, with the bits reversed as they are output
+void Deflater::BuildCodes(const unsigned char *lengths, int n, unsigned short *codes)
+{
+    int count[DeflateFormat::MaxBits + 1] = { 0 };
+    for (int s = 0; s < n; ++s)
+        ++count[lengths[s]];
+    count[0] = 0;
+
+    int nextCode[DeflateFormat::MaxBits + 1];
+    int code = 0;
+    for (int len = 1; len <= DeflateFormat::MaxBits; ++len)
+    {
+        code = (code + count[len - 1]) << 1;
+        nextCode[len] = code;
+    }
+
+    for (int s = 0; s < n; ++s)
+    {
+        int len = lengths[s];
+        codes[s] = 0;
+        if (len == 0)
+            continue;
+
+        int value = nextCode[len]++;
+        int reversed = 0;
+        for (int k = 0; k < len; ++k)
+            reversed |= ((value >> k) & 1) << (len - 1 - k);
+        codes[s] = static_cast<unsigned short>(reversed);
+    }
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,128 @@
+﻿/*!
+* @file    Deflater.h
+* @brief   Header file for class Deflater
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef DEFLATER_H_GUID_CB0E319E_9F48_448E_A9EC_7211D1300342
+#define DEFLATER_H_GUID_CB0E319E_9F48_448E_A9EC_7211D1300342
+
+
+#include <vector>
+#include "LibDef.h"
+#include "ByteSink.h"
+#include "DeflateFormat.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class Deflater compresses data into a raw DEFLATE stream (RFC 1951), as the parts of an .xlsx
+*        package are compressed.
+* @details Matches are found by hash chains over a 256KB buffer, and every 16K symbols are written as a
+*          block with its own Huffman codes. The chains are short, which trades a few percent of the
+*          size for speed: the XML of a worksheet is compressed faster than a disk writes it. @n
+*          The memory used is fixed, whatever the size of the data.
+*/
+class Deflater : public Noncopyable
+{
+public:
+    /*!
+    * @param [in] output Which receives the compressed data. Must outlive the Deflater.
+    */
+    explicit Deflater(ByteSink &output);
+
+    /*!
+    * @brief Compress more data.
+    * @return false if the output failed.
+    */
+    bool Write(const unsigned char *data, size_t size);
+
+    /*!
+    * @brief Compress the rest of the data and end the stream.
+    * @return false if the output failed.
+    */
+    bool Finish();
+
+private:
+    enum
+    {
+        WindowSize   = DeflateFormat::WindowSize,
+        BufferSize   = 8 * WindowSize,  // the buffer slides once per BufferSize - WindowSize bytes
+        HashBits     = 15,
+        MaxChain     = 16,          // candidates tried for a match
+        NiceMatch    = 128,         // a match at least this long is taken at once
+        LookAhead    = DeflateFormat::MaxMatch + DeflateFormat::MinMatch + 1,
+        BlockSymbols = 16384,
+        OutputSize   = 65536
+    };
+
+    /*!
+    * @brief A literal (distance is 0) or a match
+    */
+    struct Symbol
+    {
+        unsigned short literalOrLength;
+        unsigned short distance;
+    };
+
+private:
+    void Compress(bool flush);
+    void Slide();
+
+    void Insert(size_t pos)
+    {
+        const unsigned char *p = &m_buffer[pos];
+        size_t hash = ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & ((1 << HashBits) - 1);
+        m_prev[pos & (WindowSize - 1)] = m_head[hash];
+        m_head[hash] = static_cast<int>(pos);
+    }
+
+    void WriteBlock(bool last);
+
+    void PutBits(unsigned long value, int n)
+    {
+        m_bitBuffer |= value << m_bitCount;
+        m_bitCount += n;
+        while (m_bitCount >= 8)
+        {
+            m_output.push_back(static_cast<unsigned char>(m_bitBuffer & 0xFF));
+            m_bitBuffer >>= 8;
+            m_bitCount -= 8;
+        }
+    }
+
+    bool FlushOutput();
+
+    static void BuildLengths(const unsigned long *frequencies, int n, int maxBits, unsigned char *lengths);
+    static void BuildCodes(const unsigned char *lengths, int n, unsigned short *codes);
+
+private:
+    ByteSink                  &m_sink;
+
+    std::vector<unsigned char> m_buffer;        // the last WindowSize bytes compressed and the data not compressed yet
+    size_t                     m_pos;           // next byte to compress
+    size_t                     m_end;           // end of the data in m_buffer
+    std::vector<int>           m_head;          // hash => the last position with the hash, -1 if none
+    std::vector<int>           m_prev;          // position => the previous position with the same hash
+
+    std::vector<Symbol>        m_symbols;       // of the current block
+
+    std::vector<unsigned char> m_output;
+    unsigned long              m_bitBuffer;     // bits not output yet, the next bit is the lowest one
+    int                        m_bitCount;
+    bool                       m_failed;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //DEFLATER_H_GUID_CB0E319E_9F48_448E_A9EC_7211D1300342
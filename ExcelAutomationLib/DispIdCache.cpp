@@ -0,0 +1,172 @@
+﻿/*!
+* @file    DispIdCache.cpp
+* @brief   Implementation file for class DispIdCache
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <map>
+#include "DispIdCache.h"
+#include "AtomicsUtil.h"
+#include "MemberKey.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief Class DispIdTable holds the cached entries and the lock which guards them.
+    */
+    class DispIdTable : public Noncopyable
+    {
+    public:
+        DispIdTable(): m_hits(0), m_misses(0)
+        {
+            ::InitializeCriticalSection(&m_lock);
+        }
+
+        ~DispIdTable()
+        {
+            ::DeleteCriticalSection(&m_lock);
+        }
+
+        void Lock()
+        {
+            ::EnterCriticalSection(&m_lock);
+        }
+
+        void Unlock()
+        {
+            ::LeaveCriticalSection(&m_lock);
+        }
+
+        // Called with the lock held
+        void Insert(const MemberKey &key, DISPID dispId)
+        {
+            std::map<MemberKey, DISPID>::iterator it = m_entries.find(key);
+            if (it != m_entries.end())
+                it->second = dispId;
+            else
+                m_entries.insert(std::make_pair(m_keys.Store(key), dispId));
+        }
+
+        // Called with the lock held
+        void Clear()
+        {
+            m_entries.clear();
+            m_keys.Clear();
+        }
+
+    public:
+        std::map<MemberKey, DISPID> m_entries;
+        AtomicsUtil::Integer        m_hits;
+        AtomicsUtil::Integer        m_misses;
+
+    private:
+        MemberKeyStore              m_keys;
+        CRITICAL_SECTION            m_lock;
+    };
+
+    // Constructed while the module is being loaded, before any call of DispIdCache
+    DispIdTable s_table;
+
+
+    /*!
+    * @brief Class TableLock locks s_table during its lifetime.
+    */
+    class TableLock : public Noncopyable
+    {
+    public:
+        TableLock()
+        {
+            s_table.Lock();
+        }
+
+        ~TableLock()
+        {
+            s_table.Unlock();
+        }
+    };
+}
+
+
+HRESULT DispIdCache::GetDispId(IDispatch *pDisp, LPCOLESTR typeName, LPOLESTR name, DISPID &dispId)
+{
+    assert(pDisp);
+    assert(name);
+
+    if (!typeName)
+        return pDisp->GetIDsOfNames(IID_NULL, &name, 1, LOCALE_SYSTEM_DEFAULT, &dispId);
+
+    // the key points to the names of the caller, so a hit does not allocate
+    MemberKey key(typeName, name);
+
+    {
+        TableLock lock;
+        std::map<MemberKey, DISPID>::const_iterator it = s_table.m_entries.find(key);
+        if (it != s_table.m_entries.end())
+        {
+            dispId = it->second;
+            AtomicsUtil::Increment(&s_table.m_hits);
+            return S_OK;
+        }
+    }
+
+    // Not holding the lock across the call: it may be a cross-process round trip
+    AtomicsUtil::Increment(&s_table.m_misses);
+    HRESULT hr = pDisp->GetIDsOfNames(IID_NULL, &name, 1, LOCALE_SYSTEM_DEFAULT, &dispId);
+
+    if (SUCCEEDED(hr))
+    {
+        TableLock lock;
+        s_table.Insert(key, dispId);
+    }
+
+    return hr;
+}
+
+
+void DispIdCache::Invalidate(LPCOLESTR typeName, LPCOLESTR name)
+{
+    if (!typeName)
+        return;
+
+    TableLock lock;
+    s_table.m_entries.erase(MemberKey(typeName, name));
+}
+
+
+void DispIdCache::Clear()
+{
+    TableLock lock;
+    s_table.Clear();
+}
+
+
+long DispIdCache::CountHits()
+{
+    return s_table.m_hits;
+}
+
+
+long DispIdCache::CountMisses()
+{
+    return s_table.m_misses;
+}
+
+
+void DispIdCache::ResetCounters()
+{
+    ::InterlockedExchange(&s_table.m_hits, 0);
+    ::InterlockedExchange(&s_table.m_misses, 0);
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,77 @@
+﻿/*!
+* @file    DispIdCache.h
+* @brief   Header file for class DispIdCache
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef DISPIDCACHE_H_GUID_877C2FE3_47EA_4633_82B5_6B1F2D9A87E2
+#define DISPIDCACHE_H_GUID_877C2FE3_47EA_4633_82B5_6B1F2D9A87E2
+
+
+#include <windows.h>
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Class DispIdCache remembers the DISPIDs returned by IDispatch::GetIDsOfNames().
+*        All the members of DispIdCache are static member.
+* @details A DISPID is a property of the type, not of the object, so every Range shares the DISPID of
+*          "Value". Entries are keyed by the name of the Excel type (such as "Range" or "Font") and the
+*          name of the member, and are filled on first use. All members are thread-safe.
+* @note DispIdCache is not intended and allowed to be instantiated.
+*/
+class DispIdCache
+{
+public:
+    /*!
+    * @brief Get the DISPID of a member, calling IDispatch::GetIDsOfNames() only on a cache miss.
+    * @param [in] pDisp Pointer to IDispatch. Must not be NULL.
+    * @param [in] typeName Name of the type which @e pDisp belongs to. If it is NULL, the cache is bypassed.
+    * @param [in] name Name of the method or property involved.
+    * @param [out] dispId Which returns the DISPID.
+    * @return Any value which can be returned by IDispatch::GetIDsOfNames().
+    */
+    static HRESULT GetDispId(IDispatch *pDisp, LPCOLESTR typeName, LPOLESTR name, DISPID &dispId);
+
+    /*!
+    * @brief Remove the entry of a member, so the next lookup asks IDispatch::GetIDsOfNames() again.
+    */
+    static void Invalidate(LPCOLESTR typeName, LPCOLESTR name);
+
+    /*!
+    * @brief Remove all entries.
+    */
+    static void Clear();
+
+    /*!
+    * @brief Number of lookups answered from the cache.
+    */
+    static long CountHits();
+
+    /*!
+    * @brief Number of lookups which called IDispatch::GetIDsOfNames().
+    */
+    static long CountMisses();
+
+    /*!
+    * @brief Reset the hit and miss counters to 0.
+    */
+    static void ResetCounters();
+
+private:
+    // Forbid instantiation
+    DispIdCache();
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //DISPIDCACHE_H_GUID_877C2FE3_47EA_4633_82B5_6B1F2D9A87E2
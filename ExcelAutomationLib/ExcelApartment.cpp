@@ -0,0 +1,266 @@
+﻿/*!
+* @file    ExcelApartment.cpp
+* @brief   Implementation file for class ExcelApartment and class ExcelApartmentTask
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <windows.h>
+#include <cassert>
+
+#include "ExcelApartment.h"
+#include "Noncopyable.h"
+#include "TaskExecutor.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ApartmentHost
+
+/*!
+* @brief Class ApartmentHost makes the thread of an ExcelApartment a single-threaded apartment running Excel.
+*/
+class ApartmentHost : public TaskExecutor::Host, public Noncopyable
+{
+public:
+    ApartmentHost(): m_pApp(0), m_started(true), m_running(false) { }
+
+    /*!
+    * @brief Wait until the thread has tried to start Excel.
+    * @return true if Excel is running
+    */
+    bool WaitStarted()
+    {
+        m_started.Wait();
+        return m_running;
+    }
+
+    ExcelApplication& GetApplication()
+    {
+        assert(m_pApp);
+        return *m_pApp;
+    }
+
+private:
+    virtual void EnterThread()
+    {
+        // The application initializes COM on this thread, as an STA
+        m_pApp = new ExcelApplication;
+        m_running = m_pApp->Startup();
+
+        m_started.Set();
+    }
+
+    virtual void LeaveThread()
+    {
+        if (m_pApp->IsRunning())
+            m_pApp->Shutdown();
+
+        // It uninitializes COM, so it is destroyed on this thread too
+        delete m_pApp;
+        m_pApp = 0;
+    }
+
+    virtual void Wait(Event &wake)
+    {
+        // The calls from Excel and the window messages of COM are served while there is no task
+        HANDLE handle = wake.GetHandle();
+        DWORD result = ::MsgWaitForMultipleObjects(1, &handle, FALSE, INFINITE, QS_ALLINPUT);
+
+        if (result == WAIT_OBJECT_0 + 1)
+        {
+            MSG msg;
+            while (::PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+            {
+                ::TranslateMessage(&msg);
+                ::DispatchMessage(&msg);
+            }
+        }
+    }
+
+private:
+    ExcelApplication *m_pApp;
+    Event             m_started;        // set when Excel is started, or failed to
+    bool              m_running;        // written before m_started is set
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ExcelApartmentImpl
+
+/*!
+* @brief Class ExcelApartmentImpl inplements ExcelApartment's interfaces.
+*/
+class ExcelApartmentImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class ExcelApartment can access members of ExcelApartmentImpl.
+    friend class ExcelApartment;
+
+private:
+    ExcelApartmentImpl(): m_executor(m_host) { }
+
+    virtual ~ExcelApartmentImpl()
+    {
+        m_executor.Stop();
+    }
+
+    bool Start();
+
+    void Post(const ExcelFuture<ExcelApartmentTask> &task);
+
+    void Stop()
+    {
+        m_executor.Stop();
+    }
+
+    bool IsApartmentThread() const
+    {
+        return m_executor.IsExecutorThread();
+    }
+
+    // Run a task, or cancel it if app is NULL
+    static void Complete(const ExcelFuture<ExcelApartmentTask> &task, ExcelApplication *app)
+    {
+        task.Body().Complete(app);
+    }
+
+private:
+    /*!
+    * @brief A task of the executor, which keeps the posted task alive until it is done
+    */
+    class Call : public TaskExecutor::Task
+    {
+    public:
+        Call(ApartmentHost &host, const ExcelFuture<ExcelApartmentTask> &task): m_host(host), m_task(task) { }
+
+    private:
+        virtual void Run()
+        {
+            ExcelApartmentImpl::Complete(m_task, &m_host.GetApplication());
+        }
+
+        virtual void Cancel()
+        {
+            ExcelApartmentImpl::Complete(m_task, 0);
+        }
+
+    private:
+        ApartmentHost                     &m_host;
+        ExcelFuture<ExcelApartmentTask>    m_task;
+    };
+
+private:
+    ApartmentHost m_host;               // must be constructed before m_executor, and destroyed after it
+    TaskExecutor  m_executor;
+};
+
+
+bool ExcelApartmentImpl::Start()
+{
+    if (!m_executor.Start())
+        return false;
+
+    if (!m_host.WaitStarted())
+    {
+        m_executor.Stop();
+        return false;
+    }
+
+    return true;
+}
+
+
+void ExcelApartmentImpl::Post(const ExcelFuture<ExcelApartmentTask> &task)
+{
+    // It is cancelled by the executor if the apartment is stopped
+    m_executor.Post(new Call(m_host, task));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelApartmentTask
+
+ExcelApartmentTask::ExcelApartmentTask(): m_done(::CreateEvent(NULL, TRUE, FALSE, NULL)), m_succeeded(false)
+{
+    assert(m_done != NULL);
+}
+
+
+ExcelApartmentTask::~ExcelApartmentTask()
+{
+    ::CloseHandle(m_done);
+}
+
+
+bool ExcelApartmentTask::Wait(unsigned long timeout /* = INFINITE */) const
+{
+    return ::WaitForSingleObject(m_done, timeout) == WAIT_OBJECT_0;
+}
+
+
+void ExcelApartmentTask::Complete(ExcelApplication *app)
+{
+    if (app)
+        m_succeeded = Run(*app);
+
+    // The results are written before the event is set, and read after it is
+    ::SetEvent(m_done);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelApartment
+
+ExcelApartment ExcelApartment::Start()
+{
+    ExcelApartment apartment(new ExcelApartmentImpl);
+
+    if (!apartment.Body().Start())
+        return ExcelApartment();
+
+    return apartment;
+}
+
+
+void ExcelApartment::Stop()
+{
+    Body().Stop();
+}
+
+
+bool ExcelApartment::IsApartmentThread() const
+{
+    return !IsNull() && Body().IsApartmentThread();
+}
+
+
+void ExcelApartment::PostTask(const ExcelFuture<ExcelApartmentTask> &task)
+{
+    if (IsNull())
+        ExcelApartmentImpl::Complete(task, 0);
+    else
+        Body().Post(task);
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelApartment::ExcelApartment(ExcelApartmentImpl *impl): HandleBase(impl)
+{
+}
+
+
+ExcelApartmentImpl& ExcelApartment::Body() const
+{
+    return dynamic_cast<ExcelApartmentImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -1,235 +1,436 @@
-﻿/*!
-* @file    ExcelApplication.cpp
-* @brief   Implementation file for class ExcelApplication
-* @date    2009-12-09
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include <tchar.h>
-#include <cassert>
-
-#include "ExcelApplication.h"
-#include "ExcelWorkbookSet.h"
-#include "ExcelWorkbook.h"
-#include "ComUtil.h"
-#include "Noncopyable.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Definition and implementation of class ExcelWorkbookSetImpl
-
-/*!
-* @brief Class ExcelWorkbookSetImpl inplements ExcelWorkbookSet's interfaces.
-*/
-class ExcelApplicationImpl : public BodyBase, public Noncopyable
-{
-    // All members are private. Only the friend class ExcelApplication can access members of ExcelApplicationImpl.
-    friend class ExcelApplication;
-
-private:
-    ExcelApplicationImpl(): m_pApp(0)
-    {
-        ::CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
-    }
-
-    virtual ~ExcelApplicationImpl()
-    {
-        // Release the body part before call CoUninitialize()
-        m_workbookSet.ReleaseRef();
-
-        if (IsRunning())
-            Shutdown();
-
-        CoUninitialize();
-    }
-
-    bool IsRunning() const
-    {
-        return m_pApp != 0;
-    }
-    
-    bool Startup();
-
-    bool SetVisible(bool visible = true);
-
-    bool Shutdown();
-
-    ExcelWorkbookSet GetWorkbookSet();
-
-    ExcelWorkbook OpenWorkbook(const ELchar *filename);
-
-    ExcelWorkbook CreateWorkbook(const ELchar *filename);
-
-private:
-    IDispatch *m_pApp;
-    ExcelWorkbookSet m_workbookSet;
-};
-
-
-bool ExcelApplicationImpl::Startup()
-{
-    assert(!IsRunning());
-
-    CLSID clsid;
-	HRESULT hr = ::CLSIDFromProgID(OLESTR("Excel.Application"), &clsid);
-
-	if (FAILED(hr))
-		return false;
-
-    IDispatch *pApp = 0;
-    hr = ::CoCreateInstance(clsid, NULL, CLSCTX_LOCAL_SERVER, IID_IDispatch, (LPVOID*)&pApp);
-
-    if (FAILED(hr))
-        return false;
-
-    m_pApp = pApp;
-
-    return true;
-}
-
-
-bool ExcelApplicationImpl::SetVisible(bool visible /* = true */)
-{
-    assert(IsRunning());
-
-    VARIANT param;
-    param.vt = VT_BOOL;  // 0 == FALSE, -1 == TRUE
-    param.boolVal = (visible ? -1 : 0);
-
-    HRESULT hr = ComUtil::Invoke(m_pApp, DISPATCH_PROPERTYPUT, OLESTR("Visible"), NULL, 1, param);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelApplicationImpl::Shutdown()
-{
-    assert(IsRunning());
-
-    HRESULT hr = ComUtil::Invoke(m_pApp, DISPATCH_METHOD, OLESTR("Quit"), NULL, 0);
-    m_pApp->Release();
-    m_pApp = 0;
-    return SUCCEEDED(hr);
-}
-
-
-ExcelWorkbookSet ExcelApplicationImpl::GetWorkbookSet()
-{
-    assert(IsRunning());
-
-    if (!m_workbookSet.IsNull())
-        return m_workbookSet;
-
-    VARIANT result;
-    VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pApp, DISPATCH_PROPERTYGET, OLESTR("Workbooks"), &result, 0);
-
-    if (SUCCEEDED(hr))
-        m_workbookSet = ExcelWorkbookSet(result.pdispVal);
-
-    return m_workbookSet;
-}
-
-
-ExcelWorkbook ExcelApplicationImpl::OpenWorkbook(const ELchar *filename)
-{
-    assert(IsRunning());
-
-    if (m_workbookSet.IsNull())
-        GetWorkbookSet();
-
-    return m_workbookSet.OpenWorkbook(filename);
-}
-
-
-ExcelWorkbook ExcelApplicationImpl::CreateWorkbook(const ELchar *filename)
-{
-    assert(IsRunning());
-
-    if (m_workbookSet.IsNull())
-        GetWorkbookSet();
-
-    return m_workbookSet.CreateWorkbook(filename);
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Implementation of class ExcelWorkbookSet
-
-ExcelApplication::ExcelApplication(): HandleBase(new ExcelApplicationImpl())
-{
-}
-
-
-bool ExcelApplication::IsRunning() const
-{
-    return Body().IsRunning();
-}
-
-
-bool ExcelApplication::Startup()
-{
-    return Body().Startup();
-}
-
-
-bool ExcelApplication::SetVisible(bool visible /* = true */)
-{
-    return Body().SetVisible(visible);
-}
-
-
-bool ExcelApplication::Shutdown()
-{
-    return Body().Shutdown();
-}
-
-
-ExcelWorkbook ExcelApplication::OpenWorkbook(const ELchar *filename)
-{
-    return Body().OpenWorkbook(filename);
-}
-
-
-ExcelWorkbook ExcelApplication::OpenWorkbook(const ELstring &filename)
-{
-    return OpenWorkbook(filename.c_str());
-}
-
-
-ExcelWorkbook ExcelApplication::CreateWorkbook(const ELchar *filename)
-{
-    return Body().CreateWorkbook(filename);
-}
-
-
-ExcelWorkbook ExcelApplication::CreateWorkbook(const ELstring &filename)
-{
-    return CreateWorkbook(filename.c_str());
-}
-
-
-// <begin> Handle/Body pattern implementation
-
-ExcelApplication::ExcelApplication(ExcelApplicationImpl *impl): HandleBase(impl)
-{ 
-}
-
-
-ExcelApplicationImpl& ExcelApplication::Body() const
-{
-    return dynamic_cast<ExcelApplicationImpl&>(HandleBase::Body());
-}
-
-// <end> Handle/Body pattern implementation
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
+﻿/*!
+* @file    ExcelApplication.cpp
+* @brief   Implementation file for class ExcelApplication
+* @date    2009-12-09
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include <tchar.h>
+#include <cassert>
+
+#include "ExcelApplication.h"
+#include "ExcelWorkbookSet.h"
+#include "ExcelWorkbook.h"
+#include "ComUtil.h"
+#include "Noncopyable.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ExcelWorkbookSetImpl
+
+/*!
+* @brief Class ExcelWorkbookSetImpl inplements ExcelWorkbookSet's interfaces.
+*/
+class ExcelApplicationImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class ExcelApplication can access members of ExcelApplicationImpl.
+    friend class ExcelApplication;
+
+private:
+    ExcelApplicationImpl(): m_pApp(0), m_openedWorkbooks(0), m_performanceDepth(0), m_recalculatePending(false),
+        m_savedScreenUpdating(false), m_savedEnableEvents(false),
+        m_hasScreenUpdating(false), m_hasEnableEvents(false), m_hasCalculation(false), m_savedCalculation(0)
+    {
+        ::CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+    }
+
+    virtual ~ExcelApplicationImpl()
+    {
+        // Release the body part before call CoUninitialize()
+        m_workbookSet.ReleaseRef();
+
+        if (IsRunning())
+            Shutdown();
+
+        CoUninitialize();
+    }
+
+    bool IsRunning() const
+    {
+        return m_pApp != 0;
+    }
+    
+    bool Startup();
+
+    bool SetVisible(bool visible = true);
+
+    bool Shutdown();
+
+    ExcelWorkbookSet GetWorkbookSet();
+
+    ExcelWorkbook OpenWorkbook(const ELchar *filename);
+
+    ExcelWorkbook CreateWorkbook(const ELchar *filename);
+
+    bool EnterPerformanceMode();
+
+    bool LeavePerformanceMode(bool recalculate);
+
+    bool GetBoolProperty(LPOLESTR name, bool &value);
+
+    void Attach(IDispatch *pApp)
+    {
+        assert(!IsRunning());
+        assert(pApp);
+
+        m_pApp = pApp;
+        m_openedWorkbooks = 0;
+    }
+
+    IDispatch* Detach();
+
+    unsigned long CountOpenedWorkbooks() const
+    {
+        return m_openedWorkbooks;
+    }
+
+private:
+    IDispatch *m_pApp;
+    ExcelWorkbookSet m_workbookSet;
+    unsigned long m_openedWorkbooks;
+
+    // State of the performance mode, see ExcelPerformanceScope
+    int  m_performanceDepth;        // number of nested scopes
+    bool m_recalculatePending;      // some scope asked for a recalculation on exit
+    bool m_savedScreenUpdating;
+    bool m_savedEnableEvents;
+    bool m_hasScreenUpdating;       // whether m_savedScreenUpdating is valid and has to be restored
+    bool m_hasEnableEvents;
+    bool m_hasCalculation;
+    long m_savedCalculation;
+};
+
+
+bool ExcelApplicationImpl::Startup()
+{
+    assert(!IsRunning());
+
+    CLSID clsid;
+	HRESULT hr = ::CLSIDFromProgID(OLESTR("Excel.Application"), &clsid);
+
+	if (FAILED(hr))
+		return false;
+
+    IDispatch *pApp = 0;
+    hr = ::CoCreateInstance(clsid, NULL, CLSCTX_LOCAL_SERVER, IID_IDispatch, (LPVOID*)&pApp);
+
+    if (FAILED(hr))
+        return false;
+
+    m_pApp = pApp;
+    m_openedWorkbooks = 0;
+
+    return true;
+}
+
+
+bool ExcelApplicationImpl::SetVisible(bool visible /* = true */)
+{
+    assert(IsRunning());
+
+    HRESULT hr = ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT, OLESTR("Visible"), NULL, visible);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ExcelApplicationImpl::Shutdown()
+{
+    assert(IsRunning());
+
+    HRESULT hr = ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_METHOD, OLESTR("Quit"), NULL);
+    m_pApp->Release();
+    m_pApp = 0;
+    m_performanceDepth = 0;
+    return SUCCEEDED(hr);
+}
+
+
+IDispatch* ExcelApplicationImpl::Detach()
+{
+    // The workbook set refers to this instance
+    m_workbookSet.ReleaseRef();
+
+    IDispatch *pApp = m_pApp;
+    m_pApp = 0;
+    m_performanceDepth = 0;
+
+    return pApp;
+}
+
+
+ExcelWorkbookSet ExcelApplicationImpl::GetWorkbookSet()
+{
+    assert(IsRunning());
+
+    if (!m_workbookSet.IsNull())
+        return m_workbookSet;
+
+    VARIANT result;
+    VariantInit(&result);
+
+    HRESULT hr = ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYGET, OLESTR("Workbooks"), &result);
+
+    if (SUCCEEDED(hr))
+        m_workbookSet = ExcelWorkbookSet(result.pdispVal);
+
+    return m_workbookSet;
+}
+
+
+ExcelWorkbook ExcelApplicationImpl::OpenWorkbook(const ELchar *filename)
+{
+    assert(IsRunning());
+
+    if (m_workbookSet.IsNull())
+        GetWorkbookSet();
+
+    ExcelWorkbook workbook = m_workbookSet.OpenWorkbook(filename);
+    if (!workbook.IsNull())
+        ++m_openedWorkbooks;
+
+    return workbook;
+}
+
+
+ExcelWorkbook ExcelApplicationImpl::CreateWorkbook(const ELchar *filename)
+{
+    assert(IsRunning());
+
+    if (m_workbookSet.IsNull())
+        GetWorkbookSet();
+
+    ExcelWorkbook workbook = m_workbookSet.CreateWorkbook(filename);
+    if (!workbook.IsNull())
+        ++m_openedWorkbooks;
+
+    return workbook;
+}
+
+
+bool ExcelApplicationImpl::GetBoolProperty(LPOLESTR name, bool &value)
+{
+    VARIANT result;
+    VariantInit(&result);
+
+    HRESULT hr = ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYGET, name, &result);
+
+    if (FAILED(hr) || result.vt != VT_BOOL)
+    {
+        VariantClear(&result);
+        return false;
+    }
+
+    value = (result.boolVal != VARIANT_FALSE);
+    return true;
+}
+
+
+bool ExcelApplicationImpl::EnterPerformanceMode()
+{
+    assert(IsRunning());
+
+    const long xlCalculationManual = -4135;
+
+    // Only the outermost scope saves and changes the settings
+    if (++m_performanceDepth > 1)
+        return true;
+
+    m_recalculatePending = false;
+
+    bool succeeded = true;
+
+    m_hasScreenUpdating = GetBoolProperty(OLESTR("ScreenUpdating"), m_savedScreenUpdating);
+    if (!m_hasScreenUpdating || FAILED(ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT,
+        OLESTR("ScreenUpdating"), NULL, false)))
+    {
+        succeeded = false;
+    }
+
+    m_hasEnableEvents = GetBoolProperty(OLESTR("EnableEvents"), m_savedEnableEvents);
+    if (!m_hasEnableEvents || FAILED(ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT,
+        OLESTR("EnableEvents"), NULL, false)))
+    {
+        succeeded = false;
+    }
+
+    // Calculation is not available before a workbook is opened
+    VARIANT result;
+    VariantInit(&result);
+    HRESULT hr = ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYGET, OLESTR("Calculation"), &result);
+    if (SUCCEEDED(hr))
+        hr = VariantChangeType(&result, &result, 0, VT_I4);
+
+    m_hasCalculation = SUCCEEDED(hr);
+    if (m_hasCalculation)
+        m_savedCalculation = result.lVal;
+
+    VariantClear(&result);
+
+    if (!m_hasCalculation || FAILED(ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT,
+        OLESTR("Calculation"), NULL, xlCalculationManual)))
+    {
+        succeeded = false;
+    }
+
+    return succeeded;
+}
+
+
+bool ExcelApplicationImpl::LeavePerformanceMode(bool recalculate)
+{
+    assert(IsRunning());
+
+    // The application has been restarted in the scope, the settings of the old instance are gone
+    if (m_performanceDepth == 0)
+        return false;
+
+    if (recalculate)
+        m_recalculatePending = true;
+
+    if (--m_performanceDepth > 0)
+        return true;
+
+    // Restore in the reversed order of EnterPerformanceMode()
+    bool succeeded = true;
+
+    if (m_hasCalculation && FAILED(ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT,
+        OLESTR("Calculation"), NULL, m_savedCalculation)))
+    {
+        succeeded = false;
+    }
+
+    if (m_hasEnableEvents && FAILED(ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT,
+        OLESTR("EnableEvents"), NULL, m_savedEnableEvents)))
+    {
+        succeeded = false;
+    }
+
+    if (m_hasScreenUpdating && FAILED(ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT,
+        OLESTR("ScreenUpdating"), NULL, m_savedScreenUpdating)))
+    {
+        succeeded = false;
+    }
+
+    m_hasCalculation = m_hasEnableEvents = m_hasScreenUpdating = false;
+
+    if (m_recalculatePending)
+    {
+        m_recalculatePending = false;
+        if (FAILED(ComUtil::Invoke(m_pApp, OLESTR("Application"), DISPATCH_METHOD, OLESTR("Calculate"), NULL)))
+            succeeded = false;
+    }
+
+    return succeeded;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelWorkbookSet
+
+ExcelApplication::ExcelApplication(): HandleBase(new ExcelApplicationImpl())
+{
+}
+
+
+bool ExcelApplication::IsRunning() const
+{
+    return Body().IsRunning();
+}
+
+
+bool ExcelApplication::Startup()
+{
+    return Body().Startup();
+}
+
+
+bool ExcelApplication::SetVisible(bool visible /* = true */)
+{
+    return Body().SetVisible(visible);
+}
+
+
+bool ExcelApplication::Shutdown()
+{
+    return Body().Shutdown();
+}
+
+
+ExcelWorkbook ExcelApplication::OpenWorkbook(const ELchar *filename)
+{
+    return Body().OpenWorkbook(filename);
+}
+
+
+ExcelWorkbook ExcelApplication::OpenWorkbook(const ELstring &filename)
+{
+    return OpenWorkbook(filename.c_str());
+}
+
+
+ExcelWorkbook ExcelApplication::CreateWorkbook(const ELchar *filename)
+{
+    return Body().CreateWorkbook(filename);
+}
+
+
+ExcelWorkbook ExcelApplication::CreateWorkbook(const ELstring &filename)
+{
+    return CreateWorkbook(filename.c_str());
+}
+
+
+bool ExcelApplication::EnterPerformanceMode()
+{
+    return Body().EnterPerformanceMode();
+}
+
+
+bool ExcelApplication::LeavePerformanceMode(bool recalculate)
+{
+    return Body().LeavePerformanceMode(recalculate);
+}
+
+
+void ExcelApplication::Attach(IDispatch *pApp)
+{
+    Body().Attach(pApp);
+}
+
+
+IDispatch* ExcelApplication::Detach()
+{
+    return Body().Detach();
+}
+
+
+unsigned long ExcelApplication::CountOpenedWorkbooks() const
+{
+    return Body().CountOpenedWorkbooks();
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelApplication::ExcelApplication(ExcelApplicationImpl *impl): HandleBase(impl)
+{ 
+}
+
+
+ExcelApplicationImpl& ExcelApplication::Body() const
+{
+    return dynamic_cast<ExcelApplicationImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
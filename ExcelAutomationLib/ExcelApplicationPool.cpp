@@ -0,0 +1,462 @@
+﻿/*!
+* @file    ExcelApplicationPool.cpp
+* @brief   Implementation file for class ExcelApplicationPool and class ExcelApplicationLease
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <windows.h>
+#include <psapi.h>
+#include <cassert>
+
+#include "ExcelApplicationPool.h"
+#include "ComUtil.h"
+#include "InstancePool.h"
+#include "Noncopyable.h"
+
+#pragma comment(lib, "psapi.lib")
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief Get the Global Interface Table of the process, which keeps the idle instances.
+    * @return NULL if failed. The caller releases it.
+    * @note COM must be initialized on the calling thread.
+    */
+    IGlobalInterfaceTable* GetGlobalInterfaceTable()
+    {
+        IGlobalInterfaceTable *pTable = 0;
+        HRESULT hr = ::CoCreateInstance(CLSID_StdGlobalInterfaceTable, NULL, CLSCTX_INPROC_SERVER,
+            IID_IGlobalInterfaceTable, (LPVOID*)&pTable);
+
+        return SUCCEEDED(hr) ? pTable : 0;
+    }
+
+    /*!
+    * @brief Whether an instance still answers
+    */
+    bool IsResponding(IDispatch *pApp)
+    {
+        VARIANT result;
+        ::VariantInit(&result);
+
+        HRESULT hr = ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_PROPERTYGET, OLESTR("Ready"), &result);
+
+        ::VariantClear(&result);
+
+        return SUCCEEDED(hr);
+    }
+
+    /*!
+    * @brief Private bytes of the process of an instance, 0 if not known
+    */
+    unsigned long long GetMemoryUsage(IDispatch *pApp)
+    {
+        VARIANT result;
+        ::VariantInit(&result);
+
+        HRESULT hr = ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_PROPERTYGET, OLESTR("Hwnd"), &result);
+        if (SUCCEEDED(hr))
+            hr = ::VariantChangeType(&result, &result, 0, VT_I4);
+
+        if (FAILED(hr))
+        {
+            ::VariantClear(&result);
+            return 0;
+        }
+
+        DWORD processId = 0;
+        ::GetWindowThreadProcessId(reinterpret_cast<HWND>(static_cast<LONG_PTR>(result.lVal)), &processId);
+
+        HANDLE process = ::OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+        if (process == NULL)
+            return 0;
+
+        unsigned long long memory = 0;
+
+        PROCESS_MEMORY_COUNTERS counters;
+        counters.cb = sizeof(counters);
+        if (::GetProcessMemoryInfo(process, &counters, sizeof(counters)))
+            memory = counters.PagefileUsage;
+
+        ::CloseHandle(process);
+
+        return memory;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ComApplicationFactory
+
+/*!
+* @brief Class ComApplicationFactory starts and quits the Excel instances of an ExcelApplicationPool.
+* @details It runs on the pool thread, which is a single-threaded apartment of its own. An instance is kept
+*          in the Global Interface Table, and its cookie is its id.
+*/
+class ComApplicationFactory : public InstancePool::Factory, public Noncopyable
+{
+public:
+    ComApplicationFactory(): m_pTable(0) { }
+
+private:
+    virtual void EnterThread()
+    {
+        ::CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+        m_pTable = GetGlobalInterfaceTable();
+    }
+
+    virtual void LeaveThread()
+    {
+        if (m_pTable)
+        {
+            m_pTable->Release();
+            m_pTable = 0;
+        }
+
+        ::CoUninitialize();
+    }
+
+    virtual bool Create(InstancePool::InstanceId &id, unsigned long long &memory);
+
+    virtual bool IsAlive(InstancePool::InstanceId id);
+
+    virtual void Destroy(InstancePool::InstanceId id);
+
+    virtual void Wait(Event &wake, unsigned long timeout);
+
+    // Get the instance of an id, NULL if failed. The caller releases it.
+    IDispatch* GetInstance(InstancePool::InstanceId id);
+
+private:
+    IGlobalInterfaceTable *m_pTable;
+};
+
+
+bool ComApplicationFactory::Create(InstancePool::InstanceId &id, unsigned long long &memory)
+{
+    if (!m_pTable)
+        return false;
+
+    CLSID clsid;
+    HRESULT hr = ::CLSIDFromProgID(OLESTR("Excel.Application"), &clsid);
+
+    if (FAILED(hr))
+        return false;
+
+    IDispatch *pApp = 0;
+    hr = ::CoCreateInstance(clsid, NULL, CLSCTX_LOCAL_SERVER, IID_IDispatch, (LPVOID*)&pApp);
+
+    if (FAILED(hr))
+        return false;
+
+    // Warm it up: hidden, no alert to block the automation, and none of the work which is only for a user
+    ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT, OLESTR("Visible"), NULL, false);
+    ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT, OLESTR("DisplayAlerts"), NULL, false);
+    ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT, OLESTR("ScreenUpdating"), NULL, false);
+    ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_PROPERTYPUT, OLESTR("EnableEvents"), NULL, false);
+
+    memory = GetMemoryUsage(pApp);
+
+    DWORD cookie = 0;
+    hr = m_pTable->RegisterInterfaceInGlobal(pApp, IID_IDispatch, &cookie);
+
+    if (FAILED(hr))
+        ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_METHOD, OLESTR("Quit"), NULL);
+
+    // The table keeps its own reference
+    pApp->Release();
+
+    id = cookie;
+    return SUCCEEDED(hr);
+}
+
+
+bool ComApplicationFactory::IsAlive(InstancePool::InstanceId id)
+{
+    IDispatch *pApp = GetInstance(id);
+    if (!pApp)
+        return false;
+
+    bool alive = IsResponding(pApp);
+    pApp->Release();
+
+    return alive;
+}
+
+
+void ComApplicationFactory::Destroy(InstancePool::InstanceId id)
+{
+    IDispatch *pApp = GetInstance(id);
+    if (pApp)
+    {
+        // It fails if the instance is dead already
+        ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_METHOD, OLESTR("Quit"), NULL);
+        pApp->Release();
+    }
+
+    if (m_pTable)
+        m_pTable->RevokeInterfaceFromGlobal(id);
+}
+
+
+void ComApplicationFactory::Wait(Event &wake, unsigned long timeout)
+{
+    // The window messages of COM are served while the pool thread is idle; a message does not end the wait
+    HANDLE handle = wake.GetHandle();
+    unsigned long start = Thread::TickCount();
+
+    for (;;)
+    {
+        DWORD remaining = INFINITE;
+        if (timeout != Event::infinite)
+        {
+            unsigned long elapsed = Thread::TickCount() - start;
+            remaining = (elapsed < timeout) ? timeout - elapsed : 0;
+        }
+
+        DWORD result = ::MsgWaitForMultipleObjects(1, &handle, FALSE, remaining, QS_ALLINPUT);
+        if (result != WAIT_OBJECT_0 + 1)
+            break;  // set, timed out or failed
+
+        MSG msg;
+        while (::PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+        {
+            ::TranslateMessage(&msg);
+            ::DispatchMessage(&msg);
+        }
+    }
+}
+
+
+IDispatch* ComApplicationFactory::GetInstance(InstancePool::InstanceId id)
+{
+    if (!m_pTable)
+        return 0;
+
+    IDispatch *pApp = 0;
+    HRESULT hr = m_pTable->GetInterfaceFromGlobal(id, IID_IDispatch, (LPVOID*)&pApp);
+
+    return SUCCEEDED(hr) ? pApp : 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ExcelApplicationPoolImpl
+
+/*!
+* @brief Class ExcelApplicationPoolImpl inplements ExcelApplicationPool's interfaces.
+*/
+class ExcelApplicationPoolImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class ExcelApplicationPool can access members of ExcelApplicationPoolImpl.
+    friend class ExcelApplicationPool;
+
+private:
+    explicit ExcelApplicationPoolImpl(const ExcelApplicationPoolOptions &options):
+        m_pool(m_factory, MakePoolOptions(options))
+    {
+    }
+
+    bool Lease(ExcelApplication &app, unsigned long &id, unsigned long timeout);
+
+    void Return(ExcelApplication &app, unsigned long id);
+
+    ExcelApplicationPoolStats GetStats() const;
+
+    static InstancePool::Options MakePoolOptions(const ExcelApplicationPoolOptions &options)
+    {
+        InstancePool::Options poolOptions;
+        poolOptions.size = options.size;
+        poolOptions.maxWorkbooks = options.maxWorkbooks;
+        poolOptions.maxMemoryGrowth = static_cast<unsigned long long>(options.maxMemoryGrowth) * 1024 * 1024;
+        poolOptions.checkInterval = options.checkInterval;
+
+        return poolOptions;
+    }
+
+private:
+    ComApplicationFactory m_factory;    // must be constructed before m_pool, and destroyed after it
+    InstancePool          m_pool;
+};
+
+
+bool ExcelApplicationPoolImpl::Lease(ExcelApplication &app, unsigned long &id, unsigned long timeout)
+{
+    assert(!app.IsRunning());
+
+    InstancePool::InstanceId instance;
+    if (!m_pool.Lease(instance, timeout))
+        return false;
+
+    // COM has been initialized on this thread by the ExcelApplication
+    IDispatch *pApp = 0;
+    HRESULT hr = E_FAIL;
+
+    IGlobalInterfaceTable *pTable = GetGlobalInterfaceTable();
+    if (pTable)
+    {
+        hr = pTable->GetInterfaceFromGlobal(instance, IID_IDispatch, (LPVOID*)&pApp);
+        pTable->Release();
+    }
+
+    if (FAILED(hr))
+    {
+        InstancePool::Usage usage;
+        usage.healthy = false;
+        m_pool.Return(instance, usage);
+        return false;
+    }
+
+    app.Attach(pApp);
+    id = instance;
+
+    return true;
+}
+
+
+void ExcelApplicationPoolImpl::Return(ExcelApplication &app, unsigned long id)
+{
+    InstancePool::Usage usage;
+    usage.workbooks = app.CountOpenedWorkbooks();
+
+    IDispatch *pApp = app.Detach();
+
+    if (!pApp)
+    {
+        usage.healthy = false;      // shut down by the caller
+    }
+    else
+    {
+        // The next caller gets an instance without workbook; the changes are dropped, as alerts are off
+        VARIANT result;
+        ::VariantInit(&result);
+
+        HRESULT hr = ComUtil::Invoke(pApp, OLESTR("Application"), DISPATCH_PROPERTYGET, OLESTR("Workbooks"), &result);
+        if (SUCCEEDED(hr))
+            hr = ComUtil::Invoke(result.pdispVal, OLESTR("Workbooks"), DISPATCH_METHOD, OLESTR("Close"), NULL);
+
+        ::VariantClear(&result);
+
+        usage.healthy = SUCCEEDED(hr) && IsResponding(pApp);
+        if (usage.healthy)
+            usage.memory = GetMemoryUsage(pApp);
+
+        pApp->Release();
+    }
+
+    m_pool.Return(id, usage);
+}
+
+
+ExcelApplicationPoolStats ExcelApplicationPoolImpl::GetStats() const
+{
+    InstancePool::Stats poolStats = m_pool.GetStats();
+
+    ExcelApplicationPoolStats stats;
+    stats.started = poolStats.created;
+    stats.startFailures = poolStats.createFailures;
+    stats.leases = poolStats.leases;
+    stats.leaseTimeouts = poolStats.leaseTimeouts;
+    stats.recycled = poolStats.recycled;
+    stats.dead = poolStats.dead;
+    stats.idle = poolStats.idle;
+    stats.leased = poolStats.leased;
+
+    return stats;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of struct ExcelApplicationPoolOptions and struct ExcelApplicationPoolStats
+
+ExcelApplicationPoolOptions::ExcelApplicationPoolOptions(): size(2), maxWorkbooks(0), maxMemoryGrowth(0),
+    checkInterval(30000)
+{
+}
+
+
+ExcelApplicationPoolStats::ExcelApplicationPoolStats(): started(0), startFailures(0), leases(0), leaseTimeouts(0),
+    recycled(0), dead(0), idle(0), leased(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelApplicationPool
+
+ExcelApplicationPool::ExcelApplicationPool(const ExcelApplicationPoolOptions &options):
+    HandleBase(new ExcelApplicationPoolImpl(options))
+{
+}
+
+
+ExcelApplicationPoolStats ExcelApplicationPool::GetStats() const
+{
+    return Body().GetStats();
+}
+
+
+bool ExcelApplicationPool::Lease(ExcelApplication &app, unsigned long &id, unsigned long timeout)
+{
+    return Body().Lease(app, id, timeout);
+}
+
+
+void ExcelApplicationPool::Return(ExcelApplication &app, unsigned long id)
+{
+    Body().Return(app, id);
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelApplicationPool::ExcelApplicationPool(ExcelApplicationPoolImpl *impl): HandleBase(impl)
+{
+}
+
+
+ExcelApplicationPoolImpl& ExcelApplicationPool::Body() const
+{
+    return dynamic_cast<ExcelApplicationPoolImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelApplicationLease
+
+ExcelApplicationLease::ExcelApplicationLease(ExcelApplicationPool pool, unsigned long timeout /* = INFINITE */):
+    m_pool(pool), m_id(0), m_leased(false)
+{
+    assert(!pool.IsNull());
+
+    m_leased = m_pool.Lease(m_app, m_id, timeout);
+}
+
+
+ExcelApplicationLease::~ExcelApplicationLease()
+{
+    Return();
+}
+
+
+void ExcelApplicationLease::Return()
+{
+    if (!m_leased)
+        return;
+
+    m_leased = false;
+    m_pool.Return(m_app, m_id);
+}
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
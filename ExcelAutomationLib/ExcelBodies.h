@@ -0,0 +1,241 @@
+﻿/*!
+* @file    ExcelBodies.h
+* @brief   Header file for the bodies of ExcelWorkbook, ExcelWorksheetSet, ExcelWorksheet, ExcelRange and ExcelCell
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELBODIES_H_GUID_1513710E_DCCF_4979_A595_06D8BDC24BE2
+#define EXCELBODIES_H_GUID_1513710E_DCCF_4979_A595_06D8BDC24BE2
+
+
+/*!
+* @file
+* The handles of a workbook and of everything in it have two kinds of bodies: @n
+*   ComXxxImpl drives an object of a running Excel through COM (ExcelWorkbook.cpp, ExcelWorksheet.cpp, ...), @n
+*   NativeXxxImpl reads the workbook file directly, without Excel (NativeWorkbook.cpp). @n
+* The classes in this file are the abstract bodies which the handles call. Their members are private
+* and pure virtual, and only the handle class is a friend, just like a body with a single implementation.
+*/
+
+
+#include <vector>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+#include "Noncopyable.h"
+#include "ExcelCommonTypes.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheetSet.h"
+#include "ExcelWorksheet.h"
+#include "ExcelRange.h"
+#include "ExcelCell.h"
+#include "ExcelFont.h"
+#include "ExcelValue.h"
+#include "ExcelRowQuery.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class ExcelWorkbookImpl is the body of ExcelWorkbook.
+*/
+class ExcelWorkbookImpl : public BodyBase, public Noncopyable
+{
+    // Only the friend class ExcelWorkbook can call the members of ExcelWorkbookImpl.
+    friend class ExcelWorkbook;
+
+public:
+    /*!
+    * @brief Make a handle for a body, which is needed by the bodies of other classes.
+    */
+    static ExcelWorkbook MakeHandle(ExcelWorkbookImpl *impl)
+    {
+        return ExcelWorkbook(impl);
+    }
+
+protected:
+    ExcelWorkbookImpl() { }
+    virtual ~ExcelWorkbookImpl() { }
+
+private:
+    virtual ExcelWorksheet GetActiveWorksheet() = 0;
+
+    virtual ExcelWorksheetSet GetAllWorksheets() = 0;
+
+    virtual bool Save() = 0;
+    virtual bool SaveAs(const ELstring &filename) = 0;
+
+    virtual bool Close() = 0;
+};
+
+
+/*!
+* @internal
+* @brief Class ExcelWorksheetSetImpl is the body of ExcelWorksheetSet.
+*/
+class ExcelWorksheetSetImpl : public BodyBase, public Noncopyable
+{
+    // Only the friend class ExcelWorksheetSet can call the members of ExcelWorksheetSetImpl.
+    friend class ExcelWorksheetSet;
+
+public:
+    /*!
+    * @brief Make a handle for a body, which is needed by the bodies of other classes.
+    */
+    static ExcelWorksheetSet MakeHandle(ExcelWorksheetSetImpl *impl)
+    {
+        return ExcelWorksheetSet(impl);
+    }
+
+protected:
+    ExcelWorksheetSetImpl() { }
+    virtual ~ExcelWorksheetSetImpl() { }
+
+private:
+    virtual int CountWorksheets() = 0;
+
+    virtual ExcelWorksheet GetWorksheet(int index) = 0;
+
+    virtual ExcelWorksheet AddWorksheet(ExcelWorksheet ref, bool after) = 0;
+};
+
+
+/*!
+* @internal
+* @brief Class ExcelWorksheetImpl is the body of ExcelWorksheet.
+*/
+class ExcelWorksheetImpl : public BodyBase, public Noncopyable
+{
+    // Only the friend class ExcelWorksheet can call the members of ExcelWorksheetImpl.
+    friend class ExcelWorksheet;
+
+public:
+    /*!
+    * @brief Make a handle for a body, which is needed by the bodies of other classes.
+    */
+    static ExcelWorksheet MakeHandle(ExcelWorksheetImpl *impl)
+    {
+        return ExcelWorksheet(impl);
+    }
+
+protected:
+    ExcelWorksheetImpl() { }
+    virtual ~ExcelWorksheetImpl() { }
+
+private:
+    virtual IDispatch* GetIDispatch() = 0;
+
+    virtual ELstring   GetName() = 0;
+    virtual bool       SetName(const ELstring &name) = 0;
+
+    virtual ExcelRange GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo) = 0;
+    virtual ExcelCell  GetCell(ELchar column, int row) = 0;
+
+    virtual bool CopyWorksheet(bool after) = 0;
+
+    virtual bool ApplyFontSpec(const std::vector<ExcelRangeAddress> &ranges, const ExcelFontSpec &spec) = 0;
+
+    virtual bool ReadRows(const ExcelRowQuery &query, std::vector<std::vector<ELstring> > &values, 
+        std::vector<int> *rowNumbers) = 0;
+};
+
+
+/*!
+* @internal
+* @brief Class ExcelRangeImpl is the body of ExcelRange.
+*/
+class ExcelRangeImpl : public BodyBase, public Noncopyable
+{
+    // Only the friend class ExcelRange can call the members of ExcelRangeImpl.
+    friend class ExcelRange;
+
+public:
+    /*!
+    * @brief Make a handle for a body, which is needed by the bodies of other classes.
+    */
+    static ExcelRange MakeHandle(ExcelRangeImpl *impl)
+    {
+        return ExcelRange(impl);
+    }
+
+protected:
+    ExcelRangeImpl() { }
+    virtual ~ExcelRangeImpl() { }
+
+private:
+    virtual bool ReadData(ELstring &data) = 0;
+    virtual bool WriteData(const ELchar *data) = 0;
+    virtual bool WriteDataIfChanged(const ELchar *data) = 0;
+
+    virtual bool ReadTyped(std::vector<unsigned char> &data) = 0;
+    virtual bool WriteTyped(const std::vector<unsigned char> &data) = 0;
+
+    virtual bool ReadValues(std::vector<ExcelValue> &values) = 0;
+    virtual bool WriteValues(const std::vector<ExcelValue> &values) = 0;
+
+    virtual bool ReadColumns(std::vector<ExcelColumn> &columns) = 0;
+
+    virtual bool GetValue(ExcelValue &value) = 0;
+    virtual bool SetValue(const ExcelValue &value) = 0;
+
+    virtual bool Merge(bool multiRow) = 0;
+
+    virtual ExcelFont GetFont() = 0;
+    virtual bool GetFontSpec(ExcelFontSpec &spec) = 0;
+    virtual bool ApplyFontSpec(const ExcelFontSpec &spec) = 0;
+
+    virtual bool SetHorizontalAlignment(ExcelHorizontalAlignment align) = 0;
+    virtual bool SetVerticalAlignment(ExcelVerticalAlignment align) = 0;
+};
+
+
+/*!
+* @internal
+* @brief Class ExcelCellImpl is the body of ExcelCell.
+*/
+class ExcelCellImpl : public BodyBase, public Noncopyable
+{
+    // Only the friend class ExcelCell can call the members of ExcelCellImpl.
+    friend class ExcelCell;
+
+public:
+    /*!
+    * @brief Make a handle for a body, which is needed by the bodies of other classes.
+    */
+    static ExcelCell MakeHandle(ExcelCellImpl *impl)
+    {
+        return ExcelCell(impl);
+    }
+
+protected:
+    ExcelCellImpl() { }
+    virtual ~ExcelCellImpl() { }
+
+private:
+    virtual bool GetValue(ELstring &value) = 0;
+    virtual bool SetValue(const ELstring &value) = 0;
+    virtual bool SetValue(int value) = 0;
+    virtual bool SetValue(double value) = 0;
+
+    virtual bool GetValue(ExcelValue &value) = 0;
+    virtual bool SetValue(const ExcelValue &value) = 0;
+
+    virtual ExcelFont GetFont() = 0;
+    virtual bool GetFontSpec(ExcelFontSpec &spec) = 0;
+    virtual bool ApplyFontSpec(const ExcelFontSpec &spec) = 0;
+
+    virtual bool SetHorizontalAlignment(ExcelHorizontalAlignment align) = 0;
+    virtual bool SetVerticalAlignment(ExcelVerticalAlignment align) = 0;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELBODIES_H_GUID_1513710E_DCCF_4979_A595_06D8BDC24BE2
@@ -0,0 +1,287 @@
+﻿/*!
+* @file    ExcelCallStats.cpp
+* @brief   Implementation file for class ExcelCallStats
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "ExcelCallStats.h"
+#include "CallTimer.h"
+#include "Noncopyable.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief Counters of one (member, kind) pair
+    */
+    struct Counters
+    {
+        Counters(): calls(0), failures(0), ticks(0)
+        {
+            memset(buckets, 0, sizeof(buckets));
+        }
+
+        unsigned long calls;
+        unsigned long failures;
+        LONGLONG      ticks;
+        unsigned long buckets[ExcelCallStatsEntry::BucketCount];
+    };
+
+    // Key: <type name>.<member name> and the dispatch type
+    typedef std::pair<std::wstring, WORD> CounterKey;
+    typedef std::map<CounterKey, Counters> CounterMap;
+
+
+    /*!
+    * @brief Class StatsTable holds the counters and the lock which guards them.
+    */
+    class StatsTable : public Noncopyable
+    {
+    public:
+        StatsTable()
+        {
+            ::InitializeCriticalSection(&m_lock);
+
+            LARGE_INTEGER frequency;
+            ::QueryPerformanceFrequency(&frequency);
+            m_ticksPerMicrosecond = static_cast<double>(frequency.QuadPart) / 1000000.0;
+        }
+
+        ~StatsTable()
+        {
+            ::DeleteCriticalSection(&m_lock);
+        }
+
+        void Lock()
+        {
+            ::EnterCriticalSection(&m_lock);
+        }
+
+        void Unlock()
+        {
+            ::LeaveCriticalSection(&m_lock);
+        }
+
+        double ToMicroseconds(LONGLONG ticks) const
+        {
+            return static_cast<double>(ticks) / m_ticksPerMicrosecond;
+        }
+
+        // Index of the histogram bucket for a latency
+        static int GetBucket(double microseconds)
+        {
+            int bucket = 0;
+            for (double bound = 2.0; microseconds >= bound && bucket < ExcelCallStatsEntry::BucketCount - 1;
+                bound *= 2.0)
+            {
+                ++bucket;
+            }
+            return bucket;
+        }
+
+    public:
+        CounterMap       m_counters;
+
+    private:
+        double           m_ticksPerMicrosecond;
+        CRITICAL_SECTION m_lock;
+    };
+
+    // Constructed while the module is being loaded, before any call into Excel
+    StatsTable s_table;
+
+
+    /*!
+    * @brief Class TableLock locks s_table during its lifetime.
+    */
+    class TableLock : public Noncopyable
+    {
+    public:
+        TableLock()
+        {
+            s_table.Lock();
+        }
+
+        ~TableLock()
+        {
+            s_table.Unlock();
+        }
+    };
+
+
+    const ELchar* GetKindName(ExcelCallKind kind)
+    {
+        switch (kind)
+        {
+        case ECK_Method:
+            return ELtext("method");
+        case ECK_PropertyGet:
+            return ELtext("get");
+        case ECK_PropertyPut:
+            return ELtext("put");
+        default:
+            return ELtext("other");
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class CallStatsTable
+
+volatile LONG CallStatsTable::s_enabled = 0;
+
+
+void CallStatsTable::Record(LPCOLESTR typeName, LPCOLESTR name, WORD type, HRESULT hr, LONGLONG ticks)
+{
+    assert(name);
+
+    CounterKey key(typeName ? typeName : L"", type);
+    key.first += L'.';
+    key.first += name;
+
+    double microseconds = s_table.ToMicroseconds(ticks);
+
+    TableLock lock;
+
+    Counters &counters = s_table.m_counters[key];
+    ++counters.calls;
+    if (FAILED(hr))
+        ++counters.failures;
+    counters.ticks += ticks;
+    ++counters.buckets[StatsTable::GetBucket(microseconds)];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelCallStatsEntry
+
+ExcelCallStatsEntry::ExcelCallStatsEntry(): kind(ECK_Method), calls(0), failures(0), totalMicroseconds(0)
+{
+    memset(buckets, 0, sizeof(buckets));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelCallStats
+
+void ExcelCallStats::Enable(bool enable /* = true */)
+{
+    ::InterlockedExchange(const_cast<LONG*>(&CallStatsTable::s_enabled), enable ? 1 : 0);
+}
+
+
+bool ExcelCallStats::IsEnabled()
+{
+    return CallStatsTable::IsEnabled();
+}
+
+
+void ExcelCallStats::Reset()
+{
+    TableLock lock;
+    s_table.m_counters.clear();
+}
+
+
+void ExcelCallStats::TakeSnapshot(std::vector<ExcelCallStatsEntry> &entries)
+{
+    entries.clear();
+
+    TableLock lock;
+
+    entries.reserve(s_table.m_counters.size());
+
+    for (CounterMap::const_iterator it = s_table.m_counters.begin(); it != s_table.m_counters.end(); ++it)
+    {
+        ExcelCallStatsEntry entry;
+        // The names of Excel members are ASCII
+        entry.member.assign(it->first.first.begin(), it->first.first.end());
+        entry.kind = static_cast<ExcelCallKind>(it->first.second);
+        entry.calls = it->second.calls;
+        entry.failures = it->second.failures;
+        entry.totalMicroseconds = s_table.ToMicroseconds(it->second.ticks);
+        memcpy(entry.buckets, it->second.buckets, sizeof(entry.buckets));
+
+        entries.push_back(entry);
+    }
+}
+
+
+ELstring ExcelCallStats::Dump(DumpFormat format /* = TextFormat */)
+{
+    std::vector<ExcelCallStatsEntry> entries;
+    TakeSnapshot(entries);
+
+    ELostringstream out;
+    out << std::fixed << std::setprecision(1);
+
+    if (format == JsonFormat)
+    {
+        out << ELtext("[");
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const ExcelCallStatsEntry &entry = entries[i];
+
+            out << (i == 0 ? ELtext("\n") : ELtext(",\n"));
+            out << ELtext("  {\"member\": \"") << entry.member
+                << ELtext("\", \"kind\": \"") << GetKindName(entry.kind)
+                << ELtext("\", \"calls\": ") << entry.calls
+                << ELtext(", \"failures\": ") << entry.failures
+                << ELtext(", \"totalMicroseconds\": ") << entry.totalMicroseconds
+                << ELtext(", \"buckets\": [");
+
+            for (int b = 0; b < ExcelCallStatsEntry::BucketCount; ++b)
+                out << (b == 0 ? ELtext("") : ELtext(", ")) << entry.buckets[b];
+
+            out << ELtext("]}");
+        }
+        out << (entries.empty() ? ELtext("]\n") : ELtext("\n]\n"));
+    }
+    else
+    {
+        out << std::left << std::setw(32) << ELtext("member") << std::setw(8) << ELtext("kind")
+            << std::right << std::setw(10) << ELtext("calls") << std::setw(10) << ELtext("failures")
+            << std::setw(14) << ELtext("total(ms)") << std::setw(12) << ELtext("avg(us)")
+            << ELtext("  histogram(us)\n");
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const ExcelCallStatsEntry &entry = entries[i];
+
+            out << std::left << std::setw(32) << entry.member << std::setw(8) << GetKindName(entry.kind)
+                << std::right << std::setw(10) << entry.calls << std::setw(10) << entry.failures
+                << std::setw(14) << entry.totalMicroseconds / 1000.0
+                << std::setw(12) << (entry.calls ? entry.totalMicroseconds / entry.calls : 0.0)
+                << ELtext(" ");
+
+            // only the non-empty buckets, as <lower bound>:<count>
+            for (int b = 0; b < ExcelCallStatsEntry::BucketCount; ++b)
+            {
+                if (entry.buckets[b] != 0)
+                    out << ELtext(" ") << (b == 0 ? 0UL : 1UL << b) << ELtext(":") << entry.buckets[b];
+            }
+
+            out << ELtext("\n");
+        }
+    }
+
+    return out.str();
+}
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -1,250 +1,320 @@
-﻿/*!
-* @file    ExcelCell.cpp
-* @brief   Implementation file for class ExcelCell
-* @date    2009-12-31
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include "ExcelCell.h"
-#include "ComUtil.h"
-#include "Noncopyable.h"
-#include "ExcelFont.h"
-#include "ExcelUtil.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Definition and implementation of class ExcelCellImpl
-
-/*!
-* @brief Class ExcelCellImpl inplements ExcelCell's interfaces.
-*/
-class ExcelCellImpl : public BodyBase, public Noncopyable
-{
-    // All members are private. Only the friend class ExcelCell can access members of ExcelCellImpl.
-    friend class ExcelCell;
-
-private:
-    ExcelCellImpl(IDispatch *pCell, ELchar column, int row): m_pCell(pCell), m_column(column), m_row(row)
-    {
-        assert(pCell);
-    }
-
-    virtual ~ExcelCellImpl()
-    {
-        if (m_pCell)
-        {
-            m_pCell->Release();
-            m_pCell = 0;
-        }
-    }
-
-    bool GetValue(ELstring &value);
-    bool SetValue(const ELstring &value);
-    bool SetValue(int value);
-    bool SetValue(double value);
-
-    ExcelFont GetFont();
-
-    bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
-    bool SetVerticalAlignment(ExcelVerticalAlignment align);
-
-private:
-    IDispatch *m_pCell;      // in fact, it refers an "Range" object
-    ELchar     m_column;
-    int        m_row;
-};
-
-
-bool ExcelCellImpl::GetValue(ELstring &value)
-{
-    assert(m_pCell);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pCell, DISPATCH_PROPERTYGET, OLESTR("Value"), &result, 0);
-
-    if (SUCCEEDED(hr))
-    {
-        hr = ::VariantChangeType(&result, &result, VARIANT_NOUSEROVERRIDE, VT_BSTR);
-        if (SUCCEEDED(hr))
-            value = result.bstrVal;
-    }
-
-    ::VariantClear(&result);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelCellImpl::SetValue(const ELstring &value)
-{
-    assert(m_pCell);
-
-    VARIANT param;
-    param.vt = VT_BSTR;
-    param.bstrVal = ::SysAllocString(value.c_str());
-
-    HRESULT hr = ComUtil::Invoke(m_pCell, DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, 1, param);
-
-    ::VariantClear(&param);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelCellImpl::SetValue(int value)
-{
-    assert(m_pCell);
-
-    VARIANT param;
-    param.vt = VT_INT;
-    param.intVal = value;
-
-    HRESULT hr = ComUtil::Invoke(m_pCell, DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, 1, param);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelCellImpl::SetValue(double value)
-{
-    assert(m_pCell);
-
-    VARIANT param;
-    param.vt = VT_R8;
-    param.dblVal = value;
-
-    HRESULT hr = ComUtil::Invoke(m_pCell, DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, 1, param);
-
-    return SUCCEEDED(hr);
-}
-
-
-ExcelFont ExcelCellImpl::GetFont()
-{
-    assert(m_pCell);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pCell, DISPATCH_PROPERTYGET, OLESTR("Font"), &result, 0);
-
-    if (FAILED(hr))
-        return ExcelFont();
-
-    return ExcelFont(result.pdispVal);
-}
-
-
-bool ExcelCellImpl::SetHorizontalAlignment(ExcelHorizontalAlignment align)
-{
-    assert(m_pCell);
-
-    int alignConstant;
-    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
-        return false;
-
-    VARIANT param;
-    param.vt = VT_INT;
-    param.intVal = alignConstant;
-
-    HRESULT hr = ComUtil::Invoke(m_pCell, DISPATCH_PROPERTYPUT, OLESTR("HorizontalAlignment"), NULL, 1, param);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelCellImpl::SetVerticalAlignment(ExcelVerticalAlignment align)
-{
-    assert(m_pCell);
-
-    int alignConstant;
-    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
-        return false;
-
-    VARIANT param;
-    param.vt = VT_INT;
-    param.intVal = alignConstant;
-
-    HRESULT hr = ComUtil::Invoke(m_pCell, DISPATCH_PROPERTYPUT, OLESTR("VerticalAlignment"), NULL, 1, param);
-
-    return SUCCEEDED(hr);    
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Implementation of class ExcelCell
-
-ExcelCell::ExcelCell(IDispatch *pCell, ELchar column, int row): HandleBase(new ExcelCellImpl(pCell, column, row))
-{
-    assert(pCell);
-}
-
-
-bool ExcelCell::GetValue(ELstring &value)
-{
-    return Body().GetValue(value);
-}
-
-
-bool ExcelCell::SetValue(const ELstring &value)
-{
-    return Body().SetValue(value);
-}
-
-
-bool ExcelCell::SetValue(int value)
-{
-    return Body().SetValue(value);
-}
-
-
-bool ExcelCell::SetValue(double value)
-{
-    return Body().SetValue(value);
-}
-
-
-ExcelFont ExcelCell::GetFont()
-{
-    return Body().GetFont();
-}
-
-
-bool ExcelCell::SetHorizontalAlignment(ExcelHorizontalAlignment align)
-{
-    return Body().SetHorizontalAlignment(align);
-}
-
-
-bool ExcelCell::SetVerticalAlignment(ExcelVerticalAlignment align)
-{
-    return Body().SetVerticalAlignment(align);
-}
-
-
-// <begin> Handle/Body pattern implementation
-
-ExcelCell::ExcelCell(ExcelCellImpl *impl): HandleBase(impl)
-{ 
-}
-
-
-ExcelCellImpl& ExcelCell::Body() const
-{
-    return dynamic_cast<ExcelCellImpl&>(HandleBase::Body());
-}
-
-// <end> Handle/Body pattern implementation
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
-
+﻿/*!
+* @file    ExcelCell.cpp
+* @brief   Implementation file for class ExcelCell
+* @date    2009-12-31
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include "ExcelCell.h"
+#include "ExcelFont.h"
+#include "ExcelValue.h"
+#include "ExcelUtil.h"
+#include "ExcelBodies.h"
+
+#ifdef _WIN32
+#include "ComUtil.h"
+#endif
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+#ifdef _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ComCellImpl
+
+/*!
+* @brief Class ComCellImpl inplements ExcelCell's interfaces.
+*/
+class ComCellImpl : public ExcelCellImpl
+{
+    // All members are private. Only the friend class ExcelCell can create ComCellImpl.
+    friend class ExcelCell;
+
+private:
+    ComCellImpl(IDispatch *pCell, ELchar column, int row): m_pCell(pCell), m_column(column), m_row(row)
+    {
+        assert(pCell);
+    }
+
+    virtual ~ComCellImpl()
+    {
+        if (m_pCell)
+        {
+            m_pCell->Release();
+            m_pCell = 0;
+        }
+    }
+
+    virtual bool GetValue(ELstring &value);
+    virtual bool SetValue(const ELstring &value);
+    virtual bool SetValue(int value);
+    virtual bool SetValue(double value);
+
+    virtual bool GetValue(ExcelValue &value);
+    virtual bool SetValue(const ExcelValue &value);
+
+    virtual ExcelFont GetFont();
+    virtual bool GetFontSpec(ExcelFontSpec &spec);
+    virtual bool ApplyFontSpec(const ExcelFontSpec &spec);
+
+    virtual bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
+    virtual bool SetVerticalAlignment(ExcelVerticalAlignment align);
+
+private:
+    IDispatch *m_pCell;      // in fact, it refers an "Range" object
+    ELchar     m_column;
+    int        m_row;
+};
+
+
+bool ComCellImpl::GetValue(ELstring &value)
+{
+    assert(m_pCell);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    if (SUCCEEDED(hr))
+    {
+        hr = ::VariantChangeType(&result, &result, VARIANT_NOUSEROVERRIDE, VT_BSTR);
+        if (SUCCEEDED(hr))
+            value = result.bstrVal;
+    }
+
+    ::VariantClear(&result);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComCellImpl::SetValue(const ELstring &value)
+{
+    assert(m_pCell);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, value);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComCellImpl::SetValue(int value)
+{
+    assert(m_pCell);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, value);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComCellImpl::SetValue(double value)
+{
+    assert(m_pCell);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, value);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComCellImpl::GetValue(ExcelValue &value)
+{
+    assert(m_pCell);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    if (SUCCEEDED(hr))
+    {
+        hr = ComUtil::VariantToValue(&result, value);
+        ::VariantClear(&result);
+    }
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComCellImpl::SetValue(const ExcelValue &value)
+{
+    assert(m_pCell);
+
+    VARIANT param;
+    HRESULT hr = ComUtil::ValueToVariant(value, &param);
+
+    if (SUCCEEDED(hr))
+    {
+        hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, param);
+        ::VariantClear(&param);
+    }
+
+    return SUCCEEDED(hr);
+}
+
+
+ExcelFont ComCellImpl::GetFont()
+{
+    assert(m_pCell);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Font"), &result);
+
+    if (FAILED(hr))
+        return ExcelFont();
+
+    return ExcelFont(result.pdispVal);
+}
+
+
+bool ComCellImpl::GetFontSpec(ExcelFontSpec &spec)
+{
+    ExcelFont font = GetFont();
+    return !font.IsNull() && font.GetSpec(spec);
+}
+
+
+bool ComCellImpl::ApplyFontSpec(const ExcelFontSpec &spec)
+{
+    ExcelFont font = GetFont();
+    return !font.IsNull() && font.ApplySpec(spec);
+}
+
+
+bool ComCellImpl::SetHorizontalAlignment(ExcelHorizontalAlignment align)
+{
+    assert(m_pCell);
+
+    int alignConstant;
+    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
+        return false;
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("HorizontalAlignment"), NULL, alignConstant);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComCellImpl::SetVerticalAlignment(ExcelVerticalAlignment align)
+{
+    assert(m_pCell);
+
+    int alignConstant;
+    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
+        return false;
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pCell, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("VerticalAlignment"), NULL, alignConstant);
+
+    return SUCCEEDED(hr);    
+}
+
+
+#endif // _WIN32
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelCell
+
+#ifdef _WIN32
+
+ExcelCell::ExcelCell(IDispatch *pCell, ELchar column, int row): HandleBase(new ComCellImpl(pCell, column, row))
+{
+    assert(pCell);
+}
+
+#endif // _WIN32
+
+
+bool ExcelCell::GetValue(ELstring &value)
+{
+    return Body().GetValue(value);
+}
+
+
+bool ExcelCell::SetValue(const ELstring &value)
+{
+    return Body().SetValue(value);
+}
+
+
+bool ExcelCell::SetValue(int value)
+{
+    return Body().SetValue(value);
+}
+
+
+bool ExcelCell::SetValue(double value)
+{
+    return Body().SetValue(value);
+}
+
+
+bool ExcelCell::GetValue(ExcelValue &value)
+{
+    return Body().GetValue(value);
+}
+
+
+bool ExcelCell::SetValue(const ExcelValue &value)
+{
+    return Body().SetValue(value);
+}
+
+
+ExcelFont ExcelCell::GetFont()
+{
+    return Body().GetFont();
+}
+
+
+bool ExcelCell::GetFontSpec(ExcelFontSpec &spec)
+{
+    return Body().GetFontSpec(spec);
+}
+
+
+bool ExcelCell::ApplyFontSpec(const ExcelFontSpec &spec)
+{
+    return Body().ApplyFontSpec(spec);
+}
+
+
+bool ExcelCell::SetHorizontalAlignment(ExcelHorizontalAlignment align)
+{
+    return Body().SetHorizontalAlignment(align);
+}
+
+
+bool ExcelCell::SetVerticalAlignment(ExcelVerticalAlignment align)
+{
+    return Body().SetVerticalAlignment(align);
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelCell::ExcelCell(ExcelCellImpl *impl): HandleBase(impl)
+{ 
+}
+
+
+ExcelCellImpl& ExcelCell::Body() const
+{
+    return dynamic_cast<ExcelCellImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
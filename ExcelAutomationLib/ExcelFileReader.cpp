@@ -0,0 +1,83 @@
+﻿/*!
+* @file    ExcelFileReader.cpp
+* @brief   Implementation file for class ExcelFileReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <memory>
+#include "ExcelFileReader.h"
+#include "ExcelBodies.h"
+#include "FileSource.h"
+#include "NativeWorkbook.h"
+#include "XlsxReader.h"
+#include "XlsReader.h"
+#include "CompoundFile.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // Create the reader for the format of a file, by the signature at the beginning of the file
+    NativeWorkbookSource* CreateSource(const ELstring &filename)
+    {
+        FileSource file;
+        if (!file.Open(filename))
+            return NULL;
+
+        unsigned char signature[8];
+        if (file.Read(signature, sizeof(signature)) != sizeof(signature))
+            return NULL;
+
+        // a zip package
+        if (signature[0] == 'P' && signature[1] == 'K' && signature[2] == 3 && signature[3] == 4)
+            return new XlsxReader;
+
+        // an OLE compound file
+        if (CompoundFile::IsCompoundFile(signature, sizeof(signature)))
+            return new XlsReader;
+
+        return NULL;
+    }
+}
+
+
+ExcelWorkbook ExcelFileReader::Open(const ELstring &filename)
+{
+    return Open(filename, ExcelFileReadOptions());
+}
+
+
+ExcelWorkbook ExcelFileReader::Open(const ELstring &filename, const ExcelFileReadOptions &options)
+{
+    std::auto_ptr<NativeWorkbookSource> source(CreateSource(filename));
+    if (source.get() == NULL || !source->Open(filename))
+        return ExcelWorkbook();
+
+    NativeWorkbookImpl *workbook = new NativeWorkbookImpl(source.release(), 
+        options.preloadSheets ? 0 : options.maxResidentSheets);
+    ExcelWorkbook handle = ExcelWorkbookImpl::MakeHandle(workbook);
+
+    if (options.preloadSheets && !workbook->LoadAllSheets(options.parallelSheets))
+        return ExcelWorkbook();
+
+    return handle;
+}
+
+
+ExcelWorkbook ExcelFileReader::Open(const ELstring &filename, int parallelSheets)
+{
+    ExcelFileReadOptions options;
+    options.preloadSheets = true;
+    options.parallelSheets = parallelSheets;
+
+    return Open(filename, options);
+}
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
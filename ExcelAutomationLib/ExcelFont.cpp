@@ -1,323 +1,398 @@
-﻿/*!
-* @file    ExcelFont.cpp
-* @brief   Implementation file for class ExcelFont
-* @date    2010-09-01 15:12:42
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include "ExcelFont.h"
-#include "ComUtil.h"
-#include "Noncopyable.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Definition and implementation of class ExcelFontImpl
-
-/*!
-* @brief Class ExcelFontImpl inplements ExcelFont's interfaces.
-*/
-class ExcelFontImpl : public BodyBase, public Noncopyable
-{
-    // All members are private. Only the friend class ExcelFont can access members of ExcelFontImpl.
-    friend class ExcelFont;
-
-private:
-    ExcelFontImpl(IDispatch *pFont) : m_pFont(pFont)
-    {
-        assert(pFont);
-    }
-
-    virtual ~ExcelFontImpl()
-    {
-        if (m_pFont)
-        {
-            m_pFont->Release();
-            m_pFont = 0;
-        }
-    }
-
-    bool GetName(ELstring &name);
-    bool SetName(const ELstring &name);
-
-    bool GetSize(int &size);
-    bool SetSize(int size);
-
-    bool GetBold(bool &bold);
-    bool SetBold(bool bold);
-
-    bool GetItalic(bool &italic);
-    bool SetItalic(bool italic);
-
-    bool GetColor(COLORREF &rgb);
-    bool SetColor(COLORREF rgb);
-
-
-private:
-    IDispatch *m_pFont;
-};
-
-
-bool ExcelFontImpl::GetName(ELstring &name)
-{
-    assert(m_pFont);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYGET, OLESTR("Name"), &result, 0);
-
-    if (SUCCEEDED(hr))
-        name = result.bstrVal;
-
-    ::VariantClear(&result);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelFontImpl::SetName(const ExcelAutomation::ELstring &name)
-{
-    assert(m_pFont);
-
-    VARIANT param;
-    param.vt = VT_BSTR;
-    param.bstrVal = ::SysAllocString(name.c_str());
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYPUT, OLESTR("Name"), NULL, 1, param);
-
-    ::VariantClear(&param);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelFontImpl::GetSize(int &size)
-{
-    assert(m_pFont);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYGET, OLESTR("Size"), &result, 0);
-
-    if (SUCCEEDED(hr))
-    {
-        hr = ::VariantChangeType(&result, &result, VARIANT_NOUSEROVERRIDE, VT_INT);
-        if (SUCCEEDED(hr))
-            size = result.intVal;
-    }
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelFontImpl::SetSize(int size)
-{
-    assert(m_pFont);
-
-    VARIANT param;
-    param.vt = VT_INT;
-    param.intVal = size;
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYPUT, OLESTR("Size"), NULL, 1, param);
-
-    return SUCCEEDED(hr); 
-}
-
-
-bool ExcelFontImpl::GetBold(bool &bold)
-{
-    assert(m_pFont);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYGET, OLESTR("Bold"), &result, 0);
-
-    if (SUCCEEDED(hr))
-    {
-        hr = ::VariantChangeType(&result, &result, VARIANT_NOUSEROVERRIDE, VT_BOOL);
-        if (SUCCEEDED(hr))
-            bold = (result.boolVal == TRUE);
-    }
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelFontImpl::SetBold(bool bold)
-{
-    assert(m_pFont);
-
-    VARIANT param;
-    param.vt = VT_BOOL;
-    param.boolVal = bold;
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYPUT, OLESTR("Bold"), NULL, 1, param);
-
-    return SUCCEEDED(hr); 
-}
-
-
-bool ExcelFontImpl::GetItalic(bool &italic)
-{
-    assert(m_pFont);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYGET, OLESTR("Italic"), &result, 0);
-
-    if (SUCCEEDED(hr))
-    {
-        hr = ::VariantChangeType(&result, &result, VARIANT_NOUSEROVERRIDE, VT_BOOL);
-        if (SUCCEEDED(hr))
-            italic = (result.boolVal == TRUE);
-    }
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelFontImpl::SetItalic(bool italic)
-{
-    assert(m_pFont);
-
-    VARIANT param;
-    param.vt = VT_BOOL;
-    param.boolVal = italic;
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYPUT, OLESTR("Italic"), NULL, 1, param);
-
-    return SUCCEEDED(hr); 
-}
-
-
-bool ExcelFontImpl::GetColor(COLORREF &rgb)
-{
-    assert(m_pFont);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYGET, OLESTR("Color"), &result, 0);
-
-    if (SUCCEEDED(hr))
-    {
-        hr = ::VariantChangeType(&result, &result, VARIANT_NOUSEROVERRIDE, VT_UI4);
-        if (SUCCEEDED(hr))
-            rgb = result.ulVal;
-    }
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelFontImpl::SetColor(COLORREF rgb)
-{
-    assert(m_pFont);
-
-    VARIANT param;
-    param.vt = VT_UI4;
-    param.ulVal = rgb;
-
-    HRESULT hr = ComUtil::Invoke(m_pFont, DISPATCH_PROPERTYPUT, OLESTR("Color"), NULL, 1, param);
-
-    return SUCCEEDED(hr); 
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Implementation of class ExcelFont
-
-
-ExcelFont::ExcelFont(IDispatch *pFont) : HandleBase(new ExcelFontImpl(pFont))
-{
-    assert(pFont);
-}
-
-
-bool ExcelFont::GetName(ELstring &name)
-{
-    return Body().GetName(name);
-}
-
-
-bool ExcelFont::SetName(const ELstring &name)
-{
-    return Body().SetName(name);
-}
-
-
-bool ExcelFont::GetSize(int &size)
-{
-    return Body().GetSize(size);
-}
-
-
-bool ExcelFont::SetSize(int size)
-{
-    return Body().SetSize(size);
-}
-
-
-bool ExcelFont::GetBold(bool &bold)
-{
-    return Body().GetBold(bold);
-}
-
-
-bool ExcelFont::SetBold(bool bold)
-{
-    return Body().SetBold(bold);
-}
-
-
-bool ExcelFont::GetItalic(bool &italic)
-{
-    return Body().GetItalic(italic);
-}
-
-
-bool ExcelFont::SetItalic(bool italic)
-{
-    return Body().SetItalic(italic);
-}
-
-
-bool ExcelFont::GetColor(COLORREF &rgb)
-{
-    return Body().GetColor(rgb);
-}
-
-
-bool ExcelFont::SetColor(COLORREF rgb)
-{
-    return Body().SetColor(rgb);
-}
-
-
-// <begin> Handle/Body pattern implementation
-
-ExcelFont::ExcelFont(ExcelFontImpl *impl): HandleBase(impl)
-{ 
-}
-
-
-ExcelFontImpl& ExcelFont::Body() const
-{
-    return dynamic_cast<ExcelFontImpl&>(HandleBase::Body());
-}
-
-// <end> Handle/Body pattern implementation
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
-
+﻿/*!
+* @file    ExcelFont.cpp
+* @brief   Implementation file for class ExcelFont
+* @date    2010-09-01 15:12:42
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include "ExcelFont.h"
+#include "ComUtil.h"
+#include "Noncopyable.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ExcelFontImpl
+
+/*!
+* @brief Class ExcelFontImpl inplements ExcelFont's interfaces.
+*/
+class ExcelFontImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class ExcelFont can access members of ExcelFontImpl.
+    friend class ExcelFont;
+
+private:
+    ExcelFontImpl(IDispatch *pFont) : m_pFont(pFont)
+    {
+        assert(pFont);
+    }
+
+    virtual ~ExcelFontImpl()
+    {
+        if (m_pFont)
+        {
+            m_pFont->Release();
+            m_pFont = 0;
+        }
+    }
+
+    bool GetName(ELstring &name);
+    bool SetName(const ELstring &name);
+
+    bool GetSize(int &size);
+    bool SetSize(int size);
+
+    bool GetBold(bool &bold);
+    bool SetBold(bool bold);
+
+    bool GetItalic(bool &italic);
+    bool SetItalic(bool italic);
+
+    bool GetColor(COLORREF &rgb);
+    bool SetColor(COLORREF rgb);
+
+    bool GetSpec(ExcelFontSpec &spec);
+    bool ApplySpec(const ExcelFontSpec &spec);
+
+    // Read the properties in mask into spec; a mixed property is left out of spec.mask
+    bool ReadSpec(unsigned int mask, ExcelFontSpec &spec);
+
+    // Get a property and change it to the type vt. Return S_FALSE if the property is mixed (Null).
+    HRESULT GetProperty(LPOLESTR name, VARTYPE vt, VARIANT *pResult);
+
+    bool PutProperty(LPOLESTR name, const ComArg &value);
+
+
+private:
+    IDispatch *m_pFont;
+};
+
+
+HRESULT ExcelFontImpl::GetProperty(LPOLESTR name, VARTYPE vt, VARIANT *pResult)
+{
+    assert(m_pFont);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pFont, OLESTR("Font"), DISPATCH_PROPERTYGET, name, pResult);
+
+    if (SUCCEEDED(hr) && pResult->vt == VT_NULL)
+        return S_FALSE;     // the cells of the range have different values
+
+    if (SUCCEEDED(hr))
+        hr = ::VariantChangeType(pResult, pResult, VARIANT_NOUSEROVERRIDE, vt);
+
+    return SUCCEEDED(hr) ? S_OK : hr;
+}
+
+
+bool ExcelFontImpl::PutProperty(LPOLESTR name, const ComArg &value)
+{
+    assert(m_pFont);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pFont, OLESTR("Font"), DISPATCH_PROPERTYPUT, name, NULL, value);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ExcelFontImpl::GetName(ELstring &name)
+{
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = GetProperty(OLESTR("Name"), VT_BSTR, &result);
+
+    if (hr == S_OK)
+        name = result.bstrVal;
+
+    ::VariantClear(&result);
+
+    return hr == S_OK;
+}
+
+
+bool ExcelFontImpl::SetName(const ExcelAutomation::ELstring &name)
+{
+    return PutProperty(OLESTR("Name"), name);
+}
+
+
+bool ExcelFontImpl::GetSize(int &size)
+{
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = GetProperty(OLESTR("Size"), VT_INT, &result);
+
+    if (hr == S_OK)
+        size = result.intVal;
+
+    ::VariantClear(&result);
+
+    return hr == S_OK;
+}
+
+
+bool ExcelFontImpl::SetSize(int size)
+{
+    return PutProperty(OLESTR("Size"), size);
+}
+
+
+bool ExcelFontImpl::GetBold(bool &bold)
+{
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = GetProperty(OLESTR("Bold"), VT_BOOL, &result);
+
+    if (hr == S_OK)
+        bold = (result.boolVal != VARIANT_FALSE);
+
+    ::VariantClear(&result);
+
+    return hr == S_OK;
+}
+
+
+bool ExcelFontImpl::SetBold(bool bold)
+{
+    return PutProperty(OLESTR("Bold"), bold);
+}
+
+
+bool ExcelFontImpl::GetItalic(bool &italic)
+{
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = GetProperty(OLESTR("Italic"), VT_BOOL, &result);
+
+    if (hr == S_OK)
+        italic = (result.boolVal != VARIANT_FALSE);
+
+    ::VariantClear(&result);
+
+    return hr == S_OK;
+}
+
+
+bool ExcelFontImpl::SetItalic(bool italic)
+{
+    return PutProperty(OLESTR("Italic"), italic);
+}
+
+
+bool ExcelFontImpl::GetColor(COLORREF &rgb)
+{
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = GetProperty(OLESTR("Color"), VT_UI4, &result);
+
+    if (hr == S_OK)
+        rgb = result.ulVal;
+
+    ::VariantClear(&result);
+
+    return hr == S_OK;
+}
+
+
+bool ExcelFontImpl::SetColor(COLORREF rgb)
+{
+    return PutProperty(OLESTR("Color"), rgb);
+}
+
+
+bool ExcelFontImpl::GetSpec(ExcelFontSpec &spec)
+{
+    return ReadSpec(EFP_All, spec);
+}
+
+
+bool ExcelFontImpl::ApplySpec(const ExcelFontSpec &spec)
+{
+    // Every put makes Excel repaint and recalculate the layout, while a get is cheap: read the properties
+    // of the spec first, and put only the ones which differ. If the read fails, put them all.
+    ExcelFontSpec current;
+    if (!ReadSpec(spec.mask, current))
+        current = ExcelFontSpec();
+
+    bool succeeded = true;
+
+    if (spec.Has(EFP_Name) && !(current.Has(EFP_Name) && current.name == spec.name))
+        succeeded = SetName(spec.name) && succeeded;
+
+    if (spec.Has(EFP_Size) && !(current.Has(EFP_Size) && current.size == spec.size))
+        succeeded = SetSize(spec.size) && succeeded;
+
+    if (spec.Has(EFP_Bold) && !(current.Has(EFP_Bold) && current.bold == spec.bold))
+        succeeded = SetBold(spec.bold) && succeeded;
+
+    if (spec.Has(EFP_Italic) && !(current.Has(EFP_Italic) && current.italic == spec.italic))
+        succeeded = SetItalic(spec.italic) && succeeded;
+
+    if (spec.Has(EFP_Color) && !(current.Has(EFP_Color) && current.color == spec.color))
+        succeeded = SetColor(spec.color) && succeeded;
+
+    return succeeded;
+}
+
+
+bool ExcelFontImpl::ReadSpec(unsigned int mask, ExcelFontSpec &spec)
+{
+    // A mixed property is not an error, it is only left out of the spec
+    static const struct
+    {
+        LPOLESTR          name;
+        ExcelFontProperty property;
+        VARTYPE           vt;
+    } properties[] = {
+        { OLESTR("Name"),   EFP_Name,   VT_BSTR },
+        { OLESTR("Size"),   EFP_Size,   VT_INT  },
+        { OLESTR("Bold"),   EFP_Bold,   VT_BOOL },
+        { OLESTR("Italic"), EFP_Italic, VT_BOOL },
+        { OLESTR("Color"),  EFP_Color,  VT_UI4  }
+    };
+
+    spec = ExcelFontSpec();
+
+    for (size_t i = 0; i < sizeof(properties) / sizeof(properties[0]); ++i)
+    {
+        if ((mask & properties[i].property) == 0)
+            continue;
+
+        VARIANT result;
+        ::VariantInit(&result);
+
+        HRESULT hr = GetProperty(properties[i].name, properties[i].vt, &result);
+
+        if (hr == S_OK)
+        {
+            switch (properties[i].property)
+            {
+            case EFP_Name:   spec.SetName(result.bstrVal);                    break;
+            case EFP_Size:   spec.SetSize(result.intVal);                     break;
+            case EFP_Bold:   spec.SetBold(result.boolVal != VARIANT_FALSE);   break;
+            case EFP_Italic: spec.SetItalic(result.boolVal != VARIANT_FALSE); break;
+            case EFP_Color:  spec.SetColor(result.ulVal);                     break;
+            default:         assert(false);                                   break;
+            }
+        }
+
+        ::VariantClear(&result);
+
+        if (FAILED(hr))
+            return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelFont
+
+
+ExcelFont::ExcelFont(IDispatch *pFont) : HandleBase(new ExcelFontImpl(pFont))
+{
+    assert(pFont);
+}
+
+
+bool ExcelFont::GetName(ELstring &name)
+{
+    return Body().GetName(name);
+}
+
+
+bool ExcelFont::SetName(const ELstring &name)
+{
+    return Body().SetName(name);
+}
+
+
+bool ExcelFont::GetSize(int &size)
+{
+    return Body().GetSize(size);
+}
+
+
+bool ExcelFont::SetSize(int size)
+{
+    return Body().SetSize(size);
+}
+
+
+bool ExcelFont::GetBold(bool &bold)
+{
+    return Body().GetBold(bold);
+}
+
+
+bool ExcelFont::SetBold(bool bold)
+{
+    return Body().SetBold(bold);
+}
+
+
+bool ExcelFont::GetItalic(bool &italic)
+{
+    return Body().GetItalic(italic);
+}
+
+
+bool ExcelFont::SetItalic(bool italic)
+{
+    return Body().SetItalic(italic);
+}
+
+
+bool ExcelFont::GetColor(COLORREF &rgb)
+{
+    return Body().GetColor(rgb);
+}
+
+
+bool ExcelFont::SetColor(COLORREF rgb)
+{
+    return Body().SetColor(rgb);
+}
+
+
+bool ExcelFont::GetSpec(ExcelFontSpec &spec)
+{
+    return Body().GetSpec(spec);
+}
+
+
+bool ExcelFont::ApplySpec(const ExcelFontSpec &spec)
+{
+    return Body().ApplySpec(spec);
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelFont::ExcelFont(ExcelFontImpl *impl): HandleBase(impl)
+{ 
+}
+
+
+ExcelFontImpl& ExcelFont::Body() const
+{
+    return dynamic_cast<ExcelFontImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
@@ -0,0 +1,36 @@
+﻿/*!
+* @file    ExcelPerformanceScope.cpp
+* @brief   Implementation file for class ExcelPerformanceScope
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+
+#include "ExcelPerformanceScope.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+ExcelPerformanceScope::ExcelPerformanceScope(ExcelApplication app, bool recalculateOnExit /* = false */):
+    m_app(app), m_recalculateOnExit(recalculateOnExit), m_succeeded(false)
+{
+    assert(m_app.IsRunning());
+
+    m_succeeded = m_app.EnterPerformanceMode();
+}
+
+
+ExcelPerformanceScope::~ExcelPerformanceScope()
+{
+    // The application may have been shut down in the scope, nothing to restore then
+    if (m_app.IsRunning())
+        m_app.LeavePerformanceMode(m_recalculateOnExit);
+}
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
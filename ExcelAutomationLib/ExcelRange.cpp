@@ -1,350 +1,753 @@
-﻿/*!
-* @file    ExcelRange.cpp
-* @brief   Implementation file for class ExcelRange
-* @date    2009-12-08
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include <tchar.h>
-#include <cassert>
-#include <sstream>
-
-#include "ExcelRange.h"
-#include "StringUtil.h"
-#include "ComUtil.h"
-#include "Noncopyable.h"
-#include "ExcelFont.h"
-#include "ExcelUtil.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-////////////////////////////////////////////////////////////////////////////////
-// Definition and implementation of class ExcelRangeImpl
-
-/*!
-* @brief Class ExcelWorksheetImpl inplements ExcelWorksheet's interfaces.
-* @note: All calling for ExcelWorksheet's interface will redirect to ExcelRangeImpl.
-*/
-class ExcelRangeImpl : public BodyBase, public Noncopyable
-{
-    // All members are private, so only the friend class ExcelRange can access the members of ExcelRangeImpl
-    friend class ExcelRange;
-
-private:
-    ExcelRangeImpl(IDispatch *pRange, ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo): \
-        m_pRange(pRange), m_columnFrom(columnFrom), m_columnTo(columnTo), m_rowFrom(rowFrom), m_rowTo(rowTo),
-        m_merged(false), m_multiRowMerged(false)
-    {
-        assert(pRange);
-    }
-
-    virtual ~ExcelRangeImpl()
-    {
-        if (m_pRange)
-        {
-            m_pRange->Release();
-            m_pRange = 0;
-        }
-    }
-
-    bool ReadData(ELstring &data);
-    bool WriteData(const ELchar *data);
-
-    bool Merge(bool multiRow);
-
-    ExcelFont GetFont();
-
-    bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
-    bool SetVerticalAlignment(ExcelVerticalAlignment align);
-    
-
-private:
-    IDispatch *m_pRange;
-    ELchar     m_columnFrom;
-    ELchar     m_columnTo;
-    int        m_rowFrom;
-    int        m_rowTo;
-    bool       m_merged;
-    bool       m_multiRowMerged;
-};
-
-
-bool ExcelRangeImpl::ReadData(ELstring &data)
-{
-    assert(!m_merged);
-    assert(m_pRange);
-    data.clear();
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pRange, DISPATCH_PROPERTYGET, OLESTR("Value"), &result, 0);
-
-    if (SUCCEEDED(hr))
-    {
-        hr = ComUtil::EncodeSafeArrayDim2(result.parray, data);
-        ::VariantClear(&result);
-    }
-
-    return SUCCEEDED(hr);
-}
-
-
-
-bool ExcelRangeImpl::WriteData(const ELchar *data)
-{
-    assert(!m_merged);
-    assert(m_pRange);
-
-    VARIANT param;
-    param.vt = VT_ARRAY | VT_VARIANT;
-    param.parray = ComUtil::DecodeSafeArrayDim2(data);
-
-    HRESULT hr = ComUtil::Invoke(m_pRange, DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, 1, param);
-
-    ::VariantClear(&param);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelRangeImpl::Merge(bool multiRow)
-{
-    assert(m_pRange);
-
-    VARIANT param;
-    param.vt = VT_BOOL;
-    param.boolVal = multiRow;
-
-    HRESULT hr = ComUtil::Invoke(m_pRange, DISPATCH_METHOD, OLESTR("Merge"), NULL, 1, param);
-
-    m_merged = SUCCEEDED(hr);
-    m_multiRowMerged = multiRow;
-
-    return SUCCEEDED(hr);
-}
-
-
-ExcelFont ExcelRangeImpl::GetFont()
-{
-    assert(m_pRange);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pRange, DISPATCH_PROPERTYGET, OLESTR("Font"), &result, 0);
-
-    if (FAILED(hr))
-        return ExcelFont();
-
-    return ExcelFont(result.pdispVal);
-}
-
-
-bool ExcelRangeImpl::SetHorizontalAlignment(ExcelHorizontalAlignment align)
-{
-    assert(m_pRange);
-
-    int alignConstant;
-    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
-        return false;
-
-    VARIANT param;
-    param.vt = VT_INT;
-    param.intVal = alignConstant;
-
-    HRESULT hr = ComUtil::Invoke(m_pRange, DISPATCH_PROPERTYPUT, OLESTR("HorizontalAlignment"), NULL, 1, param);
-
-    return SUCCEEDED(hr);
-}
-
-
-bool ExcelRangeImpl::SetVerticalAlignment(ExcelVerticalAlignment align)
-{
-    assert(m_pRange);
-
-    int alignConstant;
-    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
-        return false;
-
-    VARIANT param;
-    param.vt = VT_INT;
-    param.intVal = alignConstant;
-
-    HRESULT hr = ComUtil::Invoke(m_pRange, DISPATCH_PROPERTYPUT, OLESTR("VerticalAlignment"), NULL, 1, param);
-
-    return SUCCEEDED(hr);    
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// class ExcelRange implementation
-
-ExcelRange::ExcelRange(IDispatch *pRange, ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo): 
-    HandleBase(new ExcelRangeImpl(pRange, columnFrom, columnTo, rowFrom, rowTo))
-{
-    assert(pRange);
-}
-
-
-bool ExcelRange::ReadData(ELstring &data)
-{
-    return Body().ReadData(data);
-}
-
-
-bool ExcelRange::ReadData(std::vector<std::vector<ELstring> > &values)
-{
-    ELstring tmp;
-    if (!ReadData(tmp))
-        return false;
-
-    return DecodeData(tmp, values);
-}
-
-
-bool ExcelRange::WriteData(const ELchar *data)
-{
-    return Body().WriteData(data);
-}
-
-
-bool ExcelRange::WriteData(const ELstring &data)
-{
-    return WriteData(data.c_str());
-}
-
-
-bool ExcelRange::WriteData(const std::vector<std::vector<ELstring> > &values)
-{
-    ELstring tmp = EncodeData(values);
-    return WriteData(tmp);
-}
-
-
-bool ExcelRange::DecodeData(const ELstring &data, std::vector<std::vector<ELstring> > &values)
-{
-    std::basic_istringstream<ELchar> iss(data);
-    iss >> std::noskipws;
-
-    int row = 0;
-    int column = 0;
-    ELchar dumb;
-
-    // Encoding format: <row>#<column>#
-    iss >> row >> dumb;             // <row>#
-    assert(dumb == ELtext('#'));    // Whether the delimiter is '#', it's not important. 
-                                    // So we just place an assert statement here.
-    iss >> column >> dumb;          // <column>#
-    assert(dumb == ELtext('#'));
-
-    if (row <=0 || column <= 0)
-        return false;   // no data or dirty data
-
-    // initialize the two-dimensional array
-    std::vector<std::vector<ELstring> >(row, std::vector<ELstring>(column, ELstring())).swap(values);
-
-    bool validState = true;  // flag indicating whether the data is well formed
-
-    for (int i = 0; validState && i < row; ++i)
-    {
-        for (int j = 0; validState && j < column; ++j)
-        {
-            // Encoding format: <number of characters>#<characters>
-            int count = 0;
-            iss >> count >> dumb;
-            assert(dumb == ELtext('#'));
-
-            validState = iss.good() && (count >= 0);
-
-            ELstring curValue;
-            for (int k = 0; k < count; ++k)
-            {
-                ELchar ch;
-                iss >> ch;
-                curValue.push_back(ch);
-            }
-
-            validState = validState && iss.good();
-
-            if (validState)
-                values[i][j] = curValue;
-        }
-    }
-
-    return validState;
-}
-
-
-ELstring ExcelRange::EncodeData(const std::vector<std::vector<ELstring> > &values)
-{
-    std::basic_ostringstream<ELchar> oss;
-
-    int rowNum = values.size();
-    if (rowNum == 0)
-        return ELstring(ELtext("0#"));
-
-    int columnNum = values[0].size();
-
-    // Encoding format: <row>#<column>#
-    oss << rowNum << ELtext('#') << columnNum << ELtext('#');
-
-    for (int i = 0; i < rowNum; ++i)
-    {
-        for (int j = 0; j < columnNum; ++j)
-        {
-            // Encoding format: <number of characters>#<characters>
-            oss << values[i][j].length() << ELtext('#') << values[i][j];
-        }
-    }
-
-    return oss.str();
-}
-
-
-bool ExcelRange::Merge(bool multiRow /* = false */)
-{
-    return Body().Merge(multiRow);
-}
-
-
-ExcelFont ExcelRange::GetFont()
-{
-    return Body().GetFont();
-}
-
-
-bool ExcelRange::SetHorizontalAlignment(ExcelHorizontalAlignment align)
-{
-    return Body().SetHorizontalAlignment(align);
-}
-
-
-bool ExcelRange::SetVerticalAlignment(ExcelVerticalAlignment align)
-{
-    return Body().SetVerticalAlignment(align);
-}
-
-
-// <begin> Handle/Body pattern implementation
-
-ExcelRange::ExcelRange(ExcelRangeImpl *impl): HandleBase(impl)
-{
-}
-
-
-ExcelRangeImpl& ExcelRange::Body() const
-{
-    return dynamic_cast<ExcelRangeImpl&>(HandleBase::Body());
-}
-
-// <end> Handle/Body pattern implementation
-
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
+﻿/*!
+* @file    ExcelRange.cpp
+* @brief   Implementation file for class ExcelRange
+* @date    2009-12-08
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <algorithm>
+#include <string>
+
+#include "ExcelRange.h"
+#include "StringUtil.h"
+#include "ExcelFont.h"
+#include "ExcelValue.h"
+#include "ExcelRangeView.h"
+#include "ExcelUtil.h"
+#include "RangeCodec.h"
+#include "ExcelBodies.h"
+
+#ifdef _WIN32
+#include <tchar.h>
+#include "ComUtil.h"
+#include "RangeFingerprint.h"
+#endif
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+#ifdef _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ComRangeImpl
+
+/*!
+* @brief Class ComRangeImpl inplements ExcelRange's interfaces.
+*/
+class ComRangeImpl : public ExcelRangeImpl
+{
+    // All members are private. Only the friend class ExcelRange can create ComRangeImpl.
+    friend class ExcelRange;
+
+private:
+    ComRangeImpl(IDispatch *pRange, ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo): \
+        m_pRange(pRange), m_columnFrom(columnFrom), m_columnTo(columnTo), m_rowFrom(rowFrom), m_rowTo(rowTo),
+        m_merged(false), m_multiRowMerged(false)
+    {
+        assert(pRange);
+    }
+
+    virtual ~ComRangeImpl()
+    {
+        if (m_pRange)
+        {
+            m_pRange->Release();
+            m_pRange = 0;
+        }
+    }
+
+    virtual bool ReadData(ELstring &data);
+    virtual bool WriteData(const ELchar *data);
+    virtual bool WriteDataIfChanged(const ELchar *data);
+
+    virtual bool ReadTyped(std::vector<unsigned char> &data);
+    virtual bool WriteTyped(const std::vector<unsigned char> &data);
+
+    virtual bool ReadValues(std::vector<ExcelValue> &values);
+    virtual bool WriteValues(const std::vector<ExcelValue> &values);
+
+    virtual bool ReadColumns(std::vector<ExcelColumn> &columns);
+
+    virtual bool GetValue(ExcelValue &value);
+    virtual bool SetValue(const ExcelValue &value);
+
+    virtual bool Merge(bool multiRow);
+
+    virtual ExcelFont GetFont();
+    virtual bool GetFontSpec(ExcelFontSpec &spec);
+    virtual bool ApplyFontSpec(const ExcelFontSpec &spec);
+
+    virtual bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
+    virtual bool SetVerticalAlignment(ExcelVerticalAlignment align);
+    
+
+private:
+    IDispatch *m_pRange;
+    ELchar     m_columnFrom;
+    ELchar     m_columnTo;
+    int        m_rowFrom;
+    int        m_rowTo;
+    bool       m_merged;
+    bool       m_multiRowMerged;
+
+    // The cells as last read or written by ReadData() or WriteData(), empty if the range has been written
+    // in another way since
+    RangeFingerprint m_fingerprint;
+};
+
+
+bool ComRangeImpl::ReadData(ELstring &data)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+    data.clear();
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    if (SUCCEEDED(hr))
+    {
+        hr = ComUtil::EncodeSafeArrayDim2(result.parray, data);
+        ::VariantClear(&result);
+    }
+
+    if (SUCCEEDED(hr))
+        m_fingerprint.Assign(data.data(), data.length());
+    else
+        m_fingerprint.Clear();
+
+    return SUCCEEDED(hr);
+}
+
+
+
+bool ComRangeImpl::WriteData(const ELchar *data)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+
+    VARIANT param;
+    param.vt = VT_ARRAY | VT_VARIANT;
+    param.parray = ComUtil::DecodeSafeArrayDim2(data);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, param);
+
+    ::VariantClear(&param);
+
+    if (SUCCEEDED(hr))
+        m_fingerprint.Assign(data, std::char_traits<ELchar>::length(data));
+    else
+        m_fingerprint.Clear();
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::WriteDataIfChanged(const ELchar *data)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+    assert(data);
+
+    RangeFingerprint next;
+    std::vector<CellPos> positions;
+    std::vector<RangeFingerprint::ChangedCell> cells;
+
+    if (m_fingerprint.IsEmpty() ||
+        !m_fingerprint.Compare(data, std::char_traits<ELchar>::length(data), next, positions, cells))
+        return WriteData(data);     // nothing to compare with
+
+    std::vector<CellRect> rects;
+    CellRectangles::Build(positions, rects);
+
+    bool succeeded = true;
+    for (size_t k = 0; k < rects.size() && succeeded; ++k)
+    {
+        const CellRect &rect = rects[k];
+
+        SAFEARRAYBOUND bounds[2];
+        bounds[0].lLbound = 1;
+        bounds[0].cElements = rect.CountRows();
+        bounds[1].lLbound = 1;
+        bounds[1].cElements = rect.CountColumns();
+
+        VARIANT param;
+        param.vt = VT_ARRAY | VT_VARIANT;
+        param.parray = ::SafeArrayCreate(VT_VARIANT, 2, bounds);
+        if (!param.parray)
+        {
+            succeeded = false;
+            break;
+        }
+
+        {
+            SafeArrayDim2Data elems(param.parray);
+            succeeded = SUCCEEDED(elems.Status());
+
+            for (int row = rect.rowFrom; succeeded && row <= rect.rowTo; ++row)
+            {
+                // the changed cells of a row are adjacent in positions
+                size_t index = std::lower_bound(positions.begin(), positions.end(), CellPos(row, rect.columnFrom)) -
+                    positions.begin();
+
+                for (int column = rect.columnFrom; succeeded && column <= rect.columnTo; ++column, ++index)
+                {
+                    assert(index < positions.size() && positions[index].row == row && positions[index].column == column);
+
+                    VARIANT &elem = elems.At(row - rect.rowFrom, column - rect.columnFrom);
+                    elem.vt = VT_BSTR;
+                    elem.bstrVal = ::SysAllocStringLen(cells[index].value, static_cast<UINT>(cells[index].length));
+
+                    // out of memory: the rectangle is not written
+                    if (!elem.bstrVal)
+                        succeeded = false;
+                }
+            }
+        }
+
+        // the address is relative to the top-left cell of this range
+        ELchar address[50];
+        memset(address, 0, sizeof(address));
+        _stprintf_s(address, 50, ELtext("%c%d:%c%d"), ELtext('A') + rect.columnFrom, rect.rowFrom + 1,
+            ELtext('A') + rect.columnTo, rect.rowTo + 1);
+
+        VARIANT range;
+        ::VariantInit(&range);
+
+        HRESULT hr = E_FAIL;
+        if (succeeded)
+            hr = ComUtil::Invoke(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Range"), &range, address);
+
+        if (SUCCEEDED(hr))
+        {
+            hr = ComUtil::InvokeEarlyBound(range.pdispVal, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"),
+                NULL, param);
+            ::VariantClear(&range);
+        }
+
+        ::VariantClear(&param);
+        succeeded = SUCCEEDED(hr);
+    }
+
+    // after a failure, some of the changed cells may have been written
+    if (succeeded)
+        m_fingerprint.Swap(next);
+    else
+        m_fingerprint.Clear();
+
+    return succeeded;
+}
+
+
+bool ComRangeImpl::ReadTyped(std::vector<unsigned char> &data)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+    data.clear();
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    if (SUCCEEDED(hr))
+    {
+        if (result.vt & VT_ARRAY)
+        {
+            hr = ComUtil::EncodeSafeArrayDim2Typed(result.parray, data);
+        }
+        else
+        {
+            // the value of a single cell range is not an array
+            ExcelTypedWriter writer(data);
+            writer.Begin(1, 1);
+            hr = ComUtil::EncodeVariantTyped(&result, writer);
+        }
+
+        ::VariantClear(&result);
+    }
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::WriteTyped(const std::vector<unsigned char> &data)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+    m_fingerprint.Clear();
+
+    if (data.empty())
+        return false;
+
+    VARIANT param;
+    param.vt = VT_ARRAY | VT_VARIANT;
+    param.parray = ComUtil::DecodeSafeArrayDim2Typed(&data[0], data.size());
+
+    if (!param.parray)
+        return false;
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, param);
+
+    ::VariantClear(&param);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::ReadValues(std::vector<ExcelValue> &values)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    if (SUCCEEDED(hr))
+    {
+        if (result.vt & VT_ARRAY)
+        {
+            hr = ComUtil::SafeArrayDim2ToValues(result.parray, values);
+        }
+        else
+        {
+            // the value of a single cell range is not an array
+            values.resize(1);
+            hr = ComUtil::VariantToValue(&result, values[0]);
+        }
+
+        ::VariantClear(&result);
+    }
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::WriteValues(const std::vector<ExcelValue> &values)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+    m_fingerprint.Clear();
+
+    VARIANT param;
+    param.vt = VT_ARRAY | VT_VARIANT;
+    param.parray = ComUtil::ValuesToSafeArrayDim2(values, m_rowTo - m_rowFrom + 1, m_columnTo - m_columnFrom + 1);
+
+    if (!param.parray)
+        return false;
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, param);
+
+    ::VariantClear(&param);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::ReadColumns(std::vector<ExcelColumn> &columns)
+{
+    assert(!m_merged);
+    assert(m_pRange);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    if (SUCCEEDED(hr))
+    {
+        if (result.vt & VT_ARRAY)
+        {
+            hr = ComUtil::SafeArrayDim2ToColumns(result.parray, columns);
+        }
+        else if (ExcelUtil::PrepareColumns(columns, 1, 1))
+        {
+            // the value of a single cell range is not an array
+            ComUtil::VariantToColumn(&result, columns[0], 0);
+        }
+        else
+        {
+            hr = E_INVALIDARG;
+        }
+
+        ::VariantClear(&result);
+    }
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::GetValue(ExcelValue &value)
+{
+    assert(m_pRange);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    if (SUCCEEDED(hr))
+    {
+        if (result.vt & VT_ARRAY)
+        {
+            SafeArrayDim2Data data(result.parray);
+            hr = data.Status();
+            if (SUCCEEDED(hr))
+                hr = ComUtil::VariantToValue(&data.At(0, 0), value);
+        }
+        else
+        {
+            hr = ComUtil::VariantToValue(&result, value);
+        }
+
+        ::VariantClear(&result);
+    }
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::SetValue(const ExcelValue &value)
+{
+    assert(m_pRange);
+    m_fingerprint.Clear();
+
+    // Excel sets every cell of the range to a value which is not an array
+    VARIANT param;
+    HRESULT hr = ComUtil::ValueToVariant(value, &param);
+
+    if (SUCCEEDED(hr))
+    {
+        hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, param);
+        ::VariantClear(&param);
+    }
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::Merge(bool multiRow)
+{
+    assert(m_pRange);
+    m_fingerprint.Clear();
+
+    HRESULT hr = ComUtil::Invoke(m_pRange, OLESTR("Range"), DISPATCH_METHOD, OLESTR("Merge"), NULL, multiRow);
+
+    m_merged = SUCCEEDED(hr);
+    m_multiRowMerged = multiRow;
+
+    return SUCCEEDED(hr);
+}
+
+
+ExcelFont ComRangeImpl::GetFont()
+{
+    assert(m_pRange);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Font"), &result);
+
+    if (FAILED(hr))
+        return ExcelFont();
+
+    return ExcelFont(result.pdispVal);
+}
+
+
+bool ComRangeImpl::GetFontSpec(ExcelFontSpec &spec)
+{
+    ExcelFont font = GetFont();
+    return !font.IsNull() && font.GetSpec(spec);
+}
+
+
+bool ComRangeImpl::ApplyFontSpec(const ExcelFontSpec &spec)
+{
+    ExcelFont font = GetFont();
+    return !font.IsNull() && font.ApplySpec(spec);
+}
+
+
+bool ComRangeImpl::SetHorizontalAlignment(ExcelHorizontalAlignment align)
+{
+    assert(m_pRange);
+
+    int alignConstant;
+    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
+        return false;
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("HorizontalAlignment"), NULL, alignConstant);
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComRangeImpl::SetVerticalAlignment(ExcelVerticalAlignment align)
+{
+    assert(m_pRange);
+
+    int alignConstant;
+    if (!ExcelUtil::GetExcelConstant(align, alignConstant))
+        return false;
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("VerticalAlignment"), NULL, alignConstant);
+
+    return SUCCEEDED(hr);    
+}
+
+
+#endif // _WIN32
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class RangeValuesBuilder
+
+/*!
+* @brief Class RangeValuesBuilder is the RangeCodec visitor which fills a two-dimensional vector of strings.
+*/
+class RangeValuesBuilder
+{
+public:
+    RangeValuesBuilder(std::vector<std::vector<ELstring> > &values): m_values(values)
+    {
+    }
+
+    bool Begin(int rows, int columns)
+    {
+        // initialize the two-dimensional array
+        std::vector<std::vector<ELstring> >(rows, std::vector<ELstring>(columns, ELstring())).swap(m_values);
+        return true;
+    }
+
+    bool Value(int row, int column, const ELchar *value, size_t length)
+    {
+        m_values[row][column].assign(value, length);
+        return true;
+    }
+
+private:
+    RangeValuesBuilder& operator = (const RangeValuesBuilder &);
+
+private:
+    std::vector<std::vector<ELstring> > &m_values;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class ExcelRange implementation
+
+#ifdef _WIN32
+
+ExcelRange::ExcelRange(IDispatch *pRange, ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo): 
+    HandleBase(new ComRangeImpl(pRange, columnFrom, columnTo, rowFrom, rowTo))
+{
+    assert(pRange);
+}
+
+#endif // _WIN32
+
+
+bool ExcelRange::ReadData(ELstring &data)
+{
+    return Body().ReadData(data);
+}
+
+
+bool ExcelRange::ReadData(std::vector<std::vector<ELstring> > &values)
+{
+    ELstring tmp;
+    if (!ReadData(tmp))
+        return false;
+
+    return DecodeData(tmp, values);
+}
+
+
+bool ExcelRange::ReadData(ExcelRangeView &view)
+{
+    ELstring tmp;
+    if (!ReadData(tmp))
+        return false;
+
+    return ExcelRangeView::Decode(tmp, view);
+}
+
+
+bool ExcelRange::WriteData(const ELchar *data)
+{
+    return Body().WriteData(data);
+}
+
+
+bool ExcelRange::WriteData(const ELstring &data)
+{
+    return WriteData(data.c_str());
+}
+
+
+bool ExcelRange::WriteData(const std::vector<std::vector<ELstring> > &values)
+{
+    ELstring tmp = EncodeData(values);
+    return WriteData(tmp);
+}
+
+
+bool ExcelRange::WriteDataIfChanged(const ELchar *data)
+{
+    return Body().WriteDataIfChanged(data);
+}
+
+
+bool ExcelRange::WriteDataIfChanged(const ELstring &data)
+{
+    return WriteDataIfChanged(data.c_str());
+}
+
+
+bool ExcelRange::WriteDataIfChanged(const std::vector<std::vector<ELstring> > &values)
+{
+    ELstring tmp = EncodeData(values);
+    return WriteDataIfChanged(tmp);
+}
+
+
+bool ExcelRange::ReadTyped(std::vector<unsigned char> &data)
+{
+    return Body().ReadTyped(data);
+}
+
+
+bool ExcelRange::WriteTyped(const std::vector<unsigned char> &data)
+{
+    return Body().WriteTyped(data);
+}
+
+
+bool ExcelRange::ReadValues(std::vector<ExcelValue> &values)
+{
+    return Body().ReadValues(values);
+}
+
+
+bool ExcelRange::WriteValues(const std::vector<ExcelValue> &values)
+{
+    return Body().WriteValues(values);
+}
+
+
+bool ExcelRange::ReadColumns(std::vector<ExcelColumn> &columns)
+{
+    return Body().ReadColumns(columns);
+}
+
+
+bool ExcelRange::GetValue(ExcelValue &value)
+{
+    return Body().GetValue(value);
+}
+
+
+bool ExcelRange::SetValue(const ExcelValue &value)
+{
+    return Body().SetValue(value);
+}
+
+
+bool ExcelRange::DecodeData(const ELstring &data, std::vector<std::vector<ELstring> > &values)
+{
+    RangeValuesBuilder builder(values);
+    return RangeCodec::Decode(data.c_str(), data.length(), builder);
+}
+
+
+ELstring ExcelRange::EncodeData(const std::vector<std::vector<ELstring> > &values)
+{
+    ELstring encoded;
+
+    int rowNum = values.size();
+    if (rowNum == 0)
+        return ELstring(ELtext("0#"));
+
+    int columnNum = values[0].size();
+
+    // Encoding format: <row>#<column>#
+    RangeCodec::AppendNumber(encoded, rowNum);
+    RangeCodec::AppendNumber(encoded, columnNum);
+
+    for (int i = 0; i < rowNum; ++i)
+    {
+        for (int j = 0; j < columnNum; ++j)
+        {
+            // Encoding format: <number of characters>#<characters>
+            RangeCodec::AppendValue(encoded, values[i][j].c_str(), values[i][j].length());
+        }
+    }
+
+    return encoded;
+}
+
+
+bool ExcelRange::Merge(bool multiRow /* = false */)
+{
+    return Body().Merge(multiRow);
+}
+
+
+ExcelFont ExcelRange::GetFont()
+{
+    return Body().GetFont();
+}
+
+
+bool ExcelRange::GetFontSpec(ExcelFontSpec &spec)
+{
+    return Body().GetFontSpec(spec);
+}
+
+
+bool ExcelRange::ApplyFontSpec(const ExcelFontSpec &spec)
+{
+    return Body().ApplyFontSpec(spec);
+}
+
+
+bool ExcelRange::SetHorizontalAlignment(ExcelHorizontalAlignment align)
+{
+    return Body().SetHorizontalAlignment(align);
+}
+
+
+bool ExcelRange::SetVerticalAlignment(ExcelVerticalAlignment align)
+{
+    return Body().SetVerticalAlignment(align);
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelRange::ExcelRange(ExcelRangeImpl *impl): HandleBase(impl)
+{
+}
+
+
+ExcelRangeImpl& ExcelRange::Body() const
+{
+    return dynamic_cast<ExcelRangeImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
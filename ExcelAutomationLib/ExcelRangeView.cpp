@@ -0,0 +1,166 @@
+﻿/*!
+* @file    ExcelRangeView.cpp
+* @brief   Implementation file for class ExcelRangeView
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <vector>
+
+#include "ExcelRangeView.h"
+#include "Noncopyable.h"
+#include "RangeCodec.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ExcelRangeViewImpl
+
+/*!
+* @brief Class ExcelRangeViewImpl inplements ExcelRangeView's interfaces.
+* @note ExcelRangeViewImpl is also the RangeCodec visitor which builds the offset index.
+*/
+class ExcelRangeViewImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class ExcelRangeView can access members of ExcelRangeViewImpl.
+    friend class ExcelRangeView;
+    friend class RangeCodec;
+
+private:
+    ExcelRangeViewImpl(): m_rows(0), m_columns(0), m_base(0), m_end(0)
+    {
+    }
+
+    virtual ~ExcelRangeViewImpl()
+    {
+    }
+
+    int CountRows() const
+    {
+        return m_rows;
+    }
+
+    int CountColumns() const
+    {
+        return m_columns;
+    }
+
+    ExcelStringRef GetValue(int row, int column) const
+    {
+        assert(row >= 0 && row < m_rows);
+        assert(column >= 0 && column < m_columns);
+
+        // the length prefix was checked by Decode()
+        const ELchar *pos = m_data.c_str() + m_index[static_cast<size_t>(row) * m_columns + column];
+        int length = 0;
+        RangeCodec::ParseNumber(pos, m_data.c_str() + m_data.length(), length);
+
+        return ExcelStringRef(pos, length);
+    }
+
+    bool Decode(ELstring &data);
+
+    // RangeCodec visitor
+    bool Begin(int rows, int columns)
+    {
+        m_rows = rows;
+        m_columns = columns;
+        m_index.reserve(static_cast<size_t>(rows) * columns);
+        return true;
+    }
+
+    bool Value(int /* row */, int /* column */, const ELchar *value, size_t length)
+    {
+        // The length prefix of a value starts where the previous value ends. The first one follows the
+        // '#' which ends the header, so it is found by going back over its digits.
+        const ELchar *prefix = m_end;
+        if (m_index.empty())
+        {
+            for (prefix = value - 1; prefix[-1] >= ELtext('0') && prefix[-1] <= ELtext('9'); --prefix)
+                ;
+        }
+
+        // values are reported in row-major order, so the index is simply appended
+        m_index.push_back(prefix - m_base);
+        m_end = value + length;
+        return true;
+    }
+
+private:
+    ELstring             m_data;     // the encoded string
+    int                  m_rows;
+    int                  m_columns;
+    std::vector<size_t>  m_index;    // offset of the length prefix of every value, in row-major order
+    const ELchar        *m_base;     // start of the buffer being decoded
+    const ELchar        *m_end;      // end of the last value decoded
+};
+
+
+bool ExcelRangeViewImpl::Decode(ELstring &data)
+{
+    m_base = data.c_str();
+    if (!RangeCodec::Decode(m_base, data.length(), *this))
+        return false;
+
+    // offsets are relative, so they stay valid after the buffer is moved
+    m_data.swap(data);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelRangeView
+
+int ExcelRangeView::CountRows() const
+{
+    return IsNull() ? 0 : Body().CountRows();
+}
+
+
+int ExcelRangeView::CountColumns() const
+{
+    return IsNull() ? 0 : Body().CountColumns();
+}
+
+
+ExcelStringRef ExcelRangeView::GetValue(int row, int column) const
+{
+    return Body().GetValue(row, column);
+}
+
+
+bool ExcelRangeView::Decode(ELstring &data, ExcelRangeView &view)
+{
+    ExcelRangeViewImpl *impl = new ExcelRangeViewImpl();
+    ExcelRangeView tmp(impl);   // owns impl from now on
+
+    if (!impl->Decode(data))
+        return false;
+
+    view = tmp;
+    return true;
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelRangeView::ExcelRangeView(ExcelRangeViewImpl *impl): HandleBase(impl)
+{
+}
+
+
+ExcelRangeViewImpl& ExcelRangeView::Body() const
+{
+    return dynamic_cast<ExcelRangeViewImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
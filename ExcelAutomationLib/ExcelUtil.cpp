@@ -1,98 +1,172 @@
-﻿/*!
-* @file    ExcelUtil.cpp
-* @brief   Implementation file for class ExcelUtil
-* @date    2010-09-07 15:01:24
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include "ExcelUtil.h"
-
-
-using namespace std;
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-
-bool ExcelUtil::GetExcelConstant(ExcelHorizontalAlignment align, int &alignConstant)
-{
-    // Values of constants
-    const int xlLeft = -4131;
-    const int xlCenter = -4108;
-    const int xlRight = -4152;
-
-    switch (align)
-    {
-    case EHA_Left:
-        alignConstant = xlLeft;
-        break;
-
-    case EHA_HCenter:
-        alignConstant = xlCenter;
-        break;
-
-    case EHA_Right:
-        alignConstant = xlRight;
-        break;
-
-    default:
-        return false; // Unknow type
-    }
-
-    return true;
-}
-
-
-bool ExcelUtil::GetExcelConstant(ExcelVerticalAlignment align, int &alignConstant)
-{
-    // Values of constants
-    const int xlTop = -4160;
-    const int xlCenter = -4108;
-    const int xlBottom = -4107;
-
-    switch (align)
-    {
-    case EVA_Top:
-        alignConstant = xlTop;
-        break;
-
-    case EVA_VCenter:
-        alignConstant = xlCenter;
-        break;
-
-    case EVA_Bottom:
-        alignConstant = xlBottom;
-        break;
-
-    default:
-        return false; // Unknow type
-    }
-
-    return true;
-}
-
-
-int ExcelUtil::GuessFileFormatFromFilename(const ELstring &filename)
-{
-    int formatCode = 56;  // xlExcel8 (97-2003 format in Excel 2007-2010, xls), by default
-
-    size_t lastDotPos = filename.find_last_of(ELtext('.'));
-
-    if (lastDotPos != string::npos && lastDotPos + 1 < filename.length())
-    {
-        ELstring ext = filename.substr(lastDotPos + 1);
-        if (ext == ELtext("xlsx"))
-            formatCode = 51;  // xlOpenXMLWorkbook
-    }
-
-    return formatCode;
-}
-
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
+﻿/*!
+* @file    ExcelUtil.cpp
+* @brief   Implementation file for class ExcelUtil
+* @date    2010-09-07 15:01:24
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include <cmath>
+#include "ExcelUtil.h"
+
+
+using namespace std;
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+
+bool ExcelUtil::GetExcelConstant(ExcelHorizontalAlignment align, int &alignConstant)
+{
+    // Values of constants
+    const int xlLeft = -4131;
+    const int xlCenter = -4108;
+    const int xlRight = -4152;
+
+    switch (align)
+    {
+    case EHA_Left:
+        alignConstant = xlLeft;
+        break;
+
+    case EHA_HCenter:
+        alignConstant = xlCenter;
+        break;
+
+    case EHA_Right:
+        alignConstant = xlRight;
+        break;
+
+    default:
+        return false; // Unknow type
+    }
+
+    return true;
+}
+
+
+bool ExcelUtil::GetExcelConstant(ExcelVerticalAlignment align, int &alignConstant)
+{
+    // Values of constants
+    const int xlTop = -4160;
+    const int xlCenter = -4108;
+    const int xlBottom = -4107;
+
+    switch (align)
+    {
+    case EVA_Top:
+        alignConstant = xlTop;
+        break;
+
+    case EVA_VCenter:
+        alignConstant = xlCenter;
+        break;
+
+    case EVA_Bottom:
+        alignConstant = xlBottom;
+        break;
+
+    default:
+        return false; // Unknow type
+    }
+
+    return true;
+}
+
+
+int ExcelUtil::GuessFileFormatFromFilename(const ELstring &filename)
+{
+    int formatCode = 56;  // xlExcel8 (97-2003 format in Excel 2007-2010, xls), by default
+
+    size_t lastDotPos = filename.find_last_of(ELtext('.'));
+
+    if (lastDotPos != string::npos && lastDotPos + 1 < filename.length())
+    {
+        ELstring ext = filename.substr(lastDotPos + 1);
+        if (ext == ELtext("xlsx"))
+            formatCode = 51;  // xlOpenXMLWorkbook
+        else if (ext == ELtext("xlsb"))
+            formatCode = 50;  // xlExcel12 (Excel 2007-2010 binary workbook, xlsb)
+    }
+
+    return formatCode;
+}
+
+
+bool ExcelUtil::PrepareColumns(std::vector<ExcelColumn> &columns, size_t count, size_t rows)
+{
+    if (columns.size() != count)
+        return false;
+
+    for (size_t i = 0; i < count; ++i)
+        columns[i].Reset(rows);
+
+    return true;
+}
+
+
+void ExcelUtil::SetColumnNumber(ExcelColumn &column, size_t row, double number)
+{
+    switch (column.type)
+    {
+    case ECT_Double:
+        column.doubles[row] = number;
+        column.valid[row] = true;
+        break;
+
+    case ECT_Int64:
+        // only an integer which fits: [-2^63, 2^63)
+        if (number == floor(number) && number >= -9223372036854775808.0 && number < 9223372036854775808.0)
+        {
+            column.integers[row] = static_cast<long long>(number);
+            column.valid[row] = true;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void ExcelUtil::AppendColumnName(ELstring &text, int column)
+{
+    ELchar buffer[8];
+    ELchar *end = buffer + sizeof(buffer) / sizeof(buffer[0]);
+    ELchar *p = end;
+
+    for (; column > 0 && p != buffer; column = (column - 1) / 26)
+        *--p = static_cast<ELchar>(ELtext('A') + (column - 1) % 26);
+
+    text.append(p, end);
+}
+
+
+void ExcelUtil::AppendRangeAddress(ELstring &text, int columnFrom, int rowFrom, int columnTo, int rowTo)
+{
+    AppendColumnName(text, columnFrom);
+    AppendRowNumber(text, rowFrom);
+    text += ELtext(':');
+    AppendColumnName(text, columnTo);
+    AppendRowNumber(text, rowTo);
+}
+
+
+void ExcelUtil::AppendRowNumber(ELstring &text, int row)
+{
+    ELchar buffer[16];
+    ELchar *end = buffer + sizeof(buffer) / sizeof(buffer[0]);
+    ELchar *p = end;
+
+    for (unsigned int n = static_cast<unsigned int>(row); p == end || n > 0; n /= 10)
+        *--p = static_cast<ELchar>(ELtext('0') + n % 10);
+
+    text.append(p, end);
+}
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -1,39 +1,57 @@
-﻿/*!
-* @file    ExcelUtil.h
-* @brief   Header file for class ExcelUtil
-* @date    2010-09-07 15:01:24
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef EXCELUTIL_H_GUID_FBB6D52B_54B3_4DC5_A5B5_E746A3A94DB4
-#define EXCELUTIL_H_GUID_FBB6D52B_54B3_4DC5_A5B5_E746A3A94DB4
-
-
-#include "LibDef.h"
-#include "ExcelCommonTypes.h"
-#include "StringUtil.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-class ExcelUtil
-{
-public:
-    static bool GetExcelConstant(ExcelHorizontalAlignment align, int &alignConstant);
-    static bool GetExcelConstant(ExcelVerticalAlignment align, int &alignConstant);
-
-    //  Guess file format from file name.
-    static int GuessFileFormatFromFilename(const ELstring &filename);
-};
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
-
-
-#endif //EXCELUTIL_H_GUID_FBB6D52B_54B3_4DC5_A5B5_E746A3A94DB4
-
+﻿/*!
+* @file    ExcelUtil.h
+* @brief   Header file for class ExcelUtil
+* @date    2010-09-07 15:01:24
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef EXCELUTIL_H_GUID_FBB6D52B_54B3_4DC5_A5B5_E746A3A94DB4
+#define EXCELUTIL_H_GUID_FBB6D52B_54B3_4DC5_A5B5_E746A3A94DB4
+
+
+#include <vector>
+#include "LibDef.h"
+#include "ExcelCommonTypes.h"
+#include "StringUtil.h"
+#include "ExcelColumns.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+class ExcelUtil
+{
+public:
+    static bool GetExcelConstant(ExcelHorizontalAlignment align, int &alignConstant);
+    static bool GetExcelConstant(ExcelVerticalAlignment align, int &alignConstant);
+
+    //  Guess file format from file name.
+    static int GuessFileFormatFromFilename(const ELstring &filename);
+
+    //  Check that there is one buffer per column of a range for ExcelRange::ReadColumns(), and reset
+    //  them for @e rows rows.
+    static bool PrepareColumns(std::vector<ExcelColumn> &columns, size_t count, size_t rows);
+
+    //  Store a number (also a date or a boolean) into a numeric column; a string column is not changed.
+    static void SetColumnNumber(ExcelColumn &column, size_t row, double number);
+
+    //  Append the name of a column: "A" for 1, "Z" for 26, "AA" for 27, ...
+    static void AppendColumnName(ELstring &text, int column);
+
+    //  Append the address of a range, such as "A1:AB20". Columns and rows start from 1.
+    static void AppendRangeAddress(ELstring &text, int columnFrom, int rowFrom, int columnTo, int rowTo);
+
+private:
+    static void AppendRowNumber(ELstring &text, int row);
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELUTIL_H_GUID_FBB6D52B_54B3_4DC5_A5B5_E746A3A94DB4
+
@@ -0,0 +1,131 @@
+﻿/*!
+* @file    ExcelValue.cpp
+* @brief   Implementation file for class ExcelValue
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include "ExcelValue.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // The value and the type, and nothing else: a string is out of line
+    typedef char ExcelValueSizeCheck[sizeof(ExcelValue) == 16 ? 1 : -1];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelValue
+
+// The strings are allocated and freed here, so that they are on the heap of this library
+
+ExcelValue::ExcelValue(const ELstring &value): m_type(EVT_String)
+{
+    m_data.text = new ELstring(value);
+}
+
+
+ExcelValue::ExcelValue(const ELchar *value): m_type(EVT_String)
+{
+    assert(value);
+    m_data.text = new ELstring(value);
+}
+
+
+ExcelValue::ExcelValue(const ExcelValue &other): m_data(other.m_data), m_type(other.m_type)
+{
+    if (m_type == EVT_String)
+        m_data.text = new ELstring(*other.m_data.text);
+}
+
+
+ExcelValue& ExcelValue::operator = (const ExcelValue &other)
+{
+    if (this != &other)
+    {
+        if (m_type == EVT_String && other.m_type == EVT_String)
+        {
+            // reuse the string
+            *m_data.text = *other.m_data.text;
+        }
+        else
+        {
+            ExcelValue copy(other);
+            Swap(copy);
+        }
+    }
+
+    return *this;
+}
+
+
+ExcelValue::~ExcelValue()
+{
+    Clear();
+}
+
+
+bool ExcelValue::ToDouble(double &number) const
+{
+    switch (m_type)
+    {
+    case EVT_Double:
+    case EVT_Date:
+        number = m_data.number;
+        return true;
+
+    case EVT_Int64:
+        number = static_cast<double>(m_data.integer);
+        return true;
+
+    case EVT_Bool:
+        number = (m_data.boolean ? 1 : 0);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+void ExcelValue::Clear()
+{
+    if (m_type == EVT_String)
+        delete m_data.text;
+
+    m_type = EVT_Empty;
+    m_data.integer = 0;
+}
+
+
+void ExcelValue::SetString(const ELstring &value)
+{
+    SetString(value.data(), value.length());
+}
+
+
+void ExcelValue::SetString(const ELchar *value, size_t length)
+{
+    assert(value || length == 0);
+
+    if (m_type == EVT_String)
+    {
+        m_data.text->assign(value, length);
+        return;
+    }
+
+    ELstring *text = new ELstring(value, length);
+    Clear();
+    m_type = EVT_String;
+    m_data.text = text;
+}
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -1,247 +1,414 @@
-﻿/*!
-* @file    ExcelWorksheet.cpp
-* @brief   Implementation file for class ExcelWorksheet and class ExcelWorksheetImpl
-* @date    2009-12-01
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include <tchar.h>
-#include <cassert>
-
-#include "ExcelWorksheet.h"
-#include "ExcelRange.h"
-#include "ExcelCell.h"
-#include "ComUtil.h"
-#include "Noncopyable.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Definition and implementation of class ExcelWorksheetImpl
-
-/*!
-* @brief Class ExcelWorksheetImpl inplements ExcelWorksheet's interfaces.
-*/
-class ExcelWorksheetImpl : public BodyBase, public Noncopyable
-{
-    // All members are private. Only the friend class ExcelWorksheet can access members of ExcelWorksheetImpl.
-    friend class ExcelWorksheet;
-
-private:
-    ExcelWorksheetImpl(IDispatch *pWorksheet): m_pWorksheet(pWorksheet)
-    {
-        assert(pWorksheet);
-    }
-
-    virtual ~ExcelWorksheetImpl()
-    {
-        if (m_pWorksheet)
-        {
-            m_pWorksheet->Release();
-            m_pWorksheet = 0;
-        }
-    }
-
-    IDispatch* GetIDispatch()
-    {
-        return m_pWorksheet;
-    }
-
-    ELstring   GetName();
-    bool       SetName(const ELstring &name);
-
-    ExcelRange GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
-    ExcelCell  GetCell(ELchar column, int row);
-
-    bool CopyWorksheet(bool after);
-
-private:
-    IDispatch *m_pWorksheet;
-};
-
-
-ELstring ExcelWorksheetImpl::GetName()
-{
-    assert(m_pWorksheet);
-
-    VARIANT result;
-    ::VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pWorksheet, DISPATCH_PROPERTYGET, OLESTR("Name"), &result, 0);
-
-    if (FAILED(hr))
-        return ELstring();
-
-    ELstring name(result.bstrVal);
-
-    ::VariantClear(&result);
-
-    return name;
-}
-
-
-bool ExcelWorksheetImpl::SetName(const ELstring &name)
-{
-    assert(m_pWorksheet);
-
-    VARIANT param;
-    param.vt = VT_BSTR;
-    param.bstrVal = ::SysAllocString(name.c_str());
-
-    HRESULT hr = ComUtil::Invoke(m_pWorksheet, DISPATCH_PROPERTYPUT, OLESTR("Name"), NULL, 1, param);
-
-    ::VariantClear(&param);
-
-    return SUCCEEDED(hr);
-}
-
-
-ExcelRange ExcelWorksheetImpl::GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
-{
-    assert(m_pWorksheet);
-
-    ELchar buf[50];
-    memset(buf, 0, sizeof(buf));
-    _stprintf_s(buf, 50, ELtext("%c%d:%c%d"), columnFrom, rowFrom, columnTo, rowTo);
-
-    VARIANT param;
-    param.vt = VT_BSTR;
-    param.bstrVal = ::SysAllocString(buf);
-
-    VARIANT result;
-    VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pWorksheet, DISPATCH_PROPERTYGET, OLESTR("Range"), &result, 1, param);
-
-    ::VariantClear(&param);
-
-    if (FAILED(hr))
-        return ExcelRange();
-
-    return ExcelRange(result.pdispVal, columnFrom, columnTo, rowFrom, rowTo);
-}
-
-
-ExcelCell ExcelWorksheetImpl::GetCell(ELchar column, int row)
-{
-    assert(m_pWorksheet);
-
-    ELchar buf[50];
-    memset(buf, 0, sizeof(buf));
-    _stprintf_s(buf, 50, ELtext("%c%d"), column, row);
-
-    VARIANT param;
-    param.vt = VT_BSTR;
-    param.bstrVal = ::SysAllocString(buf);
-
-    VARIANT result;
-    VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pWorksheet, DISPATCH_PROPERTYGET, OLESTR("Range"), &result, 1, param);
-
-    ::VariantClear(&param);
-
-    if (FAILED(hr))
-        return ExcelCell();
-
-    return ExcelCell(result.pdispVal, column, row);
-}
-
-
-bool ExcelWorksheetImpl::CopyWorksheet(bool after)
-{
-    assert(m_pWorksheet);
-
-    VARIANT paramOptional;
-    paramOptional.vt = VT_ERROR;
-    paramOptional.scode = DISP_E_PARAMNOTFOUND;
-
-    VARIANT afterParam;
-    afterParam.vt = VT_DISPATCH;
-    afterParam.pdispVal = m_pWorksheet;
-
-    HRESULT hr;
-    
-    if (after)
-        hr = ComUtil::Invoke(m_pWorksheet, DISPATCH_METHOD, OLESTR("Copy"), NULL, 2, paramOptional, afterParam);
-    else
-        hr = ComUtil::Invoke(m_pWorksheet, DISPATCH_METHOD, OLESTR("Copy"), NULL, 2, afterParam, paramOptional);
-
-    return SUCCEEDED(hr);
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Implementation of class ExcelWorksheet
-
-ExcelWorksheet::ExcelWorksheet(IDispatch *pWorksheet): HandleBase(new ExcelWorksheetImpl(pWorksheet))
-{
-    assert(pWorksheet);
-}
-
-
-IDispatch* ExcelWorksheet::GetIDispatch()
-{
-    return Body().GetIDispatch();
-}
-
-
-ELstring ExcelWorksheet::GetName()
-{
-    return Body().GetName();
-}
-
-
-bool ExcelWorksheet::SetName(const ELstring &name)
-{
-    return Body().SetName(name);
-}
-
-
-ExcelRange ExcelWorksheet::GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
-{
-    return Body().GetRange(columnFrom, columnTo, rowFrom, rowTo);
-}
-
-
-ExcelCell ExcelWorksheet::GetCell(ELchar column, int row)
-{
-    return Body().GetCell(column, row);
-}
-
-
-bool ExcelWorksheet::Merge(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo, bool multiRow)
-{
-    ExcelRange range = GetRange(columnFrom, columnTo, rowFrom, rowTo);
-    return !range.IsNull() && range.Merge(multiRow);
-}
-
-
-bool ExcelWorksheet::CopyWorksheet(bool after)
-{
-    return Body().CopyWorksheet(after);
-}
-
-
-// <begin> Handle/Body pattern implementation
-
-ExcelWorksheet::ExcelWorksheet(ExcelWorksheetImpl *impl): HandleBase(impl)
-{ 
-}
-
-
-ExcelWorksheetImpl& ExcelWorksheet::Body() const
-{
-    return dynamic_cast<ExcelWorksheetImpl&>(HandleBase::Body());
-}
-
-// <end> Handle/Body pattern implementation
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
+﻿/*!
+* @file    ExcelWorksheet.cpp
+* @brief   Implementation file for class ExcelWorksheet and class ExcelWorksheetImpl
+* @date    2009-12-01
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include <cassert>
+
+#include "ExcelWorksheet.h"
+#include "ExcelRange.h"
+#include "ExcelCell.h"
+#include "ExcelFont.h"
+#include "ExcelBodies.h"
+#include "ExcelUtil.h"
+#include "RowQueryFilter.h"
+
+#ifdef _WIN32
+#include <tchar.h>
+#include "ComUtil.h"
+#endif
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+#ifdef _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ComWorksheetImpl
+
+/*!
+* @brief Class ComWorksheetImpl inplements ExcelWorksheet's interfaces.
+*/
+class ComWorksheetImpl : public ExcelWorksheetImpl
+{
+    // All members are private. Only the friend class ExcelWorksheet can create ComWorksheetImpl.
+    friend class ExcelWorksheet;
+
+private:
+    ComWorksheetImpl(IDispatch *pWorksheet): m_pWorksheet(pWorksheet)
+    {
+        assert(pWorksheet);
+    }
+
+    virtual ~ComWorksheetImpl()
+    {
+        if (m_pWorksheet)
+        {
+            m_pWorksheet->Release();
+            m_pWorksheet = 0;
+        }
+    }
+
+    virtual IDispatch* GetIDispatch()
+    {
+        return m_pWorksheet;
+    }
+
+    virtual ELstring   GetName();
+    virtual bool       SetName(const ELstring &name);
+
+    virtual ExcelRange GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
+    virtual ExcelCell  GetCell(ELchar column, int row);
+
+    virtual bool CopyWorksheet(bool after);
+
+    virtual bool ApplyFontSpec(const std::vector<ExcelRangeAddress> &ranges, const ExcelFontSpec &spec);
+
+    virtual bool ReadRows(const ExcelRowQuery &query, std::vector<std::vector<ELstring> > &values, 
+        std::vector<int> *rowNumbers);
+
+    // Write the font of the range of an address, which may be a union range
+    bool ApplyFontSpec(const ELstring &address, const ExcelFontSpec &spec);
+
+    // Read the values of the range of an address as ExcelRange::ReadData() does
+    bool ReadData(const ELstring &address, std::vector<std::vector<ELstring> > &values);
+
+private:
+    IDispatch *m_pWorksheet;
+};
+
+
+ELstring ComWorksheetImpl::GetName()
+{
+    assert(m_pWorksheet);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_PROPERTYGET, OLESTR("Name"), &result);
+
+    if (FAILED(hr))
+        return ELstring();
+
+    ELstring name(result.bstrVal);
+
+    ::VariantClear(&result);
+
+    return name;
+}
+
+
+bool ComWorksheetImpl::SetName(const ELstring &name)
+{
+    assert(m_pWorksheet);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_PROPERTYPUT, OLESTR("Name"), NULL, name);
+
+    return SUCCEEDED(hr);
+}
+
+
+ExcelRange ComWorksheetImpl::GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
+{
+    assert(m_pWorksheet);
+
+    ELchar buf[50];
+    memset(buf, 0, sizeof(buf));
+    _stprintf_s(buf, 50, ELtext("%c%d:%c%d"), columnFrom, rowFrom, columnTo, rowTo);
+
+    VARIANT result;
+    VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_PROPERTYGET, OLESTR("Range"), &result, buf);
+
+    if (FAILED(hr))
+        return ExcelRange();
+
+    return ExcelRange(result.pdispVal, columnFrom, columnTo, rowFrom, rowTo);
+}
+
+
+ExcelCell ComWorksheetImpl::GetCell(ELchar column, int row)
+{
+    assert(m_pWorksheet);
+
+    ELchar buf[50];
+    memset(buf, 0, sizeof(buf));
+    _stprintf_s(buf, 50, ELtext("%c%d"), column, row);
+
+    VARIANT result;
+    VariantInit(&result);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_PROPERTYGET, OLESTR("Range"), &result, buf);
+
+    if (FAILED(hr))
+        return ExcelCell();
+
+    return ExcelCell(result.pdispVal, column, row);
+}
+
+
+bool ComWorksheetImpl::CopyWorksheet(bool after)
+{
+    assert(m_pWorksheet);
+
+    IDispatch *afterParam = m_pWorksheet;
+
+    HRESULT hr;
+    
+    if (after)
+        hr = ComUtil::Invoke(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_METHOD, OLESTR("Copy"), NULL, ComArg::Missing(), afterParam);
+    else
+        hr = ComUtil::Invoke(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_METHOD, OLESTR("Copy"), NULL, afterParam, ComArg::Missing());
+
+    return SUCCEEDED(hr);
+}
+
+
+bool ComWorksheetImpl::ApplyFontSpec(const std::vector<ExcelRangeAddress> &ranges, const ExcelFontSpec &spec)
+{
+    // The longest address which Range accepts
+    const size_t maxAddressLength = 255;
+
+    bool succeeded = true;
+    ELstring address;
+
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        const ExcelRangeAddress &range = ranges[i];
+
+        ELstring one;
+        ExcelUtil::AppendRangeAddress(one, range.columnFrom, range.rowFrom, range.columnTo, range.rowTo);
+
+        if (!address.empty() && address.length() + 1 + one.length() > maxAddressLength)
+        {
+            succeeded = ApplyFontSpec(address, spec) && succeeded;
+            address.clear();
+        }
+
+        if (!address.empty())
+            address += ELtext(',');
+        address += one;
+    }
+
+    if (!address.empty())
+        succeeded = ApplyFontSpec(address, spec) && succeeded;
+
+    return succeeded;
+}
+
+
+bool ComWorksheetImpl::ApplyFontSpec(const ELstring &address, const ExcelFontSpec &spec)
+{
+    assert(m_pWorksheet);
+
+    VARIANT range;
+    VariantInit(&range);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_PROPERTYGET, OLESTR("Range"), &range, address);
+
+    if (FAILED(hr))
+        return false;
+
+    VARIANT font;
+    VariantInit(&font);
+
+    hr = ComUtil::InvokeEarlyBound(range.pdispVal, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Font"), &font);
+
+    ::VariantClear(&range);
+
+    if (FAILED(hr))
+        return false;
+
+    // the properties are read once for the union range, which is mixed if some ranges differ
+    return ExcelFont(font.pdispVal).ApplySpec(spec);
+}
+
+
+bool ComWorksheetImpl::ReadRows(const ExcelRowQuery &query, std::vector<std::vector<ELstring> > &values, 
+    std::vector<int> *rowNumbers)
+{
+    assert(m_pWorksheet);
+
+    // number of rows read by one call, so a long query does not hold all its rows as strings at once
+    const int RowsPerRead = 4096;
+
+    values.clear();
+    if (rowNumbers != NULL)
+        rowNumbers->clear();
+
+    // The last row with data is not known
+    RowQueryFilter filter(query);
+    if (!filter.IsValid() || filter.GetRowTo() == 0)
+        return false;
+
+    std::vector<std::vector<ELstring> > block;
+    std::vector<ELstring> selected;
+    ELstring address;
+    for (int rowFrom = filter.GetRowFrom(); rowFrom <= filter.GetRowTo(); rowFrom += RowsPerRead)
+    {
+        int rowTo = (filter.GetRowTo() - rowFrom < RowsPerRead ? filter.GetRowTo() : rowFrom + RowsPerRead - 1);
+
+        address.clear();
+        ExcelUtil::AppendRangeAddress(address, filter.GetFirstColumn(), rowFrom, filter.GetLastColumn(), rowTo);
+        if (!ReadData(address, block))
+            return false;
+
+        for (size_t i = 0; i < block.size(); ++i)
+        {
+            int row = rowFrom + static_cast<int>(i);
+            TextRowValues rowValues(block[i], filter.GetFirstColumn());
+            if (filter.Accept(row, rowValues, selected))
+            {
+                values.push_back(std::vector<ELstring>());
+                values.back().swap(selected);
+                if (rowNumbers != NULL)
+                    rowNumbers->push_back(row);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool ComWorksheetImpl::ReadData(const ELstring &address, std::vector<std::vector<ELstring> > &values)
+{
+    assert(m_pWorksheet);
+
+    VARIANT range;
+    VariantInit(&range);
+
+    HRESULT hr = ComUtil::InvokeEarlyBound(m_pWorksheet, OLESTR("Worksheet"), DISPATCH_PROPERTYGET, OLESTR("Range"), &range, address);
+
+    if (FAILED(hr))
+        return false;
+
+    VARIANT result;
+    VariantInit(&result);
+
+    hr = ComUtil::InvokeEarlyBound(range.pdispVal, OLESTR("Range"), DISPATCH_PROPERTYGET, OLESTR("Value"), &result);
+
+    ::VariantClear(&range);
+
+    if (FAILED(hr))
+        return false;
+
+    ELstring data;
+    bool succeeded;
+
+    if (result.vt & VT_ARRAY)
+    {
+        succeeded = SUCCEEDED(ComUtil::EncodeSafeArrayDim2(result.parray, data)) && ExcelRange::DecodeData(data, values);
+    }
+    else
+    {
+        // the range of a single cell has a single value
+        succeeded = SUCCEEDED(::VariantChangeType(&result, &result, VARIANT_NOUSEROVERRIDE, VT_BSTR));
+        if (succeeded && result.bstrVal != NULL)
+            data = result.bstrVal;
+        if (succeeded)
+            std::vector<std::vector<ELstring> >(1, std::vector<ELstring>(1, data)).swap(values);
+    }
+
+    ::VariantClear(&result);
+
+    return succeeded;
+}
+
+
+#endif // _WIN32
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelWorksheet
+
+#ifdef _WIN32
+
+ExcelWorksheet::ExcelWorksheet(IDispatch *pWorksheet): HandleBase(new ComWorksheetImpl(pWorksheet))
+{
+    assert(pWorksheet);
+}
+
+#endif // _WIN32
+
+
+IDispatch* ExcelWorksheet::GetIDispatch()
+{
+    return Body().GetIDispatch();
+}
+
+
+ELstring ExcelWorksheet::GetName()
+{
+    return Body().GetName();
+}
+
+
+bool ExcelWorksheet::SetName(const ELstring &name)
+{
+    return Body().SetName(name);
+}
+
+
+ExcelRange ExcelWorksheet::GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
+{
+    return Body().GetRange(columnFrom, columnTo, rowFrom, rowTo);
+}
+
+
+ExcelCell ExcelWorksheet::GetCell(ELchar column, int row)
+{
+    return Body().GetCell(column, row);
+}
+
+
+bool ExcelWorksheet::Merge(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo, bool multiRow)
+{
+    ExcelRange range = GetRange(columnFrom, columnTo, rowFrom, rowTo);
+    return !range.IsNull() && range.Merge(multiRow);
+}
+
+
+bool ExcelWorksheet::CopyWorksheet(bool after)
+{
+    return Body().CopyWorksheet(after);
+}
+
+
+bool ExcelWorksheet::ApplyFontSpec(const std::vector<ExcelRangeAddress> &ranges, const ExcelFontSpec &spec)
+{
+    return Body().ApplyFontSpec(ranges, spec);
+}
+
+
+bool ExcelWorksheet::ReadRows(const ExcelRowQuery &query, std::vector<std::vector<ELstring> > &values, 
+    std::vector<int> *rowNumbers /* = NULL */)
+{
+    return Body().ReadRows(query, values, rowNumbers);
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelWorksheet::ExcelWorksheet(ExcelWorksheetImpl *impl): HandleBase(impl)
+{ 
+}
+
+
+ExcelWorksheetImpl& ExcelWorksheet::Body() const
+{
+    return dynamic_cast<ExcelWorksheetImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
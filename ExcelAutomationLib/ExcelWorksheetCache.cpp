@@ -0,0 +1,403 @@
+﻿/*!
+* @file    ExcelWorksheetCache.cpp
+* @brief   Implementation file for class ExcelWorksheetCache
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "ExcelWorksheetCache.h"
+#include "ExcelRange.h"
+#include "ExcelCell.h"
+#include "ExcelValue.h"
+#include "Noncopyable.h"
+#include "CellRectangles.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of struct ExcelWorksheetCacheStats
+
+ExcelWorksheetCacheStats::ExcelWorksheetCacheStats():
+    loads(0), hits(0), misses(0), writes(0), flushes(0), flushedCells(0), flushRoundTrips(0),
+    lastFlushCells(0), lastFlushRoundTrips(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ExcelWorksheetCacheImpl
+
+/*!
+* @brief Class ExcelWorksheetCacheImpl inplements ExcelWorksheetCache's interfaces.
+* @note The values of a loaded region are kept in one block, row by row. A cell read alone or set is kept
+*       in a map, which is looked up first: its value is newer than the one of any region.
+*/
+class ExcelWorksheetCacheImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class ExcelWorksheetCache can access members of ExcelWorksheetCacheImpl.
+    friend class ExcelWorksheetCache;
+
+private:
+    struct CellEntry
+    {
+        CellEntry(): dirty(false) { }
+
+        ExcelValue value;
+        bool       dirty;
+    };
+
+    typedef std::map<CellPos, CellEntry> CellMap;
+
+    struct Region
+    {
+        Region(const CellRect &r): rect(r) { }
+
+        bool Contains(const CellPos &pos) const
+        {
+            return pos.row >= rect.rowFrom && pos.row <= rect.rowTo &&
+                pos.column >= rect.columnFrom && pos.column <= rect.columnTo;
+        }
+
+        const ExcelValue& At(const CellPos &pos) const
+        {
+            return values[(pos.row - rect.rowFrom) * rect.CountColumns() + (pos.column - rect.columnFrom)];
+        }
+
+        CellRect                rect;
+        std::vector<ExcelValue> values;     // row by row
+    };
+
+    // the newest region first
+    typedef std::list<Region> RegionList;
+
+private:
+    explicit ExcelWorksheetCacheImpl(ExcelWorksheet worksheet): m_worksheet(worksheet), m_dirtyCount(0)
+    {
+        assert(!worksheet.IsNull());
+    }
+
+    virtual ~ExcelWorksheetCacheImpl()
+    {
+        Flush();
+    }
+
+    bool Load(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
+
+    bool GetValue(ELchar column, int row, ExcelValue &value);
+
+    void SetValue(ELchar column, int row, const ExcelValue &value)
+    {
+        CellEntry &entry = m_cells[Position(column, row)];
+        if (!entry.dirty)
+        {
+            entry.dirty = true;
+            ++m_dirtyCount;
+        }
+
+        entry.value = value;
+        ++m_stats.writes;
+    }
+
+    size_t CountDirty() const
+    {
+        return m_dirtyCount;
+    }
+
+    bool Flush();
+
+    void Invalidate(const CellRect &rect);
+
+    void Discard();
+
+    ExcelWorksheetCacheStats GetStats() const
+    {
+        return m_stats;
+    }
+
+    static CellPos Position(ELchar column, int row)
+    {
+        assert(row > 0);
+
+        // 'a' and 'A' is the same column, so they must be adjacent to 'B'
+        if (column >= ELtext('a') && column <= ELtext('z'))
+            column = static_cast<ELchar>(column - ELtext('a') + ELtext('A'));
+
+        return CellPos(row, column);
+    }
+
+    bool WriteRect(const CellRect &rect);
+
+private:
+    ExcelWorksheet           m_worksheet;
+    CellMap                  m_cells;
+    RegionList               m_regions;
+    size_t                   m_dirtyCount;
+    ExcelWorksheetCacheStats m_stats;
+};
+
+
+bool ExcelWorksheetCacheImpl::Load(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
+{
+    CellPos from = Position(columnFrom, rowFrom);
+    CellPos to = Position(columnTo, rowTo);
+    if (from.row > to.row || from.column > to.column)
+        return false;
+
+    ExcelRange range = m_worksheet.GetRange(columnFrom, columnTo, rowFrom, rowTo);
+    if (range.IsNull())
+        return false;
+
+    CellRect rect(from.row, to.row, from.column, to.column);
+    std::vector<ExcelValue> values;
+    if (!range.ReadValues(values) || values.size() != static_cast<size_t>(rect.CountRows()) * rect.CountColumns())
+        return false;
+
+    // the older values of the region are dropped, except the dirty ones
+    Invalidate(rect);
+
+    m_regions.push_front(Region(rect));
+    m_regions.front().values.swap(values);
+    ++m_stats.loads;
+
+    return true;
+}
+
+
+bool ExcelWorksheetCacheImpl::GetValue(ELchar column, int row, ExcelValue &value)
+{
+    CellPos pos = Position(column, row);
+
+    CellMap::const_iterator it = m_cells.find(pos);
+    if (it != m_cells.end())
+    {
+        value = it->second.value;
+        ++m_stats.hits;
+        return true;
+    }
+
+    for (RegionList::const_iterator region = m_regions.begin(); region != m_regions.end(); ++region)
+    {
+        if (region->Contains(pos))
+        {
+            value = region->At(pos);
+            ++m_stats.hits;
+            return true;
+        }
+    }
+
+    // not in memory yet
+    ExcelCell cell = m_worksheet.GetCell(column, row);
+    if (cell.IsNull() || !cell.GetValue(value))
+        return false;
+
+    m_cells[pos].value = value;
+    ++m_stats.misses;
+
+    return true;
+}
+
+
+bool ExcelWorksheetCacheImpl::Flush()
+{
+    m_stats.lastFlushCells = 0;
+    m_stats.lastFlushRoundTrips = 0;
+
+    if (m_dirtyCount == 0)
+        return true;
+
+    std::vector<CellPos> cells;
+    cells.reserve(m_dirtyCount);
+    for (CellMap::const_iterator it = m_cells.begin(); it != m_cells.end(); ++it)
+    {
+        if (it->second.dirty)
+            cells.push_back(it->first);
+    }
+
+    std::vector<CellRect> rects;
+    CellRectangles::Build(cells, rects);
+
+    bool succeeded = true;
+    for (size_t i = 0; i < rects.size(); ++i)
+    {
+        if (!WriteRect(rects[i]))
+            succeeded = false;
+    }
+
+    ++m_stats.flushes;
+    m_stats.flushRoundTrips += m_stats.lastFlushRoundTrips;
+    m_stats.flushedCells += m_stats.lastFlushCells;
+
+    return succeeded;
+}
+
+
+bool ExcelWorksheetCacheImpl::WriteRect(const CellRect &rect)
+{
+    std::vector<ExcelValue> values(static_cast<size_t>(rect.CountRows()) * rect.CountColumns());
+    std::vector<CellEntry*> entries(values.size());
+
+    for (int row = rect.rowFrom; row <= rect.rowTo; ++row)
+    {
+        // cells of a row are adjacent in the map
+        CellMap::iterator it = m_cells.find(CellPos(row, rect.columnFrom));
+
+        for (int column = rect.columnFrom; column <= rect.columnTo; ++column, ++it)
+        {
+            assert(it != m_cells.end() && it->first.row == row && it->first.column == column && it->second.dirty);
+
+            size_t index = static_cast<size_t>(row - rect.rowFrom) * rect.CountColumns() + (column - rect.columnFrom);
+            values[index] = it->second.value;
+            entries[index] = &it->second;
+        }
+    }
+
+    ExcelRange range = m_worksheet.GetRange(static_cast<ELchar>(rect.columnFrom), static_cast<ELchar>(rect.columnTo),
+        rect.rowFrom, rect.rowTo);
+
+    ++m_stats.lastFlushRoundTrips;
+    if (range.IsNull() || !range.WriteValues(values))
+        return false;   // the cells stay dirty
+
+    for (size_t i = 0; i < entries.size(); ++i)
+        entries[i]->dirty = false;
+
+    m_dirtyCount -= entries.size();
+    m_stats.lastFlushCells += static_cast<unsigned long>(entries.size());
+
+    return true;
+}
+
+
+void ExcelWorksheetCacheImpl::Invalidate(const CellRect &rect)
+{
+    for (RegionList::iterator region = m_regions.begin(); region != m_regions.end(); )
+    {
+        const CellRect &r = region->rect;
+        if (r.rowFrom <= rect.rowTo && rect.rowFrom <= r.rowTo && r.columnFrom <= rect.columnTo && rect.columnFrom <= r.columnTo)
+            region = m_regions.erase(region);
+        else
+            ++region;
+    }
+
+    CellMap::iterator it = m_cells.lower_bound(CellPos(rect.rowFrom, rect.columnFrom));
+    while (it != m_cells.end() && it->first.row <= rect.rowTo)
+    {
+        if (!it->second.dirty && it->first.column >= rect.columnFrom && it->first.column <= rect.columnTo)
+            m_cells.erase(it++);
+        else
+            ++it;
+    }
+}
+
+
+void ExcelWorksheetCacheImpl::Discard()
+{
+    for (CellMap::iterator it = m_cells.begin(); it != m_cells.end(); )
+    {
+        // the value in memory is not the one of the worksheet
+        if (it->second.dirty)
+            m_cells.erase(it++);
+        else
+            ++it;
+    }
+
+    m_dirtyCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelWorksheetCache
+
+ExcelWorksheetCache::ExcelWorksheetCache(ExcelWorksheet worksheet): HandleBase(new ExcelWorksheetCacheImpl(worksheet))
+{
+}
+
+
+bool ExcelWorksheetCache::Load(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
+{
+    return Body().Load(columnFrom, columnTo, rowFrom, rowTo);
+}
+
+
+bool ExcelWorksheetCache::GetValue(ELchar column, int row, ExcelValue &value)
+{
+    return Body().GetValue(column, row, value);
+}
+
+
+void ExcelWorksheetCache::SetValue(ELchar column, int row, const ExcelValue &value)
+{
+    Body().SetValue(column, row, value);
+}
+
+
+size_t ExcelWorksheetCache::CountDirty() const
+{
+    return Body().CountDirty();
+}
+
+
+bool ExcelWorksheetCache::Flush()
+{
+    return Body().Flush();
+}
+
+
+bool ExcelWorksheetCache::Save(const ExcelWorkbook &workbook)
+{
+    return Body().Flush() && workbook.Save();
+}
+
+
+void ExcelWorksheetCache::Invalidate()
+{
+    // covers every cell
+    Body().Invalidate(CellRect(1, 0x7FFFFFFF, 0, 0x7FFFFFFF));
+}
+
+
+void ExcelWorksheetCache::Invalidate(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
+{
+    Body().Invalidate(CellRect(rowFrom, rowTo, ExcelWorksheetCacheImpl::Position(columnFrom, rowFrom).column,
+        ExcelWorksheetCacheImpl::Position(columnTo, rowTo).column));
+}
+
+
+void ExcelWorksheetCache::Discard()
+{
+    Body().Discard();
+}
+
+
+ExcelWorksheetCacheStats ExcelWorksheetCache::GetStats() const
+{
+    return Body().GetStats();
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelWorksheetCache::ExcelWorksheetCache(ExcelWorksheetCacheImpl *impl): HandleBase(impl)
+{
+}
+
+
+ExcelWorksheetCacheImpl& ExcelWorksheetCache::Body() const
+{
+    return dynamic_cast<ExcelWorksheetCacheImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -1,168 +1,170 @@
-﻿/*!
-* @file    ExcelWorksheetSet.cpp
-* @brief   Implementation file for class ExcelWorksheetSet
-* @date    2009-12-13
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#include <tchar.h>
-#include <cassert>
-
-#include "ExcelWorksheetSet.h"
-#include "ExcelWorksheet.h"
-#include "ComUtil.h"
-#include "Noncopyable.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Definition and implementation of class ExcelWorksheetSetImpl
-
-/*!
-* @brief Class ExcelWorksheetSetImpl inplements ExcelWorksheetSet's interfaces.
-*/
-class ExcelWorksheetSetImpl : public BodyBase, public Noncopyable
-{
-    // All members are private. Only the friend class ExcelWorksheetSet can access members of ExcelWorksheetSetImpl.
-    friend class ExcelWorksheetSet;
-
-private:
-    ExcelWorksheetSetImpl(IDispatch *pWorksheetSet): m_pWorksheetSet(pWorksheetSet)
-    {
-        assert(pWorksheetSet);
-    }
-
-    virtual ~ExcelWorksheetSetImpl()
-    {
-        if (m_pWorksheetSet)
-        {
-            m_pWorksheetSet->Release();
-            m_pWorksheetSet = 0;
-        }
-    }
-
-    int CountWorksheets();
-
-    ExcelWorksheet GetWorksheet(int index);
-
-    ExcelWorksheet AddWorksheet(ExcelWorksheet ref, bool after);
-
-private:
-    IDispatch *m_pWorksheetSet;
-};
-
-
-int ExcelWorksheetSetImpl::CountWorksheets()
-{
-    assert(m_pWorksheetSet);
-
-    VARIANT result;
-    VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pWorksheetSet, DISPATCH_PROPERTYGET, OLESTR("Count"), &result, 0);
-
-    if (FAILED(hr))
-        return -1;
-
-    return (int)result.lVal;
-}
-
-
-ExcelWorksheet ExcelWorksheetSetImpl::GetWorksheet(int index)
-{
-    assert(m_pWorksheetSet);
-
-    VARIANT param;
-    param.vt = VT_INT;
-    param.intVal = index;
-
-    VARIANT result;
-    VariantInit(&result);
-
-    HRESULT hr = ComUtil::Invoke(m_pWorksheetSet, DISPATCH_PROPERTYGET, OLESTR("Item"), &result, 1, param);
-
-    if (FAILED(hr))
-        return ExcelWorksheet();
-
-    return ExcelWorksheet(result.pdispVal);
-}
-
-
-ExcelWorksheet ExcelWorksheetSetImpl::AddWorksheet(ExcelWorksheet ref, bool after)
-{
-    assert(m_pWorksheetSet);
-
-    VARIANT paramOptional;
-    paramOptional.vt = VT_ERROR;
-    paramOptional.scode = DISP_E_PARAMNOTFOUND;
-
-    VARIANT refParam;
-    refParam.vt = VT_DISPATCH;
-    refParam.pdispVal = ref.GetIDispatch();
-
-    VARIANT result;
-    VariantInit(&result);
-
-    HRESULT hr;
-    
-    if (after)
-        hr = ComUtil::Invoke(m_pWorksheetSet, DISPATCH_METHOD, OLESTR("Add"), &result, 2, paramOptional, refParam);
-    else
-        hr = ComUtil::Invoke(m_pWorksheetSet, DISPATCH_METHOD, OLESTR("Add"), &result, 2, refParam, paramOptional);
-
-    if (FAILED(hr))
-        return ExcelWorksheet();
-
-    return ExcelWorksheet(result.pdispVal);
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Implementation of class ExcelWorksheetSet
-
-ExcelWorksheetSet::ExcelWorksheetSet(IDispatch *pWorksheetSet): HandleBase(new ExcelWorksheetSetImpl(pWorksheetSet))
-{
-    assert(pWorksheetSet);
-}
-
-
-int ExcelWorksheetSet::CountWorksheets()
-{
-    return Body().CountWorksheets();
-}
-
-
-ExcelWorksheet ExcelWorksheetSet::GetWorksheet(int index)
-{
-    return Body().GetWorksheet(index);
-}
-
-
-ExcelWorksheet ExcelWorksheetSet::AddWorksheet(ExcelAutomation::ExcelWorksheet ref, bool after)
-{
-    return Body().AddWorksheet(ref, after);
-}
-
-
-// <begin> Handle/Body pattern implementation
-
-ExcelWorksheetSet::ExcelWorksheetSet(ExcelWorksheetSetImpl *impl): HandleBase(impl)
-{ 
-}
-
-
-ExcelWorksheetSetImpl& ExcelWorksheetSet::Body() const
-{
-    return dynamic_cast<ExcelWorksheetSetImpl&>(HandleBase::Body());
-}
-
-// <end> Handle/Body pattern implementation
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
+﻿/*!
+* @file    ExcelWorksheetSet.cpp
+* @brief   Implementation file for class ExcelWorksheetSet
+* @date    2009-12-13
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#include <cassert>
+
+#include "ExcelWorksheetSet.h"
+#include "ExcelWorksheet.h"
+#include "ExcelBodies.h"
+
+#ifdef _WIN32
+#include <tchar.h>
+#include "ComUtil.h"
+#endif
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+#ifdef _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ComWorksheetSetImpl
+
+/*!
+* @brief Class ComWorksheetSetImpl inplements ExcelWorksheetSet's interfaces.
+*/
+class ComWorksheetSetImpl : public ExcelWorksheetSetImpl
+{
+    // All members are private. Only the friend class ExcelWorksheetSet can create ComWorksheetSetImpl.
+    friend class ExcelWorksheetSet;
+
+private:
+    ComWorksheetSetImpl(IDispatch *pWorksheetSet): m_pWorksheetSet(pWorksheetSet)
+    {
+        assert(pWorksheetSet);
+    }
+
+    virtual ~ComWorksheetSetImpl()
+    {
+        if (m_pWorksheetSet)
+        {
+            m_pWorksheetSet->Release();
+            m_pWorksheetSet = 0;
+        }
+    }
+
+    virtual int CountWorksheets();
+
+    virtual ExcelWorksheet GetWorksheet(int index);
+
+    virtual ExcelWorksheet AddWorksheet(ExcelWorksheet ref, bool after);
+
+private:
+    IDispatch *m_pWorksheetSet;
+};
+
+
+int ComWorksheetSetImpl::CountWorksheets()
+{
+    assert(m_pWorksheetSet);
+
+    VARIANT result;
+    VariantInit(&result);
+
+    HRESULT hr = ComUtil::Invoke(m_pWorksheetSet, OLESTR("Sheets"), DISPATCH_PROPERTYGET, OLESTR("Count"), &result);
+
+    if (FAILED(hr))
+        return -1;
+
+    return (int)result.lVal;
+}
+
+
+ExcelWorksheet ComWorksheetSetImpl::GetWorksheet(int index)
+{
+    assert(m_pWorksheetSet);
+
+    VARIANT result;
+    VariantInit(&result);
+
+    HRESULT hr = ComUtil::Invoke(m_pWorksheetSet, OLESTR("Sheets"), DISPATCH_PROPERTYGET, OLESTR("Item"), &result, index);
+
+    if (FAILED(hr))
+        return ExcelWorksheet();
+
+    return ExcelWorksheet(result.pdispVal);
+}
+
+
+ExcelWorksheet ComWorksheetSetImpl::AddWorksheet(ExcelWorksheet ref, bool after)
+{
+    assert(m_pWorksheetSet);
+
+    IDispatch *refParam = ref.GetIDispatch();
+
+    VARIANT result;
+    VariantInit(&result);
+
+    HRESULT hr;
+    
+    if (after)
+        hr = ComUtil::Invoke(m_pWorksheetSet, OLESTR("Sheets"), DISPATCH_METHOD, OLESTR("Add"), &result, ComArg::Missing(), refParam);
+    else
+        hr = ComUtil::Invoke(m_pWorksheetSet, OLESTR("Sheets"), DISPATCH_METHOD, OLESTR("Add"), &result, refParam, ComArg::Missing());
+
+    if (FAILED(hr))
+        return ExcelWorksheet();
+
+    return ExcelWorksheet(result.pdispVal);
+}
+
+
+#endif // _WIN32
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelWorksheetSet
+
+#ifdef _WIN32
+
+ExcelWorksheetSet::ExcelWorksheetSet(IDispatch *pWorksheetSet): HandleBase(new ComWorksheetSetImpl(pWorksheetSet))
+{
+    assert(pWorksheetSet);
+}
+
+#endif // _WIN32
+
+
+int ExcelWorksheetSet::CountWorksheets()
+{
+    return Body().CountWorksheets();
+}
+
+
+ExcelWorksheet ExcelWorksheetSet::GetWorksheet(int index)
+{
+    return Body().GetWorksheet(index);
+}
+
+
+ExcelWorksheet ExcelWorksheetSet::AddWorksheet(ExcelAutomation::ExcelWorksheet ref, bool after)
+{
+    return Body().AddWorksheet(ref, after);
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelWorksheetSet::ExcelWorksheetSet(ExcelWorksheetSetImpl *impl): HandleBase(impl)
+{ 
+}
+
+
+ExcelWorksheetSetImpl& ExcelWorksheetSet::Body() const
+{
+    return dynamic_cast<ExcelWorksheetSetImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
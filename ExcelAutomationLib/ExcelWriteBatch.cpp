@@ -0,0 +1,217 @@
+﻿/*!
+* @file    ExcelWriteBatch.cpp
+* @brief   Implementation file for class ExcelWriteBatch
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <map>
+#include <vector>
+
+#include "ExcelWriteBatch.h"
+#include "ExcelRange.h"
+#include "ExcelValue.h"
+#include "Noncopyable.h"
+#include "CellRectangles.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class ExcelWriteBatchImpl
+
+/*!
+* @brief Class ExcelWriteBatchImpl inplements ExcelWriteBatch's interfaces.
+*/
+class ExcelWriteBatchImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class ExcelWriteBatch can access members of ExcelWriteBatchImpl.
+    friend class ExcelWriteBatch;
+
+private:
+    typedef std::map<CellPos, ExcelValue> CellMap;
+
+private:
+    ExcelWriteBatchImpl(ExcelWorksheet worksheet, size_t flushThreshold):
+        m_worksheet(worksheet), m_flushThreshold(flushThreshold)
+    {
+        assert(!worksheet.IsNull());
+    }
+
+    virtual ~ExcelWriteBatchImpl()
+    {
+        Commit();
+    }
+
+    bool SetValue(ELchar column, int row, const ELstring &value)
+    {
+        Record(column, row).SetString(value);
+        return FlushIfFull();
+    }
+
+    bool SetValue(ELchar column, int row, int value)
+    {
+        Record(column, row).SetInt64(value);
+        return FlushIfFull();
+    }
+
+    bool SetValue(ELchar column, int row, double value)
+    {
+        Record(column, row).SetDouble(value);
+        return FlushIfFull();
+    }
+
+    size_t CountPending() const
+    {
+        return m_cells.size();
+    }
+
+    bool Commit();
+
+    void Discard()
+    {
+        m_cells.clear();
+    }
+
+    ExcelValue& Record(ELchar column, int row)
+    {
+        assert(row > 0);
+
+        // 'a' and 'A' is the same column, so they must be adjacent to 'B'
+        if (column >= ELtext('a') && column <= ELtext('z'))
+            column = static_cast<ELchar>(column - ELtext('a') + ELtext('A'));
+
+        return m_cells[CellPos(row, column)];
+    }
+
+    bool FlushIfFull()
+    {
+        return m_cells.size() < m_flushThreshold || Commit();
+    }
+
+    bool WriteRect(const CellRect &rect);
+
+private:
+    ExcelWorksheet m_worksheet;
+    size_t         m_flushThreshold;
+    CellMap        m_cells;          // pending cells, in row-major order
+};
+
+
+bool ExcelWriteBatchImpl::Commit()
+{
+    if (m_cells.empty())
+        return true;
+
+    std::vector<CellPos> cells;
+    cells.reserve(m_cells.size());
+    for (CellMap::const_iterator it = m_cells.begin(); it != m_cells.end(); ++it)
+        cells.push_back(it->first);
+
+    std::vector<CellRect> rects;
+    CellRectangles::Build(cells, rects);
+
+    bool succeeded = true;
+    for (size_t i = 0; i < rects.size(); ++i)
+    {
+        if (!WriteRect(rects[i]))
+            succeeded = false;
+    }
+
+    m_cells.clear();
+
+    return succeeded;
+}
+
+
+bool ExcelWriteBatchImpl::WriteRect(const CellRect &rect)
+{
+    std::vector<ExcelValue> values;
+    values.reserve(static_cast<size_t>(rect.CountRows()) * rect.CountColumns());
+
+    for (int row = rect.rowFrom; row <= rect.rowTo; ++row)
+    {
+        // cells of a row are adjacent in the map
+        CellMap::const_iterator it = m_cells.find(CellPos(row, rect.columnFrom));
+
+        for (int column = rect.columnFrom; column <= rect.columnTo; ++column, ++it)
+        {
+            assert(it != m_cells.end() && it->first.row == row && it->first.column == column);
+            values.push_back(it->second);
+        }
+    }
+
+    // Through the handles, so that a worksheet which is not in Excel (read by ExcelFileReader) fails cleanly
+    ExcelRange range = m_worksheet.GetRange(static_cast<ELchar>(rect.columnFrom), static_cast<ELchar>(rect.columnTo),
+        rect.rowFrom, rect.rowTo);
+
+    return !range.IsNull() && range.WriteValues(values);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ExcelWriteBatch
+
+ExcelWriteBatch::ExcelWriteBatch(ExcelWorksheet worksheet, size_t flushThreshold /* = DefaultFlushThreshold */):
+    HandleBase(new ExcelWriteBatchImpl(worksheet, flushThreshold))
+{
+}
+
+
+bool ExcelWriteBatch::SetValue(ELchar column, int row, const ELstring &value)
+{
+    return Body().SetValue(column, row, value);
+}
+
+
+bool ExcelWriteBatch::SetValue(ELchar column, int row, int value)
+{
+    return Body().SetValue(column, row, value);
+}
+
+
+bool ExcelWriteBatch::SetValue(ELchar column, int row, double value)
+{
+    return Body().SetValue(column, row, value);
+}
+
+
+size_t ExcelWriteBatch::CountPending() const
+{
+    return Body().CountPending();
+}
+
+
+bool ExcelWriteBatch::Commit()
+{
+    return Body().Commit();
+}
+
+
+void ExcelWriteBatch::Discard()
+{
+    Body().Discard();
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+ExcelWriteBatch::ExcelWriteBatch(ExcelWriteBatchImpl *impl): HandleBase(impl)
+{
+}
+
+
+ExcelWriteBatchImpl& ExcelWriteBatch::Body() const
+{
+    return dynamic_cast<ExcelWriteBatchImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,77 @@
+﻿/*!
+* @file    FileSink.cpp
+* @brief   Implementation file for class FileSink
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdio>
+#include "FileSink.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+FileSink::FileSink(): m_file(NULL), m_position(0), m_failed(false)
+{
+}
+
+
+FileSink::~FileSink()
+{
+    Close();
+}
+
+
+bool FileSink::Open(const ELstring &filename)
+{
+    Close();
+
+#if defined(_WIN32) && defined(_UNICODE)
+    m_file = _wfopen(filename.c_str(), L"wb");
+#elif defined(_UNICODE)
+    m_file = fopen(Utf8::FromELstring(filename).c_str(), "wb");
+#else
+    m_file = fopen(filename.c_str(), "wb");
+#endif
+
+    m_position = 0;
+    m_failed = (m_file == NULL);
+    return m_file != NULL;
+}
+
+
+bool FileSink::Close()
+{
+    if (m_file == NULL)
+        return !m_failed;
+
+    if (fclose(m_file) != 0)
+        m_failed = true;
+    m_file = NULL;
+
+    return !m_failed;
+}
+
+
+bool FileSink::Write(const unsigned char *data, size_t size)
+{
+    if (m_file == NULL || m_failed)
+        return false;
+
+    if (fwrite(data, 1, size, m_file) != size)
+    {
+        m_failed = true;
+        return false;
+    }
+
+    m_position += size;
+    return true;
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,71 @@
+﻿/*!
+* @file    FileSink.h
+* @brief   Header file for class FileSink
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef FILESINK_H_GUID_553F1700_DD8D_4BF1_9C62_E8FB24CDAED7
+#define FILESINK_H_GUID_553F1700_DD8D_4BF1_9C62_E8FB24CDAED7
+
+
+#include <cstdio>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "ByteSink.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class FileSink writes a file from the beginning, and counts the bytes written.
+*/
+class FileSink : public ByteSink, public Noncopyable
+{
+public:
+    FileSink();
+    ~FileSink();
+
+    /*!
+    * @brief Create a file, or truncate an existing one.
+    * @param [in] filename Name of the file. On Linux a wide name is converted to UTF-8.
+    */
+    bool Open(const ELstring &filename);
+
+    /*!
+    * @return false if any write failed or the file cannot be closed.
+    */
+    bool Close();
+
+    bool IsOpen() const
+    {
+        return m_file != NULL;
+    }
+
+    /*!
+    * @brief Number of bytes written so far, which is the offset of the next byte.
+    */
+    long long Position() const
+    {
+        return m_position;
+    }
+
+    virtual bool Write(const unsigned char *data, size_t size);
+
+private:
+    FILE      *m_file;
+    long long  m_position;
+    bool       m_failed;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //FILESINK_H_GUID_553F1700_DD8D_4BF1_9C62_E8FB24CDAED7
@@ -0,0 +1,109 @@
+﻿/*!
+* @file    FileSource.cpp
+* @brief   Implementation file for class FileSource
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef _WIN32
+#   define _FILE_OFFSET_BITS 64     // 64-bit off_t for fseeko/ftello
+#endif
+
+#include <cstdio>
+#ifndef _WIN32
+#   include <sys/types.h>
+#endif
+#include "FileSource.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+FileSource::FileSource(): m_file(NULL), m_failed(false)
+{
+}
+
+
+FileSource::~FileSource()
+{
+    Close();
+}
+
+
+bool FileSource::Open(const ELstring &filename)
+{
+    Close();
+
+#if defined(_WIN32) && defined(_UNICODE)
+    m_file = _wfopen(filename.c_str(), L"rb");
+#elif defined(_UNICODE)
+    m_file = fopen(Utf8::FromELstring(filename).c_str(), "rb");
+#else
+    m_file = fopen(filename.c_str(), "rb");
+#endif
+
+    m_failed = (m_file == NULL);
+    return m_file != NULL;
+}
+
+
+void FileSource::Close()
+{
+    if (m_file != NULL)
+    {
+        fclose(m_file);
+        m_file = NULL;
+    }
+}
+
+
+long long FileSource::Size()
+{
+    if (m_file == NULL)
+        return -1;
+
+#ifdef _WIN32
+    if (_fseeki64(m_file, 0, SEEK_END) != 0)
+        return -1;
+    return _ftelli64(m_file);
+#else
+    if (fseeko(m_file, 0, SEEK_END) != 0)
+        return -1;
+    return static_cast<long long>(ftello(m_file));
+#endif
+}
+
+
+bool FileSource::Seek(long long offset)
+{
+    if (m_file == NULL)
+        return false;
+
+#ifdef _WIN32
+    m_failed = (_fseeki64(m_file, offset, SEEK_SET) != 0);
+#else
+    m_failed = (fseeko(m_file, static_cast<off_t>(offset), SEEK_SET) != 0);
+#endif
+
+    return !m_failed;
+}
+
+
+size_t FileSource::Read(unsigned char *buffer, size_t size)
+{
+    if (m_file == NULL || m_failed)
+        return 0;
+
+    size_t n = fread(buffer, 1, size, m_file);
+    if (n < size && ferror(m_file))
+        m_failed = true;
+
+    return n;
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
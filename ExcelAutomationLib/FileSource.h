@@ -0,0 +1,77 @@
+﻿/*!
+* @file    FileSource.h
+* @brief   Header file for class FileSource
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef FILESOURCE_H_GUID_5B0E4C7D_2A61_4F3B_9C8E_A4D1F6B27E93
+#define FILESOURCE_H_GUID_5B0E4C7D_2A61_4F3B_9C8E_A4D1F6B27E93
+
+
+#include <cstdio>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "ByteSource.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class FileSource reads a file from a given position.
+* @details Files larger than 2GB are supported. Every FileSource has its own file handle, so the readers 
+*          on different threads do not share a file position.
+*/
+class FileSource : public ByteSource, public Noncopyable
+{
+public:
+    FileSource();
+    ~FileSource();
+
+    /*!
+    * @brief Open a file for reading.
+    * @param [in] filename Name of the file. On Linux a wide name is converted to UTF-8.
+    * @return true if the file is opened.
+    */
+    bool Open(const ELstring &filename);
+
+    void Close();
+
+    bool IsOpen() const
+    {
+        return m_file != NULL;
+    }
+
+    /*!
+    * @brief Size of the file in bytes, -1 on failure.
+    */
+    long long Size();
+
+    /*!
+    * @brief Move to the given offset from the beginning of the file.
+    */
+    bool Seek(long long offset);
+
+    virtual size_t Read(unsigned char *buffer, size_t size);
+
+    virtual bool Failed() const
+    {
+        return m_failed;
+    }
+
+private:
+    FILE *m_file;
+    bool  m_failed;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //FILESOURCE_H_GUID_5B0E4C7D_2A61_4F3B_9C8E_A4D1F6B27E93
@@ -0,0 +1,446 @@
+﻿/*!
+* @file    Inflater.cpp
+* @brief   Implementation file for class Inflater
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstring>
+#include "Inflater.h"
+#include "DeflateFormat.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    const size_t InputBufferSize = 16384;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of struct Inflater::Huffman
+
+bool Inflater::Huffman::Build(const unsigned char *lengths, int n)
+{
+    assert(n <= MaxLiteralCodes);
+
+    memset(count, 0, sizeof(count));
+    memset(fast, 0, sizeof(fast));
+
+    for (int s = 0; s < n; ++s)
+        ++count[lengths[s]];
+
+    if (count[0] == n)
+        return true;    // no codes, any use of it is an error
+
+    // reject an over-subscribed code (an incomplete one is allowed, as zlib does for a single distance code)
+    int left = 1;
+    for (int len = 1; len <= MaxBits; ++len)
+    {
+        left <<= 1;
+        left -= count[len];
+        if (left < 0)
+            return false;
+    }
+
+    // offsets of each length in the symbol table, and the first code of each length
+    unsigned short offset[MaxBits + 1];
+    unsigned short nextCode[MaxBits + 1];
+    offset[1] = 0;
+    nextCode[1] = 0;
+    for (int len = 1; len < MaxBits; ++len)
+    {
+        offset[len + 1] = static_cast<unsigned short>(offset[len] + count[len]);
+        nextCode[len + 1] = static_cast<unsigned short>((nextCode[len] + count[len]) << 1);
+    }
+
+    for (int s = 0; s < n; ++s)
+    {
+        int len = lengths[s];
+        if (len == 0)
+            continue;
+
+        symbol[offset[len]++] = static_cast<unsigned short>(s);
+
+        unsigned int code = nextCode[len]++;
+        if (len <= FastBits)
+        {
+            // the bits of a code are stored from the highest one, the bit buffer gives the lowest first
+            unsigned int reversed = 0;
+            for (int k = 0; k < len; ++k)
+                reversed |= ((code >> k) & 1) << (len - 1 - k);
+
+            for (unsigned int i = reversed; i < (1U << FastBits); i += (1U << len))
+                fast[i] = static_cast<unsigned short>((len << 9) | s);
+        }
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class Inflater
+
+Inflater::Inflater(ByteSource &input): m_input(&input), m_inBuffer(InputBufferSize), m_inData(&m_inBuffer[0]), 
+    m_inPos(0), m_inEnd(0), m_bitBuffer(0), m_bitCount(0), m_window(WindowSize), m_total(0), 
+    m_state(StateBlockHeader), m_lastBlock(false), m_storedRemaining(0), m_copyRemaining(0), m_copyDistance(0)
+{
+}
+
+
+Inflater::Inflater(const unsigned char *data, size_t size): m_input(NULL), m_inData(data), m_inPos(0), 
+    m_inEnd(size), m_bitBuffer(0), m_bitCount(0), m_window(WindowSize), m_total(0), 
+    m_state(StateBlockHeader), m_lastBlock(false), m_storedRemaining(0), m_copyRemaining(0), m_copyDistance(0)
+{
+}
+
+
+size_t Inflater::Read(unsigned char *buffer, size_t size)
+{
+    size_t produced = 0;
+
+    while (produced < size)
+    {
+        if (m_copyRemaining > 0)
+        {
+            // the rest of a match
+            size_t n = m_copyRemaining < size - produced ? m_copyRemaining : size - produced;
+            for (size_t i = 0; i < n; ++i)
+                Put(buffer, produced, m_window[(m_total - m_copyDistance) & (WindowSize - 1)]);
+            m_copyRemaining -= n;
+            continue;
+        }
+
+        switch (m_state)
+        {
+        case StateBlockHeader:
+            if (m_lastBlock)
+                m_state = StateDone;
+            else if (!ReadBlockHeader())
+                m_state = StateError;
+            break;
+
+        case StateStored:
+            if (m_storedRemaining == 0)
+            {
+                m_state = StateBlockHeader;
+            }
+            else if (!NeedBits(8))
+            {
+                m_state = StateError;
+            }
+            else
+            {
+                Put(buffer, produced, static_cast<unsigned char>(TakeBits(8)));
+                --m_storedRemaining;
+            }
+            break;
+
+        case StateCodes:
+            {
+                int symbol;
+                if (!Decode(m_literalCode, symbol))
+                {
+                    m_state = StateError;
+                    break;
+                }
+
+                if (symbol < 256)
+                {
+                    Put(buffer, produced, static_cast<unsigned char>(symbol));
+                    break;
+                }
+
+                if (symbol == 256)
+                {
+                    m_state = StateBlockHeader;     // end of the block
+                    break;
+                }
+
+                // a match: <length> <distance>
+                symbol -= 257;
+                if (symbol >= 29 || !NeedBits(DeflateFormat::LengthExtra[symbol]))
+                {
+                    m_state = StateError;
+                    break;
+                }
+                size_t length = DeflateFormat::LengthBase[symbol] + TakeBits(DeflateFormat::LengthExtra[symbol]);
+
+                if (!Decode(m_distanceCode, symbol) || symbol >= 30 || !NeedBits(DeflateFormat::DistanceExtra[symbol]))
+                {
+                    m_state = StateError;
+                    break;
+                }
+                size_t distance = DeflateFormat::DistanceBase[symbol] + TakeBits(DeflateFormat::DistanceExtra[symbol]);
+
+                if (distance > m_total)
+                {
+                    m_state = StateError;   // refers to data before the start
+                    break;
+                }
+
+                m_copyRemaining = length;
+                m_copyDistance = distance;
+            }
+            break;
+
+        case StateDone:
+        case StateError:
+            return produced;
+        }
+    }
+
+    return produced;
+}
+
+
+bool Inflater::ReadByte(unsigned char &value)
+{
+    if (m_inPos == m_inEnd)
+    {
+        if (m_input == NULL)
+            return false;   // the end of the data in memory
+
+        m_inPos = 0;
+        m_inEnd = m_input->Read(&m_inBuffer[0], m_inBuffer.size());
+        if (m_inEnd == 0)
+            return false;
+    }
+
+    value = m_inData[m_inPos++];
+    return true;
+}
+
+
+// Get as many bits as possible, without failing at the end of the input
+void Inflater::FillBits()
+{
+    unsigned char value;
+    while (m_bitCount <= 24 && ReadByte(value))
+    {
+        m_bitBuffer |= static_cast<unsigned long>(value) << m_bitCount;
+        m_bitCount += 8;
+    }
+}
+
+
+bool Inflater::NeedBits(int n)
+{
+    assert(n <= 25);
+
+    unsigned char value;
+    while (m_bitCount < n)
+    {
+        if (!ReadByte(value))
+            return false;   // truncated input
+
+        m_bitBuffer |= static_cast<unsigned long>(value) << m_bitCount;
+        m_bitCount += 8;
+    }
+
+    return true;
+}
+
+
+unsigned long Inflater::TakeBits(int n)
+{
+    assert(n <= m_bitCount);
+
+    unsigned long value = m_bitBuffer & ((1UL << n) - 1);
+    m_bitBuffer >>= n;
+    m_bitCount -= n;
+    return value;
+}
+
+
+bool Inflater::Decode(const Huffman &code, int &symbol)
+{
+    if (m_bitCount < MaxBits)
+        FillBits();
+
+    unsigned int entry = code.fast[m_bitBuffer & ((1U << FastBits) - 1)];
+    if (entry != 0 && static_cast<int>(entry >> 9) <= m_bitCount)
+    {
+        TakeBits(entry >> 9);
+        symbol = entry & 0x1FF;
+        return true;
+    }
+
+    // a long code (or the end of the input), decode it bit by bit
+    int value = 0;      // bits of the code so far
+    int first = 0;      // first code of the current length
+    int index = 0;      // index of the first code of the current length in the symbol table
+    for (int len = 1; len <= MaxBits; ++len)
+    {
+        if (!NeedBits(1))
+            return false;
+
+        value |= static_cast<int>(TakeBits(1));
+        int count = code.count[len];
+        if (value - count < first)
+        {
+            symbol = code.symbol[index + (value - first)];
+            return true;
+        }
+
+        index += count;
+        first += count;
+        first <<= 1;
+        value <<= 1;
+    }
+
+    return false;   // no such code
+}
+
+
+bool Inflater::ReadBlockHeader()
+{
+    if (!NeedBits(3))
+        return false;
+
+    m_lastBlock = TakeBits(1) != 0;
+
+    switch (TakeBits(2))
+    {
+    case 0:
+        {
+            // stored block: skip to the byte boundary, then LEN and NLEN
+            TakeBits(m_bitCount & 7);
+            if (!NeedBits(16))
+                return false;
+            unsigned long length = TakeBits(16);
+            if (!NeedBits(16))
+                return false;
+            unsigned long complement = TakeBits(16);
+            if (length != (~complement & 0xFFFF))
+                return false;
+
+            m_storedRemaining = length;
+            m_state = StateStored;
+        }
+        return true;
+
+    case 1:
+        m_state = StateCodes;
+        return ReadFixedCodes();
+
+    case 2:
+        m_state = StateCodes;
+        return ReadDynamicCodes();
+
+    default:
+        return false;
+    }
+}
+
+
+bool Inflater::ReadFixedCodes()
+{
+    unsigned char lengths[MaxLiteralCodes];
+
+    int s = 0;
+    for (; s < 144; ++s)
+        lengths[s] = 8;
+    for (; s < 256; ++s)
+        lengths[s] = 9;
+    for (; s < 280; ++s)
+        lengths[s] = 7;
+    for (; s < MaxLiteralCodes; ++s)
+        lengths[s] = 8;
+
+    if (!m_literalCode.Build(lengths, MaxLiteralCodes))
+        return false;
+
+    for (s = 0; s < MaxDistanceCodes; ++s)
+        lengths[s] = 5;
+
+    return m_distanceCode.Build(lengths, MaxDistanceCodes);
+}
+
+
+bool Inflater::ReadDynamicCodes()
+{
+    if (!NeedBits(14))
+        return false;
+
+    int literalCount = static_cast<int>(TakeBits(5)) + 257;
+    int distanceCount = static_cast<int>(TakeBits(5)) + 1;
+    int codeLengthCount = static_cast<int>(TakeBits(4)) + 4;
+
+    if (literalCount > 286 || distanceCount > MaxDistanceCodes)
+        return false;
+
+    // the code which compresses the code lengths
+    unsigned char lengths[MaxLiteralCodes + MaxDistanceCodes];
+    memset(lengths, 0, 19);
+
+    for (int i = 0; i < codeLengthCount; ++i)
+    {
+        if (!NeedBits(3))
+            return false;
+        lengths[DeflateFormat::CodeLengthOrder[i]] = static_cast<unsigned char>(TakeBits(3));
+    }
+
+    Huffman lengthCode;
+    if (!lengthCode.Build(lengths, 19))
+        return false;
+
+    // the code lengths of the literal/length code and the distance code, as one sequence
+    int total = literalCount + distanceCount;
+    int i = 0;
+    while (i < total)
+    {
+        int symbol;
+        if (!Decode(lengthCode, symbol))
+            return false;
+
+        if (symbol < 16)
+        {
+            lengths[i++] = static_cast<unsigned char>(symbol);
+            continue;
+        }
+
+        unsigned char value = 0;
+        int repeat;
+        if (symbol == 16)
+        {
+            if (i == 0 || !NeedBits(2))
+                return false;   // nothing to repeat
+            value = lengths[i - 1];
+            repeat = 3 + static_cast<int>(TakeBits(2));
+        }
+        else if (symbol == 17)
+        {
+            if (!NeedBits(3))
+                return false;
+            repeat = 3 + static_cast<int>(TakeBits(3));
+        }
+        else
+        {
+            if (!NeedBits(7))
+                return false;
+            repeat = 11 + static_cast<int>(TakeBits(7));
+        }
+
+        if (i + repeat > total)
+            return false;
+
+        while (repeat-- > 0)
+            lengths[i++] = value;
+    }
+
+    if (lengths[256] == 0)
+        return false;   // no end-of-block code
+
+    return m_literalCode.Build(lengths, literalCount) && m_distanceCode.Build(lengths + literalCount, distanceCount);
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,129 @@
+﻿/*!
+* @file    Inflater.h
+* @brief   Header file for class Inflater
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef INFLATER_H_GUID_E593616E_4550_46A2_9960_5F7359D40547
+#define INFLATER_H_GUID_E593616E_4550_46A2_9960_5F7359D40547
+
+
+#include <vector>
+#include "LibDef.h"
+#include "ByteSource.h"
+#include "DeflateFormat.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class Inflater decompresses a raw DEFLATE stream (RFC 1951), which is how the parts of an
+*        .xlsx package are compressed.
+* @details The compressed data is pulled from another ByteSource, or read in place from memory (such as a
+*          MappedPackage), and the decompressed data is pulled by Read(), so only the 32KB history window is
+*          kept whatever the size of the part is.
+*/
+class Inflater : public ByteSource, public Noncopyable
+{
+public:
+    /*!
+    * @param [in] input The compressed data. Must outlive the Inflater.
+    */
+    explicit Inflater(ByteSource &input);
+
+    /*!
+    * @param [in] data, size The compressed data, which is not copied. Must outlive the Inflater.
+    */
+    Inflater(const unsigned char *data, size_t size);
+
+    virtual size_t Read(unsigned char *buffer, size_t size);
+
+    virtual bool Failed() const
+    {
+        return m_state == StateError || (m_input != NULL && m_input->Failed());
+    }
+
+private:
+    enum
+    {
+        WindowSize = DeflateFormat::WindowSize,
+        FastBits = 9,           // codes up to this length are decoded by one table lookup
+        MaxBits = DeflateFormat::MaxBits,
+        MaxLiteralCodes = DeflateFormat::MaxLiteralCodes,
+        MaxDistanceCodes = DeflateFormat::DistanceCodes
+    };
+
+    enum State
+    {
+        StateBlockHeader,       // before the header of a block
+        StateStored,            // in a stored block
+        StateCodes,             // in a block compressed by Huffman codes
+        StateDone,              // after the last block
+        StateError              // corrupted data
+    };
+
+    /*!
+    * @brief A canonical Huffman code
+    */
+    struct Huffman
+    {
+        unsigned short count[MaxBits + 1];      // number of codes of each length
+        unsigned short symbol[MaxLiteralCodes]; // symbols ordered by code
+        unsigned short fast[1 << FastBits];     // (length << 9) | symbol, indexed by the next bits; 0 if longer
+
+        bool Build(const unsigned char *lengths, int n);
+    };
+
+private:
+    bool ReadByte(unsigned char &value);
+    void FillBits();
+    bool NeedBits(int n);
+    unsigned long TakeBits(int n);
+
+    bool Decode(const Huffman &code, int &symbol);
+
+    bool ReadBlockHeader();
+    bool ReadDynamicCodes();
+    bool ReadFixedCodes();
+
+    void Put(unsigned char *buffer, size_t &produced, unsigned char value)
+    {
+        buffer[produced++] = value;
+        m_window[m_total++ & (WindowSize - 1)] = value;
+    }
+
+private:
+    ByteSource                *m_input;        // NULL if the data is in memory
+    std::vector<unsigned char> m_inBuffer;
+    const unsigned char       *m_inData;        // m_inBuffer, or the data in memory
+    size_t                     m_inPos;
+    size_t                     m_inEnd;
+
+    unsigned long              m_bitBuffer;     // bits not consumed yet, the next bit is the lowest one
+    int                        m_bitCount;
+
+    std::vector<unsigned char> m_window;        // the last WindowSize bytes of output
+    size_t                     m_total;         // number of bytes output so far
+
+    State                      m_state;
+    bool                       m_lastBlock;
+    size_t                     m_storedRemaining;
+    size_t                     m_copyRemaining; // a match which is not copied completely
+    size_t                     m_copyDistance;
+
+    Huffman                    m_literalCode;
+    Huffman                    m_distanceCode;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //INFLATER_H_GUID_E593616E_4550_46A2_9960_5F7359D40547
@@ -0,0 +1,290 @@
+﻿/*!
+* @file    InstancePool.cpp
+* @brief   Implementation file for class InstancePool
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include "InstancePool.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // How long the pool thread waits before it tries again to start an instance
+    const unsigned long retryDelay = 1000;
+}
+
+
+InstancePool::InstancePool(Factory &factory, const Options &options): m_factory(factory), m_options(options),
+    m_stopping(false), m_available(false), m_wake(false)
+{
+    // If the thread cannot be started, no instance is started and every lease fails at once
+    m_thread.Start(ThreadMain, this);
+}
+
+
+InstancePool::~InstancePool()
+{
+    {
+        MutexLock lock(m_mutex);
+
+        // all the instances should be returned
+        for (RecordMap::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+            assert(!it->second.leased);
+
+        m_stopping = true;
+    }
+
+    // the leases waiting for an instance fail
+    m_available.Set();
+    m_wake.Set();
+    m_thread.Join();
+}
+
+
+bool InstancePool::Lease(InstanceId &id, unsigned long timeout)
+{
+    unsigned long start = Thread::TickCount();
+
+    for (;;)
+    {
+        {
+            MutexLock lock(m_mutex);
+
+            if (!m_idle.empty())
+            {
+                // the last returned one is the warmest
+                id = m_idle.back();
+                m_idle.pop_back();
+
+                m_records[id].leased = true;
+                ++m_stats.leases;
+
+                // m_available releases one waiting thread, pass it on if more instances are idle
+                if (!m_idle.empty())
+                    m_available.Set();
+
+                return true;
+            }
+
+            if (m_stopping)
+            {
+                // m_available releases one waiting thread, pass the stop on
+                m_available.Set();
+                return false;
+            }
+
+            // without the pool thread, no instance is ever started
+            if (!m_thread.IsStarted())
+                return false;
+        }
+
+        unsigned long waited = Thread::TickCount() - start;
+        if (timeout != Event::infinite && waited >= timeout)
+        {
+            MutexLock lock(m_mutex);
+            ++m_stats.leaseTimeouts;
+            return false;
+        }
+
+        m_available.Wait(timeout == Event::infinite ? Event::infinite : timeout - waited);
+    }
+}
+
+
+void InstancePool::Return(InstanceId id, const Usage &usage)
+{
+    MutexLock lock(m_mutex);
+
+    RecordMap::iterator it = m_records.find(id);
+    assert(it != m_records.end() && it->second.leased);
+    if (it == m_records.end())
+        return;
+
+    Record &record = it->second;
+    record.leased = false;
+    record.workbooks += usage.workbooks;
+    ++m_stats.returns;
+
+    bool recycle = false;
+    if (!usage.healthy)
+    {
+        ++m_stats.dead;
+        recycle = true;
+    }
+    else if ((m_options.maxWorkbooks != 0 && record.workbooks >= m_options.maxWorkbooks) ||
+        (m_options.maxMemoryGrowth != 0 && usage.memory > record.memory &&
+        usage.memory - record.memory >= m_options.maxMemoryGrowth))
+    {
+        ++m_stats.recycled;
+        recycle = true;
+    }
+
+    if (recycle || m_stopping)
+    {
+        // the pool thread destroys it, and starts a new one
+        m_records.erase(it);
+        m_retired.push_back(id);
+        m_wake.Set();
+    }
+    else
+    {
+        m_idle.push_back(id);
+        m_available.Set();
+    }
+}
+
+
+InstancePool::Stats InstancePool::GetStats() const
+{
+    MutexLock lock(m_mutex);
+
+    Stats stats = m_stats;
+    stats.idle = m_idle.size();     // without the ones being checked
+    for (RecordMap::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+    {
+        if (it->second.leased)
+            ++stats.leased;
+    }
+
+    return stats;
+}
+
+
+void InstancePool::ThreadMain(void *context)
+{
+    static_cast<InstancePool*>(context)->Run();
+}
+
+
+void InstancePool::Run()
+{
+    m_factory.EnterThread();
+
+    unsigned long lastCheck = Thread::TickCount();
+
+    for (;;)
+    {
+        std::vector<InstanceId> retired;
+        bool stopping;
+        bool missing;
+        {
+            MutexLock lock(m_mutex);
+            retired.swap(m_retired);
+            stopping = m_stopping;
+            missing = m_records.size() < m_options.size;
+        }
+
+        for (size_t i = 0; i < retired.size(); ++i)
+            m_factory.Destroy(retired[i]);
+
+        if (stopping)
+            break;
+
+        unsigned long elapsed = Thread::TickCount() - lastCheck;
+        if (m_options.checkInterval != 0 && elapsed >= m_options.checkInterval)
+        {
+            CheckIdle();
+            lastCheck = Thread::TickCount();
+            continue;
+        }
+
+        unsigned long wait = (m_options.checkInterval != 0) ? m_options.checkInterval - elapsed : Event::infinite;
+
+        if (missing)
+        {
+            InstanceId id = 0;
+            unsigned long long memory = 0;
+            bool created = m_factory.Create(id, memory);
+
+            MutexLock lock(m_mutex);
+            if (created)
+            {
+                assert(m_records.find(id) == m_records.end());
+
+                m_records[id].memory = memory;
+                m_idle.push_back(id);
+                ++m_stats.created;
+                m_available.Set();
+                continue;
+            }
+
+            ++m_stats.createFailures;
+            if (wait > retryDelay)
+                wait = retryDelay;
+        }
+
+        m_factory.Wait(m_wake, wait);
+    }
+
+    DestroyAll();
+
+    m_factory.LeaveThread();
+}
+
+
+void InstancePool::CheckIdle()
+{
+    // The idle instances are taken out while they are checked; a lease meanwhile waits for them
+    std::vector<InstanceId> idle;
+    {
+        MutexLock lock(m_mutex);
+        idle.swap(m_idle);
+    }
+
+    std::vector<InstanceId> alive;
+    std::vector<InstanceId> dead;
+    for (size_t i = 0; i < idle.size(); ++i)
+    {
+        if (m_factory.IsAlive(idle[i]))
+            alive.push_back(idle[i]);
+        else
+            dead.push_back(idle[i]);
+    }
+
+    {
+        MutexLock lock(m_mutex);
+
+        for (size_t i = 0; i < dead.size(); ++i)
+            m_records.erase(dead[i]);
+        m_stats.dead += static_cast<unsigned long>(dead.size());
+
+        // the ones returned meanwhile are warmer, so they stay at the back
+        m_idle.insert(m_idle.begin(), alive.begin(), alive.end());
+        if (!m_idle.empty())
+            m_available.Set();
+    }
+
+    for (size_t i = 0; i < dead.size(); ++i)
+        m_factory.Destroy(dead[i]);
+}
+
+
+void InstancePool::DestroyAll()
+{
+    std::vector<InstanceId> instances;
+    {
+        MutexLock lock(m_mutex);
+
+        for (RecordMap::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+            instances.push_back(it->first);
+        instances.insert(instances.end(), m_retired.begin(), m_retired.end());
+
+        m_records.clear();
+        m_idle.clear();
+        m_retired.clear();
+    }
+
+    for (size_t i = 0; i < instances.size(); ++i)
+        m_factory.Destroy(instances[i]);
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
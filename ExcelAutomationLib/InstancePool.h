@@ -0,0 +1,197 @@
+﻿/*!
+* @file    InstancePool.h
+* @brief   Header file for class InstancePool
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef INSTANCEPOOL_H_GUID_B72E4A90_6D1C_4F38_9A05_C3E8F1D62B74
+#define INSTANCEPOOL_H_GUID_B72E4A90_6D1C_4F38_9A05_C3E8F1D62B74
+
+
+#include <map>
+#include <vector>
+#include "LibDef.h"
+#include "Noncopyable.h"
+#include "ThreadUtil.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class InstancePool keeps a number of instances which are slow to start (Excel processes) started,
+*        and leases them to callers.
+* @details The instances are made, checked and destroyed by a Factory, and known by the id which the
+*          factory gives them. A thread of the pool calls the factory: it starts instances until there are
+*          @e size of them, idle or leased, checks the idle ones every @e checkInterval and replaces the
+*          dead ones, and destroys the instances which are recycled. @n
+*          The caller tells how an instance was used when it returns it. The instance is recycled if it is
+*          not healthy, if the workbooks opened in it reach @e maxWorkbooks, or if its memory has grown by
+*          @e maxMemoryGrowth since it was started.
+* @note All the calls of the factory are made on the thread of the pool, so the pool logic does not depend
+*       on COM, and a stand-in factory can be used where there is no Excel.
+*/
+class InstancePool : public Noncopyable
+{
+public:
+    typedef unsigned long InstanceId;
+
+    /*!
+    * @brief Interface of what makes the instances of the pool. All its members are called on the pool thread.
+    */
+    class Factory
+    {
+    public:
+        virtual ~Factory() { }
+
+        /*!
+        * @brief Called when the pool thread starts, before any other member.
+        */
+        virtual void EnterThread() { }
+
+        /*!
+        * @brief Called when the pool thread ends, after all the instances are destroyed.
+        */
+        virtual void LeaveThread() { }
+
+        /*!
+        * @brief Start an instance ready to be used.
+        * @param [out] id Which returns the id of the instance.
+        * @param [out] memory Which returns the memory used by the instance in bytes, 0 if not known.
+        * @return true if successful, otherwise false
+        */
+        virtual bool Create(InstanceId &id, unsigned long long &memory) = 0;
+
+        /*!
+        * @brief Whether an idle instance still answers.
+        */
+        virtual bool IsAlive(InstanceId id) = 0;
+
+        /*!
+        * @brief Shut an instance down, which may be dead already.
+        */
+        virtual void Destroy(InstanceId id) = 0;
+
+        /*!
+        * @brief Wait until @e wake is set or @e timeout expires, when the pool thread has nothing to do.
+        * @param [in] timeout In milliseconds, or Event::infinite.
+        * @note An STA thread keeps pumping its messages here.
+        */
+        virtual void Wait(Event &wake, unsigned long timeout)
+        {
+            wake.Wait(timeout);
+        }
+    };
+
+    struct Options
+    {
+        Options(): size(1), maxWorkbooks(0), maxMemoryGrowth(0), checkInterval(30000) { }
+
+        size_t             size;            // number of instances kept started
+        unsigned long      maxWorkbooks;    // 0 for no limit
+        unsigned long long maxMemoryGrowth; // in bytes, 0 for no limit
+        unsigned long      checkInterval;   // in milliseconds
+    };
+
+    /*!
+    * @brief How a leased instance was used, told by Return()
+    */
+    struct Usage
+    {
+        Usage(): healthy(true), workbooks(0), memory(0) { }
+
+        bool               healthy;         // whether the instance still answers
+        unsigned long      workbooks;       // number of workbooks opened or created during the lease
+        unsigned long long memory;          // memory used by the instance in bytes, 0 if not known
+    };
+
+    struct Stats
+    {
+        Stats(): created(0), createFailures(0), leases(0), leaseTimeouts(0), returns(0), recycled(0), dead(0),
+            idle(0), leased(0)
+        {
+        }
+
+        unsigned long created;
+        unsigned long createFailures;
+        unsigned long leases;
+        unsigned long leaseTimeouts;
+        unsigned long returns;
+        unsigned long recycled;             // instances recycled because of the limits
+        unsigned long dead;                 // instances found dead, when returned or checked
+        size_t        idle;
+        size_t        leased;
+    };
+
+public:
+    /*!
+    * @brief Start the pool thread, which starts the instances.
+    * @param [in] factory Which must live longer than the pool.
+    */
+    InstancePool(Factory &factory, const Options &options);
+
+    /*!
+    * @brief Stop the pool thread, after it destroys all the instances.
+    * @note The leased instances are destroyed too, so they should all be returned before.
+    */
+    ~InstancePool();
+
+    /*!
+    * @brief Lease an idle instance, waiting for one if there is none.
+    * @param [out] id Which returns the id of the instance.
+    * @param [in] timeout In milliseconds, or Event::infinite.
+    * @return true if successful, false if the timeout expires, the pool is stopping, or its thread could not be started
+    */
+    bool Lease(InstanceId &id, unsigned long timeout);
+
+    /*!
+    * @brief Give back a leased instance, which is idle again or recycled.
+    */
+    void Return(InstanceId id, const Usage &usage);
+
+    Stats GetStats() const;
+
+private:
+    struct Record
+    {
+        Record(): memory(0), workbooks(0), leased(false) { }
+
+        unsigned long long memory;          // when the instance was started
+        unsigned long      workbooks;       // opened in all the leases
+        bool               leased;
+    };
+
+    typedef std::map<InstanceId, Record> RecordMap;
+
+    static void ThreadMain(void *context);
+
+    void Run();
+    void CheckIdle();
+    void DestroyAll();
+
+private:
+    Factory                &m_factory;
+    Options                 m_options;
+
+    mutable Mutex           m_mutex;        // guards the members below
+    RecordMap               m_records;      // all the instances which are not retired
+    std::vector<InstanceId> m_idle;         // the last returned at the back
+    std::vector<InstanceId> m_retired;      // to be destroyed by the pool thread
+    bool                    m_stopping;
+    Stats                   m_stats;
+
+    Event                   m_available;    // set when an instance becomes idle, or the pool stops
+    Event                   m_wake;         // set when the pool thread has something to do
+    Thread                  m_thread;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //INSTANCEPOOL_H_GUID_B72E4A90_6D1C_4F38_9A05_C3E8F1D62B74
@@ -0,0 +1,145 @@
+﻿/*!
+* @file    MappedPackage.cpp
+* @brief   Implementation file for class MappedPackage
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#   define _FILE_OFFSET_BITS 64     // 64-bit off_t for the size of the file
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MappedPackage.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+#ifdef _WIN32
+
+MappedPackage::MappedPackage(): m_data(NULL), m_size(0), m_mapping(NULL)
+{
+}
+
+#else
+
+MappedPackage::MappedPackage(): m_data(NULL), m_size(0)
+{
+}
+
+#endif // _WIN32
+
+
+MappedPackage::~MappedPackage()
+{
+    Close();
+}
+
+
+#ifdef _WIN32
+
+bool MappedPackage::Open(const ELstring &filename)
+{
+    Close();
+
+    HANDLE file = ::CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0 ||
+        static_cast<unsigned long long>(size.QuadPart) > static_cast<size_t>(-1))
+    {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    // the mapping object keeps the file open
+    m_mapping = ::CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    ::CloseHandle(file);
+    if (m_mapping == NULL)
+        return false;
+
+    m_data = static_cast<const unsigned char*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == NULL)
+    {
+        Close();
+        return false;
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+
+void MappedPackage::Close()
+{
+    if (m_data != NULL)
+        ::UnmapViewOfFile(m_data);
+    if (m_mapping != NULL)
+        ::CloseHandle(m_mapping);
+
+    m_data = NULL;
+    m_size = 0;
+    m_mapping = NULL;
+}
+
+#else
+
+bool MappedPackage::Open(const ELstring &filename)
+{
+    Close();
+
+#ifdef _UNICODE
+    int file = open(Utf8::FromELstring(filename).c_str(), O_RDONLY);
+#else
+    int file = open(filename.c_str(), O_RDONLY);
+#endif
+    if (file < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0 ||
+        static_cast<unsigned long long>(status.st_size) > static_cast<size_t>(-1))
+    {
+        close(file);
+        return false;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    void *data = mmap(NULL, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<size_t>(status.st_size);
+    return true;
+}
+
+
+void MappedPackage::Close()
+{
+    if (m_data != NULL)
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+
+    m_data = NULL;
+    m_size = 0;
+}
+
+#endif // _WIN32
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,83 @@
+﻿/*!
+* @file    MappedPackage.h
+* @brief   Header file for class MappedPackage
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef MAPPEDPACKAGE_H_GUID_C64A1F0E_7B3D_4E28_95A6_2D8E0B71F4C3
+#define MAPPEDPACKAGE_H_GUID_C64A1F0E_7B3D_4E28_95A6_2D8E0B71F4C3
+
+
+#include <cstddef>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class MappedPackage maps a package file (such as an .xlsx workbook) into memory, read-only.
+* @details The pages are read by the system when they are touched, so mapping a file costs nothing until
+*          its bytes are used, and the parts which are never read are never loaded. The mapping is shared
+*          by the readers on all the threads.
+* @note Open() fails for an empty file, and for a file larger than the address space (on a 32-bit
+*       process); the caller reads the file by FileSource then.
+*/
+class MappedPackage : public Noncopyable
+{
+public:
+    MappedPackage();
+    ~MappedPackage();
+
+    bool Open(const ELstring &filename);
+
+    void Close();
+
+    bool IsOpen() const
+    {
+        return m_data != NULL;
+    }
+
+    const unsigned char* Data() const
+    {
+        return m_data;
+    }
+
+    size_t Size() const
+    {
+        return m_size;
+    }
+
+    /*!
+    * @brief Get the bytes [offset, offset + size) of the file.
+    * @return NULL if the range is not in the file.
+    */
+    const unsigned char* GetSpan(long long offset, long long size) const
+    {
+        if (offset < 0 || size < 0 || offset > static_cast<long long>(m_size) ||
+            size > static_cast<long long>(m_size) - offset)
+            return NULL;
+
+        return m_data + static_cast<size_t>(offset);
+    }
+
+private:
+    const unsigned char *m_data;
+    size_t               m_size;
+#ifdef _WIN32
+    void                *m_mapping;     // HANDLE of the file mapping object
+#endif
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //MAPPEDPACKAGE_H_GUID_C64A1F0E_7B3D_4E28_95A6_2D8E0B71F4C3
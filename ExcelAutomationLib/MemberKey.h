@@ -0,0 +1,94 @@
+﻿/*!
+* @file    MemberKey.h
+* @brief   Header file for struct MemberKey and class MemberKeyStore
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef MEMBERKEY_H_GUID_4A9D27E6_1B85_4C3F_8E70_F26C0B5D9A13
+#define MEMBERKEY_H_GUID_4A9D27E6_1B85_4C3F_8E70_F26C0B5D9A13
+
+
+#include <windows.h>
+#include <cwchar>
+#include <set>
+#include <string>
+#include "LibDef.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Struct MemberKey names a member of an Excel type, as the key of the caches of DispIdCache and
+*        VtableBinding.
+* @details The key only points to the names, and compares them by content, so a lookup does not
+*          allocate. A key which is stored in a cache must point to names owned by a MemberKeyStore.
+*/
+struct MemberKey
+{
+    MemberKey(LPCOLESTR typeName, LPCOLESTR name, int kind = 0): typeName(typeName), name(name), kind(kind)
+    {
+    }
+
+    bool operator < (const MemberKey &other) const
+    {
+        int diff = std::wcscmp(typeName, other.typeName);
+        if (diff == 0)
+            diff = std::wcscmp(name, other.name);
+
+        return (diff != 0) ? (diff < 0) : (kind < other.kind);
+    }
+
+    LPCOLESTR typeName;     // name of the Excel type, such as "Range"
+    LPCOLESTR name;         // name of the member, such as "Value"
+    int       kind;         // what the cache tells apart, such as the invoke kind
+};
+
+
+/*!
+* @internal
+* @brief Class MemberKeyStore owns the names which the stored keys of a cache point to.
+* @details Each name is stored once, however many keys point to it; the names are few (the members the 
+*          library calls), so they are kept until Clear(). It is not thread-safe: the cache which owns it
+*          locks it together with its entries.
+*/
+class MemberKeyStore : public Noncopyable
+{
+public:
+    /*!
+    * @brief Return a copy of @e key which points to names owned by this object.
+    */
+    MemberKey Store(const MemberKey &key)
+    {
+        return MemberKey(StoreName(key.typeName), StoreName(key.name), key.kind);
+    }
+
+    /*!
+    * @brief Forget all the names. The keys returned by Store() must not be used any more.
+    */
+    void Clear()
+    {
+        m_names.clear();
+    }
+
+private:
+    LPCOLESTR StoreName(LPCOLESTR name)
+    {
+        // the elements of a std::set never move, so the pointer stays valid
+        return m_names.insert(std::wstring(name)).first->c_str();
+    }
+
+    std::set<std::wstring> m_names;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //MEMBERKEY_H_GUID_4A9D27E6_1B85_4C3F_8E70_F26C0B5D9A13
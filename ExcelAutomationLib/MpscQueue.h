@@ -0,0 +1,126 @@
+﻿/*!
+* @file    MpscQueue.h
+* @brief   Header file for class MpscQueue
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef MPSCQUEUE_H_GUID_A85C3F17_2E94_4B6D_8C01_5D7E9B24F6A3
+#define MPSCQUEUE_H_GUID_A85C3F17_2E94_4B6D_8C01_5D7E9B24F6A3
+
+
+#include <cstddef>
+#include "LibDef.h"
+#include "AtomicsUtil.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class MpscQueue is a lock-free queue which many threads can push to, and one thread pops from.
+* @details It is intrusive: a node is the item itself, so neither a push nor a pop allocates. A push is
+*          one atomic exchange, and never waits for the other threads. @n
+*          A node is linked to the previous one just after the exchange; if the consumer comes in between,
+*          Pop() returns NULL as if the queue is empty. The consumer must not take it as the end: it has to
+*          try again when the producer has finished the push (see TaskExecutor, which is woken after it).
+* @note The queue does not own the nodes. A node must not be pushed again before it is popped.
+*/
+class MpscQueue : public Noncopyable
+{
+public:
+    struct Node
+    {
+        Node * volatile next;
+    };
+
+public:
+    MpscQueue(): m_head(&m_stub), m_tail(&m_stub)
+    {
+        m_stub.next = NULL;
+    }
+
+    /*!
+    * @brief Add a node at the end of the queue. Any thread can call it.
+    */
+    void Push(Node *node)
+    {
+        node->next = NULL;
+
+        // the exchange publishes the node, and orders the writes to it before
+        Node *prev = static_cast<Node*>(AtomicsUtil::ExchangePointer(Address(&m_head), node));
+
+        AtomicsUtil::StorePointer(Address(&prev->next), node);
+    }
+
+    /*!
+    * @brief Take the node at the front of the queue. Only the consumer thread can call it.
+    * @return NULL if the queue is empty, or a push is not finished yet
+    */
+    Node* Pop()
+    {
+        Node *tail = m_tail;
+        Node *next = Next(tail);
+
+        // skip the stub
+        if (tail == &m_stub)
+        {
+            if (next == NULL)
+                return NULL;
+
+            m_tail = next;
+            tail = next;
+            next = Next(next);
+        }
+
+        if (next != NULL)
+        {
+            m_tail = next;
+            return tail;
+        }
+
+        // tail is the last node linked: it can be taken only if no push is going on after it
+        if (tail != AtomicsUtil::LoadPointer(Address(&m_head)))
+            return NULL;
+
+        // put the stub behind it, so that the queue is never empty of nodes
+        Push(&m_stub);
+
+        next = Next(tail);
+        if (next != NULL)
+        {
+            m_tail = next;
+            return tail;
+        }
+
+        return NULL;
+    }
+
+private:
+    static void * volatile * Address(Node * volatile *p)
+    {
+        return reinterpret_cast<void * volatile *>(p);
+    }
+
+    static Node* Next(Node *node)
+    {
+        return static_cast<Node*>(AtomicsUtil::LoadPointer(Address(&node->next)));
+    }
+
+private:
+    Node * volatile m_head;                             // the last node pushed, written by the producers
+    char            m_pad[64 - sizeof(Node*)];          // keeps m_head and m_tail on different cache lines
+    Node           *m_tail;                             // the next node to pop, owned by the consumer
+    Node            m_stub;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //MPSCQUEUE_H_GUID_A85C3F17_2E94_4B6D_8C01_5D7E9B24F6A3
@@ -0,0 +1,660 @@
+﻿/*!
+* @file    NativeSheet.cpp
+* @brief   Implementation file for class NativeSheet, NativeRowValues and NativeSheetBuilder
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "NativeSheet.h"
+#include "RangeCodec.h"
+#include "ExcelUtil.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // the codes are the values of the xlErrXxx constants
+    const struct
+    {
+        const char *text;
+        int         code;
+    } s_errors[] = {
+        { "#NULL!", 2000 }, { "#DIV/0!", 2007 }, { "#VALUE!", 2015 }, { "#REF!", 2023 },
+        { "#NAME?", 2029 }, { "#NUM!", 2036 }, { "#N/A", 2042 },
+    };
+
+    bool CellLess(const NativeCell &lhs, const NativeCell &rhs)
+    {
+        return lhs.row < rhs.row || (lhs.row == rhs.row && lhs.column < rhs.column);
+    }
+
+    void AppendAscii(ELstring &out, const char *text)
+    {
+        for (; *text != '\0'; ++text)
+            out.push_back(static_cast<ELchar>(*text));
+    }
+
+    // Format a number as Excel's "General" format does for a value in a cell (15 significant digits)
+    void FormatNumber(double value, char (&buffer)[32])
+    {
+#ifdef _MSC_VER
+        sprintf_s(buffer, sizeof(buffer), "%.15G", value);
+#else
+        snprintf(buffer, sizeof(buffer), "%.15G", value);
+#endif
+    }
+
+    // Format an OLE Automation date as "YYYY-MM-DD hh:mm:ss", without the part which is zero
+    void FormatDate(double value, char (&buffer)[32])
+    {
+        long days = static_cast<long>(std::floor(value));
+        long seconds = static_cast<long>(std::floor((value - days) * 86400.0 + 0.5));
+        if (seconds >= 86400)
+        {
+            ++days;
+            seconds -= 86400;
+        }
+
+        // days since 1899-12-30 => civil date (H. Hinnant's algorithm, from 0000-03-01)
+        long z = days + 693899;
+        long era = (z >= 0 ? z : z - 146096) / 146097;
+        long doe = z - era * 146097;
+        long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        long mp = (5 * doy + 2) / 153;
+        long day = doy - (153 * mp + 2) / 5 + 1;
+        long month = (mp < 10 ? mp + 3 : mp - 9);
+        long year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+        int n = 0;
+#ifdef _MSC_VER
+        if (days != 0 || seconds == 0)
+            n = sprintf_s(buffer, sizeof(buffer), "%04ld-%02ld-%02ld", year, month, day);
+        if (seconds != 0)
+            sprintf_s(buffer + n, sizeof(buffer) - n, n == 0 ? "%02ld:%02ld:%02ld" : " %02ld:%02ld:%02ld", 
+                seconds / 3600, seconds / 60 % 60, seconds % 60);
+#else
+        if (days != 0 || seconds == 0)
+            n = snprintf(buffer, sizeof(buffer), "%04ld-%02ld-%02ld", year, month, day);
+        if (seconds != 0)
+            snprintf(buffer + n, sizeof(buffer) - n, n == 0 ? "%02ld:%02ld:%02ld" : " %02ld:%02ld:%02ld", 
+                seconds / 3600, seconds / 60 % 60, seconds % 60);
+#endif
+    }
+}
+
+
+void NativeSheet::Add(int row, int column, NativeCellType type, double number, size_t index)
+{
+    NativeCell cell;
+    cell.row = row;
+    cell.column = column;
+    cell.type = type;
+    cell.number = number;
+    cell.index = index;
+
+    if (!m_cells.empty() && !CellLess(m_cells.back(), cell))
+        m_sorted = false;
+
+    m_cells.push_back(cell);
+}
+
+
+void NativeSheet::AddNumber(int row, int column, NativeCellType type, double number)
+{
+    assert(type == NCT_Number || type == NCT_Date || type == NCT_Bool);
+    Add(row, column, type, number, 0);
+}
+
+
+void NativeSheet::AddSharedString(int row, int column, size_t index)
+{
+    Add(row, column, NCT_SharedString, 0, index);
+}
+
+
+void NativeSheet::AddString(int row, int column, const char *text, size_t length)
+{
+    Add(row, column, NCT_String, 0, m_strings.Add(text, length));
+}
+
+
+void NativeSheet::AddError(int row, int column, const char *text, size_t length)
+{
+    Add(row, column, NCT_Error, GetErrorCode(text, length), m_strings.Add(text, length));
+}
+
+
+void NativeSheet::RemoveCells(size_t first)
+{
+    if (first >= m_cells.size())
+        return;
+
+    // the strings are added in the order of the cells
+    size_t strings = m_strings.Count();
+    for (size_t i = first; i < m_cells.size(); ++i)
+    {
+        if ((m_cells[i].type == NCT_String || m_cells[i].type == NCT_Error) && m_cells[i].index < strings)
+            strings = m_cells[i].index;
+    }
+
+    m_cells.resize(first);
+    m_strings.Truncate(strings);
+}
+
+
+void NativeSheet::Finish()
+{
+    if (!m_sorted)
+    {
+        // a cell given twice keeps the last value
+        std::stable_sort(m_cells.begin(), m_cells.end(), CellLess);
+
+        std::vector<NativeCell>::iterator out = m_cells.begin();
+        for (std::vector<NativeCell>::iterator it = m_cells.begin(); it != m_cells.end(); ++it)
+        {
+            if (it + 1 != m_cells.end() && !CellLess(*it, *(it + 1)))
+                continue;
+            *out++ = *it;
+        }
+        m_cells.erase(out, m_cells.end());
+
+        m_sorted = true;
+    }
+
+    // the vector is filled once and then only read
+    std::vector<NativeCell>(m_cells).swap(m_cells);
+}
+
+
+void NativeSheet::Clear()
+{
+    std::vector<NativeCell>().swap(m_cells);
+    m_strings.Clear();
+    m_sorted = true;
+}
+
+
+size_t NativeSheet::LowerBound(int row, int column) const
+{
+    NativeCell key;
+    key.row = row;
+    key.column = column;
+
+    return std::lower_bound(m_cells.begin(), m_cells.end(), key, CellLess) - m_cells.begin();
+}
+
+
+const NativeCell* NativeSheet::FindCell(int row, int column) const
+{
+    size_t index = LowerBound(row, column);
+    if (index == m_cells.size() || m_cells[index].row != row || m_cells[index].column != column)
+        return NULL;
+
+    return &m_cells[index];
+}
+
+
+void NativeSheet::GetText(const NativeCell &cell, const char *&text, size_t &length) const
+{
+    if (cell.type == NCT_SharedString)
+    {
+        assert(m_sharedStrings);
+        if (m_sharedStrings != NULL && cell.index < m_sharedStrings->Count())
+        {
+            m_sharedStrings->Get(cell.index, text, length);
+            return;
+        }
+
+        text = "";      // a broken index
+        length = 0;
+        return;
+    }
+
+    assert(cell.type == NCT_String || cell.type == NCT_Error);
+    m_strings.Get(cell.index, text, length);
+}
+
+
+void NativeSheet::FormatValue(const NativeCell *cell, ELstring &value) const
+{
+    value.clear();
+    if (cell == NULL)
+        return;
+
+    char buffer[32];
+    switch (cell->type)
+    {
+    case NCT_Number:
+        FormatNumber(cell->number, buffer);
+        AppendAscii(value, buffer);
+        break;
+
+    case NCT_Date:
+        FormatDate(cell->number, buffer);
+        AppendAscii(value, buffer);
+        break;
+
+    case NCT_Bool:
+        // as VariantChangeType() converts a VT_BOOL to a string
+        AppendAscii(value, cell->number != 0 ? "-1" : "0");
+        break;
+
+    default:
+        {
+            const char *text;
+            size_t length;
+            GetText(*cell, text, length);
+            Utf8::Append(value, text, length);
+        }
+        break;
+    }
+}
+
+
+void NativeSheet::GetValue(const NativeCell *cell, ExcelValue &value) const
+{
+    if (cell == NULL)
+    {
+        value.Clear();
+        return;
+    }
+
+    switch (cell->type)
+    {
+    case NCT_Number:
+        value.SetDouble(cell->number);
+        break;
+
+    case NCT_Date:
+        value.SetDate(cell->number);
+        break;
+
+    case NCT_Bool:
+        value.SetBool(cell->number != 0);
+        break;
+
+    case NCT_Error:
+        // an error unknown to COM is kept as text
+        if (cell->number != 0)
+        {
+            // the SCODE of a VT_ERROR VARIANT which Excel returns for a cell error
+            value.SetError(static_cast<int>(0x800A0000UL | static_cast<unsigned long>(cell->number)));
+            break;
+        }
+        // fall through
+
+    default:
+        {
+            const char *text;
+            size_t length;
+            GetText(*cell, text, length);
+
+            ELstring str;
+            Utf8::Append(str, text, length);
+            value.SetString(str);
+        }
+        break;
+    }
+}
+
+
+void NativeSheet::GetRangeValues(int rowFrom, int columnFrom, int rowTo, int columnTo, std::vector<ExcelValue> &values) const
+{
+    assert(rowFrom <= rowTo && columnFrom <= columnTo);
+
+    size_t columns = columnTo - columnFrom + 1;
+    values.resize((rowTo - rowFrom + 1) * columns);
+
+    for (int row = rowFrom; row <= rowTo; ++row)
+    {
+        ExcelValue *rowValues = &values[(row - rowFrom) * columns];
+        size_t index = LowerBound(row, columnFrom);
+        for (int column = columnFrom; column <= columnTo; ++column)
+        {
+            const NativeCell *cell = NULL;
+            if (index < m_cells.size() && m_cells[index].row == row && m_cells[index].column == column)
+                cell = &m_cells[index++];
+
+            GetValue(cell, rowValues[column - columnFrom]);
+        }
+    }
+}
+
+
+bool NativeSheet::ReadColumns(int rowFrom, int columnFrom, int rowTo, int columnTo, std::vector<ExcelColumn> &columns) const
+{
+    assert(rowFrom <= rowTo && columnFrom <= columnTo);
+
+    if (!ExcelUtil::PrepareColumns(columns, columnTo - columnFrom + 1, rowTo - rowFrom + 1))
+        return false;
+
+    for (int row = rowFrom; row <= rowTo; ++row)
+    {
+        size_t entry = row - rowFrom;
+        for (size_t index = LowerBound(row, columnFrom);
+            index < m_cells.size() && m_cells[index].row == row && m_cells[index].column <= columnTo; ++index)
+        {
+            const NativeCell &cell = m_cells[index];
+            ExcelColumn &column = columns[cell.column - columnFrom];
+
+            switch (cell.type)
+            {
+            case NCT_Number:
+            case NCT_Date:
+            case NCT_Bool:
+                if (column.type == ECT_String)
+                {
+                    FormatValue(&cell, column.strings[entry]);
+                    column.valid[entry] = true;
+                }
+                else
+                {
+                    ExcelUtil::SetColumnNumber(column, entry, cell.number);
+                }
+                break;
+
+            case NCT_Error:
+                break;      // not valid
+
+            default:
+                if (column.type == ECT_String)
+                {
+                    const char *text;
+                    size_t length;
+                    GetText(cell, text, length);
+                    Utf8::Append(column.strings[entry], text, length);
+                    column.valid[entry] = true;
+                }
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+void NativeSheet::EncodeRange(int rowFrom, int columnFrom, int rowTo, int columnTo, ELstring &data) const
+{
+    assert(rowFrom <= rowTo && columnFrom <= columnTo);
+
+    ELstring encoded;
+    ELstring value;
+
+    // Encoding format: <row>#<column>#
+    RangeCodec::AppendNumber(encoded, rowTo - rowFrom + 1);
+    RangeCodec::AppendNumber(encoded, columnTo - columnFrom + 1);
+
+    for (int row = rowFrom; row <= rowTo; ++row)
+    {
+        size_t index = LowerBound(row, columnFrom);
+        for (int column = columnFrom; column <= columnTo; ++column)
+        {
+            const NativeCell *cell = NULL;
+            if (index < m_cells.size() && m_cells[index].row == row && m_cells[index].column == column)
+                cell = &m_cells[index++];
+
+            FormatValue(cell, value);
+
+            // Encoding format: <number of characters>#<characters>
+            RangeCodec::AppendValue(encoded, value.data(), value.length());
+        }
+    }
+
+    data.swap(encoded);
+}
+
+
+void NativeSheet::EncodeRangeTyped(int rowFrom, int columnFrom, int rowTo, int columnTo, ExcelTypedWriter &writer) const
+{
+    assert(rowFrom <= rowTo && columnFrom <= columnTo);
+
+    writer.Begin(rowTo - rowFrom + 1, columnTo - columnFrom + 1);
+
+    for (int row = rowFrom; row <= rowTo; ++row)
+    {
+        size_t index = LowerBound(row, columnFrom);
+        for (int column = columnFrom; column <= columnTo; ++column)
+        {
+            if (index == m_cells.size() || m_cells[index].row != row || m_cells[index].column != column)
+            {
+                writer.PutEmpty();
+                continue;
+            }
+
+            const NativeCell &cell = m_cells[index++];
+            switch (cell.type)
+            {
+            case NCT_Number:
+                writer.PutDouble(cell.number);
+                break;
+
+            case NCT_Date:
+                writer.PutDate(cell.number);
+                break;
+
+            case NCT_Bool:
+                writer.PutBool(cell.number != 0);
+                break;
+
+            case NCT_Error:
+                // an error unknown to COM is kept as text
+                if (cell.number != 0)
+                {
+                    // the SCODE of a VT_ERROR VARIANT which Excel returns for a cell error
+                    writer.PutError(static_cast<int>(0x800A0000UL | static_cast<unsigned long>(cell.number)));
+                    break;
+                }
+                // fall through
+
+            default:
+                {
+                    const char *text;
+                    size_t length;
+                    GetText(cell, text, length);
+                    writer.PutStringUtf8(text, length);
+                }
+                break;
+            }
+        }
+    }
+}
+
+
+int NativeSheet::GetErrorCode(const char *text, size_t length)
+{
+    std::string str(text, length);
+    for (size_t i = 0; i < sizeof(s_errors) / sizeof(s_errors[0]); ++i)
+    {
+        if (str == s_errors[i].text)
+            return s_errors[i].code;
+    }
+
+    return 0;
+}
+
+
+const char* NativeSheet::GetErrorText(int code)
+{
+    for (size_t i = 0; i < sizeof(s_errors) / sizeof(s_errors[0]); ++i)
+    {
+        if (code == s_errors[i].code)
+            return s_errors[i].text;
+    }
+
+    return NULL;
+}
+
+
+bool NativeSheet::IsBuiltInDateFormat(int id)
+{
+    return (id >= 14 && id <= 22) || (id >= 27 && id <= 36) || (id >= 45 && id <= 47) || (id >= 50 && id <= 58);
+}
+
+
+bool NativeSheet::IsDateFormatCode(const std::string &code)
+{
+    for (size_t i = 0; i < code.length(); ++i)
+    {
+        char ch = code[i];
+        switch (ch)
+        {
+        case '"':           // literal text
+            i = code.find('"', i + 1);
+            if (i == std::string::npos)
+                return false;
+            break;
+
+        case '\\':          // an escaped character
+        case '_':           // a space as wide as the next character
+        case '*':           // repeat the next character
+            ++i;
+            break;
+
+        case '[':           // a color, a condition or a locale; [h], [m] and [s] are elapsed times
+            {
+                std::string::size_type end = code.find(']', i);
+                if (end == std::string::npos)
+                    return false;
+
+                std::string section = code.substr(i + 1, end - i - 1);
+                if (!section.empty() && strchr("hHmMsS", section[0]) != NULL && 
+                    section.find_first_not_of(section[0]) == std::string::npos)
+                    return true;
+                i = end;
+            }
+            break;
+
+        case ';':           // only the format of positive numbers counts
+            return false;
+
+        default:
+            if (strchr("dDmMyYhHsS", ch) != NULL)
+                return true;
+            break;
+        }
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class NativeRowValues
+
+// The cells of a row are few and may be unordered while the sheet is read, so they are searched one by one
+const NativeCell* NativeRowValues::Find(int column) const
+{
+    for (size_t i = m_first; i < m_last; ++i)
+    {
+        if (m_sheet.GetCell(i).column == column)
+            return &m_sheet.GetCell(i);
+    }
+
+    return NULL;
+}
+
+
+void NativeRowValues::GetText(int column, ELstring &text) const
+{
+    m_sheet.FormatValue(Find(column), text);
+}
+
+
+bool NativeRowValues::GetNumber(int column, double &number) const
+{
+    const NativeCell *cell = Find(column);
+    if (cell == NULL)
+        return false;
+
+    switch (cell->type)
+    {
+    case NCT_Number:
+    case NCT_Date:
+        number = cell->number;
+        return true;
+
+    case NCT_Bool:
+        number = (cell->number != 0 ? -1 : 0);    // as the text is
+        return true;
+
+    case NCT_Error:
+        return false;
+
+    default:
+        {
+            ELstring text;
+            m_sheet.FormatValue(cell, text);
+            return RowQueryFilter::ParseNumber(text, number);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class NativeSheetBuilder
+
+bool NativeSheetBuilder::Wants(unsigned long row, unsigned long column)
+{
+    int number = static_cast<int>(row) + 1;
+    if (number != m_row)
+    {
+        FinishRow();
+        m_row = number;
+        m_rowFirstCell = m_sheet.CountCells();
+    }
+
+    return m_filter == NULL ||
+        (m_filter->IsWantedRow(m_row) && m_filter->IsWantedColumn(static_cast<int>(column) + 1));
+}
+
+
+void NativeSheetBuilder::AddNumber(unsigned long column, unsigned long style, double number)
+{
+    int col = static_cast<int>(column) + 1;
+    if (style < m_dateStyles.size() && m_dateStyles[style])
+        m_sheet.AddNumber(m_row, col, NCT_Date, NativeSheet::SerialToDate(number, m_date1904));
+    else
+        m_sheet.AddNumber(m_row, col, NCT_Number, number);
+}
+
+
+void NativeSheetBuilder::AddBool(unsigned long column, bool value)
+{
+    m_sheet.AddNumber(m_row, static_cast<int>(column) + 1, NCT_Bool, value ? 1 : 0);
+}
+
+
+void NativeSheetBuilder::AddError(unsigned long column, unsigned long code)
+{
+    // the codes of BIFF are the xlErrXxx constants less 2000
+    const char *text = NativeSheet::GetErrorText(static_cast<int>(2000 + code));
+    if (text != NULL)
+        m_sheet.AddError(m_row, static_cast<int>(column) + 1, text, strlen(text));
+}
+
+
+void NativeSheetBuilder::FinishRow()
+{
+    if (m_filter == NULL || !m_filter->IsWantedRow(m_row) || m_sheet.CountCells() == m_rowFirstCell)
+        return;
+
+    NativeRowValues values(m_sheet, m_rowFirstCell, m_sheet.CountCells());
+    if (!m_filter->AcceptCondition(m_row, values))
+        m_sheet.RemoveCells(m_rowFirstCell);
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
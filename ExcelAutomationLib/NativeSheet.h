@@ -0,0 +1,356 @@
+﻿/*!
+* @file    NativeSheet.h
+* @brief   Header file for class NativeStringPool, NativeSheet, NativeRowValues and NativeSheetBuilder
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef NATIVESHEET_H_GUID_FCE2954F_8049_48C0_B3EC_5C08351D66C0
+#define NATIVESHEET_H_GUID_FCE2954F_8049_48C0_B3EC_5C08351D66C0
+
+
+#include <string>
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "Noncopyable.h"
+#include "ExcelTypedCodec.h"
+#include "ExcelValue.h"
+#include "ExcelColumns.h"
+#include "RowQueryFilter.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class NativeStringPool stores many UTF-8 strings in one buffer.
+*/
+class NativeStringPool : public Noncopyable
+{
+public:
+    NativeStringPool()
+    {
+        m_offsets.push_back(0);
+    }
+
+    size_t Count() const
+    {
+        return m_offsets.size() - 1;
+    }
+
+    /*!
+    * @return Index of the new string.
+    */
+    size_t Add(const char *text, size_t length)
+    {
+        m_chars.insert(m_chars.end(), text, text + length);
+        m_offsets.push_back(m_chars.size());
+        return m_offsets.size() - 2;
+    }
+
+    void Get(size_t index, const char *&text, size_t &length) const
+    {
+        static const char empty = '\0';
+
+        length = m_offsets[index + 1] - m_offsets[index];
+        text = (length == 0 ? &empty : &m_chars[m_offsets[index]]);
+    }
+
+    void Clear()
+    {
+        m_chars.clear();
+        m_offsets.resize(1);
+    }
+
+    /*!
+    * @brief Remove the strings from @e count on.
+    */
+    void Truncate(size_t count)
+    {
+        if (count < Count())
+        {
+            m_chars.resize(m_offsets[count]);
+            m_offsets.resize(count + 1);
+        }
+    }
+
+private:
+    std::vector<char>   m_chars;
+    std::vector<size_t> m_offsets;      // string i is [m_offsets[i], m_offsets[i + 1]) of m_chars
+};
+
+
+/*!
+* @internal
+* @brief Types of the values in a NativeSheet
+*/
+enum NativeCellType
+{
+    NCT_Number,
+    NCT_Date,           // number is an OLE Automation date
+    NCT_Bool,           // number is 0 or 1
+    NCT_SharedString,   // index is in the shared strings of the workbook
+    NCT_String,         // index is in the strings of the sheet
+    NCT_Error           // number is the error code (such as 2042 for #N/A, 0 if unknown), index is the text
+};
+
+
+/*!
+* @internal
+* @brief A non-empty cell of a NativeSheet. Rows and columns start from 1, as in Excel.
+*/
+struct NativeCell
+{
+    int            row;
+    int            column;
+    NativeCellType type;
+    double         number;
+    size_t         index;
+};
+
+
+/*!
+* @internal
+* @brief Class NativeSheet holds the values of a worksheet read from a workbook file.
+* @details Only the non-empty cells are stored, ordered by row and column, in one vector. The strings of
+*          the cells are UTF-8 and converted only when a value is read.
+*/
+class NativeSheet : public Noncopyable
+{
+public:
+    NativeSheet(): m_sharedStrings(NULL), m_sorted(true) { }
+
+    /*!
+    * @brief Set the shared strings of the workbook, which must outlive the sheet.
+    */
+    void SetSharedStrings(const NativeStringPool *sharedStrings)
+    {
+        m_sharedStrings = sharedStrings;
+    }
+
+    // <begin> Used by the readers to fill the sheet
+    void AddNumber(int row, int column, NativeCellType type, double number);
+    void AddSharedString(int row, int column, size_t index);
+    void AddString(int row, int column, const char *text, size_t length);
+    void AddError(int row, int column, const char *text, size_t length);
+
+    /*!
+    * @brief Remove the cells from @e first on, with their strings. Used to drop a row which is not wanted.
+    */
+    void RemoveCells(size_t first);
+
+    /*!
+    * @brief Called after the last cell is added.
+    */
+    void Finish();
+    // <end> Used by the readers to fill the sheet
+
+    void Clear();
+
+    size_t CountCells() const
+    {
+        return m_cells.size();
+    }
+
+    /*!
+    * @brief Get a cell by index, the cells are ordered by row and column after Finish().
+    */
+    const NativeCell& GetCell(size_t index) const
+    {
+        return m_cells[index];
+    }
+
+    /*!
+    * @return NULL if the cell is empty.
+    */
+    const NativeCell* FindCell(int row, int column) const;
+
+    /*!
+    * @brief Get the text of a string or error cell.
+    */
+    void GetText(const NativeCell &cell, const char *&text, size_t &length) const;
+
+    /*!
+    * @brief Encode the values of a range in the string form of ExcelRange::ReadData().
+    */
+    void EncodeRange(int rowFrom, int columnFrom, int rowTo, int columnTo, ELstring &data) const;
+
+    /*!
+    * @brief Encode the values of a range in the typed binary encoding of ExcelRange::ReadTyped().
+    */
+    void EncodeRangeTyped(int rowFrom, int columnFrom, int rowTo, int columnTo, ExcelTypedWriter &writer) const;
+
+    /*!
+    * @brief Format a value as ExcelRange::ReadData() does; an empty cell (NULL) is an empty string.
+    */
+    void FormatValue(const NativeCell *cell, ELstring &value) const;
+
+    /*!
+    * @brief Get a value with its type, as ExcelCell::GetValue(ExcelValue&) does; an empty cell (NULL) is an
+    *        empty value. An error unknown to COM is a string.
+    */
+    void GetValue(const NativeCell *cell, ExcelValue &value) const;
+
+    /*!
+    * @brief Get the values of a range, row by row, as ExcelRange::ReadValues() does.
+    */
+    void GetRangeValues(int rowFrom, int columnFrom, int rowTo, int columnTo, std::vector<ExcelValue> &values) const;
+
+    /*!
+    * @brief Read the values of a range into typed column buffers, as ExcelRange::ReadColumns() does.
+    *        Only the non-empty cells are visited.
+    * @return false if the number of buffers is not the number of columns of the range.
+    */
+    bool ReadColumns(int rowFrom, int columnFrom, int rowTo, int columnTo, std::vector<ExcelColumn> &columns) const;
+
+    /*!
+    * @brief Map the text of an error to its code (the value of the xlErrXxx constant).
+    * @return 0 if the error is unknown.
+    */
+    static int GetErrorCode(const char *text, size_t length);
+
+    /*!
+    * @brief Map the code of an error to its text.
+    * @return NULL if the code is unknown.
+    */
+    static const char* GetErrorText(int code);
+
+    /*!
+    * @brief Convert a serial date of a workbook file to an OLE Automation date.
+    * @param [in] date1904 Whether the dates of the workbook are days since 1904-01-01 instead of 1900-01-01.
+    */
+    static double SerialToDate(double serial, bool date1904)
+    {
+        if (date1904)
+            return serial + 1462;
+        return serial < 60 ? serial + 1 : serial;    // Excel takes 1900 as a leap year, OLE Automation does not
+    }
+
+    /*!
+    * @brief Whether a built-in number format (by its id) shows a date or a time.
+    */
+    static bool IsBuiltInDateFormat(int id);
+
+    /*!
+    * @brief Whether a custom number format code shows a date or a time, e.g. "yyyy\-mm\-dd" or "[$-409]h:mm AM/PM".
+    */
+    static bool IsDateFormatCode(const std::string &code);
+
+private:
+    void Add(int row, int column, NativeCellType type, double number, size_t index);
+
+    // Index of the first cell at or after (row, column)
+    size_t LowerBound(int row, int column) const;
+
+private:
+    std::vector<NativeCell>  m_cells;
+    NativeStringPool         m_strings;
+    const NativeStringPool  *m_sharedStrings;
+    bool                     m_sorted;
+};
+
+
+/*!
+* @internal
+* @brief Class NativeRowValues gives the cells of one row of a NativeSheet to a RowQueryFilter.
+*/
+class NativeRowValues : public RowValues
+{
+public:
+    /*!
+    * @param [in] first, last The cells of the row are [first, last) of @e sheet.
+    */
+    NativeRowValues(const NativeSheet &sheet, size_t first, size_t last): 
+        m_sheet(sheet), m_first(first), m_last(last)
+    {
+    }
+
+    virtual void GetText(int column, ELstring &text) const;
+    virtual bool GetNumber(int column, double &number) const;
+
+private:
+    const NativeCell* Find(int column) const;
+
+    NativeRowValues& operator = (const NativeRowValues &);
+
+private:
+    const NativeSheet &m_sheet;
+    size_t             m_first;
+    size_t             m_last;
+};
+
+
+/*!
+* @internal
+* @brief Class NativeSheetBuilder adds the cells of a binary worksheet (BIFF8 or BIFF12) to a NativeSheet.
+* @details The rows and the columns are 0-based, as they are in the records. With a filter, the cells
+*          which are not wanted are not decoded, and a row which does not meet the condition is removed
+*          when the cells of the next row start, so the rows must come in order as they do in the files.
+*/
+class NativeSheetBuilder
+{
+public:
+    NativeSheetBuilder(NativeSheet &sheet, const std::vector<bool> &dateStyles, bool date1904,
+        const RowQueryFilter *filter):
+        m_sheet(sheet), m_dateStyles(dateStyles), m_date1904(date1904), m_filter(filter), m_row(0), m_rowFirstCell(0)
+    {
+    }
+
+    /*!
+    * @brief Whether a cell is wanted. Called for every cell, in order.
+    */
+    bool Wants(unsigned long row, unsigned long column);
+
+    /*!
+    * @brief Whether the rows after the current one are not wanted.
+    */
+    bool IsDone() const
+    {
+        return m_filter != NULL && m_filter->IsPastRows(m_row);
+    }
+
+    // <begin> Add a value to the current row
+    void AddNumber(unsigned long column, unsigned long style, double number);
+    void AddBool(unsigned long column, bool value);
+
+    // @param [in] code The error code of the file format, such as 0x2A for #N/A
+    void AddError(unsigned long column, unsigned long code);
+
+    void AddSharedString(unsigned long column, size_t index)
+    {
+        m_sheet.AddSharedString(m_row, static_cast<int>(column) + 1, index);
+    }
+
+    void AddString(unsigned long column, const std::string &text)
+    {
+        m_sheet.AddString(m_row, static_cast<int>(column) + 1, text.data(), text.length());
+    }
+    // <end> Add a value to the current row
+
+    /*!
+    * @brief Apply the condition of the filter to the current row. Called after the last cell.
+    */
+    void FinishRow();
+
+private:
+    NativeSheetBuilder& operator = (const NativeSheetBuilder &);
+
+private:
+    NativeSheet             &m_sheet;
+    const std::vector<bool> &m_dateStyles;      // whether a style (by index) has a date format
+    bool                     m_date1904;
+    const RowQueryFilter    *m_filter;
+    int                      m_row;             // of the current cell, starts from 1
+    size_t                   m_rowFirstCell;    // index of the first cell of the row in the sheet
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //NATIVESHEET_H_GUID_FCE2954F_8049_48C0_B3EC_5C08351D66C0
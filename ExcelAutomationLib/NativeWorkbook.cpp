@@ -0,0 +1,574 @@
+﻿/*!
+* @file    NativeWorkbook.cpp
+* @brief   Implementation file for the native bodies of ExcelWorkbook, ExcelWorksheetSet, ExcelWorksheet, ExcelRange and ExcelCell
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <algorithm>
+#include "NativeWorkbook.h"
+#include "ParallelTasks.h"
+#include "ExcelTypedCodec.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // 'A' => 1, ..., 'Z' => 26; 0 for other characters
+    int ColumnNumber(ELchar column)
+    {
+        if (column >= ELtext('a') && column <= ELtext('z'))
+            return column - ELtext('a') + 1;
+        if (column >= ELtext('A') && column <= ELtext('Z'))
+            return column - ELtext('A') + 1;
+        return 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class NativeWorkbookImpl
+
+NativeWorkbookImpl::NativeWorkbookImpl(NativeWorkbookSource *source, int maxResidentSheets /* = 0 */): 
+    m_source(source), m_sheets(source->CountSheets(), static_cast<NativeSheet*>(NULL)),
+    m_lastUse(source->CountSheets(), 0), m_useCount(0), m_maxResidentSheets(maxResidentSheets)
+{
+    assert(source);
+}
+
+
+NativeWorkbookImpl::~NativeWorkbookImpl()
+{
+    Close();
+}
+
+
+ELstring NativeWorkbookImpl::GetSheetName(int index) const
+{
+    if (m_source == NULL || index < 0 || index >= m_source->CountSheets())
+        return ELstring();
+
+    return Utf8::ToELstring(m_source->GetSheetName(index));
+}
+
+
+const NativeSheet* NativeWorkbookImpl::GetSheet(int index)
+{
+    if (m_source == NULL || index < 0 || index >= static_cast<int>(m_sheets.size()))
+        return NULL;
+
+    m_lastUse[index] = ++m_useCount;
+
+    if (m_sheets[index] == NULL)
+    {
+        if (!m_source->LoadSharedParts())
+            return NULL;
+
+        if (m_maxResidentSheets > 0)
+        {
+            int resident = static_cast<int>(m_sheets.size() - std::count(m_sheets.begin(), m_sheets.end(), 
+                static_cast<NativeSheet*>(NULL)));
+            if (resident >= m_maxResidentSheets)
+                ReleaseLeastRecentSheet();
+        }
+
+        LoadSheetTask(this, index);
+    }
+
+    return m_sheets[index];
+}
+
+
+const NativeSheet* NativeWorkbookImpl::FindSheet(int index)
+{
+    if (m_source == NULL || index < 0 || index >= static_cast<int>(m_sheets.size()) || m_sheets[index] == NULL)
+        return NULL;
+
+    m_lastUse[index] = ++m_useCount;
+    return m_sheets[index];
+}
+
+
+bool NativeWorkbookImpl::LoadSheet(int index, const RowQueryFilter &filter, NativeSheet &sheet)
+{
+    if (m_source == NULL || index < 0 || index >= static_cast<int>(m_sheets.size()) || !m_source->LoadSharedParts())
+        return false;
+
+    return m_source->LoadSheet(index, sheet, &filter);
+}
+
+
+bool NativeWorkbookImpl::LoadAllSheets(int parallelSheets)
+{
+    if (m_source == NULL || !m_source->LoadSharedParts())
+        return false;
+
+    // every task fills its own slot of m_sheets, the slots of the sheets already read are left alone
+    ParallelTasks::Run(static_cast<int>(m_sheets.size()), parallelSheets, LoadSheetTask, this);
+
+    for (size_t i = 0; i < m_sheets.size(); ++i)
+    {
+        if (m_sheets[i] == NULL)
+            return false;
+    }
+
+    return true;
+}
+
+
+void NativeWorkbookImpl::ReleaseLeastRecentSheet()
+{
+    int victim = -1;
+    for (size_t i = 0; i < m_sheets.size(); ++i)
+    {
+        if (m_sheets[i] != NULL && (victim < 0 || m_lastUse[i] < m_lastUse[victim]))
+            victim = static_cast<int>(i);
+    }
+
+    if (victim >= 0)
+    {
+        delete m_sheets[victim];
+        m_sheets[victim] = NULL;
+    }
+}
+
+
+// Read a worksheet into its slot of m_sheets, which stays NULL if it cannot be read
+void NativeWorkbookImpl::LoadSheetTask(void *context, int task)
+{
+    NativeWorkbookImpl *workbook = static_cast<NativeWorkbookImpl*>(context);
+    if (workbook->m_sheets[task] != NULL)
+        return;
+
+    NativeSheet *sheet = new NativeSheet;
+    if (!workbook->m_source->LoadSheet(task, *sheet, NULL))
+    {
+        delete sheet;
+        return;
+    }
+
+    workbook->m_sheets[task] = sheet;
+}
+
+
+ExcelWorksheet NativeWorkbookImpl::GetActiveWorksheet()
+{
+    if (CountSheets() == 0)
+        return ExcelWorksheet();
+
+    return ExcelWorksheetImpl::MakeHandle(new NativeWorksheetImpl(this, m_source->GetActiveSheet()));
+}
+
+
+ExcelWorksheetSet NativeWorkbookImpl::GetAllWorksheets()
+{
+    if (m_source == NULL)
+        return ExcelWorksheetSet();
+
+    return ExcelWorksheetSetImpl::MakeHandle(new NativeWorksheetSetImpl(this));
+}
+
+
+bool NativeWorkbookImpl::Save()
+{
+    return false;   // read-only
+}
+
+
+bool NativeWorkbookImpl::SaveAs(const ELstring &/*filename*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeWorkbookImpl::Close()
+{
+    for (size_t i = 0; i < m_sheets.size(); ++i)
+        delete m_sheets[i];
+    m_sheets.clear();
+    m_lastUse.clear();
+
+    delete m_source;
+    m_source = NULL;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class NativeWorksheetSetImpl
+
+NativeWorksheetSetImpl::NativeWorksheetSetImpl(NativeWorkbookImpl *workbook): 
+    m_handle(ExcelWorkbookImpl::MakeHandle(workbook)), m_workbook(workbook)
+{
+    assert(workbook);
+}
+
+
+int NativeWorksheetSetImpl::CountWorksheets()
+{
+    return m_workbook->CountSheets();
+}
+
+
+// @param [in] index Starts from 1, as Worksheets.Item of Excel
+ExcelWorksheet NativeWorksheetSetImpl::GetWorksheet(int index)
+{
+    if (index < 1 || index > m_workbook->CountSheets())
+        return ExcelWorksheet();
+
+    return ExcelWorksheetImpl::MakeHandle(new NativeWorksheetImpl(m_workbook, index - 1));
+}
+
+
+ExcelWorksheet NativeWorksheetSetImpl::AddWorksheet(ExcelWorksheet /*ref*/, bool /*after*/)
+{
+    return ExcelWorksheet();    // read-only
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class NativeWorksheetImpl
+
+NativeWorksheetImpl::NativeWorksheetImpl(NativeWorkbookImpl *workbook, int index): 
+    m_handle(ExcelWorkbookImpl::MakeHandle(workbook)), m_workbook(workbook), m_index(index)
+{
+    assert(workbook);
+}
+
+
+IDispatch* NativeWorksheetImpl::GetIDispatch()
+{
+    return NULL;    // not an object of Excel
+}
+
+
+ELstring NativeWorksheetImpl::GetName()
+{
+    return m_workbook->GetSheetName(m_index);
+}
+
+
+bool NativeWorksheetImpl::SetName(const ELstring &/*name*/)
+{
+    return false;   // read-only
+}
+
+
+ExcelRange NativeWorksheetImpl::GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo)
+{
+    int first = ColumnNumber(columnFrom);
+    int last = ColumnNumber(columnTo);
+    if (first == 0 || last < first || rowFrom < 1 || rowTo < rowFrom)
+        return ExcelRange();
+
+    return ExcelRangeImpl::MakeHandle(new NativeRangeImpl(m_workbook, m_index, first, last, rowFrom, rowTo));
+}
+
+
+ExcelCell NativeWorksheetImpl::GetCell(ELchar column, int row)
+{
+    int number = ColumnNumber(column);
+    if (number == 0 || row < 1)
+        return ExcelCell();
+
+    return ExcelCellImpl::MakeHandle(new NativeCellImpl(m_workbook, m_index, number, row));
+}
+
+
+bool NativeWorksheetImpl::CopyWorksheet(bool /*after*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeWorksheetImpl::ApplyFontSpec(const std::vector<ExcelRangeAddress> & /*ranges*/, const ExcelFontSpec & /*spec*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeWorksheetImpl::ReadRows(const ExcelRowQuery &query, std::vector<std::vector<ELstring> > &values, 
+    std::vector<int> *rowNumbers)
+{
+    values.clear();
+    if (rowNumbers != NULL)
+        rowNumbers->clear();
+
+    RowQueryFilter filter(query);
+    if (!filter.IsValid())
+        return false;
+
+    // A worksheet in memory is filtered as it is. Otherwise only the cells the query needs are read, from
+    // the rows which meet the condition, and they are not kept.
+    const NativeSheet *sheet = m_workbook->FindSheet(m_index);
+    bool evaluate = (sheet != NULL);
+
+    NativeSheet filtered;
+    if (sheet == NULL)
+    {
+        if (!m_workbook->LoadSheet(m_index, filter, filtered))
+            return false;
+        sheet = &filtered;
+    }
+
+    std::vector<ELstring> selected;
+    size_t count = sheet->CountCells();
+    size_t first = 0;
+    while (first < count)
+    {
+        int row = sheet->GetCell(first).row;
+        if (filter.IsPastRows(row))
+            break;
+
+        size_t last = first + 1;
+        while (last < count && sheet->GetCell(last).row == row)
+            ++last;
+
+        if (filter.IsWantedRow(row))
+        {
+            NativeRowValues rowValues(*sheet, first, last);
+            if (evaluate ? filter.Accept(row, rowValues, selected) : filter.Select(rowValues, selected))
+            {
+                values.push_back(std::vector<ELstring>());
+                values.back().swap(selected);
+                if (rowNumbers != NULL)
+                    rowNumbers->push_back(row);
+            }
+        }
+
+        first = last;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class NativeRangeImpl
+
+NativeRangeImpl::NativeRangeImpl(NativeWorkbookImpl *workbook, int sheet, int columnFrom, int columnTo, int rowFrom, int rowTo): 
+    m_handle(ExcelWorkbookImpl::MakeHandle(workbook)), m_workbook(workbook), m_sheet(sheet), 
+    m_columnFrom(columnFrom), m_columnTo(columnTo), m_rowFrom(rowFrom), m_rowTo(rowTo)
+{
+    assert(workbook);
+}
+
+
+bool NativeRangeImpl::ReadData(ELstring &data)
+{
+    const NativeSheet *sheet = m_workbook->GetSheet(m_sheet);
+    if (sheet == NULL)
+        return false;
+
+    sheet->EncodeRange(m_rowFrom, m_columnFrom, m_rowTo, m_columnTo, data);
+    return true;
+}
+
+
+bool NativeRangeImpl::WriteData(const ELchar * /*data*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeRangeImpl::WriteDataIfChanged(const ELchar * /*data*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeRangeImpl::ReadTyped(std::vector<unsigned char> &data)
+{
+    data.clear();
+
+    const NativeSheet *sheet = m_workbook->GetSheet(m_sheet);
+    if (sheet == NULL)
+        return false;
+
+    ExcelTypedWriter writer(data);
+    sheet->EncodeRangeTyped(m_rowFrom, m_columnFrom, m_rowTo, m_columnTo, writer);
+    return true;
+}
+
+
+bool NativeRangeImpl::WriteTyped(const std::vector<unsigned char> &/*data*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeRangeImpl::ReadValues(std::vector<ExcelValue> &values)
+{
+    const NativeSheet *sheet = m_workbook->GetSheet(m_sheet);
+    if (sheet == NULL)
+        return false;
+
+    sheet->GetRangeValues(m_rowFrom, m_columnFrom, m_rowTo, m_columnTo, values);
+    return true;
+}
+
+
+bool NativeRangeImpl::WriteValues(const std::vector<ExcelValue> &/*values*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeRangeImpl::ReadColumns(std::vector<ExcelColumn> &columns)
+{
+    const NativeSheet *sheet = m_workbook->GetSheet(m_sheet);
+    if (sheet == NULL)
+        return false;
+
+    return sheet->ReadColumns(m_rowFrom, m_columnFrom, m_rowTo, m_columnTo, columns);
+}
+
+
+bool NativeRangeImpl::GetValue(ExcelValue &value)
+{
+    const NativeSheet *sheet = m_workbook->GetSheet(m_sheet);
+    if (sheet == NULL)
+        return false;
+
+    sheet->GetValue(sheet->FindCell(m_rowFrom, m_columnFrom), value);
+    return true;
+}
+
+
+bool NativeRangeImpl::SetValue(const ExcelValue &/*value*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeRangeImpl::Merge(bool /*multiRow*/)
+{
+    return false;   // read-only
+}
+
+
+ExcelFont NativeRangeImpl::GetFont()
+{
+    return ExcelFont();     // fonts are not read
+}
+
+
+bool NativeRangeImpl::GetFontSpec(ExcelFontSpec & /*spec*/)
+{
+    return false;   // fonts are not read
+}
+
+
+bool NativeRangeImpl::ApplyFontSpec(const ExcelFontSpec & /*spec*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeRangeImpl::SetHorizontalAlignment(ExcelHorizontalAlignment /*align*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeRangeImpl::SetVerticalAlignment(ExcelVerticalAlignment /*align*/)
+{
+    return false;   // read-only
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class NativeCellImpl
+
+NativeCellImpl::NativeCellImpl(NativeWorkbookImpl *workbook, int sheet, int column, int row): 
+    m_handle(ExcelWorkbookImpl::MakeHandle(workbook)), m_workbook(workbook), m_sheet(sheet), m_column(column), m_row(row)
+{
+    assert(workbook);
+}
+
+
+bool NativeCellImpl::GetValue(ELstring &value)
+{
+    const NativeSheet *sheet = m_workbook->GetSheet(m_sheet);
+    if (sheet == NULL)
+        return false;
+
+    sheet->FormatValue(sheet->FindCell(m_row, m_column), value);
+    return true;
+}
+
+
+bool NativeCellImpl::SetValue(const ELstring &/*value*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeCellImpl::SetValue(int /*value*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeCellImpl::SetValue(double /*value*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeCellImpl::GetValue(ExcelValue &value)
+{
+    const NativeSheet *sheet = m_workbook->GetSheet(m_sheet);
+    if (sheet == NULL)
+        return false;
+
+    sheet->GetValue(sheet->FindCell(m_row, m_column), value);
+    return true;
+}
+
+
+bool NativeCellImpl::SetValue(const ExcelValue &/*value*/)
+{
+    return false;   // read-only
+}
+
+
+ExcelFont NativeCellImpl::GetFont()
+{
+    return ExcelFont();     // fonts are not read
+}
+
+
+bool NativeCellImpl::GetFontSpec(ExcelFontSpec & /*spec*/)
+{
+    return false;   // fonts are not read
+}
+
+
+bool NativeCellImpl::ApplyFontSpec(const ExcelFontSpec & /*spec*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeCellImpl::SetHorizontalAlignment(ExcelHorizontalAlignment /*align*/)
+{
+    return false;   // read-only
+}
+
+
+bool NativeCellImpl::SetVerticalAlignment(ExcelVerticalAlignment /*align*/)
+{
+    return false;   // read-only
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,240 @@
+﻿/*!
+* @file    NativeWorkbook.h
+* @brief   Header file for the native bodies of ExcelWorkbook, ExcelWorksheetSet, ExcelWorksheet, ExcelRange and ExcelCell
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef NATIVEWORKBOOK_H_GUID_996CEC49_ABFF_4CA9_AAF3_588C244A6E0F
+#define NATIVEWORKBOOK_H_GUID_996CEC49_ABFF_4CA9_AAF3_588C244A6E0F
+
+
+#include <vector>
+#include "LibDef.h"
+#include "ExcelBodies.h"
+#include "NativeWorkbookSource.h"
+#include "NativeSheet.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class NativeWorkbookImpl implements ExcelWorkbook's interfaces for a workbook file read without Excel.
+* @details The workbook is read-only: Save(), SaveAs() and every member which changes a worksheet, a range
+*          or a cell fail. A worksheet is read when its cells are used first, and kept until Close() unless
+*          the number of resident worksheets is limited: then the least recently used one is released to
+*          read another, and read again when it is used again. @n
+*          The bodies of the worksheets, ranges and cells hold an ExcelWorkbook handle, so the workbook
+*          lives as long as any of them.
+*/
+class NativeWorkbookImpl : public ExcelWorkbookImpl
+{
+public:
+    /*!
+    * @param [in] source An opened source, which is deleted by the NativeWorkbookImpl.
+    * @param [in] maxResidentSheets Maximum number of worksheets kept in memory, 0 for no limit.
+    */
+    explicit NativeWorkbookImpl(NativeWorkbookSource *source, int maxResidentSheets = 0);
+
+    int CountSheets() const
+    {
+        return m_source == NULL ? 0 : m_source->CountSheets();
+    }
+
+    ELstring GetSheetName(int index) const;
+
+    /*!
+    * @brief Get the cells of a worksheet, which are read at the first call.
+    * @param [in] index Index of the worksheet, starts from 0.
+    * @return NULL if the workbook is closed or the worksheet cannot be read.
+    * @note The returned sheet may be released by the next call, when the resident worksheets are limited.
+    */
+    const NativeSheet* GetSheet(int index);
+
+    /*!
+    * @brief Get the cells of a worksheet only if they are read already.
+    * @return NULL if the worksheet is not read.
+    */
+    const NativeSheet* FindSheet(int index);
+
+    /*!
+    * @brief Read only what a filter wants of a worksheet, into a sheet which is not kept by the workbook.
+    */
+    bool LoadSheet(int index, const RowQueryFilter &filter, NativeSheet &sheet);
+
+    /*!
+    * @brief Read all the worksheets which are not read yet, several at the same time.
+    * @param [in] parallelSheets Number of worksheets read at the same time, 0 for one per processor.
+    * @return true if every worksheet was read.
+    * @note The shared strings and the styles are read by the source before, and only read by the threads.
+    *       The limit of resident worksheets does not apply.
+    */
+    bool LoadAllSheets(int parallelSheets);
+
+private:
+    virtual ~NativeWorkbookImpl();
+
+    virtual ExcelWorksheet GetActiveWorksheet();
+
+    virtual ExcelWorksheetSet GetAllWorksheets();
+
+    virtual bool Save();
+    virtual bool SaveAs(const ELstring &filename);
+
+    virtual bool Close();
+
+    void ReleaseLeastRecentSheet();
+
+    static void LoadSheetTask(void *context, int task);
+
+private:
+    NativeWorkbookSource      *m_source;
+    std::vector<NativeSheet*>  m_sheets;        // NULL if not read yet
+    std::vector<unsigned long> m_lastUse;       // value of m_useCount when a sheet was used last
+    unsigned long              m_useCount;
+    int                        m_maxResidentSheets;
+};
+
+
+/*!
+* @internal
+* @brief Class NativeWorksheetSetImpl implements ExcelWorksheetSet's interfaces for a NativeWorkbookImpl.
+*/
+class NativeWorksheetSetImpl : public ExcelWorksheetSetImpl
+{
+public:
+    NativeWorksheetSetImpl(NativeWorkbookImpl *workbook);
+
+private:
+    virtual int CountWorksheets();
+
+    virtual ExcelWorksheet GetWorksheet(int index);
+
+    virtual ExcelWorksheet AddWorksheet(ExcelWorksheet ref, bool after);
+
+private:
+    ExcelWorkbook       m_handle;       // keeps the workbook alive
+    NativeWorkbookImpl *m_workbook;
+};
+
+
+/*!
+* @internal
+* @brief Class NativeWorksheetImpl implements ExcelWorksheet's interfaces for a NativeWorkbookImpl.
+*/
+class NativeWorksheetImpl : public ExcelWorksheetImpl
+{
+public:
+    NativeWorksheetImpl(NativeWorkbookImpl *workbook, int index);
+
+private:
+    virtual IDispatch* GetIDispatch();
+
+    virtual ELstring   GetName();
+    virtual bool       SetName(const ELstring &name);
+
+    virtual ExcelRange GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
+    virtual ExcelCell  GetCell(ELchar column, int row);
+
+    virtual bool CopyWorksheet(bool after);
+
+    virtual bool ApplyFontSpec(const std::vector<ExcelRangeAddress> &ranges, const ExcelFontSpec &spec);
+
+    virtual bool ReadRows(const ExcelRowQuery &query, std::vector<std::vector<ELstring> > &values, 
+        std::vector<int> *rowNumbers);
+
+private:
+    ExcelWorkbook       m_handle;       // keeps the workbook alive
+    NativeWorkbookImpl *m_workbook;
+    int                 m_index;
+};
+
+
+/*!
+* @internal
+* @brief Class NativeRangeImpl implements ExcelRange's interfaces for a NativeWorkbookImpl.
+*/
+class NativeRangeImpl : public ExcelRangeImpl
+{
+public:
+    NativeRangeImpl(NativeWorkbookImpl *workbook, int sheet, int columnFrom, int columnTo, int rowFrom, int rowTo);
+
+private:
+    virtual bool ReadData(ELstring &data);
+    virtual bool WriteData(const ELchar *data);
+    virtual bool WriteDataIfChanged(const ELchar *data);
+
+    virtual bool ReadTyped(std::vector<unsigned char> &data);
+    virtual bool WriteTyped(const std::vector<unsigned char> &data);
+
+    virtual bool ReadValues(std::vector<ExcelValue> &values);
+    virtual bool WriteValues(const std::vector<ExcelValue> &values);
+
+    virtual bool ReadColumns(std::vector<ExcelColumn> &columns);
+
+    virtual bool GetValue(ExcelValue &value);
+    virtual bool SetValue(const ExcelValue &value);
+
+    virtual bool Merge(bool multiRow);
+
+    virtual ExcelFont GetFont();
+    virtual bool GetFontSpec(ExcelFontSpec &spec);
+    virtual bool ApplyFontSpec(const ExcelFontSpec &spec);
+
+    virtual bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
+    virtual bool SetVerticalAlignment(ExcelVerticalAlignment align);
+
+private:
+    ExcelWorkbook       m_handle;       // keeps the workbook alive
+    NativeWorkbookImpl *m_workbook;
+    int                 m_sheet;
+    int                 m_columnFrom;
+    int                 m_columnTo;
+    int                 m_rowFrom;
+    int                 m_rowTo;
+};
+
+
+/*!
+* @internal
+* @brief Class NativeCellImpl implements ExcelCell's interfaces for a NativeWorkbookImpl.
+*/
+class NativeCellImpl : public ExcelCellImpl
+{
+public:
+    NativeCellImpl(NativeWorkbookImpl *workbook, int sheet, int column, int row);
+
+private:
+    virtual bool GetValue(ELstring &value);
+    virtual bool SetValue(const ELstring &value);
+    virtual bool SetValue(int value);
+    virtual bool SetValue(double value);
+
+    virtual bool GetValue(ExcelValue &value);
+    virtual bool SetValue(const ExcelValue &value);
+
+    virtual ExcelFont GetFont();
+    virtual bool GetFontSpec(ExcelFontSpec &spec);
+    virtual bool ApplyFontSpec(const ExcelFontSpec &spec);
+
+    virtual bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
+    virtual bool SetVerticalAlignment(ExcelVerticalAlignment align);
+
+private:
+    ExcelWorkbook       m_handle;       // keeps the workbook alive
+    NativeWorkbookImpl *m_workbook;
+    int                 m_sheet;
+    int                 m_column;
+    int                 m_row;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //NATIVEWORKBOOK_H_GUID_996CEC49_ABFF_4CA9_AAF3_588C244A6E0F
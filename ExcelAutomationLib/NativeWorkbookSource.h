@@ -0,0 +1,72 @@
+﻿/*!
+* @file    NativeWorkbookSource.h
+* @brief   Header file for class NativeWorkbookSource
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef NATIVEWORKBOOKSOURCE_H_GUID_F8D7A573_9C8F_4806_B352_89DCDC2F6547
+#define NATIVEWORKBOOKSOURCE_H_GUID_F8D7A573_9C8F_4806_B352_89DCDC2F6547
+
+
+#include <string>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "Noncopyable.h"
+#include "NativeSheet.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class NativeWorkbookSource is a reader of one workbook file format, used by the native bodies
+*        (see ExcelBodies.h) and created by ExcelFileReader.
+* @details Open() reads only the directory of the workbook, such as the sheet names. What the sheets share,
+*          such as the shared strings, is read by LoadSharedParts(), and the cells of a sheet are read only
+*          when LoadSheet() is called for it.
+*/
+class NativeWorkbookSource : public Noncopyable
+{
+public:
+    virtual ~NativeWorkbookSource() { }
+
+    virtual bool Open(const ELstring &filename) = 0;
+
+    virtual int CountSheets() const = 0;
+
+    /*!
+    * @param [in] index Index of the worksheet, starts from 0.
+    * @return The name in UTF-8.
+    */
+    virtual const std::string& GetSheetName(int index) const = 0;
+
+    /*!
+    * @brief Index of the worksheet which was active when the workbook was saved.
+    */
+    virtual int GetActiveSheet() const = 0;
+
+    /*!
+    * @brief Read what the worksheets share. Nothing is done if it is read already.
+    * @note It must be called successfully before LoadSheet(), by one thread.
+    */
+    virtual bool LoadSharedParts() = 0;
+
+    /*!
+    * @brief Read the cells of a worksheet.
+    * @param [in] filter NULL to read every cell. Otherwise only the rows it accepts are read, and only the
+    *                    cells of the columns it wants; the other cells are skipped before they are decoded.
+    * @note It does not change the source, so different sheets can be loaded by different threads.
+    */
+    virtual bool LoadSheet(int index, NativeSheet &sheet, const RowQueryFilter *filter) const = 0;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //NATIVEWORKBOOKSOURCE_H_GUID_F8D7A573_9C8F_4806_B352_89DCDC2F6547
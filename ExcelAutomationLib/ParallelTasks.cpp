@@ -0,0 +1,138 @@
+﻿/*!
+* @file    ParallelTasks.cpp
+* @brief   Implementation file for class ParallelTasks
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+#include "ParallelTasks.h"
+#include "AtomicsUtil.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief What the threads of a Run() share
+    */
+    struct TaskQueue
+    {
+        ParallelTasks::TaskFunction function;
+        void                       *context;
+        int                         count;
+        AtomicsUtil::Integer        taken;      // number of tasks taken by the threads
+    };
+
+    void RunTasks(TaskQueue &queue)
+    {
+        for (;;)
+        {
+            int task = static_cast<int>(AtomicsUtil::Increment(&queue.taken)) - 1;
+            if (task >= queue.count)
+                break;
+
+            queue.function(queue.context, task);
+        }
+    }
+
+#ifdef _WIN32
+    typedef HANDLE Thread;
+
+    unsigned __stdcall ThreadProc(void *param)
+    {
+        RunTasks(*static_cast<TaskQueue*>(param));
+        return 0;
+    }
+
+    bool StartThread(Thread &thread, TaskQueue &queue)
+    {
+        thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, ThreadProc, &queue, 0, NULL));
+        return thread != NULL;
+    }
+
+    void JoinThread(Thread thread)
+    {
+        ::WaitForSingleObject(thread, INFINITE);
+        ::CloseHandle(thread);
+    }
+#else
+    typedef pthread_t Thread;
+
+    extern "C" void* ThreadProc(void *param)
+    {
+        RunTasks(*static_cast<TaskQueue*>(param));
+        return NULL;
+    }
+
+    bool StartThread(Thread &thread, TaskQueue &queue)
+    {
+        return pthread_create(&thread, NULL, ThreadProc, &queue) == 0;
+    }
+
+    void JoinThread(Thread thread)
+    {
+        pthread_join(thread, NULL);
+    }
+#endif
+}
+
+
+int ParallelTasks::CountProcessors()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    int count = static_cast<int>(info.dwNumberOfProcessors);
+#else
+    int count = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+
+    return count > 0 ? count : 1;
+}
+
+
+void ParallelTasks::Run(int count, int threads, TaskFunction function, void *context)
+{
+    if (threads <= 0)
+        threads = CountProcessors();
+    if (threads > count)
+        threads = count;
+
+    TaskQueue queue;
+    queue.function = function;
+    queue.context = context;
+    queue.count = count;
+    queue.taken = 0;
+
+    // the calling thread is one of the threads
+    std::vector<Thread> started;
+    for (int i = 1; i < threads; ++i)
+    {
+        Thread thread;
+        if (!StartThread(thread, queue))
+            break;
+        started.push_back(thread);
+    }
+
+    RunTasks(queue);
+
+    for (size_t i = 0; i < started.size(); ++i)
+        JoinThread(started[i]);
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,63 @@
+﻿/*!
+* @file    ParallelTasks.h
+* @brief   Header file for class ParallelTasks
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef PARALLELTASKS_H_GUID_928B8A15_68DA_483D_8AF7_F28198F9D4BF
+#define PARALLELTASKS_H_GUID_928B8A15_68DA_483D_8AF7_F28198F9D4BF
+
+
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class ParallelTasks runs a number of independent tasks on a few threads.
+*        All the members of ParallelTasks are static member.
+* @details The threads take the next task from a shared counter until none is left, so a long task does
+*          not hold up the others. The calling thread works as one of them, and Run() returns when all the
+*          tasks are done. It uses Win32 threads on Windows and POSIX threads elsewhere.
+* @note ParallelTasks is not intended and allowed to be instantiated.
+*/
+class ParallelTasks
+{
+public:
+    /*!
+    * @brief A task
+    * @param [in] context The context given to Run().
+    * @param [in] task Index of the task, from 0 to count - 1.
+    */
+    typedef void (*TaskFunction)(void *context, int task);
+
+    /*!
+    * @brief Number of processors which the process can use, 1 at least
+    */
+    static int CountProcessors();
+
+    /*!
+    * @brief Run the tasks 0 to count - 1.
+    * @param [in] count Number of tasks.
+    * @param [in] threads Maximum number of tasks which run at the same time. 0 means CountProcessors(),
+    *             and 1 runs all the tasks in the calling thread.
+    * @note If a thread cannot be created, its tasks are run by the other threads.
+    */
+    static void Run(int count, int threads, TaskFunction function, void *context);
+
+private:
+    // Forbid instantiation
+    ParallelTasks();
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //PARALLELTASKS_H_GUID_928B8A15_68DA_483D_8AF7_F28198F9D4BF
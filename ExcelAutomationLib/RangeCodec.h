@@ -0,0 +1,156 @@
+﻿/*!
+* @file    RangeCodec.h
+* @brief   Header file for class RangeCodec
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef RANGECODEC_H_GUID_DABC14EE_217D_4D18_B348_893994FF2671
+#define RANGECODEC_H_GUID_DABC14EE_217D_4D18_B348_893994FF2671
+
+
+#include <cstddef>
+#include "LibDef.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class RangeCodec is the single codec for the encoded string form of a range.
+*        ExcelRange::DecodeData(), ExcelRange::EncodeData() and the string codec of ComUtil are built on it.
+* @note The encoding format is the one specified in ComUtil::EncodeSafeArrayDim2(). @n
+*       The decoder walks the buffer with a pointer: length prefixes are parsed in place and
+*       every value is handed to the visitor as a (pointer, length) pair, so no stream object
+*       is involved and nothing is done per character.
+* @note RangeCodec is not intended and allowed to be instantiated.
+*/
+class RangeCodec
+{
+public:
+    /*!
+    * @brief Decode an encoded string and report its content to a visitor.
+    * @tparam TVisitor A class which provides the following two members: @n
+    *           bool Begin(int rows, int columns);   --> called once, before any value  @n
+    *           bool Value(int row, int column, const ELchar *value, size_t length);  @n
+    *         The value pointer refers into @e data and is not NUL-terminated.
+    *         Row and column indices start from 0. Returning false from either member stops decoding.
+    * @param [in] data The encoded string. Must not be NULL.
+    * @param [in] length Number of characters in @e data.
+    * @param [in,out] visitor The visitor which receives the decoded values.
+    * @return true if the whole range was decoded, otherwise false (dirty data or stopped by the visitor)
+    */
+    template <class TVisitor>
+    static bool Decode(const ELchar *data, size_t length, TVisitor &visitor)
+    {
+        const ELchar *pos = data;
+        const ELchar *end = data + length;
+
+        // Encoding format: <row>#<column>#
+        int row = 0;
+        int column = 0;
+        if (!ParseNumber(pos, end, row) || !ParseNumber(pos, end, column))
+            return false;
+
+        if (row <= 0 || column <= 0)
+            return false;   // no data or dirty data
+
+        if (!visitor.Begin(row, column))
+            return false;
+
+        for (int i = 0; i < row; ++i)
+        {
+            for (int j = 0; j < column; ++j)
+            {
+                // Encoding format: <number of characters>#<characters>
+                int count = 0;
+                if (!ParseNumber(pos, end, count))
+                    return false;
+
+                if (static_cast<size_t>(end - pos) < static_cast<size_t>(count))
+                    return false;   // truncated value
+
+                if (!visitor.Value(i, j, pos, count))
+                    return false;
+
+                pos += count;
+            }
+        }
+
+        return true;
+    }
+
+    /*!
+    * @brief Parse a non-negative decimal number followed by the delimiter '#'.
+    * @param [in,out] pos Current position. It is moved past the delimiter if successful.
+    * @param [in] end End of the buffer.
+    * @param [out] value The parsed number.
+    * @return true if successful, otherwise false
+    */
+    static bool ParseNumber(const ELchar *&pos, const ELchar *end, int &value)
+    {
+        const int maxValue = 0x7FFFFFFF;
+
+        const ELchar *p = pos;
+        int result = 0;
+
+        while (p != end && *p >= ELtext('0') && *p <= ELtext('9'))
+        {
+            int digit = *p - ELtext('0');
+            if (result > (maxValue - digit) / 10)
+                return false;   // overflow
+
+            result = result * 10 + digit;
+            ++p;
+        }
+
+        if (p == pos || p == end || *p != ELtext('#'))
+            return false;
+
+        pos = p + 1;
+        value = result;
+        return true;
+    }
+
+    /*!
+    * @brief Append a non-negative decimal number followed by the delimiter '#'.
+    */
+    static void AppendNumber(ELstring &out, size_t value)
+    {
+        ELchar buf[24];
+        ELchar *p = buf + sizeof(buf) / sizeof(buf[0]);
+
+        *--p = ELtext('#');
+        do
+        {
+            *--p = static_cast<ELchar>(ELtext('0') + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        out.append(p, buf + sizeof(buf) / sizeof(buf[0]));
+    }
+
+    /*!
+    * @brief Append one value in the format <number of characters>#<characters>.
+    */
+    static void AppendValue(ELstring &out, const ELchar *value, size_t length)
+    {
+        AppendNumber(out, length);
+        out.append(value, length);
+    }
+
+private:
+    // Forbid instantiation
+    RangeCodec();
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //RANGECODEC_H_GUID_DABC14EE_217D_4D18_B348_893994FF2671
@@ -0,0 +1,170 @@
+﻿/*!
+* @file    RangeFingerprint.h
+* @brief   Header file for class RangeFingerprint
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef RANGEFINGERPRINT_H_GUID_E4C07A19_5B2D_4F86_8E31_96A0D3B75C42
+#define RANGEFINGERPRINT_H_GUID_E4C07A19_5B2D_4F86_8E31_96A0D3B75C42
+
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "RangeCodec.h"
+#include "CellRectangles.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class RangeFingerprint keeps a hash of every cell of a range, as it was last read or written in the
+*        encoded string form, so that a later write can find the cells which changed.
+* @details The hash is the 64-bit FNV-1a of the characters of a value. Only 8 bytes are kept per cell.
+*/
+class RangeFingerprint
+{
+    class Builder;
+    friend class Builder;
+
+public:
+    /*!
+    * @brief A cell whose value differs from the fingerprint. The value refers into the encoded string.
+    */
+    struct ChangedCell
+    {
+        const ELchar *value;
+        size_t        length;
+    };
+
+public:
+    RangeFingerprint(): m_rows(0), m_columns(0) { }
+
+    bool IsEmpty() const
+    {
+        return m_hashes.empty();
+    }
+
+    void Clear()
+    {
+        m_rows = 0;
+        m_columns = 0;
+        std::vector<unsigned long long>().swap(m_hashes);
+    }
+
+    void Swap(RangeFingerprint &other)
+    {
+        std::swap(m_rows, other.m_rows);
+        std::swap(m_columns, other.m_columns);
+        m_hashes.swap(other.m_hashes);
+    }
+
+    /*!
+    * @brief Take the fingerprint of an encoded string.
+    * @return false (and the fingerprint is cleared) if the string is not well formed
+    */
+    bool Assign(const ELchar *data, size_t length)
+    {
+        Builder builder(*this, NULL, NULL, NULL);
+        if (!RangeCodec::Decode(data, length, builder))
+        {
+            Clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    /*!
+    * @brief Take the fingerprint of an encoded string, and find the cells which differ from this one.
+    * @param [out] next Which returns the fingerprint of @e data.
+    * @param [out] positions Which returns the positions (starting from 0) of the changed cells, row by row.
+    * @param [out] cells Which returns the values of the changed cells, in the order of @e positions.
+    * @return false if the string is not well formed or the size of the range is not the same
+    */
+    bool Compare(const ELchar *data, size_t length, RangeFingerprint &next,
+        std::vector<CellPos> &positions, std::vector<ChangedCell> &cells) const
+    {
+        positions.clear();
+        cells.clear();
+
+        Builder builder(next, this, &positions, &cells);
+        return RangeCodec::Decode(data, length, builder);
+    }
+
+    static unsigned long long Hash(const ELchar *value, size_t length)
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<unsigned long long>(value[i]);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+private:
+    // The RangeCodec visitor which fills a fingerprint, and compares it with an old one if any
+    class Builder
+    {
+    public:
+        Builder(RangeFingerprint &target, const RangeFingerprint *old, std::vector<CellPos> *positions,
+            std::vector<ChangedCell> *cells): m_target(target), m_old(old), m_positions(positions), m_cells(cells)
+        {
+        }
+
+        bool Begin(int rows, int columns)
+        {
+            if (m_old != NULL && (rows != m_old->m_rows || columns != m_old->m_columns))
+                return false;
+
+            m_target.m_rows = rows;
+            m_target.m_columns = columns;
+            m_target.m_hashes.resize(static_cast<size_t>(rows) * columns);
+            return true;
+        }
+
+        bool Value(int row, int column, const ELchar *value, size_t length)
+        {
+            size_t index = static_cast<size_t>(row) * m_target.m_columns + column;
+            unsigned long long hash = Hash(value, length);
+            m_target.m_hashes[index] = hash;
+
+            if (m_old != NULL && m_old->m_hashes[index] != hash)
+            {
+                m_positions->push_back(CellPos(row, column));
+
+                ChangedCell cell = { value, length };
+                m_cells->push_back(cell);
+            }
+
+            return true;
+        }
+
+    private:
+        RangeFingerprint               &m_target;
+        const RangeFingerprint         *m_old;
+        std::vector<CellPos>           *m_positions;
+        std::vector<ChangedCell>       *m_cells;
+    };
+
+private:
+    int                             m_rows;
+    int                             m_columns;
+    std::vector<unsigned long long> m_hashes;       // row by row
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //RANGEFINGERPRINT_H_GUID_E4C07A19_5B2D_4F86_8E31_96A0D3B75C42
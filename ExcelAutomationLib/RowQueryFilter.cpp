@@ -0,0 +1,149 @@
+﻿/*!
+* @file    RowQueryFilter.cpp
+* @brief   Implementation file for class RowQueryFilter
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdlib>
+#include <cwchar>
+#include "RowQueryFilter.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // Columns after XFD (16384) are not in any worksheet
+    const int MaxColumn = 16384;
+
+    bool IsSpace(ELchar ch)
+    {
+        return ch == ELtext(' ') || ch == ELtext('\t') || ch == ELtext('\r') || ch == ELtext('\n');
+    }
+
+    template <typename T>
+    bool CompareWith(ExcelCompareOperator op, const T &lhs, const T &rhs)
+    {
+        switch (op)
+        {
+        case ECO_Equal:         return lhs == rhs;
+        case ECO_NotEqual:      return !(lhs == rhs);
+        case ECO_Less:          return lhs < rhs;
+        case ECO_LessEqual:     return !(rhs < lhs);
+        case ECO_Greater:       return rhs < lhs;
+        case ECO_GreaterEqual:  return !(lhs < rhs);
+        default:                return false;
+        }
+    }
+}
+
+
+RowQueryFilter::RowQueryFilter(const ExcelRowQuery &query):
+    m_query(query), m_valid(false), m_firstColumn(0), m_numericValue(false), m_number(0)
+{
+    const std::vector<int> &columns = query.GetColumns();
+    if (columns.empty() || query.GetRowFrom() < 1 || (query.GetRowTo() != 0 && query.GetRowTo() < query.GetRowFrom()))
+        return;
+
+    std::vector<int> wanted(columns);
+    if (query.GetWhereColumn() != 0)
+        wanted.push_back(query.GetWhereColumn());
+
+    for (size_t i = 0; i < wanted.size(); ++i)
+    {
+        int column = wanted[i];
+        if (column < 1 || column > MaxColumn)
+            return;
+
+        if (column >= static_cast<int>(m_wanted.size()))
+            m_wanted.resize(column + 1, false);
+        m_wanted[column] = true;
+
+        if (m_firstColumn == 0 || column < m_firstColumn)
+            m_firstColumn = column;
+    }
+
+    m_numericValue = ParseNumber(query.GetWhereValue(), m_number);
+    m_valid = true;
+}
+
+
+bool RowQueryFilter::Accept(int row, const RowValues &values, std::vector<ELstring> &selected) const
+{
+    if (m_query.GetWhereColumn() != 0 && !Compare(values))
+        return false;
+
+    if (!Select(values, selected))
+        return false;
+
+    ExcelRowPredicate *predicate = m_query.GetPredicate();
+    return predicate == NULL || predicate->Accept(row, selected);
+}
+
+
+bool RowQueryFilter::AcceptCondition(int row, const RowValues &values) const
+{
+    if (m_query.GetWhereColumn() != 0)
+        return Compare(values);
+
+    if (m_query.GetPredicate() == NULL)
+        return true;
+
+    std::vector<ELstring> selected;
+    return Select(values, selected) && m_query.GetPredicate()->Accept(row, selected);
+}
+
+
+bool RowQueryFilter::Select(const RowValues &values, std::vector<ELstring> &selected) const
+{
+    const std::vector<int> &columns = m_query.GetColumns();
+    selected.resize(columns.size());
+
+    bool empty = true;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        values.GetText(columns[i], selected[i]);
+        empty = empty && selected[i].empty();
+    }
+
+    return !empty;
+}
+
+
+bool RowQueryFilter::Compare(const RowValues &values) const
+{
+    int column = m_query.GetWhereColumn();
+
+    double number;
+    if (m_numericValue && values.GetNumber(column, number))
+        return CompareWith(m_query.GetWhereOperator(), number, m_number);
+
+    ELstring text;
+    values.GetText(column, text);
+    return CompareWith(m_query.GetWhereOperator(), text, m_query.GetWhereValue());
+}
+
+
+bool RowQueryFilter::ParseNumber(const ELstring &text, double &number)
+{
+    if (text.empty() || IsSpace(text[0]))
+        return false;
+
+    const ELchar *begin = text.c_str();
+    ELchar *end = NULL;
+#ifdef _UNICODE
+    number = wcstod(begin, &end);
+#else
+    number = strtod(begin, &end);
+#endif
+
+    return end == begin + text.length();
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,200 @@
+﻿/*!
+* @file    RowQueryFilter.h
+* @brief   Header file for class RowQueryFilter, RowValues and TextRowValues
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef ROWQUERYFILTER_H_GUID_8D41E6A3_2C7F_4B95_A0D8_6F3B1E9C7A24
+#define ROWQUERYFILTER_H_GUID_8D41E6A3_2C7F_4B95_A0D8_6F3B1E9C7A24
+
+
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "Noncopyable.h"
+#include "ExcelRowQuery.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class RowValues gives the values of one row to a RowQueryFilter.
+*/
+class RowValues
+{
+public:
+    virtual ~RowValues() { }
+
+    /*!
+    * @brief Get a value formatted as ExcelRange::ReadData() does; an empty cell is an empty string.
+    */
+    virtual void GetText(int column, ELstring &text) const = 0;
+
+    /*!
+    * @brief Get a value as a number.
+    * @return false if the value is not a number.
+    */
+    virtual bool GetNumber(int column, double &number) const = 0;
+};
+
+
+/*!
+* @internal
+* @brief Class RowQueryFilter evaluates an ExcelRowQuery row by row, for the bodies of ExcelWorksheet.
+* @details The readers use IsWantedRow() and IsWantedColumn() to leave out the cells which the query does
+*          not need, before they are decoded.
+*/
+class RowQueryFilter : public Noncopyable
+{
+public:
+    explicit RowQueryFilter(const ExcelRowQuery &query);
+
+    /*!
+    * @return false if the query selects no column or has an invalid column or row.
+    */
+    bool IsValid() const
+    {
+        return m_valid;
+    }
+
+    int GetRowFrom() const
+    {
+        return m_query.GetRowFrom();
+    }
+
+    /*!
+    * @return 0 for the last row with data.
+    */
+    int GetRowTo() const
+    {
+        return m_query.GetRowTo();
+    }
+
+    bool IsWantedRow(int row) const
+    {
+        return row >= m_query.GetRowFrom() && (m_query.GetRowTo() == 0 || row <= m_query.GetRowTo());
+    }
+
+    /*!
+    * @brief Whether a row and all the rows after it are not wanted.
+    */
+    bool IsPastRows(int row) const
+    {
+        return m_query.GetRowTo() != 0 && row > m_query.GetRowTo();
+    }
+
+    /*!
+    * @brief Whether the cells of a column are needed, to be returned or by the comparison.
+    */
+    bool IsWantedColumn(int column) const
+    {
+        return column > 0 && column < static_cast<int>(m_wanted.size()) && m_wanted[column];
+    }
+
+    /*!
+    * @brief The first and the last of the columns which are needed.
+    */
+    int GetFirstColumn() const
+    {
+        return m_firstColumn;
+    }
+
+    int GetLastColumn() const
+    {
+        return static_cast<int>(m_wanted.size()) - 1;
+    }
+
+    /*!
+    * @brief Whether the rows are filtered by a comparison or a predicate.
+    */
+    bool HasCondition() const
+    {
+        return m_query.GetWhereColumn() != 0 || m_query.GetPredicate() != NULL;
+    }
+
+    /*!
+    * @brief Decide whether a wanted row is returned, and get the values of the selected columns if it is.
+    * @param [out] selected Values of the selected columns, in the order of the query.
+    * @return false if the row does not meet the condition or all the selected values are empty.
+    * @note The predicate of the query is called once for each call.
+    */
+    bool Accept(int row, const RowValues &values, std::vector<ELstring> &selected) const;
+
+    /*!
+    * @brief Decide whether a wanted row meets the condition, while a worksheet is read.
+    * @note The selected values are formatted only for a predicate. Select() gets them from the rows kept.
+    */
+    bool AcceptCondition(int row, const RowValues &values) const;
+
+    /*!
+    * @brief Get the values of the selected columns of a row which meets the condition.
+    * @return false if all the values are empty.
+    */
+    bool Select(const RowValues &values, std::vector<ELstring> &selected) const;
+
+    /*!
+    * @brief Parse a whole string as a number, as the comparison does.
+    */
+    static bool ParseNumber(const ELstring &text, double &number);
+
+private:
+    bool Compare(const RowValues &values) const;
+
+private:
+    const ExcelRowQuery &m_query;
+    bool                 m_valid;
+    std::vector<bool>    m_wanted;          // indexed by column, up to the last column needed
+    int                  m_firstColumn;
+    bool                 m_numericValue;    // whether the constant of the comparison is a number
+    double               m_number;
+};
+
+
+/*!
+* @internal
+* @brief Class TextRowValues gives a row read by ExcelRange::ReadData() to a RowQueryFilter.
+*/
+class TextRowValues : public RowValues
+{
+public:
+    /*!
+    * @param [in] values The values of the row, from column @e firstColumn on.
+    */
+    TextRowValues(const std::vector<ELstring> &values, int firstColumn): m_values(values), m_firstColumn(firstColumn)
+    {
+    }
+
+    virtual void GetText(int column, ELstring &text) const
+    {
+        size_t index = static_cast<size_t>(column - m_firstColumn);
+        if (column >= m_firstColumn && index < m_values.size())
+            text = m_values[index];
+        else
+            text.clear();
+    }
+
+    virtual bool GetNumber(int column, double &number) const
+    {
+        size_t index = static_cast<size_t>(column - m_firstColumn);
+        return column >= m_firstColumn && index < m_values.size() && RowQueryFilter::ParseNumber(m_values[index], number);
+    }
+
+private:
+    TextRowValues& operator = (const TextRowValues &);
+
+private:
+    const std::vector<ELstring> &m_values;
+    int                          m_firstColumn;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //ROWQUERYFILTER_H_GUID_8D41E6A3_2C7F_4B95_A0D8_6F3B1E9C7A24
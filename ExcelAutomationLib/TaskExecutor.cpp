@@ -0,0 +1,145 @@
+﻿/*!
+* @file    TaskExecutor.cpp
+* @brief   Implementation file for class TaskExecutor
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <cassert>
+#include "TaskExecutor.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+TaskExecutor::TaskExecutor(Host &host): m_host(host), m_wake(false), m_running(0), m_posting(0), m_sleeping(0),
+    m_stopping(0)
+{
+}
+
+
+TaskExecutor::~TaskExecutor()
+{
+    Stop();
+}
+
+
+bool TaskExecutor::Start()
+{
+    assert(!m_thread.IsStarted());
+
+    m_stopping = 0;
+    AtomicsUtil::Exchange(&m_running, 1);
+
+    if (!m_thread.Start(&TaskExecutor::ThreadMain, this))
+    {
+        AtomicsUtil::Exchange(&m_running, 0);
+        return false;
+    }
+
+    return true;
+}
+
+
+void TaskExecutor::Stop()
+{
+    assert(!IsExecutorThread());
+
+    if (!m_thread.IsStarted())
+        return;
+
+    // No post can begin from now on; wait for the ones going on, which do not block
+    AtomicsUtil::Exchange(&m_running, 0);
+    while (AtomicsUtil::Load(&m_posting) != 0)
+        Thread::Sleep(0);
+
+    // The thread ends when it finds the queue empty, which is final now
+    AtomicsUtil::Exchange(&m_stopping, 1);
+    m_wake.Set();
+
+    m_thread.Join();
+}
+
+
+bool TaskExecutor::Post(Task *task)
+{
+    assert(task != NULL);
+
+    AtomicsUtil::Increment(&m_posting);
+
+    if (AtomicsUtil::Load(&m_running) == 0)
+    {
+        AtomicsUtil::Decrement(&m_posting);
+
+        task->Cancel();
+        delete task;
+        return false;
+    }
+
+    m_queue.Push(task);
+
+    // Wake the thread only if it is waiting, or about to
+    if (AtomicsUtil::Exchange(&m_sleeping, 0) == 1)
+        m_wake.Set();
+
+    AtomicsUtil::Decrement(&m_posting);
+    return true;
+}
+
+
+bool TaskExecutor::IsExecutorThread() const
+{
+    return m_thread.IsCurrent();
+}
+
+
+void TaskExecutor::ThreadMain(void *context)
+{
+    static_cast<TaskExecutor*>(context)->Run();
+}
+
+
+void TaskExecutor::Run()
+{
+    m_host.EnterThread();
+
+    for (;;)
+    {
+        Task *task = static_cast<Task*>(m_queue.Pop());
+
+        if (task == NULL)
+        {
+            // Tell the producers before the last look at the queue, so that a task pushed after it wakes us
+            AtomicsUtil::Exchange(&m_sleeping, 1);
+
+            task = static_cast<Task*>(m_queue.Pop());
+            if (task == NULL)
+            {
+                if (AtomicsUtil::Load(&m_stopping) != 0)
+                    break;
+
+                m_host.Wait(m_wake);
+            }
+
+            AtomicsUtil::Exchange(&m_sleeping, 0);
+
+            if (task == NULL)
+                continue;
+        }
+
+        task->Run();
+        delete task;
+    }
+
+    m_host.LeaveThread();
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
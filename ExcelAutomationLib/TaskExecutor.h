@@ -0,0 +1,140 @@
+﻿/*!
+* @file    TaskExecutor.h
+* @brief   Header file for class TaskExecutor
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef TASKEXECUTOR_H_GUID_3E7D91C4_58A2_4F0B_B6E9_0C24A8F53D17
+#define TASKEXECUTOR_H_GUID_3E7D91C4_58A2_4F0B_B6E9_0C24A8F53D17
+
+
+#include "LibDef.h"
+#include "AtomicsUtil.h"
+#include "Noncopyable.h"
+#include "ThreadUtil.h"
+#include "MpscQueue.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class TaskExecutor runs tasks on a thread of its own, in the order they are posted.
+* @details Any thread can post a task; the tasks go through an MpscQueue, so a post does not take a lock.
+*          The thread of the executor only waits on an event when the queue is empty, and the event is
+*          set by a post only if the thread is waiting, so a busy executor costs no system call per task. @n
+*          What the thread needs (such as the initialization of a COM apartment, or a message loop while
+*          it waits) is given by a Host, so the executor itself does not depend on COM.
+*/
+class TaskExecutor : public Noncopyable
+{
+public:
+    /*!
+    * @brief A task, which is deleted by the executor after it is run or cancelled
+    */
+    class Task : public MpscQueue::Node
+    {
+    public:
+        virtual ~Task() { }
+
+        /*!
+        * @brief Run the task, on the thread of the executor. It must not throw.
+        */
+        virtual void Run() = 0;
+
+        /*!
+        * @brief Called instead of Run() for a task which is posted too late, when the executor is stopping.
+        */
+        virtual void Cancel() { }
+    };
+
+    /*!
+    * @brief Interface of what the thread of an executor needs. All its members are called on that thread.
+    */
+    class Host
+    {
+    public:
+        virtual ~Host() { }
+
+        /*!
+        * @brief Called when the thread starts, before any task is run.
+        */
+        virtual void EnterThread() { }
+
+        /*!
+        * @brief Called when the thread ends, after all the tasks are run.
+        */
+        virtual void LeaveThread() { }
+
+        /*!
+        * @brief Wait until @e wake is set, when there is no task to run.
+        * @note An STA thread keeps pumping its messages here.
+        */
+        virtual void Wait(Event &wake)
+        {
+            wake.Wait();
+        }
+    };
+
+public:
+    /*!
+    * @param [in] host Which must live longer than the executor.
+    */
+    explicit TaskExecutor(Host &host);
+
+    /*!
+    * @brief Stop the executor if it is running.
+    */
+    ~TaskExecutor();
+
+    /*!
+    * @brief Start the thread.
+    * @return true if successful, otherwise false
+    */
+    bool Start();
+
+    /*!
+    * @brief Stop the thread after it runs the tasks posted before. The tasks posted later are cancelled.
+    * @note It must not be called by a task.
+    */
+    void Stop();
+
+    /*!
+    * @brief Post a task, which is run by the thread of the executor. Any thread can call it.
+    * @return false if the executor is not running; the task is cancelled then.
+    */
+    bool Post(Task *task);
+
+    /*!
+    * @brief Whether the calling thread is the thread of the executor
+    */
+    bool IsExecutorThread() const;
+
+private:
+    static void ThreadMain(void *context);
+
+    void Run();
+
+private:
+    Host                &m_host;
+    MpscQueue            m_queue;
+    Event                m_wake;
+
+    AtomicsUtil::Integer m_running;         // 1 from Start() until Stop() begins
+    AtomicsUtil::Integer m_posting;         // number of posts going on
+    AtomicsUtil::Integer m_sleeping;        // 1 when the thread is about to wait on m_wake
+    AtomicsUtil::Integer m_stopping;        // 1 when the thread is asked to end
+
+    Thread               m_thread;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //TASKEXECUTOR_H_GUID_3E7D91C4_58A2_4F0B_B6E9_0C24A8F53D17
@@ -0,0 +1,340 @@
+﻿/*!
+* @file    ThreadUtil.cpp
+* @brief   Implementation file for class Mutex, class Event and class Thread
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <time.h>
+#endif
+
+#include <cassert>
+#include "ThreadUtil.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief What a new thread is given, owned by the thread
+    */
+    struct ThreadStart
+    {
+        Thread::ThreadFunction function;
+        void                  *context;
+    };
+
+    void RunThread(void *param)
+    {
+        ThreadStart start = *static_cast<ThreadStart*>(param);
+        delete static_cast<ThreadStart*>(param);
+
+        start.function(start.context);
+    }
+
+#ifdef _WIN32
+    unsigned __stdcall ThreadStartProc(void *param)
+    {
+        RunThread(param);
+        return 0;
+    }
+#else
+    extern "C"
+    {
+        // static, as a function with C linkage is external even in an unnamed namespace
+        static void* ThreadStartProc(void *param)
+        {
+            RunThread(param);
+            return NULL;
+        }
+    }
+
+    // The absolute time of a timeout, for pthread_cond_timedwait()
+    timespec Deadline(unsigned long timeout)
+    {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += static_cast<long>(timeout % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+        return deadline;
+    }
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class Mutex
+
+#ifdef _WIN32
+
+Mutex::Mutex()
+{
+    ::InitializeCriticalSection(&m_lock);
+}
+
+
+Mutex::~Mutex()
+{
+    ::DeleteCriticalSection(&m_lock);
+}
+
+
+void Mutex::Lock()
+{
+    ::EnterCriticalSection(&m_lock);
+}
+
+
+void Mutex::Unlock()
+{
+    ::LeaveCriticalSection(&m_lock);
+}
+
+#else
+
+Mutex::Mutex()
+{
+    pthread_mutex_init(&m_lock, NULL);
+}
+
+
+Mutex::~Mutex()
+{
+    pthread_mutex_destroy(&m_lock);
+}
+
+
+void Mutex::Lock()
+{
+    pthread_mutex_lock(&m_lock);
+}
+
+
+void Mutex::Unlock()
+{
+    pthread_mutex_unlock(&m_lock);
+}
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class Event
+
+#ifdef _WIN32
+
+Event::Event(bool manualReset): m_event(::CreateEvent(NULL, manualReset ? TRUE : FALSE, FALSE, NULL))
+{
+    assert(m_event != NULL);
+}
+
+
+Event::~Event()
+{
+    ::CloseHandle(m_event);
+}
+
+
+void Event::Set()
+{
+    ::SetEvent(m_event);
+}
+
+
+void Event::Reset()
+{
+    ::ResetEvent(m_event);
+}
+
+
+bool Event::Wait(unsigned long timeout /* = infinite */)
+{
+    return ::WaitForSingleObject(m_event, timeout == infinite ? INFINITE : timeout) == WAIT_OBJECT_0;
+}
+
+#else
+
+Event::Event(bool manualReset): m_manualReset(manualReset), m_set(false)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_condition, NULL);
+}
+
+
+Event::~Event()
+{
+    pthread_cond_destroy(&m_condition);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+
+void Event::Set()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_set = true;
+
+    if (m_manualReset)
+        pthread_cond_broadcast(&m_condition);
+    else
+        pthread_cond_signal(&m_condition);
+
+    pthread_mutex_unlock(&m_mutex);
+}
+
+
+void Event::Reset()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_set = false;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+
+bool Event::Wait(unsigned long timeout /* = infinite */)
+{
+    pthread_mutex_lock(&m_mutex);
+
+    if (timeout == infinite)
+    {
+        while (!m_set)
+            pthread_cond_wait(&m_condition, &m_mutex);
+    }
+    else
+    {
+        timespec deadline = Deadline(timeout);
+        while (!m_set)
+        {
+            if (pthread_cond_timedwait(&m_condition, &m_mutex, &deadline) == ETIMEDOUT)
+                break;
+        }
+    }
+
+    bool set = m_set;
+    if (set && !m_manualReset)
+        m_set = false;
+
+    pthread_mutex_unlock(&m_mutex);
+
+    return set;
+}
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class Thread
+
+Thread::Thread(): m_started(false)
+{
+}
+
+
+Thread::~Thread()
+{
+    assert(!m_started);     // must be joined
+}
+
+
+bool Thread::Start(ThreadFunction function, void *context)
+{
+    assert(!m_started);
+
+    ThreadStart *start = new ThreadStart;
+    start->function = function;
+    start->context = context;
+
+#ifdef _WIN32
+    m_thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, ThreadStartProc, start, 0, &m_threadId));
+    m_started = (m_thread != NULL);
+#else
+    m_started = (pthread_create(&m_thread, NULL, ThreadStartProc, start) == 0);
+#endif
+
+    if (!m_started)
+        delete start;
+
+    return m_started;
+}
+
+
+void Thread::Join()
+{
+    if (!m_started)
+        return;
+
+#ifdef _WIN32
+    ::WaitForSingleObject(m_thread, INFINITE);
+    ::CloseHandle(m_thread);
+#else
+    pthread_join(m_thread, NULL);
+#endif
+
+    m_started = false;
+}
+
+
+bool Thread::IsCurrent() const
+{
+    if (!m_started)
+        return false;
+
+#ifdef _WIN32
+    return ::GetCurrentThreadId() == m_threadId;
+#else
+    return pthread_equal(pthread_self(), m_thread) != 0;
+#endif
+}
+
+
+void Thread::Sleep(unsigned long milliseconds)
+{
+#ifdef _WIN32
+    ::Sleep(milliseconds);
+#else
+    if (milliseconds == 0)
+    {
+        sched_yield();
+        return;
+    }
+
+    timespec duration;
+    duration.tv_sec = milliseconds / 1000;
+    duration.tv_nsec = static_cast<long>(milliseconds % 1000) * 1000000;
+    while (nanosleep(&duration, &duration) == -1 && errno == EINTR)
+        ;
+#endif
+}
+
+
+unsigned long Thread::TickCount()
+{
+#ifdef _WIN32
+    return ::GetTickCount();
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<unsigned long>(now.tv_sec) * 1000 + static_cast<unsigned long>(now.tv_nsec / 1000000);
+#endif
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
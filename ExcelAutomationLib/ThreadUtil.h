@@ -0,0 +1,184 @@
+﻿/*!
+* @file    ThreadUtil.h
+* @brief   Header file for class Mutex, class MutexLock, class Event and class Thread
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef THREADUTIL_H_GUID_0F6B2D84_3C71_4E9A_B5D2_81E7A4C93F06
+#define THREADUTIL_H_GUID_0F6B2D84_3C71_4E9A_B5D2_81E7A4C93F06
+
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#include "LibDef.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class Mutex is a lock which is not recursive on every platform.
+* @details It is a critical section on Windows and a POSIX mutex elsewhere.
+*/
+class Mutex : public Noncopyable
+{
+public:
+    Mutex();
+    ~Mutex();
+
+    void Lock();
+    void Unlock();
+
+private:
+#ifdef _WIN32
+    CRITICAL_SECTION m_lock;
+#else
+    pthread_mutex_t  m_lock;
+#endif
+};
+
+
+/*!
+* @internal
+* @brief Class MutexLock locks a Mutex during its lifetime.
+*/
+class MutexLock : public Noncopyable
+{
+public:
+    explicit MutexLock(Mutex &mutex): m_mutex(mutex)
+    {
+        m_mutex.Lock();
+    }
+
+    ~MutexLock()
+    {
+        m_mutex.Unlock();
+    }
+
+private:
+    Mutex &m_mutex;
+};
+
+
+/*!
+* @internal
+* @brief Class Event is a flag which threads can wait for, as a Win32 event.
+* @details A manual-reset event stays set until Reset() is called, and releases all the waiting threads.
+*          An auto-reset event releases one waiting thread, and is reset when that thread is released. @n
+*          It is a Win32 event on Windows, and a POSIX mutex with a condition variable elsewhere.
+*/
+class Event : public Noncopyable
+{
+public:
+    //! The timeout which never expires
+    static const unsigned long infinite = 0xFFFFFFFF;
+
+    explicit Event(bool manualReset);
+    ~Event();
+
+    void Set();
+    void Reset();
+
+    /*!
+    * @brief Wait until the event is set.
+    * @param [in] timeout In milliseconds, or Event::infinite.
+    * @return true if the event is set, false if the timeout expires
+    */
+    bool Wait(unsigned long timeout = infinite);
+
+#ifdef _WIN32
+    /*!
+    * @brief The Win32 event, for WaitForMultipleObjects() and alike
+    */
+    HANDLE GetHandle() const
+    {
+        return m_event;
+    }
+#endif
+
+private:
+#ifdef _WIN32
+    HANDLE          m_event;
+#else
+    pthread_mutex_t m_mutex;
+    pthread_cond_t  m_condition;
+    bool            m_manualReset;
+    bool            m_set;
+#endif
+};
+
+
+/*!
+* @internal
+* @brief Class Thread runs a function on a new thread.
+* @details It uses Win32 threads on Windows and POSIX threads elsewhere. The thread must be joined
+*          before the Thread object is destroyed.
+*/
+class Thread : public Noncopyable
+{
+public:
+    /*!
+    * @brief The function which the thread runs
+    * @param [in] context The context given to Start().
+    */
+    typedef void (*ThreadFunction)(void *context);
+
+    Thread();
+    ~Thread();
+
+    /*!
+    * @brief Start the thread.
+    * @return true if successful, otherwise false
+    */
+    bool Start(ThreadFunction function, void *context);
+
+    /*!
+    * @brief Wait for the end of the thread. It does nothing if the thread is not started.
+    */
+    void Join();
+
+    bool IsStarted() const
+    {
+        return m_started;
+    }
+
+    /*!
+    * @brief Whether the calling thread is this thread
+    */
+    bool IsCurrent() const;
+
+    /*!
+    * @brief Suspend the calling thread.
+    * @param [in] milliseconds 0 to give up the rest of the time slice only.
+    */
+    static void Sleep(unsigned long milliseconds);
+
+    /*!
+    * @brief A clock in milliseconds which only goes forward, for timeouts. It wraps around.
+    */
+    static unsigned long TickCount();
+
+private:
+#ifdef _WIN32
+    HANDLE    m_thread;
+    unsigned  m_threadId;
+#else
+    pthread_t m_thread;
+#endif
+    bool      m_started;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //THREADUTIL_H_GUID_0F6B2D84_3C71_4E9A_B5D2_81E7A4C93F06
@@ -0,0 +1,182 @@
+﻿/*!
+* @file    Utf8.cpp
+* @brief   Implementation file for class Utf8
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <vector>
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+#if defined(_UNICODE) || defined(_WIN32)
+    void AppendWide(std::wstring &out, const char *text, size_t length)
+    {
+        const unsigned char *pos = reinterpret_cast<const unsigned char*>(text);
+        const unsigned char *end = pos + length;
+
+        out.reserve(out.length() + length);
+        while (pos != end)
+        {
+            unsigned long ch = Utf8::NextCodePoint(pos, end);
+            if (ch >= 0x10000 && sizeof(wchar_t) == 2)
+            {
+                out.push_back(static_cast<wchar_t>(0xD800 + ((ch - 0x10000) >> 10)));
+                out.push_back(static_cast<wchar_t>(0xDC00 + (ch & 0x3FF)));
+            }
+            else
+            {
+                out.push_back(static_cast<wchar_t>(ch));
+            }
+        }
+    }
+
+    std::string FromWide(const std::wstring &str)
+    {
+        std::string result;
+        result.reserve(str.length());
+
+        for (size_t i = 0; i < str.length(); ++i)
+        {
+            unsigned long ch = static_cast<unsigned long>(str[i]);
+            if (sizeof(wchar_t) == 2 && ch >= 0xD800 && ch < 0xDC00 && i + 1 < str.length())
+            {
+                unsigned long low = static_cast<unsigned long>(str[i + 1]);
+                if (low >= 0xDC00 && low < 0xE000)
+                {
+                    ch = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
+                }
+            }
+            Utf8::AppendCodePoint(result, ch);
+        }
+
+        return result;
+    }
+#endif
+}
+
+
+unsigned long Utf8::NextCodePoint(const unsigned char *&pos, const unsigned char *end)
+{
+    unsigned long ch = *pos++;
+    if (ch < 0x80)
+        return ch;
+
+    int trail;
+    if (ch >= 0xF0 && ch < 0xF8)
+    {
+        trail = 3;
+        ch &= 0x07;
+    }
+    else if (ch >= 0xE0)
+    {
+        trail = 2;
+        ch &= 0x0F;
+    }
+    else if (ch >= 0xC0)
+    {
+        trail = 1;
+        ch &= 0x1F;
+    }
+    else
+    {
+        return 0xFFFD;
+    }
+
+    for (; trail > 0; --trail)
+    {
+        if (pos == end || (*pos & 0xC0) != 0x80)
+            return 0xFFFD;
+        ch = (ch << 6) | (*pos++ & 0x3F);
+    }
+
+    return ch > 0x10FFFF ? 0xFFFD : ch;
+}
+
+
+void Utf8::AppendCodePoint(std::string &out, unsigned long ch)
+{
+    if (ch < 0x80)
+    {
+        out.push_back(static_cast<char>(ch));
+    }
+    else if (ch < 0x800)
+    {
+        out.push_back(static_cast<char>(0xC0 | (ch >> 6)));
+        out.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+    }
+    else if (ch < 0x10000)
+    {
+        out.push_back(static_cast<char>(0xE0 | (ch >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(0xF0 | (ch >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((ch >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+    }
+}
+
+
+void Utf8::Append(ELstring &out, const char *text, size_t length)
+{
+#if defined(_UNICODE)
+    AppendWide(out, text, length);
+#elif defined(_WIN32)
+    // UTF-8 => UTF-16 => the ANSI code page
+    std::wstring wide;
+    AppendWide(wide, text, length);
+    if (wide.empty())
+        return;
+
+    int size = ::WideCharToMultiByte(CP_ACP, 0, wide.data(), static_cast<int>(wide.length()), NULL, 0, NULL, NULL);
+    if (size <= 0)
+        return;
+
+    std::vector<char> buffer(size);
+    ::WideCharToMultiByte(CP_ACP, 0, wide.data(), static_cast<int>(wide.length()), &buffer[0], size, NULL, NULL);
+    out.append(&buffer[0], size);
+#else
+    out.append(text, length);
+#endif
+}
+
+
+std::string Utf8::FromELstring(const ELstring &str)
+{
+#if defined(_UNICODE)
+    return FromWide(str);
+#elif defined(_WIN32)
+    if (str.empty())
+        return std::string();
+
+    int size = ::MultiByteToWideChar(CP_ACP, 0, str.data(), static_cast<int>(str.length()), NULL, 0);
+    if (size <= 0)
+        return std::string();
+
+    std::vector<wchar_t> buffer(size);
+    ::MultiByteToWideChar(CP_ACP, 0, str.data(), static_cast<int>(str.length()), &buffer[0], size);
+    return FromWide(std::wstring(&buffer[0], size));
+#else
+    return str;
+#endif
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,71 @@
+﻿/*!
+* @file    Utf8.h
+* @brief   Header file for class Utf8
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef UTF8_H_GUID_48CF3DCF_6D5B_44B0_A144_88B6DDF9880C
+#define UTF8_H_GUID_48CF3DCF_6D5B_44B0_A144_88B6DDF9880C
+
+
+#include <string>
+#include "LibDef.h"
+#include "StringUtil.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class Utf8 converts between the UTF-8 text of the workbook files and ELstring.
+*        All the members of Utf8 are static member.
+* @details ELstring is UTF-16 on Windows and UTF-32 on Linux when _UNICODE is defined. Otherwise it is
+*          the ANSI code page on Windows and UTF-8 on Linux.
+* @note Utf8 is not intended and allowed to be instantiated.
+*/
+class Utf8
+{
+public:
+    /*!
+    * @brief Append a code point in UTF-8.
+    */
+    static void AppendCodePoint(std::string &out, unsigned long ch);
+
+    /*!
+    * @brief Decode the code point at @e pos, and move @e pos after it.
+    * @return U+FFFD for a malformed sequence.
+    */
+    static unsigned long NextCodePoint(const unsigned char *&pos, const unsigned char *end);
+
+    /*!
+    * @brief Append UTF-8 text to an ELstring.
+    */
+    static void Append(ELstring &out, const char *text, size_t length);
+
+    static ELstring ToELstring(const std::string &text)
+    {
+        ELstring result;
+        Append(result, text.data(), text.length());
+        return result;
+    }
+
+    /*!
+    * @brief Convert an ELstring to UTF-8.
+    */
+    static std::string FromELstring(const ELstring &str);
+
+private:
+    // Forbid instantiation
+    Utf8();
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //UTF8_H_GUID_48CF3DCF_6D5B_44B0_A144_88B6DDF9880C
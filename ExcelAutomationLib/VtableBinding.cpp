@@ -0,0 +1,441 @@
+﻿/*!
+* @file    VtableBinding.cpp
+* @brief   Implementation file for class VtableBinding
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <map>
+#include "VtableBinding.h"
+#include "MemberKey.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // The largest number of parameters of a method which can be called through the vtable
+    const UINT MaxParams = 8;
+
+    // Role of a parameter of a vtable method
+    enum ParamKind
+    {
+        PK_In,              // [in]
+        PK_OptionalIn,      // [in, optional]
+        PK_Lcid,            // [in, lcid], filled by us
+        PK_RetVal           // [out, retval], the result
+    };
+
+    struct VtableParam
+    {
+        ParamKind kind;
+        VARTYPE   vt;       // type of the parameter (for PK_RetVal, the type pointed to)
+    };
+
+    /*!
+    * @brief Struct VtableMethod records how to call one member through the vtable.
+    * @note It is a plain struct so a copy can be taken out of the cache without any allocation.
+    */
+    struct VtableMethod
+    {
+        VtableMethod(): available(false), oVft(0), callconv(CC_STDCALL), paramCount(0)
+        {
+        }
+
+        bool        available;      // false if the member cannot be called through the vtable
+        IID         iid;            // IID of the dual interface
+        SHORT       oVft;           // offset of the vtable slot, in bytes
+        CALLCONV    callconv;
+        UINT        paramCount;
+        VtableParam params[MaxParams];
+    };
+
+
+    /*!
+    * @brief Class MethodTable holds the cached members and the lock which guards them.
+    */
+    class MethodTable : public Noncopyable
+    {
+    public:
+        MethodTable()
+        {
+            ::InitializeCriticalSection(&m_lock);
+        }
+
+        ~MethodTable()
+        {
+            ::DeleteCriticalSection(&m_lock);
+        }
+
+        bool Find(const MemberKey &key, VtableMethod &method)
+        {
+            ::EnterCriticalSection(&m_lock);
+            std::map<MemberKey, VtableMethod>::const_iterator it = m_methods.find(key);
+            bool found = (it != m_methods.end());
+            if (found)
+                method = it->second;
+            ::LeaveCriticalSection(&m_lock);
+            return found;
+        }
+
+        void Insert(const MemberKey &key, const VtableMethod &method)
+        {
+            ::EnterCriticalSection(&m_lock);
+            std::map<MemberKey, VtableMethod>::iterator it = m_methods.find(key);
+            if (it != m_methods.end())
+                it->second = method;
+            else
+                m_methods.insert(std::make_pair(m_keys.Store(key), method));
+            ::LeaveCriticalSection(&m_lock);
+        }
+
+        void Clear()
+        {
+            ::EnterCriticalSection(&m_lock);
+            m_methods.clear();
+            m_keys.Clear();
+            ::LeaveCriticalSection(&m_lock);
+        }
+
+    private:
+        std::map<MemberKey, VtableMethod> m_methods;
+        MemberKeyStore                    m_keys;
+        CRITICAL_SECTION                  m_lock;
+    };
+
+    // Constructed while the module is being loaded, before any call of VtableBinding
+    MethodTable s_table;
+
+
+    // Return the kind of a user defined type, or TKIND_MAX if it cannot be found
+    TYPEKIND GetRefTypeKind(ITypeInfo *pTypeInfo, HREFTYPE refType, WORD &typeFlags)
+    {
+        TYPEKIND kind = TKIND_MAX;
+
+        ITypeInfo *pRefInfo = NULL;
+        if (FAILED(pTypeInfo->GetRefTypeInfo(refType, &pRefInfo)))
+            return kind;
+
+        TYPEATTR *pAttr = NULL;
+        if (SUCCEEDED(pRefInfo->GetTypeAttr(&pAttr)))
+        {
+            kind = pAttr->typekind;
+            typeFlags = pAttr->wTypeFlags;
+            pRefInfo->ReleaseTypeAttr(pAttr);
+        }
+
+        pRefInfo->Release();
+        return kind;
+    }
+
+
+    // Map the type of a parameter to the VARTYPE passed to ::DispCallFunc(), or VT_EMPTY if it is not supported
+    VARTYPE ResolveType(ITypeInfo *pTypeInfo, const TYPEDESC &desc)
+    {
+        WORD typeFlags = 0;
+
+        switch (desc.vt)
+        {
+        case VT_I2:
+        case VT_I4:
+        case VT_INT:
+        case VT_UI4:
+        case VT_R4:
+        case VT_R8:
+        case VT_BOOL:
+        case VT_BSTR:
+        case VT_DATE:
+        case VT_VARIANT:
+        case VT_DISPATCH:
+            return desc.vt;
+
+        case VT_USERDEFINED:
+            // the Excel constants (XlHAlign and so on) are 4-byte enumerations
+            if (GetRefTypeKind(pTypeInfo, desc.hreftype, typeFlags) == TKIND_ENUM)
+                return VT_I4;
+            break;
+
+        case VT_PTR:
+            // a pointer to another Excel object, which is an IDispatch as long as its interface is dual
+            if (desc.lptdesc->vt == VT_USERDEFINED)
+            {
+                TYPEKIND kind = GetRefTypeKind(pTypeInfo, desc.lptdesc->hreftype, typeFlags);
+                if (kind == TKIND_DISPATCH || (kind == TKIND_INTERFACE && (typeFlags & TYPEFLAG_FDUAL)))
+                    return VT_DISPATCH;
+            }
+            break;
+        }
+
+        return VT_EMPTY;
+    }
+
+
+    // Fill the parameters of a vtable method from its FUNCDESC
+    bool LoadParams(ITypeInfo *pTypeInfo, const FUNCDESC *pFunc, VtableMethod &method)
+    {
+        // the typed method must return an HRESULT, with the result in an [out, retval] parameter
+        if (pFunc->elemdescFunc.tdesc.vt != VT_HRESULT || pFunc->cParams < 0 ||
+            static_cast<UINT>(pFunc->cParams) > MaxParams)
+        {
+            return false;
+        }
+
+        method.paramCount = pFunc->cParams;
+
+        for (UINT i = 0; i < method.paramCount; ++i)
+        {
+            const ELEMDESC &elem = pFunc->lprgelemdescParam[i];
+            USHORT flags = elem.paramdesc.wParamFlags;
+            VtableParam &param = method.params[i];
+
+            if (flags & PARAMFLAG_FLCID)
+            {
+                param.kind = PK_Lcid;
+                param.vt = VT_I4;
+            }
+            else if (flags & PARAMFLAG_FRETVAL)
+            {
+                if (elem.tdesc.vt != VT_PTR)
+                    return false;
+                param.kind = PK_RetVal;
+                param.vt = ResolveType(pTypeInfo, *elem.tdesc.lptdesc);
+            }
+            else if (flags & PARAMFLAG_FOUT)
+            {
+                return false;
+            }
+            else
+            {
+                param.kind = (flags & (PARAMFLAG_FOPT | PARAMFLAG_FHASDEFAULT)) ? PK_OptionalIn : PK_In;
+                param.vt = ResolveType(pTypeInfo, elem.tdesc);
+            }
+
+            if (param.vt == VT_EMPTY)
+                return false;
+        }
+
+        return true;
+    }
+
+
+    // Find the vtable slot of a member in the type information of the object
+    bool LoadMethod(IDispatch *pDisp, LPOLESTR name, INVOKEKIND invokeKind, VtableMethod &method)
+    {
+        ITypeInfo *pTypeInfo = NULL;
+        if (FAILED(pDisp->GetTypeInfo(0, LOCALE_SYSTEM_DEFAULT, &pTypeInfo)))
+            return false;
+
+        TYPEATTR *pAttr = NULL;
+        if (FAILED(pTypeInfo->GetTypeAttr(&pAttr)))
+        {
+            pTypeInfo->Release();
+            return false;
+        }
+
+        // the object reports its dispinterface, the vtable layout is in the dual interface behind it
+        if (pAttr->typekind == TKIND_DISPATCH)
+        {
+            bool dual = (pAttr->wTypeFlags & TYPEFLAG_FDUAL) != 0;
+            pTypeInfo->ReleaseTypeAttr(pAttr);
+            pAttr = NULL;
+
+            HREFTYPE refType;
+            ITypeInfo *pInterfaceInfo = NULL;
+            if (dual && SUCCEEDED(pTypeInfo->GetRefTypeOfImplType(static_cast<UINT>(-1), &refType)))
+                pTypeInfo->GetRefTypeInfo(refType, &pInterfaceInfo);
+
+            pTypeInfo->Release();
+            pTypeInfo = pInterfaceInfo;
+
+            if (!pTypeInfo || FAILED(pTypeInfo->GetTypeAttr(&pAttr)))
+            {
+                if (pTypeInfo)
+                    pTypeInfo->Release();
+                return false;
+            }
+        }
+
+        bool found = false;
+        bool loaded = false;
+
+        MEMBERID memberId;
+        if (pAttr->typekind == TKIND_INTERFACE && SUCCEEDED(pTypeInfo->GetIDsOfNames(&name, 1, &memberId)))
+        {
+            for (UINT i = 0; i < pAttr->cFuncs && !found; ++i)
+            {
+                FUNCDESC *pFunc = NULL;
+                if (FAILED(pTypeInfo->GetFuncDesc(i, &pFunc)))
+                    break;
+
+                found = (pFunc->memid == memberId && pFunc->invkind == invokeKind);
+                if (found)
+                {
+                    method.iid = pAttr->guid;
+                    method.oVft = pFunc->oVft;
+                    method.callconv = pFunc->callconv;
+                    loaded = LoadParams(pTypeInfo, pFunc, method);
+                }
+
+                pTypeInfo->ReleaseFuncDesc(pFunc);
+            }
+        }
+
+        pTypeInfo->ReleaseTypeAttr(pAttr);
+        pTypeInfo->Release();
+
+        return loaded;
+    }
+}
+
+
+bool VtableBinding::Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult,
+    VARIANT *pArgs, UINT argc, HRESULT &hr)
+{
+    assert(pDisp);
+    assert(name);
+
+    if (!typeName)
+        return false;
+
+    INVOKEKIND invokeKind = INVOKE_FUNC;
+    if (type & DISPATCH_PROPERTYPUT)
+        invokeKind = INVOKE_PROPERTYPUT;
+    else if (type & DISPATCH_PROPERTYGET)
+        invokeKind = INVOKE_PROPERTYGET;
+
+    // the key points to the names of the caller, so a cached member is found without allocating
+    MemberKey key(typeName, name, invokeKind);
+
+    VtableMethod method;
+    if (!s_table.Find(key, method))
+    {
+        // a member which cannot be called through the vtable is cached too, so it is looked up only once
+        method.available = LoadMethod(pDisp, name, invokeKind, method);
+        s_table.Insert(key, method);
+    }
+
+    if (!method.available)
+        return false;
+
+    // map the parameters to the [in] parameters of the method; for a property put, the value is the last one
+    UINT inputs[MaxParams];
+    UINT inputCount = 0;
+    for (UINT i = 0; i < method.paramCount; ++i)
+    {
+        if (method.params[i].kind == PK_In || method.params[i].kind == PK_OptionalIn)
+            inputs[inputCount++] = i;
+    }
+
+    if (argc > inputCount)
+        return false;
+
+    VARIANT *supplied[MaxParams] = { NULL };
+    for (UINT k = 0; k < argc; ++k)
+    {
+        UINT input = (invokeKind == INVOKE_PROPERTYPUT && k == argc - 1) ? inputCount - 1 : k;
+        supplied[inputs[input]] = &pArgs[argc - 1 - k];
+    }
+
+    // the typed method wants an object which supports the dual interface
+    IUnknown *pInterface = NULL;
+    if (FAILED(pDisp->QueryInterface(method.iid, reinterpret_cast<void**>(&pInterface))))
+        return false;
+
+    VARIANT     values[MaxParams];
+    bool        owned[MaxParams] = { false };
+    VARTYPE     types[MaxParams];
+    VARIANTARG *ptrs[MaxParams];
+
+    VARIANT retval;
+    ::VariantInit(&retval);
+    VARIANT *pRet = pResult ? pResult : &retval;
+    VARTYPE retType = VT_EMPTY;
+
+    bool ready = true;
+
+    for (UINT i = 0; i < method.paramCount && ready; ++i)
+    {
+        const VtableParam &param = method.params[i];
+        VARIANT &value = values[i];
+        ptrs[i] = &value;
+        types[i] = param.vt;
+
+        switch (param.kind)
+        {
+        case PK_Lcid:
+            value.vt = VT_I4;
+            value.lVal = LOCALE_SYSTEM_DEFAULT;
+            break;
+
+        case PK_RetVal:
+            // the result is written straight into the VARIANT (or its value part) of the caller
+            retType = param.vt;
+            types[i] = VT_PTR;
+            value.vt = VT_PTR;
+            value.byref = (retType == VT_VARIANT) ? static_cast<void*>(pRet) : static_cast<void*>(&pRet->llVal);
+            break;
+
+        default:
+            if (!supplied[i])
+            {
+                // only an optional VARIANT can be omitted without knowing its default value
+                ready = (param.kind == PK_OptionalIn && param.vt == VT_VARIANT);
+                value.vt = VT_ERROR;
+                value.scode = DISP_E_PARAMNOTFOUND;
+            }
+            else if (param.vt == VT_VARIANT || supplied[i]->vt == param.vt)
+            {
+                value = *supplied[i];
+            }
+            else
+            {
+                ::VariantInit(&value);
+                owned[i] = true;
+                ready = SUCCEEDED(::VariantChangeType(&value, supplied[i], 0, param.vt));
+            }
+            break;
+        }
+    }
+
+    if (ready)
+    {
+        VARIANT callResult;
+        ::VariantInit(&callResult);
+
+        ready = SUCCEEDED(::DispCallFunc(pInterface, method.oVft, method.callconv, VT_HRESULT,
+            method.paramCount, types, ptrs, &callResult));
+
+        if (ready)
+        {
+            hr = callResult.scode;
+            if (SUCCEEDED(hr) && retType != VT_EMPTY && retType != VT_VARIANT)
+                pRet->vt = retType;
+        }
+    }
+
+    for (UINT i = 0; i < method.paramCount; ++i)
+    {
+        if (owned[i])
+            ::VariantClear(&values[i]);
+    }
+
+    ::VariantClear(&retval);
+    pInterface->Release();
+
+    return ready;
+}
+
+
+void VtableBinding::Clear()
+{
+    s_table.Clear();
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
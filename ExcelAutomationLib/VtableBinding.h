@@ -0,0 +1,65 @@
+﻿/*!
+* @file    VtableBinding.h
+* @brief   Header file for class VtableBinding
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef VTABLEBINDING_H_GUID_F71C4550_114A_4996_8556_45BB04999151
+#define VTABLEBINDING_H_GUID_F71C4550_114A_4996_8556_45BB04999151
+
+
+#include <windows.h>
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Class VtableBinding calls a member of a dual interface through its vtable (early binding).
+*        All the members of VtableBinding are static member.
+* @details The vtable slot and the signature of a member are found in the type information of the
+*          object on first use, and cached by the name of the Excel type and the name of the member.
+*          A call then goes straight to the typed method by ::DispCallFunc(), which saves the name
+*          lookup, the DISPPARAMS packing and the argument coercion of IDispatch::Invoke().
+* @note VtableBinding::Invoke() reports whether the early-bound path was available, so the caller
+*       can fall back to IDispatch::Invoke(). All members are thread-safe.
+*/
+class VtableBinding
+{
+public:
+    /*!
+    * @brief Call a member through the vtable of its dual interface.
+    * @param [in] pDisp Pointer to IDispatch. Must not be NULL.
+    * @param [in] typeName Name of the Excel type which @e pDisp belongs to, such as "Range". Must not be NULL.
+    * @param [in] type Three values are allowed: DISPATCH_METHOD, DISPATCH_PROPERTYGET, DISPATCH_PROPERTYPUT
+    * @param [in] name Name of the method or property involved.
+    * @param [out] pResult Pointer to a variant which holds the results. Can be NULL.
+    * @param [in] pArgs The parameters, in reversed order as DISPPARAMS::rgvarg.
+    * @param [in] argc Number of the parameters.
+    * @param [out] hr Which returns the result of the call, if the early-bound path is available.
+    * @return true if the member is called through the vtable, false if the early-bound path is not
+    *         available for this member or this object (nothing has been called then).
+    */
+    static bool Invoke(IDispatch *pDisp, LPCOLESTR typeName, WORD type, LPOLESTR name, VARIANT *pResult,
+        VARIANT *pArgs, UINT argc, HRESULT &hr);
+
+    /*!
+    * @brief Remove all cached members.
+    */
+    static void Clear();
+
+private:
+    // Forbid instantiation
+    VtableBinding();
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //VTABLEBINDING_H_GUID_F71C4550_114A_4996_8556_45BB04999151
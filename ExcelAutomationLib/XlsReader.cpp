@@ -0,0 +1,603 @@
+﻿/*!
+* @file    XlsReader.cpp
+* @brief   Implementation file for class XlsReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstring>
+#include <set>
+#include "XlsReader.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    // types of the BIFF8 records which are read
+    const unsigned long RecordFormula    = 0x0006;
+    const unsigned long RecordEof        = 0x000A;
+    const unsigned long RecordDate1904   = 0x0022;
+    const unsigned long RecordFilePass   = 0x002F;
+    const unsigned long RecordContinue   = 0x003C;
+    const unsigned long RecordWindow1    = 0x003D;
+    const unsigned long RecordBoundSheet = 0x0085;
+    const unsigned long RecordMulRk      = 0x00BD;
+    const unsigned long RecordRString    = 0x00D6;
+    const unsigned long RecordXf         = 0x00E0;
+    const unsigned long RecordSst        = 0x00FC;
+    const unsigned long RecordLabelSst   = 0x00FD;
+    const unsigned long RecordNumber     = 0x0203;
+    const unsigned long RecordLabel      = 0x0204;
+    const unsigned long RecordBoolErr    = 0x0205;
+    const unsigned long RecordString     = 0x0207;
+    const unsigned long RecordRk         = 0x027E;
+    const unsigned long RecordFormat     = 0x041E;
+    const unsigned long RecordBof        = 0x0809;
+
+    const unsigned long Biff8Version     = 0x0600;
+
+    unsigned long GetUInt16(const unsigned char *p)
+    {
+        return p[0] | (static_cast<unsigned long>(p[1]) << 8);
+    }
+
+    unsigned long GetUInt32(const unsigned char *p)
+    {
+        return GetUInt16(p) | (GetUInt16(p + 2) << 16);
+    }
+
+    // An IEEE double, little-endian
+    double GetDouble(const unsigned char *p)
+    {
+        unsigned long long bits = GetUInt32(p) | (static_cast<unsigned long long>(GetUInt32(p + 4)) << 32);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // An RK number: a 30-bit integer or the high 30 bits of a double, maybe multiplied by 100
+    double DecodeRk(unsigned long rk)
+    {
+        double value;
+        if (rk & 2)
+        {
+            value = static_cast<int>(rk & 0xFFFFFFFCUL) / 4;
+        }
+        else
+        {
+            unsigned long long bits = static_cast<unsigned long long>(rk & 0xFFFFFFFCUL) << 32;
+            memcpy(&value, &bits, sizeof(value));
+        }
+
+        return (rk & 1) ? value / 100 : value;
+    }
+
+
+    /*!
+    * @brief Class BiffRecordReader reads the records of a BIFF8 stream.
+    * @details A record is a 16-bit type and a 16-bit length, then the body. A body longer than 8224 bytes
+    *          goes on in the CONTINUE records after it, which are joined by ReadBody().
+    */
+    class BiffRecordReader
+    {
+    public:
+        explicit BiffRecordReader(CompoundStreamReader &stream):
+            m_stream(stream), m_type(0), m_length(0), m_bodyStart(0), m_bodyRead(true)
+        {
+        }
+
+        /*!
+        * @brief Move to the next record. Its body is read by ReadBody(), or skipped.
+        */
+        bool Next()
+        {
+            if (!m_bodyRead && !m_stream.Seek(m_bodyStart + m_length))
+                return false;
+
+            unsigned char header[4];
+            if (m_stream.Read(header, sizeof(header)) != sizeof(header))
+                return false;
+
+            m_type = GetUInt16(header);
+            m_length = GetUInt16(header + 2);
+            m_bodyStart = m_stream.Tell();
+            m_bodyRead = false;
+            return true;
+        }
+
+        unsigned long GetType() const
+        {
+            return m_type;
+        }
+
+        /*!
+        * @brief Read the body of the record, with the bodies of the CONTINUE records after it.
+        */
+        bool ReadBody()
+        {
+            m_boundaries.clear();
+            m_data.resize(m_length);
+            if (m_length > 0 && m_stream.Read(&m_data[0], m_length) != m_length)
+                return false;
+            m_bodyRead = true;
+
+            for (;;)
+            {
+                size_t position = m_stream.Tell();
+
+                unsigned char header[4];
+                if (m_stream.Read(header, sizeof(header)) != sizeof(header) || GetUInt16(header) != RecordContinue)
+                {
+                    m_stream.Seek(position);
+                    return true;
+                }
+
+                size_t offset = m_data.size();
+                size_t length = GetUInt16(header + 2);
+                m_boundaries.push_back(offset);
+                m_data.resize(offset + length);
+                if (length > 0 && m_stream.Read(&m_data[offset], length) != length)
+                    return false;
+            }
+        }
+
+        const std::vector<unsigned char>& GetData() const
+        {
+            return m_data;
+        }
+
+        /*!
+        * @brief Offsets in GetData() where the CONTINUE records start.
+        */
+        const std::vector<size_t>& GetBoundaries() const
+        {
+            return m_boundaries;
+        }
+
+    private:
+        BiffRecordReader& operator = (const BiffRecordReader &);
+
+    private:
+        CompoundStreamReader       &m_stream;
+        unsigned long               m_type;
+        size_t                      m_length;
+        size_t                      m_bodyStart;
+        bool                        m_bodyRead;
+        std::vector<unsigned char>  m_data;
+        std::vector<size_t>         m_boundaries;
+    };
+
+
+    /*!
+    * @brief Class BiffCursor reads the fields of a record body, such as the strings which may be split by
+    *        CONTINUE records.
+    */
+    class BiffCursor
+    {
+    public:
+        explicit BiffCursor(const BiffRecordReader &record):
+            m_data(record.GetData()), m_boundaries(record.GetBoundaries()), m_position(0), m_nextBoundary(0)
+        {
+        }
+
+        bool Has(size_t n) const
+        {
+            return m_position + n <= m_data.size();
+        }
+
+        // <begin> The caller checks Has() before
+        unsigned long UInt8()
+        {
+            return m_data[m_position++];
+        }
+
+        unsigned long UInt16()
+        {
+            m_position += 2;
+            return GetUInt16(&m_data[m_position - 2]);
+        }
+
+        unsigned long UInt32()
+        {
+            m_position += 4;
+            return GetUInt32(&m_data[m_position - 4]);
+        }
+        // <end> The caller checks Has() before
+
+        void Skip(size_t n)
+        {
+            m_position = (n < m_data.size() - m_position ? m_position + n : m_data.size());
+        }
+
+        /*!
+        * @brief Read the option byte and the characters of an XLUnicodeString (the character count is read
+        *        by the caller), and skip its formatting runs and phonetic data.
+        * @details The characters are 8-bit (the low bytes of UTF-16) or UTF-16. When they go on in a
+        *          CONTINUE record, it starts with a new option byte, which may change the width.
+        */
+        bool ReadString(size_t count, std::string &text)
+        {
+            text.clear();
+            if (!Has(1))
+                return false;
+
+            unsigned long options = UInt8();
+            size_t runs = 0;
+            size_t phonetic = 0;
+            if (options & 0x08)
+            {
+                if (!Has(2))
+                    return false;
+                runs = UInt16();
+            }
+            if (options & 0x04)
+            {
+                if (!Has(4))
+                    return false;
+                phonetic = UInt32();
+            }
+
+            size_t width = (options & 0x01) ? 2 : 1;
+            unsigned long surrogate = 0;
+            while (count > 0)
+            {
+                size_t end = NextBoundary();
+                size_t n = (end - m_position) / width;
+                if (n > count)
+                    n = count;
+
+                for (size_t i = 0; i < n; ++i, m_position += width)
+                {
+                    unsigned long ch = (width == 2 ? GetUInt16(&m_data[m_position]) : m_data[m_position]);
+                    if (ch >= 0xD800 && ch < 0xDC00)
+                    {
+                        surrogate = ch;
+                        continue;
+                    }
+                    if (ch >= 0xDC00 && ch < 0xE000 && surrogate != 0)
+                        ch = 0x10000 + ((surrogate - 0xD800) << 10) + (ch - 0xDC00);
+                    surrogate = 0;
+
+                    Utf8::AppendCodePoint(text, ch);
+                }
+
+                count -= n;
+                if (count == 0)
+                    break;
+
+                // the characters go on in the next CONTINUE record
+                if (m_position != end || end == m_data.size())
+                    return false;
+                width = (UInt8() & 0x01) ? 2 : 1;
+            }
+
+            Skip(runs * 4 + phonetic);
+            return true;
+        }
+
+    private:
+        // The first boundary after the position, or the end of the data
+        size_t NextBoundary()
+        {
+            while (m_nextBoundary < m_boundaries.size() && m_boundaries[m_nextBoundary] <= m_position)
+                ++m_nextBoundary;
+
+            return m_nextBoundary < m_boundaries.size() ? m_boundaries[m_nextBoundary] : m_data.size();
+        }
+
+        BiffCursor& operator = (const BiffCursor &);
+
+    private:
+        const std::vector<unsigned char> &m_data;
+        const std::vector<size_t>        &m_boundaries;
+        size_t                            m_position;
+        size_t                            m_nextBoundary;
+    };
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class XlsReader
+
+XlsReader::XlsReader(): m_activeSheet(0), m_date1904(false), m_sharedPartsLoaded(false)
+{
+}
+
+
+bool XlsReader::Open(const ELstring &filename)
+{
+    if (!m_file.Open(filename) || !m_file.OpenStream("Workbook", m_stream))
+        return false;
+
+    CompoundStreamReader stream(m_stream);
+    BiffRecordReader record(stream);
+
+    // The workbook globals substream comes first: BOF ... EOF
+    if (!record.Next() || record.GetType() != RecordBof || !record.ReadBody() ||
+        record.GetData().size() < 2 || GetUInt16(&record.GetData()[0]) != Biff8Version)
+        return false;
+
+    int activeTab = 0;
+    int sheetCount = 0;         // of all the sheets, including chart sheets
+    bool windowSeen = false;
+    std::vector<int> tabs;      // index of each worksheet in all the sheets
+
+    while (record.Next() && record.GetType() != RecordEof)
+    {
+        switch (record.GetType())
+        {
+        case RecordFilePass:
+            return false;       // encrypted
+
+        case RecordBoundSheet:
+            {
+                BiffCursor cursor(record);
+                std::string name;
+                if (!record.ReadBody() || !cursor.Has(8))
+                    return false;
+
+                size_t offset = cursor.UInt32();
+                cursor.UInt8();                 // visibility
+                unsigned long type = cursor.UInt8();
+                if (!cursor.ReadString(cursor.UInt8(), name))
+                    return false;
+
+                if (type == 0)                  // a worksheet or a dialog sheet
+                {
+                    m_sheetNames.push_back(name);
+                    m_sheetOffsets.push_back(offset);
+                    tabs.push_back(sheetCount);
+                }
+                ++sheetCount;
+            }
+            break;
+
+        case RecordWindow1:
+            if (!windowSeen && record.ReadBody() && record.GetData().size() >= 12)
+            {
+                windowSeen = true;
+                activeTab = static_cast<int>(GetUInt16(&record.GetData()[10]));
+            }
+            break;
+
+        case RecordDate1904:
+            if (record.ReadBody() && record.GetData().size() >= 2)
+                m_date1904 = (GetUInt16(&record.GetData()[0]) == 1);
+            break;
+        }
+    }
+
+    m_activeSheet = 0;
+    for (size_t i = 0; i < tabs.size(); ++i)
+    {
+        if (tabs[i] == activeTab)
+            m_activeSheet = static_cast<int>(i);
+    }
+
+    return true;
+}
+
+
+bool XlsReader::LoadSharedParts()
+{
+    if (m_sharedPartsLoaded)
+        return true;
+
+    m_sharedStrings.Clear();
+    m_dateStyles.clear();
+
+    CompoundStreamReader stream(m_stream);
+    BiffRecordReader record(stream);
+    if (!record.Next() || record.GetType() != RecordBof)
+        return false;
+
+    std::set<int> dateFormats;      // custom number formats (FORMAT records come before XF records)
+    std::string text;
+
+    while (record.Next() && record.GetType() != RecordEof)
+    {
+        unsigned long type = record.GetType();
+        if (type != RecordFormat && type != RecordXf && type != RecordSst)
+            continue;
+
+        if (!record.ReadBody())
+            return false;
+
+        BiffCursor cursor(record);
+        if (type == RecordFormat)
+        {
+            if (!cursor.Has(4))
+                return false;
+
+            int id = static_cast<int>(cursor.UInt16());
+            if (cursor.ReadString(cursor.UInt16(), text) && NativeSheet::IsDateFormatCode(text))
+                dateFormats.insert(id);
+        }
+        else if (type == RecordXf)
+        {
+            if (!cursor.Has(4))
+                return false;
+
+            cursor.UInt16();        // font
+            int format = static_cast<int>(cursor.UInt16());
+            m_dateStyles.push_back(NativeSheet::IsBuiltInDateFormat(format) || dateFormats.count(format) != 0);
+        }
+        else
+        {
+            // total number of strings, number of unique strings, then the unique strings
+            if (!cursor.Has(8))
+                return false;
+
+            cursor.UInt32();
+            size_t count = cursor.UInt32();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!cursor.Has(2) || !cursor.ReadString(cursor.UInt16(), text))
+                    return false;
+                m_sharedStrings.Add(text.data(), text.length());
+            }
+        }
+    }
+
+    m_sharedPartsLoaded = true;
+    return true;
+}
+
+
+bool XlsReader::LoadSheet(int index, NativeSheet &sheet, const RowQueryFilter *filter) const
+{
+    assert(index >= 0 && index < CountSheets());
+    assert(m_sharedPartsLoaded);
+
+    sheet.Clear();
+    sheet.SetSharedStrings(&m_sharedStrings);
+
+    CompoundStreamReader stream(m_stream);
+    BiffRecordReader record(stream);
+    if (!stream.Seek(m_sheetOffsets[index]) || !record.Next() || record.GetType() != RecordBof)
+    {
+        sheet.Finish();
+        return false;
+    }
+
+    NativeSheetBuilder builder(sheet, m_dateStyles, m_date1904, filter);
+    std::string text;
+    bool succeeded = false;
+    int depth = 1;                  // a chart in the worksheet is a substream with its own BOF and EOF
+    bool stringPending = false;     // the result of the last FORMULA is in the next STRING record
+    unsigned long stringColumn = 0;
+
+    while (!succeeded && record.Next())
+    {
+        unsigned long type = record.GetType();
+        switch (type)
+        {
+        case RecordBof:
+            ++depth;
+            continue;
+
+        case RecordEof:
+            succeeded = (--depth == 0);
+            continue;
+
+        case RecordLabelSst:
+        case RecordNumber:
+        case RecordRk:
+        case RecordMulRk:
+        case RecordBoolErr:
+        case RecordFormula:
+        case RecordString:
+        case RecordLabel:
+        case RecordRString:
+            if (depth == 1)
+                break;
+            continue;
+
+        default:
+            continue;
+        }
+
+        if (!record.ReadBody())
+            break;
+
+        const std::vector<unsigned char> &data = record.GetData();
+        BiffCursor cursor(record);
+
+        if (type == RecordString)
+        {
+            if (stringPending && cursor.Has(2) && cursor.ReadString(cursor.UInt16(), text))
+                builder.AddString(stringColumn, text);
+            stringPending = false;
+            continue;
+        }
+
+        stringPending = false;
+        if (data.size() < 6)
+            continue;
+
+        // every cell record starts with the row and the column, then the XF of the cell
+        const unsigned char *p = &data[0];
+        unsigned long row = GetUInt16(p);
+        unsigned long column = GetUInt16(p + 2);
+
+        if (type == RecordMulRk)
+        {
+            // the row, the first column, (XF, RK) of each cell, the last column
+            size_t count = (data.size() - 6) / 6;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const unsigned char *cell = p + 4 + i * 6;
+                if (builder.Wants(row, column + i))
+                    builder.AddNumber(column + i, GetUInt16(cell), DecodeRk(GetUInt32(cell + 2)));
+            }
+        }
+        else if (builder.Wants(row, column))
+        {
+            unsigned long xf = GetUInt16(p + 4);
+            switch (type)
+            {
+            case RecordLabelSst:
+                if (data.size() >= 10)
+                    builder.AddSharedString(column, GetUInt32(p + 6));
+                break;
+
+            case RecordNumber:
+                if (data.size() >= 14)
+                    builder.AddNumber(column, xf, GetDouble(p + 6));
+                break;
+
+            case RecordRk:
+                if (data.size() >= 10)
+                    builder.AddNumber(column, xf, DecodeRk(GetUInt32(p + 6)));
+                break;
+
+            case RecordBoolErr:
+                if (data.size() >= 8 && p[7] == 0)
+                    builder.AddBool(column, p[6] != 0);
+                else if (data.size() >= 8)
+                    builder.AddError(column, p[6]);
+                break;
+
+            case RecordFormula:
+                // the cached result: a double, or a tagged value if the last two bytes are 0xFFFF
+                if (data.size() < 14)
+                    break;
+                if (p[12] != 0xFF || p[13] != 0xFF)
+                    builder.AddNumber(column, xf, GetDouble(p + 6));
+                else if (p[6] == 0)
+                    stringPending = true, stringColumn = column;
+                else if (p[6] == 1)
+                    builder.AddBool(column, p[8] != 0);
+                else if (p[6] == 2)
+                    builder.AddError(column, p[8]);
+                else if (p[6] == 3)
+                    builder.AddString(column, std::string());
+                break;
+
+            default:
+                // LABEL and RSTRING: the string is in the record
+                cursor.Skip(6);
+                if (cursor.Has(2) && cursor.ReadString(cursor.UInt16(), text))
+                    builder.AddString(column, text);
+                break;
+            }
+        }
+
+        if (builder.IsDone())
+            succeeded = true;   // the rows after it are not wanted
+    }
+
+    builder.FinishRow();
+    sheet.Finish();
+    return succeeded;
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,81 @@
+﻿/*!
+* @file    XlsReader.h
+* @brief   Header file for class XlsReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef XLSREADER_H_GUID_A7F31C58_64E2_4B0D_8C9A_1E5D07B3F624
+#define XLSREADER_H_GUID_A7F31C58_64E2_4B0D_8C9A_1E5D07B3F624
+
+
+#include <string>
+#include <vector>
+#include "LibDef.h"
+#include "NativeWorkbookSource.h"
+#include "NativeSheet.h"
+#include "CompoundFile.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class XlsReader reads an Excel 97-2003 workbook (.xls): the BIFF8 Workbook stream of an OLE
+*        compound file.
+* @details The Workbook stream is read in place from the mapped file. Open() reads only the sheet list of
+*          the workbook globals; the shared strings (SST) and the formats of the cells (XF, FORMAT) are read
+*          by LoadSharedParts(), and a worksheet from its own BOF record by LoadSheet(). @n
+*          The values are read from the LABELSST, LABEL, RSTRING, NUMBER, RK, MULRK and BOOLERR records,
+*          and the cached results of the FORMULA records. Older BIFF versions (the "Book" stream of Excel 5
+*          and 95) and encrypted workbooks are not supported.
+*/
+class XlsReader : public NativeWorkbookSource
+{
+public:
+    XlsReader();
+
+    virtual bool Open(const ELstring &filename);
+
+    virtual int CountSheets() const
+    {
+        return static_cast<int>(m_sheetNames.size());
+    }
+
+    virtual const std::string& GetSheetName(int index) const
+    {
+        return m_sheetNames[index];
+    }
+
+    virtual int GetActiveSheet() const
+    {
+        return m_activeSheet;
+    }
+
+    virtual bool LoadSharedParts();
+
+    virtual bool LoadSheet(int index, NativeSheet &sheet, const RowQueryFilter *filter) const;
+
+private:
+    CompoundFile             m_file;
+    CompoundStream           m_stream;          // the Workbook stream
+
+    std::vector<std::string> m_sheetNames;      // UTF-8
+    std::vector<size_t>      m_sheetOffsets;    // positions of the BOF records of the worksheets in m_stream
+    int                      m_activeSheet;
+
+    bool                     m_date1904;
+    bool                     m_sharedPartsLoaded;
+    std::vector<bool>        m_dateStyles;      // whether an XF (by index) has a date format
+    NativeStringPool         m_sharedStrings;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //XLSREADER_H_GUID_A7F31C58_64E2_4B0D_8C9A_1E5D07B3F624
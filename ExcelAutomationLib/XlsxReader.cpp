@@ -0,0 +1,889 @@
+﻿/*!
+* @file    XlsxReader.cpp
+* @brief   Implementation file for class XlsxReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include "XlsxReader.h"
+#include "XmlReader.h"
+#include "Biff12.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    /*!
+    * @brief A relationship of a part, from its .rels part
+    */
+    struct Relationship
+    {
+        std::string id;
+        std::string type;
+        std::string target;     // the full name of the target part
+    };
+
+
+    bool EndsWith(const std::string &str, const char *suffix)
+    {
+        size_t length = strlen(suffix);
+        return str.length() >= length && str.compare(str.length() - length, length, suffix) == 0;
+    }
+
+
+    // The name of the .rels part of a part: "xl/workbook.xml" => "xl/_rels/workbook.xml.rels"
+    std::string GetRelsPartName(const std::string &partName)
+    {
+        std::string::size_type slash = partName.rfind('/');
+        if (slash == std::string::npos)
+            return "_rels/" + partName + ".rels";
+
+        return partName.substr(0, slash + 1) + "_rels/" + partName.substr(slash + 1) + ".rels";
+    }
+
+
+    // Resolve the target of a relationship against the part which has the relationship
+    std::string ResolveTarget(const std::string &sourcePart, const std::string &target)
+    {
+        std::string path;
+        if (!target.empty() && target[0] == '/')
+        {
+            path = target.substr(1);
+        }
+        else
+        {
+            std::string::size_type slash = sourcePart.rfind('/');
+            path = (slash == std::string::npos ? std::string() : sourcePart.substr(0, slash + 1)) + target;
+        }
+
+        // remove "." and ".." segments
+        std::vector<std::string> segments;
+        std::string::size_type start = 0;
+        while (start <= path.length())
+        {
+            std::string::size_type end = path.find('/', start);
+            if (end == std::string::npos)
+                end = path.length();
+
+            std::string segment = path.substr(start, end - start);
+            if (segment == "..")
+            {
+                if (!segments.empty())
+                    segments.pop_back();
+            }
+            else if (!segment.empty() && segment != ".")
+            {
+                segments.push_back(segment);
+            }
+
+            start = end + 1;
+        }
+
+        std::string result;
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            if (i != 0)
+                result.push_back('/');
+            result += segments[i];
+        }
+
+        return result;
+    }
+
+
+    // Parse a cell reference such as "AB12"; false if there is no row or column
+    bool ParseCellReference(const std::string &ref, int &row, int &column)
+    {
+        size_t i = 0;
+        column = 0;
+        for (; i < ref.length() && ref[i] >= 'A' && ref[i] <= 'Z'; ++i)
+            column = column * 26 + (ref[i] - 'A' + 1);
+
+        row = 0;
+        for (; i < ref.length() && ref[i] >= '0' && ref[i] <= '9'; ++i)
+            row = row * 10 + (ref[i] - '0');
+
+        return column > 0 && row > 0 && i == ref.length();
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Handlers of the parts
+
+    /*!
+    * @brief Class RelsHandler reads a .rels part.
+    */
+    class RelsHandler : public XmlHandler
+    {
+    public:
+        RelsHandler(const std::string &sourcePart, std::vector<Relationship> &relationships): 
+            m_sourcePart(sourcePart), m_relationships(relationships)
+        {
+        }
+
+        virtual void StartElement(const std::string &name, const XmlAttributes &attributes)
+        {
+            if (name != "Relationship")
+                return;
+
+            const std::string *id = attributes.Find("Id");
+            const std::string *type = attributes.Find("Type");
+            const std::string *target = attributes.Find("Target");
+            const std::string *mode = attributes.Find("TargetMode");
+            if (id == NULL || type == NULL || target == NULL || (mode != NULL && *mode == "External"))
+                return;
+
+            Relationship relationship;
+            relationship.id = *id;
+            relationship.type = *type;
+            relationship.target = ResolveTarget(m_sourcePart, *target);
+            m_relationships.push_back(relationship);
+        }
+
+        virtual void EndElement(const std::string &) { }
+        virtual void Characters(const char *, size_t) { }
+
+    private:
+        RelsHandler& operator = (const RelsHandler &);
+
+    private:
+        std::string                m_sourcePart;
+        std::vector<Relationship> &m_relationships;
+    };
+
+
+    /*!
+    * @brief Class WorkbookHandler reads the workbook part.
+    */
+    class WorkbookHandler : public XmlHandler
+    {
+    public:
+        WorkbookHandler(): activeTab(0), date1904(false), m_viewSeen(false)
+        {
+        }
+
+        virtual void StartElement(const std::string &name, const XmlAttributes &attributes)
+        {
+            if (name == "sheet")
+            {
+                const std::string *sheetName = attributes.Find("name");
+                const std::string *id = attributes.Find("id");
+                names.push_back(sheetName != NULL ? *sheetName : std::string());
+                ids.push_back(id != NULL ? *id : std::string());
+            }
+            else if (name == "workbookView" && !m_viewSeen)
+            {
+                m_viewSeen = true;
+                const std::string *tab = attributes.Find("activeTab");
+                if (tab != NULL)
+                    activeTab = atoi(tab->c_str());
+            }
+            else if (name == "workbookPr")
+            {
+                const std::string *value = attributes.Find("date1904");
+                date1904 = (value != NULL && (*value == "1" || *value == "true"));
+            }
+        }
+
+        virtual void EndElement(const std::string &) { }
+        virtual void Characters(const char *, size_t) { }
+
+    public:
+        std::vector<std::string> names;     // of all the sheets, including chart sheets
+        std::vector<std::string> ids;       // relationship ids
+        int                      activeTab;
+        bool                     date1904;
+
+    private:
+        bool                     m_viewSeen;
+    };
+
+
+    /*!
+    * @brief Class SharedStringsHandler reads the shared strings part.
+    * @details The text of a rich string is the text of all its runs. Phonetic runs (<rPh>) are not part of it.
+    */
+    class SharedStringsHandler : public XmlHandler
+    {
+    public:
+        SharedStringsHandler(NativeStringPool &strings): m_strings(strings), m_inText(false), m_inPhonetic(false)
+        {
+        }
+
+        virtual void StartElement(const std::string &name, const XmlAttributes &)
+        {
+            if (name == "si")
+                m_text.clear();
+            else if (name == "t")
+                m_inText = !m_inPhonetic;
+            else if (name == "rPh")
+                m_inPhonetic = true;
+        }
+
+        virtual void EndElement(const std::string &name)
+        {
+            if (name == "si")
+                m_strings.Add(m_text.data(), m_text.length());
+            else if (name == "t")
+                m_inText = false;
+            else if (name == "rPh")
+                m_inPhonetic = false;
+        }
+
+        virtual void Characters(const char *text, size_t length)
+        {
+            if (m_inText)
+                m_text.append(text, length);
+        }
+
+    private:
+        SharedStringsHandler& operator = (const SharedStringsHandler &);
+
+    private:
+        NativeStringPool &m_strings;
+        std::string       m_text;
+        bool              m_inText;
+        bool              m_inPhonetic;
+    };
+
+
+    /*!
+    * @brief Class StylesHandler finds the cell styles whose number format is a date format.
+    */
+    class StylesHandler : public XmlHandler
+    {
+    public:
+        StylesHandler(std::vector<bool> &dateStyles): m_dateStyles(dateStyles), m_inCellXfs(false)
+        {
+        }
+
+        virtual void StartElement(const std::string &name, const XmlAttributes &attributes)
+        {
+            if (name == "numFmt")
+            {
+                const std::string *id = attributes.Find("numFmtId");
+                const std::string *code = attributes.Find("formatCode");
+                if (id != NULL && code != NULL && NativeSheet::IsDateFormatCode(*code))
+                    m_dateFormats.insert(atoi(id->c_str()));
+            }
+            else if (name == "cellXfs")
+            {
+                m_inCellXfs = true;
+            }
+            else if (name == "xf" && m_inCellXfs)
+            {
+                const std::string *id = attributes.Find("numFmtId");
+                int format = (id != NULL ? atoi(id->c_str()) : 0);
+                m_dateStyles.push_back(NativeSheet::IsBuiltInDateFormat(format) || m_dateFormats.count(format) != 0);
+            }
+        }
+
+        virtual void EndElement(const std::string &name)
+        {
+            if (name == "cellXfs")
+                m_inCellXfs = false;
+        }
+
+        virtual void Characters(const char *, size_t) { }
+
+    private:
+        StylesHandler& operator = (const StylesHandler &);
+
+    private:
+        std::vector<bool> &m_dateStyles;
+        std::set<int>      m_dateFormats;       // custom number formats (<numFmts> comes before <cellXfs>)
+        bool               m_inCellXfs;
+    };
+
+
+    /*!
+    * @brief Class SheetHandler reads the cells of a worksheet part.
+    * @details With a filter, the cells which are not wanted are skipped before their values are collected,
+    *          a row which does not meet the condition is removed when it ends, and the parsing stops after
+    *          the last wanted row.
+    */
+    class SheetHandler : public XmlHandler
+    {
+    public:
+        SheetHandler(NativeSheet &sheet, const std::vector<bool> &dateStyles, bool date1904, 
+            const RowQueryFilter *filter, XmlReader &reader): 
+            m_sheet(sheet), m_dateStyles(dateStyles), m_date1904(date1904), m_filter(filter), m_reader(reader),
+            m_inSheetData(false), m_rowWanted(true), m_rowFirstCell(0), m_row(0), m_column(0), m_skipped(false),
+            m_style(0), m_hasValue(false), m_inValue(false), m_inPhonetic(false)
+        {
+        }
+
+        virtual void StartElement(const std::string &name, const XmlAttributes &attributes)
+        {
+            if (!m_inSheetData)
+            {
+                m_inSheetData = (name == "sheetData");
+                return;
+            }
+
+            if (name == "row")
+            {
+                const std::string *r = attributes.Find("r");
+                m_row = (r != NULL ? atoi(r->c_str()) : m_row + 1);
+                m_column = 0;
+
+                if (m_filter != NULL)
+                {
+                    if (m_filter->IsPastRows(m_row))
+                        m_reader.Stop();    // the rows are in order
+
+                    m_rowWanted = m_filter->IsWantedRow(m_row);
+                    m_rowFirstCell = m_sheet.CountCells();
+                }
+            }
+            else if (name == "c")
+            {
+                int row, column;
+                const std::string *r = attributes.Find("r");
+                if (r != NULL && ParseCellReference(*r, row, column))
+                {
+                    m_row = row;
+                    m_column = column;
+                }
+                else
+                {
+                    ++m_column;
+                }
+
+                m_value.clear();
+                m_hasValue = false;
+
+                m_skipped = (m_filter != NULL && (!m_rowWanted || !m_filter->IsWantedColumn(m_column)));
+                if (m_skipped)
+                    return;
+
+                const std::string *t = attributes.Find("t");
+                m_type = (t != NULL ? *t : std::string());
+
+                const std::string *s = attributes.Find("s");
+                m_style = (s != NULL ? atoi(s->c_str()) : 0);
+            }
+            else if (name == "v")
+            {
+                m_inValue = m_hasValue = !m_skipped;
+            }
+            else if (name == "t")
+            {
+                // the text of an inline string
+                m_inValue = !m_inPhonetic && !m_skipped;
+                m_hasValue = !m_skipped;
+            }
+            else if (name == "rPh")
+            {
+                m_inPhonetic = true;
+            }
+        }
+
+        virtual void EndElement(const std::string &name)
+        {
+            if (name == "v" || name == "t")
+                m_inValue = false;
+            else if (name == "rPh")
+                m_inPhonetic = false;
+            else if (name == "c")
+                AddCell();
+            else if (name == "row")
+                FilterRow();
+            else if (name == "sheetData")
+                m_inSheetData = false;
+        }
+
+        virtual void Characters(const char *text, size_t length)
+        {
+            if (m_inValue)
+                m_value.append(text, length);
+        }
+
+    private:
+        void FilterRow()
+        {
+            if (m_filter == NULL || !m_rowWanted || m_sheet.CountCells() == m_rowFirstCell)
+                return;
+
+            NativeRowValues values(m_sheet, m_rowFirstCell, m_sheet.CountCells());
+            if (!m_filter->AcceptCondition(m_row, values))
+                m_sheet.RemoveCells(m_rowFirstCell);
+        }
+
+        void AddCell()
+        {
+            if (!m_hasValue || m_row <= 0 || m_column <= 0)
+                return;     // an empty cell which has a style only
+
+            if (m_type.empty() || m_type == "n")
+            {
+                double number = strtod(m_value.c_str(), NULL);
+                if (m_style >= 0 && static_cast<size_t>(m_style) < m_dateStyles.size() && m_dateStyles[m_style])
+                {
+                    m_sheet.AddNumber(m_row, m_column, NCT_Date, NativeSheet::SerialToDate(number, m_date1904));
+                }
+                else
+                {
+                    m_sheet.AddNumber(m_row, m_column, NCT_Number, number);
+                }
+            }
+            else if (m_type == "s")
+            {
+                m_sheet.AddSharedString(m_row, m_column, strtoul(m_value.c_str(), NULL, 10));
+            }
+            else if (m_type == "b")
+            {
+                m_sheet.AddNumber(m_row, m_column, NCT_Bool, (m_value == "1" || m_value == "true") ? 1 : 0);
+            }
+            else if (m_type == "e")
+            {
+                m_sheet.AddError(m_row, m_column, m_value.data(), m_value.length());
+            }
+            else
+            {
+                // "str" (the result of a formula), "inlineStr", or "d" (an ISO 8601 date, kept as text)
+                m_sheet.AddString(m_row, m_column, m_value.data(), m_value.length());
+            }
+        }
+
+    private:
+        SheetHandler& operator = (const SheetHandler &);
+
+    private:
+        NativeSheet             &m_sheet;
+        const std::vector<bool> &m_dateStyles;
+        bool                     m_date1904;
+        const RowQueryFilter    *m_filter;
+        XmlReader               &m_reader;
+        bool                     m_inSheetData;
+
+        // the current row
+        bool                     m_rowWanted;
+        size_t                   m_rowFirstCell;    // index of the first cell of the row in the sheet
+
+        // the current cell
+        int                      m_row;
+        int                      m_column;
+        bool                     m_skipped;         // not wanted by the filter
+        std::string              m_type;
+        int                      m_style;
+        std::string              m_value;
+        bool                     m_hasValue;
+        bool                     m_inValue;
+        bool                     m_inPhonetic;
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Readers of the binary parts of an .xlsb package, which give what the handlers give
+
+    /*!
+    * @brief Read the sheets, the active tab and the date system of a binary workbook part into @e workbook.
+    */
+    bool ReadWorkbookRecords(ByteSource &input, WorkbookHandler &workbook)
+    {
+        Biff12Reader reader(input);
+        bool viewSeen = false;
+        std::string id, name;
+
+        while (reader.Next())
+        {
+            const unsigned char *data = reader.GetData();
+            size_t size = reader.GetSize();
+
+            switch (reader.GetType())
+            {
+            case BRT_BundleSh:
+                {
+                    // the state, the tab id, the relationship id (0xFFFFFFFF for none), the name
+                    size_t offset = 8;
+                    if (size >= 12 && Biff12::GetUInt32(data + 8) == 0xFFFFFFFFUL)
+                    {
+                        offset = 12;
+                        id.clear();
+                    }
+                    else if (!Biff12::GetWideString(data, size, offset, id))
+                    {
+                        return false;
+                    }
+
+                    if (!Biff12::GetWideString(data, size, offset, name))
+                        return false;
+
+                    workbook.names.push_back(name);
+                    workbook.ids.push_back(id);
+                }
+                break;
+
+            case BRT_BookView:
+                if (!viewSeen && size >= 28)
+                {
+                    viewSeen = true;
+                    workbook.activeTab = static_cast<int>(Biff12::GetUInt32(data + 24));
+                }
+                break;
+
+            case BRT_WbProp:
+                if (size >= 4)
+                    workbook.date1904 = (data[0] & 0x01) != 0;
+                break;
+            }
+        }
+
+        return !reader.Failed();
+    }
+
+
+    /*!
+    * @brief Read a binary shared strings part. The runs and the phonetic data after the text are left out.
+    */
+    bool ReadSharedStringRecords(ByteSource &input, NativeStringPool &strings)
+    {
+        Biff12Reader reader(input);
+        std::string text;
+
+        while (reader.Next())
+        {
+            // the flags of the rich string, then the text
+            size_t offset = 1;
+            if (reader.GetType() != BRT_SstItem)
+                continue;
+            if (!Biff12::GetWideString(reader.GetData(), reader.GetSize(), offset, text))
+                return false;
+
+            strings.Add(text.data(), text.length());
+        }
+
+        return !reader.Failed();
+    }
+
+
+    /*!
+    * @brief Find the cell styles of a binary styles part whose number format is a date format.
+    */
+    bool ReadStyleRecords(ByteSource &input, std::vector<bool> &dateStyles)
+    {
+        Biff12Reader reader(input);
+        std::set<int> dateFormats;      // custom number formats (they come before the cell styles)
+        bool inCellXfs = false;
+        std::string code;
+
+        while (reader.Next())
+        {
+            const unsigned char *data = reader.GetData();
+            size_t size = reader.GetSize();
+
+            switch (reader.GetType())
+            {
+            case BRT_Fmt:
+                {
+                    size_t offset = 2;
+                    if (size >= 2 && Biff12::GetWideString(data, size, offset, code) && NativeSheet::IsDateFormatCode(code))
+                        dateFormats.insert(static_cast<int>(Biff12::GetUInt16(data)));
+                }
+                break;
+
+            case BRT_BeginCellXfs:
+                inCellXfs = true;
+                break;
+
+            case BRT_EndCellXfs:
+                inCellXfs = false;
+                break;
+
+            case BRT_Xf:
+                if (inCellXfs && size >= 4)
+                {
+                    int format = static_cast<int>(Biff12::GetUInt16(data + 2));
+                    dateStyles.push_back(NativeSheet::IsBuiltInDateFormat(format) || dateFormats.count(format) != 0);
+                }
+                break;
+            }
+        }
+
+        return !reader.Failed();
+    }
+
+
+    /*!
+    * @brief Read the cells of a binary worksheet part; the reading stops after the last wanted row.
+    */
+    bool ReadSheetRecords(ByteSource &input, NativeSheetBuilder &builder)
+    {
+        Biff12Reader reader(input);
+        bool inSheetData = false;
+        unsigned long row = 0;
+        std::string text;
+
+        while (reader.Next())
+        {
+            unsigned long type = reader.GetType();
+            const unsigned char *data = reader.GetData();
+            size_t size = reader.GetSize();
+
+            if (!inSheetData)
+            {
+                inSheetData = (type == BRT_BeginSheetData);
+                continue;
+            }
+
+            if (type == BRT_EndSheetData)
+                break;
+
+            if (type == BRT_RowHdr)
+            {
+                if (size >= 4)
+                    row = Biff12::GetUInt32(data);
+                continue;
+            }
+
+            // every cell record starts with the column, then the style (24 bits) and 8 bits of flags
+            if ((type > BRT_FmlaError && type != BRT_CellRString) || type == BRT_CellBlank || size < 8)
+                continue;
+
+            unsigned long column = Biff12::GetUInt32(data);
+            unsigned long style = Biff12::GetUInt32(data + 4) & 0xFFFFFF;
+            if (!builder.Wants(row, column))
+            {
+                if (builder.IsDone())
+                    return true;    // the rows are in order
+                continue;
+            }
+
+            size_t offset = 8;
+            switch (type)
+            {
+            case BRT_CellRk:
+                if (size >= 12)
+                    builder.AddNumber(column, style, Biff12::DecodeRk(Biff12::GetUInt32(data + 8)));
+                break;
+
+            case BRT_CellReal:
+            case BRT_FmlaNum:
+                if (size >= 16)
+                    builder.AddNumber(column, style, Biff12::GetDouble(data + 8));
+                break;
+
+            case BRT_CellBool:
+            case BRT_FmlaBool:
+                if (size >= 9)
+                    builder.AddBool(column, data[8] != 0);
+                break;
+
+            case BRT_CellError:
+            case BRT_FmlaError:
+                if (size >= 9)
+                    builder.AddError(column, data[8]);
+                break;
+
+            case BRT_CellIsst:
+                if (size >= 12)
+                    builder.AddSharedString(column, Biff12::GetUInt32(data + 8));
+                break;
+
+            case BRT_CellRString:
+                offset = 9;         // the flags of the rich string come before the text
+                // fall through
+            default:
+                // BRT_CellSt and BRT_FmlaString
+                if (Biff12::GetWideString(data, size, offset, text))
+                    builder.AddString(column, text);
+                break;
+            }
+        }
+
+        return !reader.Failed();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class XlsxReader
+
+XlsxReader::XlsxReader(): m_activeSheet(0), m_binary(false), m_date1904(false), m_sharedPartsLoaded(false)
+{
+}
+
+
+bool XlsxReader::Open(const ELstring &filename)
+{
+    if (!m_archive.Open(filename))
+        return false;
+
+    // The package relationships tell the name of the workbook part
+    std::vector<Relationship> relationships;
+    RelsHandler packageRels("", relationships);
+    if (!ParsePart("_rels/.rels", packageRels))
+        return false;
+
+    std::string workbookPart;
+    for (size_t i = 0; i < relationships.size(); ++i)
+    {
+        if (EndsWith(relationships[i].type, "/officeDocument"))
+        {
+            workbookPart = relationships[i].target;
+            break;
+        }
+    }
+
+    if (workbookPart.empty())
+        return false;
+
+    // The workbook relationships tell the names of the other parts
+    relationships.clear();
+    RelsHandler workbookRels(workbookPart, relationships);
+    if (!ParsePart(GetRelsPartName(workbookPart), workbookRels))
+        return false;
+
+    // The parts of an .xlsb package are BIFF12 records instead of XML
+    m_binary = EndsWith(workbookPart, ".bin");
+
+    WorkbookHandler workbook;
+    if (m_binary)
+    {
+        ZipEntryReader input;
+        if (!OpenPart(workbookPart, input) || !ReadWorkbookRecords(input, workbook))
+            return false;
+    }
+    else if (!ParsePart(workbookPart, workbook))
+    {
+        return false;
+    }
+
+    m_date1904 = workbook.date1904;
+    m_activeSheet = 0;
+
+    for (size_t i = 0; i < workbook.names.size(); ++i)
+    {
+        for (size_t k = 0; k < relationships.size(); ++k)
+        {
+            if (relationships[k].id == workbook.ids[i] && EndsWith(relationships[k].type, "/worksheet"))
+            {
+                if (static_cast<int>(i) == workbook.activeTab)
+                    m_activeSheet = static_cast<int>(m_sheetNames.size());
+
+                m_sheetNames.push_back(workbook.names[i]);
+                m_sheetParts.push_back(relationships[k].target);
+                break;
+            }
+        }
+    }
+
+    // Shared strings and styles are optional, and read by LoadSharedParts()
+    for (size_t i = 0; i < relationships.size(); ++i)
+    {
+        if (EndsWith(relationships[i].type, "/sharedStrings"))
+            m_sharedStringsPart = relationships[i].target;
+        else if (EndsWith(relationships[i].type, "/styles"))
+            m_stylesPart = relationships[i].target;
+    }
+
+    return true;
+}
+
+
+bool XlsxReader::LoadSharedParts()
+{
+    if (m_sharedPartsLoaded)
+        return true;
+
+    m_sharedStrings.Clear();
+    m_dateStyles.clear();
+
+    if (!m_sharedStringsPart.empty())
+    {
+        if (m_binary)
+        {
+            ZipEntryReader input;
+            if (!OpenPart(m_sharedStringsPart, input) || !ReadSharedStringRecords(input, m_sharedStrings))
+                return false;
+        }
+        else
+        {
+            SharedStringsHandler handler(m_sharedStrings);
+            if (!ParsePart(m_sharedStringsPart, handler))
+                return false;
+        }
+    }
+
+    if (!m_stylesPart.empty())
+    {
+        if (m_binary)
+        {
+            ZipEntryReader input;
+            if (!OpenPart(m_stylesPart, input) || !ReadStyleRecords(input, m_dateStyles))
+                return false;
+        }
+        else
+        {
+            StylesHandler handler(m_dateStyles);
+            if (!ParsePart(m_stylesPart, handler))
+                return false;
+        }
+    }
+
+    m_sharedPartsLoaded = true;
+    return true;
+}
+
+
+bool XlsxReader::LoadSheet(int index, NativeSheet &sheet, const RowQueryFilter *filter) const
+{
+    assert(index >= 0 && index < CountSheets());
+    assert(m_sharedPartsLoaded);
+
+    sheet.Clear();
+    sheet.SetSharedStrings(&m_sharedStrings);
+
+    // the handler stops the reader after the last wanted row
+    ZipEntryReader input;
+    if (!OpenPart(m_sheetParts[index], input))
+        return false;
+
+    bool succeeded;
+    if (m_binary)
+    {
+        NativeSheetBuilder builder(sheet, m_dateStyles, m_date1904, filter);
+        succeeded = ReadSheetRecords(input, builder);
+        builder.FinishRow();
+    }
+    else
+    {
+        XmlReader reader(input);
+        SheetHandler handler(sheet, m_dateStyles, m_date1904, filter, reader);
+        succeeded = reader.Parse(handler) && !input.Failed();
+    }
+
+    sheet.Finish();
+    return succeeded;
+}
+
+
+bool XlsxReader::OpenPart(const std::string &name, ZipEntryReader &input) const
+{
+    const ZipArchive::Entry *entry = m_archive.FindEntry(name);
+    return entry != NULL && input.Open(m_archive, *entry);
+}
+
+
+bool XlsxReader::ParsePart(const std::string &name, XmlHandler &handler) const
+{
+    ZipEntryReader input;
+    if (!OpenPart(name, input))
+        return false;
+
+    XmlReader reader(input);
+    return reader.Parse(handler) && !input.Failed();
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
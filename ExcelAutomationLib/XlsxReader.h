@@ -0,0 +1,89 @@
+﻿/*!
+* @file    XlsxReader.h
+* @brief   Header file for class XlsxReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef XLSXREADER_H_GUID_43225ABD_776B_43BB_8F26_51172D0335AA
+#define XLSXREADER_H_GUID_43225ABD_776B_43BB_8F26_51172D0335AA
+
+
+#include <string>
+#include <vector>
+#include "LibDef.h"
+#include "NativeWorkbookSource.h"
+#include "NativeSheet.h"
+#include "ZipArchive.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+class XmlHandler;
+
+
+/*!
+* @internal
+* @brief Class XlsxReader reads an Office Open XML workbook (.xlsx, .xlsm), or its binary form (.xlsb).
+* @details The parts are inflated from the package and parsed by XmlReader as streams, so neither a part
+*          nor its XML tree is held in memory. Open() reads only the relationships and the workbook part;
+*          the shared strings and the styles are read with the first worksheet. Only worksheets are read; chart sheets are left out,
+*          as they are by the Worksheets collection of Excel. @n
+*          An .xlsb package has the same relationships, but its parts are BIFF12 records (see Biff12),
+*          which are read by Biff12Reader in the same streaming way.
+*/
+class XlsxReader : public NativeWorkbookSource
+{
+public:
+    XlsxReader();
+
+    virtual bool Open(const ELstring &filename);
+
+    virtual int CountSheets() const
+    {
+        return static_cast<int>(m_sheetNames.size());
+    }
+
+    virtual const std::string& GetSheetName(int index) const
+    {
+        return m_sheetNames[index];
+    }
+
+    virtual int GetActiveSheet() const
+    {
+        return m_activeSheet;
+    }
+
+    virtual bool LoadSharedParts();
+
+    virtual bool LoadSheet(int index, NativeSheet &sheet, const RowQueryFilter *filter) const;
+
+private:
+    bool OpenPart(const std::string &name, ZipEntryReader &input) const;
+    bool ParsePart(const std::string &name, XmlHandler &handler) const;
+
+private:
+    ZipArchive               m_archive;
+
+    std::vector<std::string> m_sheetNames;      // UTF-8
+    std::vector<std::string> m_sheetParts;      // names of the parts of the worksheets
+    int                      m_activeSheet;
+    bool                     m_binary;          // whether the parts are BIFF12 records (.xlsb)
+
+    bool                     m_date1904;        // dates are days since 1904-01-01 instead of 1900-01-01
+    std::string              m_sharedStringsPart;   // empty if none
+    std::string              m_stylesPart;          // empty if none
+    bool                     m_sharedPartsLoaded;
+    std::vector<bool>        m_dateStyles;      // whether a cell style (index of cellXfs) is a date format
+    NativeStringPool         m_sharedStrings;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //XLSXREADER_H_GUID_43225ABD_776B_43BB_8F26_51172D0335AA
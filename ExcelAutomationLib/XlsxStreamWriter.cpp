@@ -0,0 +1,1160 @@
+﻿/*!
+* @file    XlsxStreamWriter.cpp
+* @brief   Implementation file for class XlsxStreamWriter
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "XlsxStreamWriter.h"
+#include "ExcelTypedCodec.h"
+#include "ExcelUtil.h"
+#include "RangeCodec.h"
+#include "NativeSheet.h"
+#include "ZipWriter.h"
+#include "Biff12.h"
+#include "Utf8.h"
+#include "Noncopyable.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    const int    XlsxFileFormat = 51;       // xlOpenXMLWorkbook
+    const int    XlsbFileFormat = 50;       // xlExcel12
+    const size_t FlushSize      = 65536;    // a part is compressed in pieces of this size
+    const size_t MaxSheetName   = 31;
+
+    const char XmlDeclaration[] = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\r\n";
+    const char MainNamespace[]  = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+    const char RelsNamespace[]  = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+
+    // cellXfs 0 is "General", 1 is the built-in date format 22 ("m/d/yyyy h:mm")
+    const char StylesPart[] =
+        "<fonts count=\"1\"><font><sz val=\"11\"/><name val=\"Calibri\"/><family val=\"2\"/></font></fonts>"
+        "<fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill><fill><patternFill patternType=\"gray125\"/></fill></fills>"
+        "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+        "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+        "<cellXfs count=\"2\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+        "<xf numFmtId=\"22\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/></cellXfs>"
+        "<cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>";
+
+    const char ContentTypeBase[] = "application/vnd.openxmlformats-officedocument.spreadsheetml.";
+    const char BinaryContentTypeBase[] = "application/vnd.ms-excel.";
+
+    // The styles of StylesPart as BIFF12 records
+    void AppendBinaryStyles(std::string &out)
+    {
+        std::string body;
+
+        Biff12::AppendHeader(out, BRT_BeginStyleSheet, 0);
+
+        // Calibri 11 in the text color of the theme
+        Biff12::AppendUInt32(body, 1);
+        Biff12::AppendRecord(out, BRT_BeginFonts, body);
+        body.clear();
+        Biff12::AppendUInt16(body, 220);                // height in twips
+        Biff12::AppendUInt16(body, 0);
+        Biff12::AppendUInt16(body, 400);                // weight: normal
+        Biff12::AppendUInt16(body, 0);
+        body.append("\0\x02\0\0", 4);                 // underline, family (swiss), charset, unused
+        body.append("\x07\x01\0\0\0\0\0\xFF", 8);     // color: theme 1
+        body.push_back('\x02');                        // scheme: minor
+        Biff12::AppendWideString(body, "Calibri");
+        Biff12::AppendRecord(out, BRT_Font, body);
+        Biff12::AppendHeader(out, BRT_EndFonts, 0);
+
+        // the fills "none" and "gray125"
+        body.clear();
+        Biff12::AppendUInt32(body, 2);
+        Biff12::AppendRecord(out, BRT_BeginFills, body);
+        for (unsigned long pattern = 0; pattern <= 0x11; pattern += 0x11)
+        {
+            body.clear();
+            Biff12::AppendUInt32(body, pattern);
+            body.append("\x02\x40\0\0\0\0\0\xFF", 8);     // foreground: system color
+            body.append("\x02\x41\0\0\xFF\xFF\xFF\xFF", 8); // background: system color
+            body.append(48, '\0');                     // no gradient
+            Biff12::AppendRecord(out, BRT_Fill, body);
+        }
+        Biff12::AppendHeader(out, BRT_EndFills, 0);
+
+        // no border
+        body.clear();
+        Biff12::AppendUInt32(body, 1);
+        Biff12::AppendRecord(out, BRT_BeginBorders, body);
+        Biff12::AppendRecord(out, BRT_Border, std::string(51, '\0'));
+        Biff12::AppendHeader(out, BRT_EndBorders, 0);
+
+        // the XF of the "Normal" style, then the XFs of the cells: "General" and the date format 22
+        for (int group = 0; group < 2; ++group)
+        {
+            unsigned long count = (group == 0 ? 1 : 2);
+            body.clear();
+            Biff12::AppendUInt32(body, count);
+            Biff12::AppendRecord(out, group == 0 ? BRT_BeginCellStyleXfs : BRT_BeginCellXfs, body);
+
+            for (unsigned long i = 0; i < count; ++i)
+            {
+                body.clear();
+                Biff12::AppendUInt16(body, group == 0 ? 0xFFFF : 0);    // parent
+                Biff12::AppendUInt16(body, i == 0 ? 0 : 22);            // number format
+                body.append(8, '\0');                                  // font, fill, border, rotation, indent
+                Biff12::AppendUInt16(body, 0x1010);                     // bottom aligned, locked
+                body.push_back(static_cast<char>(i == 0 ? 0 : 1));      // the number format is applied
+                body.push_back('\0');
+                Biff12::AppendRecord(out, BRT_Xf, body);
+            }
+
+            Biff12::AppendHeader(out, group == 0 ? BRT_EndCellStyleXfs : BRT_EndCellXfs, 0);
+        }
+
+        body.clear();
+        Biff12::AppendUInt32(body, 1);
+        Biff12::AppendRecord(out, BRT_BeginStyles, body);
+        body.clear();
+        Biff12::AppendUInt32(body, 0);
+        Biff12::AppendUInt16(body, 1);                  // built-in
+        body.append("\0\xFF", 2);                       // built-in style 0 ("Normal"), no outline level
+        Biff12::AppendWideString(body, "Normal");
+        Biff12::AppendRecord(out, BRT_Style, body);
+        Biff12::AppendHeader(out, BRT_EndStyles, 0);
+
+        Biff12::AppendHeader(out, BRT_EndStyleSheet, 0);
+    }
+
+    void AppendInteger(std::string &out, long long value)
+    {
+        char buffer[24];
+        char *end = buffer + sizeof(buffer);
+        char *p = end;
+
+        unsigned long long n = value < 0 ? 0 - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+        do
+        {
+            *--p = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+
+        if (value < 0)
+            *--p = '-';
+
+        out.append(p, end);
+    }
+
+    // The shortest of 15 and 17 significant digits which gives the same double back
+    void AppendDouble(std::string &out, double value)
+    {
+        char buffer[32];
+#ifdef _MSC_VER
+        sprintf_s(buffer, sizeof(buffer), "%.15G", value);
+        if (strtod(buffer, NULL) != value)
+            sprintf_s(buffer, sizeof(buffer), "%.17G", value);
+#else
+        snprintf(buffer, sizeof(buffer), "%.15G", value);
+        if (strtod(buffer, NULL) != value)
+            snprintf(buffer, sizeof(buffer), "%.17G", value);
+#endif
+        out.append(buffer);
+    }
+
+    // "A" for 1, "Z" for 26, "AA" for 27, ...
+    void AppendColumnName(std::string &out, int column)
+    {
+        char buffer[4];
+        char *end = buffer + sizeof(buffer);
+        char *p = end;
+
+        for (; column > 0; column = (column - 1) / 26)
+            *--p = static_cast<char>('A' + (column - 1) % 26);
+
+        out.append(p, end);
+    }
+
+    bool IsHexDigit(char ch)
+    {
+        return (ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F') || (ch >= 'a' && ch <= 'f');
+    }
+
+    // Escape UTF-8 text for the content of an element or an attribute value
+    void AppendEscaped(std::string &out, const char *text, size_t length)
+    {
+        static const char hexDigits[] = "0123456789ABCDEF";
+
+        const char *end = text + length;
+        const char *plain = text;      // start of the characters which need no escape
+
+        for (const char *p = text; p != end; ++p)
+        {
+            const char *replacement;
+            unsigned char ch = static_cast<unsigned char>(*p);
+
+            if (ch == '&')
+                replacement = "&amp;";
+            else if (ch == '<')
+                replacement = "&lt;";
+            else if (ch == '>')
+                replacement = "&gt;";
+            else if (ch == '"')
+                replacement = "&quot;";
+            else if ((ch < 0x20 && ch != '\t' && ch != '\n' && ch != '\r') ||
+                (ch == '_' && end - p >= 7 && p[1] == 'x' && IsHexDigit(p[2]) && IsHexDigit(p[3]) &&
+                IsHexDigit(p[4]) && IsHexDigit(p[5]) && p[6] == '_'))
+                replacement = NULL;     // not allowed in XML, or taken as an escape by Excel: _xHHHH_
+            else
+                continue;
+
+            out.append(plain, p);
+            plain = p + 1;
+
+            if (replacement != NULL)
+            {
+                out.append(replacement);
+            }
+            else
+            {
+                out.append("_x00");
+                out.push_back(hexDigits[ch >> 4]);
+                out.push_back(hexDigits[ch & 0xF]);
+                out.push_back('_');
+            }
+        }
+
+        out.append(plain, end);
+    }
+
+    void AppendEscaped(std::string &out, const std::string &text)
+    {
+        AppendEscaped(out, text.data(), text.length());
+    }
+
+    // A text which is a decimal number becomes a number, as Excel converts it when it is written through COM
+    bool ParseNumber(const std::string &text, double &value)
+    {
+        if (text.empty())
+            return false;
+
+        for (size_t i = 0; i < text.length(); ++i)
+        {
+            char ch = text[i];
+            if (!((ch >= '0' && ch <= '9') || ch == '.' || ch == '-' || ch == '+' || ch == 'E' || ch == 'e'))
+                return false;
+        }
+
+        if (text[0] == 'E' || text[0] == 'e')
+            return false;
+
+        char *end;
+        value = strtod(text.c_str(), &end);
+        return end == text.c_str() + text.length();
+    }
+
+    // UTF-16 code units, little-endian => UTF-8
+    void AppendUtf16(std::string &out, const unsigned char *data, size_t units)
+    {
+        for (size_t i = 0; i < units; ++i)
+        {
+            unsigned long ch = data[2 * i] | (static_cast<unsigned long>(data[2 * i + 1]) << 8);
+            if (ch >= 0xD800 && ch < 0xDC00 && i + 1 < units)
+            {
+                unsigned long low = data[2 * i + 2] | (static_cast<unsigned long>(data[2 * i + 3]) << 8);
+                if (low >= 0xDC00 && low < 0xE000)
+                {
+                    ch = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
+                }
+            }
+
+            Utf8::AppendCodePoint(out, ch);
+        }
+    }
+
+    bool IsFinite(double value)
+    {
+        return value == value && value - value == 0;
+    }
+
+    // Sheet names are compared case-insensitively (only ASCII letters are folded)
+    ELstring FoldSheetName(const ELstring &name)
+    {
+        ELstring folded(name);
+        for (size_t i = 0; i < folded.length(); ++i)
+        {
+            if (folded[i] >= ELtext('a') && folded[i] <= ELtext('z'))
+                folded[i] = static_cast<ELchar>(folded[i] - ELtext('a') + ELtext('A'));
+        }
+        return folded;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Definition and implementation of class XlsxStreamWriterImpl
+
+/*!
+* @brief Class XlsxStreamWriterImpl inplements XlsxStreamWriter's interfaces.
+* @details The worksheet being written is the open entry of the zip file. The other parts are written
+*          by Close(), since the shared strings are known only after the last row. @n
+*          For an .xlsb file the parts are BIFF12 records instead of XML, in the same package: a cell is a
+*          record of 8 to 16 bytes, with nothing to format or escape.
+*/
+class XlsxStreamWriterImpl : public BodyBase, public Noncopyable
+{
+    // All members are private. Only the friend class XlsxStreamWriter can access members of XlsxStreamWriterImpl.
+    friend class XlsxStreamWriter;
+
+private:
+    typedef std::map<std::string, size_t> StringMap;
+
+    /*!
+    * @brief The visitor of RangeCodec::Decode() for WriteData()
+    */
+    class DataVisitor
+    {
+    public:
+        explicit DataVisitor(XlsxStreamWriterImpl &writer): m_writer(writer), m_columns(0), m_inRow(false) { }
+
+        bool Begin(int rows, int columns)
+        {
+            m_columns = columns;
+            return columns <= XlsxStreamWriter::MaxColumns && rows <= XlsxStreamWriter::MaxRows - m_writer.CountRows();
+        }
+
+        bool Value(int /* row */, int column, const ELchar *value, size_t length)
+        {
+            if (column == 0)
+            {
+                if (!m_writer.BeginRow())
+                    return false;
+                m_inRow = true;
+            }
+
+            if (length > 0)
+                m_writer.PutText(column + 1, Utf8::FromELstring(ELstring(value, length)));
+
+            if (column + 1 == m_columns)
+            {
+                m_inRow = false;
+                return m_writer.EndRow();
+            }
+
+            return true;
+        }
+
+        /*!
+        * @brief End the row which is cut by dirty data, so that the XML stays well-formed.
+        */
+        void Finish()
+        {
+            if (m_inRow)
+                m_writer.EndRow();
+        }
+
+    private:
+        XlsxStreamWriterImpl &m_writer;
+        int                   m_columns;
+        bool                  m_inRow;
+    };
+
+private:
+    explicit XlsxStreamWriterImpl(bool binary):
+        m_binary(binary), m_inSheet(false), m_rows(0), m_stringCount(0), m_closed(false), m_failed(false)
+    {
+    }
+
+    virtual ~XlsxStreamWriterImpl()
+    {
+        Close();
+    }
+
+    bool Open(const ELstring &filename)
+    {
+        return m_zip.Open(filename);
+    }
+
+    bool AddWorksheet(const ELstring &name);
+    bool WriteRow(const std::vector<ELstring> &values);
+    bool WriteData(const ELstring &data);
+    bool WriteTyped(const std::vector<unsigned char> &data);
+
+    int CountRows() const
+    {
+        return m_rows;
+    }
+
+    bool Close();
+
+    bool BeginSheet(const ELstring &name);
+    bool EndSheet();
+
+    bool BeginRow();
+    bool EndRow();
+
+    // <begin> Put a cell into the current row
+    void BeginCell(int column, const char *attributes)
+    {
+        m_part.append("<c r=\"");
+        AppendColumnName(m_part, column);
+        AppendInteger(m_part, m_rows);
+        m_part.append("\"");
+        m_part.append(attributes);
+        m_part.append("><v>");
+    }
+
+    void EndCell()
+    {
+        m_part.append("</v></c>");
+    }
+
+    // The record of a cell (BIFF12), up to its value of @e valueSize bytes
+    void BeginCellRecord(unsigned long type, int column, unsigned long style, size_t valueSize)
+    {
+        Biff12::AppendHeader(m_part, type, 8 + valueSize);
+        Biff12::AppendUInt32(m_part, column - 1);
+        Biff12::AppendUInt32(m_part, style);     // and no flags
+    }
+
+    void PutText(int column, const std::string &text);
+    void PutString(int column, const std::string &text);
+    void PutNumber(int column, double value);
+    void PutInteger(int column, long long value);
+    void PutBool(int column, bool value);
+    void PutError(int column, const char *text);
+    void PutDate(int column, double value);
+    // <end> Put a cell into the current row
+
+    bool Flush();
+    bool WritePart(const std::string &name, const std::string &content);
+    bool WriteSharedStrings();
+    bool WriteWorkbook();
+
+    // ".bin" or ".xml"
+    const char* GetPartExtension() const
+    {
+        return m_binary ? ".bin" : ".xml";
+    }
+
+private:
+    ZipWriter                        m_zip;
+    bool                             m_binary;          // whether the parts are BIFF12 records (.xlsb)
+    std::vector<std::string>         m_sheetNames;      // in UTF-8
+    std::vector<ELstring>            m_sheetKeys;       // FoldSheetName() of the names
+    bool                             m_inSheet;         // whether the entry of a worksheet is open
+    int                              m_rows;            // rows of the current worksheet
+    std::string                      m_part;            // XML (or records) not compressed yet
+
+    StringMap                        m_strings;         // text => index in the shared strings
+    std::vector<const std::string*>  m_stringOrder;     // keys of m_strings by index
+    size_t                           m_stringCount;     // number of cells which refer to a shared string
+
+    bool                             m_closed;
+    bool                             m_failed;
+};
+
+
+bool XlsxStreamWriterImpl::AddWorksheet(const ELstring &name)
+{
+    if (m_closed || m_failed)
+        return false;
+
+    if (name.empty() || name.length() > MaxSheetName || name.find_first_of(ELtext(":\\/?*[]")) != ELstring::npos ||
+        name[0] == ELtext('\'') || name[name.length() - 1] == ELtext('\''))
+        return false;
+
+    ELstring key = FoldSheetName(name);
+    for (size_t i = 0; i < m_sheetKeys.size(); ++i)
+    {
+        if (m_sheetKeys[i] == key)
+            return false;
+    }
+
+    return EndSheet() && BeginSheet(name);
+}
+
+
+bool XlsxStreamWriterImpl::WriteRow(const std::vector<ELstring> &values)
+{
+    if (values.size() > XlsxStreamWriter::MaxColumns || !BeginRow())
+        return false;
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (!values[i].empty())
+            PutText(static_cast<int>(i + 1), Utf8::FromELstring(values[i]));
+    }
+
+    return EndRow();
+}
+
+
+bool XlsxStreamWriterImpl::WriteData(const ELstring &data)
+{
+    DataVisitor visitor(*this);
+    bool succeeded = RangeCodec::Decode(data.c_str(), data.length(), visitor);
+    visitor.Finish();
+    return succeeded;
+}
+
+
+bool XlsxStreamWriterImpl::WriteTyped(const std::vector<unsigned char> &data)
+{
+    if (data.empty())
+        return false;
+
+    ExcelTypedReader reader(&data[0], data.size());
+
+    int rows = 0;
+    int columns = 0;
+    if (!reader.ReadHeader(rows, columns) || columns > XlsxStreamWriter::MaxColumns ||
+        rows > XlsxStreamWriter::MaxRows - m_rows)
+        return false;
+
+    ExcelTypedValue value;
+    std::string text;
+
+    for (int row = 0; row < rows; ++row)
+    {
+        if (!BeginRow())
+            return false;
+
+        for (int column = 1; column <= columns; ++column)
+        {
+            if (!reader.Next(value))
+            {
+                EndRow();
+                return false;
+            }
+
+            switch (value.tag)
+            {
+            case ETT_Empty:
+                break;
+
+            case ETT_Double:
+                PutNumber(column, value.number);
+                break;
+
+            case ETT_Int64:
+                PutInteger(column, value.integer);
+                break;
+
+            case ETT_Bool:
+                PutBool(column, value.boolean);
+                break;
+
+            case ETT_Error:
+                {
+                    // the SCODE of a VT_ERROR VARIANT keeps the xlErrXxx constant in the low word
+                    const char *errorText = NativeSheet::GetErrorText(value.error & 0xFFFF);
+                    PutError(column, errorText != NULL ? errorText : "#N/A");
+                }
+                break;
+
+            case ETT_Date:
+                PutDate(column, value.number);
+                break;
+
+            case ETT_String16:
+                text.clear();
+                AppendUtf16(text, value.text, value.textLength);
+                PutString(column, text);
+                break;
+
+            case ETT_String8:
+                text.assign(reinterpret_cast<const char*>(value.text), value.textLength);
+                PutString(column, text);
+                break;
+            }
+        }
+
+        if (!EndRow())
+            return false;
+    }
+
+    return true;
+}
+
+
+bool XlsxStreamWriterImpl::Close()
+{
+    if (m_closed)
+        return !m_failed;
+
+    m_closed = true;
+
+    if (!m_failed && m_sheetNames.empty())
+        BeginSheet(ELtext("Sheet1"));   // a workbook has one worksheet at least
+
+    if (!m_failed)
+        EndSheet();
+
+    if (!m_failed)
+        WriteSharedStrings();
+
+    if (!m_failed)
+        WriteWorkbook();
+
+    if (!m_zip.Close())
+        m_failed = true;
+
+    return !m_failed;
+}
+
+
+bool XlsxStreamWriterImpl::BeginSheet(const ELstring &name)
+{
+    assert(!m_inSheet);
+
+    m_sheetNames.push_back(Utf8::FromELstring(name));
+    m_sheetKeys.push_back(FoldSheetName(name));
+
+    std::string part = "xl/worksheets/sheet";
+    AppendInteger(part, static_cast<long long>(m_sheetNames.size()));
+    part.append(GetPartExtension());
+
+    if (!m_zip.BeginEntry(part))
+    {
+        m_failed = true;
+        return false;
+    }
+
+    m_inSheet = true;
+    m_rows = 0;
+
+    if (m_binary)
+    {
+        m_part.clear();
+        Biff12::AppendHeader(m_part, BRT_BeginSheet, 0);
+        Biff12::AppendHeader(m_part, BRT_BeginSheetData, 0);
+        return true;
+    }
+
+    m_part.assign(XmlDeclaration);
+    m_part.append("<worksheet xmlns=\"");
+    m_part.append(MainNamespace);
+    m_part.append("\" xmlns:r=\"");
+    m_part.append(RelsNamespace);
+    m_part.append("\"><sheetData>");
+
+    return true;
+}
+
+
+bool XlsxStreamWriterImpl::EndSheet()
+{
+    if (!m_inSheet)
+        return true;
+
+    m_inSheet = false;
+
+    if (m_binary)
+    {
+        Biff12::AppendHeader(m_part, BRT_EndSheetData, 0);
+        Biff12::AppendHeader(m_part, BRT_EndSheet, 0);
+    }
+    else
+    {
+        m_part.append("</sheetData></worksheet>");
+    }
+
+    if (!Flush() || !m_zip.EndEntry())
+        m_failed = true;
+
+    return !m_failed;
+}
+
+
+bool XlsxStreamWriterImpl::BeginRow()
+{
+    if (m_closed || m_failed)
+        return false;
+
+    if (!m_inSheet && !BeginSheet(ELtext("Sheet1")))
+        return false;
+
+    if (m_rows == XlsxStreamWriter::MaxRows)
+        return false;
+
+    ++m_rows;
+
+    if (m_binary)
+    {
+        // the row, its style, its height (15 points in twips), flags, and no column spans
+        Biff12::AppendHeader(m_part, BRT_RowHdr, 17);
+        Biff12::AppendUInt32(m_part, m_rows - 1);
+        Biff12::AppendUInt32(m_part, 0);
+        Biff12::AppendUInt16(m_part, 300);
+        m_part.append(7, '\0');
+        return true;
+    }
+
+    m_part.append("<row r=\"");
+    AppendInteger(m_part, m_rows);
+    m_part.append("\">");
+
+    return true;
+}
+
+
+bool XlsxStreamWriterImpl::EndRow()
+{
+    if (!m_binary)
+        m_part.append("</row>");
+
+    return m_part.size() < FlushSize || Flush();
+}
+
+
+void XlsxStreamWriterImpl::PutText(int column, const std::string &text)
+{
+    double number;
+    if (ParseNumber(text, number))
+        PutNumber(column, number);
+    else
+        PutString(column, text);
+}
+
+
+void XlsxStreamWriterImpl::PutString(int column, const std::string &text)
+{
+    std::pair<StringMap::iterator, bool> result = m_strings.insert(StringMap::value_type(text, m_strings.size()));
+    if (result.second)
+        m_stringOrder.push_back(&result.first->first);
+
+    ++m_stringCount;
+
+    if (m_binary)
+    {
+        BeginCellRecord(BRT_CellIsst, column, 0, 4);
+        Biff12::AppendUInt32(m_part, static_cast<unsigned long>(result.first->second));
+        return;
+    }
+
+    BeginCell(column, " t=\"s\"");
+    AppendInteger(m_part, static_cast<long long>(result.first->second));
+    EndCell();
+}
+
+
+void XlsxStreamWriterImpl::PutNumber(int column, double value)
+{
+    if (!IsFinite(value))
+    {
+        PutError(column, "#NUM!");     // a cell cannot hold an infinity or a NaN
+        return;
+    }
+
+    if (m_binary)
+    {
+        BeginCellRecord(BRT_CellReal, column, 0, 8);
+        Biff12::AppendDouble(m_part, value);
+        return;
+    }
+
+    BeginCell(column, "");
+    AppendDouble(m_part, value);
+    EndCell();
+}
+
+
+void XlsxStreamWriterImpl::PutInteger(int column, long long value)
+{
+    if (m_binary)
+    {
+        // an RK number holds a 30-bit integer in 4 bytes
+        if (value >= -0x20000000LL && value < 0x20000000LL)
+        {
+            BeginCellRecord(BRT_CellRk, column, 0, 4);
+            Biff12::AppendUInt32(m_part, static_cast<unsigned long>((value << 2) | 2) & 0xFFFFFFFFUL);
+        }
+        else
+        {
+            BeginCellRecord(BRT_CellReal, column, 0, 8);
+            Biff12::AppendDouble(m_part, static_cast<double>(value));
+        }
+        return;
+    }
+
+    BeginCell(column, "");
+    AppendInteger(m_part, value);
+    EndCell();
+}
+
+
+void XlsxStreamWriterImpl::PutBool(int column, bool value)
+{
+    if (m_binary)
+    {
+        BeginCellRecord(BRT_CellBool, column, 0, 1);
+        m_part.push_back(value ? '\x01' : '\0');
+        return;
+    }
+
+    BeginCell(column, " t=\"b\"");
+    m_part.push_back(value ? '1' : '0');
+    EndCell();
+}
+
+
+void XlsxStreamWriterImpl::PutError(int column, const char *text)
+{
+    if (m_binary)
+    {
+        // the codes of BIFF are the xlErrXxx constants less 2000
+        int code = NativeSheet::GetErrorCode(text, strlen(text));
+        BeginCellRecord(BRT_CellError, column, 0, 1);
+        m_part.push_back(static_cast<char>(code != 0 ? code - 2000 : 0x2A));
+        return;
+    }
+
+    BeginCell(column, " t=\"e\"");
+    m_part.append(text);
+    EndCell();
+}
+
+
+void XlsxStreamWriterImpl::PutDate(int column, double value)
+{
+    if (!IsFinite(value))
+    {
+        PutError(column, "#NUM!");
+        return;
+    }
+
+    // OLE Automation date => serial number: Excel takes 1900 as a leap year, OLE Automation does not
+    if (value >= 1 && value < 61)
+        value -= 1;
+
+    if (m_binary)
+    {
+        BeginCellRecord(BRT_CellReal, column, 1, 8);
+        Biff12::AppendDouble(m_part, value);
+        return;
+    }
+
+    BeginCell(column, " s=\"1\"");
+    AppendDouble(m_part, value);
+    EndCell();
+}
+
+
+bool XlsxStreamWriterImpl::Flush()
+{
+    if (!m_part.empty() && !m_zip.Write(reinterpret_cast<const unsigned char*>(m_part.data()), m_part.size()))
+        m_failed = true;
+
+    m_part.clear();
+    return !m_failed;
+}
+
+
+bool XlsxStreamWriterImpl::WritePart(const std::string &name, const std::string &content)
+{
+    if (!m_zip.BeginEntry(name) ||
+        !m_zip.Write(reinterpret_cast<const unsigned char*>(content.data()), content.size()) ||
+        !m_zip.EndEntry())
+        m_failed = true;
+
+    return !m_failed;
+}
+
+
+// The shared strings may be many, so they are compressed in pieces as the rows are
+bool XlsxStreamWriterImpl::WriteSharedStrings()
+{
+    if (!m_zip.BeginEntry(std::string("xl/sharedStrings") + GetPartExtension()))
+    {
+        m_failed = true;
+        return false;
+    }
+
+    std::string item;
+    if (m_binary)
+    {
+        m_part.clear();
+        Biff12::AppendHeader(m_part, BRT_BeginSst, 8);
+        Biff12::AppendUInt32(m_part, static_cast<unsigned long>(m_stringCount));
+        Biff12::AppendUInt32(m_part, static_cast<unsigned long>(m_stringOrder.size()));
+    }
+    else
+    {
+        m_part.assign(XmlDeclaration);
+        m_part.append("<sst xmlns=\"");
+        m_part.append(MainNamespace);
+        m_part.append("\" count=\"");
+        AppendInteger(m_part, static_cast<long long>(m_stringCount));
+        m_part.append("\" uniqueCount=\"");
+        AppendInteger(m_part, static_cast<long long>(m_stringOrder.size()));
+        m_part.append("\">");
+    }
+
+    for (size_t i = 0; i < m_stringOrder.size(); ++i)
+    {
+        if (m_binary)
+        {
+            // plain text: no runs, no phonetic data
+            item.assign(1, '\0');
+            Biff12::AppendWideString(item, *m_stringOrder[i]);
+            Biff12::AppendRecord(m_part, BRT_SstItem, item);
+        }
+        else
+        {
+            m_part.append("<si><t xml:space=\"preserve\">");
+            AppendEscaped(m_part, *m_stringOrder[i]);
+            m_part.append("</t></si>");
+        }
+
+        if (m_part.size() >= FlushSize && !Flush())
+            return false;
+    }
+
+    if (m_binary)
+        Biff12::AppendHeader(m_part, BRT_EndSst, 0);
+    else
+        m_part.append("</sst>");
+
+    if (!Flush() || !m_zip.EndEntry())
+        m_failed = true;
+
+    return !m_failed;
+}
+
+
+// The workbook part, the styles, the relationships and the content types
+bool XlsxStreamWriterImpl::WriteWorkbook()
+{
+    size_t sheetCount = m_sheetNames.size();
+    std::string extension(GetPartExtension());
+
+    std::string xml;
+    if (m_binary)
+    {
+        AppendBinaryStyles(xml);
+    }
+    else
+    {
+        xml.assign(XmlDeclaration);
+        xml.append("<styleSheet xmlns=\"");
+        xml.append(MainNamespace);
+        xml.append("\">");
+        xml.append(StylesPart);
+        xml.append("</styleSheet>");
+    }
+    if (!WritePart("xl/styles" + extension, xml))
+        return false;
+
+    if (m_binary)
+    {
+        std::string body, id;
+
+        xml.clear();
+        Biff12::AppendHeader(xml, BRT_BeginBook, 0);
+        Biff12::AppendHeader(xml, BRT_BeginBundleShs, 0);
+        for (size_t i = 0; i < sheetCount; ++i)
+        {
+            // visible, the sheet id, the relationship id, the name
+            id.assign("rId");
+            AppendInteger(id, static_cast<long long>(i + 1));
+
+            body.clear();
+            Biff12::AppendUInt32(body, 0);
+            Biff12::AppendUInt32(body, static_cast<unsigned long>(i + 1));
+            Biff12::AppendWideString(body, id);
+            Biff12::AppendWideString(body, m_sheetNames[i]);
+            Biff12::AppendRecord(xml, BRT_BundleSh, body);
+        }
+        Biff12::AppendHeader(xml, BRT_EndBundleShs, 0);
+        Biff12::AppendHeader(xml, BRT_EndBook, 0);
+    }
+    else
+    {
+        xml.assign(XmlDeclaration);
+        xml.append("<workbook xmlns=\"");
+        xml.append(MainNamespace);
+        xml.append("\" xmlns:r=\"");
+        xml.append(RelsNamespace);
+        xml.append("\"><sheets>");
+        for (size_t i = 0; i < sheetCount; ++i)
+        {
+            xml.append("<sheet name=\"");
+            AppendEscaped(xml, m_sheetNames[i]);
+            xml.append("\" sheetId=\"");
+            AppendInteger(xml, static_cast<long long>(i + 1));
+            xml.append("\" r:id=\"rId");
+            AppendInteger(xml, static_cast<long long>(i + 1));
+            xml.append("\"/>");
+        }
+        xml.append("</sheets></workbook>");
+    }
+    if (!WritePart("xl/workbook" + extension, xml))
+        return false;
+
+    // rId1..rIdN are the worksheets, followed by the styles and the shared strings
+    xml.assign(XmlDeclaration);
+    xml.append("<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">");
+    for (size_t i = 0; i <= sheetCount + 1; ++i)
+    {
+        xml.append("<Relationship Id=\"rId");
+        AppendInteger(xml, static_cast<long long>(i + 1));
+        xml.append("\" Type=\"");
+        xml.append(RelsNamespace);
+        if (i < sheetCount)
+        {
+            xml.append("/worksheet\" Target=\"worksheets/sheet");
+            AppendInteger(xml, static_cast<long long>(i + 1));
+        }
+        else if (i == sheetCount)
+        {
+            xml.append("/styles\" Target=\"styles");
+        }
+        else
+        {
+            xml.append("/sharedStrings\" Target=\"sharedStrings");
+        }
+        xml.append(extension);
+        xml.append("\"/>");
+    }
+    xml.append("</Relationships>");
+    if (!WritePart("xl/_rels/workbook" + extension + ".rels", xml))
+        return false;
+
+    xml.assign(XmlDeclaration);
+    xml.append("<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">");
+    xml.append("<Relationship Id=\"rId1\" Type=\"");
+    xml.append(RelsNamespace);
+    xml.append("/officeDocument\" Target=\"xl/workbook");
+    xml.append(extension);
+    xml.append("\"/></Relationships>");
+    if (!WritePart("_rels/.rels", xml))
+        return false;
+
+    // the content types of the parts: the XML ones, or the binary ones
+    const char *base = (m_binary ? BinaryContentTypeBase : ContentTypeBase);
+    const char *types[4][2] =
+    {
+        { "sheet.main+xml",     "sheet.binary.macroEnabled.main" },
+        { "worksheet+xml",      "worksheet" },
+        { "styles+xml",         "styles" },
+        { "sharedStrings+xml",  "sharedStrings" },
+    };
+    int column = (m_binary ? 1 : 0);
+
+    xml.assign(XmlDeclaration);
+    xml.append("<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">");
+    xml.append("<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>");
+    xml.append("<Default Extension=\"xml\" ContentType=\"application/xml\"/>");
+    xml.append("<Override PartName=\"/xl/workbook");
+    xml.append(extension);
+    xml.append("\" ContentType=\"");
+    xml.append(base);
+    xml.append(types[0][column]);
+    xml.append("\"/>");
+    for (size_t i = 0; i < sheetCount; ++i)
+    {
+        xml.append("<Override PartName=\"/xl/worksheets/sheet");
+        AppendInteger(xml, static_cast<long long>(i + 1));
+        xml.append(extension);
+        xml.append("\" ContentType=\"");
+        xml.append(base);
+        xml.append(types[1][column]);
+        xml.append("\"/>");
+    }
+    xml.append("<Override PartName=\"/xl/styles");
+    xml.append(extension);
+    xml.append("\" ContentType=\"");
+    xml.append(base);
+    xml.append(types[2][column]);
+    xml.append("\"/>");
+    xml.append("<Override PartName=\"/xl/sharedStrings");
+    xml.append(extension);
+    xml.append("\" ContentType=\"");
+    xml.append(base);
+    xml.append(types[3][column]);
+    xml.append("\"/>");
+    xml.append("</Types>");
+
+    return WritePart("[Content_Types].xml", xml);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class XlsxStreamWriter
+
+XlsxStreamWriter XlsxStreamWriter::Create(const ELstring &filename)
+{
+    int format = ExcelUtil::GuessFileFormatFromFilename(filename);
+    if (format != XlsxFileFormat && format != XlsbFileFormat)
+        return XlsxStreamWriter();
+
+    XlsxStreamWriter writer(new XlsxStreamWriterImpl(format == XlsbFileFormat));
+    if (!writer.Body().Open(filename))
+        return XlsxStreamWriter();
+
+    return writer;
+}
+
+
+bool XlsxStreamWriter::AddWorksheet(const ELstring &name)
+{
+    return Body().AddWorksheet(name);
+}
+
+
+bool XlsxStreamWriter::WriteRow(const std::vector<ELstring> &values)
+{
+    return Body().WriteRow(values);
+}
+
+
+bool XlsxStreamWriter::WriteData(const ELstring &data)
+{
+    return Body().WriteData(data);
+}
+
+
+bool XlsxStreamWriter::WriteTyped(const std::vector<unsigned char> &data)
+{
+    return Body().WriteTyped(data);
+}
+
+
+int XlsxStreamWriter::CountRows() const
+{
+    return Body().CountRows();
+}
+
+
+bool XlsxStreamWriter::Close()
+{
+    return Body().Close();
+}
+
+
+// <begin> Handle/Body pattern implementation
+
+XlsxStreamWriter::XlsxStreamWriter(XlsxStreamWriterImpl *impl): HandleBase(impl)
+{
+}
+
+
+XlsxStreamWriterImpl& XlsxStreamWriter::Body() const
+{
+    return dynamic_cast<XlsxStreamWriterImpl&>(HandleBase::Body());
+}
+
+// <end> Handle/Body pattern implementation
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
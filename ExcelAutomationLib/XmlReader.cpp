@@ -0,0 +1,359 @@
+﻿/*!
+* @file    XmlReader.cpp
+* @brief   Implementation file for class XmlReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstring>
+#include <cstdlib>
+#include "XmlReader.h"
+#include "Utf8.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    const size_t BufferSize = 65536;
+
+    inline bool IsSpace(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+    }
+
+    inline bool IsNameEnd(char ch)
+    {
+        return IsSpace(ch) || ch == '>' || ch == '/' || ch == '=';
+    }
+}
+
+
+XmlReader::XmlReader(ByteSource &input): m_input(input), m_buffer(BufferSize), m_pos(0), m_end(0), m_stopped(false)
+{
+}
+
+
+bool XmlReader::Parse(XmlHandler &handler)
+{
+    m_stopped = false;
+    m_text.clear();
+
+    char ch;
+    while (!m_stopped && Next(ch))
+    {
+        if (ch == '<')
+        {
+            FlushText(handler);
+            if (!ReadMarkup(handler))
+                return false;
+        }
+        else if (ch == '&')
+        {
+            if (!ReadEntity(m_text))
+                return false;
+        }
+        else
+        {
+            // take the whole run of plain text in the buffer at once
+            size_t start = m_pos - 1;
+            while (m_pos < m_end && m_buffer[m_pos] != '<' && m_buffer[m_pos] != '&')
+                ++m_pos;
+            m_text.append(reinterpret_cast<const char*>(&m_buffer[start]), m_pos - start);
+        }
+    }
+
+    if (m_stopped)
+        return true;
+
+    FlushText(handler);
+    return !m_input.Failed();
+}
+
+
+bool XmlReader::Fill()
+{
+    m_pos = 0;
+    m_end = m_input.Read(&m_buffer[0], m_buffer.size());
+    return m_end > 0;
+}
+
+
+void XmlReader::FlushText(XmlHandler &handler)
+{
+    if (!m_text.empty())
+    {
+        handler.Characters(m_text.data(), m_text.length());
+        m_text.clear();
+    }
+}
+
+
+// Skip everything up to and including @e terminator (3 characters at most)
+bool XmlReader::SkipPast(const char *terminator)
+{
+    size_t length = strlen(terminator);
+    char window[4] = { 0, 0, 0, 0 };
+
+    char ch;
+    while (Next(ch))
+    {
+        memmove(window, window + 1, 2);
+        window[2] = ch;
+        if (memcmp(window + 3 - length, terminator, length) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+
+// Read a name starting with @e ch; @e ch receives the character after the name
+bool XmlReader::ReadName(char &ch, std::string &name)
+{
+    name.clear();
+    while (!IsNameEnd(ch))
+    {
+        name.push_back(ch);
+
+        // take the rest of the name in the buffer at once
+        size_t start = m_pos;
+        while (m_pos < m_end && !IsNameEnd(static_cast<char>(m_buffer[m_pos])))
+            ++m_pos;
+        name.append(reinterpret_cast<const char*>(&m_buffer[0]) + start, m_pos - start);
+
+        if (!Next(ch))
+            return false;
+    }
+
+    return !name.empty();
+}
+
+
+// Decode an entity reference; the '&' is consumed already
+bool XmlReader::ReadEntity(std::string &text)
+{
+    char entity[12];
+    size_t length = 0;
+
+    char ch;
+    for (;;)
+    {
+        if (!Next(ch))
+            return false;
+        if (ch == ';')
+            break;
+        if (length == sizeof(entity) - 1)
+            return false;
+        entity[length++] = ch;
+    }
+    entity[length] = '\0';
+
+    if (entity[0] == '#')
+    {
+        char *end;
+        unsigned long code = (entity[1] == 'x' ? strtoul(entity + 2, &end, 16) : strtoul(entity + 1, &end, 10));
+        if (*end != '\0' || code == 0 || code > 0x10FFFF)
+            return false;
+        Utf8::AppendCodePoint(text, code);
+    }
+    else if (strcmp(entity, "lt") == 0)
+        text.push_back('<');
+    else if (strcmp(entity, "gt") == 0)
+        text.push_back('>');
+    else if (strcmp(entity, "amp") == 0)
+        text.push_back('&');
+    else if (strcmp(entity, "quot") == 0)
+        text.push_back('"');
+    else if (strcmp(entity, "apos") == 0)
+        text.push_back('\'');
+    else
+        return false;   // no DTD, so no other entities
+
+    return true;
+}
+
+
+// Read what follows a '<'
+bool XmlReader::ReadMarkup(XmlHandler &handler)
+{
+    char ch;
+    if (!Next(ch))
+        return false;
+
+    if (ch == '/')
+        return ReadEndTag(handler);
+
+    if (ch == '?')
+        return SkipPast("?>");  // XML declaration or processing instruction
+
+    if (ch != '!')
+        return ReadStartTag(ch, handler);
+
+    if (!Next(ch))
+        return false;
+
+    if (ch == '-')
+        return Next(ch) && ch == '-' && SkipPast("-->");
+
+    if (ch == '[')
+    {
+        // <![CDATA[ ... ]]>
+        for (const char *p = "CDATA["; *p != '\0'; ++p)
+        {
+            if (!Next(ch) || ch != *p)
+                return false;
+        }
+
+        while (Next(ch))
+        {
+            m_text.push_back(ch);
+            size_t n = m_text.length();
+            if (ch == '>' && n >= 3 && m_text[n - 2] == ']' && m_text[n - 3] == ']')
+            {
+                m_text.resize(n - 3);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // <!DOCTYPE ...>, may have an internal subset in brackets
+    int depth = 0;
+    do
+    {
+        if (ch == '[')
+            ++depth;
+        else if (ch == ']')
+            --depth;
+        else if (ch == '>' && depth == 0)
+            return true;
+    } while (Next(ch));
+
+    return false;
+}
+
+
+bool XmlReader::ReadStartTag(char ch, XmlHandler &handler)
+{
+    if (!ReadName(ch, m_name))
+        return false;
+    ToLocalName(m_name);
+
+    m_attributes.m_count = 0;
+    for (;;)
+    {
+        while (IsSpace(ch))
+        {
+            if (!Next(ch))
+                return false;
+        }
+
+        if (ch == '>')
+        {
+            handler.StartElement(m_name, m_attributes);
+            return true;
+        }
+
+        if (ch == '/')
+        {
+            if (!Next(ch) || ch != '>')
+                return false;
+            handler.StartElement(m_name, m_attributes);
+            handler.EndElement(m_name);
+            return true;
+        }
+
+        // an attribute: name = "value"
+        if (m_attributes.m_count == m_attributes.m_items.size())
+            m_attributes.m_items.resize(m_attributes.m_count + 1);
+        std::pair<std::string, std::string> &item = m_attributes.m_items[m_attributes.m_count];
+
+        if (!ReadName(ch, item.first))
+            return false;
+
+        // namespace declarations are not reported, the names are matched by local name anyway
+        bool isNamespace = (item.first.compare(0, 5, "xmlns") == 0 && (item.first.length() == 5 || item.first[5] == ':'));
+        ToLocalName(item.first);
+
+        while (IsSpace(ch))
+        {
+            if (!Next(ch))
+                return false;
+        }
+        if (ch != '=' || !Next(ch))
+            return false;
+        while (IsSpace(ch))
+        {
+            if (!Next(ch))
+                return false;
+        }
+        if (ch != '"' && ch != '\'')
+            return false;
+
+        char quote = ch;
+        item.second.clear();
+        for (;;)
+        {
+            if (!Next(ch))
+                return false;
+            if (ch == quote)
+                break;
+            if (ch == '&')
+            {
+                if (!ReadEntity(item.second))
+                    return false;
+                continue;
+            }
+
+            item.second.push_back(ch);
+
+            // take the rest of the value in the buffer at once
+            size_t start = m_pos;
+            while (m_pos < m_end && m_buffer[m_pos] != quote && m_buffer[m_pos] != '&')
+                ++m_pos;
+            item.second.append(reinterpret_cast<const char*>(&m_buffer[0]) + start, m_pos - start);
+        }
+
+        if (!isNamespace)
+            ++m_attributes.m_count;
+        if (!Next(ch))
+            return false;
+    }
+}
+
+
+bool XmlReader::ReadEndTag(XmlHandler &handler)
+{
+    char ch;
+    if (!Next(ch) || !ReadName(ch, m_name))
+        return false;
+    ToLocalName(m_name);
+
+    while (IsSpace(ch))
+    {
+        if (!Next(ch))
+            return false;
+    }
+    if (ch != '>')
+        return false;
+
+    handler.EndElement(m_name);
+    return true;
+}
+
+
+// Remove the namespace prefix of a name
+void XmlReader::ToLocalName(std::string &name)
+{
+    std::string::size_type colon = name.find(':');
+    if (colon != std::string::npos)
+        name.erase(0, colon + 1);
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
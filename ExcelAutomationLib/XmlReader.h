@@ -0,0 +1,152 @@
+﻿/*!
+* @file    XmlReader.h
+* @brief   Header file for class XmlReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef XMLREADER_H_GUID_FE4A5564_3B6C_4217_8657_822272AD5D4D
+#define XMLREADER_H_GUID_FE4A5564_3B6C_4217_8657_822272AD5D4D
+
+
+#include <string>
+#include <vector>
+#include "LibDef.h"
+#include "ByteSource.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class XmlAttributes holds the attributes of an element, by local name (without the prefix).
+*/
+class XmlAttributes
+{
+public:
+    XmlAttributes(): m_count(0) { }
+
+    size_t Count() const
+    {
+        return m_count;
+    }
+
+    const std::string& GetName(size_t index) const
+    {
+        return m_items[index].first;
+    }
+
+    const std::string& GetValue(size_t index) const
+    {
+        return m_items[index].second;
+    }
+
+    /*!
+    * @return The value of the attribute, NULL if there is no such attribute.
+    */
+    const std::string* Find(const char *name) const
+    {
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            if (m_items[i].first == name)
+                return &m_items[i].second;
+        }
+        return NULL;
+    }
+
+private:
+    friend class XmlReader;
+
+    // The strings are reused from element to element, so they keep their buffers
+    std::vector<std::pair<std::string, std::string> > m_items;
+    size_t                                            m_count;
+};
+
+
+/*!
+* @internal
+* @brief Class XmlHandler receives what XmlReader finds in a document.
+* @details Element and attribute names are local names, and the text is UTF-8 with the entities decoded.
+*          The text of an element may be reported in several pieces.
+*/
+class XmlHandler
+{
+public:
+    virtual ~XmlHandler() { }
+
+    virtual void StartElement(const std::string &name, const XmlAttributes &attributes) = 0;
+    virtual void EndElement(const std::string &name) = 0;
+    virtual void Characters(const char *text, size_t length) = 0;
+};
+
+
+/*!
+* @internal
+* @brief Class XmlReader is a streaming (SAX style) parser for the XML parts of a workbook package.
+* @details The document is pulled from a ByteSource through a fixed buffer, so a sheet of any size is
+*          parsed in constant memory. It is not a validating parser: DTDs are skipped, and the document is
+*          expected to be UTF-8, which is what Excel writes.
+*/
+class XmlReader : public Noncopyable
+{
+public:
+    explicit XmlReader(ByteSource &input);
+
+    /*!
+    * @brief Parse the document and report it to @e handler.
+    * @return false if the document is malformed or the input failed.
+    */
+    bool Parse(XmlHandler &handler);
+
+    /*!
+    * @brief Called by the handler to stop the parsing; Parse() returns true then.
+    */
+    void Stop()
+    {
+        m_stopped = true;
+    }
+
+private:
+    bool Next(char &ch)
+    {
+        if (m_pos == m_end && !Fill())
+            return false;
+
+        ch = static_cast<char>(m_buffer[m_pos++]);
+        return true;
+    }
+
+    bool Fill();
+
+    bool SkipPast(const char *terminator);
+    bool ReadName(char &ch, std::string &name);
+    bool ReadEntity(std::string &text);
+    bool ReadStartTag(char ch, XmlHandler &handler);
+    bool ReadEndTag(XmlHandler &handler);
+    bool ReadMarkup(XmlHandler &handler);
+    void FlushText(XmlHandler &handler);
+
+    static void ToLocalName(std::string &name);
+
+private:
+    ByteSource                 &m_input;
+    std::vector<unsigned char>  m_buffer;
+    size_t                      m_pos;
+    size_t                      m_end;
+    bool                        m_stopped;
+
+    std::string                 m_name;
+    std::string                 m_text;
+    XmlAttributes               m_attributes;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //XMLREADER_H_GUID_FE4A5564_3B6C_4217_8657_822272AD5D4D
@@ -0,0 +1,327 @@
+﻿/*!
+* @file    ZipArchive.cpp
+* @brief   Implementation file for class ZipArchive and ZipEntryReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstring>
+#include "ZipArchive.h"
+#include "Inflater.h"
+#include "Crc32.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    const unsigned long EndOfCentralDirSignature = 0x06054B50;
+    const unsigned long CentralHeaderSignature   = 0x02014B50;
+    const unsigned long LocalHeaderSignature     = 0x04034B50;
+
+    const size_t EndOfCentralDirSize = 22;
+    const size_t CentralHeaderSize   = 46;
+    const size_t LocalHeaderSize     = 30;
+    const size_t MaxCommentSize      = 0xFFFF;
+
+    unsigned long GetUInt16(const unsigned char *p)
+    {
+        return p[0] | (static_cast<unsigned long>(p[1]) << 8);
+    }
+
+    unsigned long GetUInt32(const unsigned char *p)
+    {
+        return GetUInt16(p) | (GetUInt16(p + 2) << 16);
+    }
+
+    bool ReadFully(FileSource &file, unsigned char *buffer, size_t size)
+    {
+        return file.Read(buffer, size) == size;
+    }
+
+    // Find the end of central directory record in the end of the file, which is followed by a comment of
+    // up to 64KB, and get where the directory is
+    bool FindDirectory(const unsigned char *tail, size_t tailSize, long long fileSize, 
+        size_t &entryCount, unsigned long &dirSize, unsigned long &dirOffset)
+    {
+        if (tailSize < EndOfCentralDirSize)
+            return false;
+
+        const unsigned char *eocd = NULL;
+        for (size_t pos = tailSize - EndOfCentralDirSize + 1; pos-- > 0; )
+        {
+            if (GetUInt32(tail + pos) == EndOfCentralDirSignature)
+            {
+                eocd = tail + pos;
+                break;
+            }
+        }
+
+        if (eocd == NULL)
+            return false;
+
+        entryCount = GetUInt16(eocd + 10);
+        dirSize = GetUInt32(eocd + 12);
+        dirOffset = GetUInt32(eocd + 16);
+
+        if (entryCount == 0xFFFF || dirOffset == 0xFFFFFFFFUL)
+            return false;   // zip64
+
+        return static_cast<long long>(dirOffset) + static_cast<long long>(dirSize) <= fileSize;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ZipArchive
+
+bool ZipArchive::Open(const ELstring &filename)
+{
+    m_filename = filename;
+    m_entries.clear();
+    m_index.clear();
+
+    size_t entryCount;
+    unsigned long dirSize;
+    unsigned long dirOffset;
+
+    // A mapped file is parsed in place
+    if (m_package.Open(filename))
+    {
+        size_t fileSize = m_package.Size();
+        size_t tailSize = (fileSize < EndOfCentralDirSize + MaxCommentSize ? fileSize : EndOfCentralDirSize + MaxCommentSize);
+        if (!FindDirectory(m_package.Data() + fileSize - tailSize, tailSize, fileSize, entryCount, dirSize, dirOffset))
+            return false;
+
+        return ReadDirectory(m_package.GetSpan(dirOffset, dirSize), dirSize, entryCount);
+    }
+
+    // Otherwise the end of the file and the directory are read into buffers
+    FileSource file;
+    if (!file.Open(filename))
+        return false;
+
+    long long fileSize = file.Size();
+    if (fileSize < static_cast<long long>(EndOfCentralDirSize))
+        return false;
+
+    size_t tailSize = static_cast<size_t>(fileSize < static_cast<long long>(EndOfCentralDirSize + MaxCommentSize) 
+        ? fileSize : EndOfCentralDirSize + MaxCommentSize);
+    std::vector<unsigned char> tail(tailSize);
+    if (!file.Seek(fileSize - tailSize) || !ReadFully(file, &tail[0], tailSize))
+        return false;
+
+    if (!FindDirectory(&tail[0], tailSize, fileSize, entryCount, dirSize, dirOffset))
+        return false;
+
+    std::vector<unsigned char> dir(dirSize + 1);
+    if (!file.Seek(dirOffset) || !ReadFully(file, &dir[0], dirSize))
+        return false;
+
+    return ReadDirectory(&dir[0], dirSize, entryCount);
+}
+
+
+bool ZipArchive::ReadDirectory(const unsigned char *dir, size_t dirSize, size_t entryCount)
+{
+    m_entries.reserve(entryCount);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < entryCount; ++i)
+    {
+        if (pos + CentralHeaderSize > dirSize || GetUInt32(dir + pos) != CentralHeaderSignature)
+            return false;
+
+        const unsigned char *header = dir + pos;
+        size_t nameLength = GetUInt16(header + 28);
+        size_t extraLength = GetUInt16(header + 30);
+        size_t commentLength = GetUInt16(header + 32);
+        if (pos + CentralHeaderSize + nameLength + extraLength + commentLength > dirSize)
+            return false;
+
+        Entry entry;
+        entry.name.assign(reinterpret_cast<const char*>(header + CentralHeaderSize), nameLength);
+        entry.method = static_cast<int>(GetUInt16(header + 10));
+        entry.crc = GetUInt32(header + 16);
+        entry.compressedSize = GetUInt32(header + 20);
+        entry.size = GetUInt32(header + 24);
+        entry.headerOffset = GetUInt32(header + 42);
+
+        if ((GetUInt16(header + 8) & 1) == 0)  // encrypted entries are left out
+        {
+            m_index[MakeKey(entry.name)] = m_entries.size();
+            m_entries.push_back(entry);
+        }
+
+        pos += CentralHeaderSize + nameLength + extraLength + commentLength;
+    }
+
+    return true;
+}
+
+
+const ZipArchive::Entry* ZipArchive::FindEntry(const std::string &name) const
+{
+    std::map<std::string, size_t>::const_iterator it = m_index.find(MakeKey(name));
+    return it == m_index.end() ? NULL : &m_entries[it->second];
+}
+
+
+const unsigned char* ZipArchive::GetRawData(const Entry &entry) const
+{
+    // The local header may have an extra field different from the one in the central directory
+    const unsigned char *header = m_package.GetSpan(entry.headerOffset, LocalHeaderSize);
+    if (header == NULL || GetUInt32(header) != LocalHeaderSignature)
+        return NULL;
+
+    long long dataOffset = entry.headerOffset + LocalHeaderSize + GetUInt16(header + 26) + GetUInt16(header + 28);
+    return m_package.GetSpan(dataOffset, entry.compressedSize);
+}
+
+
+std::string ZipArchive::MakeKey(const std::string &name)
+{
+    std::string key;
+    key.reserve(name.length());
+
+    for (size_t i = (!name.empty() && name[0] == '/') ? 1 : 0; i < name.length(); ++i)
+    {
+        char ch = name[i];
+        if (ch >= 'A' && ch <= 'Z')
+            ch = static_cast<char>(ch - 'A' + 'a');
+        else if (ch == '\\')
+            ch = '/';
+        key.push_back(ch);
+    }
+
+    return key;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class ZipEntryReader
+
+size_t ZipEntryReader::MemorySource::Read(unsigned char *buffer, size_t size)
+{
+    if (size > m_remaining)
+        size = m_remaining;
+
+    memcpy(buffer, m_data, size);
+    m_data += size;
+    m_remaining -= size;
+    return size;
+}
+
+
+ZipEntryReader::ZipEntryReader(): m_raw(m_file), m_mapped(false), m_inflater(NULL), m_expectedCrc(0), 
+    m_expectedSize(0), m_crc(0), m_size(0), m_checked(false), m_failed(false)
+{
+}
+
+
+ZipEntryReader::~ZipEntryReader()
+{
+    delete m_inflater;
+}
+
+
+bool ZipEntryReader::Open(const ZipArchive &archive, const ZipArchive::Entry &entry)
+{
+    delete m_inflater;
+    m_inflater = NULL;
+
+    m_expectedCrc = entry.crc;
+    m_expectedSize = entry.size;
+    m_crc = 0;
+    m_size = 0;
+    m_checked = false;
+    m_failed = true;
+
+    if (entry.method != 0 && entry.method != 8)
+        return false;
+
+    m_mapped = archive.IsMapped();
+    if (m_mapped)
+    {
+        const unsigned char *data = archive.GetRawData(entry);
+        if (data == NULL)
+            return false;
+
+        // the compressed data is inflated in place
+        size_t size = static_cast<size_t>(entry.compressedSize);
+        m_memory.Reset(data, size);
+        if (entry.method == 8)
+            m_inflater = new Inflater(data, size);
+
+        m_failed = false;
+        return true;
+    }
+
+    if (!m_file.Open(archive.GetFilename()))
+        return false;
+
+    // The local header may have an extra field different from the one in the central directory
+    unsigned char header[LocalHeaderSize];
+    if (!m_file.Seek(entry.headerOffset) || !ReadFully(m_file, header, LocalHeaderSize))
+        return false;
+    if (GetUInt32(header) != LocalHeaderSignature)
+        return false;
+
+    long long dataOffset = entry.headerOffset + LocalHeaderSize + GetUInt16(header + 26) + GetUInt16(header + 28);
+    if (!m_file.Seek(dataOffset))
+        return false;
+
+    m_raw.Reset(entry.compressedSize);
+    if (entry.method == 8)
+        m_inflater = new Inflater(m_raw);
+
+    m_failed = false;
+    return true;
+}
+
+
+size_t ZipEntryReader::Read(unsigned char *buffer, size_t size)
+{
+    if (m_failed)
+        return 0;
+
+    size_t n;
+    if (m_inflater != NULL)
+        n = m_inflater->Read(buffer, size);
+    else if (m_mapped)
+        n = m_memory.Read(buffer, size);
+    else
+        n = m_raw.Read(buffer, size);
+    m_crc = Crc32::Update(m_crc, buffer, n);
+    m_size += n;
+
+    if (m_size > m_expectedSize)
+    {
+        m_failed = true;
+        return 0;
+    }
+
+    if (n < size && !m_checked)
+    {
+        // the end of the data
+        m_checked = true;
+        if (m_size != m_expectedSize || m_crc != m_expectedCrc)
+            m_failed = true;
+    }
+
+    return n;
+}
+
+
+bool ZipEntryReader::Failed() const
+{
+    return m_failed || m_file.Failed() || (m_inflater != NULL && m_inflater->Failed());
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
@@ -0,0 +1,207 @@
+﻿/*!
+* @file    ZipArchive.h
+* @brief   Header file for class ZipArchive and ZipEntryReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef ZIPARCHIVE_H_GUID_7D0E0DC4_CA42_4356_A0D6_B7D5F1D5A97E
+#define ZIPARCHIVE_H_GUID_7D0E0DC4_CA42_4356_A0D6_B7D5F1D5A97E
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "ByteSource.h"
+#include "FileSource.h"
+#include "MappedPackage.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+class Inflater;
+
+
+/*!
+* @internal
+* @brief Class ZipArchive holds the central directory of a zip file, such as an .xlsx package.
+* @details Only the directory is loaded by Open(); the data of an entry is read by ZipEntryReader.
+*          The file is mapped into memory if it can be: the directory is parsed in place then, and the
+*          entries are read from the mapping, so the parts which are not used are never read from the disk.
+*          Otherwise the file is read by FileSource. @n
+*          Stored and deflated entries are supported, encrypted and zip64 archives are not.
+*/
+class ZipArchive : public Noncopyable
+{
+public:
+    struct Entry
+    {
+        std::string   name;             // as stored in the archive, '/' separated
+        int           method;           // 0: stored; 8: deflated
+        unsigned long crc;
+        long long     compressedSize;
+        long long     size;
+        long long     headerOffset;     // offset of the local header
+    };
+
+public:
+    bool Open(const ELstring &filename);
+
+    const ELstring& GetFilename() const
+    {
+        return m_filename;
+    }
+
+    size_t CountEntries() const
+    {
+        return m_entries.size();
+    }
+
+    const Entry& GetEntry(size_t index) const
+    {
+        return m_entries[index];
+    }
+
+    /*!
+    * @brief Find an entry by name.
+    * @details Names are compared case-insensitively and a leading '/' is ignored, as for the part
+    *          names of an Open Packaging Conventions package.
+    * @return NULL if there is no such entry.
+    */
+    const Entry* FindEntry(const std::string &name) const;
+
+    /*!
+    * @brief Whether the file is mapped into memory.
+    */
+    bool IsMapped() const
+    {
+        return m_package.IsOpen();
+    }
+
+    /*!
+    * @brief Get the data of an entry as it is stored in the mapped file, which is the uncompressed data of
+    *        a stored entry. It has entry.compressedSize bytes and is valid until the archive is closed.
+    * @return NULL if the file is not mapped or the entry is broken.
+    * @note The CRC is not checked.
+    */
+    const unsigned char* GetRawData(const Entry &entry) const;
+
+private:
+    bool ReadDirectory(const unsigned char *dir, size_t dirSize, size_t entryCount);
+
+    static std::string MakeKey(const std::string &name);
+
+private:
+    MappedPackage                 m_package;
+    ELstring                      m_filename;
+    std::vector<Entry>            m_entries;
+    std::map<std::string, size_t> m_index;      // MakeKey(name) => index in m_entries
+};
+
+
+/*!
+* @internal
+* @brief Class ZipEntryReader streams the uncompressed data of one entry of a ZipArchive.
+* @details The data is read from the mapping of the archive, without copying it into a file buffer, or
+*          else by a file handle of the reader's own; so several entries can be read at the same time.
+*          The CRC and the size are checked at the end of the data; a mismatch sets Failed().
+*/
+class ZipEntryReader : public ByteSource, public Noncopyable
+{
+public:
+    ZipEntryReader();
+    ~ZipEntryReader();
+
+    bool Open(const ZipArchive &archive, const ZipArchive::Entry &entry);
+
+    virtual size_t Read(unsigned char *buffer, size_t size);
+
+    virtual bool Failed() const;
+
+private:
+    /*!
+    * @brief The data of a stored entry in the mapped file.
+    */
+    class MemorySource : public ByteSource
+    {
+    public:
+        MemorySource(): m_data(NULL), m_remaining(0) { }
+
+        void Reset(const unsigned char *data, size_t size)
+        {
+            m_data = data;
+            m_remaining = size;
+        }
+
+        virtual size_t Read(unsigned char *buffer, size_t size);
+
+        virtual bool Failed() const
+        {
+            return false;
+        }
+
+    private:
+        const unsigned char *m_data;
+        size_t               m_remaining;
+    };
+
+    /*!
+    * @brief The compressed data of the entry, read from the file.
+    */
+    class RawSource : public ByteSource
+    {
+    public:
+        RawSource(FileSource &file): m_file(file), m_remaining(0) { }
+
+        void Reset(long long size)
+        {
+            m_remaining = size;
+        }
+
+        virtual size_t Read(unsigned char *buffer, size_t size)
+        {
+            if (static_cast<long long>(size) > m_remaining)
+                size = static_cast<size_t>(m_remaining);
+
+            size_t n = m_file.Read(buffer, size);
+            m_remaining -= n;
+            return n;
+        }
+
+        virtual bool Failed() const
+        {
+            return m_file.Failed();
+        }
+
+    private:
+        FileSource &m_file;
+        long long   m_remaining;
+    };
+
+private:
+    FileSource    m_file;
+    RawSource     m_raw;
+    MemorySource  m_memory;
+    bool          m_mapped;         // whether the data is read from m_memory (or by m_inflater in place)
+    Inflater     *m_inflater;       // NULL for a stored entry
+
+    unsigned long m_expectedCrc;
+    long long     m_expectedSize;
+    unsigned long m_crc;
+    long long     m_size;
+    bool          m_checked;
+    bool          m_failed;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //ZIPARCHIVE_H_GUID_7D0E0DC4_CA42_4356_A0D6_B7D5F1D5A97E
@@ -0,0 +1,239 @@
+﻿/*!
+* @file    ZipWriter.cpp
+* @brief   Implementation file for class ZipWriter
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include "ZipWriter.h"
+#include "Deflater.h"
+#include "Crc32.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+namespace
+{
+    const unsigned long EndOfCentralDirSignature = 0x06054B50;
+    const unsigned long CentralHeaderSignature   = 0x02014B50;
+    const unsigned long LocalHeaderSignature     = 0x04034B50;
+    const unsigned long DataDescriptorSignature  = 0x08074B50;
+
+    const unsigned long VersionNeeded  = 20;        // 2.0: deflate
+    const unsigned long Flags          = 0x0808;    // bit 3: data descriptor; bit 11: UTF-8 names
+    const unsigned long MethodDeflated = 8;
+    const unsigned long DosTime        = 0;
+    const unsigned long DosDate        = (0 << 9) | (1 << 5) | 1;  // 1980-01-01, the time is not recorded
+
+    const long long MaxSize    = 0xFFFFFFFFLL;      // without zip64
+    const size_t    MaxEntries = 0xFFFF;
+
+    void PutUInt16(std::vector<unsigned char> &buffer, unsigned long value)
+    {
+        buffer.push_back(static_cast<unsigned char>(value & 0xFF));
+        buffer.push_back(static_cast<unsigned char>((value >> 8) & 0xFF));
+    }
+
+    void PutUInt32(std::vector<unsigned char> &buffer, unsigned long value)
+    {
+        PutUInt16(buffer, value & 0xFFFF);
+        PutUInt16(buffer, (value >> 16) & 0xFFFF);
+    }
+
+    void PutString(std::vector<unsigned char> &buffer, const std::string &str)
+    {
+        buffer.insert(buffer.end(), str.begin(), str.end());
+    }
+}
+
+
+ZipWriter::ZipWriter(): m_deflater(NULL), m_dataOffset(0), m_failed(false)
+{
+}
+
+
+ZipWriter::~ZipWriter()
+{
+    delete m_deflater;
+}
+
+
+bool ZipWriter::Open(const ELstring &filename)
+{
+    assert(!m_file.IsOpen());
+
+    m_entries.clear();
+    m_failed = !m_file.Open(filename);
+    return !m_failed;
+}
+
+
+bool ZipWriter::BeginEntry(const std::string &name)
+{
+    assert(m_file.IsOpen() && m_deflater == NULL);
+
+    if (m_failed || m_entries.size() == MaxEntries || name.length() > 0xFFFF)
+        return false;
+
+    Entry entry;
+    entry.name = name;
+    entry.crc = 0;
+    entry.compressedSize = 0;
+    entry.size = 0;
+    entry.headerOffset = m_file.Position();
+
+    if (entry.headerOffset > MaxSize || !WriteLocalHeader(entry))
+    {
+        m_failed = true;
+        return false;
+    }
+
+    m_entries.push_back(entry);
+    m_dataOffset = m_file.Position();
+    m_deflater = new Deflater(m_file);
+    return true;
+}
+
+
+bool ZipWriter::Write(const unsigned char *data, size_t size)
+{
+    assert(m_deflater != NULL);
+
+    if (m_failed)
+        return false;
+
+    Entry &entry = m_entries.back();
+    entry.crc = Crc32::Update(entry.crc, data, size);
+    entry.size += size;
+
+    if (entry.size > MaxSize || !m_deflater->Write(data, size))
+        m_failed = true;
+
+    return !m_failed;
+}
+
+
+bool ZipWriter::EndEntry()
+{
+    assert(m_deflater != NULL);
+
+    if (!m_failed && !m_deflater->Finish())
+        m_failed = true;
+
+    delete m_deflater;
+    m_deflater = NULL;
+
+    if (m_failed)
+        return false;
+
+    Entry &entry = m_entries.back();
+    entry.compressedSize = m_file.Position() - m_dataOffset;
+    if (entry.compressedSize > MaxSize)
+    {
+        m_failed = true;
+        return false;
+    }
+
+    std::vector<unsigned char> descriptor;
+    PutUInt32(descriptor, DataDescriptorSignature);
+    PutUInt32(descriptor, entry.crc);
+    PutUInt32(descriptor, static_cast<unsigned long>(entry.compressedSize));
+    PutUInt32(descriptor, static_cast<unsigned long>(entry.size));
+
+    if (!m_file.Write(&descriptor[0], descriptor.size()))
+        m_failed = true;
+
+    return !m_failed;
+}
+
+
+bool ZipWriter::Close()
+{
+    if (!m_file.IsOpen())
+        return false;
+
+    if (m_deflater != NULL)
+        EndEntry();
+
+    if (!m_failed && !WriteCentralDirectory())
+        m_failed = true;
+
+    if (!m_file.Close())
+        m_failed = true;
+
+    return !m_failed;
+}
+
+
+// The sizes are not known yet, they are in the data descriptor
+bool ZipWriter::WriteLocalHeader(const Entry &entry)
+{
+    std::vector<unsigned char> header;
+    PutUInt32(header, LocalHeaderSignature);
+    PutUInt16(header, VersionNeeded);
+    PutUInt16(header, Flags);
+    PutUInt16(header, MethodDeflated);
+    PutUInt16(header, DosTime);
+    PutUInt16(header, DosDate);
+    PutUInt32(header, 0);           // crc
+    PutUInt32(header, 0);           // compressed size
+    PutUInt32(header, 0);           // size
+    PutUInt16(header, static_cast<unsigned long>(entry.name.length()));
+    PutUInt16(header, 0);           // extra field length
+    PutString(header, entry.name);
+
+    return m_file.Write(&header[0], header.size());
+}
+
+
+bool ZipWriter::WriteCentralDirectory()
+{
+    long long offset = m_file.Position();
+
+    std::vector<unsigned char> directory;
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        const Entry &entry = m_entries[i];
+        PutUInt32(directory, CentralHeaderSignature);
+        PutUInt16(directory, VersionNeeded);    // version made by: MS-DOS
+        PutUInt16(directory, VersionNeeded);
+        PutUInt16(directory, Flags);
+        PutUInt16(directory, MethodDeflated);
+        PutUInt16(directory, DosTime);
+        PutUInt16(directory, DosDate);
+        PutUInt32(directory, entry.crc);
+        PutUInt32(directory, static_cast<unsigned long>(entry.compressedSize));
+        PutUInt32(directory, static_cast<unsigned long>(entry.size));
+        PutUInt16(directory, static_cast<unsigned long>(entry.name.length()));
+        PutUInt16(directory, 0);    // extra field length
+        PutUInt16(directory, 0);    // comment length
+        PutUInt16(directory, 0);    // disk number
+        PutUInt16(directory, 0);    // internal attributes
+        PutUInt32(directory, 0);    // external attributes
+        PutUInt32(directory, static_cast<unsigned long>(entry.headerOffset));
+        PutString(directory, entry.name);
+    }
+
+    size_t directorySize = directory.size();
+    if (offset + static_cast<long long>(directorySize) > MaxSize)
+        return false;
+
+    PutUInt32(directory, EndOfCentralDirSignature);
+    PutUInt16(directory, 0);        // number of this disk
+    PutUInt16(directory, 0);        // disk of the central directory
+    PutUInt16(directory, static_cast<unsigned long>(m_entries.size()));
+    PutUInt16(directory, static_cast<unsigned long>(m_entries.size()));
+    PutUInt32(directory, static_cast<unsigned long>(directorySize));
+    PutUInt32(directory, static_cast<unsigned long>(offset));
+    PutUInt16(directory, 0);        // comment length
+
+    return m_file.Write(&directory[0], directory.size());
+}
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
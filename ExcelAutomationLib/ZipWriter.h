@@ -0,0 +1,93 @@
+﻿/*!
+* @file    ZipWriter.h
+* @brief   Header file for class ZipWriter
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef ZIPWRITER_H_GUID_9AC889B9_953E_46D4_8FAD_951D23839549
+#define ZIPWRITER_H_GUID_9AC889B9_953E_46D4_8FAD_951D23839549
+
+
+#include <string>
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "FileSink.h"
+#include "Noncopyable.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+class Deflater;
+
+
+/*!
+* @internal
+* @brief Class ZipWriter writes a zip file entry by entry, such as an .xlsx package.
+* @details Every entry is deflated straight into the file while it is written, and its CRC and sizes
+*          follow the data in a data descriptor, so nothing but the list of entries is kept in memory. @n
+*          Zip64 is not supported: an entry or an archive of 4GB or more fails.
+*/
+class ZipWriter : public Noncopyable
+{
+public:
+    ZipWriter();
+
+    /*!
+    * @brief Discard an archive which is not closed: the file is left incomplete.
+    */
+    ~ZipWriter();
+
+    bool Open(const ELstring &filename);
+
+    /*!
+    * @brief Start a deflated entry; the previous one must be ended.
+    * @param [in] name Name of the entry in UTF-8, '/' separated.
+    */
+    bool BeginEntry(const std::string &name);
+
+    /*!
+    * @brief Append data to the current entry.
+    */
+    bool Write(const unsigned char *data, size_t size);
+
+    bool EndEntry();
+
+    /*!
+    * @brief Write the central directory and close the file.
+    * @return true if the whole archive was written successfully.
+    */
+    bool Close();
+
+private:
+    struct Entry
+    {
+        std::string   name;
+        unsigned long crc;
+        long long     compressedSize;
+        long long     size;
+        long long     headerOffset;     // offset of the local header
+    };
+
+private:
+    bool WriteLocalHeader(const Entry &entry);
+    bool WriteCentralDirectory();
+
+private:
+    FileSink           m_file;
+    std::vector<Entry> m_entries;
+    Deflater          *m_deflater;      // of the current entry, NULL if none
+    long long          m_dataOffset;    // offset of the data of the current entry
+    bool               m_failed;
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //ZIPWRITER_H_GUID_9AC889B9_953E_46D4_8FAD_951D23839549
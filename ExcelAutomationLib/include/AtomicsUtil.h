@@ -1,67 +1,155 @@
-﻿/*!
-* @file    AtomicsUtil.h
-* @brief   Header file for class AtomicsUtil.
-* @date    2009-12-09
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef ATOMICSUTIL_H_GUID_BBB9EDC4_2368_4C83_9E93_CE3FF8B7BC98
-#define ATOMICSUTIL_H_GUID_BBB9EDC4_2368_4C83_9E93_CE3FF8B7BC98
-
-
-#include <windows.h>
-#include "LibDef.h"
-
-
-// namespace start
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-/*!
-* @internal
-* @brief Class AtomicsUtil is an utility class which provides some atomic operations on integer.
-*        All members of AtomicsUtil are static members.
-* @note AtomicsUtil is not intended and allowed to be instantiated.
-*/
-class AtomicsUtil
-{
-public:  // public types
-    /*!
-    * @brief Integer type for atomic operation.
-    */
-    typedef LONG Integer;
-
-public:  // public interfaces
-    /*!
-    * @brief Increment an integer as an atomic operation.
-    * @param pValue A pointer to the variable to be incremented.
-    * @return The resulting incremented value.
-    */
-    static Integer Increment(Integer *pValue)
-    {
-        return ::InterlockedIncrement(pValue);
-    }
-
-    /*!
-    * @brief Decrement an integer as an atomic operation.
-    * @param pValue A pointer to the variable to be decremented.
-    * @return The resulting decremented value.
-    */
-    static Integer Decrement(Integer *pValue)
-    {
-        return ::InterlockedDecrement(pValue);
-    }
-
-private:
-    // Forbid instantiation
-    AtomicsUtil();
-};
-
-
-// namespace end
-EXCEL_AUTOMATION_NAMESPACE_END
-
-
-#endif //ATOMICSUTIL_H_GUID_BBB9EDC4_2368_4C83_9E93_CE3FF8B7BC98
+﻿/*!
+* @file    AtomicsUtil.h
+* @brief   Header file for class AtomicsUtil.
+* @date    2009-12-09
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef ATOMICSUTIL_H_GUID_BBB9EDC4_2368_4C83_9E93_CE3FF8B7BC98
+#define ATOMICSUTIL_H_GUID_BBB9EDC4_2368_4C83_9E93_CE3FF8B7BC98
+
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "LibDef.h"
+
+
+// namespace start
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @internal
+* @brief Class AtomicsUtil is an utility class which provides some atomic operations on integer.
+*        All members of AtomicsUtil are static members.
+* @note AtomicsUtil is not intended and allowed to be instantiated.
+*/
+class AtomicsUtil
+{
+public:  // public types
+    /*!
+    * @brief Integer type for atomic operation.
+    */
+#ifdef _WIN32
+    typedef LONG Integer;
+#else
+    typedef long Integer;
+#endif
+
+public:  // public interfaces
+    /*!
+    * @brief Increment an integer as an atomic operation.
+    * @param pValue A pointer to the variable to be incremented.
+    * @return The resulting incremented value.
+    */
+    static Integer Increment(Integer *pValue)
+    {
+#ifdef _WIN32
+        return ::InterlockedIncrement(pValue);
+#else
+        return __sync_add_and_fetch(pValue, 1);
+#endif
+    }
+
+    /*!
+    * @brief Decrement an integer as an atomic operation.
+    * @param pValue A pointer to the variable to be decremented.
+    * @return The resulting decremented value.
+    */
+    static Integer Decrement(Integer *pValue)
+    {
+#ifdef _WIN32
+        return ::InterlockedDecrement(pValue);
+#else
+        return __sync_sub_and_fetch(pValue, 1);
+#endif
+    }
+
+    /*!
+    * @brief Read an integer as an atomic operation, which is a full memory barrier.
+    * @param pValue A pointer to the variable to be read.
+    * @return The value read.
+    */
+    static Integer Load(Integer *pValue)
+    {
+#ifdef _WIN32
+        return ::InterlockedCompareExchange(pValue, 0, 0);
+#else
+        return __sync_fetch_and_add(pValue, 0);
+#endif
+    }
+
+    /*!
+    * @brief Set an integer to a value as an atomic operation, which is a full memory barrier.
+    * @param pValue A pointer to the variable to be set.
+    * @param value The new value.
+    * @return The value before.
+    */
+    static Integer Exchange(Integer *pValue, Integer value)
+    {
+#ifdef _WIN32
+        return ::InterlockedExchange(pValue, value);
+#else
+        return __atomic_exchange_n(pValue, value, __ATOMIC_SEQ_CST);
+#endif
+    }
+
+    /*!
+    * @brief Set a pointer to a value as an atomic operation, which is a full memory barrier.
+    * @param ppValue A pointer to the pointer to be set.
+    * @param value The new value.
+    * @return The value before.
+    */
+    static void* ExchangePointer(void * volatile *ppValue, void *value)
+    {
+#ifdef _WIN32
+        return ::InterlockedExchangePointer(ppValue, value);
+#else
+        return __atomic_exchange_n(ppValue, value, __ATOMIC_SEQ_CST);
+#endif
+    }
+
+    /*!
+    * @brief Read a pointer, so that the reads and writes after it are not moved before it (acquire).
+    * @param ppValue A pointer to the pointer to be read.
+    * @return The value read.
+    */
+    static void* LoadPointer(void * volatile *ppValue)
+    {
+#ifdef _WIN32
+        // a volatile read has acquire semantics with Visual C++
+        return *ppValue;
+#else
+        return __atomic_load_n(ppValue, __ATOMIC_ACQUIRE);
+#endif
+    }
+
+    /*!
+    * @brief Write a pointer, so that the reads and writes before it are not moved after it (release).
+    * @param ppValue A pointer to the pointer to be written.
+    * @param value The new value.
+    */
+    static void StorePointer(void * volatile *ppValue, void *value)
+    {
+#ifdef _WIN32
+        // a volatile write has release semantics with Visual C++
+        *ppValue = value;
+#else
+        __atomic_store_n(ppValue, value, __ATOMIC_RELEASE);
+#endif
+    }
+
+private:
+    // Forbid instantiation
+    AtomicsUtil();
+};
+
+
+// namespace end
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //ATOMICSUTIL_H_GUID_BBB9EDC4_2368_4C83_9E93_CE3FF8B7BC98
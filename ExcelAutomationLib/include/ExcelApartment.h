@@ -0,0 +1,214 @@
+﻿/*!
+* @file    ExcelApartment.h
+* @brief   Header file for class ExcelApartment, class ExcelApartmentTask and class template ExcelFuture
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELAPARTMENT_H_GUID_C5190E6A_7B3D_4A82_9F64_2D8B0E17A5F9
+#define EXCELAPARTMENT_H_GUID_C5190E6A_7B3D_4A82_9F64_2D8B0E17A5F9
+
+
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "ExcelApplication.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declaration
+class ExcelApartmentImpl;
+
+
+/*!
+* @brief Class ExcelApartmentTask is the base class of the work posted to an ExcelApartment.
+* @details A task is run on the thread of the apartment, where it can use the ExcelApplication of the apartment
+*          and every handle got from it. It keeps its results in its own members, which are read through
+*          the ExcelFuture returned by ExcelApartment::Post(), after the task is done.
+* @note The handles got in Run() must not be kept in the task: they belong to the thread of the apartment.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelApartmentTask : public BodyBase
+{
+public:
+    /*!
+    * @brief Wait until the task is run, or cancelled.
+    * @param [in] timeout Milliseconds to wait, or INFINITE.
+    * @return true if the task is done, false if the timeout expires
+    */
+    bool Wait(unsigned long timeout = INFINITE) const;
+
+    bool IsDone() const
+    {
+        return Wait(0);
+    }
+
+    /*!
+    * @brief Whether the task was run and Run() returned true. It is false until the task is done.
+    */
+    bool Succeeded() const
+    {
+        return IsDone() && m_succeeded;
+    }
+
+protected:
+    ExcelApartmentTask();
+    virtual ~ExcelApartmentTask();
+
+private:
+    /*!
+    * @brief Do the work, on the thread of the apartment.
+    * @param [in] app The running application of the apartment.
+    * @return true if successful, otherwise false
+    */
+    virtual bool Run(ExcelApplication &app) = 0;
+
+    // Forbid copy
+    ExcelApartmentTask(const ExcelApartmentTask &);
+    ExcelApartmentTask& operator = (const ExcelApartmentTask &);
+
+private:
+    // Used by ExcelApartmentImpl only
+    friend class ExcelApartmentImpl;
+    void Complete(ExcelApplication *app);   // run it, or cancel it if app is NULL
+
+private:
+    HANDLE m_done;                          // manual-reset event
+    bool   m_succeeded;
+};
+
+
+/*!
+* @brief Class template ExcelFuture refers to a task posted to an ExcelApartment, and to its results.
+* @tparam TTask The type of the task, which is derived from ExcelApartmentTask.
+* @details It is a handle of the task: the task is destroyed when it is done and the last future of it
+*          is destroyed, so a caller can drop the future of a task whose results it does not need.
+*/
+template <class TTask>
+class ExcelFuture : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelFuture(): HandleBase(0) { }
+
+    /*!
+    * @brief Wait until the task is run, or cancelled.
+    * @return true if the task is done, false if the timeout expires
+    * @note It must not be called by a task of the same apartment, which would wait forever.
+    */
+    bool Wait(unsigned long timeout = INFINITE) const
+    {
+        return Body().Wait(timeout);
+    }
+
+    bool IsReady() const
+    {
+        return Body().IsDone();
+    }
+
+    /*!
+    * @brief Wait until the task is done, and tell whether its Run() returned true.
+    */
+    bool Succeeded() const
+    {
+        Body().Wait();
+        return Body().Succeeded();
+    }
+
+    /*!
+    * @brief Wait until the task is done, and return it to read its results.
+    */
+    TTask& Get() const
+    {
+        Body().Wait();
+        return Body();
+    }
+
+    TTask* operator -> () const
+    {
+        return &Get();
+    }
+
+private:
+    friend class ExcelApartment;
+    friend class ExcelApartmentImpl;
+    explicit ExcelFuture(TTask *task): HandleBase(task) { }
+
+    TTask& Body() const
+    {
+        return static_cast<TTask&>(HandleBase::Body());
+    }
+};
+
+
+/*!
+* @brief Class ExcelApartment runs an Excel instance on a thread of its own, so that any thread can use it.
+* @details The thread is a single-threaded apartment, which starts Excel, runs the posted tasks in the
+*          order they are posted, and quits Excel when the apartment is stopped. Post() does not take a lock
+*          and does not wait for the task: a caller can post several tasks, and wait for their futures
+*          later. While it has no task, the thread pumps its messages as an STA thread should.
+* @note Tasks of one apartment are run one by one; use several apartments to run them in parallel.
+* @note When the last handle of the apartment is destroyed, it is stopped. It must not be destroyed by a task.
+* @note ExcelApartment/ExcelApartmentImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelApartment : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelApartment(): HandleBase(0) { }
+
+    /*!
+    * @brief Start the thread of an apartment, and Excel on it.
+    * @return A null handle if the thread or Excel cannot be started
+    */
+    static ExcelApartment Start();
+
+    /*!
+    * @brief Post a task, which the apartment takes the ownership of. Any thread can call it.
+    * @param [in] task Created by new.
+    * @return The future of the task. If the apartment is stopped, the task is cancelled: it is done
+    *         and not succeeded.
+    */
+    template <class TTask>
+    ExcelFuture<TTask> Post(TTask *task)
+    {
+        ExcelFuture<TTask> future(task);
+        PostTask(ExcelFuture<ExcelApartmentTask>(task));
+        return future;
+    }
+
+    /*!
+    * @brief Run the tasks posted before, then quit Excel and end the thread. The tasks posted later
+    *        are cancelled.
+    * @note It must not be called by a task.
+    */
+    void Stop();
+
+    /*!
+    * @brief Whether the calling thread is the thread of the apartment, where the tasks are run
+    */
+    bool IsApartmentThread() const;
+
+private:
+    void PostTask(const ExcelFuture<ExcelApartmentTask> &task);
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelApartmentImpl;
+    ExcelApartment(ExcelApartmentImpl *impl);
+    ExcelApartmentImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELAPARTMENT_H_GUID_C5190E6A_7B3D_4A82_9F64_2D8B0E17A5F9
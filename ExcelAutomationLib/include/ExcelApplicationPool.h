@@ -0,0 +1,162 @@
+﻿/*!
+* @file    ExcelApplicationPool.h
+* @brief   Header file for class ExcelApplicationPool and class ExcelApplicationLease
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELAPPLICATIONPOOL_H_GUID_64D0E3B8_A27F_4C19_8E5B_F19C07A4D2E3
+#define EXCELAPPLICATIONPOOL_H_GUID_64D0E3B8_A27F_4C19_8E5B_F19C07A4D2E3
+
+
+#include <cstddef>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "ExcelApplication.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declaration
+class ExcelApplicationPoolImpl;
+
+
+/*!
+* @brief Options of an ExcelApplicationPool
+*/
+struct EXCEL_AUTOMATION_DLL_API ExcelApplicationPoolOptions
+{
+    ExcelApplicationPoolOptions();
+
+    size_t        size;             //!< Number of instances kept started, idle or leased
+    unsigned long maxWorkbooks;     //!< Recycle an instance after it has opened or created this many workbooks; 0 for no limit
+    unsigned long maxMemoryGrowth;  //!< Recycle an instance after its memory has grown by this many MB; 0 for no limit
+    unsigned long checkInterval;    //!< Milliseconds between two health checks of the idle instances; 0 for none
+};
+
+
+/*!
+* @brief Statistics of an ExcelApplicationPool
+*/
+struct EXCEL_AUTOMATION_DLL_API ExcelApplicationPoolStats
+{
+    ExcelApplicationPoolStats();
+
+    unsigned long started;          //!< Number of instances started
+    unsigned long startFailures;    //!< Number of instances which could not be started
+    unsigned long leases;           //!< Number of leases
+    unsigned long leaseTimeouts;    //!< Number of leases which found no idle instance in time
+    unsigned long recycled;         //!< Number of instances recycled because of maxWorkbooks or maxMemoryGrowth
+    unsigned long dead;             //!< Number of instances found dead, when returned or checked
+    size_t        idle;             //!< Number of idle instances now
+    size_t        leased;           //!< Number of leased instances now
+};
+
+
+/*!
+* @brief Class ExcelApplicationPool keeps a number of Excel instances started, so that a job does not wait
+*        for Excel to start.
+* @details A thread of the pool starts the instances: they are hidden, and alerts, screen updating and events
+*          are turned off. The thread checks the idle instances every @e checkInterval, and replaces the ones
+*          which are dead or recycled. @n
+*          An instance is leased by ExcelApplicationLease. When it is returned, its workbooks are closed
+*          without saving, and it is checked: it is recycled if it does not answer, if it has opened
+*          @e maxWorkbooks workbooks in all its leases, or if its memory has grown by @e maxMemoryGrowth.
+* @note The instances are passed between the apartments through the Global Interface Table, so a thread
+*       can lease an instance started by the pool thread.
+* @note When the last handle of the pool is destroyed, all the instances are quit. Every lease must be
+*       returned before.
+* @note ExcelApplicationPool/ExcelApplicationPoolImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelApplicationPool : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelApplicationPool(): HandleBase(0) { }
+
+    /*!
+    * @brief Create a pool, which starts its instances in the background.
+    */
+    explicit ExcelApplicationPool(const ExcelApplicationPoolOptions &options);
+
+    ExcelApplicationPoolStats GetStats() const;
+
+private:
+    // Used by ExcelApplicationLease only
+    friend class ExcelApplicationLease;
+    bool Lease(ExcelApplication &app, unsigned long &id, unsigned long timeout);
+    void Return(ExcelApplication &app, unsigned long id);
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelApplicationPoolImpl;
+    ExcelApplicationPool(ExcelApplicationPoolImpl *impl);
+    ExcelApplicationPoolImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+/*!
+* @brief Class ExcelApplicationLease leases an Excel instance from an ExcelApplicationPool during its lifetime.
+* @details The instance is running and can be used as any ExcelApplication, except that it must not be
+*          shut down: it is returned to the pool by Return() or by the destructor. Every copy of the
+*          ExcelApplication stops running when the instance is returned.
+* @note The lease is returned when the scope is left by an exception as well.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelApplicationLease
+{
+public:
+    /*!
+    * @brief Lease an idle instance, waiting for one if there is none.
+    * @param [in] pool The pool. Must not be null.
+    * @param [in] timeout Milliseconds to wait, or INFINITE.
+    * @note Check IsLeased() for the result.
+    */
+    explicit ExcelApplicationLease(ExcelApplicationPool pool, unsigned long timeout = INFINITE);
+
+    /*!
+    * @brief Return the instance to the pool.
+    */
+    ~ExcelApplicationLease();
+
+    bool IsLeased() const
+    {
+        return m_leased;
+    }
+
+    /*!
+    * @brief The leased instance, which is not running if IsLeased() is false.
+    */
+    ExcelApplication GetApplication() const
+    {
+        return m_app;
+    }
+
+    /*!
+    * @brief Return the instance to the pool before the lease is destroyed.
+    */
+    void Return();
+
+private:
+    // Forbid copy
+    ExcelApplicationLease(const ExcelApplicationLease &);
+    ExcelApplicationLease& operator = (const ExcelApplicationLease &);
+
+private:
+    ExcelApplicationPool m_pool;
+    ExcelApplication     m_app;
+    unsigned long        m_id;
+    bool                 m_leased;
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELAPPLICATIONPOOL_H_GUID_64D0E3B8_A27F_4C19_8E5B_F19C07A4D2E3
@@ -1,26 +1,41 @@
-﻿/*!
-* @file    ExcelAutomation.h
-* @brief   Including this header file is a convenient way to use this library.
-* @date    2009-12-10
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef EXCELAUTOMATION_H_GUID_91E20692_94F9_412C_8CAB_EF4435734B1C
-#define EXCELAUTOMATION_H_GUID_91E20692_94F9_412C_8CAB_EF4435734B1C
-
-
-// Includes all other public header files here
-#include "StringUtil.h"
-#include "ExcelApplication.h"
-#include "ExcelWorkbookSet.h"
-#include "ExcelWorkbook.h"
-#include "ExcelWorksheetSet.h"
-#include "ExcelWorksheet.h"
-#include "ExcelRange.h"
-#include "ExcelCell.h"
-#include "ExcelFont.h"
-
-
-#endif //EXCELAUTOMATION_H_GUID_91E20692_94F9_412C_8CAB_EF4435734B1C
+﻿/*!
+* @file    ExcelAutomation.h
+* @brief   Including this header file is a convenient way to use this library.
+* @date    2009-12-10
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef EXCELAUTOMATION_H_GUID_91E20692_94F9_412C_8CAB_EF4435734B1C
+#define EXCELAUTOMATION_H_GUID_91E20692_94F9_412C_8CAB_EF4435734B1C
+
+
+// Includes all other public header files here
+#include "StringUtil.h"
+#include "ExcelApplication.h"
+#include "ExcelPerformanceScope.h"
+#ifdef _WIN32
+#include "ExcelApplicationPool.h"
+#include "ExcelApartment.h"
+#endif
+#include "ExcelWorkbookSet.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheetSet.h"
+#include "ExcelWorksheet.h"
+#include "ExcelRowQuery.h"
+#include "ExcelRange.h"
+#include "ExcelRangeView.h"
+#include "ExcelTypedCodec.h"
+#include "ExcelCell.h"
+#include "ExcelValue.h"
+#include "ExcelColumns.h"
+#include "ExcelFont.h"
+#include "ExcelWriteBatch.h"
+#include "ExcelWorksheetCache.h"
+#include "ExcelCallStats.h"
+#include "ExcelFileReader.h"
+#include "XlsxStreamWriter.h"
+
+
+#endif //EXCELAUTOMATION_H_GUID_91E20692_94F9_412C_8CAB_EF4435734B1C
@@ -0,0 +1,111 @@
+﻿/*!
+* @file    ExcelCallStats.h
+* @brief   Header file for class ExcelCallStats
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELCALLSTATS_H_GUID_225ED384_4F9A_4332_A699_B1107C912C5E
+#define EXCELCALLSTATS_H_GUID_225ED384_4F9A_4332_A699_B1107C912C5E
+
+
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Kind of a call into Excel, the values are the same as DISPATCH_XXX in <oaidl.h>
+*/
+enum ExcelCallKind
+{
+    ECK_Method = 1,           // A method call
+    ECK_PropertyGet = 2,      // Get a property
+    ECK_PropertyPut = 4       // Put a property
+};
+
+
+/*!
+* @brief Statistics of the calls of one member of an Excel type in one kind.
+*/
+struct EXCEL_AUTOMATION_DLL_API ExcelCallStatsEntry
+{
+    /*!
+    * @brief Number of buckets of the latency histogram.
+    * @details Bucket 0 counts the calls which take less than 2 microseconds, bucket i (0 < i < BucketCount - 1)
+    *          counts the calls which take [2^i, 2^(i+1)) microseconds, and the last bucket counts all the
+    *          slower calls.
+    */
+    enum { BucketCount = 24 };
+
+    ExcelCallStatsEntry();
+
+    ELstring      member;                   //!< Name of the type and the member, such as "Range.Value"
+    ExcelCallKind kind;                     //!< Kind of the calls
+    unsigned long calls;                    //!< Number of calls
+    unsigned long failures;                 //!< Number of calls which returned a failure HRESULT
+    double        totalMicroseconds;        //!< Total time of all the calls
+    unsigned long buckets[BucketCount];     //!< The latency histogram
+};
+
+
+/*!
+* @brief Class ExcelCallStats measures the calls made into Excel by this library.
+*        All the members of ExcelCallStats are static member.
+* @details When enabled, every call goes through ComUtil is timed and counted by the name of the member
+*          and the kind of the call. The statistics can be copied out by TakeSnapshot(), or formatted
+*          as text or JSON by Dump(). @n
+*          Measuring is disabled by default, and a disabled call costs only a test of a flag.
+* @note All members are thread-safe.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelCallStats
+{
+public:
+    /*!
+    * @brief Output formats of Dump()
+    */
+    enum DumpFormat
+    {
+        TextFormat,     //!< One line per entry, aligned for reading
+        JsonFormat      //!< An array of objects, one per entry
+    };
+
+    /*!
+    * @brief Start or stop measuring. The collected statistics are kept.
+    */
+    static void Enable(bool enable = true);
+
+    static bool IsEnabled();
+
+    /*!
+    * @brief Drop all the collected statistics.
+    */
+    static void Reset();
+
+    /*!
+    * @brief Copy the collected statistics.
+    * @param [out] entries Which returns the entries, sorted by member name and kind.
+    */
+    static void TakeSnapshot(std::vector<ExcelCallStatsEntry> &entries);
+
+    /*!
+    * @brief Format the collected statistics.
+    */
+    static ELstring Dump(DumpFormat format = TextFormat);
+
+private:
+    // Forbid instantiation
+    ExcelCallStats();
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELCALLSTATS_H_GUID_225ED384_4F9A_4332_A699_B1107C912C5E
@@ -1,83 +1,111 @@
-﻿/*!
-* @file    ExcelCell.h
-* @brief   Header file for class ExcelCell
-* @date    2009-12-31
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef EXCELCELL_H_GUID_F7A9BE95_9657_4811_94CF_CB56C002DDF0
-#define EXCELCELL_H_GUID_F7A9BE95_9657_4811_94CF_CB56C002DDF0
-
-
-#include "LibDef.h"
-#include "HandleBody.h"
-#include "StringUtil.h"
-#include "ExcelCommonTypes.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-// Forward declarations
-class ExcelFont;
-
-
-/*!
-* @brief Class ExcelCell represents the concept "Cell" in Excel.
-* @note ExcelCell/ExcelCellImpl is an implementation of the "Handle/Body" pattern.
-* @note In fact, there is no such a "Cell" object in Excel Object Model. "Cell" is a special "Range". 
-*       ExcelCell is provided just for convenience.
-*/
-class EXCEL_AUTOMATION_DLL_API ExcelCell : public HandleBase
-{
-public:
-    /*!
-    * Default constructor
-    */ // Doc is needed by Doxygen
-    ExcelCell() : HandleBase(0) { }
-
-    bool GetValue(ELstring &value);
-    bool SetValue(const ELstring &value);
-    bool SetValue(int value);
-    bool SetValue(double value);
-
-    /*!
-    * @brief Return an object representing the font property of this cell
-    */
-    ExcelFont GetFont();
-
-    /*!
-    * @brief Set horizontal alignment of the cell
-    * @param [in] align Refer to ExcelHorizontalAlignment
-    * @return true if successful, otherwise false
-    */
-    bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
-
-    /*!
-    * @brief Set vertical alignment of the cell
-    * @param [in] align Refer to ExcelVerticalAlignment
-    * @return true if successful, otherwise false
-    */
-    bool SetVerticalAlignment(ExcelVerticalAlignment align);
-
-private:
-    friend class ExcelWorksheetImpl;  // which will call the following ctor
-    ExcelCell(IDispatch *pCell, ELchar column, int row);
-
-private:
-    // <begin> Handle/Body pattern implementation
-    friend class ExcelCellImpl;
-    ExcelCell(ExcelCellImpl *impl);
-    ExcelCellImpl& Body() const;
-    // <end> Handle/Body pattern implementation
-};
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
-
-
-#endif //EXCELCELL_H_GUID_F7A9BE95_9657_4811_94CF_CB56C002DDF0
+﻿/*!
+* @file    ExcelCell.h
+* @brief   Header file for class ExcelCell
+* @date    2009-12-31
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef EXCELCELL_H_GUID_F7A9BE95_9657_4811_94CF_CB56C002DDF0
+#define EXCELCELL_H_GUID_F7A9BE95_9657_4811_94CF_CB56C002DDF0
+
+
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+#include "ExcelCommonTypes.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declarations
+class ExcelFont;
+struct ExcelFontSpec;
+class ExcelValue;
+class ExcelCellImpl;
+
+
+/*!
+* @brief Class ExcelCell represents the concept "Cell" in Excel.
+* @note ExcelCell/ExcelCellImpl is an implementation of the "Handle/Body" pattern.
+* @note In fact, there is no such a "Cell" object in Excel Object Model. "Cell" is a special "Range". 
+*       ExcelCell is provided just for convenience.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelCell : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelCell() : HandleBase(0) { }
+
+    bool GetValue(ELstring &value);
+    bool SetValue(const ELstring &value);
+    bool SetValue(int value);
+    bool SetValue(double value);
+
+    /*!
+    * @brief Get the value of the cell with its type.
+    * @param [out] value Which returns the value. Unlike GetValue(ELstring&), a number is not formatted as text.
+    * @return true if successful, otherwise false
+    */
+    bool GetValue(ExcelValue &value);
+
+    /*!
+    * @brief Set the value of the cell with its type.
+    * @return true if successful, otherwise false
+    */
+    bool SetValue(const ExcelValue &value);
+
+    /*!
+    * @brief Return an object representing the font property of this cell
+    */
+    ExcelFont GetFont();
+
+    /*!
+    * @brief Read all the properties of the font of this cell, see ExcelFont::GetSpec().
+    * @return true if successful, otherwise false; always false for a workbook opened by ExcelFileReader
+    */
+    bool GetFontSpec(ExcelFontSpec &spec);
+
+    /*!
+    * @brief Write the properties of the font of this cell which differ from @e spec, see ExcelFont::ApplySpec().
+    * @return true if successful, otherwise false; always false for a workbook opened by ExcelFileReader
+    */
+    bool ApplyFontSpec(const ExcelFontSpec &spec);
+
+    /*!
+    * @brief Set horizontal alignment of the cell
+    * @param [in] align Refer to ExcelHorizontalAlignment
+    * @return true if successful, otherwise false
+    */
+    bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
+
+    /*!
+    * @brief Set vertical alignment of the cell
+    * @param [in] align Refer to ExcelVerticalAlignment
+    * @return true if successful, otherwise false
+    */
+    bool SetVerticalAlignment(ExcelVerticalAlignment align);
+
+private:
+    friend class ComWorksheetImpl;    // which will call the following ctor
+    ExcelCell(IDispatch *pCell, ELchar column, int row);
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelCellImpl;
+    ExcelCell(ExcelCellImpl *impl);
+    ExcelCellImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELCELL_H_GUID_F7A9BE95_9657_4811_94CF_CB56C002DDF0
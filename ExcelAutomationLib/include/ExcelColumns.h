@@ -0,0 +1,95 @@
+﻿/*!
+* @file    ExcelColumns.h
+* @brief   Header file for the typed column buffers of ExcelRange::ReadColumns()
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELCOLUMNS_H_GUID_8D41B7E2_C5A0_4E1F_93B6_2A7F05D9E48C
+#define EXCELCOLUMNS_H_GUID_8D41B7E2_C5A0_4E1F_93B6_2A7F05D9E48C
+
+
+#include <cstddef>
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Type of the values which an ExcelColumn receives
+*/
+enum ExcelColumnType
+{
+    ECT_Double = 0,     // Numbers, dates (OLE Automation dates) and booleans (1 or 0)
+    ECT_Int64  = 1,     // Numbers and dates which are integers, and booleans (1 or 0)
+    ECT_String = 2      // Strings, and other values formatted as ExcelRange::ReadData() does
+};
+
+
+/*!
+* @brief Typed buffer which receives the values of one column of a range, see ExcelRange::ReadColumns().
+* @details Only the vector for @e type is filled, with one entry per row of the range, and @e valid tells
+*          which entries hold a value. An entry is not valid (0, or an empty string) if the cell is empty,
+*          is an error, or its value does not fit the type: a string in a numeric column is not parsed,
+*          and a number which is not an integer is not valid in an ECT_Int64 column.
+* @note The buffers are reused by the next read, so a column read again does not allocate.
+*/
+struct ExcelColumn
+{
+    explicit ExcelColumn(ExcelColumnType columnType = ECT_Double): type(columnType) { }
+
+    /*!
+    * @brief Size the buffer of @e type for @e rows entries, none of which is valid; free the others.
+    */
+    void Reset(size_t rows)
+    {
+        if (type == ECT_Double)
+            doubles.assign(rows, 0);
+        else
+            std::vector<double>().swap(doubles);
+
+        if (type == ECT_Int64)
+            integers.assign(rows, 0);
+        else
+            std::vector<long long>().swap(integers);
+
+        if (type == ECT_String)
+        {
+            strings.resize(rows);
+            for (size_t i = 0; i < rows; ++i)
+                strings[i].clear();     // keeps the capacity of a reused string
+        }
+        else
+        {
+            std::vector<ELstring>().swap(strings);
+        }
+
+        valid.assign(rows, false);
+    }
+
+    /*!
+    * @brief Number of entries (rows) of the column.
+    */
+    size_t Size() const
+    {
+        return valid.size();
+    }
+
+    ExcelColumnType         type;
+    std::vector<double>     doubles;    // ECT_Double
+    std::vector<long long>  integers;   // ECT_Int64
+    std::vector<ELstring>   strings;    // ECT_String
+    std::vector<bool>       valid;      // validity bitmap: whether entry i holds the value of row i
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELCOLUMNS_H_GUID_8D41B7E2_C5A0_4E1F_93B6_2A7F05D9E48C
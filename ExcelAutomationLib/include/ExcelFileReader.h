@@ -0,0 +1,92 @@
+﻿/*!
+* @file    ExcelFileReader.h
+* @brief   Header file for class ExcelFileReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELFILEREADER_H_GUID_B482A542_D14D_4240_BD1D_D7758D55A64F
+#define EXCELFILEREADER_H_GUID_B482A542_D14D_4240_BD1D_D7758D55A64F
+
+
+#include "LibDef.h"
+#include "StringUtil.h"
+#include "ExcelWorkbook.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Options of ExcelFileReader::Open()
+*/
+struct ExcelFileReadOptions
+{
+    ExcelFileReadOptions(): preloadSheets(false), parallelSheets(1), maxResidentSheets(0) { }
+
+    bool preloadSheets;     // Read all the worksheets in Open(), instead of each one when its cells are used first
+    int  parallelSheets;    // With preloadSheets, number of worksheets read at the same time; 0 for one per processor
+    int  maxResidentSheets; // Without preloadSheets, number of worksheets kept in memory; 0 for no limit
+};
+
+
+/*!
+* @brief Class ExcelFileReader opens a workbook file directly, without starting Excel.
+*        All the members of ExcelFileReader are static member.
+* @details The returned ExcelWorkbook and the worksheets, ranges and cells got from it are the same handles
+*          as the ones for a workbook opened in Excel, so the code which reads them works with both. @n
+*          The workbook is read-only: every member which changes it fails, GetFont() returns a null ExcelFont
+*          and ExcelWorksheet::GetIDispatch() returns NULL. Values are read as they were saved, as formulas
+*          are not calculated. @n
+*          ExcelRange::ReadData() formats the values as Excel does through COM, except that dates are
+*          "YYYY-MM-DD hh:mm:ss" and errors are their text (such as "#N/A"). ExcelRange::ReadTyped() gives
+*          the strings in UTF-8 (ETT_String8). @n
+*          Supported formats: Office Open XML workbook (.xlsx, .xlsm), Excel binary workbook (.xlsb), Excel 97-2003
+*          workbook (.xls).
+* @note ExcelFileReader does not need COM, and it is available on Linux.
+* @note ExcelFileReader is not intended and allowed to be instantiated.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelFileReader
+{
+public:
+    /*!
+    * @brief Open a workbook file.
+    * @param [in] filename Name of the file. The format is detected from the content of the file.
+    * @return The workbook, or a null ExcelWorkbook if the file cannot be read.
+    * @note Only the directory of the workbook, such as the sheet names, is read now. The shared strings
+    *       are read when the cells of any worksheet are used first, and the cells of a worksheet when
+    *       any range or cell of it is read first.
+    */
+    static ExcelWorkbook Open(const ELstring &filename);
+
+    /*!
+    * @brief Open a workbook file with options.
+    * @param [in] filename Name of the file. The format is detected from the content of the file.
+    * @param [in] options How the worksheets are read. @n
+    *        With preloadSheets, the shared strings and the styles are read first, then the worksheets are
+    *        inflated and parsed in parallel, each by its own thread. It pays when most worksheets will be read. @n
+    *        With maxResidentSheets, the least recently used worksheet is released when another one has to be
+    *        read, and read again if it is used again. It bounds the memory for a workbook of many big worksheets.
+    * @return The workbook, or a null ExcelWorkbook if the file (or any worksheet, with preloadSheets) cannot be read.
+    */
+    static ExcelWorkbook Open(const ELstring &filename, const ExcelFileReadOptions &options);
+
+    /*!
+    * @brief Open a workbook file and read all its worksheets now, several at the same time.
+    * @note It is the same as Open() with the options preloadSheets and parallelSheets.
+    */
+    static ExcelWorkbook Open(const ELstring &filename, int parallelSheets);
+
+private:
+    // Forbid instantiation
+    ExcelFileReader();
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELFILEREADER_H_GUID_B482A542_D14D_4240_BD1D_D7758D55A64F
@@ -1,70 +1,158 @@
-﻿/*!
-* @file    ExcelFont.h
-* @brief   Header file for class ExcelFont
-* @date    2010-09-01 15:12:42
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef EXCELFONT_H_GUID_76A3C90B_F8F4_49A5_9F56_9CA86958D756
-#define EXCELFONT_H_GUID_76A3C90B_F8F4_49A5_9F56_9CA86958D756
-
-
-#include "LibDef.h"
-#include "HandleBody.h"
-#include "StringUtil.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-/*!
-* @brief Class ExcelFont represents the concept "Font" in Excel.
-* @note ExcelFont/ExcelFontImpl is an implementation of the "Handle/Body" pattern.
-*/
-class EXCEL_AUTOMATION_DLL_API ExcelFont : public HandleBase
-{
-public:
-    /*!
-    * Default constructor
-    */ // Doc is needed by Doxygen
-    ExcelFont() : HandleBase(0) { }
-
-    bool GetName(ELstring &name);
-    bool SetName(const ELstring &name);
-
-    bool GetSize(int &size);
-    bool SetSize(int size);
-
-    bool GetBold(bool &bold);
-    bool SetBold(bool bold);
-
-    bool GetItalic(bool &italic);
-    bool SetItalic(bool italic);
-
-    bool GetColor(COLORREF &rgb);
-    bool SetColor(COLORREF rgb);
-
-
-private:
-    friend class ExcelRangeImpl;  // which will call the following ctor
-    friend class ExcelCellImpl;   // which will call the following ctor
-    ExcelFont(IDispatch *pFont);
-
-private:
-    // <begin> Handle/Body pattern implementation
-    friend class ExcelFontImpl;
-    ExcelFont(ExcelFontImpl *impl);
-    ExcelFontImpl& Body() const;
-    // <end> Handle/Body pattern implementation
-};
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
-
-
-#endif //EXCELFONT_H_GUID_76A3C90B_F8F4_49A5_9F56_9CA86958D756
-
+﻿/*!
+* @file    ExcelFont.h
+* @brief   Header file for class ExcelFont
+* @date    2010-09-01 15:12:42
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef EXCELFONT_H_GUID_76A3C90B_F8F4_49A5_9F56_9CA86958D756
+#define EXCELFONT_H_GUID_76A3C90B_F8F4_49A5_9F56_9CA86958D756
+
+
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declaration
+class ExcelFontImpl;
+
+
+/*!
+* @brief Properties of a font, used as the bits of ExcelFontSpec::mask
+*/
+enum ExcelFontProperty
+{
+    EFP_Name   = 0x01,
+    EFP_Size   = 0x02,
+    EFP_Bold   = 0x04,
+    EFP_Italic = 0x08,
+    EFP_Color  = 0x10,
+    EFP_All    = 0x1F
+};
+
+
+/*!
+* @brief Struct ExcelFontSpec holds the properties of a font, see ExcelFont::GetSpec() and ExcelFont::ApplySpec().
+* @details @e mask tells which properties hold a value: the setters of ExcelFontSpec set their bit, and
+*          ExcelFont::GetSpec() sets the bit of every property which has one value over the whole range
+*          (a property which is mixed, such as a range partly bold, has no bit).
+*/
+struct ExcelFontSpec
+{
+    ExcelFontSpec(): size(0), bold(false), italic(false), color(0), mask(0) { }
+
+    void SetName(const ELstring &value)
+    {
+        name = value;
+        mask |= EFP_Name;
+    }
+
+    void SetSize(int value)
+    {
+        size = value;
+        mask |= EFP_Size;
+    }
+
+    void SetBold(bool value)
+    {
+        bold = value;
+        mask |= EFP_Bold;
+    }
+
+    void SetItalic(bool value)
+    {
+        italic = value;
+        mask |= EFP_Italic;
+    }
+
+    void SetColor(COLORREF value)
+    {
+        color = value;
+        mask |= EFP_Color;
+    }
+
+    bool Has(ExcelFontProperty property) const
+    {
+        return (mask & property) != 0;
+    }
+
+    ELstring     name;
+    int          size;
+    bool         bold;
+    bool         italic;
+    COLORREF     color;
+    unsigned int mask;      // bits of ExcelFontProperty
+};
+
+
+/*!
+* @brief Class ExcelFont represents the concept "Font" in Excel.
+* @note ExcelFont/ExcelFontImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelFont : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelFont() : HandleBase(0) { }
+
+    bool GetName(ELstring &name);
+    bool SetName(const ELstring &name);
+
+    bool GetSize(int &size);
+    bool SetSize(int size);
+
+    bool GetBold(bool &bold);
+    bool SetBold(bool bold);
+
+    bool GetItalic(bool &italic);
+    bool SetItalic(bool italic);
+
+    bool GetColor(COLORREF &rgb);
+    bool SetColor(COLORREF rgb);
+
+    /*!
+    * @brief Read all the properties of the font.
+    * @param [out] spec Which returns the properties; a mixed property is left out of @e spec.mask.
+    * @return true if successful, otherwise false
+    */
+    bool GetSpec(ExcelFontSpec &spec);
+
+    /*!
+    * @brief Write the properties in @e spec.mask which differ from the font.
+    * @details The properties are read first, in the same call, and only the ones which differ are put:
+    *          a get is much cheaper than a put, which makes Excel repaint.
+    * @return true if successful, otherwise false
+    */
+    bool ApplySpec(const ExcelFontSpec &spec);
+
+
+private:
+    friend class ComRangeImpl;        // which will call the following ctor
+    friend class ComCellImpl;         // which will call the following ctor
+    friend class ComWorksheetImpl;    // which will call the following ctor
+    ExcelFont(IDispatch *pFont);
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelFontImpl;
+    ExcelFont(ExcelFontImpl *impl);
+    ExcelFontImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELFONT_H_GUID_76A3C90B_F8F4_49A5_9F56_9CA86958D756
+
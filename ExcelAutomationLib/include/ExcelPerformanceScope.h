@@ -0,0 +1,71 @@
+﻿/*!
+* @file    ExcelPerformanceScope.h
+* @brief   Header file for class ExcelPerformanceScope
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELPERFORMANCESCOPE_H_GUID_CFA9635D_A82B_4661_BE92_2EEEE99233C7
+#define EXCELPERFORMANCESCOPE_H_GUID_CFA9635D_A82B_4661_BE92_2EEEE99233C7
+
+
+#include "LibDef.h"
+#include "ExcelApplication.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Class ExcelPerformanceScope puts Excel into a fast mode for bulk operations during its lifetime.
+* @details The constructor saves Application.ScreenUpdating, Application.EnableEvents and Application.Calculation,
+*          then turns off screen updating and events, and sets the calculation to manual. The destructor
+*          restores the saved settings, and calls Application.Calculate if asked to. @n
+*          Scopes can be nested. Only the outermost scope saves and restores the settings, and the
+*          recalculation asked by any scope happens once when the outermost scope exits.
+* @note The settings are restored when the scope is left by an exception as well.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelPerformanceScope
+{
+public:
+    /*!
+    * @brief Enter the performance mode.
+    * @param [in] app The application which must be running.
+    * @param [in] recalculateOnExit Whether to recalculate all open workbooks on exit.
+    */
+    explicit ExcelPerformanceScope(ExcelApplication app, bool recalculateOnExit = false);
+
+    /*!
+    * @brief Leave the performance mode.
+    */
+    ~ExcelPerformanceScope();
+
+    /*!
+    * @brief Whether all settings were changed successfully on enter.
+    * @note Calculation can not be changed before a workbook is opened, so false is returned in that case.
+    *       The other settings are still changed and will be restored.
+    */
+    bool Succeeded() const
+    {
+        return m_succeeded;
+    }
+
+private:
+    // Forbid copy
+    ExcelPerformanceScope(const ExcelPerformanceScope &);
+    ExcelPerformanceScope& operator = (const ExcelPerformanceScope &);
+
+private:
+    ExcelApplication m_app;
+    bool             m_recalculateOnExit;
+    bool             m_succeeded;
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELPERFORMANCESCOPE_H_GUID_CFA9635D_A82B_4661_BE92_2EEEE99233C7
@@ -1,155 +1,268 @@
-﻿/*!
-* @file    ExcelRange.h
-* @brief   Header file for class ExcelRange
-* @date    2009-12-08
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef EXCELRANGE_H_GUID_A48F0552_080F_444F_89EC_97ADCFC3A649
-#define EXCELRANGE_H_GUID_A48F0552_080F_444F_89EC_97ADCFC3A649
-
-
-#include <vector>
-#include "LibDef.h"
-#include "HandleBody.h"
-#include "StringUtil.h"
-#include "ExcelCommonTypes.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-// Forward declarations
-class ExcelWorksheet;
-class ExcelFont;
-
-
-/*!
-* @brief Class ExcelRange represents the concept "Range" in Excel.
-* @note ExcelRange/ExcelRangeImpl is an implementation of the "Handle/Body" pattern.
-*/
-class EXCEL_AUTOMATION_DLL_API ExcelRange : public HandleBase
-{
-public:
-    /*!
-    * Default constructor
-    */ // Doc is needed by Doxygen
-    ExcelRange(): HandleBase(0) { }
-
-    /*!
-    * @brief Encode values in this range into string form.
-    * @param [out] data The corresponding encoded string of this range.
-    * @return true if successful, otherwise false
-    * @note Encoding format: @n
-    *         EncodingString := <number of rows>#<number of columns>#{Values}            @n
-    *         Values := {RowValues}{RowValues}...{RowValues}              --> All rows in the two-dimentional array    @n
-    *         RowValues := {ColumnValue}{ColumnValue}...{ColumnValue}     --> All columns of in one row     @n
-    *         ColumnValue := <number of characters>#<the character string of the value>          @n
-    *       Example: @n
-    *         For the two-dimensional array (2*5) @n
-    *           { {abc, de, fghi, 3, 5235}, {23, 5353, 3253, 32} }, @n
-    *         The correpsonding encoded string is 2#5#3#abc2#de4#fghi1#34#52352#234#53530#4#32532#32.    @n
-    */
-    bool ReadData(ELstring &data);
-
-    /*!
-    * @brief Read values in this range into vector.
-    * @param [out] values Vector of Vectors of strings which holds values for this range
-    * @return true if successful, otherwise false
-    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
-    */
-    bool ReadData(std::vector<std::vector<ELstring> > &values);
-
-    /*!
-    * @brief Decode the string form of a range and write the data into this range.
-    * @return true if successful, otherwise false
-    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
-    * @note The source range and this range must have the same size (same number of rows and columns).
-    */
-    bool WriteData(const ELchar *data);
-
-    /*!
-    * @brief Decode the string form of a range and write the data into this range.
-    * @return true if successful, otherwise false
-    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
-    * @note The source range and this range must have the same size (same number of rows and columns).
-    */
-    bool WriteData(const ELstring &data);
-
-    /*!
-    * @brief Write values in the vector into this range.
-    * @return true if successful, otherwise false
-    * @note The vector and this range must have the same size (same number of rows and columns).
-    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
-    */
-    bool WriteData(const std::vector<std::vector<ELstring> > &values);
-
-    /*!
-    * @brief Decode the string form of a range into values
-    * @param [in] data The string form of a range (the encoded string)
-    * @param [out] Which returns the values for this range
-    * @return true if successful, otherwise false
-    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
-    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
-    */
-    static bool DecodeData(const ELstring &data, std::vector<std::vector<ELstring> > &values);
-
-    /*!
-    * @brief Encode values of a range into the string form
-    * @param [in] values The values for a range
-    * @return The string form of this range
-    * @note The sub-vector objects must have the same size, which is number of columns
-    * @note The encoding format is the one specified in ExcelRange::ReadData().
-    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
-    */
-    static ELstring EncodeData(const std::vector<std::vector<ELstring> > &values);
-
-    /*!
-    * @brief Merge this range into one cell or merge every row of this range into one cell.
-    * @param [in] multiRow If true, merge every row of the range into one cell;
-    *                      otherwise (false), merge the whole range into one cell.
-    * @return true if successful, otherwise false
-    */
-    bool Merge(bool multiRow = false);
-
-    /*!
-    * @brief Return an object representing the font property of this range
-    */
-    ExcelFont GetFont();
-
-    /*!
-    * @brief Set horizontal alignment of the range
-    * @param [in] align Refer to ExcelHorizontalAlignment
-    * @return true if successful, otherwise false
-    */
-    bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
-
-    /*!
-    * @brief Set vertical alignment of the range
-    * @param [in] align Refer to ExcelVerticalAlignment
-    * @return true if successful, otherwise false
-    */
-    bool SetVerticalAlignment(ExcelVerticalAlignment align);
-
-
-private:
-    friend class ExcelWorksheetImpl;  // which will call the following ctor
-    ExcelRange(IDispatch *pRange, ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
-
-private:
-    // <begin> Handle/Body pattern implementation
-    friend class ExcelRangeImpl;
-    ExcelRange(ExcelRangeImpl *impl);
-    ExcelRangeImpl& Body() const;
-    // <end> Handle/Body pattern implementation
-};
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
-
-
-#endif //EXCELRANGE_H_GUID_A48F0552_080F_444F_89EC_97ADCFC3A649
+﻿/*!
+* @file    ExcelRange.h
+* @brief   Header file for class ExcelRange
+* @date    2009-12-08
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef EXCELRANGE_H_GUID_A48F0552_080F_444F_89EC_97ADCFC3A649
+#define EXCELRANGE_H_GUID_A48F0552_080F_444F_89EC_97ADCFC3A649
+
+
+#include <vector>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+#include "ExcelCommonTypes.h"
+#include "ExcelColumns.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declarations
+class ExcelWorksheet;
+class ExcelFont;
+struct ExcelFontSpec;
+class ExcelRangeView;
+class ExcelValue;
+class ExcelRangeImpl;
+
+
+/*!
+* @brief Class ExcelRange represents the concept "Range" in Excel.
+* @note ExcelRange/ExcelRangeImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelRange : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelRange(): HandleBase(0) { }
+
+    /*!
+    * @brief Encode values in this range into string form.
+    * @param [out] data The corresponding encoded string of this range.
+    * @return true if successful, otherwise false
+    * @note Encoding format: @n
+    *         EncodingString := <number of rows>#<number of columns>#{Values}            @n
+    *         Values := {RowValues}{RowValues}...{RowValues}              --> All rows in the two-dimentional array    @n
+    *         RowValues := {ColumnValue}{ColumnValue}...{ColumnValue}     --> All columns of in one row     @n
+    *         ColumnValue := <number of characters>#<the character string of the value>          @n
+    *       Example: @n
+    *         For the two-dimensional array (2*5) @n
+    *           { {abc, de, fghi, 3, 5235}, {23, 5353, 3253, 32} }, @n
+    *         The correpsonding encoded string is 2#5#3#abc2#de4#fghi1#34#52352#234#53530#4#32532#32.    @n
+    */
+    bool ReadData(ELstring &data);
+
+    /*!
+    * @brief Read values in this range into vector.
+    * @param [out] values Vector of Vectors of strings which holds values for this range
+    * @return true if successful, otherwise false
+    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
+    */
+    bool ReadData(std::vector<std::vector<ELstring> > &values);
+
+    /*!
+    * @brief Read values in this range into a read-only view.
+    * @param [out] view Which returns the view over the encoded string of this range
+    * @return true if successful, otherwise false
+    * @note Unlike ReadData(std::vector<std::vector<ELstring> >&), no string is allocated per cell.
+    *       Prefer it when the values are only scanned.
+    */
+    bool ReadData(ExcelRangeView &view);
+
+    /*!
+    * @brief Decode the string form of a range and write the data into this range.
+    * @return true if successful, otherwise false
+    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
+    * @note The source range and this range must have the same size (same number of rows and columns).
+    */
+    bool WriteData(const ELchar *data);
+
+    /*!
+    * @brief Decode the string form of a range and write the data into this range.
+    * @return true if successful, otherwise false
+    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
+    * @note The source range and this range must have the same size (same number of rows and columns).
+    */
+    bool WriteData(const ELstring &data);
+
+    /*!
+    * @brief Write values in the vector into this range.
+    * @return true if successful, otherwise false
+    * @note The vector and this range must have the same size (same number of rows and columns).
+    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
+    */
+    bool WriteData(const std::vector<std::vector<ELstring> > &values);
+
+    /*!
+    * @brief Write only the cells whose values changed since this range was last read or written.
+    * @return true if successful, otherwise false
+    * @details This range keeps a hash of every cell as it was last read by ReadData() or written by
+    *          WriteData() or WriteDataIfChanged(). The cells which differ from it are covered with dense
+    *          rectangles and only these are written, so a refresh which changes few cells sends few values
+    *          and makes Excel recalculate less. If there is nothing to compare with (the first write, a
+    *          write in another way, or a data of another size), the whole range is written.
+    * @note Keep the same ExcelRange object across the refreshes: a range got again has no hashes yet.
+    *       A change made in Excel, not through this range, is not seen.
+    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
+    */
+    bool WriteDataIfChanged(const ELchar *data);
+
+    /*!
+    * @brief Write only the cells whose values changed, see WriteDataIfChanged(const ELchar*).
+    */
+    bool WriteDataIfChanged(const ELstring &data);
+
+    /*!
+    * @brief Write only the cells whose values changed, see WriteDataIfChanged(const ELchar*).
+    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
+    */
+    bool WriteDataIfChanged(const std::vector<std::vector<ELstring> > &values);
+
+    /*!
+    * @brief Encode values in this range into the typed binary encoding.
+    * @param [out] data The corresponding encoded data of this range.
+    * @return true if successful, otherwise false
+    * @note The encoding format is the one specified in ExcelTypedCodec.h. Unlike ReadData(ELstring&),
+    *       numbers, dates, booleans and errors keep their types and are not formatted as text.
+    *       Use ExcelTypedReader to walk the data.
+    */
+    bool ReadTyped(std::vector<unsigned char> &data);
+
+    /*!
+    * @brief Decode data in the typed binary encoding and write the values into this range.
+    * @return true if successful, otherwise false
+    * @note The encoding format of @e data must be the one specified in ExcelTypedCodec.h.
+    *       Use ExcelTypedWriter to build the data.
+    * @note The source range and this range must have the same size (same number of rows and columns).
+    */
+    bool WriteTyped(const std::vector<unsigned char> &data);
+
+    /*!
+    * @brief Read values in this range with their types.
+    * @param [out] values Which returns the values of this range, row by row
+    * @return true if successful, otherwise false
+    * @note values[i * columns + j] holds the value for row i and column j of this range (i and j start
+    *       from 0), where columns is the number of columns of this range.
+    * @note Unlike ReadData(), numbers, dates, booleans and errors keep their types and are not formatted
+    *       as text; unlike ReadTyped(), the values need no decoding.
+    */
+    bool ReadValues(std::vector<ExcelValue> &values);
+
+    /*!
+    * @brief Write values with their types into this range.
+    * @return true if successful, otherwise false
+    * @note The layout of @e values is the one specified in ExcelRange::ReadValues(), and its size must be
+    *       the number of cells of this range.
+    */
+    bool WriteValues(const std::vector<ExcelValue> &values);
+
+    /*!
+    * @brief Read values in this range column by column into typed buffers.
+    * @param [in,out] columns One buffer per column of this range, whose @e type is set by the caller;
+    *                         columns[j].Size() is the number of rows of this range after the call.
+    * @return true if successful, otherwise false (also if the number of buffers is not the number of
+    *         columns of this range)
+    * @note The values go straight into the buffers, in one pass, without an encoded string or a vector per
+    *       row as ReadData() makes. See ExcelColumn for how a value is converted to the type of a buffer.
+    */
+    bool ReadColumns(std::vector<ExcelColumn> &columns);
+
+    /*!
+    * @brief Get the value of the first (top-left) cell of this range with its type.
+    * @return true if successful, otherwise false
+    */
+    bool GetValue(ExcelValue &value);
+
+    /*!
+    * @brief Set every cell of this range to the same value.
+    * @return true if successful, otherwise false
+    */
+    bool SetValue(const ExcelValue &value);
+
+    /*!
+    * @brief Decode the string form of a range into values
+    * @param [in] data The string form of a range (the encoded string)
+    * @param [out] Which returns the values for this range
+    * @return true if successful, otherwise false
+    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
+    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
+    */
+    static bool DecodeData(const ELstring &data, std::vector<std::vector<ELstring> > &values);
+
+    /*!
+    * @brief Encode values of a range into the string form
+    * @param [in] values The values for a range
+    * @return The string form of this range
+    * @note The sub-vector objects must have the same size, which is number of columns
+    * @note The encoding format is the one specified in ExcelRange::ReadData().
+    * @note values[i][j] holds the value for row i and column j of this range (i and j start from 0)
+    */
+    static ELstring EncodeData(const std::vector<std::vector<ELstring> > &values);
+
+    /*!
+    * @brief Merge this range into one cell or merge every row of this range into one cell.
+    * @param [in] multiRow If true, merge every row of the range into one cell;
+    *                      otherwise (false), merge the whole range into one cell.
+    * @return true if successful, otherwise false
+    */
+    bool Merge(bool multiRow = false);
+
+    /*!
+    * @brief Return an object representing the font property of this range
+    */
+    ExcelFont GetFont();
+
+    /*!
+    * @brief Read all the properties of the font of this range, see ExcelFont::GetSpec().
+    * @return true if successful, otherwise false; always false for a workbook opened by ExcelFileReader
+    */
+    bool GetFontSpec(ExcelFontSpec &spec);
+
+    /*!
+    * @brief Write the properties of the font of this range which differ from @e spec, see ExcelFont::ApplySpec().
+    * @return true if successful, otherwise false; always false for a workbook opened by ExcelFileReader
+    * @note To give many ranges the same font, see ExcelWorksheet::ApplyFontSpec().
+    */
+    bool ApplyFontSpec(const ExcelFontSpec &spec);
+
+    /*!
+    * @brief Set horizontal alignment of the range
+    * @param [in] align Refer to ExcelHorizontalAlignment
+    * @return true if successful, otherwise false
+    */
+    bool SetHorizontalAlignment(ExcelHorizontalAlignment align);
+
+    /*!
+    * @brief Set vertical alignment of the range
+    * @param [in] align Refer to ExcelVerticalAlignment
+    * @return true if successful, otherwise false
+    */
+    bool SetVerticalAlignment(ExcelVerticalAlignment align);
+
+
+private:
+    friend class ComWorksheetImpl;    // which will call the following ctor
+    ExcelRange(IDispatch *pRange, ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelRangeImpl;
+    ExcelRange(ExcelRangeImpl *impl);
+    ExcelRangeImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELRANGE_H_GUID_A48F0552_080F_444F_89EC_97ADCFC3A649
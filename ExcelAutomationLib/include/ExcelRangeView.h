@@ -0,0 +1,103 @@
+﻿/*!
+* @file    ExcelRangeView.h
+* @brief   Header file for class ExcelRangeView
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELRANGEVIEW_H_GUID_2D828AB7_6B69_4D01_B875_9607F98B34DF
+#define EXCELRANGEVIEW_H_GUID_2D828AB7_6B69_4D01_B875_9607F98B34DF
+
+
+#include <cstddef>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declaration
+class ExcelRangeViewImpl;
+
+
+/*!
+* @brief ExcelStringRef refers to a character string owned by someone else (pointer + length).
+* @note The referred characters are not NUL-terminated.
+*/
+struct ExcelStringRef
+{
+    ExcelStringRef(): str(0), length(0) { }
+    ExcelStringRef(const ELchar *s, size_t len): str(s), length(len) { }
+
+    /*!
+    * @brief Make a copy of the referred characters.
+    */
+    ELstring ToString() const
+    {
+        return ELstring(str, length);
+    }
+
+    const ELchar *str;      // first character of the string
+    size_t        length;   // number of characters
+};
+
+
+/*!
+* @brief Class ExcelRangeView is a read-only view over the encoded string form of a range.
+* @details The encoded string is held once and an offset index is built over it, so reading
+*          values allocates nothing per cell. Copying an ExcelRangeView shares the same buffer.
+* @note The encoding format is the one specified in ExcelRange::ReadData().
+* @note ExcelRangeView/ExcelRangeViewImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelRangeView : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelRangeView(): HandleBase(0) { }
+
+    /*!
+    * @brief Number of rows in the view, 0 for a null view
+    */
+    int CountRows() const;
+
+    /*!
+    * @brief Number of columns in the view, 0 for a null view
+    */
+    int CountColumns() const;
+
+    /*!
+    * @brief Return the value for row @e row and column @e column (both start from 0)
+    * @note The returned reference stays valid as long as any ExcelRangeView sharing this buffer is alive.
+    */
+    ExcelStringRef GetValue(int row, int column) const;
+
+    /*!
+    * @brief Build a view over the string form of a range.
+    * @param [in,out] data The string form of a range (the encoded string).
+    *                      Its content is moved into the view, so @e data is empty on return.
+    * @param [out] view Which returns the view
+    * @return true if successful, otherwise false (@e data is left untouched)
+    * @note The encoding format of @e data must be the one specified in ExcelRange::ReadData().
+    */
+    static bool Decode(ELstring &data, ExcelRangeView &view);
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelRangeViewImpl;
+    ExcelRangeView(ExcelRangeViewImpl *impl);
+    ExcelRangeViewImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELRANGEVIEW_H_GUID_2D828AB7_6B69_4D01_B875_9607F98B34DF
@@ -0,0 +1,180 @@
+﻿/*!
+* @file    ExcelRowQuery.h
+* @brief   Header file for class ExcelRowQuery and class ExcelRowPredicate
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELROWQUERY_H_GUID_3F0B8C2E_5A61_4D7B_9E24_C1A7D9E05B38
+#define EXCELROWQUERY_H_GUID_3F0B8C2E_5A61_4D7B_9E24_C1A7D9E05B38
+
+
+#include <vector>
+#include "LibDef.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Operators of the comparison of ExcelRowQuery::Where()
+*/
+enum ExcelCompareOperator
+{
+    ECO_Equal,
+    ECO_NotEqual,
+    ECO_Less,
+    ECO_LessEqual,
+    ECO_Greater,
+    ECO_GreaterEqual
+};
+
+
+/*!
+* @brief Class ExcelRowPredicate decides which rows ExcelWorksheet::ReadRows() returns.
+*/
+class ExcelRowPredicate
+{
+public:
+    virtual ~ExcelRowPredicate() { }
+
+    /*!
+    * @param [in] row Number of the row, starts from 1.
+    * @param [in] values Values of the selected columns of the row, in the order they were selected,
+    *                    formatted as ExcelRange::ReadData() does.
+    * @return true to return the row.
+    */
+    virtual bool Accept(int row, const std::vector<ELstring> &values) = 0;
+};
+
+
+/*!
+* @brief Class ExcelRowQuery describes what ExcelWorksheet::ReadRows() reads: some columns of the rows which
+*        meet a condition.
+* @details Columns are numbers, 1 for column A, so columns after Z can be selected. @n
+*          The condition is either a comparison of the value of one column (which needs not be selected) with
+*          a constant, or an ExcelRowPredicate. A comparison is numeric if both the value and the constant are
+*          numbers, otherwise the two strings are compared; an empty cell is an empty string.
+* @note The members which set the query return the query itself, so they can be chained: @n
+*       ExcelRowQuery().Select(2).Select(5).Where(3, ECO_Greater, ELtext("100"))
+*/
+class ExcelRowQuery
+{
+public:
+    ExcelRowQuery(): m_rowFrom(1), m_rowTo(0), m_whereColumn(0), m_whereOperator(ECO_Equal), m_predicate(NULL) { }
+
+    /*!
+    * @brief Select a column. The values of a row are in the order the columns are selected.
+    */
+    ExcelRowQuery& Select(int column)
+    {
+        m_columns.push_back(column);
+        return *this;
+    }
+
+    /*!
+    * @brief Select the columns from @e columnFrom to @e columnTo.
+    */
+    ExcelRowQuery& Select(int columnFrom, int columnTo)
+    {
+        for (int column = columnFrom; column <= columnTo; ++column)
+            m_columns.push_back(column);
+        return *this;
+    }
+
+    /*!
+    * @brief Read only the rows from @e rowFrom to @e rowTo; @e rowTo is 0 for the last row with data.
+    * @note A query of a workbook in Excel needs @e rowTo, see ExcelWorksheet::ReadRows().
+    * @note By default every row is read.
+    */
+    ExcelRowQuery& SetRows(int rowFrom, int rowTo)
+    {
+        m_rowFrom = rowFrom;
+        m_rowTo = rowTo;
+        return *this;
+    }
+
+    /*!
+    * @brief Read only the rows whose value of @e column compares to @e value as @e op tells.
+    */
+    ExcelRowQuery& Where(int column, ExcelCompareOperator op, const ELstring &value)
+    {
+        m_whereColumn = column;
+        m_whereOperator = op;
+        m_whereValue = value;
+        m_predicate = NULL;
+        return *this;
+    }
+
+    /*!
+    * @brief Read only the rows which @e predicate accepts.
+    * @note The predicate must outlive the query, and is not deleted by it.
+    */
+    ExcelRowQuery& Where(ExcelRowPredicate *predicate)
+    {
+        m_whereColumn = 0;
+        m_predicate = predicate;
+        return *this;
+    }
+
+    const std::vector<int>& GetColumns() const
+    {
+        return m_columns;
+    }
+
+    int GetRowFrom() const
+    {
+        return m_rowFrom;
+    }
+
+    int GetRowTo() const
+    {
+        return m_rowTo;
+    }
+
+    /*!
+    * @return 0 if there is no comparison.
+    */
+    int GetWhereColumn() const
+    {
+        return m_whereColumn;
+    }
+
+    ExcelCompareOperator GetWhereOperator() const
+    {
+        return m_whereOperator;
+    }
+
+    const ELstring& GetWhereValue() const
+    {
+        return m_whereValue;
+    }
+
+    /*!
+    * @return NULL if there is no predicate.
+    */
+    ExcelRowPredicate* GetPredicate() const
+    {
+        return m_predicate;
+    }
+
+private:
+    std::vector<int>      m_columns;
+    int                   m_rowFrom;
+    int                   m_rowTo;
+
+    int                   m_whereColumn;
+    ExcelCompareOperator  m_whereOperator;
+    ELstring              m_whereValue;
+    ExcelRowPredicate    *m_predicate;
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELROWQUERY_H_GUID_3F0B8C2E_5A61_4D7B_9E24_C1A7D9E05B38
@@ -0,0 +1,457 @@
+﻿/*!
+* @file    ExcelTypedCodec.h
+* @brief   Header file for the typed binary encoding of a range
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELTYPEDCODEC_H_GUID_2F27E979_6783_4ED8_9438_6D2D808FD6F7
+#define EXCELTYPEDCODEC_H_GUID_2F27E979_6783_4ED8_9438_6D2D808FD6F7
+
+
+/*!
+* @file
+* This file implements the typed binary encoding of a range, which keeps the type of every value
+* instead of stringifying it. See ExcelRange::ReadTyped() and ExcelRange::WriteTyped(). @n
+* Encoding format (all integers are little-endian): @n
+*   Header := 'E' 'T' <version: 1 byte> <flags: 1 byte, 0> <rows: 4 bytes> <columns: 4 bytes>  @n
+*   Values := {Value}{Value}...{Value}          --> rows * columns values, row by row       @n
+*   Value  := <tag: 1 byte> <payload>           --> tag is one of ExcelTypedTag              @n
+*   Payload of each tag: @n
+*     ETT_Empty    none                                                @n
+*     ETT_Double   8 bytes, IEEE 754 double                            @n
+*     ETT_Int64    8 bytes, signed integer                             @n
+*     ETT_Bool     1 byte, 0 or 1                                      @n
+*     ETT_Error    4 bytes, error code (SCODE of a VT_ERROR VARIANT)   @n
+*     ETT_Date     8 bytes, IEEE 754 double (OLE Automation date)      @n
+*     ETT_String16 <number of code units: 4 bytes> <UTF-16 code units, 2 bytes each>  @n
+*     ETT_String8  <number of bytes: 4 bytes> <UTF-8 bytes>            @n
+* @note Everything in this file is inline and does not depend on COM, so the encoded data can be
+*       produced and consumed on any platform.
+*/
+
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "LibDef.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Type tag of a value in the typed binary encoding
+*/
+enum ExcelTypedTag
+{
+    ETT_Empty    = 0,     // Empty cell
+    ETT_Double   = 1,     // Number
+    ETT_Int64    = 2,     // Integer
+    ETT_Bool     = 3,     // Boolean
+    ETT_Error    = 4,     // Error value, such as #N/A
+    ETT_Date     = 5,     // Date/time as an OLE Automation date
+    ETT_String16 = 6,     // UTF-16 string
+    ETT_String8  = 7      // UTF-8 string
+};
+
+
+/*!
+* @brief Constants of the typed binary encoding
+*/
+enum ExcelTypedFormat
+{
+    ETF_Version    = 1,   // Current version of the encoding
+    ETF_HeaderSize = 12   // Size of the header in bytes
+};
+
+
+/*!
+* @brief One decoded value of the typed binary encoding.
+* @note For strings, @e text refers into the encoded buffer (no copy is made).
+*/
+struct ExcelTypedValue
+{
+    ExcelTypedValue(): tag(ETT_Empty), number(0), integer(0), boolean(false), error(0), text(0), textLength(0) { }
+
+    /*!
+    * @brief Make a copy of a string value (ETT_String16 or ETT_String8).
+    */
+    std::wstring GetString() const;
+
+    ExcelTypedTag        tag;
+    double               number;      // ETT_Double, ETT_Date
+    long long            integer;     // ETT_Int64
+    bool                 boolean;     // ETT_Bool
+    int                  error;       // ETT_Error
+    const unsigned char *text;        // ETT_String16, ETT_String8: first byte of the string
+    size_t               textLength;  // ETT_String16: number of code units; ETT_String8: number of bytes
+};
+
+
+/*!
+* @brief Class ExcelTypedWriter appends a range to a buffer in the typed binary encoding.
+* @note Call Begin() once, then put exactly rows * columns values, row by row.
+*/
+class ExcelTypedWriter
+{
+public:
+    /*!
+    * @param [out] buffer The buffer which receives the encoded data. Existing content is kept.
+    */
+    explicit ExcelTypedWriter(std::vector<unsigned char> &buffer): m_buffer(buffer)
+    {
+    }
+
+    void Begin(int rows, int columns)
+    {
+        m_buffer.push_back('E');
+        m_buffer.push_back('T');
+        m_buffer.push_back(static_cast<unsigned char>(ETF_Version));
+        m_buffer.push_back(0);
+        PutUInt32(static_cast<unsigned long>(rows));
+        PutUInt32(static_cast<unsigned long>(columns));
+    }
+
+    void PutEmpty()
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_Empty));
+    }
+
+    void PutDouble(double value)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_Double));
+        PutRawDouble(value);
+    }
+
+    void PutInt64(long long value)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_Int64));
+        PutUInt64(static_cast<unsigned long long>(value));
+    }
+
+    void PutBool(bool value)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_Bool));
+        m_buffer.push_back(value ? 1 : 0);
+    }
+
+    void PutError(int code)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_Error));
+        PutUInt32(static_cast<unsigned long>(code));
+    }
+
+    void PutDate(double value)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_Date));
+        PutRawDouble(value);
+    }
+
+    /*!
+    * @brief Put a string given as wide characters. It is stored as UTF-16.
+    */
+    void PutString(const wchar_t *str, size_t length)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_String16));
+
+        // reserve the length field, it is patched after the code units are written
+        size_t lengthPos = m_buffer.size();
+        PutUInt32(0);
+
+        unsigned long units = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            unsigned long ch = static_cast<unsigned long>(str[i]);
+            if (sizeof(wchar_t) > 2 && ch > 0xFFFF)
+            {
+                // encode as a surrogate pair
+                ch -= 0x10000;
+                PutUInt16(0xD800 + ((ch >> 10) & 0x3FF));
+                PutUInt16(0xDC00 + (ch & 0x3FF));
+                units += 2;
+            }
+            else
+            {
+                PutUInt16(ch & 0xFFFF);
+                ++units;
+            }
+        }
+
+        for (int k = 0; k < 4; ++k)
+            m_buffer[lengthPos + k] = static_cast<unsigned char>((units >> (8 * k)) & 0xFF);
+    }
+
+    void PutString(const std::wstring &str)
+    {
+        PutString(str.c_str(), str.length());
+    }
+
+    /*!
+    * @brief Put a string given as UTF-8 bytes. It is stored as it is.
+    */
+    void PutStringUtf8(const char *str, size_t length)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(ETT_String8));
+        PutUInt32(static_cast<unsigned long>(length));
+        m_buffer.insert(m_buffer.end(), str, str + length);
+    }
+
+private:
+    void PutUInt16(unsigned long value)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(value & 0xFF));
+        m_buffer.push_back(static_cast<unsigned char>((value >> 8) & 0xFF));
+    }
+
+    void PutUInt32(unsigned long value)
+    {
+        for (int k = 0; k < 4; ++k)
+            m_buffer.push_back(static_cast<unsigned char>((value >> (8 * k)) & 0xFF));
+    }
+
+    void PutUInt64(unsigned long long value)
+    {
+        for (int k = 0; k < 8; ++k)
+            m_buffer.push_back(static_cast<unsigned char>((value >> (8 * k)) & 0xFF));
+    }
+
+    void PutRawDouble(double value)
+    {
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        PutUInt64(bits);
+    }
+
+    // Forbid copy assignment
+    ExcelTypedWriter& operator = (const ExcelTypedWriter &);
+
+private:
+    std::vector<unsigned char> &m_buffer;
+};
+
+
+/*!
+* @brief Class ExcelTypedReader walks a buffer in the typed binary encoding.
+* @note Call ReadHeader() once, then call Next() rows * columns times.
+*/
+class ExcelTypedReader
+{
+public:
+    ExcelTypedReader(const unsigned char *data, size_t size): m_pos(data), m_end(data + size)
+    {
+    }
+
+    /*!
+    * @brief Read the header.
+    * @return true if successful, otherwise false (not a supported typed encoding)
+    */
+    bool ReadHeader(int &rows, int &columns)
+    {
+        if (Remaining() < ETF_HeaderSize)
+            return false;
+
+        if (m_pos[0] != 'E' || m_pos[1] != 'T' || m_pos[2] != ETF_Version)
+            return false;
+
+        // no flag is defined yet, so a range with one is of a newer encoding
+        if (m_pos[3] != 0)
+            return false;
+
+        m_pos += 4;
+        unsigned long r = GetUInt32();
+        unsigned long c = GetUInt32();
+        if (r > 0x7FFFFFFF || c > 0x7FFFFFFF)
+            return false;
+
+        rows = static_cast<int>(r);
+        columns = static_cast<int>(c);
+        return true;
+    }
+
+    /*!
+    * @brief Read the next value.
+    * @return true if successful, otherwise false (truncated data or unknown tag)
+    */
+    bool Next(ExcelTypedValue &value)
+    {
+        if (Remaining() < 1)
+            return false;
+
+        // an unknown tag is checked before it is cast, it is not a value of ExcelTypedTag
+        unsigned char tag = *m_pos++;
+        if (tag > ETT_String8)
+            return false;
+
+        value.tag = static_cast<ExcelTypedTag>(tag);
+
+        switch (value.tag)
+        {
+        case ETT_Empty:
+            return true;
+
+        case ETT_Double:
+        case ETT_Date:
+            if (Remaining() < 8)
+                return false;
+            value.number = GetRawDouble();
+            return true;
+
+        case ETT_Int64:
+            if (Remaining() < 8)
+                return false;
+            value.integer = static_cast<long long>(GetUInt64());
+            return true;
+
+        case ETT_Bool:
+            if (Remaining() < 1)
+                return false;
+            value.boolean = (*m_pos++ != 0);
+            return true;
+
+        case ETT_Error:
+            if (Remaining() < 4)
+                return false;
+            value.error = static_cast<int>(GetUInt32());
+            return true;
+
+        case ETT_String16:
+        case ETT_String8:
+            {
+                if (Remaining() < 4)
+                    return false;
+
+                // check the length before it is multiplied, so that it cannot overflow
+                size_t length = GetUInt32();
+                size_t unit = (value.tag == ETT_String16 ? 2 : 1);
+                if (length > Remaining() / unit)
+                    return false;
+
+                size_t bytes = unit * length;
+
+                value.text = m_pos;
+                value.textLength = length;
+                m_pos += bytes;
+                return true;
+            }
+
+        default:
+            return false; // Unknown type
+        }
+    }
+
+private:
+    size_t Remaining() const
+    {
+        return static_cast<size_t>(m_end - m_pos);
+    }
+
+    unsigned long GetUInt32()
+    {
+        unsigned long value = 0;
+        for (int k = 0; k < 4; ++k)
+            value |= static_cast<unsigned long>(m_pos[k]) << (8 * k);
+        m_pos += 4;
+        return value;
+    }
+
+    unsigned long long GetUInt64()
+    {
+        unsigned long long value = 0;
+        for (int k = 0; k < 8; ++k)
+            value |= static_cast<unsigned long long>(m_pos[k]) << (8 * k);
+        m_pos += 8;
+        return value;
+    }
+
+    double GetRawDouble()
+    {
+        unsigned long long bits = GetUInt64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+private:
+    const unsigned char *m_pos;
+    const unsigned char *m_end;
+};
+
+
+inline std::wstring ExcelTypedValue::GetString() const
+{
+    std::wstring result;
+
+    if (tag == ETT_String16)
+    {
+        result.reserve(textLength);
+        for (size_t i = 0; i < textLength; ++i)
+        {
+            unsigned long ch = text[2 * i] | (static_cast<unsigned long>(text[2 * i + 1]) << 8);
+            if (sizeof(wchar_t) > 2 && ch >= 0xD800 && ch < 0xDC00 && i + 1 < textLength)
+            {
+                // combine a surrogate pair into one wide character
+                unsigned long low = text[2 * i + 2] | (static_cast<unsigned long>(text[2 * i + 3]) << 8);
+                if (low >= 0xDC00 && low < 0xE000)
+                {
+                    ch = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
+                }
+            }
+            result.push_back(static_cast<wchar_t>(ch));
+        }
+    }
+    else if (tag == ETT_String8)
+    {
+        result.reserve(textLength);
+        size_t i = 0;
+        while (i < textLength)
+        {
+            unsigned long ch = text[i];
+            int extra = 0;
+            if (ch >= 0xF0)
+            {
+                ch &= 0x07;
+                extra = 3;
+            }
+            else if (ch >= 0xE0)
+            {
+                ch &= 0x0F;
+                extra = 2;
+            }
+            else if (ch >= 0xC0)
+            {
+                ch &= 0x1F;
+                extra = 1;
+            }
+
+            ++i;
+            for (; extra > 0 && i < textLength; --extra, ++i)
+                ch = (ch << 6) | (text[i] & 0x3F);
+
+            if (sizeof(wchar_t) == 2 && ch > 0xFFFF)
+            {
+                // encode as a surrogate pair
+                ch -= 0x10000;
+                result.push_back(static_cast<wchar_t>(0xD800 + ((ch >> 10) & 0x3FF)));
+                result.push_back(static_cast<wchar_t>(0xDC00 + (ch & 0x3FF)));
+            }
+            else
+            {
+                result.push_back(static_cast<wchar_t>(ch));
+            }
+        }
+    }
+
+    return result;
+}
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELTYPEDCODEC_H_GUID_2F27E979_6783_4ED8_9438_6D2D808FD6F7
@@ -0,0 +1,230 @@
+﻿/*!
+* @file    ExcelValue.h
+* @brief   Header file for class ExcelValue
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELVALUE_H_GUID_5C0E8A3D_17B4_4F69_9E2A_D84B63F1C07E
+#define EXCELVALUE_H_GUID_5C0E8A3D_17B4_4F69_9E2A_D84B63F1C07E
+
+
+#include <cassert>
+#include "LibDef.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+/*!
+* @brief Type of the value held by an ExcelValue
+*/
+enum ExcelValueType
+{
+    EVT_Empty  = 0,     // Empty cell
+    EVT_Double = 1,     // Number
+    EVT_Int64  = 2,     // Integer
+    EVT_Bool   = 3,     // Boolean
+    EVT_String = 4,     // String
+    EVT_Error  = 5,     // Error value, such as #N/A
+    EVT_Date   = 6      // Date/time as an OLE Automation date
+};
+
+
+/*!
+* @brief Class ExcelValue holds the value of one cell with its type, as a VARIANT does.
+* @details Unlike ExcelCell::GetValue(ELstring&), a number read into an ExcelValue is not formatted
+*          as text, so it does not depend on the locale and does not need to be parsed back. @n
+*          An ExcelValue takes 16 bytes: the value and the type. A string is allocated out of line,
+*          so a large two-dimensional buffer of ExcelValue (see ExcelRange::ReadValues()) stays compact.
+* @note The error value is the SCODE of a VT_ERROR VARIANT which Excel returns for a cell error,
+*       such as 0x800A07FA for #N/A (xlErrNA is 2042), as in the typed binary encoding.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelValue
+{
+public:
+    /*!
+    * Default constructor, which makes an empty value
+    */ // Doc is needed by Doxygen
+    ExcelValue(): m_type(EVT_Empty)
+    {
+        m_data.integer = 0;
+    }
+
+    explicit ExcelValue(double value): m_type(EVT_Double)
+    {
+        m_data.number = value;
+    }
+
+    explicit ExcelValue(int value): m_type(EVT_Int64)
+    {
+        m_data.integer = value;
+    }
+
+    explicit ExcelValue(long long value): m_type(EVT_Int64)
+    {
+        m_data.integer = value;
+    }
+
+    explicit ExcelValue(bool value): m_type(EVT_Bool)
+    {
+        m_data.integer = 0;
+        m_data.boolean = value;
+    }
+
+    explicit ExcelValue(const ELstring &value);
+    explicit ExcelValue(const ELchar *value);
+
+    ExcelValue(const ExcelValue &other);
+    ExcelValue& operator = (const ExcelValue &other);
+    ~ExcelValue();
+
+    /*!
+    * @brief Make an error value.
+    * @param [in] error The SCODE of the error, such as 0x800A07FA for #N/A
+    */
+    static ExcelValue MakeError(int error)
+    {
+        ExcelValue value;
+        value.SetError(error);
+        return value;
+    }
+
+    /*!
+    * @brief Make a date value.
+    * @param [in] date An OLE Automation date
+    */
+    static ExcelValue MakeDate(double date)
+    {
+        ExcelValue value;
+        value.SetDate(date);
+        return value;
+    }
+
+    ExcelValueType GetType() const
+    {
+        return m_type;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_type == EVT_Empty;
+    }
+
+    // <begin> Get the value; the type must match (a date is got by GetDouble())
+    double GetDouble() const
+    {
+        assert(m_type == EVT_Double || m_type == EVT_Date);
+        return m_data.number;
+    }
+
+    long long GetInt64() const
+    {
+        assert(m_type == EVT_Int64);
+        return m_data.integer;
+    }
+
+    bool GetBool() const
+    {
+        assert(m_type == EVT_Bool);
+        return m_data.boolean;
+    }
+
+    const ELstring& GetString() const
+    {
+        assert(m_type == EVT_String);
+        return *m_data.text;
+    }
+
+    int GetError() const
+    {
+        assert(m_type == EVT_Error);
+        return m_data.error;
+    }
+    // <end> Get the value
+
+    /*!
+    * @brief Get a number, an integer, a boolean (1 or 0) or a date as a double.
+    * @return false for an empty, string or error value
+    */
+    bool ToDouble(double &number) const;
+
+    // <begin> Set the value and its type
+    void Clear();
+
+    void SetDouble(double value)
+    {
+        Clear();
+        m_type = EVT_Double;
+        m_data.number = value;
+    }
+
+    void SetInt64(long long value)
+    {
+        Clear();
+        m_type = EVT_Int64;
+        m_data.integer = value;
+    }
+
+    void SetBool(bool value)
+    {
+        Clear();
+        m_type = EVT_Bool;
+        m_data.boolean = value;
+    }
+
+    void SetString(const ELstring &value);
+    void SetString(const ELchar *value, size_t length);
+
+    void SetError(int error)
+    {
+        Clear();
+        m_type = EVT_Error;
+        m_data.error = error;
+    }
+
+    void SetDate(double date)
+    {
+        Clear();
+        m_type = EVT_Date;
+        m_data.number = date;
+    }
+    // <end> Set the value and its type
+
+    /*!
+    * @brief Exchange the values of two objects, without copying a string.
+    */
+    void Swap(ExcelValue &other)
+    {
+        Data data = m_data;
+        m_data = other.m_data;
+        other.m_data = data;
+
+        ExcelValueType type = m_type;
+        m_type = other.m_type;
+        other.m_type = type;
+    }
+
+private:
+    union Data
+    {
+        double     number;      // EVT_Double, EVT_Date
+        long long  integer;     // EVT_Int64
+        bool       boolean;     // EVT_Bool
+        int        error;       // EVT_Error
+        ELstring  *text;        // EVT_String, owned
+    };
+
+    Data           m_data;
+    ExcelValueType m_type;
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELVALUE_H_GUID_5C0E8A3D_17B4_4F69_9E2A_D84B63F1C07E
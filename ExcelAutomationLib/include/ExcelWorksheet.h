@@ -1,93 +1,165 @@
-﻿/*!
-* @file    ExcelWorksheet.h
-* @brief   Header file for class ExcelWorksheet
-* @date    2009-12-01
-* @author  Tu Yongce <tuyongce@gmail.com>
-* @version $Id$
-*/
-
-
-#ifndef EXCELWORKSHEET_H_GUID_61B8B170_8EC6_4530_8CB9_E4B017D81BC0
-#define EXCELWORKSHEET_H_GUID_61B8B170_8EC6_4530_8CB9_E4B017D81BC0
-
-
-#include "LibDef.h"
-#include "HandleBody.h"
-#include "StringUtil.h"
-
-
-// <begin> namespace
-EXCEL_AUTOMATION_NAMESPACE_START
-
-
-// Forward declaration
-class ExcelRange;
-class ExcelCell;
-
-
-/*!
-* @brief Class ExcelWorksheet represents the concept "Worksheet" in Excel.
-* @note ExcelWorksheet/ExcelWorksheetImpl is an implementation of the "Handle/Body" pattern.
-*/
-class EXCEL_AUTOMATION_DLL_API ExcelWorksheet : public HandleBase
-{
-public:
-    /*!
-    * Default constructor
-    */ // Doc is needed by Doxygen
-    ExcelWorksheet(): HandleBase(0) { }
-
-    /*!
-    * @brief Get the IDispatch pointer for this worksheet object
-    * @note This pointer will go to be invalid when this ExcelWorksheet object is destroyed.
-    * @note Don't call IDispatch::Release() on this IDispatch pointer.
-    */
-    IDispatch* GetIDispatch(); 
-
-    ELstring   GetName();
-    bool       SetName(const ELstring &name);
-
-    ExcelRange GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
-    ExcelCell  GetCell(ELchar column, int row);
-
-    /*!
-    * @brief Merge the specified range into one cell or merge every row of the range into one cell.
-    * @param [in] columnFrom Left column of the range
-    * @param [in] columnTo Right column of the range
-    * @param [in] rowFrom Top row of the range
-    * @param [in] rowTo Bottom row of the range
-    * @param [in] multiRow If true, merge every row of the range into one cell;
-    *                      otherwise (false), merge the whole range into one cell.
-    * @return true if successful, otherwise false
-    */
-    bool Merge(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo, bool multiRow = false);
-
-    /*!
-    * @brief Create a copy of current worksheet
-    * @param [in] after If true, the new worksheet will be after this worksheet; 
-    *                   otherwise, the new worksheet will be before this worksheet.
-    * @return Return true if successful; otherwise, return false.
-    * @note The new worksheet will be added after the current worksheet and will be activated.
-    * @note Call ExcelWorkbook::GetActiveWorksheet() to get the new worksheet.
-    */
-    bool CopyWorksheet(bool after = true);
-
-private:
-    friend class ExcelWorkbookImpl;      // which calls the following ctor
-    friend class ExcelWorksheetSetImpl;  // which calls the following ctor
-    ExcelWorksheet(IDispatch *pWorksheet);
-
-private:
-    // <begin> Handle/Body pattern implementation
-    friend class ExcelWorksheetImpl;
-    ExcelWorksheet(ExcelWorksheetImpl *impl);
-    ExcelWorksheetImpl& Body() const;
-    // <end> Handle/Body pattern implementation
-};
-
-
-// <end> namespace
-EXCEL_AUTOMATION_NAMESPACE_END
-
-
-#endif //EXCELWORKSHEET_H_GUID_61B8B170_8EC6_4530_8CB9_E4B017D81BC0
+﻿/*!
+* @file    ExcelWorksheet.h
+* @brief   Header file for class ExcelWorksheet
+* @date    2009-12-01
+* @author  Tu Yongce <tuyongce@gmail.com>
+* @version $Id$
+*/
+
+
+#ifndef EXCELWORKSHEET_H_GUID_61B8B170_8EC6_4530_8CB9_E4B017D81BC0
+#define EXCELWORKSHEET_H_GUID_61B8B170_8EC6_4530_8CB9_E4B017D81BC0
+
+
+#include <vector>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declaration
+class ExcelRange;
+class ExcelCell;
+class ExcelRowQuery;
+class ExcelWorksheetImpl;
+struct ExcelFontSpec;
+
+
+/*!
+* @brief Address of a range of a worksheet, see ExcelWorksheet::ApplyFontSpec()
+* @details Columns are numbers, 1 for column A, so that a range can be after column Z.
+*/
+struct ExcelRangeAddress
+{
+    ExcelRangeAddress(ELchar colFrom, ELchar colTo, int rFrom, int rTo):
+        columnFrom(ColumnNumber(colFrom)), columnTo(ColumnNumber(colTo)), rowFrom(rFrom), rowTo(rTo)
+    {
+    }
+
+    /*!
+    * @brief Make the address of a range given by column numbers, 1 for column A.
+    */
+    static ExcelRangeAddress FromColumnNumbers(int colFrom, int colTo, int rFrom, int rTo)
+    {
+        ExcelRangeAddress address(ELtext('A'), ELtext('A'), rFrom, rTo);
+        address.columnFrom = colFrom;
+        address.columnTo = colTo;
+        return address;
+    }
+
+    // 'A' or 'a' => 1, ..., 'Z' or 'z' => 26
+    static int ColumnNumber(ELchar column)
+    {
+        if (column >= ELtext('a') && column <= ELtext('z'))
+            return column - ELtext('a') + 1;
+        return column - ELtext('A') + 1;
+    }
+
+    int columnFrom;     //!< Left column of the range, 1 for column A
+    int columnTo;       //!< Right column of the range
+    int rowFrom;        //!< Top row of the range
+    int rowTo;          //!< Bottom row of the range
+};
+
+
+/*!
+* @brief Class ExcelWorksheet represents the concept "Worksheet" in Excel.
+* @note ExcelWorksheet/ExcelWorksheetImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelWorksheet : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelWorksheet(): HandleBase(0) { }
+
+    /*!
+    * @brief Get the IDispatch pointer for this worksheet object
+    * @note This pointer will go to be invalid when this ExcelWorksheet object is destroyed.
+    * @note Don't call IDispatch::Release() on this IDispatch pointer.
+    */
+    IDispatch* GetIDispatch(); 
+
+    ELstring   GetName();
+    bool       SetName(const ELstring &name);
+
+    ExcelRange GetRange(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
+    ExcelCell  GetCell(ELchar column, int row);
+
+    /*!
+    * @brief Merge the specified range into one cell or merge every row of the range into one cell.
+    * @param [in] columnFrom Left column of the range
+    * @param [in] columnTo Right column of the range
+    * @param [in] rowFrom Top row of the range
+    * @param [in] rowTo Bottom row of the range
+    * @param [in] multiRow If true, merge every row of the range into one cell;
+    *                      otherwise (false), merge the whole range into one cell.
+    * @return true if successful, otherwise false
+    */
+    bool Merge(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo, bool multiRow = false);
+
+    /*!
+    * @brief Create a copy of current worksheet
+    * @param [in] after If true, the new worksheet will be after this worksheet; 
+    *                   otherwise, the new worksheet will be before this worksheet.
+    * @return Return true if successful; otherwise, return false.
+    * @note The new worksheet will be added after the current worksheet and will be activated.
+    * @note Call ExcelWorkbook::GetActiveWorksheet() to get the new worksheet.
+    */
+    bool CopyWorksheet(bool after = true);
+
+    /*!
+    * @brief Give many ranges the same font.
+    * @param [in] ranges The ranges, which may be apart from each other.
+    * @param [in] spec The properties to write, see ExcelFontSpec.
+    * @return true if successful, otherwise false
+    * @note The ranges are joined into union ranges ("A1:B2,D5:E9"), and the font of every union range is
+    *       written at once, so that the number of calls into Excel does not grow with the number of ranges.
+    *       An address is at most 255 characters long, so a union range holds about 30 ranges.
+    */
+    bool ApplyFontSpec(const std::vector<ExcelRangeAddress> &ranges, const ExcelFontSpec &spec);
+
+    /*!
+    * @brief Read some columns of the rows which meet a condition.
+    * @param [in] query The columns, the rows and the condition, see ExcelRowQuery.
+    * @param [out] values Values of the rows, each has the selected columns in the order of the query, 
+    *                     formatted as ExcelRange::ReadData() does. Rows whose selected values are all empty
+    *                     are left out.
+    * @param [out] rowNumbers If not NULL, the number of each row in @e values.
+    * @return true if successful, otherwise false
+    * @note For a workbook opened by ExcelFileReader, the query is applied while the worksheet is read: the
+    *       cells of the other columns and rows are skipped before they are decoded, the cells of a row which
+    *       does not meet the condition are dropped when the row ends, and the reading stops after the last
+    *       row of the query. The result is not kept, so a worksheet which is not read yet is read again by
+    *       the next query; a worksheet already read (by ranges or cells) is filtered in memory. @n
+    *       For a workbook in Excel, the last row of the query must be given (ExcelRowQuery::SetRows()), as the
+    *       last row with data is not looked for; the query fails otherwise. The columns from the first to the
+    *       last selected one, which may be after Z, are read 4096 rows at a time and filtered then.
+    */
+    bool ReadRows(const ExcelRowQuery &query, std::vector<std::vector<ELstring> > &values, 
+        std::vector<int> *rowNumbers = NULL);
+
+private:
+    friend class ComWorkbookImpl;        // which calls the following ctor
+    friend class ComWorksheetSetImpl;    // which calls the following ctor
+    ExcelWorksheet(IDispatch *pWorksheet);
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelWorksheetImpl;
+    ExcelWorksheet(ExcelWorksheetImpl *impl);
+    ExcelWorksheetImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELWORKSHEET_H_GUID_61B8B170_8EC6_4530_8CB9_E4B017D81BC0
@@ -0,0 +1,144 @@
+﻿/*!
+* @file    ExcelWorksheetCache.h
+* @brief   Header file for class ExcelWorksheetCache
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELWORKSHEETCACHE_H_GUID_3A9D62F0_B81E_4C57_A4D3_7E05C1B96F28
+#define EXCELWORKSHEETCACHE_H_GUID_3A9D62F0_B81E_4C57_A4D3_7E05C1B96F28
+
+
+#include <cstddef>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheet.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declarations
+class ExcelValue;
+class ExcelWorksheetCacheImpl;
+
+
+/*!
+* @brief Statistics of an ExcelWorksheetCache
+*/
+struct EXCEL_AUTOMATION_DLL_API ExcelWorksheetCacheStats
+{
+    ExcelWorksheetCacheStats();
+
+    unsigned long loads;                //!< Number of regions read in bulk, each by one Range.Value get
+    unsigned long hits;                 //!< Number of GetValue() served from memory: the reads avoided
+    unsigned long misses;               //!< Number of GetValue() which read a cell from the worksheet
+    unsigned long writes;               //!< Number of SetValue()
+    unsigned long flushes;              //!< Number of flushes which had dirty cells
+    unsigned long flushedCells;         //!< Number of dirty cells written by all the flushes
+    unsigned long flushRoundTrips;      //!< Number of Range.Value puts made by all the flushes
+    unsigned long lastFlushCells;       //!< Number of dirty cells written by the last flush
+    unsigned long lastFlushRoundTrips;  //!< Number of Range.Value puts made by the last flush
+};
+
+
+/*!
+* @brief Class ExcelWorksheetCache keeps the values of a worksheet in memory, so that reading and writing
+*        the same cells again and again does not call into Excel every time.
+* @details Load() reads a region by one Range.Value get, and GetValue() of its cells is then served from
+*          memory; a cell out of the loaded regions is read from the worksheet once, then kept. SetValue()
+*          updates the value in memory and marks the cell dirty. Flush() covers the dirty cells with dense
+*          rectangles and writes every rectangle by one Range.Value put, just like ExcelWriteBatch. @n
+*          The cache is flushed by Flush(), by Save(), and when the last handle of the cache is destroyed.
+* @note Invalidation: the cache does not see any other change of the worksheet, such as a write through
+*       ExcelRange, ExcelCell or ExcelWriteBatch, or the recalculation of a formula after a flush. Call
+*       Invalidate() for the cells which may have changed; their next GetValue() reads them again. A dirty
+*       cell is never invalidated, its value is written by the next flush; Discard() drops it instead.
+* @note ExcelWorksheetCache/ExcelWorksheetCacheImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelWorksheetCache : public HandleBase
+{
+public:
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelWorksheetCache(): HandleBase(0) { }
+
+    /*!
+    * @brief Create an empty cache attached to a worksheet.
+    * @param [in] worksheet The worksheet. Must not be null.
+    */
+    explicit ExcelWorksheetCache(ExcelWorksheet worksheet);
+
+    /*!
+    * @brief Read a region of the worksheet in bulk.
+    * @return true if successful, otherwise false
+    * @note The values of the region replace the ones in memory, except for the dirty cells.
+    */
+    bool Load(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
+
+    /*!
+    * @brief Get the value of a cell, from memory if it is there.
+    * @return true if successful, otherwise false
+    */
+    bool GetValue(ELchar column, int row, ExcelValue &value);
+
+    /*!
+    * @brief Set the value of a cell in memory; it is written to the worksheet by the next flush.
+    */
+    void SetValue(ELchar column, int row, const ExcelValue &value);
+
+    /*!
+    * @brief Number of cells set but not written yet
+    */
+    size_t CountDirty() const;
+
+    /*!
+    * @brief Write the dirty cells into the worksheet.
+    * @return true if successful, otherwise false. The cells of a rectangle which cannot be written stay
+    *         dirty, so that Flush() can be called again.
+    */
+    bool Flush();
+
+    /*!
+    * @brief Flush the cache, then save the workbook of the worksheet.
+    * @return true if both are successful, otherwise false. The workbook is not saved if the flush fails.
+    */
+    bool Save(const ExcelWorkbook &workbook);
+
+    /*!
+    * @brief Drop all the values in memory except the dirty cells.
+    */
+    void Invalidate();
+
+    /*!
+    * @brief Drop the values of a region in memory except the dirty cells.
+    * @note A loaded region which overlaps the given region is dropped as a whole.
+    */
+    void Invalidate(ELchar columnFrom, ELchar columnTo, int rowFrom, int rowTo);
+
+    /*!
+    * @brief Drop the dirty cells without writing them.
+    */
+    void Discard();
+
+    ExcelWorksheetCacheStats GetStats() const;
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelWorksheetCacheImpl;
+    ExcelWorksheetCache(ExcelWorksheetCacheImpl *impl);
+    ExcelWorksheetCacheImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELWORKSHEETCACHE_H_GUID_3A9D62F0_B81E_4C57_A4D3_7E05C1B96F28
@@ -0,0 +1,96 @@
+﻿/*!
+* @file    ExcelWriteBatch.h
+* @brief   Header file for class ExcelWriteBatch
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef EXCELWRITEBATCH_H_GUID_65A6D9C7_22B0_49B1_A23E_DA04F39B621A
+#define EXCELWRITEBATCH_H_GUID_65A6D9C7_22B0_49B1_A23E_DA04F39B621A
+
+
+#include <cstddef>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+#include "ExcelWorksheet.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declaration
+class ExcelWriteBatchImpl;
+
+
+/*!
+* @brief Class ExcelWriteBatch collects cell writes for a worksheet and sends them to Excel in bulk.
+* @details Every ExcelCell::SetValue() is a call into Excel. ExcelWriteBatch only records the values,
+*          then covers the recorded cells with dense rectangles and writes every rectangle by one
+*          Range.Value put. A report written row by row becomes a single call. @n
+*          The batch is flushed by Commit(), when the number of pending cells reaches the threshold,
+*          and when the last handle of the batch is destroyed.
+* @note A cell written twice keeps the last value.
+* @note A worksheet of a workbook opened by ExcelFileReader is read-only: Commit() fails and drops the cells.
+* @note ExcelWriteBatch/ExcelWriteBatchImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API ExcelWriteBatch : public HandleBase
+{
+public:
+    /*!
+    * @brief Default number of pending cells which triggers a flush
+    */
+    enum { DefaultFlushThreshold = 65536 };
+
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    ExcelWriteBatch(): HandleBase(0) { }
+
+    /*!
+    * @brief Create a batch attached to a worksheet.
+    * @param [in] worksheet The worksheet which receives the values. Must not be null.
+    * @param [in] flushThreshold Number of pending cells which triggers a flush.
+    */
+    explicit ExcelWriteBatch(ExcelWorksheet worksheet, size_t flushThreshold = DefaultFlushThreshold);
+
+    /*!
+    * @brief Record the value of a cell.
+    * @return true if successful, otherwise false (only possible when the write triggers a flush which fails)
+    */
+    bool SetValue(ELchar column, int row, const ELstring &value);
+    bool SetValue(ELchar column, int row, int value);
+    bool SetValue(ELchar column, int row, double value);
+
+    /*!
+    * @brief Number of cells recorded but not written yet
+    */
+    size_t CountPending() const;
+
+    /*!
+    * @brief Write all pending cells into the worksheet.
+    * @return true if successful, otherwise false. The pending cells are dropped in both cases.
+    */
+    bool Commit();
+
+    /*!
+    * @brief Drop all pending cells without writing them.
+    */
+    void Discard();
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class ExcelWriteBatchImpl;
+    ExcelWriteBatch(ExcelWriteBatchImpl *impl);
+    ExcelWriteBatchImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //EXCELWRITEBATCH_H_GUID_65A6D9C7_22B0_49B1_A23E_DA04F39B621A
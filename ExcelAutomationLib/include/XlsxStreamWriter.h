@@ -0,0 +1,118 @@
+﻿/*!
+* @file    XlsxStreamWriter.h
+* @brief   Header file for class XlsxStreamWriter
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef XLSXSTREAMWRITER_H_GUID_407D17B6_DB63_4B03_82F1_F46040048CB0
+#define XLSXSTREAMWRITER_H_GUID_407D17B6_DB63_4B03_82F1_F46040048CB0
+
+
+#include <vector>
+#include "LibDef.h"
+#include "HandleBody.h"
+#include "StringUtil.h"
+
+
+// <begin> namespace
+EXCEL_AUTOMATION_NAMESPACE_START
+
+
+// Forward declaration
+class XlsxStreamWriterImpl;
+
+
+/*!
+* @brief Class XlsxStreamWriter writes a workbook file row by row, without starting Excel.
+* @details The rows of a worksheet are compressed into the file as soon as they are written, so only
+*          the shared strings and the styles stay in memory: exporting a million rows takes about the
+*          memory of a thousand. The price is that the rows are written in order, a worksheet is
+*          finished when the next one is added, and nothing can be read back or changed. @n
+*          The values are written as ExcelRange::WriteData() and ExcelRange::WriteTyped() would: a text
+*          which is a number (such as "12.5") becomes a number, dates get the "m/d/yyyy h:mm" format, and
+*          the other values of the typed encoding keep their types. @n
+*          The file is completed by Close(), or when the last handle of the writer is destroyed.
+* @note XlsxStreamWriter does not need COM, and it is available on Linux as ExcelFileReader is.
+* @note XlsxStreamWriter/XlsxStreamWriterImpl is an implementation of the "Handle/Body" pattern.
+*/
+class EXCEL_AUTOMATION_DLL_API XlsxStreamWriter : public HandleBase
+{
+public:
+    /*!
+    * @brief Size of a worksheet of an .xlsx file
+    */
+    enum
+    {
+        MaxRows    = 1048576,
+        MaxColumns = 16384
+    };
+
+    /*!
+    * Default constructor
+    */ // Doc is needed by Doxygen
+    XlsxStreamWriter(): HandleBase(0) { }
+
+    /*!
+    * @brief Create a workbook file, or replace an existing one.
+    * @param [in] filename Name of the file. As for ExcelWorkbook::SaveAs(), the format is chosen by
+    *        ExcelUtil::GuessFileFormatFromFilename(), and it must be the Office Open XML workbook (.xlsx) or the
+    *        Excel binary workbook (.xlsb). An .xlsb file is smaller and faster to write and to read back.
+    * @return The writer, or a null XlsxStreamWriter if the format is not supported or the file cannot be created.
+    */
+    static XlsxStreamWriter Create(const ELstring &filename);
+
+    /*!
+    * @brief Finish the current worksheet and start a new one, which receives the following rows.
+    * @param [in] name Name of the worksheet: 1 to 31 characters, none of ":\/?*[]", and unique in the workbook.
+    * @return true if successful, otherwise false
+    * @note A worksheet named "Sheet1" is added if a row is written before any worksheet is added.
+    */
+    bool AddWorksheet(const ELstring &name);
+
+    /*!
+    * @brief Append a row to the current worksheet.
+    * @param [in] values The values from column A. An empty string leaves the cell empty.
+    * @return true if successful, otherwise false
+    */
+    bool WriteRow(const std::vector<ELstring> &values);
+
+    /*!
+    * @brief Append the rows of an encoded range to the current worksheet.
+    * @param [in] data The values in the encoded string form of ExcelRange::WriteData(). Column A is the first column.
+    * @return true if successful, otherwise false (dirty data, or the rows cannot be written)
+    */
+    bool WriteData(const ELstring &data);
+
+    /*!
+    * @brief Append the rows of a range in the typed binary encoding (see ExcelTypedCodec.h).
+    * @return true if successful, otherwise false (dirty data, or the rows cannot be written)
+    */
+    bool WriteTyped(const std::vector<unsigned char> &data);
+
+    /*!
+    * @brief Number of rows written into the current worksheet
+    */
+    int CountRows() const;
+
+    /*!
+    * @brief Finish the current worksheet and complete the file.
+    * @return true if the whole file was written successfully, otherwise false. Nothing can be written after it.
+    */
+    bool Close();
+
+private:
+    // <begin> Handle/Body pattern implementation
+    friend class XlsxStreamWriterImpl;
+    XlsxStreamWriter(XlsxStreamWriterImpl *impl);
+    XlsxStreamWriterImpl& Body() const;
+    // <end> Handle/Body pattern implementation
+};
+
+
+// <end> namespace
+EXCEL_AUTOMATION_NAMESPACE_END
+
+
+#endif //XLSXSTREAMWRITER_H_GUID_407D17B6_DB63_4B03_82F1_F46040048CB0
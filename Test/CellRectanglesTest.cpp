@@ -0,0 +1,177 @@
+﻿/*!
+* @file    CellRectanglesTest.cpp
+* @brief   Test of CellRectangles, which groups the cells written by a batch or flushed by a cache into rectangles
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "CellRectangles.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    typedef std::vector<CellPos> Cells;
+    typedef std::vector<CellRect> Rects;
+
+    // The cells of a rectangle, row by row
+    void AddRect(Cells &cells, int rowFrom, int rowTo, int columnFrom, int columnTo)
+    {
+        for (int i = rowFrom; i <= rowTo; ++i)
+        {
+            for (int j = columnFrom; j <= columnTo; ++j)
+                cells.push_back(CellPos(i, j));
+        }
+    }
+
+    // Sort the cells and drop the duplicates, as CellRectangles::Build() wants them
+    void Normalize(Cells &cells)
+    {
+        std::sort(cells.begin(), cells.end());
+
+        Cells unique;
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            if (unique.empty() || unique.back() < cells[i])
+                unique.push_back(cells[i]);
+        }
+        cells.swap(unique);
+    }
+
+    // Every cell is in exactly one rectangle, and every cell of a rectangle is one of the cells
+    bool Covers(const Cells &cells, const Rects &rects)
+    {
+        std::set<CellPos> remaining(cells.begin(), cells.end());
+
+        for (size_t k = 0; k < rects.size(); ++k)
+        {
+            const CellRect &rect = rects[k];
+            if (rect.rowFrom > rect.rowTo || rect.columnFrom > rect.columnTo)
+                return false;
+
+            for (int i = rect.rowFrom; i <= rect.rowTo; ++i)
+            {
+                for (int j = rect.columnFrom; j <= rect.columnTo; ++j)
+                {
+                    if (remaining.erase(CellPos(i, j)) != 1)
+                        return false;
+                }
+            }
+        }
+
+        return remaining.empty();
+    }
+
+    bool Has(const Rects &rects, int rowFrom, int rowTo, int columnFrom, int columnTo)
+    {
+        for (size_t k = 0; k < rects.size(); ++k)
+        {
+            if (rects[k].rowFrom == rowFrom && rects[k].rowTo == rowTo &&
+                rects[k].columnFrom == columnFrom && rects[k].columnTo == columnTo)
+                return true;
+        }
+
+        return false;
+    }
+
+    Rects Build(Cells cells)
+    {
+        Normalize(cells);
+
+        Rects rects;
+        CellRectangles::Build(cells, rects);
+        TEST_CHECK(Covers(cells, rects));
+        return rects;
+    }
+
+
+    void TestShapes()
+    {
+        Cells cells;
+        TEST_CHECK(Build(cells).empty());
+
+        // a report written row by row is one rectangle
+        AddRect(cells, 2, 50, 3, 12);
+        Rects rects = Build(cells);
+        TEST_CHECK(rects.size() == 1 && Has(rects, 2, 50, 3, 12));
+
+        // two blocks side by side, in the same rows
+        cells.clear();
+        AddRect(cells, 1, 4, 1, 2);
+        AddRect(cells, 1, 4, 5, 6);
+        rects = Build(cells);
+        TEST_CHECK(rects.size() == 2 && Has(rects, 1, 4, 1, 2) && Has(rects, 1, 4, 5, 6));
+
+        // an empty row between two blocks of the same columns keeps them apart
+        cells.clear();
+        AddRect(cells, 1, 2, 1, 3);
+        AddRect(cells, 4, 5, 1, 3);
+        rects = Build(cells);
+        TEST_CHECK(rects.size() == 2 && Has(rects, 1, 2, 1, 3) && Has(rects, 4, 5, 1, 3));
+
+        // runs of other columns are not merged, even if they overlap
+        cells.clear();
+        AddRect(cells, 1, 1, 1, 3);
+        AddRect(cells, 2, 3, 2, 3);
+        AddRect(cells, 4, 4, 2, 4);
+        rects = Build(cells);
+        TEST_CHECK(rects.size() == 3 && Has(rects, 1, 1, 1, 3) && Has(rects, 2, 3, 2, 3) && Has(rects, 4, 4, 2, 4));
+
+        // a block which stops while its neighbour goes on
+        cells.clear();
+        AddRect(cells, 1, 2, 1, 1);
+        AddRect(cells, 1, 5, 3, 4);
+        rects = Build(cells);
+        TEST_CHECK(rects.size() == 2 && Has(rects, 1, 2, 1, 1) && Has(rects, 1, 5, 3, 4));
+
+        // single cells
+        cells.clear();
+        cells.push_back(CellPos(1, 1));
+        cells.push_back(CellPos(2, 2));
+        cells.push_back(CellPos(3, 1));
+        rects = Build(cells);
+        TEST_CHECK(rects.size() == 3);
+    }
+
+
+    // Random sets of cells, from sparse to dense, are always covered exactly
+    void TestRandom()
+    {
+        unsigned long seed = 12345;
+        for (int round = 0; round < 200; ++round)
+        {
+            int density = 10 + round % 90;      // percent of the cells of a 20 x 20 area
+
+            Cells cells;
+            for (int i = 1; i <= 20; ++i)
+            {
+                for (int j = 1; j <= 20; ++j)
+                {
+                    seed = seed * 1103515245UL + 12345UL;
+                    if (static_cast<int>((seed >> 16) % 100) < density)
+                        cells.push_back(CellPos(i, j));
+                }
+            }
+
+            Rects rects = Build(cells);
+            TEST_CHECK(rects.size() <= cells.size());
+        }
+    }
+}
+
+
+int main()
+{
+    TestShapes();
+    TestRandom();
+
+    return TestResult("CellRectanglesTest");
+}
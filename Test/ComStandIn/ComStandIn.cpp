@@ -0,0 +1,854 @@
+﻿/*!
+* @file    ComStandIn.cpp
+* @brief   Implementation file of the Linux COM stand-in used by the tests
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <windows.h>
+#include <tchar.h>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+#include "ComStandIn.h"
+
+
+const IID IID_NULL     = { 0x00000000, 0x0000, 0x0000, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } };
+const IID IID_IUnknown = { 0x00000000, 0x0000, 0x0000, { 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46 } };
+const IID IID_IDispatch = { 0x00020400, 0x0000, 0x0000, { 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46 } };
+
+
+namespace
+{
+    IDispatch *s_pInstance = NULL;
+    LONG       s_strings = 0;
+
+    // The features of a SAFEARRAY which tell how its elements are owned
+    const USHORT FADF_BSTR     = 0x100;
+    const USHORT FADF_UNKNOWN  = 0x200;
+    const USHORT FADF_DISPATCH = 0x400;
+    const USHORT FADF_VARIANT  = 0x800;
+
+    // Size of an element of a SAFEARRAY, or 0 if the type is not supported
+    ULONG ElementSize(VARTYPE vt)
+    {
+        switch (vt)
+        {
+        case VT_I1: case VT_UI1:
+            return 1;
+        case VT_I2: case VT_UI2: case VT_BOOL:
+            return 2;
+        case VT_I4: case VT_UI4: case VT_INT: case VT_UINT: case VT_R4: case VT_ERROR:
+            return 4;
+        case VT_R8: case VT_DATE: case VT_I8: case VT_UI8: case VT_CY:
+            return 8;
+        case VT_BSTR: case VT_DISPATCH: case VT_UNKNOWN:
+            return sizeof(void*);
+        case VT_VARIANT:
+            return sizeof(VARIANT);
+        default:
+            return 0;
+        }
+    }
+
+    // Number of elements of a SAFEARRAY
+    ULONG CountElements(const SAFEARRAY *psa)
+    {
+        ULONG count = 1;
+        for (USHORT i = 0; i < psa->cDims; ++i)
+            count *= psa->rgsabound[i].cElements;
+        return count;
+    }
+
+    // Pointer to the element at the indices (the first dimension first), or NULL if one is out of bounds
+    void* ElementAt(SAFEARRAY *psa, const LONG *rgIndices)
+    {
+        // the bounds are stored the last dimension first, and the first dimension varies fastest in memory
+        ULONG offset = 0;
+        ULONG stride = 1;
+        for (USHORT dim = 0; dim < psa->cDims; ++dim)
+        {
+            const SAFEARRAYBOUND &bound = psa->rgsabound[psa->cDims - 1 - dim];
+            LONG index = rgIndices[dim] - bound.lLbound;
+            if (index < 0 || static_cast<ULONG>(index) >= bound.cElements)
+                return NULL;
+
+            offset += static_cast<ULONG>(index) * stride;
+            stride *= bound.cElements;
+        }
+
+        return static_cast<char*>(psa->pvData) + offset * psa->cbElements;
+    }
+
+    // Release what an element of a SAFEARRAY owns
+    void ClearElement(const SAFEARRAY *psa, void *pElement)
+    {
+        if (psa->fFeatures & FADF_VARIANT)
+        {
+            ::VariantClear(static_cast<VARIANT*>(pElement));
+        }
+        else if (psa->fFeatures & FADF_BSTR)
+        {
+            ::SysFreeString(*static_cast<BSTR*>(pElement));
+            *static_cast<BSTR*>(pElement) = NULL;
+        }
+        else if (psa->fFeatures & (FADF_DISPATCH | FADF_UNKNOWN))
+        {
+            IUnknown *&pUnknown = *static_cast<IUnknown**>(pElement);
+            if (pUnknown)
+                pUnknown->Release();
+            pUnknown = NULL;
+        }
+    }
+
+    // Copy an element into uninitialized memory, taking a reference to what it owns
+    HRESULT CopyElement(const SAFEARRAY *psa, void *pDest, const void *pSource)
+    {
+        if (psa->fFeatures & FADF_VARIANT)
+        {
+            ::VariantInit(static_cast<VARIANT*>(pDest));
+            return ::VariantCopy(static_cast<VARIANT*>(pDest), static_cast<const VARIANT*>(pSource));
+        }
+
+        if (psa->fFeatures & FADF_BSTR)
+        {
+            BSTR source = *static_cast<const BSTR*>(pSource);
+            BSTR copy = source ? ::SysAllocStringLen(source, ::SysStringLen(source)) : NULL;
+            if (source && !copy)
+                return E_OUTOFMEMORY;
+            *static_cast<BSTR*>(pDest) = copy;
+            return S_OK;
+        }
+
+        if (psa->fFeatures & (FADF_DISPATCH | FADF_UNKNOWN))
+        {
+            IUnknown *pUnknown = *static_cast<IUnknown* const*>(pSource);
+            if (pUnknown)
+                pUnknown->AddRef();
+        }
+
+        std::memcpy(pDest, pSource, psa->cbElements);
+        return S_OK;
+    }
+
+    SAFEARRAY* CopyArray(const SAFEARRAY *psa)
+    {
+        size_t header = sizeof(SAFEARRAY) + (psa->cDims - 1) * sizeof(SAFEARRAYBOUND);
+        SAFEARRAY *pCopy = static_cast<SAFEARRAY*>(std::malloc(header));
+        if (!pCopy)
+            return NULL;
+
+        std::memcpy(pCopy, psa, header);
+        pCopy->cLocks = 0;
+
+        ULONG count = CountElements(psa);
+        pCopy->pvData = std::calloc(count ? count : 1, psa->cbElements);
+        if (!pCopy->pvData)
+        {
+            std::free(pCopy);
+            return NULL;
+        }
+
+        for (ULONG i = 0; i < count; ++i)
+        {
+            const char *pSource = static_cast<const char*>(psa->pvData) + i * psa->cbElements;
+            CopyElement(psa, static_cast<char*>(pCopy->pvData) + i * psa->cbElements, pSource);
+        }
+
+        return pCopy;
+    }
+
+    // Read a numeric variant as a double; false if it is not a number
+    bool GetNumber(const VARIANT &value, double &number)
+    {
+        switch (value.vt)
+        {
+        case VT_EMPTY: number = 0; return true;
+        case VT_I1:    number = value.cVal; return true;
+        case VT_UI1:   number = value.bVal; return true;
+        case VT_I2:    number = value.iVal; return true;
+        case VT_UI2:   number = value.uiVal; return true;
+        case VT_I4:    number = value.lVal; return true;
+        case VT_UI4:   number = value.ulVal; return true;
+        case VT_INT:   number = value.intVal; return true;
+        case VT_UINT:  number = value.uintVal; return true;
+        case VT_I8:    number = static_cast<double>(value.llVal); return true;
+        case VT_UI8:   number = static_cast<double>(value.ullVal); return true;
+        case VT_R4:    number = value.fltVal; return true;
+        case VT_R8:    number = value.dblVal; return true;
+        case VT_DATE:  number = value.date; return true;
+        case VT_CY:    number = value.cyVal.int64 / 10000.0; return true;
+        case VT_BOOL:  number = value.boolVal ? -1 : 0; return true;
+        default:       return false;
+        }
+    }
+
+    // Convert a variant to a string as ::VariantChangeType() does with no flags
+    HRESULT ToString(const VARIANT &value, std::wstring &text)
+    {
+        wchar_t buffer[64];
+
+        switch (value.vt)
+        {
+        case VT_BSTR:
+            text.assign(value.bstrVal ? value.bstrVal : L"", ::SysStringLen(value.bstrVal));
+            return S_OK;
+
+        case VT_EMPTY:
+            text.clear();
+            return S_OK;
+
+        case VT_BOOL:
+            text = value.boolVal ? L"-1" : L"0";
+            return S_OK;
+
+        case VT_I8:
+            std::swprintf(buffer, 64, L"%lld", value.llVal);
+            text = buffer;
+            return S_OK;
+
+        case VT_UI8:
+            std::swprintf(buffer, 64, L"%llu", value.ullVal);
+            text = buffer;
+            return S_OK;
+
+        default:
+            {
+                double number = 0;
+                if (!GetNumber(value, number))
+                    return DISP_E_TYPEMISMATCH;
+
+                std::swprintf(buffer, 64, L"%.15G", number);
+                text = buffer;
+                return S_OK;
+            }
+        }
+    }
+
+    // Convert a variant to a number; a string must hold nothing but the number
+    HRESULT ToNumber(const VARIANT &value, double &number)
+    {
+        if (value.vt != VT_BSTR)
+            return GetNumber(value, number) ? S_OK : DISP_E_TYPEMISMATCH;
+
+        const wchar_t *text = value.bstrVal ? value.bstrVal : L"";
+        wchar_t *end = NULL;
+        number = std::wcstod(text, &end);
+        while (end && *end == L' ')
+            ++end;
+
+        return (end == text || *end != L'\0') ? DISP_E_TYPEMISMATCH : S_OK;
+    }
+
+    // Store a number as an integer type, rounding to the nearest
+    template <typename T>
+    HRESULT ToInteger(double number, double low, double high, T &result)
+    {
+        number = std::floor(number + 0.5);
+        if (number < low || number > high)
+            return DISP_E_OVERFLOW;
+        result = static_cast<T>(number);
+        return S_OK;
+    }
+}
+
+
+namespace ComStandIn
+{
+    void SetInstance(IDispatch *pObject)
+    {
+        s_pInstance = pObject;
+    }
+
+    long CountStrings()
+    {
+        return ::InterlockedCompareExchange(&s_strings, 0, 0);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Strings, variants and safe arrays
+
+// A BSTR points after a 4-byte prefix which holds its length in bytes, as on Windows
+BSTR SysAllocStringLen(const OLECHAR *strIn, UINT ui)
+{
+    char *pBlock = static_cast<char*>(std::malloc(sizeof(UINT) + (ui + 1) * sizeof(OLECHAR)));
+    if (!pBlock)
+        return NULL;
+
+    *reinterpret_cast<UINT*>(pBlock) = ui * sizeof(OLECHAR);
+    BSTR str = reinterpret_cast<BSTR>(pBlock + sizeof(UINT));
+    if (strIn)
+        std::wmemcpy(str, strIn, ui);
+    str[ui] = L'\0';
+
+    ::InterlockedIncrement(&s_strings);
+    return str;
+}
+
+
+BSTR SysAllocString(const OLECHAR *psz)
+{
+    return psz ? ::SysAllocStringLen(psz, static_cast<UINT>(std::wcslen(psz))) : NULL;
+}
+
+
+void SysFreeString(BSTR bstrString)
+{
+    if (!bstrString)
+        return;
+
+    ::InterlockedDecrement(&s_strings);
+    std::free(reinterpret_cast<char*>(bstrString) - sizeof(UINT));
+}
+
+
+UINT SysStringLen(BSTR pbstr)
+{
+    if (!pbstr)
+        return 0;
+    return *reinterpret_cast<UINT*>(reinterpret_cast<char*>(pbstr) - sizeof(UINT)) / sizeof(OLECHAR);
+}
+
+
+void VariantInit(VARIANT *pvarg)
+{
+    std::memset(pvarg, 0, sizeof(VARIANT));
+    pvarg->vt = VT_EMPTY;
+}
+
+
+HRESULT VariantClear(VARIANT *pvarg)
+{
+    if (!(pvarg->vt & VT_BYREF))
+    {
+        if (pvarg->vt & VT_ARRAY)
+        {
+            if (pvarg->parray)
+                ::SafeArrayDestroy(pvarg->parray);
+        }
+        else if (pvarg->vt == VT_BSTR)
+        {
+            ::SysFreeString(pvarg->bstrVal);
+        }
+        else if ((pvarg->vt == VT_DISPATCH || pvarg->vt == VT_UNKNOWN) && pvarg->punkVal)
+        {
+            pvarg->punkVal->Release();
+        }
+    }
+
+    ::VariantInit(pvarg);
+    return S_OK;
+}
+
+
+HRESULT VariantCopy(VARIANT *pvargDest, const VARIANT *pvargSrc)
+{
+    if (pvargDest == pvargSrc)
+        return S_OK;
+
+    VARIANT copy = *pvargSrc;
+
+    if (!(copy.vt & VT_BYREF))
+    {
+        if (copy.vt & VT_ARRAY)
+        {
+            copy.parray = copy.parray ? CopyArray(copy.parray) : NULL;
+            if (pvargSrc->parray && !copy.parray)
+                return E_OUTOFMEMORY;
+        }
+        else if (copy.vt == VT_BSTR && copy.bstrVal)
+        {
+            copy.bstrVal = ::SysAllocStringLen(copy.bstrVal, ::SysStringLen(copy.bstrVal));
+            if (!copy.bstrVal)
+                return E_OUTOFMEMORY;
+        }
+        else if ((copy.vt == VT_DISPATCH || copy.vt == VT_UNKNOWN) && copy.punkVal)
+        {
+            copy.punkVal->AddRef();
+        }
+    }
+
+    ::VariantClear(pvargDest);
+    *pvargDest = copy;
+    return S_OK;
+}
+
+
+HRESULT VariantChangeType(VARIANT *pvargDest, const VARIANT *pvarSrc, USHORT /*wFlags*/, VARTYPE vt)
+{
+    if (pvarSrc->vt == vt || vt == VT_VARIANT)
+        return ::VariantCopy(pvargDest, pvarSrc);
+
+    VARIANT result;
+    ::VariantInit(&result);
+    result.vt = vt;
+
+    HRESULT hr = S_OK;
+    double number = 0;
+
+    if (pvarSrc->vt == VT_NULL || pvarSrc->vt == VT_ERROR || (pvarSrc->vt & (VT_ARRAY | VT_BYREF)))
+        return DISP_E_TYPEMISMATCH;
+
+    switch (vt)
+    {
+    case VT_BSTR:
+        {
+            std::wstring text;
+            hr = ToString(*pvarSrc, text);
+            if (SUCCEEDED(hr))
+            {
+                result.bstrVal = ::SysAllocStringLen(text.c_str(), static_cast<UINT>(text.length()));
+                if (!result.bstrVal)
+                    hr = E_OUTOFMEMORY;
+            }
+        }
+        break;
+
+    case VT_BOOL:
+        hr = ToNumber(*pvarSrc, number);
+        result.boolVal = number != 0 ? VARIANT_TRUE : VARIANT_FALSE;
+        break;
+
+    case VT_R8:
+    case VT_DATE:
+        hr = ToNumber(*pvarSrc, number);
+        result.dblVal = number;
+        break;
+
+    case VT_R4:
+        hr = ToNumber(*pvarSrc, number);
+        result.fltVal = static_cast<float>(number);
+        break;
+
+    case VT_I2:
+        hr = ToNumber(*pvarSrc, number);
+        if (SUCCEEDED(hr))
+            hr = ToInteger(number, -32768.0, 32767.0, result.iVal);
+        break;
+
+    case VT_I4:
+    case VT_INT:
+        hr = ToNumber(*pvarSrc, number);
+        if (SUCCEEDED(hr) && vt == VT_I4)
+            hr = ToInteger(number, -2147483648.0, 2147483647.0, result.lVal);
+        else if (SUCCEEDED(hr))
+            hr = ToInteger(number, -2147483648.0, 2147483647.0, result.intVal);
+        break;
+
+    case VT_UI4:
+        hr = ToNumber(*pvarSrc, number);
+        if (SUCCEEDED(hr))
+            hr = ToInteger(number, 0.0, 4294967295.0, result.ulVal);
+        break;
+
+    case VT_I8:
+        hr = ToNumber(*pvarSrc, number);
+        if (SUCCEEDED(hr))
+            hr = ToInteger(number, -9223372036854775808.0, 9223372036854774784.0, result.llVal);
+        break;
+
+    default:
+        hr = DISP_E_TYPEMISMATCH;
+        break;
+    }
+
+    if (FAILED(hr))
+    {
+        ::VariantClear(&result);
+        return hr;
+    }
+
+    ::VariantClear(pvargDest);
+    *pvargDest = result;
+    return S_OK;
+}
+
+
+SAFEARRAY* SafeArrayCreate(VARTYPE vt, UINT cDims, SAFEARRAYBOUND *rgsabound)
+{
+    ULONG size = ElementSize(vt);
+    if (cDims == 0 || size == 0)
+        return NULL;
+
+    SAFEARRAY *psa = static_cast<SAFEARRAY*>(std::malloc(sizeof(SAFEARRAY) + (cDims - 1) * sizeof(SAFEARRAYBOUND)));
+    if (!psa)
+        return NULL;
+
+    psa->cDims = static_cast<USHORT>(cDims);
+    psa->cbElements = size;
+    psa->cLocks = 0;
+    psa->fFeatures = (vt == VT_VARIANT) ? FADF_VARIANT : (vt == VT_BSTR) ? FADF_BSTR :
+        (vt == VT_DISPATCH) ? FADF_DISPATCH : (vt == VT_UNKNOWN) ? FADF_UNKNOWN : 0;
+
+    // rgsabound is given the first dimension first, and stored the other way round as Windows does
+    for (UINT i = 0; i < cDims; ++i)
+        psa->rgsabound[cDims - 1 - i] = rgsabound[i];
+
+    ULONG count = CountElements(psa);
+    psa->pvData = std::calloc(count ? count : 1, size);
+    if (!psa->pvData)
+    {
+        std::free(psa);
+        return NULL;
+    }
+
+    // all zero bits is VT_EMPTY, a NULL BSTR or a NULL pointer
+    return psa;
+}
+
+
+HRESULT SafeArrayDestroy(SAFEARRAY *psa)
+{
+    if (!psa)
+        return S_OK;
+    if (psa->cLocks)
+        return DISP_E_ARRAYISLOCKED;
+
+    ULONG count = CountElements(psa);
+    for (ULONG i = 0; i < count; ++i)
+        ClearElement(psa, static_cast<char*>(psa->pvData) + i * psa->cbElements);
+
+    std::free(psa->pvData);
+    std::free(psa);
+    return S_OK;
+}
+
+
+UINT SafeArrayGetDim(SAFEARRAY *psa)
+{
+    return psa ? psa->cDims : 0;
+}
+
+
+HRESULT SafeArrayGetLBound(SAFEARRAY *psa, UINT nDim, LONG *plLbound)
+{
+    if (!psa || !plLbound)
+        return E_INVALIDARG;
+    if (nDim == 0 || nDim > psa->cDims)
+        return DISP_E_BADINDEX;
+
+    *plLbound = psa->rgsabound[psa->cDims - nDim].lLbound;
+    return S_OK;
+}
+
+
+HRESULT SafeArrayGetUBound(SAFEARRAY *psa, UINT nDim, LONG *plUbound)
+{
+    if (!psa || !plUbound)
+        return E_INVALIDARG;
+    if (nDim == 0 || nDim > psa->cDims)
+        return DISP_E_BADINDEX;
+
+    const SAFEARRAYBOUND &bound = psa->rgsabound[psa->cDims - nDim];
+    *plUbound = bound.lLbound + static_cast<LONG>(bound.cElements) - 1;
+    return S_OK;
+}
+
+
+HRESULT SafeArrayGetElement(SAFEARRAY *psa, LONG *rgIndices, void *pv)
+{
+    if (!psa || !rgIndices || !pv)
+        return E_INVALIDARG;
+
+    void *pElement = ElementAt(psa, rgIndices);
+    if (!pElement)
+        return DISP_E_BADINDEX;
+
+    return CopyElement(psa, pv, pElement);
+}
+
+
+HRESULT SafeArrayPutElement(SAFEARRAY *psa, LONG *rgIndices, void *pv)
+{
+    if (!psa || !rgIndices)
+        return E_INVALIDARG;
+    if (psa->cLocks)
+        return DISP_E_ARRAYISLOCKED;
+
+    void *pElement = ElementAt(psa, rgIndices);
+    if (!pElement)
+        return DISP_E_BADINDEX;
+
+    // a BSTR or an interface is passed by itself, not by a pointer to it
+    const void *pSource = (psa->fFeatures & (FADF_BSTR | FADF_DISPATCH | FADF_UNKNOWN)) ? &pv : pv;
+
+    ClearElement(psa, pElement);
+    return CopyElement(psa, pElement, pSource);
+}
+
+
+HRESULT SafeArrayAccessData(SAFEARRAY *psa, void **ppvData)
+{
+    if (!psa || !ppvData)
+        return E_INVALIDARG;
+
+    ++psa->cLocks;
+    *ppvData = psa->pvData;
+    return S_OK;
+}
+
+
+HRESULT SafeArrayUnaccessData(SAFEARRAY *psa)
+{
+    if (!psa)
+        return E_INVALIDARG;
+    if (psa->cLocks == 0)
+        return E_UNEXPECTED;
+
+    --psa->cLocks;
+    return S_OK;
+}
+
+
+/*
+* The method is called as a function of the platform's C calling convention, which passes the instance and the
+* integer arguments in the integer registers and the floating-point ones in their own registers (x86-64 and
+* AArch64 both do): every method is called with the same prototype of 5 integers and 8 doubles after the
+* instance, and the callee takes from those registers just the arguments it declares. A VARIANT argument is
+* passed as a pointer to it, as the 64-bit Windows convention does, so the test objects declare it as a pointer.
+*/
+HRESULT DispCallFunc(void *pvInstance, ULONG_PTR oVft, CALLCONV /*cc*/, VARTYPE vtReturn, UINT cActuals,
+    VARTYPE *prgvt, VARIANTARG **prgpvarg, VARIANT *pvargResult)
+{
+#if defined(__x86_64__) || defined(__aarch64__)
+    if (!pvInstance || vtReturn != VT_HRESULT || !pvargResult)
+        return E_NOTIMPL;
+
+    const UINT MaxIntegers = 5;
+    const UINT MaxFloats = 8;
+
+    long integers[MaxIntegers] = { 0 };
+    double floats[MaxFloats] = { 0 };
+    UINT integerCount = 0;
+    UINT floatCount = 0;
+
+    for (UINT i = 0; i < cActuals; ++i)
+    {
+        const VARIANTARG &arg = *prgpvarg[i];
+        bool isFloat = (prgvt[i] == VT_R8 || prgvt[i] == VT_DATE || prgvt[i] == VT_R4);
+
+        if (isFloat ? floatCount == MaxFloats : integerCount == MaxIntegers)
+            return E_NOTIMPL;
+
+        switch (prgvt[i])
+        {
+        case VT_R8:
+        case VT_DATE:
+            floats[floatCount++] = arg.dblVal;
+            break;
+
+        case VT_R4:
+            {
+                // a float is passed in the low bits of the register
+                union { double d; float f; } bits;
+                bits.d = 0;
+                bits.f = arg.fltVal;
+                floats[floatCount++] = bits.d;
+            }
+            break;
+
+        case VT_I2:   integers[integerCount++] = arg.iVal; break;
+        case VT_BOOL: integers[integerCount++] = arg.boolVal; break;
+        case VT_I4:   integers[integerCount++] = arg.lVal; break;
+        case VT_INT:  integers[integerCount++] = arg.intVal; break;
+        case VT_UI4:  integers[integerCount++] = static_cast<long>(arg.ulVal); break;
+
+        case VT_VARIANT:
+            integers[integerCount++] = reinterpret_cast<long>(prgpvarg[i]);
+            break;
+
+        case VT_BSTR:
+        case VT_DISPATCH:
+        case VT_UNKNOWN:
+        case VT_PTR:
+            integers[integerCount++] = reinterpret_cast<long>(arg.byref);
+            break;
+
+        default:
+            return DISP_E_BADVARTYPE;
+        }
+    }
+
+    typedef HRESULT (*Method)(void*, long, long, long, long, long,
+        double, double, double, double, double, double, double, double);
+
+    void **vtable = *static_cast<void***>(pvInstance);
+    Method method = reinterpret_cast<Method>(vtable[oVft / sizeof(void*)]);
+
+    HRESULT hr = method(pvInstance, integers[0], integers[1], integers[2], integers[3], integers[4],
+        floats[0], floats[1], floats[2], floats[3], floats[4], floats[5], floats[6], floats[7]);
+
+    ::VariantInit(pvargResult);
+    pvargResult->vt = VT_ERROR;
+    pvargResult->scode = hr;
+    return S_OK;
+#else
+    (void)pvInstance; (void)oVft; (void)vtReturn; (void)cActuals; (void)prgvt; (void)prgpvarg; (void)pvargResult;
+    return E_NOTIMPL;
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COM runtime
+
+HRESULT CoInitializeEx(void * /*pvReserved*/, DWORD /*dwCoInit*/)
+{
+    return S_OK;
+}
+
+
+void CoUninitialize()
+{
+}
+
+
+HRESULT CLSIDFromProgID(LPCOLESTR /*lpszProgID*/, CLSID *lpclsid)
+{
+    *lpclsid = IID_NULL;
+    return S_OK;
+}
+
+
+HRESULT CoCreateInstance(REFCLSID /*rclsid*/, IUnknown * /*pUnkOuter*/, DWORD /*dwClsContext*/, REFIID riid,
+    LPVOID *ppv)
+{
+    *ppv = NULL;
+    if (!s_pInstance)
+        return static_cast<HRESULT>(0x80040154);   // REGDB_E_CLASSNOTREG
+
+    return s_pInstance->QueryInterface(riid, ppv);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Threads and time
+
+void InitializeCriticalSection(CRITICAL_SECTION *lpCriticalSection)
+{
+    // a critical section can be entered again by the thread which owns it
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&lpCriticalSection->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+
+void DeleteCriticalSection(CRITICAL_SECTION *lpCriticalSection)
+{
+    pthread_mutex_destroy(&lpCriticalSection->mutex);
+}
+
+
+void EnterCriticalSection(CRITICAL_SECTION *lpCriticalSection)
+{
+    pthread_mutex_lock(&lpCriticalSection->mutex);
+}
+
+
+void LeaveCriticalSection(CRITICAL_SECTION *lpCriticalSection)
+{
+    pthread_mutex_unlock(&lpCriticalSection->mutex);
+}
+
+
+LONG InterlockedIncrement(LONG volatile *Addend)
+{
+    return __sync_add_and_fetch(Addend, 1);
+}
+
+
+LONG InterlockedDecrement(LONG volatile *Addend)
+{
+    return __sync_sub_and_fetch(Addend, 1);
+}
+
+
+LONG InterlockedExchange(LONG volatile *Target, LONG Value)
+{
+    return __sync_lock_test_and_set(Target, Value);
+}
+
+
+LONG InterlockedCompareExchange(LONG volatile *Destination, LONG Exchange, LONG Comparand)
+{
+    return __sync_val_compare_and_swap(Destination, Comparand, Exchange);
+}
+
+
+LONG InterlockedExchangeAdd(LONG volatile *Addend, LONG Value)
+{
+    return __sync_fetch_and_add(Addend, Value);
+}
+
+
+void* InterlockedExchangePointer(void * volatile *Target, void *Value)
+{
+    __sync_synchronize();
+    return __sync_lock_test_and_set(Target, Value);
+}
+
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER *lpPerformanceCount)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    lpPerformanceCount->QuadPart = static_cast<LONGLONG>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    return TRUE;
+}
+
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER *lpFrequency)
+{
+    lpFrequency->QuadPart = 1000000000;
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Files and text
+
+DWORD GetFullPathName(LPCWSTR lpFileName, DWORD nBufferLength, LPWSTR lpBuffer, LPWSTR *lpFilePart)
+{
+    std::wstring path;
+    if (lpFileName[0] != L'/')
+    {
+        char cwd[4096];
+        if (getcwd(cwd, sizeof(cwd)))
+        {
+            for (const char *p = cwd; *p; ++p)
+                path += static_cast<wchar_t>(static_cast<unsigned char>(*p));
+            path += L'/';
+        }
+    }
+    path += lpFileName;
+
+    if (lpFilePart)
+        *lpFilePart = NULL;
+
+    // the length without the terminating null if it fits, the size of the buffer needed otherwise
+    if (path.length() >= nBufferLength)
+        return static_cast<DWORD>(path.length() + 1);
+
+    std::wmemcpy(lpBuffer, path.c_str(), path.length() + 1);
+    return static_cast<DWORD>(path.length());
+}
+
+
+int _stprintf_s(wchar_t *buffer, size_t sizeOfBuffer, const wchar_t *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = std::vswprintf(buffer, sizeOfBuffer, format, args);
+    va_end(args);
+
+    return count;
+}
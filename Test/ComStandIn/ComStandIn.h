@@ -0,0 +1,34 @@
+﻿/*!
+* @file    ComStandIn.h
+* @brief   Header file for the controls of the Linux COM stand-in used by the tests
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef COMSTANDIN_H_GUID_5F1C8D2A_93B7_4E06_A4C3_1E62D9B7F08A
+#define COMSTANDIN_H_GUID_5F1C8D2A_93B7_4E06_A4C3_1E62D9B7F08A
+
+
+#include <windows.h>
+
+
+/*!
+* @brief The functions by which a test drives the stand-in of windows.h.
+*/
+namespace ComStandIn
+{
+    /*!
+    * @brief Set the object which ::CoCreateInstance() returns (for any class), or NULL to make it fail.
+    *        The stand-in does not keep a reference; the caller keeps the object alive while it is set.
+    */
+    void SetInstance(IDispatch *pObject);
+
+    /*!
+    * @brief Return the number of BSTRs which are allocated and not freed yet.
+    */
+    long CountStrings();
+}
+
+
+#endif //COMSTANDIN_H_GUID_5F1C8D2A_93B7_4E06_A4C3_1E62D9B7F08A
@@ -0,0 +1,814 @@
+﻿/*!
+* @file    FakeExcel.cpp
+* @brief   Implementation file for the fake Excel objects which the COM tests run against
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include "FakeExcel.h"
+
+
+namespace
+{
+    long s_allGetIDsOfNames = 0;
+    long s_allInvokes = 0;
+
+    const long xlCalculationAutomatic = -4105;
+}
+
+
+namespace ComStandIn
+{
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeValue
+
+FakeValue::FakeValue()
+{
+    ::VariantInit(&m_value);
+}
+
+
+FakeValue::FakeValue(const VARIANT &value)
+{
+    ::VariantInit(&m_value);
+    ::VariantCopy(&m_value, &value);
+}
+
+
+FakeValue::FakeValue(const FakeValue &other)
+{
+    ::VariantInit(&m_value);
+    ::VariantCopy(&m_value, &other.m_value);
+}
+
+
+FakeValue& FakeValue::operator = (const FakeValue &other)
+{
+    ::VariantCopy(&m_value, &other.m_value);
+    return *this;
+}
+
+
+FakeValue::~FakeValue()
+{
+    ::VariantClear(&m_value);
+}
+
+
+std::wstring FakeValue::ToString() const
+{
+    VARIANT text;
+    ::VariantInit(&text);
+    if (FAILED(::VariantChangeType(&text, &m_value, 0, VT_BSTR)))
+        return std::wstring();
+
+    std::wstring result(text.bstrVal, ::SysStringLen(text.bstrVal));
+    ::VariantClear(&text);
+    return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeDispatch
+
+FakeDispatch::FakeDispatch(): m_references(1), m_getIDsOfNames(0), m_invokes(0)
+{
+}
+
+
+FakeDispatch::~FakeDispatch()
+{
+}
+
+
+HRESULT FakeDispatch::QueryInterface(REFIID riid, void **ppv)
+{
+    if (riid != IID_IUnknown && riid != IID_IDispatch)
+    {
+        *ppv = NULL;
+        return E_NOINTERFACE;
+    }
+
+    AddRef();
+    *ppv = static_cast<IDispatch*>(this);
+    return S_OK;
+}
+
+
+ULONG FakeDispatch::AddRef()
+{
+    return ::InterlockedIncrement(&m_references);
+}
+
+
+ULONG FakeDispatch::Release()
+{
+    LONG references = ::InterlockedDecrement(&m_references);
+    if (references == 0)
+        delete this;
+    return references;
+}
+
+
+HRESULT FakeDispatch::GetTypeInfoCount(UINT *pctinfo)
+{
+    *pctinfo = 0;
+    return S_OK;
+}
+
+
+HRESULT FakeDispatch::GetTypeInfo(UINT /*iTInfo*/, LCID /*lcid*/, ITypeInfo **ppTInfo)
+{
+    *ppTInfo = NULL;
+    return E_NOTIMPL;
+}
+
+
+HRESULT FakeDispatch::GetIDsOfNames(REFIID /*riid*/, LPOLESTR *rgszNames, UINT cNames, LCID /*lcid*/,
+    DISPID *rgDispId)
+{
+    ++m_getIDsOfNames;
+    ++s_allGetIDsOfNames;
+
+    if (cNames != 1)
+        return E_NOTIMPL;
+
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i] == rgszNames[0])
+        {
+            rgDispId[0] = static_cast<DISPID>(i + 1);
+            return S_OK;
+        }
+    }
+
+    rgDispId[0] = DISPID_UNKNOWN;
+    return DISP_E_UNKNOWNNAME;
+}
+
+
+HRESULT FakeDispatch::Invoke(DISPID dispIdMember, REFIID /*riid*/, LCID /*lcid*/, WORD wFlags,
+    DISPPARAMS *pDispParams, VARIANT *pVarResult, EXCEPINFO * /*pExcepInfo*/, UINT * /*puArgErr*/)
+{
+    ++m_invokes;
+    ++s_allInvokes;
+
+    if (dispIdMember < 1 || static_cast<size_t>(dispIdMember) > m_members.size())
+        return DISP_E_MEMBERNOTFOUND;
+    if (m_failing[dispIdMember - 1])
+        return DISP_E_EXCEPTION;
+
+    // the arguments come last first
+    FakeArgs args;
+    UINT argc = pDispParams ? pDispParams->cArgs : 0;
+    if (argc > FakeArgs::MaxArgs)
+        return DISP_E_BADPARAMCOUNT;
+    for (UINT i = argc; i > 0; --i)
+        args.Add(&pDispParams->rgvarg[i - 1]);
+
+    VARIANT result;
+    ::VariantInit(&result);
+
+    HRESULT hr = Call(m_members[dispIdMember - 1], wFlags, args, &result);
+
+    if (SUCCEEDED(hr) && pVarResult)
+        *pVarResult = result;
+    else
+        ::VariantClear(&result);
+
+    return hr;
+}
+
+
+long FakeDispatch::CountAllGetIDsOfNames()
+{
+    return s_allGetIDsOfNames;
+}
+
+
+long FakeDispatch::CountAllInvokes()
+{
+    return s_allInvokes;
+}
+
+
+void FakeDispatch::ResetAllCounters()
+{
+    s_allGetIDsOfNames = 0;
+    s_allInvokes = 0;
+}
+
+
+void FakeDispatch::SetFailing(const std::wstring &name, bool failing)
+{
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        if (m_members[i] == name)
+            m_failing[i] = failing;
+    }
+}
+
+
+void FakeDispatch::AddMember(const wchar_t *name)
+{
+    m_members.push_back(name);
+    m_failing.push_back(false);
+}
+
+
+void FakeDispatch::SetResult(VARIANT *pResult, IDispatch *pObject)
+{
+    pObject->AddRef();
+    pResult->vt = VT_DISPATCH;
+    pResult->pdispVal = pObject;
+}
+
+
+void FakeDispatch::SetResult(VARIANT *pResult, const std::wstring &value)
+{
+    pResult->vt = VT_BSTR;
+    pResult->bstrVal = ::SysAllocStringLen(value.c_str(), static_cast<UINT>(value.length()));
+}
+
+
+void FakeDispatch::SetResult(VARIANT *pResult, bool value)
+{
+    pResult->vt = VT_BOOL;
+    pResult->boolVal = value ? VARIANT_TRUE : VARIANT_FALSE;
+}
+
+
+void FakeDispatch::SetResult(VARIANT *pResult, long value)
+{
+    pResult->vt = VT_I4;
+    pResult->lVal = value;
+}
+
+
+bool FakeDispatch::GetArg(const VARIANT *pArg, long &value)
+{
+    VARIANT converted;
+    ::VariantInit(&converted);
+    if (FAILED(::VariantChangeType(&converted, pArg, 0, VT_I4)))
+        return false;
+
+    value = converted.lVal;
+    return true;
+}
+
+
+bool FakeDispatch::GetArg(const VARIANT *pArg, bool &value)
+{
+    VARIANT converted;
+    ::VariantInit(&converted);
+    if (FAILED(::VariantChangeType(&converted, pArg, 0, VT_BOOL)))
+        return false;
+
+    value = (converted.boolVal != VARIANT_FALSE);
+    return true;
+}
+
+
+bool FakeDispatch::GetArg(const VARIANT *pArg, std::wstring &value)
+{
+    if (pArg->vt != VT_BSTR)
+        return false;
+
+    value.assign(pArg->bstrVal, ::SysStringLen(pArg->bstrVal));
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeFont
+
+FakeFont::FakeFont()
+{
+    AddMember(L"Name");
+    AddMember(L"Size");
+    AddMember(L"Bold");
+    AddMember(L"Italic");
+    AddMember(L"Underline");
+    AddMember(L"Strikethrough");
+    AddMember(L"Color");
+}
+
+
+FakeValue FakeFont::Property(const std::wstring &name) const
+{
+    std::map<std::wstring, FakeValue>::const_iterator it = m_properties.find(name);
+    return (it != m_properties.end()) ? it->second : FakeValue();
+}
+
+
+HRESULT FakeFont::Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+    VARIANT *pResult)
+{
+    if (flags & DISPATCH_PROPERTYPUT)
+    {
+        if (args.size() != 1)
+            return DISP_E_BADPARAMCOUNT;
+        m_properties[name] = FakeValue(*args[0]);
+        return S_OK;
+    }
+
+    return ::VariantCopy(pResult, &Property(name).Get());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeRange
+
+FakeRange::FakeRange(FakeWorksheet *pSheet, int rowFrom, int columnFrom, int rowTo, int columnTo)
+    : m_pSheet(pSheet), m_pFont(new FakeFont), m_rowFrom(rowFrom), m_columnFrom(columnFrom), m_rowTo(rowTo),
+      m_columnTo(columnTo)
+{
+    m_pSheet->AddRef();
+
+    AddMember(L"Value");
+    AddMember(L"Value2");
+    AddMember(L"Font");
+    AddMember(L"HorizontalAlignment");
+    AddMember(L"VerticalAlignment");
+    AddMember(L"Merge");
+    AddMember(L"Range");
+}
+
+
+FakeRange::~FakeRange()
+{
+    m_pFont->Release();
+    m_pSheet->Release();
+}
+
+
+HRESULT FakeRange::Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+    VARIANT *pResult)
+{
+    if (name == L"Value" || name == L"Value2")
+    {
+        if (flags & DISPATCH_PROPERTYPUT)
+            return args.size() == 1 ? PutValue(*args[0]) : DISP_E_BADPARAMCOUNT;
+        return GetValue(pResult);
+    }
+
+    if (name == L"Font")
+    {
+        SetResult(pResult, static_cast<IDispatch*>(m_pFont));
+        return S_OK;
+    }
+
+    if (name == L"Range")
+    {
+        // an address relative to the top left cell of this range
+        std::wstring address;
+        int rowFrom, columnFrom, rowTo, columnTo;
+        if (args.size() != 1 || !GetArg(args[0], address) ||
+            !FakeWorksheet::ParseAddress(address, rowFrom, columnFrom, rowTo, columnTo))
+        {
+            return DISP_E_TYPEMISMATCH;
+        }
+
+        FakeRange *pRange = new FakeRange(m_pSheet, m_rowFrom + rowFrom - 1, m_columnFrom + columnFrom - 1,
+            m_rowFrom + rowTo - 1, m_columnFrom + columnTo - 1);
+        SetResult(pResult, static_cast<IDispatch*>(pRange));
+        pRange->Release();
+        return S_OK;
+    }
+
+    // alignment and merging are accepted and forgotten
+    return S_OK;
+}
+
+
+HRESULT FakeRange::GetValue(VARIANT *pResult) const
+{
+    if (m_rowFrom == m_rowTo && m_columnFrom == m_columnTo)
+        return ::VariantCopy(pResult, &m_pSheet->Cell(m_rowFrom, m_columnFrom).Get());
+
+    // a 2-dimensional array based at 1, as Excel returns it
+    SAFEARRAYBOUND sab[2];
+    sab[0].lLbound = 1;
+    sab[0].cElements = m_rowTo - m_rowFrom + 1;
+    sab[1].lLbound = 1;
+    sab[1].cElements = m_columnTo - m_columnFrom + 1;
+
+    SAFEARRAY *psa = ::SafeArrayCreate(VT_VARIANT, 2, sab);
+    if (!psa)
+        return E_OUTOFMEMORY;
+
+    for (int i = m_rowFrom; i <= m_rowTo; ++i)
+    {
+        for (int j = m_columnFrom; j <= m_columnTo; ++j)
+        {
+            LONG indices[2] = { i - m_rowFrom + 1, j - m_columnFrom + 1 };
+            FakeValue value = m_pSheet->Cell(i, j);
+            ::SafeArrayPutElement(psa, indices, const_cast<VARIANT*>(&value.Get()));
+        }
+    }
+
+    pResult->vt = VT_ARRAY | VT_VARIANT;
+    pResult->parray = psa;
+    return S_OK;
+}
+
+
+HRESULT FakeRange::PutValue(const VARIANT &value)
+{
+    if (!(value.vt & VT_ARRAY))
+    {
+        // a single value fills the whole range
+        for (int i = m_rowFrom; i <= m_rowTo; ++i)
+        {
+            for (int j = m_columnFrom; j <= m_columnTo; ++j)
+                m_pSheet->SetCell(i, j, value);
+        }
+        return S_OK;
+    }
+
+    m_pSheet->AddValuePut(m_rowFrom, m_columnFrom, m_rowTo, m_columnTo);
+
+    SAFEARRAY *psa = value.parray;
+    LONG rowFrom = 0, rowTo = 0, columnFrom = 0, columnTo = 0;
+    if (::SafeArrayGetDim(psa) != 2 || FAILED(::SafeArrayGetLBound(psa, 1, &rowFrom)) ||
+        FAILED(::SafeArrayGetUBound(psa, 1, &rowTo)) || FAILED(::SafeArrayGetLBound(psa, 2, &columnFrom)) ||
+        FAILED(::SafeArrayGetUBound(psa, 2, &columnTo)))
+    {
+        return DISP_E_TYPEMISMATCH;
+    }
+
+    // cells outside the array are left alone, as Excel fills them with #N/A
+    for (LONG i = rowFrom; i <= rowTo && m_rowFrom + (i - rowFrom) <= m_rowTo; ++i)
+    {
+        for (LONG j = columnFrom; j <= columnTo && m_columnFrom + (j - columnFrom) <= m_columnTo; ++j)
+        {
+            LONG indices[2] = { i, j };
+            VARIANT element;
+            ::VariantInit(&element);
+            ::SafeArrayGetElement(psa, indices, &element);
+            m_pSheet->SetCell(m_rowFrom + (i - rowFrom), m_columnFrom + (j - columnFrom), element);
+            ::VariantClear(&element);
+        }
+    }
+
+    return S_OK;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeWorksheet
+
+FakeWorksheet::FakeWorksheet(const std::wstring &name): m_name(name), m_wrapper(NULL)
+{
+    AddMember(L"Name");
+    AddMember(L"Range");
+    AddMember(L"Copy");
+}
+
+
+FakeValue FakeWorksheet::Cell(int row, int column) const
+{
+    std::map<std::pair<int, int>, FakeValue>::const_iterator it = m_cells.find(std::make_pair(row, column));
+    return (it != m_cells.end()) ? it->second : FakeValue();
+}
+
+
+void FakeWorksheet::SetCell(int row, int column, const VARIANT &value)
+{
+    if (value.vt == VT_EMPTY)
+        m_cells.erase(std::make_pair(row, column));
+    else
+        m_cells[std::make_pair(row, column)] = FakeValue(value);
+}
+
+
+void FakeWorksheet::AddValuePut(int rowFrom, int columnFrom, int rowTo, int columnTo)
+{
+    std::wstring address;
+    int cells[2][2] = { { columnFrom, rowFrom }, { columnTo, rowTo } };
+
+    for (int k = 0; k < 2; ++k)
+    {
+        if (k == 1)
+            address += L':';
+
+        std::wstring letters;
+        for (int column = cells[k][0]; column > 0; column = (column - 1) / 26)
+            letters.insert(letters.begin(), static_cast<wchar_t>(L'A' + (column - 1) % 26));
+
+        wchar_t row[16];
+        std::swprintf(row, 16, L"%d", cells[k][1]);
+        address += letters + row;
+    }
+
+    m_valuePuts.push_back(address);
+}
+
+
+bool FakeWorksheet::ParseAddress(const std::wstring &address, int &rowFrom, int &columnFrom, int &rowTo,
+    int &columnTo)
+{
+    int *parts[2][2] = { { &columnFrom, &rowFrom }, { &columnTo, &rowTo } };
+    size_t pos = 0;
+
+    for (int k = 0; k < 2; ++k)
+    {
+        int column = 0;
+        int row = 0;
+        for (; pos < address.length() && address[pos] >= L'A' && address[pos] <= L'Z'; ++pos)
+            column = column * 26 + (address[pos] - L'A' + 1);
+        for (; pos < address.length() && address[pos] >= L'0' && address[pos] <= L'9'; ++pos)
+            row = row * 10 + (address[pos] - L'0');
+
+        if (column == 0 || row == 0)
+            return false;
+
+        *parts[k][0] = column;
+        *parts[k][1] = row;
+
+        if (k == 0)
+        {
+            if (pos == address.length())
+            {
+                columnTo = columnFrom;
+                rowTo = rowFrom;
+                return true;
+            }
+            if (address[pos++] != L':')
+                return false;
+        }
+    }
+
+    return pos == address.length() && rowFrom <= rowTo && columnFrom <= columnTo;
+}
+
+
+HRESULT FakeWorksheet::Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+    VARIANT *pResult)
+{
+    if (name == L"Name")
+    {
+        if (!(flags & DISPATCH_PROPERTYPUT))
+        {
+            SetResult(pResult, m_name);
+            return S_OK;
+        }
+        return (args.size() == 1 && GetArg(args[0], m_name)) ? S_OK : DISP_E_TYPEMISMATCH;
+    }
+
+    if (name == L"Range")
+    {
+        std::wstring address;
+        int rowFrom, columnFrom, rowTo, columnTo;
+        if (args.size() != 1 || !GetArg(args[0], address) ||
+            !ParseAddress(address, rowFrom, columnFrom, rowTo, columnTo))
+        {
+            return DISP_E_TYPEMISMATCH;
+        }
+
+        FakeRange *pRange = new FakeRange(this, rowFrom, columnFrom, rowTo, columnTo);
+        if (m_wrapper)
+        {
+            IDispatch *pWrapper = m_wrapper(pRange);
+            SetResult(pResult, pWrapper);
+            pWrapper->Release();
+        }
+        else
+        {
+            SetResult(pResult, static_cast<IDispatch*>(pRange));
+        }
+        pRange->Release();
+        return S_OK;
+    }
+
+    return E_NOTIMPL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeSheets
+
+FakeSheets::FakeSheets()
+{
+    AddMember(L"Count");
+    AddMember(L"Item");
+    AddMember(L"Add");
+}
+
+
+FakeSheets::~FakeSheets()
+{
+    for (size_t i = 0; i < m_sheets.size(); ++i)
+        m_sheets[i]->Release();
+}
+
+
+FakeWorksheet* FakeSheets::Add(const std::wstring &name)
+{
+    m_sheets.push_back(new FakeWorksheet(name));
+    return m_sheets.back();
+}
+
+
+FakeWorksheet* FakeSheets::Item(int index) const
+{
+    return (index >= 1 && index <= Count()) ? m_sheets[index - 1] : NULL;
+}
+
+
+HRESULT FakeSheets::Call(const std::wstring &name, WORD /*flags*/, const FakeArgs &args,
+    VARIANT *pResult)
+{
+    if (name == L"Count")
+    {
+        SetResult(pResult, static_cast<long>(Count()));
+        return S_OK;
+    }
+
+    if (name == L"Item")
+    {
+        long index = 0;
+        if (args.size() != 1 || !GetArg(args[0], index))
+            return DISP_E_TYPEMISMATCH;
+        if (!Item(index))
+            return DISP_E_BADINDEX;
+
+        SetResult(pResult, static_cast<IDispatch*>(Item(index)));
+        return S_OK;
+    }
+
+    // Add(Before, After): the new sheet goes at the end whatever the reference
+    wchar_t sheetName[32];
+    std::swprintf(sheetName, 32, L"Sheet%d", Count() + 1);
+    SetResult(pResult, static_cast<IDispatch*>(Add(sheetName)));
+    return S_OK;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeWorkbook
+
+FakeWorkbook::FakeWorkbook(int sheets): m_pSheets(new FakeSheets), m_closed(false)
+{
+    AddMember(L"ActiveSheet");
+    AddMember(L"Worksheets");
+    AddMember(L"Save");
+    AddMember(L"SaveAs");
+    AddMember(L"Close");
+
+    for (int i = 1; i <= sheets; ++i)
+    {
+        wchar_t name[32];
+        std::swprintf(name, 32, L"Sheet%d", i);
+        m_pSheets->Add(name);
+    }
+}
+
+
+FakeWorkbook::~FakeWorkbook()
+{
+    m_pSheets->Release();
+}
+
+
+HRESULT FakeWorkbook::Call(const std::wstring &name, WORD /*flags*/, const FakeArgs &args,
+    VARIANT *pResult)
+{
+    if (m_closed)
+        return RPC_E_DISCONNECTED;
+
+    if (name == L"ActiveSheet")
+    {
+        if (!m_pSheets->Item(1))
+            return DISP_E_EXCEPTION;
+        SetResult(pResult, static_cast<IDispatch*>(m_pSheets->Item(1)));
+        return S_OK;
+    }
+
+    if (name == L"Worksheets")
+    {
+        SetResult(pResult, static_cast<IDispatch*>(m_pSheets));
+        return S_OK;
+    }
+
+    if (name == L"SaveAs")
+    {
+        if (args.empty() || !GetArg(args[0], m_savedAs))
+            return DISP_E_TYPEMISMATCH;
+        return S_OK;
+    }
+
+    if (name == L"Close")
+        m_closed = true;
+
+    return S_OK;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeWorkbooks
+
+FakeWorkbooks::FakeWorkbooks()
+{
+    AddMember(L"Add");
+    AddMember(L"Open");
+}
+
+
+FakeWorkbooks::~FakeWorkbooks()
+{
+    for (size_t i = 0; i < m_workbooks.size(); ++i)
+        m_workbooks[i]->Release();
+}
+
+
+HRESULT FakeWorkbooks::Call(const std::wstring & /*name*/, WORD /*flags*/,
+    const FakeArgs & /*args*/, VARIANT *pResult)
+{
+    // Add and Open both give a new workbook with 3 worksheets, as a default Excel does
+    m_workbooks.push_back(new FakeWorkbook(3));
+    SetResult(pResult, static_cast<IDispatch*>(m_workbooks.back()));
+    return S_OK;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Implementation of class FakeApplication
+
+FakeApplication::FakeApplication()
+    : m_pWorkbooks(new FakeWorkbooks), m_screenUpdating(true), m_enableEvents(true),
+      m_calculation(xlCalculationAutomatic), m_calculates(0), m_visible(false), m_quit(false)
+{
+    AddMember(L"Workbooks");
+    AddMember(L"Visible");
+    AddMember(L"Quit");
+    AddMember(L"ScreenUpdating");
+    AddMember(L"EnableEvents");
+    AddMember(L"Calculation");
+    AddMember(L"Calculate");
+}
+
+
+FakeApplication::~FakeApplication()
+{
+    m_pWorkbooks->Release();
+}
+
+
+HRESULT FakeApplication::Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+    VARIANT *pResult)
+{
+    bool put = (flags & DISPATCH_PROPERTYPUT) != 0;
+    if (put && args.size() != 1)
+        return DISP_E_BADPARAMCOUNT;
+
+    if (name == L"Workbooks")
+    {
+        SetResult(pResult, static_cast<IDispatch*>(m_pWorkbooks));
+    }
+    else if (name == L"Visible")
+    {
+        if (!put)
+            SetResult(pResult, m_visible);
+        else if (!GetArg(args[0], m_visible))
+            return DISP_E_TYPEMISMATCH;
+    }
+    else if (name == L"ScreenUpdating")
+    {
+        if (!put)
+            SetResult(pResult, m_screenUpdating);
+        else if (!GetArg(args[0], m_screenUpdating))
+            return DISP_E_TYPEMISMATCH;
+    }
+    else if (name == L"EnableEvents")
+    {
+        if (!put)
+            SetResult(pResult, m_enableEvents);
+        else if (!GetArg(args[0], m_enableEvents))
+            return DISP_E_TYPEMISMATCH;
+    }
+    else if (name == L"Calculation")
+    {
+        if (!put)
+            SetResult(pResult, m_calculation);
+        else if (!GetArg(args[0], m_calculation))
+            return DISP_E_TYPEMISMATCH;
+    }
+    else if (name == L"Calculate")
+    {
+        ++m_calculates;
+    }
+    else if (name == L"Quit")
+    {
+        m_quit = true;
+    }
+
+    return S_OK;
+}
+
+
+}
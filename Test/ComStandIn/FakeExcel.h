@@ -0,0 +1,425 @@
+﻿/*!
+* @file    FakeExcel.h
+* @brief   Header file for the fake Excel objects which the COM tests run against
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef FAKEEXCEL_H_GUID_C84F1B39_7E2D_4A65_9B08_3D6A15E7F2C4
+#define FAKEEXCEL_H_GUID_C84F1B39_7E2D_4A65_9B08_3D6A15E7F2C4
+
+
+#include <map>
+#include <string>
+#include <vector>
+#include <windows.h>
+
+
+namespace ComStandIn
+{
+    /*!
+    * @brief Class FakeValue owns a VARIANT, so that it can be kept in a container.
+    */
+    class FakeValue
+    {
+    public:
+        FakeValue();
+        FakeValue(const VARIANT &value);
+        FakeValue(const FakeValue &other);
+        FakeValue& operator = (const FakeValue &other);
+        ~FakeValue();
+
+        const VARIANT& Get() const
+        {
+            return m_value;
+        }
+
+        // The value as text, as ::VariantChangeType() converts it; empty if it cannot be converted
+        std::wstring ToString() const;
+
+    private:
+        VARIANT m_value;
+    };
+
+
+    /*!
+    * @brief Class FakeArgs holds the arguments of a call, the first one first, without allocating.
+    */
+    class FakeArgs
+    {
+    public:
+        enum { MaxArgs = 8 };
+
+        FakeArgs(): m_count(0)
+        {
+        }
+
+        void Add(const VARIANT *pArg)
+        {
+            m_args[m_count++] = pArg;
+        }
+
+        size_t size() const
+        {
+            return m_count;
+        }
+
+        bool empty() const
+        {
+            return m_count == 0;
+        }
+
+        const VARIANT* operator [] (size_t index) const
+        {
+            return m_args[index];
+        }
+
+    private:
+        const VARIANT *m_args[MaxArgs];
+        size_t         m_count;
+    };
+
+
+    /*!
+    * @brief Class FakeDispatch is the base of the fake Excel objects: an IDispatch whose members are
+    *        looked up by name, which counts the calls of IDispatch::GetIDsOfNames() and IDispatch::Invoke().
+    * @details The DISPID of a member is its position in the order the members are added, from 1.
+    *          The object has no type information, so the library always calls it late bound.
+    *          It deletes itself when the last reference is released. A call which does not create an
+    *          object or a string does not allocate, so that a test can count the allocations of the library.
+    */
+    class FakeDispatch : public IDispatch
+    {
+    public:
+        // IUnknown
+        virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppv);
+        virtual ULONG   STDMETHODCALLTYPE AddRef();
+        virtual ULONG   STDMETHODCALLTYPE Release();
+
+        // IDispatch
+        virtual HRESULT STDMETHODCALLTYPE GetTypeInfoCount(UINT *pctinfo);
+        virtual HRESULT STDMETHODCALLTYPE GetTypeInfo(UINT iTInfo, LCID lcid, ITypeInfo **ppTInfo);
+        virtual HRESULT STDMETHODCALLTYPE GetIDsOfNames(REFIID riid, LPOLESTR *rgszNames, UINT cNames, LCID lcid,
+            DISPID *rgDispId);
+        virtual HRESULT STDMETHODCALLTYPE Invoke(DISPID dispIdMember, REFIID riid, LCID lcid, WORD wFlags,
+            DISPPARAMS *pDispParams, VARIANT *pVarResult, EXCEPINFO *pExcepInfo, UINT *puArgErr);
+
+        // Number of references held by the library and the test
+        ULONG CountReferences() const
+        {
+            return m_references;
+        }
+
+        // Number of IDispatch::GetIDsOfNames() calls on this object
+        long CountGetIDsOfNames() const
+        {
+            return m_getIDsOfNames;
+        }
+
+        // Number of IDispatch::Invoke() calls on this object
+        long CountInvokes() const
+        {
+            return m_invokes;
+        }
+
+        // Number of IDispatch::GetIDsOfNames() and IDispatch::Invoke() calls on all the fake objects
+        static long CountAllGetIDsOfNames();
+        static long CountAllInvokes();
+        static void ResetAllCounters();
+
+        // Make a member fail with DISP_E_EXCEPTION, as Excel does when it is busy
+        void SetFailing(const std::wstring &name, bool failing = true);
+
+    protected:
+        FakeDispatch();
+        virtual ~FakeDispatch();
+
+        void AddMember(const wchar_t *name);
+
+        /*!
+        * @brief Carry out a call of a member.
+        * @param [in] name Name of the member.
+        * @param [in] flags DISPATCH_METHOD, DISPATCH_PROPERTYGET or DISPATCH_PROPERTYPUT.
+        * @param [in] args The arguments, the first one first; for a property put, the value is the last one.
+        * @param [out] pResult Where the result goes; never NULL, and VT_EMPTY on entry.
+        */
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult) = 0;
+
+        // Helpers for Call()
+        static void SetResult(VARIANT *pResult, IDispatch *pObject);    // takes a reference
+        static void SetResult(VARIANT *pResult, const std::wstring &value);
+        static void SetResult(VARIANT *pResult, bool value);
+        static void SetResult(VARIANT *pResult, long value);
+        static bool GetArg(const VARIANT *pArg, long &value);
+        static bool GetArg(const VARIANT *pArg, bool &value);
+        static bool GetArg(const VARIANT *pArg, std::wstring &value);
+
+    private:
+        FakeDispatch(const FakeDispatch&);
+        FakeDispatch& operator = (const FakeDispatch&);
+
+        std::vector<std::wstring> m_members;
+        std::vector<bool>         m_failing;
+        LONG                      m_references;
+        long                      m_getIDsOfNames;
+        long                      m_invokes;
+    };
+
+
+    class FakeWorksheet;
+
+
+    /*!
+    * @brief Class FakeFont is the Font of a FakeRange. Every property which is put is kept.
+    */
+    class FakeFont : public FakeDispatch
+    {
+    public:
+        FakeFont();
+
+        // The value of a property, VT_EMPTY if it has never been put
+        FakeValue Property(const std::wstring &name) const;
+
+    protected:
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult);
+
+    private:
+        std::map<std::wstring, FakeValue> m_properties;
+    };
+
+
+    /*!
+    * @brief Class FakeRange is a rectangle of cells of a FakeWorksheet.
+    */
+    class FakeRange : public FakeDispatch
+    {
+    public:
+        FakeRange(FakeWorksheet *pSheet, int rowFrom, int columnFrom, int rowTo, int columnTo);
+
+        FakeFont* Font() const
+        {
+            return m_pFont;
+        }
+
+    protected:
+        virtual ~FakeRange();
+
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult);
+
+    private:
+        HRESULT GetValue(VARIANT *pResult) const;
+        HRESULT PutValue(const VARIANT &value);
+
+        FakeWorksheet *m_pSheet;
+        FakeFont      *m_pFont;
+        int            m_rowFrom;
+        int            m_columnFrom;
+        int            m_rowTo;
+        int            m_columnTo;
+    };
+
+
+    /*!
+    * @brief Class FakeWorksheet holds cells, addressed by Range("A1") or Range("A1:C3").
+    */
+    class FakeWorksheet : public FakeDispatch
+    {
+    public:
+        // Give the FakeRange returned by Range() in another object, which takes a reference to it
+        typedef IDispatch* (*RangeWrapper)(FakeRange *pRange);
+
+        explicit FakeWorksheet(const std::wstring &name);
+
+        // Wrap every range returned by Range() from now on; NULL to stop
+        void SetRangeWrapper(RangeWrapper wrapper)
+        {
+            m_wrapper = wrapper;
+        }
+
+        // The value of a cell (both from 1), VT_EMPTY if it has never been set
+        FakeValue Cell(int row, int column) const;
+        void SetCell(int row, int column, const VARIANT &value);
+
+        // The ranges whose Value was put as an array, as "A1:C3", in the order of the puts
+        const std::vector<std::wstring>& ValuePuts() const
+        {
+            return m_valuePuts;
+        }
+
+        void ClearValuePuts()
+        {
+            m_valuePuts.clear();
+        }
+
+        void AddValuePut(int rowFrom, int columnFrom, int rowTo, int columnTo);
+
+        // Parse "A1" or "A1:C3"; false if it is not an address
+        static bool ParseAddress(const std::wstring &address, int &rowFrom, int &columnFrom, int &rowTo,
+            int &columnTo);
+
+    protected:
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult);
+
+    private:
+        std::wstring                               m_name;
+        std::map<std::pair<int, int>, FakeValue>   m_cells;
+        std::vector<std::wstring>                  m_valuePuts;
+        RangeWrapper                               m_wrapper;
+    };
+
+
+    /*!
+    * @brief Class FakeSheets is the Worksheets collection of a FakeWorkbook.
+    */
+    class FakeSheets : public FakeDispatch
+    {
+    public:
+        FakeSheets();
+
+        // Add a worksheet; the collection keeps a reference
+        FakeWorksheet* Add(const std::wstring &name);
+        FakeWorksheet* Item(int index) const;   // from 1
+        int Count() const
+        {
+            return static_cast<int>(m_sheets.size());
+        }
+
+    protected:
+        virtual ~FakeSheets();
+
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult);
+
+    private:
+        std::vector<FakeWorksheet*> m_sheets;
+    };
+
+
+    /*!
+    * @brief Class FakeWorkbook has the given number of worksheets, the first one active.
+    */
+    class FakeWorkbook : public FakeDispatch
+    {
+    public:
+        explicit FakeWorkbook(int sheets);
+
+        FakeSheets* Sheets() const
+        {
+            return m_pSheets;
+        }
+
+        const std::wstring& SavedAs() const
+        {
+            return m_savedAs;
+        }
+
+        bool IsClosed() const
+        {
+            return m_closed;
+        }
+
+    protected:
+        virtual ~FakeWorkbook();
+
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult);
+
+    private:
+        FakeSheets  *m_pSheets;
+        std::wstring m_savedAs;
+        bool         m_closed;
+    };
+
+
+    /*!
+    * @brief Class FakeWorkbooks is the Workbooks collection of a FakeApplication.
+    */
+    class FakeWorkbooks : public FakeDispatch
+    {
+    public:
+        FakeWorkbooks();
+
+        // The workbooks added or opened, in order; the collection keeps a reference
+        const std::vector<FakeWorkbook*>& Workbooks() const
+        {
+            return m_workbooks;
+        }
+
+    protected:
+        virtual ~FakeWorkbooks();
+
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult);
+
+    private:
+        std::vector<FakeWorkbook*> m_workbooks;
+    };
+
+
+    /*!
+    * @brief Class FakeApplication is the object which ::CoCreateInstance() hands to ExcelApplication.
+    */
+    class FakeApplication : public FakeDispatch
+    {
+    public:
+        FakeApplication();
+
+        FakeWorkbooks* Workbooks() const
+        {
+            return m_pWorkbooks;
+        }
+
+        bool ScreenUpdating() const
+        {
+            return m_screenUpdating;
+        }
+
+        bool EnableEvents() const
+        {
+            return m_enableEvents;
+        }
+
+        long Calculation() const
+        {
+            return m_calculation;
+        }
+
+        int CountCalculates() const
+        {
+            return m_calculates;
+        }
+
+        bool IsVisible() const
+        {
+            return m_visible;
+        }
+
+        bool HasQuit() const
+        {
+            return m_quit;
+        }
+
+    protected:
+        virtual ~FakeApplication();
+
+        virtual HRESULT Call(const std::wstring &name, WORD flags, const FakeArgs &args,
+            VARIANT *pResult);
+
+    private:
+        FakeWorkbooks *m_pWorkbooks;
+        bool           m_screenUpdating;
+        bool           m_enableEvents;
+        long           m_calculation;
+        int            m_calculates;
+        bool           m_visible;
+        bool           m_quit;
+    };
+}
+
+
+#endif //FAKEEXCEL_H_GUID_C84F1B39_7E2D_4A65_9B08_3D6A15E7F2C4
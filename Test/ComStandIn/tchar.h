@@ -0,0 +1,24 @@
+﻿/*!
+* @file    tchar.h
+* @brief   Stand-in for the generic-text mappings used by the COM sources of ExcelAutomationLib, on Linux
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef TCHAR_H_GUID_9C27E4B1_6A0D_4E53_8F12_B4D7A6E03C95
+#define TCHAR_H_GUID_9C27E4B1_6A0D_4E53_8F12_B4D7A6E03C95
+
+
+#include <cwchar>
+#include <cwctype>
+
+
+// The COM sources are built with _UNICODE, so the generic-text functions are the wide ones
+#define _T(s) L##s
+#define _totupper towupper
+
+int _stprintf_s(wchar_t *buffer, size_t sizeOfBuffer, const wchar_t *format, ...);
+
+
+#endif //TCHAR_H_GUID_9C27E4B1_6A0D_4E53_8F12_B4D7A6E03C95
@@ -0,0 +1,405 @@
+﻿/*!
+* @file    windows.h
+* @brief   Stand-in for the Windows and COM API used by the COM sources of ExcelAutomationLib, on Linux
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef WINDOWS_H_GUID_0B6E3A5D_2C41_4F87_9E1A_7D58C3B20F46
+#define WINDOWS_H_GUID_0B6E3A5D_2C41_4F87_9E1A_7D58C3B20F46
+
+
+/*!
+* @file
+* The tests build the COM sources of the library (ComUtil.cpp, ExcelApplication.cpp, ...) on Linux, where they
+* include this file instead of the real windows.h. It declares the types and functions those sources use,
+* with the layout and the behavior of Windows where a test depends on them. ComStandIn.cpp implements them
+* in process: strings, variants, safe arrays, critical sections and the interlocked functions work as on
+* Windows, and CoCreateInstance() returns the fake object a test gives to ComStandIn::SetInstance().
+* @note Only what the tests link is implemented; a function which is only declared is never called by them.
+*/
+
+
+#include <cstddef>
+#include <cstring>
+#include <cwchar>
+#include <pthread.h>
+
+
+#define __stdcall
+#define STDMETHODCALLTYPE
+#define WINAPI
+
+
+// Basic types; LONG is long as on Windows, so that the sources which pass a long for a LONG compile
+// unchanged (it is 64 bits here, which no test depends on)
+typedef int                HRESULT;
+typedef int                BOOL;
+typedef long               LONG;
+typedef unsigned long      ULONG;
+typedef unsigned int       UINT;
+typedef unsigned long      DWORD;
+typedef unsigned short     WORD;
+typedef unsigned char      BYTE;
+typedef short              SHORT;
+typedef unsigned short     USHORT;
+typedef long long          LONGLONG;
+typedef unsigned long long ULONGLONG;
+typedef unsigned long      ULONG_PTR;
+typedef long               LONG_PTR;
+typedef unsigned long      SIZE_T;
+typedef LONG               SCODE;
+typedef DWORD              LCID;
+typedef LONG               DISPID;
+typedef LONG               MEMBERID;
+typedef DWORD              COLORREF;
+typedef void              *HANDLE;
+typedef void              *LPVOID;
+typedef wchar_t            WCHAR;
+typedef wchar_t            OLECHAR;
+typedef OLECHAR           *LPOLESTR;
+typedef const OLECHAR     *LPCOLESTR;
+typedef OLECHAR           *BSTR;
+typedef const wchar_t     *LPCWSTR;
+typedef wchar_t           *LPWSTR;
+typedef short              VARIANT_BOOL;
+typedef double             DATE;
+typedef unsigned short     VARTYPE;
+
+#define TRUE  1
+#define FALSE 0
+
+#define VARIANT_TRUE  ((VARIANT_BOOL)-1)
+#define VARIANT_FALSE ((VARIANT_BOOL)0)
+
+#define OLESTR(s) L##s
+#define TEXT(s)   L##s
+
+#define INFINITE 0xFFFFFFFF
+#define MAX_PATH 260
+
+
+// HRESULT
+#define S_OK                  ((HRESULT)0)
+#define S_FALSE               ((HRESULT)1)
+#define E_NOTIMPL             ((HRESULT)0x80004001)
+#define E_NOINTERFACE         ((HRESULT)0x80004002)
+#define E_POINTER             ((HRESULT)0x80004003)
+#define E_ABORT               ((HRESULT)0x80004004)
+#define E_FAIL                ((HRESULT)0x80004005)
+#define E_UNEXPECTED          ((HRESULT)0x8000FFFF)
+#define E_OUTOFMEMORY         ((HRESULT)0x8007000E)
+#define E_INVALIDARG          ((HRESULT)0x80070057)
+#define DISP_E_MEMBERNOTFOUND ((HRESULT)0x80020003)
+#define DISP_E_PARAMNOTFOUND  ((HRESULT)0x80020004)
+#define DISP_E_TYPEMISMATCH   ((HRESULT)0x80020005)
+#define DISP_E_UNKNOWNNAME    ((HRESULT)0x80020006)
+#define DISP_E_EXCEPTION      ((HRESULT)0x80020009)
+#define DISP_E_BADPARAMCOUNT  ((HRESULT)0x8002000E)
+#define DISP_E_OVERFLOW       ((HRESULT)0x8002000A)
+#define DISP_E_BADINDEX       ((HRESULT)0x8002000B)
+#define DISP_E_BADVARTYPE     ((HRESULT)0x80020008)
+#define DISP_E_ARRAYISLOCKED  ((HRESULT)0x8002000D)
+#define RPC_E_DISCONNECTED    ((HRESULT)0x80010108)
+#define TYPE_E_ELEMENTNOTFOUND ((HRESULT)0x8002802B)
+
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)    (((HRESULT)(hr)) < 0)
+
+
+// Automation
+#define DISPATCH_METHOD         0x1
+#define DISPATCH_PROPERTYGET    0x2
+#define DISPATCH_PROPERTYPUT    0x4
+#define DISPATCH_PROPERTYPUTREF 0x8
+#define DISPID_PROPERTYPUT      (-3)
+#define DISPID_UNKNOWN          (-1)
+
+#define LOCALE_SYSTEM_DEFAULT  0x800
+#define LOCALE_USER_DEFAULT    0x400
+#define VARIANT_NOUSEROVERRIDE 0x4
+
+#define COINIT_MULTITHREADED     0x0
+#define COINIT_APARTMENTTHREADED 0x2
+#define CLSCTX_INPROC_SERVER     0x1
+#define CLSCTX_LOCAL_SERVER      0x4
+
+enum VARENUM
+{
+    VT_EMPTY = 0, VT_NULL = 1, VT_I2 = 2, VT_I4 = 3, VT_R4 = 4, VT_R8 = 5, VT_CY = 6, VT_DATE = 7, VT_BSTR = 8,
+    VT_DISPATCH = 9, VT_ERROR = 10, VT_BOOL = 11, VT_VARIANT = 12, VT_UNKNOWN = 13, VT_DECIMAL = 14, VT_I1 = 16,
+    VT_UI1 = 17, VT_UI2 = 18, VT_UI4 = 19, VT_I8 = 20, VT_UI8 = 21, VT_INT = 22, VT_UINT = 23, VT_VOID = 24,
+    VT_HRESULT = 25, VT_PTR = 26, VT_SAFEARRAY = 27, VT_CARRAY = 28, VT_USERDEFINED = 29,
+    VT_ARRAY = 0x2000, VT_BYREF = 0x4000
+};
+
+struct GUID
+{
+    unsigned int   Data1;
+    unsigned short Data2;
+    unsigned short Data3;
+    unsigned char  Data4[8];
+};
+
+typedef GUID        IID;
+typedef GUID        CLSID;
+typedef const IID   &REFIID;
+typedef const CLSID &REFCLSID;
+
+inline bool operator == (const GUID &a, const GUID &b)
+{
+    return std::memcmp(&a, &b, sizeof(GUID)) == 0;
+}
+
+inline bool operator != (const GUID &a, const GUID &b)
+{
+    return !(a == b);
+}
+
+extern const IID IID_NULL;
+extern const IID IID_IUnknown;
+extern const IID IID_IDispatch;
+
+struct SAFEARRAYBOUND
+{
+    ULONG cElements;
+    LONG  lLbound;
+};
+
+struct SAFEARRAY
+{
+    USHORT         cDims;
+    USHORT         fFeatures;
+    ULONG          cbElements;
+    ULONG          cLocks;
+    void          *pvData;
+    SAFEARRAYBOUND rgsabound[1];    // cDims bounds, the last dimension first
+};
+
+typedef union
+{
+    struct { unsigned int Lo; int Hi; } s;
+    LONGLONG int64;
+} CY;
+
+struct IUnknown;
+struct IDispatch;
+struct ITypeInfo;
+
+struct tagVARIANT
+{
+    VARTYPE vt;
+    WORD    wReserved1;
+    WORD    wReserved2;
+    WORD    wReserved3;
+    union
+    {
+        LONGLONG     llVal;
+        LONG         lVal;
+        BYTE         bVal;
+        SHORT        iVal;
+        float        fltVal;
+        double       dblVal;
+        VARIANT_BOOL boolVal;
+        SCODE        scode;
+        CY           cyVal;
+        DATE         date;
+        BSTR         bstrVal;
+        IUnknown    *punkVal;
+        IDispatch   *pdispVal;
+        SAFEARRAY   *parray;
+        char         cVal;
+        USHORT       uiVal;
+        ULONG        ulVal;
+        ULONGLONG    ullVal;
+        int          intVal;
+        unsigned int uintVal;
+        tagVARIANT  *pvarVal;
+        void        *byref;
+    };
+};
+
+typedef tagVARIANT VARIANT;
+typedef VARIANT    VARIANTARG;
+
+struct DISPPARAMS
+{
+    VARIANTARG *rgvarg;
+    DISPID     *rgdispidNamedArgs;
+    UINT        cArgs;
+    UINT        cNamedArgs;
+};
+
+struct EXCEPINFO
+{
+    WORD wCode;
+};
+
+struct IUnknown
+{
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppv) = 0;
+    virtual ULONG   STDMETHODCALLTYPE AddRef() = 0;
+    virtual ULONG   STDMETHODCALLTYPE Release() = 0;
+};
+
+struct IDispatch : IUnknown
+{
+    virtual HRESULT STDMETHODCALLTYPE GetTypeInfoCount(UINT *pctinfo) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetTypeInfo(UINT iTInfo, LCID lcid, ITypeInfo **ppTInfo) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetIDsOfNames(REFIID riid, LPOLESTR *rgszNames, UINT cNames, LCID lcid,
+        DISPID *rgDispId) = 0;
+    virtual HRESULT STDMETHODCALLTYPE Invoke(DISPID dispIdMember, REFIID riid, LCID lcid, WORD wFlags,
+        DISPPARAMS *pDispParams, VARIANT *pVarResult, EXCEPINFO *pExcepInfo, UINT *puArgErr) = 0;
+};
+
+
+// Type information, as much as VtableBinding reads
+enum TYPEKIND { TKIND_ENUM, TKIND_RECORD, TKIND_MODULE, TKIND_INTERFACE, TKIND_DISPATCH, TKIND_COCLASS,
+    TKIND_ALIAS, TKIND_UNION, TKIND_MAX };
+enum INVOKEKIND { INVOKE_FUNC = 1, INVOKE_PROPERTYGET = 2, INVOKE_PROPERTYPUT = 4, INVOKE_PROPERTYPUTREF = 8 };
+enum CALLCONV { CC_FASTCALL = 0, CC_CDECL = 1, CC_STDCALL = 4 };
+enum FUNCKIND { FUNC_VIRTUAL, FUNC_PUREVIRTUAL, FUNC_NONVIRTUAL, FUNC_STATIC, FUNC_DISPATCH };
+
+#define PARAMFLAG_NONE        0x00
+#define PARAMFLAG_FIN         0x01
+#define PARAMFLAG_FOUT        0x02
+#define PARAMFLAG_FLCID       0x04
+#define PARAMFLAG_FRETVAL     0x08
+#define PARAMFLAG_FOPT        0x10
+#define PARAMFLAG_FHASDEFAULT 0x20
+
+#define TYPEFLAG_FDUAL         0x40
+#define TYPEFLAG_FDISPATCHABLE 0x1000
+
+typedef DWORD HREFTYPE;
+
+struct TYPEDESC
+{
+    union
+    {
+        TYPEDESC *lptdesc;
+        HREFTYPE  hreftype;
+    };
+    VARTYPE vt;
+};
+
+struct PARAMDESC
+{
+    void  *pparamdescex;
+    USHORT wParamFlags;
+};
+
+struct ELEMDESC
+{
+    TYPEDESC  tdesc;
+    PARAMDESC paramdesc;
+};
+
+struct FUNCDESC
+{
+    MEMBERID   memid;
+    SCODE     *lprgscode;
+    ELEMDESC  *lprgelemdescParam;
+    FUNCKIND   funckind;
+    INVOKEKIND invkind;
+    CALLCONV   callconv;
+    SHORT      cParams;
+    SHORT      cParamsOpt;
+    SHORT      oVft;
+    SHORT      cScodes;
+    ELEMDESC   elemdescFunc;
+    WORD       wFuncFlags;
+};
+
+struct TYPEATTR
+{
+    GUID     guid;
+    LCID     lcid;
+    MEMBERID memidConstructor;
+    MEMBERID memidDestructor;
+    ULONG    cbSizeInstance;
+    TYPEKIND typekind;
+    WORD     cFuncs;
+    WORD     cVars;
+    WORD     cImplTypes;
+    WORD     cbSizeVft;
+    WORD     wTypeFlags;
+};
+
+struct ITypeInfo : IUnknown
+{
+    virtual HRESULT STDMETHODCALLTYPE GetTypeAttr(TYPEATTR **ppTypeAttr) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetFuncDesc(UINT index, FUNCDESC **ppFuncDesc) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetIDsOfNames(LPOLESTR *rgszNames, UINT cNames, MEMBERID *pMemId) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetRefTypeOfImplType(UINT index, HREFTYPE *pRefType) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetRefTypeInfo(HREFTYPE hRefType, ITypeInfo **ppTInfo) = 0;
+    virtual void    STDMETHODCALLTYPE ReleaseTypeAttr(TYPEATTR *pTypeAttr) = 0;
+    virtual void    STDMETHODCALLTYPE ReleaseFuncDesc(FUNCDESC *pFuncDesc) = 0;
+};
+
+
+// Strings, variants and safe arrays
+BSTR SysAllocString(const OLECHAR *psz);
+BSTR SysAllocStringLen(const OLECHAR *strIn, UINT ui);
+void SysFreeString(BSTR bstrString);
+UINT SysStringLen(BSTR pbstr);
+
+void    VariantInit(VARIANT *pvarg);
+HRESULT VariantClear(VARIANT *pvarg);
+HRESULT VariantCopy(VARIANT *pvargDest, const VARIANT *pvargSrc);
+HRESULT VariantChangeType(VARIANT *pvargDest, const VARIANT *pvarSrc, USHORT wFlags, VARTYPE vt);
+
+SAFEARRAY* SafeArrayCreate(VARTYPE vt, UINT cDims, SAFEARRAYBOUND *rgsabound);
+HRESULT    SafeArrayDestroy(SAFEARRAY *psa);
+UINT       SafeArrayGetDim(SAFEARRAY *psa);
+HRESULT    SafeArrayGetLBound(SAFEARRAY *psa, UINT nDim, LONG *plLbound);
+HRESULT    SafeArrayGetUBound(SAFEARRAY *psa, UINT nDim, LONG *plUbound);
+HRESULT    SafeArrayGetElement(SAFEARRAY *psa, LONG *rgIndices, void *pv);
+HRESULT    SafeArrayPutElement(SAFEARRAY *psa, LONG *rgIndices, void *pv);
+HRESULT    SafeArrayAccessData(SAFEARRAY *psa, void **ppvData);
+HRESULT    SafeArrayUnaccessData(SAFEARRAY *psa);
+
+HRESULT DispCallFunc(void *pvInstance, ULONG_PTR oVft, CALLCONV cc, VARTYPE vtReturn, UINT cActuals,
+    VARTYPE *prgvt, VARIANTARG **prgpvarg, VARIANT *pvargResult);
+
+
+// COM runtime
+HRESULT CoInitializeEx(void *pvReserved, DWORD dwCoInit);
+void    CoUninitialize();
+HRESULT CLSIDFromProgID(LPCOLESTR lpszProgID, CLSID *lpclsid);
+HRESULT CoCreateInstance(REFCLSID rclsid, IUnknown *pUnkOuter, DWORD dwClsContext, REFIID riid, LPVOID *ppv);
+
+
+// Threads and time
+struct CRITICAL_SECTION
+{
+    pthread_mutex_t mutex;
+};
+
+void InitializeCriticalSection(CRITICAL_SECTION *lpCriticalSection);
+void DeleteCriticalSection(CRITICAL_SECTION *lpCriticalSection);
+void EnterCriticalSection(CRITICAL_SECTION *lpCriticalSection);
+void LeaveCriticalSection(CRITICAL_SECTION *lpCriticalSection);
+
+LONG InterlockedIncrement(LONG volatile *Addend);
+LONG InterlockedDecrement(LONG volatile *Addend);
+LONG InterlockedExchange(LONG volatile *Target, LONG Value);
+LONG InterlockedCompareExchange(LONG volatile *Destination, LONG Exchange, LONG Comparand);
+LONG InterlockedExchangeAdd(LONG volatile *Addend, LONG Value);
+void* InterlockedExchangePointer(void * volatile *Target, void *Value);
+
+union LARGE_INTEGER
+{
+    LONGLONG QuadPart;
+};
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER *lpPerformanceCount);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER *lpFrequency);
+
+
+// Files
+DWORD GetFullPathName(LPCWSTR lpFileName, DWORD nBufferLength, LPWSTR lpBuffer, LPWSTR *lpFilePart);
+
+
+#endif //WINDOWS_H_GUID_0B6E3A5D_2C41_4F87_9E1A_7D58C3B20F46
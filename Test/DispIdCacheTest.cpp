@@ -0,0 +1,225 @@
+﻿/*!
+* @file    DispIdCacheTest.cpp
+* @brief   Test of DispIdCache, on the fake Excel objects
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdlib>
+#include <new>
+
+#include "ExcelApplication.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheet.h"
+#include "ExcelCell.h"
+#include "ComUtil.h"
+#include "DispIdCache.h"
+#include "ComStandIn.h"
+#include "FakeExcel.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+using namespace ComStandIn;
+
+
+namespace
+{
+    const int Loops = 100;
+
+    long s_allocations = 0;
+}
+
+
+// Count the allocations of the whole program
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+    ++s_allocations;
+
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+
+// Not inlined, or GCC warns that the memory of a new expression is given to free()
+__attribute__((noinline)) void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+
+namespace
+{
+    // A Range whose DISPIDs differ from those of FakeRange, as after Excel was upgraded
+    class RenumberedRange : public FakeDispatch
+    {
+    public:
+        RenumberedRange(): m_value(0)
+        {
+            AddMember(L"Formula");
+            AddMember(L"Value");
+        }
+
+        long Value() const
+        {
+            return m_value;
+        }
+
+    protected:
+        virtual HRESULT Call(const std::wstring &name, WORD /*flags*/, const FakeArgs &args,
+            VARIANT * /*pResult*/)
+        {
+            if (name != L"Value")
+                return DISP_E_MEMBERNOTFOUND;
+            return (args.size() == 1 && GetArg(args[0], m_value)) ? S_OK : DISP_E_TYPEMISMATCH;
+        }
+
+    private:
+        long m_value;
+    };
+
+
+    // ExcelCell::SetValue() in a loop: one GetIDsOfNames() for the whole loop, one Invoke() per iteration
+    void TestCachedSetValue()
+    {
+        FakeApplication *pApp = new FakeApplication;
+        SetInstance(pApp);
+
+        ExcelApplication app;
+        TEST_CHECK(app.Startup());
+
+        ExcelWorkbook workbook = app.CreateWorkbook(ELtext("book.xlsx"));
+        ExcelWorksheet sheet = workbook.GetActiveWorksheet();
+        ExcelCell cell = sheet.GetCell(ELtext('B'), 2);
+
+        DispIdCache::Clear();
+        DispIdCache::ResetCounters();
+        FakeDispatch::ResetAllCounters();
+
+        for (int i = 0; i < Loops; ++i)
+            TEST_CHECK(cell.SetValue(i));
+
+        TEST_CHECK(FakeDispatch::CountAllGetIDsOfNames() == 1);
+        TEST_CHECK(FakeDispatch::CountAllInvokes() == Loops);
+        TEST_CHECK(DispIdCache::CountMisses() == 1);
+        TEST_CHECK(DispIdCache::CountHits() == Loops - 1);
+
+        FakeWorksheet *pSheet = pApp->Workbooks()->Workbooks()[0]->Sheets()->Item(1);
+        TEST_CHECK(pSheet->Cell(2, 2).ToString() == L"99");
+
+        // another Range shares the DISPIDs of the first one
+        ExcelCell other = sheet.GetCell(ELtext('C'), 3);
+        FakeDispatch::ResetAllCounters();
+        TEST_CHECK(other.SetValue(1.5));
+        TEST_CHECK(FakeDispatch::CountAllGetIDsOfNames() == 0);
+
+        workbook.Close();
+        app.Shutdown();
+        SetInstance(NULL);
+        pApp->Release();
+    }
+
+    // Without a type name the cache is bypassed: two calls per iteration
+    void TestUncached()
+    {
+        FakeWorksheet *pSheet = new FakeWorksheet(L"Sheet1");
+        FakeRange *pRange = new FakeRange(pSheet, 1, 1, 1, 1);
+
+        DispIdCache::ResetCounters();
+        for (int i = 0; i < Loops; ++i)
+            TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pRange, NULL, DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, i)));
+
+        TEST_CHECK(pRange->CountGetIDsOfNames() == Loops);
+        TEST_CHECK(pRange->CountInvokes() == Loops);
+        TEST_CHECK(DispIdCache::CountHits() == 0 && DispIdCache::CountMisses() == 0);
+
+        pRange->Release();
+        pSheet->Release();
+    }
+
+    // A cached DISPID which the object does not know any more is looked up again
+    void TestStaleEntry()
+    {
+        FakeWorksheet *pSheet = new FakeWorksheet(L"Sheet1");
+        FakeRange *pRange = new FakeRange(pSheet, 1, 1, 1, 1);
+        RenumberedRange *pRenumbered = new RenumberedRange;
+
+        DispIdCache::Clear();
+        TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, 1)));
+        TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pRenumbered, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"),
+            NULL, 2)));
+        TEST_CHECK(pRenumbered->Value() == 2);
+        TEST_CHECK(pRenumbered->CountGetIDsOfNames() == 1);
+        TEST_CHECK(pRenumbered->CountInvokes() == 2);
+
+        // the entry now holds the new DISPID
+        TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pRenumbered, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"),
+            NULL, 3)));
+        TEST_CHECK(pRenumbered->Value() == 3);
+        TEST_CHECK(pRenumbered->CountGetIDsOfNames() == 1);
+
+        // an unknown name is not cached
+        TEST_CHECK(ComUtil::Invoke(pRange, OLESTR("Range"), DISPATCH_METHOD, OLESTR("NoSuchMember"), NULL) ==
+            DISP_E_UNKNOWNNAME);
+        TEST_CHECK(ComUtil::Invoke(pRange, OLESTR("Range"), DISPATCH_METHOD, OLESTR("NoSuchMember"), NULL) ==
+            DISP_E_UNKNOWNNAME);
+        TEST_CHECK(pRange->CountGetIDsOfNames() == 3);
+
+        pRenumbered->Release();
+        pRange->Release();
+        pSheet->Release();
+    }
+
+    // A hit compares the names by content and does not allocate; the cache keeps its own copy of the names
+    void TestKeys()
+    {
+        FakeWorksheet *pSheet = new FakeWorksheet(L"Sheet1");
+        FakeRange *pRange = new FakeRange(pSheet, 1, 1, 1, 1);
+
+        DispIdCache::Clear();
+
+        OLECHAR typeName[] = OLESTR("Range");
+        OLECHAR name[] = OLESTR("Font");
+        DISPID dispId = 0;
+        TEST_CHECK(SUCCEEDED(DispIdCache::GetDispId(pRange, typeName, name, dispId)));
+        TEST_CHECK(dispId == 3);
+
+        // the names of the first lookup are gone
+        std::wcscpy(typeName, OLESTR("Xxxxx"));
+        std::wcscpy(name, OLESTR("Xxxx"));
+
+        long allocations = s_allocations;
+        for (int i = 0; i < Loops; ++i)
+        {
+            dispId = 0;
+            TEST_CHECK(SUCCEEDED(DispIdCache::GetDispId(pRange, OLESTR("Range"), OLESTR("Font"), dispId)));
+            TEST_CHECK(dispId == 3);
+        }
+
+        TEST_CHECK(s_allocations == allocations);
+        TEST_CHECK(pRange->CountGetIDsOfNames() == 1);
+
+        // the same member name in another type is another entry
+        TEST_CHECK(SUCCEEDED(DispIdCache::GetDispId(pRange, OLESTR("Characters"), OLESTR("Font"), dispId)));
+        TEST_CHECK(pRange->CountGetIDsOfNames() == 2);
+
+        pRange->Release();
+        pSheet->Release();
+    }
+}
+
+
+int main()
+{
+    TestCachedSetValue();
+    TestUncached();
+    TestStaleEntry();
+    TestKeys();
+
+    TEST_CHECK(CountStrings() == 0);
+
+    return TestResult("DispIdCacheTest");
+}
@@ -0,0 +1,371 @@
+﻿/*!
+* @file    InstancePoolTest.cpp
+* @brief   Test of InstancePool, with a stand-in factory instead of Excel processes
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <set>
+
+#include "InstancePool.h"
+#include "ThreadUtil.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    typedef InstancePool::InstanceId InstanceId;
+
+
+    /*!
+    * @brief Class FakeFactory makes numbered instances, which the test can kill or keep from starting.
+    */
+    class FakeFactory : public InstancePool::Factory
+    {
+    public:
+        FakeFactory(): m_nextId(1), m_memory(1000), m_failing(false), m_entered(0), m_left(0), m_waits(0),
+            m_inThread(true)
+        {
+        }
+
+        virtual void EnterThread()
+        {
+            MutexLock lock(m_mutex);
+            ++m_entered;
+        }
+
+        virtual void LeaveThread()
+        {
+            MutexLock lock(m_mutex);
+            ++m_left;
+        }
+
+        virtual bool Create(InstanceId &id, unsigned long long &memory)
+        {
+            MutexLock lock(m_mutex);
+            CheckThread();
+
+            if (m_failing)
+                return false;
+
+            id = m_nextId++;
+            memory = m_memory;
+            m_alive.insert(id);
+            return true;
+        }
+
+        virtual bool IsAlive(InstanceId id)
+        {
+            MutexLock lock(m_mutex);
+            CheckThread();
+
+            return m_alive.count(id) != 0;
+        }
+
+        virtual void Destroy(InstanceId id)
+        {
+            MutexLock lock(m_mutex);
+            CheckThread();
+
+            m_alive.erase(id);
+            m_destroyed.insert(id);
+        }
+
+        virtual void Wait(Event &wake, unsigned long timeout)
+        {
+            {
+                MutexLock lock(m_mutex);
+                CheckThread();
+                ++m_waits;
+            }
+
+            wake.Wait(timeout);
+        }
+
+        void Kill(InstanceId id)
+        {
+            MutexLock lock(m_mutex);
+            m_alive.erase(id);
+        }
+
+        void SetFailing(bool failing)
+        {
+            MutexLock lock(m_mutex);
+            m_failing = failing;
+        }
+
+        bool IsDestroyed(InstanceId id) const
+        {
+            MutexLock lock(m_mutex);
+            return m_destroyed.count(id) != 0;
+        }
+
+        size_t CountAlive() const
+        {
+            MutexLock lock(m_mutex);
+            return m_alive.size();
+        }
+
+        int CountWaits() const
+        {
+            MutexLock lock(m_mutex);
+            return m_waits;
+        }
+
+        // Whether EnterThread() and LeaveThread() were called once, and the other members only between them
+        bool WasCalledRight() const
+        {
+            MutexLock lock(m_mutex);
+            return m_entered == 1 && m_left == 1 && m_inThread;
+        }
+
+    private:
+        void CheckThread()
+        {
+            if (m_entered != 1 || m_left != 0)
+                m_inThread = false;
+        }
+
+        mutable Mutex           m_mutex;
+        InstanceId              m_nextId;
+        unsigned long long      m_memory;
+        bool                    m_failing;
+        std::set<InstanceId>    m_alive;
+        std::set<InstanceId>    m_destroyed;
+        int                     m_entered;
+        int                     m_left;
+        int                     m_waits;
+        bool                    m_inThread;
+    };
+
+
+    // Wait until the condition holds, for at most 2 seconds
+    template <class TPredicate>
+    bool WaitFor(TPredicate predicate)
+    {
+        unsigned long start = Thread::TickCount();
+        while (!predicate())
+        {
+            if (Thread::TickCount() - start > 2000)
+                return false;
+            Thread::Sleep(1);
+        }
+        return true;
+    }
+
+    // Whether the factory destroyed an instance
+    struct IsDestroyed
+    {
+        IsDestroyed(const FakeFactory &factory, InstanceId id): factory(factory), id(id) { }
+
+        bool operator () () const
+        {
+            return factory.IsDestroyed(id);
+        }
+
+        const FakeFactory &factory;
+        InstanceId         id;
+    };
+
+    // Whether the pool has a number of idle instances
+    struct HasIdle
+    {
+        HasIdle(const InstancePool &pool, size_t count): pool(pool), count(count) { }
+
+        bool operator () () const
+        {
+            return pool.GetStats().idle == count;
+        }
+
+        const InstancePool &pool;
+        size_t              count;
+    };
+
+
+    // The instances are started up front, leased, and a lease times out when all are leased
+    void TestLease()
+    {
+        FakeFactory factory;
+        {
+            InstancePool::Options options;
+            options.size = 2;
+            InstancePool pool(factory, options);
+
+            InstanceId first = 0;
+            InstanceId second = 0;
+            InstanceId third = 0;
+            TEST_CHECK(pool.Lease(first, Event::infinite));
+            TEST_CHECK(pool.Lease(second, 1000));
+            TEST_CHECK(first != second);
+
+            // the pool thread waits through the factory once the instances are started
+            TEST_CHECK(!pool.Lease(third, 50));
+            TEST_CHECK(factory.CountWaits() > 0);
+            TEST_CHECK(pool.GetStats().leaseTimeouts == 1 && pool.GetStats().leased == 2);
+
+            // the last returned one is leased first
+            InstancePool::Usage usage;
+            pool.Return(first, usage);
+            pool.Return(second, usage);
+            TEST_CHECK(pool.Lease(third, 1000) && third == second);
+            pool.Return(third, usage);
+
+            InstancePool::Stats stats = pool.GetStats();
+            TEST_CHECK(stats.created == 2 && stats.leases == 3 && stats.returns == 3 && stats.idle == 2);
+        }
+
+        // the pool destroys all its instances when it stops
+        TEST_CHECK(factory.CountAlive() == 0);
+        TEST_CHECK(factory.WasCalledRight());
+    }
+
+
+    // An instance which is not healthy, or over a limit, is recycled and replaced
+    void TestRecycle()
+    {
+        FakeFactory factory;
+        {
+            InstancePool::Options options;
+            options.size = 1;
+            options.maxWorkbooks = 3;
+            options.maxMemoryGrowth = 500;
+            InstancePool pool(factory, options);
+
+            InstanceId id = 0;
+            InstancePool::Usage usage;
+
+            // not healthy
+            TEST_CHECK(pool.Lease(id, 1000));
+            usage.healthy = false;
+            pool.Return(id, usage);
+            usage.healthy = true;
+            TEST_CHECK(pool.Lease(id, 1000) && id == 2 && factory.IsDestroyed(1));
+
+            // 3 workbooks in two leases
+            usage.workbooks = 2;
+            pool.Return(id, usage);
+            TEST_CHECK(pool.Lease(id, 1000) && id == 2);
+            usage.workbooks = 1;
+            pool.Return(id, usage);
+            TEST_CHECK(pool.Lease(id, 1000) && id == 3 && factory.IsDestroyed(2));
+
+            // grown from 1000 to 1500 bytes
+            usage.workbooks = 0;
+            usage.memory = 1499;
+            pool.Return(id, usage);
+            TEST_CHECK(pool.Lease(id, 1000) && id == 3);
+            usage.memory = 1500;
+            pool.Return(id, usage);
+            TEST_CHECK(pool.Lease(id, 1000) && id == 4 && factory.IsDestroyed(3));
+            pool.Return(id, InstancePool::Usage());
+
+            InstancePool::Stats stats = pool.GetStats();
+            TEST_CHECK(stats.dead == 1 && stats.recycled == 2 && stats.created == 4);
+        }
+
+        TEST_CHECK(factory.CountAlive() == 0);
+        TEST_CHECK(factory.WasCalledRight());
+    }
+
+
+    // The idle instances are checked, and the dead ones replaced
+    void TestCheck()
+    {
+        FakeFactory factory;
+        {
+            InstancePool::Options options;
+            options.size = 2;
+            options.checkInterval = 10;
+            InstancePool pool(factory, options);
+
+            TEST_CHECK(WaitFor(HasIdle(pool, 2)));
+            factory.Kill(1);
+
+            // found dead by a check, and replaced
+            TEST_CHECK(WaitFor(IsDestroyed(factory, 1)));
+            TEST_CHECK(WaitFor(HasIdle(pool, 2)));
+            TEST_CHECK(pool.GetStats().dead == 1);
+
+            InstanceId first = 0;
+            InstanceId second = 0;
+            TEST_CHECK(pool.Lease(first, 1000) && pool.Lease(second, 1000));
+            TEST_CHECK(first != 1 && second != 1);
+            pool.Return(first, InstancePool::Usage());
+            pool.Return(second, InstancePool::Usage());
+        }
+
+        TEST_CHECK(factory.WasCalledRight());
+    }
+
+
+    // A lease waits while the instances cannot be started, and gets one once they can
+    void TestCreateFailure()
+    {
+        FakeFactory factory;
+        factory.SetFailing(true);
+        {
+            InstancePool::Options options;
+            InstancePool pool(factory, options);
+
+            InstanceId id = 0;
+            TEST_CHECK(!pool.Lease(id, 100));
+            TEST_CHECK(pool.GetStats().createFailures >= 1);
+
+            factory.SetFailing(false);
+            TEST_CHECK(pool.Lease(id, 3000));
+            pool.Return(id, InstancePool::Usage());
+        }
+
+        TEST_CHECK(factory.CountAlive() == 0);
+    }
+
+
+    // The instance returned by one thread is leased by another, waiting for it
+    struct Returner
+    {
+        InstancePool *pool;
+        InstanceId    id;
+
+        static void Run(void *context)
+        {
+            Returner *returner = static_cast<Returner*>(context);
+            Thread::Sleep(50);
+            returner->pool->Return(returner->id, InstancePool::Usage());
+        }
+    };
+
+    void TestWaitingLease()
+    {
+        FakeFactory factory;
+        InstancePool::Options options;
+        InstancePool pool(factory, options);
+
+        Returner returner = { &pool, 0 };
+        TEST_CHECK(pool.Lease(returner.id, 1000));
+
+        Thread thread;
+        TEST_CHECK(thread.Start(Returner::Run, &returner));
+
+        InstanceId id = 0;
+        TEST_CHECK(pool.Lease(id, 2000) && id == returner.id);
+        thread.Join();
+
+        pool.Return(id, InstancePool::Usage());
+    }
+}
+
+
+int main()
+{
+    TestLease();
+    TestRecycle();
+    TestCheck();
+    TestCreateFailure();
+    TestWaitingLease();
+
+    return TestResult("InstancePoolTest");
+}
@@ -0,0 +1,159 @@
+﻿/*!
+* @file    NativeRoundTripTest.cpp
+* @brief   Test of XlsxStreamWriter and ExcelFileReader together: rows written to .xlsx and .xlsb are read back
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ExcelFileReader.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheetSet.h"
+#include "ExcelWorksheet.h"
+#include "ExcelRange.h"
+#include "ExcelRowQuery.h"
+#include "ExcelWriteBatch.h"
+#include "XlsxStreamWriter.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    const int Columns = 30;     // A to AD
+
+    typedef std::vector<std::vector<ELstring> > Values;
+
+    ELstring Text(const char *text)
+    {
+        return ELstring(text, text + std::char_traits<char>::length(text));
+    }
+
+    // Rows of numbers, strings with the characters XML escapes and empty cells; row 3 is empty
+    Values MakeRows(int sheet)
+    {
+        const char *strings[] = { "a < b", "Tom & Jerry", "\"quoted\"", "it's > 0", "  padded  ", "line\tbreak" };
+
+        Values rows(6, std::vector<ELstring>(Columns));
+        for (int i = 0; i < static_cast<int>(rows.size()); ++i)
+        {
+            if (i == 2)
+                continue;
+
+            for (int j = 0; j < Columns; ++j)
+            {
+                char text[64];
+                switch ((i + j) % 5)
+                {
+                case 0:
+                    std::sprintf(text, "%d", (sheet * 100 + i) * Columns - j);
+                    break;
+                case 1:
+                    std::sprintf(text, "%g", (i + 1) * 0.125 + j);
+                    break;
+                case 2:
+                    text[0] = '\0';
+                    break;
+                default:
+                    std::sprintf(text, "%s %d", strings[(i * Columns + j) % 6], sheet);
+                    break;
+                }
+                rows[i][j] = Text(text);
+            }
+        }
+
+        return rows;
+    }
+
+    bool Write(const char *filename)
+    {
+        XlsxStreamWriter writer = XlsxStreamWriter::Create(Text(filename));
+        if (writer.IsNull())
+            return false;
+
+        for (int sheet = 1; sheet <= 2; ++sheet)
+        {
+            char name[32];
+            std::sprintf(name, "Round & Trip %d", sheet);
+            if (!writer.AddWorksheet(Text(name)))
+                return false;
+
+            Values rows = MakeRows(sheet);
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                if (!writer.WriteRow(rows[i]))
+                    return false;
+            }
+        }
+
+        return writer.Close();
+    }
+
+    // Read back the file, lazily (by a query) or in full (by ranges)
+    void Check(const char *filename, bool preload)
+    {
+        ExcelWorkbook workbook = preload ? ExcelFileReader::Open(Text(filename), 1) :
+            ExcelFileReader::Open(Text(filename));
+        TEST_CHECK(!workbook.IsNull());
+        if (workbook.IsNull())
+            return;
+
+        ExcelWorksheetSet sheets = workbook.GetAllWorksheets();
+        TEST_CHECK(sheets.CountWorksheets() == 2);
+
+        for (int sheet = 1; sheet <= 2 && sheet <= sheets.CountWorksheets(); ++sheet)
+        {
+            ExcelWorksheet worksheet = sheets.GetWorksheet(sheet);
+            Values expected = MakeRows(sheet);
+
+            char name[32];
+            std::sprintf(name, "Round & Trip %d", sheet);
+            TEST_CHECK(worksheet.GetName() == Text(name));
+
+            // the empty row is left out
+            Values values;
+            std::vector<int> rowNumbers;
+            TEST_CHECK(worksheet.ReadRows(ExcelRowQuery().Select(1, Columns), values, &rowNumbers));
+            TEST_CHECK(values.size() == expected.size() - 1 && rowNumbers.size() == values.size());
+            for (size_t i = 0; i < values.size() && i < rowNumbers.size(); ++i)
+            {
+                TEST_CHECK(rowNumbers[i] == static_cast<int>(i < 2 ? i + 1 : i + 2));
+                TEST_CHECK(values[i] == expected[rowNumbers[i] - 1]);
+            }
+
+            Values range;
+            TEST_CHECK(worksheet.GetRange(ELtext('A'), ELtext('F'), 1, 6).ReadData(range));
+            TEST_CHECK(range.size() == expected.size());
+            for (size_t i = 0; i < range.size() && i < expected.size(); ++i)
+                TEST_CHECK(range[i] == std::vector<ELstring>(expected[i].begin(), expected[i].begin() + 6));
+        }
+
+        // the worksheets are read-only: a batch fails to commit, and drops its cells
+        ExcelWriteBatch batch(sheets.GetWorksheet(1));
+        TEST_CHECK(batch.SetValue(ELtext('A'), 1, 1));
+        TEST_CHECK(!batch.Commit());
+        TEST_CHECK(batch.CountPending() == 0);
+    }
+}
+
+
+int main()
+{
+    const char *filenames[] = { "NativeRoundTripTest.xlsx", "NativeRoundTripTest.xlsb" };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        TEST_CHECK(Write(filenames[i]));
+        Check(filenames[i], false);
+        Check(filenames[i], true);
+        std::remove(filenames[i]);
+    }
+
+    return TestResult("NativeRoundTripTest");
+}
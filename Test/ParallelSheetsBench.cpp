@@ -0,0 +1,165 @@
+﻿/*!
+* @file    ParallelSheetsBench.cpp
+* @brief   Benchmark of ExcelFileReader reading the worksheets of a 16-sheet workbook with 1 to 16 threads
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "ExcelFileReader.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheetSet.h"
+#include "ExcelWorksheet.h"
+#include "ExcelRange.h"
+#include "XlsxStreamWriter.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    const int  Sheets = 16;
+    const int  Rows = 5000;
+    const int  Columns = 10;        // A to J
+    const char Filename[] = "ParallelSheetsBench.xlsx";
+
+    ELstring Text(const char *text)
+    {
+        return ELstring(text, text + std::char_traits<char>::length(text));
+    }
+
+    // A report-like worksheet: numbers, shared labels and unique strings
+    bool WriteWorkbook()
+    {
+        XlsxStreamWriter writer = XlsxStreamWriter::Create(Text(Filename));
+        if (writer.IsNull())
+            return false;
+
+        std::vector<ELstring> row(Columns);
+        for (int sheet = 0; sheet < Sheets; ++sheet)
+        {
+            char text[64];
+            std::sprintf(text, "Sheet%d", sheet + 1);
+            if (!writer.AddWorksheet(Text(text)))
+                return false;
+
+            for (int i = 0; i < Rows; ++i)
+            {
+                for (int j = 0; j < Columns; ++j)
+                {
+                    switch (j % 3)
+                    {
+                    case 0:
+                        std::sprintf(text, "%d", (sheet * Rows + i) * Columns + j);
+                        break;
+                    case 1:
+                        std::sprintf(text, "%.3f", (i + 1) * 0.37 + sheet);
+                        break;
+                    default:
+                        std::sprintf(text, (j == 2) ? "Region %d" : "Item %d of sheet %d", i % 50, sheet);
+                        break;
+                    }
+                    row[j] = Text(text);
+                }
+
+                if (!writer.WriteRow(row))
+                    return false;
+            }
+        }
+
+        return writer.Close();
+    }
+
+    // The cells of all the worksheets, to check that every thread count reads the same
+    bool ReadAll(ExcelWorkbook &workbook, std::vector<ELstring> &data)
+    {
+        ExcelWorksheetSet sheets = workbook.GetAllWorksheets();
+        if (sheets.IsNull() || sheets.CountWorksheets() != Sheets)
+            return false;
+
+        data.assign(Sheets, ELstring());
+        for (int i = 0; i < Sheets; ++i)
+        {
+            ExcelWorksheet sheet = sheets.GetWorksheet(i + 1);
+            ExcelRange range = sheet.GetRange(ELtext('A'), ELtext('A') + Columns - 1, 1, Rows);
+            if (range.IsNull() || !range.ReadData(data[i]))
+                return false;
+        }
+
+        return true;
+    }
+}
+
+
+int main()
+{
+    if (!WriteWorkbook())
+    {
+        std::printf("ParallelSheetsBench: cannot write %s\n", Filename);
+        return 1;
+    }
+
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+    const int rounds = 4;
+
+    std::printf("ParallelSheetsBench: %d sheets x %d x %d cells, %ld processor(s)\n", Sheets, Rows, Columns,
+        sysconf(_SC_NPROCESSORS_ONLN));
+
+    std::vector<ELstring> expected;
+    double serialTime = 0;
+    int result = 0;
+
+    for (size_t k = 0; k < sizeof(threadCounts) / sizeof(threadCounts[0]) && result == 0; ++k)
+    {
+        // the first round checks the cells and warms up the page cache, the best of the others is reported
+        double best = 0;
+        for (int round = 0; round < rounds; ++round)
+        {
+            Stopwatch watch;
+            ExcelWorkbook workbook = ExcelFileReader::Open(Text(Filename), threadCounts[k]);
+            double seconds = watch.Seconds();
+
+            if (round > 0)
+            {
+                if (round == 1 || seconds < best)
+                    best = seconds;
+                continue;
+            }
+
+            std::vector<ELstring> data;
+            if (workbook.IsNull() || !ReadAll(workbook, data))
+            {
+                std::printf("ParallelSheetsBench: cannot read %s with %d thread(s)\n", Filename, threadCounts[k]);
+                result = 1;
+                break;
+            }
+
+            if (expected.empty())
+                expected.swap(data);
+            else if (data != expected)
+            {
+                std::printf("ParallelSheetsBench: %d thread(s) read other cells than 1 thread\n", threadCounts[k]);
+                result = 1;
+                break;
+            }
+        }
+
+        if (result != 0)
+            break;
+
+        if (k == 0)
+            serialTime = best;
+
+        std::printf("  %2d thread(s)  %8.2f ms  (%.2fx)\n", threadCounts[k], best * 1e3, serialTime / best);
+    }
+
+    std::remove(Filename);
+    return result;
+}
@@ -0,0 +1,170 @@
+﻿/*!
+* @file    PerformanceScopeTest.cpp
+* @brief   Test of ExcelPerformanceScope, on the fake Excel objects
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <stdexcept>
+
+#include "ExcelApplication.h"
+#include "ExcelWorkbook.h"
+#include "ExcelPerformanceScope.h"
+#include "ComUtil.h"
+#include "ComStandIn.h"
+#include "FakeExcel.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+using namespace ComStandIn;
+
+
+namespace
+{
+    const long xlCalculationAutomatic = -4105;
+    const long xlCalculationManual = -4135;
+    const long xlCalculationSemiautomatic = 2;
+
+
+    // Whether the fake application is in the performance mode
+    bool IsFast(const FakeApplication *pApp)
+    {
+        return !pApp->ScreenUpdating() && !pApp->EnableEvents() && pApp->Calculation() == xlCalculationManual;
+    }
+
+
+    // The settings come back when the scope is left by an exception
+    void TestRestoreOnException(ExcelApplication app, FakeApplication *pApp)
+    {
+        bool caught = false;
+        try
+        {
+            ExcelPerformanceScope scope(app, true);
+            TEST_CHECK(scope.Succeeded());
+            TEST_CHECK(IsFast(pApp));
+
+            throw std::runtime_error("failed in the scope");
+        }
+        catch (const std::runtime_error &)
+        {
+            caught = true;
+        }
+
+        TEST_CHECK(caught);
+        TEST_CHECK(pApp->ScreenUpdating());
+        TEST_CHECK(pApp->EnableEvents());
+        TEST_CHECK(pApp->Calculation() == xlCalculationAutomatic);
+        TEST_CHECK(pApp->CountCalculates() == 1);
+    }
+
+
+    // Only the outermost scope restores, and the recalculation asked by an inner scope happens once at its exit
+    void TestNested(ExcelApplication app, FakeApplication *pApp)
+    {
+        int calculates = pApp->CountCalculates();
+
+        {
+            ExcelPerformanceScope outer(app);
+            {
+                ExcelPerformanceScope inner(app, true);
+                TEST_CHECK(inner.Succeeded());
+                TEST_CHECK(IsFast(pApp));
+            }
+
+            TEST_CHECK(IsFast(pApp));
+            TEST_CHECK(pApp->CountCalculates() == calculates);
+        }
+
+        TEST_CHECK(pApp->ScreenUpdating() && pApp->EnableEvents());
+        TEST_CHECK(pApp->Calculation() == xlCalculationAutomatic);
+        TEST_CHECK(pApp->CountCalculates() == calculates + 1);
+
+        // no recalculation unless asked
+        {
+            ExcelPerformanceScope scope(app);
+        }
+        TEST_CHECK(pApp->CountCalculates() == calculates + 1);
+    }
+
+
+    // The settings found on enter are restored, not the defaults
+    void TestSavedSettings(ExcelApplication app, FakeApplication *pApp)
+    {
+        TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pApp, NULL, DISPATCH_PROPERTYPUT, OLESTR("EnableEvents"), NULL, false)));
+        TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pApp, NULL, DISPATCH_PROPERTYPUT, OLESTR("Calculation"), NULL,
+            xlCalculationSemiautomatic)));
+
+        {
+            ExcelPerformanceScope scope(app);
+            TEST_CHECK(IsFast(pApp));
+        }
+
+        TEST_CHECK(pApp->ScreenUpdating());
+        TEST_CHECK(!pApp->EnableEvents());
+        TEST_CHECK(pApp->Calculation() == xlCalculationSemiautomatic);
+
+        TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pApp, NULL, DISPATCH_PROPERTYPUT, OLESTR("EnableEvents"), NULL, true)));
+        TEST_CHECK(SUCCEEDED(ComUtil::Invoke(pApp, NULL, DISPATCH_PROPERTYPUT, OLESTR("Calculation"), NULL,
+            xlCalculationAutomatic)));
+    }
+
+
+    // Calculation cannot be read (no workbook is open): the scope reports it, and restores the other settings
+    void TestCalculationUnavailable(ExcelApplication app, FakeApplication *pApp)
+    {
+        pApp->SetFailing(L"Calculation");
+
+        {
+            ExcelPerformanceScope scope(app);
+            TEST_CHECK(!scope.Succeeded());
+            TEST_CHECK(!pApp->ScreenUpdating() && !pApp->EnableEvents());
+        }
+
+        TEST_CHECK(pApp->ScreenUpdating() && pApp->EnableEvents());
+        TEST_CHECK(pApp->Calculation() == xlCalculationAutomatic);
+
+        pApp->SetFailing(L"Calculation", false);
+    }
+
+
+    // The application is shut down in the scope: nothing is left to restore
+    void TestShutdownInScope(ExcelApplication app, FakeApplication *pApp)
+    {
+        {
+            ExcelPerformanceScope scope(app, true);
+            TEST_CHECK(app.Shutdown());
+        }
+
+        TEST_CHECK(pApp->HasQuit());
+        TEST_CHECK(!app.IsRunning());
+    }
+}
+
+
+int main()
+{
+    FakeApplication *pApp = new FakeApplication;
+    SetInstance(pApp);
+
+    ExcelApplication app;
+    TEST_CHECK(app.Startup());
+    ExcelWorkbook workbook = app.CreateWorkbook(ELtext("book.xlsx"));
+    TEST_CHECK(!workbook.IsNull());
+
+    TestRestoreOnException(app, pApp);
+    TestNested(app, pApp);
+    TestSavedSettings(app, pApp);
+    TestCalculationUnavailable(app, pApp);
+
+    workbook.Close();
+    TestShutdownInScope(app, pApp);
+
+    SetInstance(NULL);
+    pApp->Release();
+
+    TEST_CHECK(CountStrings() == 0);
+
+    return TestResult("PerformanceScopeTest");
+}
@@ -0,0 +1,152 @@
+﻿/*!
+* @file    RangeCodecBench.cpp
+* @brief   Benchmark of ExcelRange::DecodeData() against the stream decoder it replaced
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ExcelRange.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    typedef std::vector<std::vector<ELstring> > Values;
+
+    /*!
+    * @brief The decoder used before RangeCodec: a string stream read one character at a time
+    */
+    bool StreamDecodeData(const ELstring &data, Values &values)
+    {
+        std::basic_istringstream<ELchar> iss(data);
+        iss >> std::noskipws;
+
+        int row = 0;
+        int column = 0;
+        ELchar dumb;
+
+        iss >> row >> dumb;
+        iss >> column >> dumb;
+
+        if (row <= 0 || column <= 0)
+            return false;
+
+        Values(row, std::vector<ELstring>(column, ELstring())).swap(values);
+
+        bool validState = true;
+
+        for (int i = 0; validState && i < row; ++i)
+        {
+            for (int j = 0; validState && j < column; ++j)
+            {
+                int count = 0;
+                iss >> count >> dumb;
+
+                validState = iss.good() && (count >= 0);
+
+                ELstring curValue;
+                for (int k = 0; k < count; ++k)
+                {
+                    ELchar ch;
+                    iss >> ch;
+                    curValue.push_back(ch);
+                }
+
+                validState = validState && iss.good();
+
+                if (validState)
+                    values[i][j] = curValue;
+            }
+        }
+
+        return validState;
+    }
+
+    // A report-like range: numbers, dates, short labels and some empty cells
+    Values MakeValues(int rows, int columns)
+    {
+        Values values(rows, std::vector<ELstring>(columns));
+
+        for (int i = 0; i < rows; ++i)
+        {
+            for (int j = 0; j < columns; ++j)
+            {
+                char text[32];
+                switch (j % 4)
+                {
+                case 0:
+                    std::sprintf(text, "%d", i * columns + j);
+                    break;
+                case 1:
+                    std::sprintf(text, "%.4f", (i + 1) * 0.37 + j);
+                    break;
+                case 2:
+                    std::sprintf(text, "Item %d of group %d", i, j);
+                    break;
+                default:
+                    text[0] = '\0';
+                    break;
+                }
+
+                values[i][j].assign(text, text + std::char_traits<char>::length(text));
+            }
+        }
+
+        return values;
+    }
+
+    template <class TDecode>
+    double Measure(TDecode decode, const ELstring &data, Values &values, int rounds)
+    {
+        Stopwatch watch;
+        for (int k = 0; k < rounds; ++k)
+        {
+            bool ok = decode(data, values);
+            assert(ok);
+            (void)ok;
+        }
+
+        return watch.Seconds() / rounds;
+    }
+}
+
+
+int main()
+{
+    const int rows = 2000;
+    const int columns = 100;    // 200k cells
+    const int rounds = 5;
+
+    ELstring data = ExcelRange::EncodeData(MakeValues(rows, columns));
+    double megabytes = data.size() * sizeof(ELchar) / (1024.0 * 1024.0);
+
+    Values streamValues;
+    Values pointerValues;
+    double streamTime = Measure(StreamDecodeData, data, streamValues, rounds);
+    double pointerTime = Measure(ExcelRange::DecodeData, data, pointerValues, rounds);
+
+    if (streamValues != pointerValues)
+    {
+        std::printf("RangeCodecBench: the two decoders disagree\n");
+        return 1;
+    }
+
+    const double cells = static_cast<double>(rows) * columns;
+    std::printf("RangeCodecBench: %d x %d cells, %.1f MB encoded\n", rows, columns, megabytes);
+    std::printf("  stream decoder   %8.2f ms  %7.1f ns/cell  %7.1f MB/s\n",
+        streamTime * 1e3, streamTime * 1e9 / cells, megabytes / streamTime);
+    std::printf("  pointer decoder  %8.2f ms  %7.1f ns/cell  %7.1f MB/s  (%.1fx)\n",
+        pointerTime * 1e3, pointerTime * 1e9 / cells, megabytes / pointerTime, streamTime / pointerTime);
+
+    return 0;
+}
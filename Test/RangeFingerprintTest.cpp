@@ -0,0 +1,162 @@
+﻿/*!
+* @file    RangeFingerprintTest.cpp
+* @brief   Test of RangeFingerprint, which finds the cells changed since a range was last read or written
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <string>
+#include <vector>
+
+#include "RangeFingerprint.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    ELstring Text(const char *text)
+    {
+        return ELstring(text, text + std::char_traits<char>::length(text));
+    }
+
+    // The encoded string of a range, the values given row by row
+    ELstring Encode(int rows, int columns, const char *const *values)
+    {
+        ELstring data;
+        RangeCodec::AppendNumber(data, rows);
+        RangeCodec::AppendNumber(data, columns);
+        for (int i = 0; i < rows * columns; ++i)
+        {
+            ELstring value = Text(values[i]);
+            RangeCodec::AppendValue(data, value.data(), value.size());
+        }
+        return data;
+    }
+
+    bool Compare(const RangeFingerprint &old, const ELstring &data, RangeFingerprint &next,
+        std::vector<CellPos> &positions, std::vector<RangeFingerprint::ChangedCell> &cells)
+    {
+        return old.Compare(data.data(), data.size(), next, positions, cells);
+    }
+
+
+    void TestChanges()
+    {
+        const char *before[] = { "1", "two", "", "4.5", "five", "6" };
+        const char *after[]  = { "1", "Two", "", "4.5", "", "x" };
+
+        ELstring data = Encode(2, 3, before);
+        RangeFingerprint fingerprint;
+        TEST_CHECK(fingerprint.IsEmpty());
+        TEST_CHECK(fingerprint.Assign(data.data(), data.size()));
+        TEST_CHECK(!fingerprint.IsEmpty());
+
+        // the same values: nothing changed
+        RangeFingerprint next;
+        std::vector<CellPos> positions;
+        std::vector<RangeFingerprint::ChangedCell> cells;
+        TEST_CHECK(Compare(fingerprint, data, next, positions, cells));
+        TEST_CHECK(positions.empty() && cells.empty());
+
+        // a changed case, a cleared cell and a new value, found row by row
+        ELstring changed = Encode(2, 3, after);
+        TEST_CHECK(Compare(fingerprint, changed, next, positions, cells));
+        TEST_CHECK(positions.size() == 3 && cells.size() == 3);
+        if (positions.size() == 3 && cells.size() == 3)
+        {
+            TEST_CHECK(positions[0].row == 0 && positions[0].column == 1);
+            TEST_CHECK(positions[1].row == 1 && positions[1].column == 1);
+            TEST_CHECK(positions[2].row == 1 && positions[2].column == 2);
+
+            // the values refer into the encoded string
+            TEST_CHECK(ELstring(cells[0].value, cells[0].length) == Text("Two"));
+            TEST_CHECK(cells[1].length == 0);
+            TEST_CHECK(ELstring(cells[2].value, cells[2].length) == Text("x"));
+            TEST_CHECK(cells[2].value >= changed.data() && cells[2].value < changed.data() + changed.size());
+        }
+
+        // the next fingerprint is the one of the new values
+        TEST_CHECK(Compare(next, changed, fingerprint, positions, cells));
+        TEST_CHECK(positions.empty());
+        TEST_CHECK(Compare(next, data, fingerprint, positions, cells));
+        TEST_CHECK(positions.size() == 3);
+    }
+
+
+    void TestMismatch()
+    {
+        const char *values[] = { "a", "b", "c", "d", "e", "f" };
+
+        RangeFingerprint fingerprint;
+        ELstring data = Encode(2, 3, values);
+        TEST_CHECK(fingerprint.Assign(data.data(), data.size()));
+
+        // another size of range cannot be compared
+        RangeFingerprint next;
+        std::vector<CellPos> positions;
+        std::vector<RangeFingerprint::ChangedCell> cells;
+        TEST_CHECK(!Compare(fingerprint, Encode(3, 2, values), next, positions, cells));
+        TEST_CHECK(!Compare(fingerprint, Encode(1, 3, values), next, positions, cells));
+
+        // dirty data
+        ELstring dirty = data.substr(0, data.size() - 1);
+        TEST_CHECK(!Compare(fingerprint, dirty, next, positions, cells));
+        TEST_CHECK(!next.Assign(dirty.data(), dirty.size()));
+        TEST_CHECK(next.IsEmpty());
+
+        // a dirty string clears the fingerprint it was assigned to
+        TEST_CHECK(!fingerprint.Assign(dirty.data(), dirty.size()));
+        TEST_CHECK(fingerprint.IsEmpty());
+    }
+
+
+    void TestSwapAndClear()
+    {
+        const char *values[] = { "1", "2" };
+        ELstring data = Encode(1, 2, values);
+
+        RangeFingerprint fingerprint;
+        RangeFingerprint other;
+        TEST_CHECK(fingerprint.Assign(data.data(), data.size()));
+
+        fingerprint.Swap(other);
+        TEST_CHECK(fingerprint.IsEmpty() && !other.IsEmpty());
+
+        RangeFingerprint next;
+        std::vector<CellPos> positions;
+        std::vector<RangeFingerprint::ChangedCell> cells;
+        TEST_CHECK(Compare(other, data, next, positions, cells) && positions.empty());
+
+        other.Clear();
+        TEST_CHECK(other.IsEmpty());
+    }
+
+
+    void TestHash()
+    {
+        // 64-bit FNV-1a
+        TEST_CHECK(RangeFingerprint::Hash(NULL, 0) == 14695981039346656037ULL);
+
+        ELstring a = Text("a");
+        TEST_CHECK(RangeFingerprint::Hash(a.data(), a.size()) == 0xAF63DC4C8601EC8CULL);
+
+        ELstring ab = Text("ab");
+        ELstring ba = Text("ba");
+        TEST_CHECK(RangeFingerprint::Hash(ab.data(), ab.size()) != RangeFingerprint::Hash(ba.data(), ba.size()));
+    }
+}
+
+
+int main()
+{
+    TestChanges();
+    TestMismatch();
+    TestSwapAndClear();
+    TestHash();
+
+    return TestResult("RangeFingerprintTest");
+}
@@ -0,0 +1,98 @@
+﻿/*!
+* @file    RangeViewTest.cpp
+* @brief   Test of ExcelRangeView
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include "ExcelRangeView.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    bool Equals(const ExcelStringRef &value, const ELchar *expected)
+    {
+        return value.ToString() == expected;
+    }
+
+    // A value which ends by digits, an empty one, and one which holds the delimiter
+    void TestValues()
+    {
+        ELstring data(ELtext("2#3#2#12") ELtext("0#") ELtext("3#a#b") ELtext("1#7") ELtext("2#10") ELtext("1##"));
+
+        ExcelRangeView view;
+        TEST_CHECK(view.CountRows() == 0 && view.CountColumns() == 0);
+
+        TEST_CHECK(ExcelRangeView::Decode(data, view));
+        TEST_CHECK(data.empty());
+        TEST_CHECK(view.CountRows() == 2 && view.CountColumns() == 3);
+
+        TEST_CHECK(Equals(view.GetValue(0, 0), ELtext("12")));
+        TEST_CHECK(Equals(view.GetValue(0, 1), ELtext("")) && view.GetValue(0, 1).length == 0);
+        TEST_CHECK(Equals(view.GetValue(0, 2), ELtext("a#b")));
+        TEST_CHECK(Equals(view.GetValue(1, 0), ELtext("7")));
+        TEST_CHECK(Equals(view.GetValue(1, 1), ELtext("10")));
+        TEST_CHECK(Equals(view.GetValue(1, 2), ELtext("#")));
+
+        // a copy shares the buffer, which outlives the first view
+        ExcelRangeView copy(view);
+        view = ExcelRangeView();
+        TEST_CHECK(Equals(copy.GetValue(0, 2), ELtext("a#b")));
+    }
+
+    // A long prefix, and the first value after a header of several digits
+    void TestLongValue()
+    {
+        ELstring value(1234, ELtext('x'));
+        ELstring data(ELtext("10#1#"));
+        data += ELtext("1234#") + value;
+        for (int i = 1; i < 10; ++i)
+            data += ELtext("1#") + ELstring(1, static_cast<ELchar>(ELtext('0') + i));
+
+        ExcelRangeView view;
+        TEST_CHECK(ExcelRangeView::Decode(data, view));
+        TEST_CHECK(view.CountRows() == 10 && view.CountColumns() == 1);
+        TEST_CHECK(view.GetValue(0, 0).length == 1234 && view.GetValue(0, 0).ToString() == value);
+        TEST_CHECK(Equals(view.GetValue(9, 0), ELtext("9")));
+    }
+
+    // A string which is not a whole range fails, and is left as it was
+    void TestDecodeFailure()
+    {
+        const ELchar *bad[] =
+        {
+            ELtext(""),
+            ELtext("abc"),
+            ELtext("0#1#"),             // no row
+            ELtext("1#0#"),             // no column
+            ELtext("1#2#1#a"),          // a value is missing
+            ELtext("1#1#5#abc"),        // truncated value
+            ELtext("1#1#x#a"),          // no length prefix
+            ELtext("1#1#99999999999#a") // the length overflows
+        };
+
+        for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+        {
+            ELstring data(bad[i]);
+            ExcelRangeView view;
+            TEST_CHECK(!ExcelRangeView::Decode(data, view));
+            TEST_CHECK(data == bad[i]);
+            TEST_CHECK(view.IsNull() && view.CountRows() == 0);
+        }
+    }
+}
+
+
+int main()
+{
+    TestValues();
+    TestLongValue();
+    TestDecodeFailure();
+
+    return TestResult("RangeViewTest");
+}
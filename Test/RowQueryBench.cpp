@@ -0,0 +1,212 @@
+﻿/*!
+* @file    RowQueryBench.cpp
+* @brief   Benchmark of ExcelWorksheet::ReadRows() on a workbook file: filtering in the parser against
+*          filtering a worksheet read in full
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ExcelFileReader.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheet.h"
+#include "ExcelRowQuery.h"
+#include "XlsxStreamWriter.h"
+#include "ZipArchive.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    // The memory allocated by the program, now and at most since ResetPeak()
+    size_t s_current = 0;
+    size_t s_peak = 0;
+
+    // Every block has a header with its size, so that it is known when the block is freed
+    const size_t HeaderSize = 16;
+}
+
+
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+    char *p = static_cast<char*>(std::malloc(size + HeaderSize));
+    if (!p)
+        throw std::bad_alloc();
+
+    *reinterpret_cast<size_t*>(p) = size;
+    s_current += size;
+    if (s_current > s_peak)
+        s_peak = s_current;
+
+    return p + HeaderSize;
+}
+
+
+// Not inlined, or GCC warns that the memory of a new expression is given to free()
+__attribute__((noinline)) void operator delete(void *p) throw()
+{
+    if (!p)
+        return;
+
+    char *block = static_cast<char*>(p) - HeaderSize;
+    s_current -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+
+namespace
+{
+    const int  Rows = 4000;
+    const int  Columns = 120;
+    const char Filename[] = "RowQueryBench.xlsx";
+
+    typedef std::vector<std::vector<ELstring> > Values;
+
+    ELstring Text(const char *text)
+    {
+        return ELstring(text, text + std::char_traits<char>::length(text));
+    }
+
+    // Column 1 is the row number modulo 100, the others mix numbers and strings
+    bool WriteWorkbook()
+    {
+        XlsxStreamWriter writer = XlsxStreamWriter::Create(Text(Filename));
+        if (writer.IsNull() || !writer.AddWorksheet(Text("Data")))
+            return false;
+
+        std::vector<ELstring> row(Columns);
+        for (int i = 0; i < Rows; ++i)
+        {
+            for (int j = 0; j < Columns; ++j)
+            {
+                char text[64];
+                if (j == 0)
+                    std::sprintf(text, "%d", i % 100);
+                else if (j % 3 == 1)
+                    std::sprintf(text, "%d", i * Columns + j);
+                else if (j % 3 == 2)
+                    std::sprintf(text, "%.4f", (i + 1) * 0.37 + j);
+                else
+                    std::sprintf(text, "Text %d-%d", j, i % 200);
+                row[j] = Text(text);
+            }
+
+            if (!writer.WriteRow(row))
+                return false;
+        }
+
+        return writer.Close();
+    }
+
+    // 5 of the 120 columns, of the rows whose column 1 is less than 5 (5 % of them)
+    ExcelRowQuery MakeQuery()
+    {
+        return ExcelRowQuery().Select(2).Select(30).Select(60).Select(90).Select(120)
+            .Where(1, ECO_Less, Text("5"));
+    }
+
+    struct Measure
+    {
+        double seconds;
+        size_t peakBytes;
+    };
+
+    // Open the workbook and run the query; with preload, the worksheet is read in full first
+    bool Run(bool preload, Values &values, Measure &measure)
+    {
+        size_t before = s_current;
+        s_peak = s_current;
+        Stopwatch watch;
+
+        {
+            ExcelWorkbook workbook = preload ? ExcelFileReader::Open(Text(Filename), 1) :
+                ExcelFileReader::Open(Text(Filename));
+            if (workbook.IsNull())
+                return false;
+
+            ExcelWorksheet sheet = workbook.GetActiveWorksheet();
+            if (sheet.IsNull() || !sheet.ReadRows(MakeQuery(), values))
+                return false;
+        }
+
+        measure.seconds = watch.Seconds();
+        measure.peakBytes = s_peak - before;
+        return true;
+    }
+}
+
+
+int main()
+{
+    if (!WriteWorkbook())
+    {
+        std::printf("RowQueryBench: cannot write %s\n", Filename);
+        return 1;
+    }
+
+    // the size of the worksheet XML which the parser goes through
+    double megabytes = 0;
+    {
+        ZipArchive archive;
+        const ZipArchive::Entry *entry = archive.Open(Text(Filename)) ?
+            archive.FindEntry("xl/worksheets/sheet1.xml") : NULL;
+        if (entry == NULL)
+        {
+            std::printf("RowQueryBench: cannot find the worksheet in %s\n", Filename);
+            return 1;
+        }
+        megabytes = entry->size / (1024.0 * 1024.0);
+    }
+
+    const int rounds = 3;
+    Measure full = { 0, 0 };
+    Measure pushed = { 0, 0 };
+    Values fullValues;
+    Values pushedValues;
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        Measure measure;
+        if (!Run(true, fullValues, measure))
+        {
+            std::printf("RowQueryBench: cannot read %s\n", Filename);
+            return 1;
+        }
+        if (round == 0 || measure.seconds < full.seconds)
+            full = measure;
+
+        if (!Run(false, pushedValues, measure))
+        {
+            std::printf("RowQueryBench: cannot query %s\n", Filename);
+            return 1;
+        }
+        if (round == 0 || measure.seconds < pushed.seconds)
+            pushed = measure;
+    }
+
+    if (fullValues != pushedValues || fullValues.size() != Rows / 20 || fullValues[0].size() != 5)
+    {
+        std::printf("RowQueryBench: the two reads disagree\n");
+        return 1;
+    }
+
+    std::printf("RowQueryBench: %d x %d cells, %.1f MB of worksheet XML, 5 columns of %d rows selected\n",
+        Rows, Columns, megabytes, static_cast<int>(fullValues.size()));
+    std::printf("  read in full, then filtered  %8.2f ms  %7.1f MB/s  peak %7.1f MB\n",
+        full.seconds * 1e3, megabytes / full.seconds, full.peakBytes / (1024.0 * 1024.0));
+    std::printf("  filtered in the parser       %8.2f ms  %7.1f MB/s  peak %7.1f MB  (%.1fx, %.1fx less memory)\n",
+        pushed.seconds * 1e3, megabytes / pushed.seconds, pushed.peakBytes / (1024.0 * 1024.0),
+        full.seconds / pushed.seconds, static_cast<double>(full.peakBytes) / pushed.peakBytes);
+
+    std::remove(Filename);
+    return 0;
+}
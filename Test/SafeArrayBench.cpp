@@ -0,0 +1,249 @@
+﻿/*!
+* @file    SafeArrayBench.cpp
+* @brief   Benchmark of the SAFEARRAY marshalling of ComUtil against the per-element one it replaced
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cassert>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "ComUtil.h"
+#include "ComStandIn.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    /*!
+    * @brief The encoder used before SafeArrayDim2Data: ::SafeArrayGetElement() and a string stream per cell
+    */
+    HRESULT ElementEncodeSafeArrayDim2(SAFEARRAY *psa, ELstring &encodedStr)
+    {
+        LONG rowFrom = 0;
+        LONG rowTo = 0;
+        LONG columnFrom = 0;
+        LONG columnTo = 0;
+
+        ::SafeArrayGetLBound(psa, 1, &rowFrom);
+        ::SafeArrayGetUBound(psa, 1, &rowTo);
+        ::SafeArrayGetLBound(psa, 2, &columnFrom);
+        ::SafeArrayGetUBound(psa, 2, &columnTo);
+
+        ELostringstream oss;
+        oss << (rowTo - rowFrom + 1) << ELtext('#') << (columnTo - columnFrom + 1) << ELtext('#');
+
+        for (LONG i = rowFrom; i <= rowTo; ++i)
+        {
+            for (LONG j = columnFrom; j <= columnTo; ++j)
+            {
+                VARIANT var;
+                HRESULT hr = ComUtil::GetSafeArrayElementDim2(psa, i, j, &var);
+                if (FAILED(hr))
+                    return hr;
+
+                hr = ::VariantChangeType(&var, &var, VARIANT_NOUSEROVERRIDE, VT_BSTR);
+                if (FAILED(hr))
+                    return hr;
+
+                ELstring str(var.bstrVal, ::SysStringLen(var.bstrVal));
+                ::VariantClear(&var);
+
+                oss << str.length() << ELtext('#') << str;
+            }
+        }
+
+        encodedStr = oss.str();
+        return S_OK;
+    }
+
+    /*!
+    * @brief The decoder used before SafeArrayDim2Data: a string stream and ::SafeArrayPutElement() per cell
+    */
+    SAFEARRAY* ElementDecodeSafeArrayDim2(const ELchar *data)
+    {
+        EListringstream iss(data);
+        iss >> std::noskipws;
+
+        int row = 0;
+        int column = 0;
+        ELchar dumb;
+
+        iss >> row >> dumb;
+        iss >> column >> dumb;
+
+        if (row <= 0 || column <= 0)
+            return NULL;
+
+        SAFEARRAYBOUND sab[2];
+        sab[0].lLbound = 1;
+        sab[0].cElements = row;
+        sab[1].lLbound = 1;
+        sab[1].cElements = column;
+
+        SAFEARRAY *psa = ::SafeArrayCreate(VT_VARIANT, 2, sab);
+        bool validState = (psa != NULL);
+
+        for (int i = 1; validState && i <= row; ++i)
+        {
+            for (int j = 1; validState && j <= column; ++j)
+            {
+                int count = 0;
+                iss >> count >> dumb;
+                validState = iss.good() && (count >= 0);
+
+                ELstring value;
+                for (int k = 0; k < count; ++k)
+                {
+                    ELchar ch;
+                    iss >> ch;
+                    value.push_back(ch);
+                }
+
+                validState = validState && iss.good();
+                if (validState)
+                    ComUtil::PutSafeArrayElementDim2(psa, i, j, value.c_str());
+            }
+        }
+
+        if (!validState && psa)
+        {
+            ::SafeArrayDestroy(psa);
+            psa = NULL;
+        }
+
+        return psa;
+    }
+
+    // A range as Excel returns it: numbers, short labels and some empty cells, based at 1
+    SAFEARRAY* MakeArray(int rows, int columns)
+    {
+        SAFEARRAYBOUND sab[2];
+        sab[0].lLbound = 1;
+        sab[0].cElements = rows;
+        sab[1].lLbound = 1;
+        sab[1].cElements = columns;
+
+        SAFEARRAY *psa = ::SafeArrayCreate(VT_VARIANT, 2, sab);
+        assert(psa);
+
+        for (int i = 1; i <= rows; ++i)
+        {
+            for (int j = 1; j <= columns; ++j)
+            {
+                wchar_t text[32];
+                switch (j % 4)
+                {
+                case 0:
+                    ComUtil::PutSafeArrayElementDim2(psa, i, j, i * columns + j);
+                    break;
+                case 1:
+                    ComUtil::PutSafeArrayElementDim2(psa, i, j, (i + 1) * 0.37 + j);
+                    break;
+                case 2:
+                    std::swprintf(text, 32, L"Item %d of group %d", i, j);
+                    ComUtil::PutSafeArrayElementDim2(psa, i, j, text);
+                    break;
+                default:
+                    break;  // left empty
+                }
+            }
+        }
+
+        return psa;
+    }
+
+    double MeasureEncode(HRESULT (*encode)(SAFEARRAY*, ELstring&), SAFEARRAY *psa, ELstring &data, int rounds)
+    {
+        Stopwatch watch;
+        for (int k = 0; k < rounds; ++k)
+        {
+            HRESULT hr = encode(psa, data);
+            assert(SUCCEEDED(hr));
+            (void)hr;
+        }
+
+        return watch.Seconds() / rounds;
+    }
+
+    double MeasureDecode(SAFEARRAY* (*decode)(const ELchar*), const ELstring &data, ELstring &check, int rounds)
+    {
+        Stopwatch watch;
+        for (int k = 0; k < rounds; ++k)
+        {
+            SAFEARRAY *psa = decode(data.c_str());
+            assert(psa);
+
+            // re-encoded only on the last round, to compare the two decoders
+            if (k == rounds - 1)
+            {
+                double elapsed = watch.Seconds();
+                ComUtil::EncodeSafeArrayDim2(psa, check);
+                ::SafeArrayDestroy(psa);
+                return elapsed / rounds;
+            }
+
+            ::SafeArrayDestroy(psa);
+        }
+
+        return watch.Seconds() / rounds;
+    }
+
+    void Report(const char *name, double seconds, double cells, double baseline)
+    {
+        std::printf("  %-20s %8.2f ms  %7.1f ns/cell", name, seconds * 1e3, seconds * 1e9 / cells);
+        if (baseline > 0)
+            std::printf("  (%.1fx)", baseline / seconds);
+        std::printf("\n");
+    }
+}
+
+
+int main()
+{
+    const int rows = 1000;
+    const int columns = 100;    // 100k cells
+    const int rounds = 5;
+
+    long strings = ComStandIn::CountStrings();
+    SAFEARRAY *psa = MakeArray(rows, columns);
+
+    ELstring elementData;
+    ELstring bulkData;
+    double elementEncode = MeasureEncode(ElementEncodeSafeArrayDim2, psa, elementData, rounds);
+    double bulkEncode = MeasureEncode(ComUtil::EncodeSafeArrayDim2, psa, bulkData, rounds);
+
+    ELstring elementCheck;
+    ELstring bulkCheck;
+    double elementDecode = MeasureDecode(ElementDecodeSafeArrayDim2, bulkData, elementCheck, rounds);
+    double bulkDecode = MeasureDecode(ComUtil::DecodeSafeArrayDim2, bulkData, bulkCheck, rounds);
+
+    ::SafeArrayDestroy(psa);
+
+    if (elementData != bulkData || elementCheck != bulkCheck || bulkCheck != bulkData)
+    {
+        std::printf("SafeArrayBench: the per-element and the bulk marshalling disagree\n");
+        return 1;
+    }
+
+    if (ComStandIn::CountStrings() != strings)
+    {
+        std::printf("SafeArrayBench: %ld BSTRs leaked\n", ComStandIn::CountStrings() - strings);
+        return 1;
+    }
+
+    const double cells = static_cast<double>(rows) * columns;
+    std::printf("SafeArrayBench: %d x %d VARIANTs, on the COM stand-in\n", rows, columns);
+    Report("per-element encode", elementEncode, cells, 0);
+    Report("bulk encode", bulkEncode, cells, elementEncode);
+    Report("per-element decode", elementDecode, cells, 0);
+    Report("bulk decode", bulkDecode, cells, elementDecode);
+
+    return 0;
+}
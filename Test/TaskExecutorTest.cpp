@@ -0,0 +1,341 @@
+﻿/*!
+* @file    TaskExecutorTest.cpp
+* @brief   Test of MpscQueue and TaskExecutor, with producers on several threads
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <vector>
+
+#include "MpscQueue.h"
+#include "TaskExecutor.h"
+#include "ThreadUtil.h"
+#include "AtomicsUtil.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    const int  Producers = 4;
+    const long ItemsPerProducer = 50000;
+
+
+    // <begin> MpscQueue
+
+    struct Item : MpscQueue::Node
+    {
+        int  producer;
+        long sequence;
+    };
+
+    struct QueueProducer
+    {
+        MpscQueue *queue;
+        Item      *items;
+
+        static void Run(void *context)
+        {
+            QueueProducer *producer = static_cast<QueueProducer*>(context);
+            for (long i = 0; i < ItemsPerProducer; ++i)
+                producer->queue->Push(&producer->items[i]);
+        }
+    };
+
+    void TestQueue()
+    {
+        MpscQueue queue;
+        TEST_CHECK(queue.Pop() == NULL);
+
+        // first in, first out; a popped node can be pushed again
+        Item items[3];
+        for (int i = 0; i < 3; ++i)
+            queue.Push(&items[i]);
+        TEST_CHECK(queue.Pop() == &items[0]);
+        queue.Push(&items[0]);
+        TEST_CHECK(queue.Pop() == &items[1]);
+        TEST_CHECK(queue.Pop() == &items[2]);
+        TEST_CHECK(queue.Pop() == &items[0]);
+        TEST_CHECK(queue.Pop() == NULL);
+
+        // every node of every producer is popped once, in the order of its producer
+        std::vector<Item> storage(Producers * ItemsPerProducer);
+        QueueProducer producers[Producers];
+        Thread threads[Producers];
+        for (int p = 0; p < Producers; ++p)
+        {
+            for (long i = 0; i < ItemsPerProducer; ++i)
+            {
+                storage[p * ItemsPerProducer + i].producer = p;
+                storage[p * ItemsPerProducer + i].sequence = i;
+            }
+
+            producers[p].queue = &queue;
+            producers[p].items = &storage[p * ItemsPerProducer];
+            TEST_CHECK(threads[p].Start(QueueProducer::Run, &producers[p]));
+        }
+
+        long next[Producers] = { 0 };
+        bool ordered = true;
+        for (long popped = 0; popped < Producers * ItemsPerProducer; )
+        {
+            // NULL may only mean that a push is not finished: try again
+            Item *item = static_cast<Item*>(queue.Pop());
+            if (item == NULL)
+            {
+                Thread::Sleep(0);
+                continue;
+            }
+
+            if (item->sequence != next[item->producer])
+                ordered = false;
+            next[item->producer] = item->sequence + 1;
+            ++popped;
+        }
+
+        for (int p = 0; p < Producers; ++p)
+            threads[p].Join();
+
+        TEST_CHECK(ordered);
+        TEST_CHECK(queue.Pop() == NULL);
+    }
+
+    // <end> MpscQueue
+
+
+    // <begin> TaskExecutor
+
+    class CountingHost : public TaskExecutor::Host
+    {
+    public:
+        CountingHost(): entered(0), left(0), waits(0) { }
+
+        virtual void EnterThread()
+        {
+            ++entered;
+        }
+
+        virtual void LeaveThread()
+        {
+            ++left;
+        }
+
+        virtual void Wait(Event &wake)
+        {
+            ++waits;
+            wake.Wait();
+        }
+
+        // written on the thread of the executor, read after it is stopped
+        int  entered;
+        int  left;
+        long waits;
+    };
+
+    // The results of the tasks, written by the thread of the executor
+    struct Results
+    {
+        Results(): ordered(true), onExecutor(true), cancelled(0)
+        {
+            for (int p = 0; p < Producers; ++p)
+                next[p] = 0;
+        }
+
+        long CountRun() const
+        {
+            long count = 0;
+            for (int p = 0; p < Producers; ++p)
+                count += next[p];
+            return count;
+        }
+
+        long                 next[Producers];
+        bool                 ordered;
+        bool                 onExecutor;
+        AtomicsUtil::Integer cancelled;     // Cancel() is called on the posting thread
+    };
+
+    class CountTask : public TaskExecutor::Task
+    {
+    public:
+        CountTask(TaskExecutor &executor, Results &results, int producer, long sequence):
+            m_executor(executor), m_results(results), m_producer(producer), m_sequence(sequence)
+        {
+        }
+
+        virtual void Run()
+        {
+            if (m_sequence != m_results.next[m_producer])
+                m_results.ordered = false;
+            if (!m_executor.IsExecutorThread())
+                m_results.onExecutor = false;
+
+            m_results.next[m_producer] = m_sequence + 1;
+        }
+
+        virtual void Cancel()
+        {
+            AtomicsUtil::Increment(&m_results.cancelled);
+        }
+
+    private:
+        TaskExecutor &m_executor;
+        Results      &m_results;
+        int           m_producer;
+        long          m_sequence;
+    };
+
+    struct TaskProducer
+    {
+        TaskExecutor *executor;
+        Results      *results;
+        int           producer;
+        long          posted;
+
+        static void Run(void *context)
+        {
+            TaskProducer *p = static_cast<TaskProducer*>(context);
+            for (long i = 0; i < ItemsPerProducer; ++i)
+            {
+                if (p->executor->Post(new CountTask(*p->executor, *p->results, p->producer, i)))
+                    ++p->posted;
+
+                // let the executor drain the queue now and then, so that it also waits
+                if (i % 5000 == 0)
+                    Thread::Sleep(1);
+            }
+        }
+    };
+
+    // Post from several threads; with stopEarly, the executor is stopped while they post
+    void RunProducers(TaskExecutor &executor, Results &results, bool stopEarly, long &posted)
+    {
+        TaskProducer producers[Producers];
+        Thread threads[Producers];
+        for (int p = 0; p < Producers; ++p)
+        {
+            TaskProducer producer = { &executor, &results, p, 0 };
+            producers[p] = producer;
+            TEST_CHECK(threads[p].Start(TaskProducer::Run, &producers[p]));
+        }
+
+        if (stopEarly)
+        {
+            Thread::Sleep(10);
+            executor.Stop();
+        }
+
+        posted = 0;
+        for (int p = 0; p < Producers; ++p)
+        {
+            threads[p].Join();
+            posted += producers[p].posted;
+        }
+
+        if (!stopEarly)
+            executor.Stop();
+    }
+
+
+    // Every task posted is run, in the order of its producer, on the thread of the executor
+    void TestExecutor()
+    {
+        CountingHost host;
+        Results results;
+        long posted = 0;
+        {
+            TaskExecutor executor(host);
+
+            // not started yet: the task is cancelled
+            TEST_CHECK(!executor.Post(new CountTask(executor, results, 0, 0)));
+            TEST_CHECK(results.cancelled == 1);
+
+            TEST_CHECK(executor.Start());
+            TEST_CHECK(!executor.IsExecutorThread());
+
+            RunProducers(executor, results, false, posted);
+
+            // stopped
+            TEST_CHECK(!executor.Post(new CountTask(executor, results, 0, 0)));
+            TEST_CHECK(results.cancelled == 2);
+        }
+
+        TEST_CHECK(posted == Producers * ItemsPerProducer);
+        TEST_CHECK(results.CountRun() == posted);
+        TEST_CHECK(results.ordered && results.onExecutor);
+        TEST_CHECK(host.entered == 1 && host.left == 1);
+    }
+
+
+    // The tasks posted before Stop() are run, the later ones are cancelled, and none is lost
+    void TestStopWhilePosting()
+    {
+        CountingHost host;
+        Results results;
+        long posted = 0;
+        {
+            TaskExecutor executor(host);
+            TEST_CHECK(executor.Start());
+            RunProducers(executor, results, true, posted);
+        }
+
+        TEST_CHECK(results.CountRun() == posted);
+        TEST_CHECK(posted + results.cancelled == Producers * ItemsPerProducer);
+        TEST_CHECK(results.ordered);
+        TEST_CHECK(host.entered == 1 && host.left == 1);
+    }
+
+
+    // One task at a time: the thread waits between them, and a post always wakes it
+    class SignalTask : public TaskExecutor::Task
+    {
+    public:
+        explicit SignalTask(Event &done): m_done(done) { }
+
+        virtual void Run()
+        {
+            m_done.Set();
+        }
+
+    private:
+        Event &m_done;
+    };
+
+    void TestWake()
+    {
+        CountingHost host;
+        TaskExecutor executor(host);
+        TEST_CHECK(executor.Start());
+
+        Event done(false);
+        bool lost = false;
+        for (int i = 0; i < 2000 && !lost; ++i)
+        {
+            TEST_CHECK(executor.Post(new SignalTask(done)));
+            lost = !done.Wait(5000);
+
+            if (i % 3 == 0)
+                Thread::Sleep(0);
+        }
+
+        executor.Stop();
+        TEST_CHECK(!lost);
+        TEST_CHECK(host.waits > 0);
+    }
+
+    // <end> TaskExecutor
+}
+
+
+int main()
+{
+    TestQueue();
+    TestExecutor();
+    TestStopWhilePosting();
+    TestWake();
+
+    return TestResult("TaskExecutorTest");
+}
@@ -0,0 +1,83 @@
+﻿/*!
+* @file    TestUtil.h
+* @brief   Helpers shared by the tests and benchmarks of ExcelAutomationLib
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#ifndef TESTUTIL_H_GUID_6E2B94D1_0C7A_4F35_A8E1_B3D57C2F9064
+#define TESTUTIL_H_GUID_6E2B94D1_0C7A_4F35_A8E1_B3D57C2F9064
+
+
+#include <cstdio>
+#include <ctime>
+
+
+/*!
+* @brief Number of failed checks in this test program
+*/
+inline int& TestFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+
+/*!
+* @brief Check a condition, and report it if it is false. The test goes on.
+*/
+#define TEST_CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++TestFailures(); \
+        } \
+    } while (0)
+
+
+/*!
+* @brief Print the result of a test program, and return its exit code.
+*/
+inline int TestResult(const char *name)
+{
+    if (TestFailures() == 0)
+        std::printf("%s: passed\n", name);
+    else
+        std::printf("%s: %d check(s) failed\n", name, TestFailures());
+
+    return TestFailures() == 0 ? 0 : 1;
+}
+
+
+/*!
+* @brief Class Stopwatch measures the wall-clock time of a benchmark.
+*/
+class Stopwatch
+{
+public:
+    Stopwatch()
+    {
+        Restart();
+    }
+
+    void Restart()
+    {
+        clock_gettime(CLOCK_MONOTONIC, &m_start);
+    }
+
+    double Seconds() const
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<double>(now.tv_sec - m_start.tv_sec) + (now.tv_nsec - m_start.tv_nsec) / 1e9;
+    }
+
+private:
+    timespec m_start;
+};
+
+
+#endif //TESTUTIL_H_GUID_6E2B94D1_0C7A_4F35_A8E1_B3D57C2F9064
@@ -0,0 +1,172 @@
+﻿/*!
+* @file    TypedCodecTest.cpp
+* @brief   Test of ExcelTypedWriter and ExcelTypedReader
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ExcelTypedCodec.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    typedef std::vector<unsigned char> Buffer;
+
+    // One value of every type, in a 2 x 4 range
+    Buffer MakeRange()
+    {
+        Buffer buffer;
+        ExcelTypedWriter writer(buffer);
+
+        writer.Begin(2, 4);
+        writer.PutEmpty();
+        writer.PutDouble(3.25);
+        writer.PutInt64(-1234567890123LL);
+        writer.PutBool(true);
+        writer.PutError(-2146826246);   // #N/A
+        writer.PutDate(40000.5);
+        writer.PutString(std::wstring(L"caf\x00E9"));
+        writer.PutStringUtf8("abc", 3);
+
+        return buffer;
+    }
+
+    // Read a whole range; false if any value cannot be read
+    bool ReadAll(const Buffer &buffer, std::vector<ExcelTypedValue> &values)
+    {
+        ExcelTypedReader reader(buffer.empty() ? NULL : &buffer[0], buffer.size());
+
+        int rows = 0;
+        int columns = 0;
+        if (!reader.ReadHeader(rows, columns))
+            return false;
+
+        values.resize(static_cast<size_t>(rows) * columns);
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (!reader.Next(values[i]))
+                return false;
+        }
+
+        return true;
+    }
+
+    void TestRoundTrip()
+    {
+        std::vector<ExcelTypedValue> values;
+        Buffer buffer = MakeRange();
+        TEST_CHECK(ReadAll(buffer, values));
+        TEST_CHECK(values.size() == 8);
+        if (values.size() != 8)
+            return;
+
+        TEST_CHECK(values[0].tag == ETT_Empty);
+        TEST_CHECK(values[1].tag == ETT_Double && values[1].number == 3.25);
+        TEST_CHECK(values[2].tag == ETT_Int64 && values[2].integer == -1234567890123LL);
+        TEST_CHECK(values[3].tag == ETT_Bool && values[3].boolean);
+        TEST_CHECK(values[4].tag == ETT_Error && values[4].error == -2146826246);
+        TEST_CHECK(values[5].tag == ETT_Date && values[5].number == 40000.5);
+        TEST_CHECK(values[6].tag == ETT_String16 && values[6].GetString() == L"caf\x00E9");
+        TEST_CHECK(values[7].tag == ETT_String8 && values[7].textLength == 3);
+        TEST_CHECK(values[7].GetString() == L"abc");
+    }
+
+    void TestSurrogatePair()
+    {
+        if (sizeof(wchar_t) <= 2)
+            return;
+
+        // U+1F600 is stored as two UTF-16 code units
+        const wchar_t str[] = { static_cast<wchar_t>(0x1F600), L'x' };
+
+        Buffer buffer;
+        ExcelTypedWriter writer(buffer);
+        writer.Begin(1, 1);
+        writer.PutString(str, 2);
+
+        std::vector<ExcelTypedValue> values;
+        TEST_CHECK(ReadAll(buffer, values));
+        TEST_CHECK(values.size() == 1 && values[0].textLength == 3);
+    }
+
+    void TestTruncated()
+    {
+        // Every prefix of a valid range must fail cleanly, never read past its end
+        Buffer buffer = MakeRange();
+        for (size_t size = 0; size < buffer.size(); ++size)
+        {
+            Buffer prefix(buffer.begin(), buffer.begin() + size);
+            std::vector<ExcelTypedValue> values;
+            TEST_CHECK(!ReadAll(prefix, values));
+        }
+    }
+
+    void TestBadHeader()
+    {
+        Buffer buffer = MakeRange();
+        std::vector<ExcelTypedValue> values;
+
+        Buffer badMagic(buffer);
+        badMagic[0] = 'X';
+        TEST_CHECK(!ReadAll(badMagic, values));
+
+        Buffer badVersion(buffer);
+        badVersion[2] = ETF_Version + 1;
+        TEST_CHECK(!ReadAll(badVersion, values));
+
+        Buffer badFlags(buffer);
+        badFlags[3] = 1;
+        TEST_CHECK(!ReadAll(badFlags, values));
+
+        Buffer unknownTag(buffer);
+        unknownTag[ETF_HeaderSize] = 0x7F;
+        TEST_CHECK(!ReadAll(unknownTag, values));
+    }
+
+    // A string whose length field claims more than the data holds
+    void TestHugeStringLength(ExcelTypedTag tag, unsigned long length)
+    {
+        Buffer buffer;
+        ExcelTypedWriter writer(buffer);
+        writer.Begin(1, 1);
+
+        buffer.push_back(static_cast<unsigned char>(tag));
+        for (int k = 0; k < 4; ++k)
+            buffer.push_back(static_cast<unsigned char>((length >> (8 * k)) & 0xFF));
+        buffer.insert(buffer.end(), 16, 'a');
+
+        std::vector<ExcelTypedValue> values;
+        TEST_CHECK(!ReadAll(buffer, values));
+    }
+
+    void TestHugeStringLengths()
+    {
+        // 2 * length overflows a 32-bit size_t for the first two; all of them exceed the data
+        TestHugeStringLength(ETT_String16, 0xFFFFFFFFUL);
+        TestHugeStringLength(ETT_String16, 0x80000001UL);
+        TestHugeStringLength(ETT_String16, 9);
+        TestHugeStringLength(ETT_String8, 0xFFFFFFFFUL);
+        TestHugeStringLength(ETT_String8, 17);
+    }
+}
+
+
+int main()
+{
+    TestRoundTrip();
+    TestSurrogatePair();
+    TestTruncated();
+    TestBadHeader();
+    TestHugeStringLengths();
+
+    return TestResult("TypedCodecTest");
+}
@@ -0,0 +1,807 @@
+﻿/*!
+* @file    VtableBindingTest.cpp
+* @brief   Test of VtableBinding, on fake Excel objects which have dual interfaces
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ExcelApplication.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheet.h"
+#include "ExcelCell.h"
+#include "ExcelFont.h"
+#include "ExcelRange.h"
+#include "ComUtil.h"
+#include "VtableBinding.h"
+#include "ComStandIn.h"
+#include "FakeExcel.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+using namespace ComStandIn;
+
+
+namespace
+{
+    const int Loops = 100;
+
+    long s_allocations = 0;
+}
+
+
+// Count the allocations of the whole program
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+    ++s_allocations;
+
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+
+// Not inlined, or GCC warns that the memory of a new expression is given to free()
+__attribute__((noinline)) void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+
+namespace
+{
+    // The IIDs of the dual interfaces, as in the Excel type library
+    const IID IID_Range     = { 0x00020846, 0x0000, 0x0000, { 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46 } };
+    const IID IID_Font      = { 0x0002084D, 0x0000, 0x0000, { 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46 } };
+    const IID IID_Worksheet = { 0x000208D8, 0x0000, 0x0000, { 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46 } };
+
+    // The first vtable slot after those of IDispatch
+    const int FirstSlot = 7;
+
+    // The types which the type information refers to
+    enum RefType
+    {
+        Ref_Interface = 1,  // the dual interface behind a dispinterface
+        Ref_Font,           // the Font dispinterface
+        Ref_XlHAlign        // an enumeration
+    };
+
+
+    /*!
+    * @brief Struct FakeParam describes a parameter: its flags and its type, a pointer type pointing to vt2 (and vt3).
+    */
+    struct FakeParam
+    {
+        USHORT   flags;
+        VARTYPE  vt;
+        VARTYPE  vt2;
+        VARTYPE  vt3;
+        HREFTYPE refType;   // of the last VT_USERDEFINED in the chain
+    };
+
+    /*!
+    * @brief Struct FakeFunc describes a typed method of a dual interface.
+    */
+    struct FakeFunc
+    {
+        const wchar_t *name;
+        MEMBERID       memberId;
+        INVOKEKIND     invokeKind;
+        int            slot;
+        UINT           paramCount;
+        FakeParam      params[3];
+    };
+
+
+    /*!
+    * @brief Class FakeTypeInfo is the type information of a dispinterface, a dual interface or an enumeration.
+    * @details The objects are static, so the references are not counted.
+    */
+    class FakeTypeInfo : public ITypeInfo
+    {
+    public:
+        FakeTypeInfo(TYPEKIND kind, WORD typeFlags, const IID &iid): m_kind(kind), m_typeFlags(typeFlags),
+            m_iid(iid), m_pInterface(NULL), m_pFont(NULL), m_pEnum(NULL), m_funcs(NULL), m_funcCount(0)
+        {
+        }
+
+        void SetFuncs(const FakeFunc *funcs, UINT count)
+        {
+            m_funcs = funcs;
+            m_funcCount = count;
+        }
+
+        void SetRefs(FakeTypeInfo *pInterface, FakeTypeInfo *pFont, FakeTypeInfo *pEnum)
+        {
+            m_pInterface = pInterface;
+            m_pFont = pFont;
+            m_pEnum = pEnum;
+        }
+
+        // IUnknown
+        virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID /*riid*/, void **ppv)
+        {
+            *ppv = NULL;
+            return E_NOINTERFACE;
+        }
+
+        virtual ULONG STDMETHODCALLTYPE AddRef()
+        {
+            return 1;
+        }
+
+        virtual ULONG STDMETHODCALLTYPE Release()
+        {
+            return 1;
+        }
+
+        // ITypeInfo
+        virtual HRESULT STDMETHODCALLTYPE GetTypeAttr(TYPEATTR **ppTypeAttr)
+        {
+            TYPEATTR *pAttr = new TYPEATTR();
+            pAttr->guid = m_iid;
+            pAttr->typekind = m_kind;
+            pAttr->wTypeFlags = m_typeFlags;
+            pAttr->cFuncs = static_cast<WORD>(m_funcCount);
+            *ppTypeAttr = pAttr;
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE GetFuncDesc(UINT index, FUNCDESC **ppFuncDesc)
+        {
+            if (index >= m_funcCount)
+                return E_INVALIDARG;
+
+            const FakeFunc &func = m_funcs[index];
+            FuncDescHolder *pHolder = new FuncDescHolder();
+            FUNCDESC &desc = pHolder->desc;
+            desc.memid = func.memberId;
+            desc.funckind = FUNC_PUREVIRTUAL;
+            desc.invkind = func.invokeKind;
+            desc.callconv = CC_STDCALL;
+            desc.cParams = static_cast<SHORT>(func.paramCount);
+            desc.oVft = static_cast<SHORT>(func.slot * sizeof(void*));
+            desc.elemdescFunc.tdesc.vt = VT_HRESULT;
+            desc.lprgelemdescParam = pHolder->params;
+
+            for (UINT i = 0; i < func.paramCount; ++i)
+            {
+                const FakeParam &param = func.params[i];
+                ELEMDESC &elem = pHolder->params[i];
+                elem.paramdesc.wParamFlags = param.flags;
+                FillType(elem.tdesc, param.vt, param.refType, pHolder->inner[i][0]);
+                if (param.vt == VT_PTR)
+                {
+                    FillType(pHolder->inner[i][0], param.vt2, param.refType, pHolder->inner[i][1]);
+                    if (param.vt2 == VT_PTR)
+                        FillType(pHolder->inner[i][1], param.vt3, param.refType, pHolder->inner[i][1]);
+                }
+            }
+
+            *ppFuncDesc = &desc;
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE GetIDsOfNames(LPOLESTR *rgszNames, UINT cNames, MEMBERID *pMemId)
+        {
+            for (UINT i = 0; i < m_funcCount && cNames == 1; ++i)
+            {
+                if (std::wcscmp(m_funcs[i].name, rgszNames[0]) == 0)
+                {
+                    *pMemId = m_funcs[i].memberId;
+                    return S_OK;
+                }
+            }
+            return DISP_E_UNKNOWNNAME;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE GetRefTypeOfImplType(UINT index, HREFTYPE *pRefType)
+        {
+            if (index != static_cast<UINT>(-1) || !(m_typeFlags & TYPEFLAG_FDUAL) || !m_pInterface)
+                return E_INVALIDARG;
+            *pRefType = Ref_Interface;
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE GetRefTypeInfo(HREFTYPE hRefType, ITypeInfo **ppTInfo)
+        {
+            FakeTypeInfo *pInfo = NULL;
+            switch (hRefType)
+            {
+            case Ref_Interface: pInfo = m_pInterface; break;
+            case Ref_Font:      pInfo = m_pFont; break;
+            case Ref_XlHAlign:  pInfo = m_pEnum; break;
+            }
+
+            *ppTInfo = pInfo;
+            return pInfo ? S_OK : TYPE_E_ELEMENTNOTFOUND;
+        }
+
+        virtual void STDMETHODCALLTYPE ReleaseTypeAttr(TYPEATTR *pTypeAttr)
+        {
+            delete pTypeAttr;
+        }
+
+        virtual void STDMETHODCALLTYPE ReleaseFuncDesc(FUNCDESC *pFuncDesc)
+        {
+            // the FUNCDESC is the first member of its holder
+            delete reinterpret_cast<FuncDescHolder*>(pFuncDesc);
+        }
+
+    private:
+        struct FuncDescHolder
+        {
+            FUNCDESC desc;
+            ELEMDESC params[3];
+            TYPEDESC inner[3][2];
+        };
+
+        static void FillType(TYPEDESC &desc, VARTYPE vt, HREFTYPE refType, TYPEDESC &pointee)
+        {
+            desc.vt = vt;
+            if (vt == VT_PTR)
+                desc.lptdesc = &pointee;
+            else if (vt == VT_USERDEFINED)
+                desc.hreftype = refType;
+        }
+
+        TYPEKIND        m_kind;
+        WORD            m_typeFlags;
+        IID             m_iid;
+        FakeTypeInfo   *m_pInterface;
+        FakeTypeInfo   *m_pFont;
+        FakeTypeInfo   *m_pEnum;
+        const FakeFunc *m_funcs;
+        UINT            m_funcCount;
+    };
+
+
+    const USHORT In = PARAMFLAG_FIN;
+    const USHORT Optional = PARAMFLAG_FIN | PARAMFLAG_FOPT;
+    const USHORT Lcid = PARAMFLAG_FIN | PARAMFLAG_FLCID;
+    const USHORT RetVal = PARAMFLAG_FOUT | PARAMFLAG_FRETVAL;
+
+    // The typed methods, in the order of their slots in the classes below
+    const FakeFunc s_rangeFuncs[] =
+    {
+        { L"Value", 6, INVOKE_PROPERTYGET, FirstSlot, 3,
+            { { Optional, VT_VARIANT }, { Lcid, VT_I4 }, { RetVal, VT_PTR, VT_VARIANT } } },
+        { L"Value", 6, INVOKE_PROPERTYPUT, FirstSlot + 1, 3,
+            { { Optional, VT_VARIANT }, { Lcid, VT_I4 }, { In, VT_VARIANT } } },
+        { L"Font", 146, INVOKE_PROPERTYGET, FirstSlot + 2, 1,
+            { { RetVal, VT_PTR, VT_PTR, VT_USERDEFINED, Ref_Font } } },
+        { L"HorizontalAlignment", 136, INVOKE_PROPERTYPUT, FirstSlot + 3, 1,
+            { { In, VT_USERDEFINED, 0, 0, Ref_XlHAlign } } },
+        { L"VerticalAlignment", 137, INVOKE_PROPERTYPUT, FirstSlot + 4, 1,
+            { { In, VT_VARIANT } } }
+    };
+
+    const FakeFunc s_fontFuncs[] =
+    {
+        { L"Bold", 96, INVOKE_PROPERTYGET, FirstSlot, 1, { { RetVal, VT_PTR, VT_VARIANT } } },
+        { L"Bold", 96, INVOKE_PROPERTYPUT, FirstSlot + 1, 1, { { In, VT_VARIANT } } },
+        { L"Size", 104, INVOKE_PROPERTYGET, FirstSlot + 2, 1, { { RetVal, VT_PTR, VT_VARIANT } } },
+        { L"Size", 104, INVOKE_PROPERTYPUT, FirstSlot + 3, 1, { { In, VT_R8 } } }
+    };
+
+    const FakeFunc s_worksheetFuncs[] =
+    {
+        { L"Name", 110, INVOKE_PROPERTYGET, FirstSlot, 1, { { RetVal, VT_PTR, VT_BSTR } } },
+        { L"Name", 110, INVOKE_PROPERTYPUT, FirstSlot + 1, 1, { { In, VT_BSTR } } }
+    };
+
+
+    FakeTypeInfo s_enumInfo(TKIND_ENUM, 0, IID_NULL);
+    FakeTypeInfo s_fontInterface(TKIND_INTERFACE, TYPEFLAG_FDUAL, IID_Font);
+    FakeTypeInfo s_fontInfo(TKIND_DISPATCH, TYPEFLAG_FDUAL, IID_Font);
+    FakeTypeInfo s_rangeInterface(TKIND_INTERFACE, TYPEFLAG_FDUAL, IID_Range);
+    FakeTypeInfo s_rangeInfo(TKIND_DISPATCH, TYPEFLAG_FDUAL, IID_Range);
+    FakeTypeInfo s_worksheetInterface(TKIND_INTERFACE, TYPEFLAG_FDUAL, IID_Worksheet);
+    FakeTypeInfo s_worksheetInfo(TKIND_DISPATCH, TYPEFLAG_FDUAL, IID_Worksheet);
+
+    void SetUpTypeInfo()
+    {
+        s_fontInterface.SetFuncs(s_fontFuncs, sizeof(s_fontFuncs) / sizeof(s_fontFuncs[0]));
+        s_fontInfo.SetRefs(&s_fontInterface, NULL, NULL);
+        s_rangeInterface.SetFuncs(s_rangeFuncs, sizeof(s_rangeFuncs) / sizeof(s_rangeFuncs[0]));
+        s_rangeInterface.SetRefs(NULL, &s_fontInfo, &s_enumInfo);
+        s_rangeInfo.SetRefs(&s_rangeInterface, NULL, NULL);
+        s_worksheetInterface.SetFuncs(s_worksheetFuncs, sizeof(s_worksheetFuncs) / sizeof(s_worksheetFuncs[0]));
+        s_worksheetInfo.SetRefs(&s_worksheetInterface, NULL, NULL);
+    }
+
+
+    /*!
+    * @brief Class DualObject is the IDispatch part of a fake dual object: a late-bound call goes to the fake
+    *        object inside, and so does a typed method, through Forward(). The typed methods of TDerived come
+    *        right after the slots of IDispatch, so DualObject adds no virtual function of its own, and
+    *        TDerived declares its virtual destructor after its typed methods.
+    */
+    template <class TDerived>
+    class DualObject : public IDispatch
+    {
+    public:
+        // IUnknown
+        virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppv)
+        {
+            if (riid == IID_IUnknown || riid == IID_IDispatch || (riid == m_iid && s_dual))
+            {
+                *ppv = static_cast<IDispatch*>(this);
+                AddRef();
+                return S_OK;
+            }
+
+            *ppv = NULL;
+            return E_NOINTERFACE;
+        }
+
+        virtual ULONG STDMETHODCALLTYPE AddRef()
+        {
+            return ++m_references;
+        }
+
+        virtual ULONG STDMETHODCALLTYPE Release()
+        {
+            ULONG references = --m_references;
+            if (references == 0)
+                delete static_cast<TDerived*>(this);
+            return references;
+        }
+
+        // IDispatch
+        virtual HRESULT STDMETHODCALLTYPE GetTypeInfoCount(UINT *pctinfo)
+        {
+            *pctinfo = 1;
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE GetTypeInfo(UINT /*iTInfo*/, LCID /*lcid*/, ITypeInfo **ppTInfo)
+        {
+            *ppTInfo = m_pTypeInfo;
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE GetIDsOfNames(REFIID riid, LPOLESTR *rgszNames, UINT cNames, LCID lcid,
+            DISPID *rgDispId)
+        {
+            return m_pInner->GetIDsOfNames(riid, rgszNames, cNames, lcid, rgDispId);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE Invoke(DISPID dispIdMember, REFIID riid, LCID lcid, WORD wFlags,
+            DISPPARAMS *pDispParams, VARIANT *pVarResult, EXCEPINFO *pExcepInfo, UINT *puArgErr)
+        {
+            ++s_invokes;
+            return m_pInner->Invoke(dispIdMember, riid, lcid, wFlags, pDispParams, pVarResult, pExcepInfo,
+                puArgErr);
+        }
+
+        // Number of calls of the typed methods and of IDispatch::Invoke() on all the objects of this type
+        static long CountTypedCalls()
+        {
+            return s_typedCalls;
+        }
+
+        static long CountInvokes()
+        {
+            return s_invokes;
+        }
+
+        static void ResetCounters()
+        {
+            s_typedCalls = 0;
+            s_invokes = 0;
+        }
+
+        // Whether QueryInterface() hands out the dual interface, as Excel does
+        static void SetDual(bool dual)
+        {
+            s_dual = dual;
+        }
+
+    protected:
+        DualObject(FakeDispatch *pInner, ITypeInfo *pTypeInfo, const IID &iid): m_references(1),
+            m_pInner(pInner), m_pTypeInfo(pTypeInfo), m_iid(iid)
+        {
+            m_pInner->AddRef();
+        }
+
+        ~DualObject()
+        {
+            m_pInner->Release();
+        }
+
+        // Carry out a typed method through the fake object inside
+        HRESULT Forward(const wchar_t *name, WORD flags, VARIANT *pArg, VARIANT *pResult)
+        {
+            ++s_typedCalls;
+
+            LPOLESTR names[1] = { const_cast<LPOLESTR>(name) };
+            DISPID dispId;
+            HRESULT hr = m_pInner->GetIDsOfNames(IID_NULL, names, 1, LOCALE_SYSTEM_DEFAULT, &dispId);
+            if (FAILED(hr))
+                return hr;
+
+            DISPID putId = DISPID_PROPERTYPUT;
+            DISPPARAMS params = { pArg, NULL, pArg ? 1U : 0U, 0 };
+            if (flags & DISPATCH_PROPERTYPUT)
+            {
+                params.rgdispidNamedArgs = &putId;
+                params.cNamedArgs = 1;
+            }
+
+            return m_pInner->Invoke(dispId, IID_NULL, LOCALE_SYSTEM_DEFAULT, flags, &params, pResult, NULL, NULL);
+        }
+
+        FakeDispatch *Inner() const
+        {
+            return m_pInner;
+        }
+
+    private:
+        DualObject(const DualObject&);
+        DualObject& operator = (const DualObject&);
+
+        ULONG         m_references;
+        FakeDispatch *m_pInner;
+        ITypeInfo    *m_pTypeInfo;
+        IID           m_iid;
+
+        static long s_typedCalls;
+        static long s_invokes;
+        static bool s_dual;
+    };
+
+    template <class TDerived> long DualObject<TDerived>::s_typedCalls = 0;
+    template <class TDerived> long DualObject<TDerived>::s_invokes = 0;
+    template <class TDerived> bool DualObject<TDerived>::s_dual = true;
+
+
+    // The dual Font of a DualRange
+    class DualFont : public DualObject<DualFont>
+    {
+    public:
+        explicit DualFont(FakeFont *pFont): DualObject<DualFont>(pFont, &s_fontInfo, IID_Font)
+        {
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE get_Bold(VARIANT *pResult)
+        {
+            return Forward(L"Bold", DISPATCH_PROPERTYGET, NULL, pResult);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE put_Bold(VARIANT *pValue)
+        {
+            return Forward(L"Bold", DISPATCH_PROPERTYPUT, pValue, NULL);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE get_Size(VARIANT *pResult)
+        {
+            return Forward(L"Size", DISPATCH_PROPERTYGET, NULL, pResult);
+        }
+
+        // [in] double, which arrives in a floating-point register
+        virtual HRESULT STDMETHODCALLTYPE put_Size(double size)
+        {
+            VARIANT value;
+            value.vt = VT_R8;
+            value.dblVal = size;
+            return Forward(L"Size", DISPATCH_PROPERTYPUT, &value, NULL);
+        }
+
+        // after the typed methods, so that its slots come last
+        virtual ~DualFont()
+        {
+        }
+    };
+
+
+    // A dual Range around a FakeRange
+    class DualRange : public DualObject<DualRange>
+    {
+    public:
+        explicit DualRange(FakeRange *pRange): DualObject<DualRange>(pRange, &s_rangeInfo, IID_Range)
+        {
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE get_Value(VARIANT *pDataType, long lcid, VARIANT *pResult)
+        {
+            if (!IsMissing(pDataType) || lcid != LOCALE_SYSTEM_DEFAULT)
+                return E_INVALIDARG;
+            return Forward(L"Value", DISPATCH_PROPERTYGET, NULL, pResult);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE put_Value(VARIANT *pDataType, long lcid, VARIANT *pValue)
+        {
+            if (!IsMissing(pDataType) || lcid != LOCALE_SYSTEM_DEFAULT)
+                return E_INVALIDARG;
+            return Forward(L"Value", DISPATCH_PROPERTYPUT, pValue, NULL);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE get_Font(IDispatch **ppFont)
+        {
+            *ppFont = new DualFont(static_cast<FakeRange*>(Inner())->Font());
+            return S_OK;
+        }
+
+        // [in] XlHAlign, which arrives as a 4-byte integer
+        virtual HRESULT STDMETHODCALLTYPE put_HorizontalAlignment(long alignment)
+        {
+            VARIANT value;
+            value.vt = VT_I4;
+            value.lVal = alignment;
+            return Forward(L"HorizontalAlignment", DISPATCH_PROPERTYPUT, &value, NULL);
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE put_VerticalAlignment(VARIANT *pValue)
+        {
+            return Forward(L"VerticalAlignment", DISPATCH_PROPERTYPUT, pValue, NULL);
+        }
+
+
+        // after the typed methods, so that its slots come last
+        virtual ~DualRange()
+        {
+        }
+
+    private:
+        static bool IsMissing(const VARIANT *pArg)
+        {
+            return pArg->vt == VT_ERROR && pArg->scode == DISP_E_PARAMNOTFOUND;
+        }
+    };
+
+
+    // A dual Worksheet around a FakeWorksheet
+    class DualWorksheet : public DualObject<DualWorksheet>
+    {
+    public:
+        explicit DualWorksheet(FakeWorksheet *pSheet): DualObject<DualWorksheet>(pSheet, &s_worksheetInfo,
+            IID_Worksheet)
+        {
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE get_Name(BSTR *pName)
+        {
+            VARIANT result;
+            ::VariantInit(&result);
+            HRESULT hr = Forward(L"Name", DISPATCH_PROPERTYGET, NULL, &result);
+            *pName = SUCCEEDED(hr) ? result.bstrVal : NULL;
+            return hr;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE put_Name(BSTR name)
+        {
+            VARIANT value;
+            value.vt = VT_BSTR;
+            value.bstrVal = name;
+            return Forward(L"Name", DISPATCH_PROPERTYPUT, &value, NULL);
+        }
+
+        // after the typed methods, so that its slots come last
+        virtual ~DualWorksheet()
+        {
+        }
+    };
+
+
+    IDispatch* WrapRange(FakeRange *pRange)
+    {
+        return new DualRange(pRange);
+    }
+
+
+    void ResetCounters()
+    {
+        DualRange::ResetCounters();
+        DualFont::ResetCounters();
+        DualWorksheet::ResetCounters();
+    }
+
+
+    // Drive a cell, a range and a font through the library, and record what comes back
+    std::vector<std::wstring> RunScenario(bool dualRanges)
+    {
+        std::vector<std::wstring> results;
+
+        // the members are cached by type name, and the Range objects of the two runs differ
+        VtableBinding::Clear();
+
+        FakeApplication *pApp = new FakeApplication;
+        SetInstance(pApp);
+
+        ExcelApplication app;
+        TEST_CHECK(app.Startup());
+
+        ExcelWorkbook workbook = app.CreateWorkbook(ELtext("book.xlsx"));
+        ExcelWorksheet sheet = workbook.GetActiveWorksheet();
+
+        FakeWorksheet *pSheet = pApp->Workbooks()->Workbooks()[0]->Sheets()->Item(1);
+        pSheet->SetRangeWrapper(dualRanges ? WrapRange : NULL);
+
+        ExcelCell cell = sheet.GetCell(ELtext('B'), 2);
+        ELstring value;
+        TEST_CHECK(cell.SetValue(42) && cell.GetValue(value));
+        results.push_back(value);
+        TEST_CHECK(cell.SetValue(2.5) && cell.GetValue(value));
+        results.push_back(value);
+        TEST_CHECK(cell.SetValue(ELstring(ELtext("text"))) && cell.GetValue(value));
+        results.push_back(value);
+
+        TEST_CHECK(cell.SetHorizontalAlignment(EHA_HCenter));
+        TEST_CHECK(cell.SetVerticalAlignment(EVA_Top));
+
+        ExcelFont font = cell.GetFont();
+        TEST_CHECK(!font.IsNull());
+        TEST_CHECK(font.SetBold(true));
+        TEST_CHECK(font.SetSize(14));
+        TEST_CHECK(font.SetItalic(true));       // not in the type information: late bound
+
+        bool bold = false;
+        bool italic = false;
+        int size = 0;
+        TEST_CHECK(font.GetBold(bold) && font.GetItalic(italic) && font.GetSize(size));
+        results.push_back(bold ? L"bold" : L"regular");
+        results.push_back(italic ? L"italic" : L"upright");
+        results.push_back(size == 14 ? L"14" : L"?");
+
+        ExcelRange range = sheet.GetRange(ELtext('A'), ELtext('C'), 1, 2);
+        std::vector<std::vector<ELstring> > rows(2, std::vector<ELstring>(3));
+        rows[0][0] = ELtext("a");
+        rows[0][2] = ELtext("1.25");
+        rows[1][1] = ELtext("b");
+        TEST_CHECK(range.WriteData(rows));
+        std::vector<std::vector<ELstring> > back;
+        TEST_CHECK(range.ReadData(back));
+        TEST_CHECK(back == rows);
+        results.push_back(pSheet->Cell(1, 3).ToString());
+
+        pSheet->SetRangeWrapper(NULL);
+        workbook.Close();
+        app.Shutdown();
+        SetInstance(NULL);
+        pApp->Release();
+
+        return results;
+    }
+
+
+    // The early-bound path gives what the late-bound path gives, and IDispatch::Invoke() is not used for it
+    void TestSameResults()
+    {
+        std::vector<std::wstring> lateBound = RunScenario(false);
+
+        ResetCounters();
+        std::vector<std::wstring> earlyBound = RunScenario(true);
+
+        TEST_CHECK(earlyBound == lateBound);
+        TEST_CHECK(lateBound.size() == 7 && lateBound[0] == L"42" && lateBound[2] == L"text" &&
+            lateBound[3] == L"bold" && lateBound[6] == L"1.25");
+
+        TEST_CHECK(DualRange::CountTypedCalls() > 0);
+        TEST_CHECK(DualRange::CountInvokes() == 0);
+        TEST_CHECK(DualFont::CountTypedCalls() == 4);     // Bold and Size, put and get
+        TEST_CHECK(DualFont::CountInvokes() == 2);        // Italic, put and get
+    }
+
+
+    // An object which has the type information but not the dual interface is called late bound
+    void TestFallback()
+    {
+        VtableBinding::Clear();
+
+        FakeWorksheet *pSheet = new FakeWorksheet(L"Sheet1");
+        FakeRange *pRange = new FakeRange(pSheet, 1, 1, 1, 1);
+        DualRange *pDual = new DualRange(pRange);
+
+        DualRange::SetDual(false);
+        ResetCounters();
+
+        HRESULT hr = ComUtil::InvokeEarlyBound(pDual, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, 7);
+        TEST_CHECK(SUCCEEDED(hr));
+        TEST_CHECK(DualRange::CountTypedCalls() == 0);
+        TEST_CHECK(DualRange::CountInvokes() == 1);
+        TEST_CHECK(pSheet->Cell(1, 1).ToString() == L"7");
+
+        // a plain IDispatch without type information
+        hr = ComUtil::InvokeEarlyBound(pRange, OLESTR("Range"), DISPATCH_PROPERTYPUT, OLESTR("Value"), NULL, 8);
+        TEST_CHECK(SUCCEEDED(hr));
+        TEST_CHECK(pSheet->Cell(1, 1).ToString() == L"8");
+
+        DualRange::SetDual(true);
+        TEST_CHECK(pDual->Release() == 0);
+        pRange->Release();
+        pSheet->Release();
+    }
+
+
+    // A BSTR goes in and comes back through the typed methods; an unknown member falls back
+    void TestStrings()
+    {
+        VtableBinding::Clear();
+
+        FakeWorksheet *pSheet = new FakeWorksheet(L"Sheet1");
+        DualWorksheet *pDual = new DualWorksheet(pSheet);
+        ResetCounters();
+
+        HRESULT hr = ComUtil::InvokeEarlyBound(pDual, OLESTR("Worksheet"), DISPATCH_PROPERTYPUT, OLESTR("Name"), NULL,
+            L"Data");
+        TEST_CHECK(SUCCEEDED(hr));
+
+        VARIANT result;
+        ::VariantInit(&result);
+        hr = ComUtil::InvokeEarlyBound(pDual, OLESTR("Worksheet"), DISPATCH_PROPERTYGET, OLESTR("Name"), &result);
+        TEST_CHECK(SUCCEEDED(hr));
+        TEST_CHECK(result.vt == VT_BSTR && std::wstring(result.bstrVal) == L"Data");
+        ::VariantClear(&result);
+
+        TEST_CHECK(DualWorksheet::CountTypedCalls() == 2);
+        TEST_CHECK(DualWorksheet::CountInvokes() == 0);
+
+        hr = ComUtil::InvokeEarlyBound(pDual, OLESTR("Worksheet"), DISPATCH_PROPERTYGET, OLESTR("Range"), &result,
+            L"A1");
+        TEST_CHECK(SUCCEEDED(hr) && result.vt == VT_DISPATCH);
+        ::VariantClear(&result);
+        TEST_CHECK(DualWorksheet::CountInvokes() == 1);
+
+        TEST_CHECK(pDual->Release() == 0);
+        pSheet->Release();
+    }
+
+
+    // A cached member is called without any allocation, even with the names in fresh buffers
+    void TestNoAllocation()
+    {
+        VtableBinding::Clear();
+
+        FakeWorksheet *pSheet = new FakeWorksheet(L"Sheet1");
+        FakeRange *pRange = new FakeRange(pSheet, 1, 1, 1, 1);
+        DualRange *pDual = new DualRange(pRange);
+
+        OLECHAR typeName[] = OLESTR("Range");
+        OLECHAR name[] = OLESTR("Value");
+        TEST_CHECK(SUCCEEDED(ComUtil::InvokeEarlyBound(pDual, typeName, DISPATCH_PROPERTYPUT, name, NULL, 0)));
+
+        // the names of the first call are gone
+        std::wcscpy(typeName, OLESTR("Xxxxx"));
+        std::wcscpy(name, OLESTR("Xxxxx"));
+
+        ResetCounters();
+        long allocations = s_allocations;
+        for (int i = 0; i < Loops; ++i)
+        {
+            OLECHAR valueName[] = OLESTR("Value");
+            TEST_CHECK(SUCCEEDED(ComUtil::InvokeEarlyBound(pDual, OLESTR("Range"), DISPATCH_PROPERTYPUT, valueName,
+                NULL, i)));
+        }
+
+        TEST_CHECK(s_allocations == allocations);
+        TEST_CHECK(DualRange::CountTypedCalls() == Loops);
+        TEST_CHECK(pSheet->Cell(1, 1).ToString() == L"99");
+
+        TEST_CHECK(pDual->Release() == 0);
+        pRange->Release();
+        pSheet->Release();
+    }
+}
+
+
+int main()
+{
+    SetUpTypeInfo();
+
+    TestSameResults();
+    TestFallback();
+    TestStrings();
+    TestNoAllocation();
+
+    TEST_CHECK(CountStrings() == 0);
+
+    return TestResult("VtableBindingTest");
+}
@@ -0,0 +1,164 @@
+﻿/*!
+* @file    WriteBatchTest.cpp
+* @brief   Test of ExcelWriteBatch, on the fake Excel objects
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <string>
+#include <vector>
+
+#include "ExcelApplication.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheet.h"
+#include "ExcelWriteBatch.h"
+#include "ComStandIn.h"
+#include "FakeExcel.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+using namespace ComStandIn;
+
+
+namespace
+{
+    typedef std::vector<std::wstring> Puts;
+
+    bool HasPuts(const FakeWorksheet *pSheet, const wchar_t *first, const wchar_t *second = NULL,
+        const wchar_t *third = NULL)
+    {
+        Puts expected;
+        const wchar_t *addresses[] = { first, second, third };
+        for (int i = 0; i < 3 && addresses[i] != NULL; ++i)
+            expected.push_back(addresses[i]);
+
+        return pSheet->ValuePuts() == expected;
+    }
+
+
+    // A report written row by row is one put, with the types of the values
+    void TestReport(ExcelWorksheet sheet, FakeWorksheet *pSheet)
+    {
+        ExcelWriteBatch batch(sheet);
+        for (int row = 1; row <= 50; ++row)
+        {
+            TEST_CHECK(batch.SetValue(ELtext('A'), row, row));
+            TEST_CHECK(batch.SetValue(ELtext('B'), row, row * 0.5));
+            TEST_CHECK(batch.SetValue(ELtext('C'), row, ELstring(ELtext("item"))));
+        }
+        TEST_CHECK(batch.CountPending() == 150);
+        TEST_CHECK(pSheet->ValuePuts().empty());
+
+        TEST_CHECK(batch.Commit());
+        TEST_CHECK(batch.CountPending() == 0);
+        TEST_CHECK(HasPuts(pSheet, L"A1:C50"));
+
+        TEST_CHECK(pSheet->Cell(50, 1).Get().vt == VT_I4 && pSheet->Cell(50, 1).ToString() == L"50");
+        TEST_CHECK(pSheet->Cell(3, 2).Get().vt == VT_R8 && pSheet->Cell(3, 2).ToString() == L"1.5");
+        TEST_CHECK(pSheet->Cell(7, 3).Get().vt == VT_BSTR && pSheet->Cell(7, 3).ToString() == L"item");
+
+        // nothing to write
+        TEST_CHECK(batch.Commit());
+        TEST_CHECK(pSheet->ValuePuts().size() == 1);
+    }
+
+
+    // Cells apart are written by one put per rectangle
+    void TestRectangles(ExcelWorksheet sheet, FakeWorksheet *pSheet)
+    {
+        ExcelWriteBatch batch(sheet);
+
+        // 'a' and 'B' are adjacent; the last value of a cell written twice is kept
+        batch.SetValue(ELtext('a'), 1, 1);
+        batch.SetValue(ELtext('B'), 1, 2);
+        batch.SetValue(ELtext('A'), 2, 3);
+        batch.SetValue(ELtext('B'), 2, 4);
+        batch.SetValue(ELtext('b'), 2, 5);
+        batch.SetValue(ELtext('E'), 1, 6);
+        batch.SetValue(ELtext('E'), 5, 7);
+        TEST_CHECK(batch.CountPending() == 6);
+
+        TEST_CHECK(batch.Commit());
+        TEST_CHECK(HasPuts(pSheet, L"E1:E1", L"A1:B2", L"E5:E5"));
+        TEST_CHECK(pSheet->Cell(2, 2).ToString() == L"5");
+        TEST_CHECK(pSheet->Cell(5, 5).ToString() == L"7");
+    }
+
+
+    // The batch is flushed at the threshold, dropped by Discard(), and committed when it is destroyed
+    void TestFlush(ExcelWorksheet sheet, FakeWorksheet *pSheet)
+    {
+        {
+            ExcelWriteBatch batch(sheet, 4);
+            for (int row = 1; row <= 9; ++row)
+                TEST_CHECK(batch.SetValue(ELtext('G'), row, row));
+
+            TEST_CHECK(HasPuts(pSheet, L"G1:G4", L"G5:G8"));
+            TEST_CHECK(batch.CountPending() == 1);
+
+            pSheet->ClearValuePuts();
+            batch.SetValue(ELtext('D'), 1, 0);
+            batch.Discard();
+            TEST_CHECK(batch.CountPending() == 0);
+
+            batch.SetValue(ELtext('D'), 2, 0);
+        }
+
+        TEST_CHECK(HasPuts(pSheet, L"D2:D2"));
+        TEST_CHECK(pSheet->Cell(1, 4).Get().vt == VT_EMPTY);
+        TEST_CHECK(pSheet->Cell(9, 7).Get().vt == VT_EMPTY);
+    }
+
+
+    // A rectangle which cannot be written fails the commit, and the cells are dropped
+    void TestFailure(ExcelWorksheet sheet, FakeWorksheet *pSheet)
+    {
+        ExcelWriteBatch batch(sheet);
+        batch.SetValue(ELtext('A'), 1, 1);
+        batch.SetValue(ELtext('C'), 1, 2);
+
+        pSheet->SetFailing(L"Range");
+        TEST_CHECK(!batch.Commit());
+        TEST_CHECK(batch.CountPending() == 0);
+        TEST_CHECK(pSheet->ValuePuts().empty());
+        pSheet->SetFailing(L"Range", false);
+    }
+}
+
+
+int main()
+{
+    FakeApplication *pApp = new FakeApplication;
+    SetInstance(pApp);
+
+    {
+        ExcelApplication app;
+        TEST_CHECK(app.Startup());
+        ExcelWorkbook workbook = app.CreateWorkbook(ELtext("book.xlsx"));
+        ExcelWorksheet sheet = workbook.GetActiveWorksheet();
+        TEST_CHECK(!sheet.IsNull());
+
+        FakeWorksheet *pSheet = pApp->Workbooks()->Workbooks()[0]->Sheets()->Item(1);
+
+        TestReport(sheet, pSheet);
+        pSheet->ClearValuePuts();
+        TestRectangles(sheet, pSheet);
+        pSheet->ClearValuePuts();
+        TestFlush(sheet, pSheet);
+        pSheet->ClearValuePuts();
+        TestFailure(sheet, pSheet);
+
+        workbook.Close();
+        app.Shutdown();
+    }
+
+    SetInstance(NULL);
+    pApp->Release();
+
+    // the cells written are freed with the fake worksheet
+    TEST_CHECK(CountStrings() == 0);
+
+    return TestResult("WriteBatchTest");
+}
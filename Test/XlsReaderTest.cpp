@@ -0,0 +1,476 @@
+﻿/*!
+* @file    XlsReaderTest.cpp
+* @brief   Test of ExcelFileReader on an .xls file, a compound file with a BIFF8 Workbook stream built here
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ExcelFileReader.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheetSet.h"
+#include "ExcelWorksheet.h"
+#include "ExcelRange.h"
+#include "ExcelValue.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    const char Filename[] = "XlsReaderTest.xls";
+
+    ELstring Text(const char *text)
+    {
+        return ELstring(text, text + std::char_traits<char>::length(text));
+    }
+
+    void AppendUInt16(std::string &out, unsigned long value)
+    {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    }
+
+    void AppendUInt32(std::string &out, unsigned long value)
+    {
+        AppendUInt16(out, value & 0xFFFF);
+        AppendUInt16(out, (value >> 16) & 0xFFFF);
+    }
+
+    void AppendDouble(std::string &out, double value)
+    {
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        AppendUInt32(out, static_cast<unsigned long>(bits & 0xFFFFFFFFUL));
+        AppendUInt32(out, static_cast<unsigned long>(bits >> 32));
+    }
+
+    void SetUInt32(std::string &out, size_t offset, unsigned long value)
+    {
+        std::string bytes;
+        AppendUInt32(bytes, value);
+        out.replace(offset, 4, bytes);
+    }
+
+
+    /*!
+    * @brief Class BiffWriter appends the records of a BIFF8 stream.
+    */
+    class BiffWriter
+    {
+    public:
+        void Record(unsigned long type, const std::string &body)
+        {
+            AppendUInt16(m_stream, type);
+            AppendUInt16(m_stream, body.size());
+            m_stream.append(body);
+        }
+
+        // BOF of the workbook globals (0x0005), a worksheet (0x0010) or a chart (0x0020)
+        void Bof(unsigned long substream)
+        {
+            std::string body;
+            AppendUInt16(body, 0x0600);
+            AppendUInt16(body, substream);
+            AppendUInt16(body, 0x0DBB);     // build
+            AppendUInt16(body, 1996);       // year
+            AppendUInt32(body, 0);
+            AppendUInt32(body, 0x0006);
+            Record(0x0809, body);
+        }
+
+        void Eof()
+        {
+            Record(0x000A, std::string());
+        }
+
+        // row, column and XF, the start of every cell record
+        static std::string Cell(int row, int column, int xf)
+        {
+            std::string body;
+            AppendUInt16(body, row);
+            AppendUInt16(body, column);
+            AppendUInt16(body, xf);
+            return body;
+        }
+
+        size_t Size() const
+        {
+            return m_stream.size();
+        }
+
+        std::string& Stream()
+        {
+            return m_stream;
+        }
+
+    private:
+        std::string m_stream;
+    };
+
+    // An XLUnicodeString without its character count: 8-bit characters, or UTF-16 if wide
+    std::string Chars(const char *text, bool wide)
+    {
+        std::string out(1, wide ? '\x01' : '\x00');
+        for (const char *p = text; *p; ++p)
+        {
+            out.push_back(*p);
+            if (wide)
+                out.push_back('\0');
+        }
+        return out;
+    }
+
+    unsigned long RkInteger(long value, bool divide)
+    {
+        return (static_cast<unsigned long>(value) << 2) | 2 | (divide ? 1 : 0);
+    }
+
+
+    /*!
+    * @brief Build the Workbook stream: two worksheets, the second one active.
+    * @details Sheet "Data" holds every kind of cell the reader decodes; sheet "Chart" has an embedded
+    *          chart substream before its only cell.
+    */
+    std::string MakeWorkbookStream()
+    {
+        BiffWriter biff;
+        std::string body;
+
+        // <begin> globals
+        biff.Bof(0x0005);
+
+        body.assign(18, '\0');
+        body[10] = 1;                           // WINDOW1: the second tab is active
+        biff.Record(0x003D, body);
+
+        body.clear();
+        AppendUInt16(body, 164);                // FORMAT 164, a custom date format
+        AppendUInt16(body, 10);
+        body += Chars("yyyy-mm-dd", false);
+        biff.Record(0x041E, body);
+
+        const unsigned long formats[] = { 0, 14, 164 };     // XF 0: General, 1: built-in date, 2: custom date
+        for (size_t i = 0; i < 3; ++i)
+        {
+            body.clear();
+            AppendUInt16(body, 0);
+            AppendUInt16(body, formats[i]);
+            body.append(16, '\0');
+            biff.Record(0x00E0, body);
+        }
+
+        // SST: an 8-bit string, a UTF-16 one, and one which goes on in a CONTINUE record as UTF-16
+        body.clear();
+        AppendUInt32(body, 5);
+        AppendUInt32(body, 3);
+        AppendUInt16(body, 5);
+        body += Chars("alpha", false);
+        AppendUInt16(body, 4);
+        body += Chars("beta", true);
+        AppendUInt16(body, 10);
+        body += Chars("split", false);
+        biff.Record(0x00FC, body);
+        biff.Record(0x003C, Chars("-text", true));
+
+        size_t boundSheets[2];
+        const char *names[2] = { "Data", "Chart" };
+        for (int i = 0; i < 2; ++i)
+        {
+            boundSheets[i] = biff.Size() + 4;
+            body.clear();
+            AppendUInt32(body, 0);              // the offset of the BOF, patched below
+            body.push_back('\0');
+            body.push_back('\0');
+            body.push_back(static_cast<char>(std::strlen(names[i])));
+            body += Chars(names[i], false);
+            biff.Record(0x0085, body);
+        }
+
+        biff.Eof();
+        // <end> globals
+
+        // <begin> sheet "Data"
+        SetUInt32(biff.Stream(), boundSheets[0], biff.Size());
+        biff.Bof(0x0010);
+
+        // row 1: LABELSST, NUMBER, RK integer, RK divided by 100
+        body = BiffWriter::Cell(0, 0, 0);
+        AppendUInt32(body, 0);
+        biff.Record(0x00FD, body);
+        body = BiffWriter::Cell(0, 1, 0);
+        AppendDouble(body, 3.5);
+        biff.Record(0x0203, body);
+        body = BiffWriter::Cell(0, 2, 0);
+        AppendUInt32(body, RkInteger(42, false));
+        biff.Record(0x027E, body);
+        body = BiffWriter::Cell(0, 3, 0);
+        AppendUInt32(body, RkInteger(123, true));
+        biff.Record(0x027E, body);
+        body = BiffWriter::Cell(0, 4, 0);
+        AppendUInt32(body, 1);
+        biff.Record(0x00FD, body);
+
+        // row 2: MULRK of three cells, then BOOLERR as a boolean and as an error
+        body.clear();
+        AppendUInt16(body, 1);
+        AppendUInt16(body, 0);
+        for (long i = 1; i <= 3; ++i)
+        {
+            AppendUInt16(body, 0);
+            AppendUInt32(body, RkInteger(-i * 10, false));
+        }
+        AppendUInt16(body, 2);
+        biff.Record(0x00BD, body);
+        body = BiffWriter::Cell(1, 3, 0);
+        body += '\x01';
+        body += '\x00';
+        biff.Record(0x0205, body);
+        body = BiffWriter::Cell(1, 4, 0);
+        body += '\x2A';                         // #N/A
+        body += '\x01';
+        biff.Record(0x0205, body);
+
+        // row 3: the cached results of FORMULA: a number, a string in the STRING record after it, a
+        // boolean, an error
+        const unsigned char results[4][8] =
+        {
+            { 0, 0, 0, 0, 0, 0, 0x1D, 0x40 },               // 7.25
+            { 0, 0, 0, 0, 0, 0, 0xFF, 0xFF },               // string
+            { 1, 0, 0, 0, 0, 0, 0xFF, 0xFF },               // FALSE
+            { 2, 0, 0x07, 0, 0, 0, 0xFF, 0xFF }             // #DIV/0!
+        };
+        for (int i = 0; i < 4; ++i)
+        {
+            body = BiffWriter::Cell(2, i, 0);
+            body.append(reinterpret_cast<const char*>(results[i]), 8);
+            AppendUInt16(body, 0);              // flags
+            AppendUInt32(body, 0);
+            AppendUInt16(body, 0);              // no formula tokens
+            biff.Record(0x0006, body);
+
+            if (i == 1)
+            {
+                body.clear();
+                AppendUInt16(body, 6);
+                body += Chars("result", false);
+                biff.Record(0x0207, body);
+            }
+        }
+
+        // row 4: dates of both formats, a LABEL, and the shared string split by CONTINUE
+        body = BiffWriter::Cell(3, 0, 1);
+        AppendDouble(body, 45000);
+        biff.Record(0x0203, body);
+        body = BiffWriter::Cell(3, 1, 2);
+        AppendDouble(body, 45000.5);
+        biff.Record(0x0203, body);
+        body = BiffWriter::Cell(3, 2, 0);
+        AppendUInt16(body, 6);
+        body += Chars("inline", true);
+        biff.Record(0x0204, body);
+        body = BiffWriter::Cell(3, 3, 0);
+        AppendUInt32(body, 2);
+        biff.Record(0x00FD, body);
+
+        biff.Eof();
+        // <end> sheet "Data"
+
+        // <begin> sheet "Chart": the cells of the chart substream are not the cells of the worksheet
+        SetUInt32(biff.Stream(), boundSheets[1], biff.Size());
+        biff.Bof(0x0010);
+        biff.Bof(0x0020);
+        body = BiffWriter::Cell(0, 0, 0);
+        AppendDouble(body, 99);
+        biff.Record(0x0203, body);
+        biff.Eof();
+        body = BiffWriter::Cell(0, 0, 0);
+        AppendDouble(body, 1);
+        biff.Record(0x0203, body);
+        biff.Eof();
+        // <end> sheet "Chart"
+
+        return biff.Stream();
+    }
+
+
+    /*!
+    * @brief Put a stream named "Workbook" in a version 3 compound file: the FAT in sector 0, the directory
+    *        in sector 1, the stream from sector 2. The stream is padded up to the mini stream cutoff, so
+    *        it is in regular sectors.
+    */
+    std::string MakeCompoundFile(std::string stream)
+    {
+        const size_t SectorSize = 512;
+        const unsigned long EndOfChain = 0xFFFFFFFEUL;
+        const unsigned long NoStream = 0xFFFFFFFFUL;
+
+        size_t streamSize = stream.size() < 4096 ? 4096 : stream.size();
+        stream.resize((streamSize + SectorSize - 1) / SectorSize * SectorSize, '\0');
+        size_t streamSectors = stream.size() / SectorSize;
+
+        std::string header;
+        header += "\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1";
+        header.append(16, '\0');                // CLSID
+        AppendUInt16(header, 0x003E);           // minor version
+        AppendUInt16(header, 3);                // major version
+        AppendUInt16(header, 0xFFFE);           // byte order
+        AppendUInt16(header, 9);                // sector shift
+        AppendUInt16(header, 6);                // mini sector shift
+        header.append(6, '\0');
+        AppendUInt32(header, 0);                // directory sectors (0 in version 3)
+        AppendUInt32(header, 1);                // FAT sectors
+        AppendUInt32(header, 1);                // first directory sector
+        AppendUInt32(header, 0);                // transaction signature
+        AppendUInt32(header, 4096);             // mini stream cutoff
+        AppendUInt32(header, EndOfChain);       // no MiniFAT
+        AppendUInt32(header, 0);
+        AppendUInt32(header, EndOfChain);       // no DIFAT sector
+        AppendUInt32(header, 0);
+        AppendUInt32(header, 0);                // DIFAT[0]: the FAT is in sector 0
+        while (header.size() < SectorSize)
+            AppendUInt32(header, NoStream);
+
+        std::string fat;
+        AppendUInt32(fat, 0xFFFFFFFDUL);        // the FAT itself
+        AppendUInt32(fat, EndOfChain);          // the directory
+        for (size_t i = 1; i < streamSectors; ++i)
+            AppendUInt32(fat, 2 + i);
+        AppendUInt32(fat, EndOfChain);
+        while (fat.size() < SectorSize)
+            AppendUInt32(fat, NoStream);
+
+        std::string directory;
+        const char *names[2] = { "Root Entry", "Workbook" };
+        for (int i = 0; i < 4; ++i)
+        {
+            std::string entry;
+            if (i < 2)
+                entry = Chars(names[i], true).substr(1);
+            entry.resize(64, '\0');
+            AppendUInt16(entry, i < 2 ? (std::strlen(names[i]) + 1) * 2 : 0);
+            entry.push_back(i == 0 ? 5 : (i == 1 ? 2 : 0));    // root storage, stream, unused
+            entry.push_back(1);                                 // black
+            AppendUInt32(entry, NoStream);                      // left
+            AppendUInt32(entry, NoStream);                      // right
+            AppendUInt32(entry, i == 0 ? 1 : NoStream);         // child
+            entry.append(16 + 4 + 16, '\0');                    // CLSID, state bits, times
+            AppendUInt32(entry, i == 1 ? 2 : (i == 0 ? EndOfChain : 0));
+            AppendUInt32(entry, i == 1 ? streamSize : 0);
+            AppendUInt32(entry, 0);
+            directory += entry;
+        }
+
+        // a FAT sector has room for the chains of the first 128 sectors
+        TEST_CHECK(2 + streamSectors <= SectorSize / 4);
+
+        return header + fat + directory + stream;
+    }
+
+    bool WriteFile(const std::string &content)
+    {
+        FILE *file = std::fopen(Filename, "wb");
+        if (file == NULL)
+            return false;
+
+        bool written = std::fwrite(content.data(), 1, content.size(), file) == content.size();
+        return std::fclose(file) == 0 && written;
+    }
+
+
+    void TestCells(ExcelWorksheet sheet)
+    {
+        TEST_CHECK(sheet.GetName() == Text("Data"));
+
+        std::vector<std::vector<ELstring> > values;
+        ExcelRange range = sheet.GetRange(ELtext('A'), ELtext('E'), 1, 4);
+        TEST_CHECK(range.ReadData(values));
+        TEST_CHECK(values.size() == 4);
+        if (values.size() != 4)
+            return;
+
+        // booleans are written as Excel converts them to text, dates without a zero time
+        const char *expected[4][5] =
+        {
+            { "alpha", "3.5", "42", "1.23", "beta" },
+            { "-10", "-20", "-30", "-1", "#N/A" },
+            { "7.25", "result", "0", "#DIV/0!", "" },
+            { "2023-03-15", "2023-03-15 12:00:00", "inline", "split-text", "" }
+        };
+
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 5; ++j)
+            {
+                if (values[i][j] != Text(expected[i][j]))
+                {
+                    std::printf("cell (%d, %d): \"%s\", expected \"%s\"\n", i + 1, j + 1,
+                        std::string(values[i][j].begin(), values[i][j].end()).c_str(), expected[i][j]);
+                    TEST_CHECK(values[i][j] == Text(expected[i][j]));
+                }
+            }
+        }
+
+        // a shared string in UTF-16
+        ExcelValue value;
+        TEST_CHECK(sheet.GetRange(ELtext('E'), ELtext('E'), 1, 1).GetValue(value));
+        TEST_CHECK(value.GetType() == EVT_String && value.GetString() == Text("beta"));
+
+        // the typed values
+        std::vector<ExcelValue> typed;
+        TEST_CHECK(sheet.GetRange(ELtext('A'), ELtext('D'), 2, 3).ReadValues(typed));
+        TEST_CHECK(typed.size() == 8);
+        if (typed.size() == 8)
+        {
+            TEST_CHECK(typed[0].GetType() == EVT_Double && typed[0].GetDouble() == -10);
+            TEST_CHECK(typed[3].GetType() == EVT_Bool && typed[3].GetBool());
+            TEST_CHECK(typed[4].GetType() == EVT_Double && typed[4].GetDouble() == 7.25);
+            TEST_CHECK(typed[5].GetType() == EVT_String);
+            TEST_CHECK(typed[6].GetType() == EVT_Bool && !typed[6].GetBool());
+            TEST_CHECK(typed[7].GetType() == EVT_Error);
+        }
+
+        TEST_CHECK(sheet.GetRange(ELtext('A'), ELtext('A'), 4, 4).GetValue(value));
+        TEST_CHECK(value.GetType() == EVT_Date && value.GetDouble() == 45000);
+    }
+}
+
+
+int main()
+{
+    TEST_CHECK(WriteFile(MakeCompoundFile(MakeWorkbookStream())));
+
+    ExcelWorkbook workbook = ExcelFileReader::Open(Text(Filename));
+    TEST_CHECK(!workbook.IsNull());
+
+    if (!workbook.IsNull())
+    {
+        ExcelWorksheetSet sheets = workbook.GetAllWorksheets();
+        TEST_CHECK(sheets.CountWorksheets() == 2);
+        TEST_CHECK(workbook.GetActiveWorksheet().GetName() == Text("Chart"));
+
+        TestCells(sheets.GetWorksheet(1));
+
+        // only the cell of the worksheet, not the one of its chart
+        ExcelValue value;
+        TEST_CHECK(sheets.GetWorksheet(2).GetRange(ELtext('A'), ELtext('A'), 1, 1).GetValue(value));
+        TEST_CHECK(value.GetType() == EVT_Double && value.GetDouble() == 1);
+
+        // a damaged file is refused
+        workbook = ExcelWorkbook();
+        std::string content = MakeCompoundFile(MakeWorkbookStream());
+        content[0x1C] = 0;
+        TEST_CHECK(WriteFile(content));
+        TEST_CHECK(ExcelFileReader::Open(Text(Filename)).IsNull());
+    }
+
+    std::remove(Filename);
+    return TestResult("XlsReaderTest");
+}
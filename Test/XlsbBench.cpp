@@ -0,0 +1,167 @@
+﻿/*!
+* @file    XlsbBench.cpp
+* @brief   Benchmark of XlsxStreamWriter and ExcelFileReader on the same worksheet saved as .xlsx and as .xlsb
+* @date    2026-10-17
+* @version $Id$
+*/
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ExcelFileReader.h"
+#include "ExcelWorkbook.h"
+#include "ExcelWorksheet.h"
+#include "ExcelRange.h"
+#include "XlsxStreamWriter.h"
+#include "TestUtil.h"
+
+
+using namespace ExcelAutomation;
+
+
+namespace
+{
+    const int Rows = 50000;
+    const int Columns = 12;     // A to L
+
+    ELstring Text(const char *text)
+    {
+        return ELstring(text, text + std::char_traits<char>::length(text));
+    }
+
+    // A report-like worksheet: integers, decimals, shared labels and unique strings
+    bool WriteWorkbook(const char *filename)
+    {
+        XlsxStreamWriter writer = XlsxStreamWriter::Create(Text(filename));
+        if (writer.IsNull() || !writer.AddWorksheet(Text("Data")))
+            return false;
+
+        std::vector<ELstring> row(Columns);
+        for (int i = 0; i < Rows; ++i)
+        {
+            for (int j = 0; j < Columns; ++j)
+            {
+                char text[64];
+                switch (j % 4)
+                {
+                case 0:
+                    std::sprintf(text, "%d", i * Columns + j);
+                    break;
+                case 1:
+                    std::sprintf(text, "%.3f", (i + 1) * 0.37 + j);
+                    break;
+                case 2:
+                    std::sprintf(text, "Region %d", i % 50);
+                    break;
+                default:
+                    std::sprintf(text, "Order %d-%d", i, j);
+                    break;
+                }
+                row[j] = Text(text);
+            }
+
+            if (!writer.WriteRow(row))
+                return false;
+        }
+
+        return writer.Close();
+    }
+
+    // Open the workbook with the worksheet read at once, and get all its cells
+    bool ReadWorkbook(const char *filename, ELstring &data)
+    {
+        ExcelWorkbook workbook = ExcelFileReader::Open(Text(filename), 1);
+        if (workbook.IsNull())
+            return false;
+
+        ExcelRange range = workbook.GetActiveWorksheet().GetRange(ELtext('A'), ELtext('A') + Columns - 1, 1, Rows);
+        return !range.IsNull() && range.ReadData(data);
+    }
+
+    long FileSize(const char *filename)
+    {
+        FILE *file = std::fopen(filename, "rb");
+        if (file == NULL)
+            return -1;
+
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fclose(file);
+        return size;
+    }
+
+    struct Measure
+    {
+        double saveSeconds;
+        double openSeconds;
+        long bytes;
+    };
+
+    // The best of some rounds of saving and of reading back; the cells read are returned in data
+    bool Run(const char *filename, ELstring &data, Measure &measure)
+    {
+        const int rounds = 3;
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            Stopwatch watch;
+            if (!WriteWorkbook(filename))
+            {
+                std::printf("XlsbBench: cannot write %s\n", filename);
+                return false;
+            }
+            double saveSeconds = watch.Seconds();
+
+            watch.Restart();
+            if (!ReadWorkbook(filename, data))
+            {
+                std::printf("XlsbBench: cannot read %s\n", filename);
+                return false;
+            }
+            double openSeconds = watch.Seconds();
+
+            if (round == 0 || saveSeconds < measure.saveSeconds)
+                measure.saveSeconds = saveSeconds;
+            if (round == 0 || openSeconds < measure.openSeconds)
+                measure.openSeconds = openSeconds;
+        }
+
+        measure.bytes = FileSize(filename);
+        std::remove(filename);
+        return true;
+    }
+}
+
+
+int main()
+{
+    const char *filenames[] = { "XlsbBench.xlsx", "XlsbBench.xlsb" };
+    Measure measures[2];
+    ELstring data[2];
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (!Run(filenames[i], data[i], measures[i]))
+            return 1;
+    }
+
+    if (data[0] != data[1] || data[0].empty())
+    {
+        std::printf("XlsbBench: the two formats read other cells\n");
+        return 1;
+    }
+
+    std::printf("XlsbBench: %d x %d cells\n", Rows, Columns);
+    for (int i = 0; i < 2; ++i)
+    {
+        std::printf("  %-15s save %8.2f ms  open and read %8.2f ms  %8.1f KB\n", filenames[i],
+            measures[i].saveSeconds * 1e3, measures[i].openSeconds * 1e3, measures[i].bytes / 1024.0);
+    }
+    std::printf("  .xlsb against .xlsx: save %.2fx, open and read %.2fx, size %.2fx\n",
+        measures[0].saveSeconds / measures[1].saveSeconds, measures[0].openSeconds / measures[1].openSeconds,
+        static_cast<double>(measures[1].bytes) / measures[0].bytes);
+
+    return 0;
+}